@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+# Copyright (c) 2024 Microsoft Corporation
+#
+# Train a strategy model for the strategy-selector tactic.
+#
+# Every benchmark is run with every candidate strategy. The static
+# features of a benchmark are labeled with the strategy that solved it
+# fastest, and the labeled points are written as a k-nearest-neighbor
+# table that can be passed to z3 with tactic.strategy_model=<file>.
+#
+# Usage:
+#   python train_strategy_model.py --strategies strategies.txt \
+#       --timeout 60 --output model.txt benchmarks/*.smt2
+#
+# strategies.txt contains one tactic s-expression per line.
+# Benchmarks that no strategy solves within the timeout are skipped.
+import argparse
+import re
+import subprocess
+import sys
+import time
+
+def script_prefix(path):
+    with open(path) as f:
+        text = f.read()
+    i = text.find("(check-sat")
+    return text if i < 0 else text[:i]
+
+def run(z3, script, timeout):
+    start = time.time()
+    try:
+        r = subprocess.run([z3, "-in"], input=script, capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None, None
+    return time.time() - start, r
+
+def features(z3, prefix, timeout):
+    script = prefix + "(apply (using-params strategy-selector :strategy_selector.print_features true) :print false)\n"
+    _, r = run(z3, script, timeout)
+    if r is None:
+        return None
+    m = re.search(r"\(features ([^)]*)\)", r.stderr)
+    if not m:
+        return None
+    tokens = m.group(1).split()
+    return dict(zip(tokens[0::2], map(float, tokens[1::2])))
+
+def solve_time(z3, prefix, strategy, timeout):
+    t, r = run(z3, prefix + "(check-sat-using %s)\n" % strategy, timeout)
+    if r is None:
+        return None
+    out = r.stdout.split()
+    if not out or out[-1] not in ("sat", "unsat"):
+        return None
+    return t
+
+def main():
+    parser = argparse.ArgumentParser(description="train a strategy model for z3")
+    parser.add_argument("--z3", default="z3", help="z3 executable")
+    parser.add_argument("--strategies", required=True, help="file with one tactic per line")
+    parser.add_argument("--timeout", type=float, default=60, help="timeout per run in seconds")
+    parser.add_argument("--k", type=int, default=3, help="number of neighbors")
+    parser.add_argument("--features", default=None, help="comma separated feature names, default all")
+    parser.add_argument("--output", required=True, help="model file to write")
+    parser.add_argument("benchmarks", nargs="+")
+    args = parser.parse_args()
+
+    with open(args.strategies) as f:
+        strategies = [l.strip() for l in f if l.strip() and not l.startswith("#")]
+    points = []
+    names = args.features.split(",") if args.features else None
+    for b in args.benchmarks:
+        prefix = script_prefix(b)
+        fs = features(args.z3, prefix, args.timeout)
+        if fs is None:
+            print("%s: could not compute features" % b, file=sys.stderr)
+            continue
+        if names is None:
+            names = list(fs.keys())
+        times = [solve_time(args.z3, prefix, s, args.timeout) for s in strategies]
+        solved = [(t, i) for i, t in enumerate(times) if t is not None]
+        if not solved:
+            print("%s: not solved" % b, file=sys.stderr)
+            continue
+        best = min(solved)[1]
+        print("%s: strategy %d %s" % (b, best, " ".join("-" if t is None else "%.2f" % t for t in times)), file=sys.stderr)
+        points.append((best, [fs.get(n, 0.0) for n in names]))
+
+    with open(args.output, "w") as out:
+        out.write("# trained on %d benchmarks\n" % len(points))
+        out.write("k %d\n" % args.k)
+        out.write("features %s\n" % " ".join(names or []))
+        for i, s in enumerate(strategies):
+            out.write("strategy %d %s\n" % (i, s))
+        for label, values in points:
+            out.write("point %d %s\n" % (label, " ".join("%g" % v for v in values)))
+
+if __name__ == "__main__":
+    main()
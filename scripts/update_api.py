@@ -426,7 +426,7 @@ def mk_dotnet(dotnet):
     dotnet.write('    {\n\n')
 
     for name, ret, sig in Closures:
-        sig = sig.replace("unsigned const*","uint[]")
+        sig = sig.replace("unsigned const*","uint[]").replace("Z3_ast const*","Z3_ast[]")
         sig = sig.replace("void*","voidp").replace("unsigned","uint")
         sig = sig.replace("Z3_ast*","ref IntPtr").replace("uint*","ref uint").replace("Z3_lbool*","ref int")
         ret = ret.replace("void*","voidp").replace("unsigned","uint")        
@@ -1134,6 +1134,12 @@ def def_API(name, result, params):
                 log_c.write(" }\n")
                 log_c.write("  Au(%s);\n" % sz_e)
                 exe_c.write("in.get_uint_array(%s)" % i)
+            elif ty == INT64 or ty == UINT64:
+                # 64-bit outputs are replayed in a buffer of twice as many unsigned values
+                log_c.write("U(0); U(0);")
+                log_c.write(" }\n")
+                log_c.write("  Au(2*%s);\n" % sz_e)
+                exe_c.write("reinterpret_cast<%s*>(in.get_uint_array(%s))" % (tstr, i))
             else:
                 error ("unsupported parameter for %s, %s" % (name, p))
         elif kind == OUT_MANAGED_ARRAY:
@@ -1392,7 +1398,10 @@ z3_ml_callbacks = frozenset([
     'Z3_solver_propagate_diseq',
     'Z3_solver_propagate_created',
     'Z3_solver_propagate_decide',
-    'Z3_solver_register_on_clause'
+    'Z3_solver_propagate_batch',
+    'Z3_solver_register_on_clause',
+    'Z3_solver_check_async',
+    'Z3_solver_register_on_progress'
     ])
 
 def mk_ml(ml_src_dir, ml_output_dir):
@@ -1944,6 +1953,9 @@ Z3_eq_eh    = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_
 
 Z3_created_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p)
 Z3_decide_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint, ctypes.c_int)
+Z3_batch_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint, ctypes.c_uint, ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_void_p), ctypes.c_uint, ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_void_p))
+Z3_check_done_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int)
+Z3_progress_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p)
 
 _lib.Z3_solver_register_on_clause.restype = None
 _lib.Z3_solver_propagate_init.restype = None
@@ -1952,6 +1964,9 @@ _lib.Z3_solver_propagate_fixed.restype = None
 _lib.Z3_solver_propagate_eq.restype = None
 _lib.Z3_solver_propagate_diseq.restype = None
 _lib.Z3_solver_propagate_decide.restype = None
+_lib.Z3_solver_propagate_batch.restype = None
+_lib.Z3_solver_check_async.restype = None
+_lib.Z3_solver_register_on_progress.restype = None
 
 on_model_eh_type = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
 _lib.Z3_optimize_register_model_eh.restype = None
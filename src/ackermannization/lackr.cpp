@@ -257,10 +257,13 @@ lbool lackr::lazy() {
         m_solver->get_model(am);
         const bool mc_res = mc.check(am);
         if (mc_res) return l_true; // model okay
-        // refine abstraction
+        // refine abstraction with the congruences violated by the model,
+        // the solver keeps what it learned in previous rounds
         for (auto const& kv : mc.get_conflicts()) {
             ackr(kv.first, kv.second);
         }
+        if (ackr_head == m_ackrs.size())
+            return l_undef; // no lemma excludes the model
         while (ackr_head < m_ackrs.size()) {
             m_solver->assert_expr(m_ackrs.get(ackr_head++));
         }
@@ -29,6 +29,8 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_smt_pp.h"
 #include "ast/ast_smt2_pp.h"
+#include "ast/ast_serialize.h"
+#include "ast/ast_pp_util.h"
 #include "ast/polymorphism_util.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "ast/rewriter/var_subst.h"
@@ -209,6 +211,91 @@ extern "C" {
         Z3_CATCH_RETURN(nullptr);
     }
 
+    Z3_ast Z3_API Z3_mk_term_dag(Z3_context c,
+                                 unsigned num_code, unsigned const code[],
+                                 unsigned num_decls, Z3_func_decl const decls[],
+                                 unsigned num_leaves, Z3_ast const leaves[],
+                                 unsigned num_sorts, Z3_sort const sorts[],
+                                 unsigned num_terms, Z3_ast terms[]) {
+        Z3_TRY;
+        LOG_Z3_mk_term_dag(c, num_code, code, num_decls, decls, num_leaves, leaves, num_sorts, sorts, num_terms, terms);
+        RESET_ERROR_CODE();
+        ast_manager& m = mk_c(c)->m();
+        expr_ref_vector values(m);
+        ptr_buffer<expr> stack;
+        auto operand = [&](unsigned& pc) {
+            if (pc >= num_code)
+                throw default_exception("term program ends inside an instruction");
+            return code[pc++];
+        };
+        for (unsigned pc = 0; pc < num_code; ) {
+            unsigned op = code[pc++];
+            expr* e = nullptr;
+            switch (op) {
+            case Z3_TERM_LEAF: {
+                unsigned k = operand(pc);
+                if (k >= num_leaves || !is_expr(to_ast(leaves[k])))
+                    throw default_exception("invalid leaf in term program");
+                e = to_expr(leaves[k]);
+                break;
+            }
+            case Z3_TERM_APP: {
+                unsigned d = operand(pc);
+                unsigned n = operand(pc);
+                if (d >= num_decls || n > stack.size())
+                    throw default_exception("invalid application in term program");
+                func_decl* f = to_func_decl(decls[d]);
+                expr* const* args = stack.data() + stack.size() - n;
+                if (f->is_polymorphic())
+                    throw default_exception("polymorphic functions are not supported in term programs");
+                if (!f->is_associative() && f->get_arity() != n)
+                    throw default_exception("wrong number of arguments in term program");
+                for (unsigned i = 0; i < n && i < f->get_arity(); ++i)
+                    if (f->get_domain(i) != args[i]->get_sort())
+                        throw default_exception("sort mismatch in term program");
+                e = m.mk_app(f, n, args);
+                stack.shrink(stack.size() - n);
+                break;
+            }
+            case Z3_TERM_REF: {
+                unsigned i = operand(pc);
+                if (i >= values.size())
+                    throw default_exception("invalid reference in term program");
+                e = values.get(i);
+                break;
+            }
+            case Z3_TERM_NUMERAL: {
+                unsigned s = operand(pc);
+                unsigned lo = operand(pc);
+                unsigned hi = operand(pc);
+                if (s >= num_sorts || !is_numeral_sort(c, sorts[s]))
+                    throw default_exception("invalid numeral sort in term program");
+                int64_t v = static_cast<int64_t>((static_cast<uint64_t>(hi) << 32) | lo);
+                e = to_expr(mk_c(c)->mk_numeral_core(rational(v, rational::i64()), to_sort(sorts[s])));
+                break;
+            }
+            default:
+                throw default_exception("invalid opcode in term program");
+            }
+            values.push_back(e);
+            stack.push_back(e);
+        }
+        if (stack.size() != 1) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "term program must leave exactly one term");
+            RETURN_Z3(nullptr);
+        }
+        for (unsigned i = 0; i < num_terms; ++i) {
+            expr* t = i < values.size() ? values.get(i) : nullptr;
+            if (t)
+                mk_c(c)->save_multiple_ast_trail(t);
+            terms[i] = of_ast(t);
+        }
+        expr* r = stack[0];
+        mk_c(c)->save_ast_trail(r);
+        RETURN_Z3(of_ast(r));
+        Z3_CATCH_RETURN(nullptr);
+    }
+
     Z3_ast Z3_API Z3_mk_const(Z3_context c, Z3_symbol s, Z3_sort ty) {
         Z3_TRY;
         LOG_Z3_mk_const(c, s, ty);
@@ -1039,6 +1126,44 @@ extern "C" {
         return Z3_ast_to_string(c, reinterpret_cast<Z3_ast>(f));
     }
 
+    Z3_char_ptr Z3_API Z3_serialize_ast(Z3_context c, Z3_ast a, unsigned* length) {
+        Z3_TRY;
+        LOG_Z3_serialize_ast(c, a, length);
+        RESET_ERROR_CODE();
+        if (!length) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "length argument is null");
+            return "";
+        }
+        CHECK_IS_EXPR(a, "");
+        std::ostringstream buffer;
+        ast_serializer s(mk_c(c)->m(), buffer);
+        s(to_expr(a));
+        s.finish();
+        std::string const& str = buffer.str();
+        auto& result = mk_c(c)->m_char_buffer;
+        result.reset();
+        result.append(static_cast<unsigned>(str.size()), str.data());
+        *length = result.size();
+        return result.data();
+        Z3_CATCH_RETURN("");
+    }
+
+    Z3_ast Z3_API Z3_deserialize_ast(Z3_context c, unsigned sz, Z3_string data) {
+        Z3_TRY;
+        LOG_Z3_deserialize_ast(c, sz, data);
+        RESET_ERROR_CODE();
+        std::istringstream in(std::string(data, sz));
+        expr_ref r(mk_c(c)->m());
+        ast_deserializer d(mk_c(c)->m(), in);
+        if (!d(r)) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "serialized expression is empty");
+            RETURN_Z3(nullptr);
+        }
+        mk_c(c)->save_ast_trail(r);
+        RETURN_Z3(of_expr(r));
+        Z3_CATCH_RETURN(nullptr);
+    }
+
     Z3_string Z3_API Z3_benchmark_to_smtlib_string(Z3_context c,
                                                    Z3_string name,
                                                    Z3_string logic,
@@ -1051,12 +1176,38 @@ extern "C" {
         LOG_Z3_benchmark_to_smtlib_string(c, name, logic, status, attributes, num_assumptions, assumptions, formula);
         RESET_ERROR_CODE();
         std::ostringstream buffer;
+        pp_params params;
+        if (params.streaming()) {
+            // print declarations and assertions with the streaming SMT2 printer.
+            ast_manager& m = mk_c(c)->m();
+            if (name && *name)
+                buffer << "; " << name << "\n";
+            if (m.is_bool(to_expr(formula)))
+                buffer << "(set-info :status " << (status ? status : "unknown") << ")\n";
+            if (logic && *logic)
+                buffer << "(set-logic " << logic << ")\n";
+            if (attributes && *attributes)
+                buffer << "; " << attributes;
+            ast_pp_util visitor(m);
+            visitor.collect(num_assumptions, to_exprs(num_assumptions, assumptions));
+            visitor.collect(to_expr(formula));
+            visitor.display_decls(buffer);
+            for (unsigned i = 0; i < num_assumptions; ++i)
+                visitor.display_assert(buffer, to_expr(assumptions[i]));
+            if (!m.is_bool(to_expr(formula)))
+                visitor.display_expr(buffer, to_expr(formula)) << "\n";
+            else {
+                if (!m.is_true(to_expr(formula)))
+                    visitor.display_assert(buffer, to_expr(formula));
+                buffer << "(check-sat)\n";
+            }
+            return mk_c(c)->mk_external_string(std::move(buffer).str());
+        }
         ast_smt_pp pp(mk_c(c)->m());
         pp.set_benchmark_name(name);
         pp.set_logic(logic?symbol(logic):symbol::null);
         pp.set_status(status);
         pp.add_attributes(attributes);
-        pp_params params;
         pp.set_simplify_implies(params.simplify_implies());
         for (unsigned i = 0; i < num_assumptions; ++i) {
             pp.add_assumption(to_expr(assumptions[i]));
@@ -152,7 +152,7 @@ namespace api {
         m_special_relations_fid   = m().mk_family_id("specrels");
         m_dt_plugin = static_cast<datatype_decl_plugin*>(m().get_plugin(m_dt_fid));
     
-        install_tactics(*this);
+        set_installer(install_tactics);
     }
 
 
@@ -451,6 +451,22 @@ extern "C" {
         Z3_CATCH;
     }
 
+    void Z3_API Z3_dec_ref_array(Z3_context c, unsigned num, Z3_ast const asts[]) {
+        Z3_TRY;
+        LOG_Z3_dec_ref_array(c, num, asts);
+        for (unsigned i = 0; i < num; ++i) {
+            Z3_ast a = asts[i];
+            if (a && to_ast(a)->get_ref_count() == 0) {
+                RESET_ERROR_CODE();
+                SET_ERROR_CODE(Z3_DEC_REF_ERROR, nullptr);
+                return;
+            }
+            if (a)
+                mk_c(c)->dec_ref(to_ast(a));
+        }
+        Z3_CATCH;
+    }
+
 
     void Z3_API Z3_get_version(unsigned * major, 
                                unsigned * minor, 
@@ -109,6 +109,18 @@ namespace api {
         void add_table_fact(func_decl* r, unsigned num_args, unsigned args[]) {
             m_context.add_table_fact(r, num_args, args);
         }
+        void add_table_facts(func_decl* r, unsigned num_args, unsigned const args[]) {
+            unsigned arity = r->get_arity();
+            if (arity == 0 || num_args % arity != 0) {
+                std::ostringstream out;
+                out << "number of arguments " << num_args << " passed to " << r->get_name() << " is not a multiple of its arity";
+                throw default_exception(out.str());
+            }
+            datalog::table_fact facts;
+            for (unsigned i = 0; i < num_args; ++i) 
+                facts.push_back(args[i]);
+            m_context.add_table_facts(r, num_args / arity, facts.data());
+        }
         std::string get_last_status() {
             datalog::execution_result status = m_context.get_status();
             switch(status) {
@@ -274,6 +286,15 @@ extern "C" {
         Z3_CATCH;
     }
 
+    void Z3_API Z3_fixedpoint_add_facts(Z3_context c, Z3_fixedpoint d, 
+                                        Z3_func_decl r, unsigned num_args, unsigned const args[]) {
+        Z3_TRY;
+        LOG_Z3_fixedpoint_add_facts(c, d, r, num_args, args);
+        RESET_ERROR_CODE();
+        to_fixedpoint_ref(d)->add_table_facts(to_func_decl(r), num_args, args);
+        Z3_CATCH;
+    }
+
     Z3_lbool Z3_API Z3_fixedpoint_query(Z3_context c,Z3_fixedpoint d, Z3_ast q) {
         Z3_TRY;
         LOG_Z3_fixedpoint_query(c, d, q);
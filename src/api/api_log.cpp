@@ -16,6 +16,13 @@ Revision History:
 
 --*/
 #include<fstream>
+#include<cstring>
+#include<string>
+#ifndef SINGLE_THREAD
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#endif
 #include "api/z3.h"
 #include "api/api_log_macros.h"
 #include "api/z3_logger.h"
@@ -26,6 +33,126 @@ Revision History:
 static std::ostream * g_z3_log = nullptr;
 atomic<bool> g_z3_log_enabled;
 
+namespace {
+    /**
+       \brief writer for the binary log format.
+
+       Records use the same tags as the text format. Unsigned payloads are
+       LEB128 varints, signed integers are zig-zag encoded, doubles are
+       stored as their 8 bytes and strings are prefixed by their length.
+       Records are appended to a buffer; full buffers are written by a
+       background thread while the next buffer is filled.
+    */
+    class binary_log {
+        static const size_t BUFFER_SIZE = 1 << 20;
+        std::ofstream           m_out;
+        std::string             m_buffer;
+#ifndef SINGLE_THREAD
+        std::string             m_pending;
+        bool                    m_has_pending = false;
+        bool                    m_done = false;
+        std::mutex              m_mux;
+        std::condition_variable m_cv;
+        std::thread             m_thread;
+
+        void writer() {
+            std::unique_lock<std::mutex> lock(m_mux);
+            while (true) {
+                m_cv.wait(lock, [&] { return m_has_pending || m_done; });
+                if (m_has_pending) {
+                    lock.unlock();
+                    m_out.write(m_pending.data(), m_pending.size());
+                    m_pending.clear();
+                    lock.lock();
+                    m_has_pending = false;
+                    m_cv.notify_all();
+                }
+                else if (m_done)
+                    return;
+            }
+        }
+#endif
+
+        void flush_buffer() {
+#ifdef SINGLE_THREAD
+            m_out.write(m_buffer.data(), m_buffer.size());
+            m_buffer.clear();
+#else
+            std::unique_lock<std::mutex> lock(m_mux);
+            m_cv.wait(lock, [&] { return !m_has_pending; });
+            m_pending.swap(m_buffer);
+            m_has_pending = true;
+            m_cv.notify_all();
+#endif
+        }
+
+    public:
+        static char const * magic() { return "\0Z3BLOG1"; }
+        static const unsigned magic_size = 9;
+
+        binary_log(char const * filename): m_out(filename, std::ios::out | std::ios::binary) {
+            m_buffer.reserve(BUFFER_SIZE);
+            m_out.write(magic(), magic_size);
+#ifndef SINGLE_THREAD
+            if (ok())
+                m_thread = std::thread([&] { writer(); });
+#endif
+        }
+
+        ~binary_log() {
+            flush_buffer();
+#ifndef SINGLE_THREAD
+            if (m_thread.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mux);
+                    m_done = true;
+                }
+                m_cv.notify_all();
+                m_thread.join();
+            }
+#endif
+            m_out.flush();
+        }
+
+        bool ok() const { return !m_out.bad() && !m_out.fail(); }
+
+        void tag(char c) {
+            m_buffer.push_back(c);
+        }
+
+        void u(uint64_t v) {
+            while (v >= 0x80) {
+                m_buffer.push_back(static_cast<char>((v & 0x7f) | 0x80));
+                v >>= 7;
+            }
+            m_buffer.push_back(static_cast<char>(v));
+        }
+
+        void i(int64_t v) {
+            u((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+        }
+
+        void d(double v) {
+            char bytes[sizeof(double)];
+            memcpy(bytes, &v, sizeof(double));
+            m_buffer.append(bytes, sizeof(double));
+        }
+
+        void s(char const * str) {
+            size_t sz = strlen(str);
+            u(sz);
+            m_buffer.append(str, sz);
+        }
+
+        void end_record() {
+            if (m_buffer.size() >= BUFFER_SIZE)
+                flush_buffer();
+        }
+    };
+}
+
+static binary_log * g_z3_blog = nullptr;
+
 #ifdef Z3_LOG_SYNC
 static mutex g_log_mux;
 #define SCOPED_LOCK() lock_guard lock(g_log_mux)
@@ -35,14 +162,26 @@ static mutex g_log_mux;
 
 // functions called from api_log_macros.*
 void SetR(void * obj) {
+    if (g_z3_blog) {
+        g_z3_blog->tag('='); g_z3_blog->u(reinterpret_cast<uintptr_t>(obj)); g_z3_blog->end_record();
+        return;
+    }
     *g_z3_log << "= " << obj << '\n';
 }
 
 void SetO(void * obj, unsigned pos) {
+    if (g_z3_blog) {
+        g_z3_blog->tag('*'); g_z3_blog->u(reinterpret_cast<uintptr_t>(obj)); g_z3_blog->u(pos); g_z3_blog->end_record();
+        return;
+    }
     *g_z3_log << "* " << obj << ' ' << pos << '\n';
 }
 
 void SetAO(void * obj, unsigned pos, unsigned idx) {
+    if (g_z3_blog) {
+        g_z3_blog->tag('@'); g_z3_blog->u(reinterpret_cast<uintptr_t>(obj)); g_z3_blog->u(pos); g_z3_blog->u(idx); g_z3_blog->end_record();
+        return;
+    }
     *g_z3_log << "@ " << obj << ' ' << pos << ' ' << idx << '\n';
 }
 
@@ -73,14 +212,29 @@ std::ostream & operator<<(std::ostream & out, ll_escaped const & d) {
 }
 }
 
-void R()              { *g_z3_log << 'R' << std::endl; }
-void P(void * obj)    { *g_z3_log << "P " << obj <<std::endl; }
-void I(int64_t i)     { *g_z3_log << "I " << i << std::endl; }
-void U(uint64_t u)    { *g_z3_log << "U " << u << std::endl; }
-void D(double d)      { *g_z3_log << "D " << d << std::endl; }
-void S(Z3_string str) { *g_z3_log << "S \"" << ll_escaped{str} << '"' << std::endl; }
+#define BLOG(_CODE_) if (g_z3_blog) { _CODE_; return; }
+
+void R()              { BLOG(g_z3_blog->tag('R')); *g_z3_log << 'R' << std::endl; }
+void P(void * obj)    { BLOG(g_z3_blog->tag('P'); g_z3_blog->u(reinterpret_cast<uintptr_t>(obj))); *g_z3_log << "P " << obj <<std::endl; }
+void I(int64_t i)     { BLOG(g_z3_blog->tag('I'); g_z3_blog->i(i)); *g_z3_log << "I " << i << std::endl; }
+void U(uint64_t u)    { BLOG(g_z3_blog->tag('U'); g_z3_blog->u(u)); *g_z3_log << "U " << u << std::endl; }
+void D(double d)      { BLOG(g_z3_blog->tag('D'); g_z3_blog->d(d)); *g_z3_log << "D " << d << std::endl; }
+void S(Z3_string str) { BLOG(g_z3_blog->tag('S'); g_z3_blog->s(str)); *g_z3_log << "S \"" << ll_escaped{str} << '"' << std::endl; }
 void Sy(Z3_symbol sym) {
     symbol s = symbol::c_api_ext2symbol(sym);
+    if (g_z3_blog) {
+        if (s.is_null())
+            g_z3_blog->tag('N');
+        else if (s.is_numerical()) {
+            g_z3_blog->tag('#');
+            g_z3_blog->u(s.get_num());
+        }
+        else {
+            g_z3_blog->tag('$');
+            g_z3_blog->s(s.str().c_str());
+        }
+        return;
+    }
     if (s.is_null()) {
         *g_z3_log << 'N';
     }
@@ -92,16 +246,16 @@ void Sy(Z3_symbol sym) {
     }
     *g_z3_log << std::endl;
 }
-void Ap(unsigned sz)  { *g_z3_log << "p " << sz << std::endl; }
-void Au(unsigned sz)  { *g_z3_log << "u " << sz << std::endl; }
-void Ai(unsigned sz)  { *g_z3_log << "i " << sz << std::endl; }
-void Asy(unsigned sz) { *g_z3_log << "s " << sz << std::endl; }
-void C(unsigned id)   { *g_z3_log << "C " << id << std::endl; }
-static void _Z3_append_log(char const * msg) { *g_z3_log << "M \"" << ll_escaped{msg} << '"' << std::endl; }
+void Ap(unsigned sz)  { BLOG(g_z3_blog->tag('p'); g_z3_blog->u(sz)); *g_z3_log << "p " << sz << std::endl; }
+void Au(unsigned sz)  { BLOG(g_z3_blog->tag('u'); g_z3_blog->u(sz)); *g_z3_log << "u " << sz << std::endl; }
+void Ai(unsigned sz)  { BLOG(g_z3_blog->tag('i'); g_z3_blog->u(sz)); *g_z3_log << "i " << sz << std::endl; }
+void Asy(unsigned sz) { BLOG(g_z3_blog->tag('s'); g_z3_blog->u(sz)); *g_z3_log << "s " << sz << std::endl; }
+void C(unsigned id)   { BLOG(g_z3_blog->tag('C'); g_z3_blog->u(id); g_z3_blog->end_record()); *g_z3_log << "C " << id << std::endl; }
+static void _Z3_append_log(char const * msg) { BLOG(g_z3_blog->tag('M'); g_z3_blog->s(msg); g_z3_blog->end_record()); *g_z3_log << "M \"" << ll_escaped{msg} << '"' << std::endl; }
 
 void ctx_enable_logging() {
     SCOPED_LOCK();
-    if (g_z3_log != nullptr)
+    if (g_z3_log != nullptr || g_z3_blog != nullptr)
         g_z3_log_enabled = true;
 }
 
@@ -111,6 +265,16 @@ static void Z3_close_log_unsafe(void) {
         dealloc(g_z3_log);
         g_z3_log = nullptr;
     }
+    if (g_z3_blog != nullptr) {
+        g_z3_log_enabled = false;
+        dealloc(g_z3_blog);
+        g_z3_blog = nullptr;
+    }
+}
+
+static bool is_binary_log_name(char const * filename) {
+    size_t sz = strlen(filename);
+    return sz >= 4 && strcmp(filename + sz - 4, ".bin") == 0;
 }
 
 extern "C" {
@@ -120,6 +284,23 @@ extern "C" {
         SCOPED_LOCK();
         Z3_close_log_unsafe();
 
+        if (is_binary_log_name(filename)) {
+            g_z3_blog = alloc(binary_log, filename);
+            res = g_z3_blog->ok();
+            if (res) {
+                g_z3_blog->tag('V');
+                std::string version = std::to_string(Z3_MAJOR_VERSION) + "." + std::to_string(Z3_MINOR_VERSION) + "." +
+                    std::to_string(Z3_BUILD_NUMBER) + "." + std::to_string(Z3_REVISION_NUMBER);
+                g_z3_blog->s(version.c_str());
+            }
+            else {
+                dealloc(g_z3_blog);
+                g_z3_blog = nullptr;
+            }
+            g_z3_log_enabled = res;
+            return res;
+        }
+
         g_z3_log = alloc(std::ofstream, filename);
         if (g_z3_log->bad() || g_z3_log->fail()) {
             dealloc(g_z3_log);
@@ -139,7 +320,7 @@ extern "C" {
         if (!g_z3_log_enabled)
             return;
         SCOPED_LOCK();
-        if (g_z3_log != nullptr)
+        if (g_z3_log != nullptr || g_z3_blog != nullptr)
             _Z3_append_log(static_cast<char const *>(str));
     }
 
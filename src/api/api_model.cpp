@@ -77,7 +77,7 @@ extern "C" {
         Z3_TRY;
         LOG_Z3_model_has_interp(c, m, a);
         CHECK_NON_NULL(m, 0);
-        return to_model_ref(m)->has_interpretation(to_func_decl(a));
+        return to_model_eval_ref(m)->has_interpretation(to_func_decl(a));
         Z3_CATCH_RETURN(false);
     }
 
@@ -157,7 +157,7 @@ extern "C" {
         RESET_ERROR_CODE();
         CHECK_NON_NULL(m, false);
         CHECK_IS_EXPR(t, false);
-        model * _m = to_model_ref(m);
+        model * _m = to_model_eval_ref(m);
         params_ref p;
         ast_manager& mgr = mk_c(c)->m();
         if (!_m->has_solver()) {
@@ -172,6 +172,85 @@ extern "C" {
         Z3_CATCH_RETURN(false);
     }
 
+    static model * prepare_eval(Z3_context c, Z3_model m) {
+        model * _m = to_model_eval_ref(m);
+        if (!_m->has_solver())
+            _m->set_solver(alloc(api::seq_expr_solver, mk_c(c)->m(), params_ref()));
+        return _m;
+    }
+
+    /**
+       \brief store the value of a Boolean, integer or bit-vector numeral e in v.
+    */
+    static bool numeral2int64(Z3_context c, expr * e, int64_t & v) {
+        ast_manager & mgr = mk_c(c)->m();
+        rational r;
+        unsigned sz;
+        if (mgr.is_true(e) || mgr.is_false(e)) {
+            v = mgr.is_true(e) ? 1 : 0;
+            return true;
+        }
+        if (mk_c(c)->autil().is_numeral(e, r) && r.is_int64()) {
+            v = r.get_int64();
+            return true;
+        }
+        if (mk_c(c)->bvutil().is_numeral(e, r, sz) && sz <= 64) {
+            v = static_cast<int64_t>(r.get_uint64());
+            return true;
+        }
+        return false;
+    }
+
+    bool Z3_API Z3_model_eval_batch(Z3_context c, Z3_model m, unsigned num_terms, Z3_ast const terms[], bool model_completion, Z3_ast values[]) {
+        Z3_TRY;
+        LOG_Z3_model_eval_batch(c, m, num_terms, terms, model_completion, values);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(m, false);
+        for (unsigned i = 0; i < num_terms; ++i) {
+            values[i] = nullptr;
+            CHECK_IS_EXPR(terms[i], false);
+        }
+        model * _m = prepare_eval(c, m);
+        model::scoped_model_completion _scm(*_m, model_completion);
+        for (unsigned i = 0; i < num_terms; ++i) {
+            expr_ref result = (*_m)(to_expr(terms[i]));
+            mk_c(c)->save_multiple_ast_trail(result);
+            values[i] = of_ast(result.get());
+        }
+        return true;
+        Z3_CATCH_RETURN(false);
+    }
+
+    unsigned Z3_API Z3_eval_int64(Z3_context c, unsigned num_models, Z3_model const models[],
+                                  unsigned num_terms, Z3_ast const terms[], bool model_completion,
+                                  unsigned num_values, int64_t values[], unsigned status[]) {
+        Z3_TRY;
+        LOG_Z3_eval_int64(c, num_models, models, num_terms, terms, model_completion, num_values, values, status);
+        RESET_ERROR_CODE();
+        if (num_values != num_models * num_terms) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "the number of values must be the number of models times the number of terms");
+            return 0;
+        }
+        for (unsigned i = 0; i < num_terms; ++i) {
+            CHECK_IS_EXPR(terms[i], 0);
+        }
+        unsigned num_ok = 0;
+        for (unsigned j = 0; j < num_models; ++j) {
+            CHECK_NON_NULL(models[j], 0);
+            model * _m = prepare_eval(c, models[j]);
+            model::scoped_model_completion _scm(*_m, model_completion);
+            for (unsigned i = 0; i < num_terms; ++i) {
+                unsigned k = j * num_terms + i;
+                values[k] = 0;
+                expr_ref result = (*_m)(to_expr(terms[i]));
+                status[k] = numeral2int64(c, result, values[k]);
+                num_ok += status[k];
+            }
+        }
+        return num_ok;
+        Z3_CATCH_RETURN(0);
+    }
+
     unsigned Z3_API Z3_model_get_num_sorts(Z3_context c, Z3_model m) {
         Z3_TRY;
         LOG_Z3_model_get_num_sorts(c, m);
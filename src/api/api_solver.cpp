@@ -17,10 +17,14 @@ Revision History:
 
 --*/
 #include<thread>
+#include<deque>
+#include<functional>
 #include "util/scoped_ctrl_c.h"
 #include "util/cancel_eh.h"
 #include "util/file_path.h"
 #include "util/scoped_timer.h"
+#include "util/profile.h"
+#include "util/perf_counters.h"
 #include "util/file_path.h"
 #include "ast/ast_pp.h"
 #include "api/z3.h"
@@ -45,6 +49,7 @@ Revision History:
 #include "sat/tactic/sat2goal.h"
 #include "cmd_context/extra_cmds/proof_cmds.h"
 #include "solver/simplifier_solver.h"
+#include "solver/cache_solver.h"
 
 
 extern "C" {
@@ -128,9 +133,23 @@ extern "C" {
 
     void Z3_solver_ref::set_cancel() {
         lock_guard lock(m_mux);
+        if (m_async_state == async_running)
+            m_async_cancel = true;
         if (m_eh) (*m_eh)(API_INTERRUPT_EH_CALLER);
     }
 
+    /**
+       \brief release the references taken by Z3_solver_check_async.
+       It runs on the thread of the caller once the check is observed as completed.
+    */
+    void Z3_solver_ref::finish_async() {
+        m_async_state = async_idle;
+        for (expr* e : m_async_assumptions)
+            m_solver->get_manager().dec_ref(e);
+        m_async_assumptions.reset();
+        dec_ref();
+    }
+
     void Z3_solver_ref::assert_expr(expr * e) {
         if (m_pp) m_pp->assert_expr(e);
         m_solver->assert_expr(e);
@@ -147,12 +166,15 @@ extern "C" {
         params_ref p = s->m_params;
         mk_c(c)->params().get_solver_params(p, proofs_enabled, models_enabled, unsat_core_enabled);
         s->m_solver = (*(s->m_solver_factory))(mk_c(c)->m(), p, proofs_enabled, models_enabled, unsat_core_enabled, s->m_logic);
+        s->m_solver = mk_cache_solver(s->m_solver.get(), p);
         
         param_descrs r;
         s->m_solver->collect_param_descrs(r);
         context_params::collect_solver_param_descrs(r);
         p.validate(r);
         s->m_solver->updt_params(p);
+        if (s->m_progress)
+            s->m_solver->set_progress_callback(s->m_progress.get());
     }
 
     static void init_solver(Z3_context c, Z3_solver s) {
@@ -692,6 +714,135 @@ extern "C" {
         return _solver_check(c, s, num_assumptions, assumptions);
         Z3_CATCH_RETURN(Z3_L_UNDEF);
     }
+
+#ifndef SINGLE_THREAD
+    /**
+       \brief process wide pool of worker threads for asynchronous checks.
+       Threads are created on first use and live until the process exits.
+    */
+    class async_check_pool {
+        std::mutex                        m_mux;
+        std::condition_variable           m_cv;
+        std::deque<std::function<void()>> m_tasks;
+        unsigned                          m_num_threads = 0;
+        unsigned                          m_num_idle = 0;
+
+        void worker() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mux);
+                    ++m_num_idle;
+                    m_cv.wait(lock, [&]() { return !m_tasks.empty(); });
+                    --m_num_idle;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        static async_check_pool& get() {
+            static async_check_pool* pool = new async_check_pool();
+            return *pool;
+        }
+
+        void submit(std::function<void()>&& task) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            m_tasks.push_back(std::move(task));
+            unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+            if (m_tasks.size() > m_num_idle && m_num_threads < max_threads) {
+                ++m_num_threads;
+                std::thread([this]() { worker(); }).detach();
+            }
+            m_cv.notify_one();
+        }
+    };
+#endif
+
+    void Z3_API Z3_solver_check_async(Z3_context c, Z3_solver s, unsigned num_assumptions, Z3_ast const assumptions[], void* user_ctx, Z3_check_done_eh done_eh) {
+        Z3_TRY;
+        LOG_Z3_solver_check_async(c, s, num_assumptions, assumptions, user_ctx, done_eh);
+        RESET_ERROR_CODE();
+        init_solver(c, s);
+        Z3_solver_ref* r = to_solver(s);
+        if (r->m_async_state != Z3_solver_ref::async_idle) {
+            SET_ERROR_CODE(Z3_INVALID_USAGE, "solver already has an asynchronous check that was not waited for");
+            return;
+        }
+        for (unsigned i = 0; i < num_assumptions; ++i) {
+            if (!is_expr(to_ast(assumptions[i]))) {
+                SET_ERROR_CODE(Z3_INVALID_ARG, "assumption is not an expression");
+                return;
+            }
+        }
+        r->inc_ref();
+        for (unsigned i = 0; i < num_assumptions; ++i) {
+            mk_c(c)->m().inc_ref(to_expr(assumptions[i]));
+            r->m_async_assumptions.push_back(to_expr(assumptions[i]));
+        }
+        r->m_async_cancel = false;
+        r->m_async_state = Z3_solver_ref::async_running;
+        auto task = [c, s, r, user_ctx, done_eh]() {
+            Z3_lbool result = Z3_L_UNDEF;
+            if (!r->m_async_cancel) {
+                try {
+                    result = _solver_check(c, s, r->m_async_assumptions.size(), reinterpret_cast<Z3_ast const*>(r->m_async_assumptions.data()));
+                }
+                catch (...) {
+                    result = Z3_L_UNDEF;
+                }
+            }
+            else
+                to_solver_ref(s)->set_reason_unknown("canceled");
+            r->m_async_result = result;
+            if (done_eh)
+                done_eh(user_ctx, s, result);
+#ifndef SINGLE_THREAD
+            std::lock_guard<std::mutex> lock(r->m_mux);
+            r->m_async_state = Z3_solver_ref::async_done;
+            r->m_async_cv.notify_all();
+#else
+            r->m_async_state = Z3_solver_ref::async_done;
+#endif
+        };
+#ifndef SINGLE_THREAD
+        async_check_pool::get().submit(task);
+#else
+        task();
+#endif
+        Z3_CATCH;
+    }
+
+    bool Z3_API Z3_solver_check_async_done(Z3_context c, Z3_solver s) {
+        Z3_TRY;
+        LOG_Z3_solver_check_async_done(c, s);
+        RESET_ERROR_CODE();
+        return to_solver(s)->m_async_state != Z3_solver_ref::async_running;
+        Z3_CATCH_RETURN(false);
+    }
+
+    Z3_lbool Z3_API Z3_solver_check_async_wait(Z3_context c, Z3_solver s) {
+        Z3_TRY;
+        LOG_Z3_solver_check_async_wait(c, s);
+        RESET_ERROR_CODE();
+        Z3_solver_ref* r = to_solver(s);
+        if (r->m_async_state == Z3_solver_ref::async_idle) {
+            SET_ERROR_CODE(Z3_INVALID_USAGE, "solver has no asynchronous check");
+            return Z3_L_UNDEF;
+        }
+#ifndef SINGLE_THREAD
+        {
+            std::unique_lock<std::mutex> lock(r->m_mux);
+            r->m_async_cv.wait(lock, [&]() { return r->m_async_state == Z3_solver_ref::async_done; });
+        }
+#endif
+        Z3_lbool result = r->m_async_result;
+        r->finish_async();
+        return result;
+        Z3_CATCH_RETURN(Z3_L_UNDEF);
+    }
     
     Z3_model Z3_API Z3_solver_get_model(Z3_context c, Z3_solver s) {
         Z3_TRY;
@@ -704,12 +855,11 @@ extern "C" {
             SET_ERROR_CODE(Z3_INVALID_USAGE, "there is no current model");
             RETURN_Z3(nullptr);
         }
-        if (_m) {
-            model_params mp(to_solver_ref(s)->get_params());
-            if (mp.compact()) _m->compress();
-        }
         Z3_model_ref * m_ref = alloc(Z3_model_ref, *mk_c(c)); 
         m_ref->m_model = _m;
+        // compression is deferred until the model is inspected beyond evaluation.
+        model_params mp(to_solver_ref(s)->get_params());
+        m_ref->m_compress = mp.compact();
         mk_c(c)->save_object(m_ref);
         RETURN_Z3(of_model(m_ref));
         Z3_CATCH_RETURN(nullptr);
@@ -786,6 +936,8 @@ extern "C" {
         to_solver_ref(s)->collect_statistics(st->m_stats);
         get_memory_statistics(st->m_stats);
         get_rlimit_statistics(mk_c(c)->m().limit(), st->m_stats);
+        profile::collect_statistics(st->m_stats);
+        perf_counters::collect_statistics(st->m_stats);
         to_solver_ref(s)->collect_timer_stats(st->m_stats);
         mk_c(c)->save_object(st);
         Z3_stats r = of_stats(st);
@@ -1010,6 +1162,45 @@ extern "C" {
         Z3_CATCH;   
     }
 
+    class api_progress_callback : public progress_callback {
+        Z3_context     m_ctx;
+        unsigned       m_interval;
+        void*          m_user_context;
+        Z3_progress_eh* m_eh;
+    public:
+        api_progress_callback(Z3_context c, unsigned interval, void* user_context, Z3_progress_eh* eh):
+            m_ctx(c), m_interval(interval), m_user_context(user_context), m_eh(eh) {}
+
+        unsigned telemetry_interval() const override { return m_interval; }
+
+        void telemetry_sample(statistics const& st) override {
+            Z3_stats_ref * s = alloc(Z3_stats_ref, *mk_c(m_ctx));
+            s->m_stats.copy(st);
+            mk_c(m_ctx)->save_object(s);
+            s->inc_ref();
+            m_eh(m_user_context, of_stats(s));
+            s->dec_ref();
+        }
+    };
+
+    void Z3_API Z3_solver_register_on_progress(
+        Z3_context  c,
+        Z3_solver   s,
+        unsigned    interval_ms,
+        void*       user_context,
+        Z3_progress_eh progress_eh) {
+        Z3_TRY;
+        RESET_ERROR_CODE();
+        init_solver(c, s);
+        auto& solver = *to_solver(s);
+        progress_callback* cb = nullptr;
+        if (interval_ms > 0 && progress_eh)
+            cb = alloc(api_progress_callback, c, interval_ms, user_context, progress_eh);
+        solver.m_solver->set_progress_callback(cb);
+        solver.m_progress = cb;
+        Z3_CATCH;
+    }
+
     void Z3_API Z3_solver_propagate_init(
         Z3_context  c, 
         Z3_solver   s, 
@@ -1104,6 +1295,33 @@ extern "C" {
         Z3_CATCH_RETURN(false);
     }
 
+    unsigned Z3_API Z3_solver_propagate_consequences(Z3_context c, Z3_solver_callback s, unsigned n, Z3_ast const* conseqs, unsigned const* num_fixed, unsigned total_fixed, Z3_ast const* fixed, unsigned const* num_eqs, unsigned total_eqs, Z3_ast const* eq_lhs, Z3_ast const* eq_rhs) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_consequences(c, s, n, conseqs, num_fixed, total_fixed, fixed, num_eqs, total_eqs, eq_lhs, eq_rhs);
+        RESET_ERROR_CODE();
+        unsigned sum_fixed = 0, sum_eqs = 0;
+        for (unsigned i = 0; i < n; ++i)
+            sum_fixed += num_fixed[i], sum_eqs += num_eqs[i];
+        if (sum_fixed != total_fixed || sum_eqs != total_eqs) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "premise counts do not add up to the array lengths");
+            return 0;
+        }
+        auto* cb = reinterpret_cast<user_propagator::callback*>(s);
+        expr* const * _fixed = (expr* const*) fixed;
+        expr* const * _eq_lhs = (expr*const*) eq_lhs;
+        expr* const * _eq_rhs = (expr*const*) eq_rhs;
+        unsigned num_propagated = 0;
+        for (unsigned i = 0; i < n; ++i) {
+            if (cb->propagate_cb(num_fixed[i], _fixed, num_eqs[i], _eq_lhs, _eq_rhs, to_expr(conseqs[i])))
+                ++num_propagated;
+            _fixed += num_fixed[i];
+            _eq_lhs += num_eqs[i];
+            _eq_rhs += num_eqs[i];
+        }
+        return num_propagated;
+        Z3_CATCH_RETURN(0);
+    }
+
     void Z3_API Z3_solver_propagate_created(Z3_context c, Z3_solver s, Z3_created_eh created_eh) {
         Z3_TRY;
         RESET_ERROR_CODE();
@@ -1120,6 +1338,14 @@ extern "C" {
         Z3_CATCH;
     }
 
+    void Z3_API Z3_solver_propagate_batch(Z3_context c, Z3_solver s, Z3_batch_eh batch_eh) {
+        Z3_TRY;
+        RESET_ERROR_CODE();
+        user_propagator::batch_eh_t c = (void(*)(void*, user_propagator::callback*, unsigned, unsigned, expr* const*, expr* const*, unsigned, expr* const*, expr* const*))batch_eh;
+        to_solver_ref(s)->user_propagate_register_batch(c);
+        Z3_CATCH;
+    }
+
     bool Z3_API Z3_solver_next_split(Z3_context c, Z3_solver_callback cb,  Z3_ast t, unsigned idx, Z3_lbool phase) {
         Z3_TRY;
         LOG_Z3_solver_next_split(c, cb, t, idx, phase);
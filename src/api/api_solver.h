@@ -18,8 +18,12 @@ Revision History:
 #pragma once
 
 #include "util/mutex.h"
+#ifndef SINGLE_THREAD
+#include <condition_variable>
+#endif
 #include "api/api_util.h"
 #include "solver/solver.h"
+#include "solver/progress_callback.h"
 
 struct solver2smt2_pp {
     ast_pp_util     m_pp_util;
@@ -46,9 +50,20 @@ struct Z3_solver_ref : public api::object {
     symbol                     m_logic;
     scoped_ptr<solver2smt2_pp> m_pp;
     scoped_ptr<cmd_context>    m_cmd_context;
+    scoped_ptr<progress_callback> m_progress;   // set by Z3_solver_register_on_progress
     mutex                      m_mux;
     event_handler*             m_eh;
 
+    // state of the check started by Z3_solver_check_async
+    enum async_state { async_idle, async_running, async_done };
+    atomic<unsigned>           m_async_state { async_idle };
+    atomic<bool>               m_async_cancel { false };
+    Z3_lbool                   m_async_result = Z3_L_UNDEF;
+    ptr_vector<expr>           m_async_assumptions;
+#ifndef SINGLE_THREAD
+    std::condition_variable    m_async_cv;
+#endif
+
     Z3_solver_ref(api::context& c, solver_factory * f): 
         api::object(c), m_solver_factory(f), m_solver(nullptr), m_logic(symbol::null), m_eh(nullptr) {}
 
@@ -59,6 +74,7 @@ struct Z3_solver_ref : public api::object {
     void assert_expr(expr* e, expr* t);
     void set_eh(event_handler* eh);
     void set_cancel();
+    void finish_async();
 
 };
 
@@ -66,7 +66,7 @@ extern "C" {
             SET_ERROR_CODE(Z3_INVALID_ARG, err.str());
             RETURN_Z3(nullptr);
         }
-        tactic * new_t = t->mk(mk_c(c)->m());
+        tactic * new_t = mk_profiled(t->mk(mk_c(c)->m()));
         RETURN_TACTIC(new_t);
         Z3_CATCH_RETURN(nullptr);
     }
@@ -375,6 +375,24 @@ extern "C" {
         Z3_CATCH_RETURN("");
     }
 
+    Z3_string Z3_API Z3_get_tactic_profile(Z3_context c) {
+        Z3_TRY;
+        LOG_Z3_get_tactic_profile(c);
+        RESET_ERROR_CODE();
+        std::ostringstream buffer;
+        display_tactic_profile(buffer);
+        return mk_c(c)->mk_external_string(buffer.str());
+        Z3_CATCH_RETURN("");
+    }
+
+    void Z3_API Z3_reset_tactic_profile(Z3_context c) {
+        Z3_TRY;
+        LOG_Z3_reset_tactic_profile(c);
+        RESET_ERROR_CODE();
+        reset_tactic_profile();
+        Z3_CATCH;
+    }
+
     Z3_param_descrs Z3_API Z3_tactic_get_param_descrs(Z3_context c, Z3_tactic t) {
         Z3_TRY;
         LOG_Z3_tactic_get_param_descrs(c, t);
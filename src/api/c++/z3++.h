@@ -502,6 +502,16 @@ namespace z3 {
     public:
         param_descrs(context& c, Z3_param_descrs d): object(c), m_descrs(d) { Z3_param_descrs_inc_ref(c, d); }
         param_descrs(param_descrs const& o): object(o.ctx()), m_descrs(o.m_descrs) { Z3_param_descrs_inc_ref(ctx(), m_descrs); }
+        param_descrs(param_descrs && s) noexcept :object(s), m_descrs(s.m_descrs) { s.m_descrs = nullptr; }
+        param_descrs & operator=(param_descrs && s) noexcept {
+            if (this != &s) {
+                if (m_descrs) Z3_param_descrs_dec_ref(ctx(), m_descrs);
+                object::operator=(s);
+                m_descrs = s.m_descrs;
+                s.m_descrs = nullptr;
+            }
+            return *this;
+        }
         param_descrs& operator=(param_descrs const& o) {
             Z3_param_descrs_inc_ref(o.ctx(), o.m_descrs);
             Z3_param_descrs_dec_ref(ctx(), m_descrs);
@@ -509,7 +519,7 @@ namespace z3 {
             object::operator=(o);
             return *this;
         }
-        ~param_descrs() override { Z3_param_descrs_dec_ref(ctx(), m_descrs); }
+        ~param_descrs() override { if (m_descrs) Z3_param_descrs_dec_ref(ctx(), m_descrs); }
         static param_descrs simplify_param_descrs(context& c) { return param_descrs(c, Z3_simplify_get_param_descrs(c)); }
         static param_descrs global_param_descrs(context& c) { return param_descrs(c, Z3_get_global_param_descrs(c)); }
 
@@ -527,8 +537,18 @@ namespace z3 {
     public:
         params(context & c):object(c) { m_params = Z3_mk_params(c); Z3_params_inc_ref(ctx(), m_params); }
         params(params const & s):object(s), m_params(s.m_params) { Z3_params_inc_ref(ctx(), m_params); }
-        ~params() override { Z3_params_dec_ref(ctx(), m_params); }
+        params(params && s) noexcept :object(s), m_params(s.m_params) { s.m_params = nullptr; }
+        ~params() override { if (m_params) Z3_params_dec_ref(ctx(), m_params); }
         operator Z3_params() const { return m_params; }
+        params & operator=(params && s) noexcept {
+            if (this != &s) {
+                if (m_params) Z3_params_dec_ref(ctx(), m_params);
+                object::operator=(s);
+                m_params = s.m_params;
+                s.m_params = nullptr;
+            }
+            return *this;
+        }
         params & operator=(params const & s) {
             Z3_params_inc_ref(s.ctx(), s.m_params);
             Z3_params_dec_ref(ctx(), m_params);
@@ -555,9 +575,20 @@ namespace z3 {
         ast(context & c):object(c), m_ast(0) {}
         ast(context & c, Z3_ast n):object(c), m_ast(n) { Z3_inc_ref(ctx(), m_ast); }
         ast(ast const & s) :object(s), m_ast(s.m_ast) { Z3_inc_ref(ctx(), m_ast); }
+        ast(ast && s) noexcept :object(s), m_ast(s.m_ast) { s.m_ast = 0; }
         ~ast() override { if (m_ast) { Z3_dec_ref(*m_ctx, m_ast); } }
         operator Z3_ast() const { return m_ast; }
         operator bool() const { return m_ast != 0; }
+        ast & operator=(ast && s) noexcept {
+            if (this != &s) {
+                if (m_ast)
+                    Z3_dec_ref(ctx(), m_ast);
+                object::operator=(s);
+                m_ast = s.m_ast;
+                s.m_ast = 0;
+            }
+            return *this;
+        }
         ast & operator=(ast const & s) {
             Z3_inc_ref(s.ctx(), s.m_ast);
             if (m_ast)
@@ -591,9 +622,10 @@ namespace z3 {
         ast_vector_tpl(context & c):object(c) { init(Z3_mk_ast_vector(c)); }
         ast_vector_tpl(context & c, Z3_ast_vector v):object(c) { init(v); }
         ast_vector_tpl(ast_vector_tpl const & s):object(s), m_vector(s.m_vector) { Z3_ast_vector_inc_ref(ctx(), m_vector); }
+        ast_vector_tpl(ast_vector_tpl && s) noexcept :object(s), m_vector(s.m_vector) { s.m_vector = nullptr; }
         ast_vector_tpl(context& c, ast_vector_tpl const& src): object(c) { init(Z3_ast_vector_translate(src.ctx(), src, c)); }
 
-        ~ast_vector_tpl() override { Z3_ast_vector_dec_ref(ctx(), m_vector); }
+        ~ast_vector_tpl() override { if (m_vector) Z3_ast_vector_dec_ref(ctx(), m_vector); }
         operator Z3_ast_vector() const { return m_vector; }
         unsigned size() const { return Z3_ast_vector_size(ctx(), m_vector); }
         T operator[](unsigned i) const { Z3_ast r = Z3_ast_vector_get(ctx(), m_vector, i); check_error(); return cast_ast<T>()(ctx(), r); }
@@ -602,6 +634,15 @@ namespace z3 {
         T back() const { return operator[](size() - 1); }
         void pop_back() { assert(size() > 0); resize(size() - 1); }
         bool empty() const { return size() == 0; }
+        ast_vector_tpl & operator=(ast_vector_tpl && s) noexcept {
+            if (this != &s) {
+                if (m_vector) Z3_ast_vector_dec_ref(ctx(), m_vector);
+                object::operator=(s);
+                m_vector = s.m_vector;
+                s.m_vector = nullptr;
+            }
+            return *this;
+        }
         ast_vector_tpl & operator=(ast_vector_tpl const & s) {
             Z3_ast_vector_inc_ref(s.ctx(), s.m_vector);
             Z3_ast_vector_dec_ref(ctx(), m_vector);
@@ -1619,6 +1660,54 @@ namespace z3 {
 
    };
 
+    /**
+       \brief A non-owning view of an expression.
+
+       Unlike #expr, it does not update reference counts. Sub-terms are kept
+       alive by the expression they belong to, so a view and the views of
+       its arguments are valid as long as the #expr it was created from.
+       Use it for read-only traversals that would otherwise create an #expr
+       for every sub-term.
+    */
+    class expr_view {
+        context * m_ctx;
+        Z3_ast    m_ast;
+    public:
+        expr_view(expr const & e):m_ctx(&e.ctx()), m_ast(e) {}
+        expr_view(context & c, Z3_ast a):m_ctx(&c), m_ast(a) {}
+        context & ctx() const { return *m_ctx; }
+        operator Z3_ast() const { return m_ast; }
+        Z3_error_code check_error() const { return m_ctx->check_error(); }
+
+        Z3_ast_kind kind() const { Z3_ast_kind r = Z3_get_ast_kind(ctx(), m_ast); check_error(); return r; }
+        bool is_app() const { return kind() == Z3_APP_AST || kind() == Z3_NUMERAL_AST; }
+        bool is_numeral() const { return kind() == Z3_NUMERAL_AST; }
+        bool is_quantifier() const { return kind() == Z3_QUANTIFIER_AST; }
+        bool is_var() const { return kind() == Z3_VAR_AST; }
+        unsigned id() const { unsigned r = Z3_get_ast_id(ctx(), m_ast); check_error(); return r; }
+        unsigned hash() const { unsigned r = Z3_get_ast_hash(ctx(), m_ast); check_error(); return r; }
+
+        /**
+           \brief Return the declaration of this application, without taking a reference.
+
+           \pre is_app()
+        */
+        Z3_func_decl decl() const { Z3_func_decl f = Z3_get_app_decl(ctx(), Z3_to_app(ctx(), m_ast)); check_error(); return f; }
+        Z3_decl_kind decl_kind() const { return Z3_get_decl_kind(ctx(), decl()); }
+        Z3_sort get_sort() const { Z3_sort s = Z3_get_sort(ctx(), m_ast); check_error(); return s; }
+        unsigned num_args() const { unsigned r = Z3_get_app_num_args(ctx(), Z3_to_app(ctx(), m_ast)); check_error(); return r; }
+        expr_view arg(unsigned i) const { Z3_ast r = Z3_get_app_arg(ctx(), Z3_to_app(ctx(), m_ast), i); check_error(); return expr_view(ctx(), r); }
+        expr_view body() const { assert(is_quantifier()); Z3_ast r = Z3_get_quantifier_body(ctx(), m_ast); check_error(); return expr_view(ctx(), r); }
+
+        /**
+           \brief Return an owning expression for this view.
+        */
+        expr to_expr() const { return expr(ctx(), m_ast); }
+
+        bool operator==(expr_view const & other) const { return m_ast == other.m_ast; }
+        bool operator!=(expr_view const & other) const { return m_ast != other.m_ast; }
+    };
+
 #define _Z3_MK_BIN_(a, b, binop)                        \
     check_context(a, b);                                \
     Z3_ast r = binop(a.ctx(), a, b);                    \
@@ -2556,8 +2645,18 @@ namespace z3 {
     public:
         func_entry(context & c, Z3_func_entry e):object(c) { init(e); }
         func_entry(func_entry const & s):object(s) { init(s.m_entry); }
-        ~func_entry() override { Z3_func_entry_dec_ref(ctx(), m_entry); }
+        func_entry(func_entry && s) noexcept :object(s), m_entry(s.m_entry) { s.m_entry = nullptr; }
+        ~func_entry() override { if (m_entry) Z3_func_entry_dec_ref(ctx(), m_entry); }
         operator Z3_func_entry() const { return m_entry; }
+        func_entry & operator=(func_entry && s) noexcept {
+            if (this != &s) {
+                if (m_entry) Z3_func_entry_dec_ref(ctx(), m_entry);
+                object::operator=(s);
+                m_entry = s.m_entry;
+                s.m_entry = nullptr;
+            }
+            return *this;
+        }
         func_entry & operator=(func_entry const & s) {
             Z3_func_entry_inc_ref(s.ctx(), s.m_entry);
             Z3_func_entry_dec_ref(ctx(), m_entry);
@@ -2579,8 +2678,18 @@ namespace z3 {
     public:
         func_interp(context & c, Z3_func_interp e):object(c) { init(e); }
         func_interp(func_interp const & s):object(s) { init(s.m_interp); }
-        ~func_interp() override { Z3_func_interp_dec_ref(ctx(), m_interp); }
+        func_interp(func_interp && s) noexcept :object(s), m_interp(s.m_interp) { s.m_interp = nullptr; }
+        ~func_interp() override { if (m_interp) Z3_func_interp_dec_ref(ctx(), m_interp); }
         operator Z3_func_interp() const { return m_interp; }
+        func_interp & operator=(func_interp && s) noexcept {
+            if (this != &s) {
+                if (m_interp) Z3_func_interp_dec_ref(ctx(), m_interp);
+                object::operator=(s);
+                m_interp = s.m_interp;
+                s.m_interp = nullptr;
+            }
+            return *this;
+        }
         func_interp & operator=(func_interp const & s) {
             Z3_func_interp_inc_ref(s.ctx(), s.m_interp);
             Z3_func_interp_dec_ref(ctx(), m_interp);
@@ -2612,9 +2721,19 @@ namespace z3 {
         model(context & c):object(c) { init(Z3_mk_model(c)); }
         model(context & c, Z3_model m):object(c) { init(m); }
         model(model const & s):object(s) { init(s.m_model); }
+        model(model && s) noexcept :object(s), m_model(s.m_model) { s.m_model = nullptr; }
         model(model& src, context& dst, translate) : object(dst) { init(Z3_model_translate(src.ctx(), src, dst)); }
-        ~model() override { Z3_model_dec_ref(ctx(), m_model); }
+        ~model() override { if (m_model) Z3_model_dec_ref(ctx(), m_model); }
         operator Z3_model() const { return m_model; }
+        model & operator=(model && s) noexcept {
+            if (this != &s) {
+                if (m_model) Z3_model_dec_ref(ctx(), m_model);
+                object::operator=(s);
+                m_model = s.m_model;
+                s.m_model = nullptr;
+            }
+            return *this;
+        }
         model & operator=(model const & s) {
             Z3_model_inc_ref(s.ctx(), s.m_model);
             Z3_model_dec_ref(ctx(), m_model);
@@ -2693,8 +2812,18 @@ namespace z3 {
         stats(context & c):object(c), m_stats(0) {}
         stats(context & c, Z3_stats e):object(c) { init(e); }
         stats(stats const & s):object(s) { init(s.m_stats); }
+        stats(stats && s) noexcept :object(s), m_stats(s.m_stats) { s.m_stats = nullptr; }
         ~stats() override { if (m_stats) Z3_stats_dec_ref(ctx(), m_stats); }
         operator Z3_stats() const { return m_stats; }
+        stats & operator=(stats && s) noexcept {
+            if (this != &s) {
+                if (m_stats) Z3_stats_dec_ref(ctx(), m_stats);
+                object::operator=(s);
+                m_stats = s.m_stats;
+                s.m_stats = nullptr;
+            }
+            return *this;
+        }
         stats & operator=(stats const & s) {
             Z3_stats_inc_ref(s.ctx(), s.m_stats);
             if (m_stats) Z3_stats_dec_ref(ctx(), m_stats);
@@ -2774,9 +2903,19 @@ namespace z3 {
         solver(context & c, char const * logic):object(c) { init(Z3_mk_solver_for_logic(c, c.str_symbol(logic))); check_error(); }
         solver(context & c, solver const& src, translate): object(c) { Z3_solver s = Z3_solver_translate(src.ctx(), src, c); check_error(); init(s); }
         solver(solver const & s):object(s) { init(s.m_solver); }
+        solver(solver && s) noexcept :object(s), m_solver(s.m_solver) { s.m_solver = nullptr; }
         solver(solver const& s, simplifier const& simp);
-        ~solver() override { Z3_solver_dec_ref(ctx(), m_solver); }
+        ~solver() override { if (m_solver) Z3_solver_dec_ref(ctx(), m_solver); }
         operator Z3_solver() const { return m_solver; }
+        solver & operator=(solver && s) noexcept {
+            if (this != &s) {
+                if (m_solver) Z3_solver_dec_ref(ctx(), m_solver);
+                object::operator=(s);
+                m_solver = s.m_solver;
+                s.m_solver = nullptr;
+            }
+            return *this;
+        }
         solver & operator=(solver const & s) {
             Z3_solver_inc_ref(s.ctx(), s.m_solver);
             Z3_solver_dec_ref(ctx(), m_solver);
@@ -3007,8 +3146,18 @@ namespace z3 {
         goal(context & c, bool models=true, bool unsat_cores=false, bool proofs=false):object(c) { init(Z3_mk_goal(c, models, unsat_cores, proofs)); }
         goal(context & c, Z3_goal s):object(c) { init(s); }
         goal(goal const & s):object(s) { init(s.m_goal); }
-        ~goal() override { Z3_goal_dec_ref(ctx(), m_goal); }
+        goal(goal && s) noexcept :object(s), m_goal(s.m_goal) { s.m_goal = nullptr; }
+        ~goal() override { if (m_goal) Z3_goal_dec_ref(ctx(), m_goal); }
         operator Z3_goal() const { return m_goal; }
+        goal & operator=(goal && s) noexcept {
+            if (this != &s) {
+                if (m_goal) Z3_goal_dec_ref(ctx(), m_goal);
+                object::operator=(s);
+                m_goal = s.m_goal;
+                s.m_goal = nullptr;
+            }
+            return *this;
+        }
         goal & operator=(goal const & s) {
             Z3_goal_inc_ref(s.ctx(), s.m_goal);
             Z3_goal_dec_ref(ctx(), m_goal);
@@ -3065,8 +3214,18 @@ namespace z3 {
     public:
         apply_result(context & c, Z3_apply_result s):object(c) { init(s); }
         apply_result(apply_result const & s):object(s) { init(s.m_apply_result); }
-        ~apply_result() override { Z3_apply_result_dec_ref(ctx(), m_apply_result); }
+        apply_result(apply_result && s) noexcept :object(s), m_apply_result(s.m_apply_result) { s.m_apply_result = nullptr; }
+        ~apply_result() override { if (m_apply_result) Z3_apply_result_dec_ref(ctx(), m_apply_result); }
         operator Z3_apply_result() const { return m_apply_result; }
+        apply_result & operator=(apply_result && s) noexcept {
+            if (this != &s) {
+                if (m_apply_result) Z3_apply_result_dec_ref(ctx(), m_apply_result);
+                object::operator=(s);
+                m_apply_result = s.m_apply_result;
+                s.m_apply_result = nullptr;
+            }
+            return *this;
+        }
         apply_result & operator=(apply_result const & s) {
             Z3_apply_result_inc_ref(s.ctx(), s.m_apply_result);
             Z3_apply_result_dec_ref(ctx(), m_apply_result);
@@ -3090,8 +3249,18 @@ namespace z3 {
         tactic(context & c, char const * name):object(c) { Z3_tactic r = Z3_mk_tactic(c, name); check_error(); init(r); }
         tactic(context & c, Z3_tactic s):object(c) { init(s); }
         tactic(tactic const & s):object(s) { init(s.m_tactic); }
-        ~tactic() override { Z3_tactic_dec_ref(ctx(), m_tactic); }
+        tactic(tactic && s) noexcept :object(s), m_tactic(s.m_tactic) { s.m_tactic = nullptr; }
+        ~tactic() override { if (m_tactic) Z3_tactic_dec_ref(ctx(), m_tactic); }
         operator Z3_tactic() const { return m_tactic; }
+        tactic & operator=(tactic && s) noexcept {
+            if (this != &s) {
+                if (m_tactic) Z3_tactic_dec_ref(ctx(), m_tactic);
+                object::operator=(s);
+                m_tactic = s.m_tactic;
+                s.m_tactic = nullptr;
+            }
+            return *this;
+        }
         tactic & operator=(tactic const & s) {
             Z3_tactic_inc_ref(s.ctx(), s.m_tactic);
             Z3_tactic_dec_ref(ctx(), m_tactic);
@@ -3176,8 +3345,18 @@ namespace z3 {
         simplifier(context & c, char const * name):object(c) { Z3_simplifier r = Z3_mk_simplifier(c, name); check_error(); init(r); }
         simplifier(context & c, Z3_simplifier s):object(c) { init(s); }
         simplifier(simplifier const & s):object(s) { init(s.m_simplifier); }
-        ~simplifier() override { Z3_simplifier_dec_ref(ctx(), m_simplifier); }
+        simplifier(simplifier && s) noexcept :object(s), m_simplifier(s.m_simplifier) { s.m_simplifier = nullptr; }
+        ~simplifier() override { if (m_simplifier) Z3_simplifier_dec_ref(ctx(), m_simplifier); }
         operator Z3_simplifier() const { return m_simplifier; }
+        simplifier & operator=(simplifier && s) noexcept {
+            if (this != &s) {
+                if (m_simplifier) Z3_simplifier_dec_ref(ctx(), m_simplifier);
+                object::operator=(s);
+                m_simplifier = s.m_simplifier;
+                s.m_simplifier = nullptr;
+            }
+            return *this;
+        }
         simplifier & operator=(simplifier const & s) {
             Z3_simplifier_inc_ref(s.ctx(), s.m_simplifier);
             Z3_simplifier_dec_ref(ctx(), m_simplifier);
@@ -3218,8 +3397,18 @@ namespace z3 {
         probe(context & c, double val):object(c) { Z3_probe r = Z3_probe_const(c, val); check_error(); init(r); }
         probe(context & c, Z3_probe s):object(c) { init(s); }
         probe(probe const & s):object(s) { init(s.m_probe); }
-        ~probe() override { Z3_probe_dec_ref(ctx(), m_probe); }
+        probe(probe && s) noexcept :object(s), m_probe(s.m_probe) { s.m_probe = nullptr; }
+        ~probe() override { if (m_probe) Z3_probe_dec_ref(ctx(), m_probe); }
         operator Z3_probe() const { return m_probe; }
+        probe & operator=(probe && s) noexcept {
+            if (this != &s) {
+                if (m_probe) Z3_probe_dec_ref(ctx(), m_probe);
+                object::operator=(s);
+                m_probe = s.m_probe;
+                s.m_probe = nullptr;
+            }
+            return *this;
+        }
         probe & operator=(probe const & s) {
             Z3_probe_inc_ref(s.ctx(), s.m_probe);
             Z3_probe_dec_ref(ctx(), m_probe);
@@ -3298,6 +3487,7 @@ namespace z3 {
         optimize(optimize const & o):object(o), m_opt(o.m_opt) {
             Z3_optimize_inc_ref(o.ctx(), o.m_opt);
         }
+        optimize(optimize && s) noexcept :object(s), m_opt(s.m_opt) { s.m_opt = nullptr; }
         optimize(context& c, optimize& src):object(c) {
             m_opt = Z3_mk_optimize(c); 
             Z3_optimize_inc_ref(c, m_opt);
@@ -3305,6 +3495,15 @@ namespace z3 {
             expr_vector v(c, src.objectives());
             for (expr_vector::iterator it = v.begin(); it != v.end(); ++it) minimize(*it);
         }
+        optimize & operator=(optimize && s) noexcept {
+            if (this != &s) {
+                if (m_opt) Z3_optimize_dec_ref(ctx(), m_opt);
+                object::operator=(s);
+                m_opt = s.m_opt;
+                s.m_opt = nullptr;
+            }
+            return *this;
+        }
         optimize& operator=(optimize const& o) {
             Z3_optimize_inc_ref(o.ctx(), o.m_opt);
             Z3_optimize_dec_ref(ctx(), m_opt);
@@ -3312,7 +3511,7 @@ namespace z3 {
             object::operator=(o);
             return *this;
         }
-        ~optimize() override { Z3_optimize_dec_ref(ctx(), m_opt); }
+        ~optimize() override { if (m_opt) Z3_optimize_dec_ref(ctx(), m_opt); }
         operator Z3_optimize() const { return m_opt; }
         void add(expr const& e) {
             assert(e.is_bool());
@@ -3404,7 +3603,17 @@ namespace z3 {
     public:
         fixedpoint(context& c):object(c) { m_fp = Z3_mk_fixedpoint(c); Z3_fixedpoint_inc_ref(c, m_fp); }
         fixedpoint(fixedpoint const & o):object(o), m_fp(o.m_fp) { Z3_fixedpoint_inc_ref(ctx(), m_fp); }
-        ~fixedpoint() override { Z3_fixedpoint_dec_ref(ctx(), m_fp); }
+        fixedpoint(fixedpoint && s) noexcept :object(s), m_fp(s.m_fp) { s.m_fp = nullptr; }
+        ~fixedpoint() override { if (m_fp) Z3_fixedpoint_dec_ref(ctx(), m_fp); }
+        fixedpoint & operator=(fixedpoint && s) noexcept {
+            if (this != &s) {
+                if (m_fp) Z3_fixedpoint_dec_ref(ctx(), m_fp);
+                object::operator=(s);
+                m_fp = s.m_fp;
+                s.m_fp = nullptr;
+            }
+            return *this;
+        }
         fixedpoint & operator=(fixedpoint const & o) {
             Z3_fixedpoint_inc_ref(o.ctx(), o.m_fp);
             Z3_fixedpoint_dec_ref(ctx(), m_fp);
@@ -3425,6 +3634,7 @@ namespace z3 {
         }
         void add_rule(expr& rule, symbol const& name) { Z3_fixedpoint_add_rule(ctx(), m_fp, rule, name); check_error(); }
         void add_fact(func_decl& f, unsigned * args) { Z3_fixedpoint_add_fact(ctx(), m_fp, f, f.arity(), args); check_error(); }
+        void add_facts(func_decl& f, unsigned num_facts, unsigned const * args) { Z3_fixedpoint_add_facts(ctx(), m_fp, f, num_facts * f.arity(), args); check_error(); }
         check_result query(expr& q) { Z3_lbool r = Z3_fixedpoint_query(ctx(), m_fp, q); check_error(); return to_check_result(r); }
         check_result query(func_decl_vector& relations) {
             array<Z3_func_decl> rs(relations);
@@ -8,7 +8,12 @@ import { asyncFuncs } from './async-fns';
 import { makeCCWrapper } from './make-cc-wrapper';
 import { functions } from './parse-api';
 
-console.log('--- Building WASM');
+// `--threads` builds the variant in which libz3 itself is multi-threaded, so that
+// sat.threads, smt.threads and parallel.enable work and contexts check in parallel.
+const threads = process.argv.includes('--threads');
+const poolSize = process.env.Z3_WASM_POOL_SIZE ?? '8';
+
+console.log(`--- Building WASM${threads ? ' (threads)' : ''}`);
 
 const SWAP_OPTS: SpawnOptions = {
   shell: true,
@@ -40,7 +45,14 @@ function spawnSync(command: string, opts: SpawnOptions = {}) {
 }
 
 function exportedFuncs(): string[] {
-  const extras = ['_malloc', '_set_throwy_error_handler', '_set_noop_error_handler', ...asyncFuncs.map(f => '_async_' + f)];
+  const extras = [
+    '_malloc',
+    '_set_throwy_error_handler',
+    '_set_noop_error_handler',
+    '_set_async_call_id',
+    '_async_is_parallel',
+    ...asyncFuncs.map(f => '_async_' + f),
+  ];
 
   // TODO(ritave): This variable is unused in original script, find out if it's important
   const fns: any[] = (functions as any[]).filter(f => !asyncFuncs.includes(f.name));
@@ -51,14 +63,17 @@ function exportedFuncs(): string[] {
 assert(fs.existsSync('./package.json'), 'Not in the root directory of js api');
 const z3RootDir = path.join(process.cwd(), '../../../');
 
+const buildDir = threads ? 'build-threads' : 'build';
+
 // TODO(ritave): Detect if it's in the configuration we need
-if (!existsSync(path.join(z3RootDir, 'build/Makefile'))) {
-  spawnSync('emconfigure python scripts/mk_make.py --staticlib --single-threaded --arm64=false', {
+if (!existsSync(path.join(z3RootDir, buildDir, 'Makefile'))) {
+  const singleThreaded = threads ? '' : ' --single-threaded';
+  spawnSync(`emconfigure python scripts/mk_make.py --staticlib${singleThreaded} --arm64=false -b ${buildDir}`, {
     cwd: z3RootDir,
   });
 }
 
-spawnSync(`emmake make -j${os.cpus().length} libz3.a`, { cwd: path.join(z3RootDir, 'build') });
+spawnSync(`emmake make -j${os.cpus().length} libz3.a`, { cwd: path.join(z3RootDir, buildDir) });
 
 const ccWrapperPath = 'build/async-fns.cc';
 console.log(`- Building ${ccWrapperPath}`);
@@ -67,9 +82,13 @@ fs.writeFileSync(ccWrapperPath, makeCCWrapper());
 
 const fns = JSON.stringify(exportedFuncs());
 const methods = '["ccall","FS","allocate","UTF8ToString","intArrayFromString","ALLOC_NORMAL"]';
-const libz3a = path.normalize('../../../build/libz3.a');
+const libz3a = path.normalize(`../../../${buildDir}/libz3.a`);
+// the threaded variant starts a pool of workers up front, since threads spawned by
+// Z3 block on their workers and cannot wait for them to be created lazily
+const threadOpts = threads ? `-DZ3_WASM_THREADS -s PTHREAD_POOL_SIZE=${poolSize}` : '-s PTHREAD_POOL_SIZE=0';
+const output = threads ? 'build/z3-built-threads.js' : 'build/z3-built.js';
 spawnSync(
-  `emcc build/async-fns.cc ${libz3a} --std=c++20 --pre-js src/low-level/async-wrapper.js -g2 -pthread -fexceptions -s WASM_BIGINT -s USE_PTHREADS=1 -s PTHREAD_POOL_SIZE=0 -s PTHREAD_POOL_SIZE_STRICT=0 -s MODULARIZE=1 -s 'EXPORT_NAME="initZ3"' -s EXPORTED_RUNTIME_METHODS=${methods} -s EXPORTED_FUNCTIONS=${fns} -s DISABLE_EXCEPTION_CATCHING=0 -s SAFE_HEAP=0 -s DEMANGLE_SUPPORT=1 -s TOTAL_MEMORY=2GB -s TOTAL_STACK=20MB -I z3/src/api/ -o build/z3-built.js`,
+  `emcc build/async-fns.cc ${libz3a} --std=c++20 --pre-js src/low-level/async-wrapper.js -g2 -pthread -fexceptions -s WASM_BIGINT -s USE_PTHREADS=1 ${threadOpts} -s PTHREAD_POOL_SIZE_STRICT=0 -s MODULARIZE=1 -s 'EXPORT_NAME="initZ3"' -s EXPORTED_RUNTIME_METHODS=${methods} -s EXPORTED_FUNCTIONS=${fns} -s DISABLE_EXCEPTION_CATCHING=0 -s SAFE_HEAP=0 -s DEMANGLE_SUPPORT=1 -s TOTAL_MEMORY=2GB -s TOTAL_STACK=20MB -I z3/src/api/ -o ${output}`,
 );
 
 fs.rmSync(ccWrapperPath);
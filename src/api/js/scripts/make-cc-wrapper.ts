@@ -41,22 +41,39 @@ extern "C" void async_${fn.name}(${fn.params
 
 #include "../../z3.h"
 
+// identifies the promise of the next async call, see async_call in async-wrapper.js
+static unsigned g_async_call_id = 0;
+
+extern "C" void set_async_call_id(unsigned id) {
+  g_async_call_id = id;
+}
+
+// whether libz3 was built with threads, so that calls on different contexts may run concurrently
+extern "C" bool async_is_parallel() {
+#ifdef Z3_WASM_THREADS
+  return true;
+#else
+  return false;
+#endif
+}
+
 template<typename Fn, Fn fn, typename... Args>
 void wrapper(Args&&... args) {
-  std::thread t([...args = std::forward<Args>(args)] {
+  unsigned id = g_async_call_id;
+  std::thread t([id, ...args = std::forward<Args>(args)] {
     try {
       auto result = fn(args...);
       MAIN_THREAD_ASYNC_EM_ASM({
-        resolve_async($0);
-      }, result);
+        resolve_async($0, $1);
+      }, id, result);
     } catch (std::exception& e) {
       MAIN_THREAD_ASYNC_EM_ASM({
-        reject_async(new Error(UTF8ToString($0)));
-      }, e.what());
+        reject_async($0, new Error(UTF8ToString($1)));
+      }, id, e.what());
     } catch (...) {
       MAIN_THREAD_ASYNC_EM_ASM({
-        reject_async('failed with unknown exception');
-      });
+        reject_async($0, 'failed with unknown exception');
+      }, id);
     }
   });
   t.detach();
@@ -64,20 +81,21 @@ void wrapper(Args&&... args) {
 
 template<typename Fn, Fn fn, typename... Args>
 void wrapper_str(Args&&... args) {
-  std::thread t([...args = std::forward<Args>(args)] {
+  unsigned id = g_async_call_id;
+  std::thread t([id, ...args = std::forward<Args>(args)] {
     try {
       auto result = fn(args...);
       MAIN_THREAD_ASYNC_EM_ASM({
-        resolve_async(UTF8ToString($0));
-      }, result);
+        resolve_async($0, UTF8ToString($1));
+      }, id, result);
     } catch (std::exception& e) {
       MAIN_THREAD_ASYNC_EM_ASM({
-        reject_async(new Error(UTF8ToString($0)));
-      }, e.what());
+        reject_async($0, new Error(UTF8ToString($1)));
+      }, id, e.what());
     } catch (...) {
       MAIN_THREAD_ASYNC_EM_ASM({
-        reject_async(new Error('failed with unknown exception'));
-      });
+        reject_async($0, new Error('failed with unknown exception'));
+      }, id);
     }
   });
   t.detach();
@@ -451,6 +451,10 @@ export async function init(initModule: any) {
         Mod._set_noop_error_handler(ctx);
         return ctx;
       },
+      // true if libz3 was built with threads and async calls on different contexts run in parallel
+      async_is_parallel: function(): boolean {
+        return Mod._async_is_parallel() !== 0;
+      },
       ${functions
         .map(wrapFunction)
         .filter(f => f != null)
@@ -91,7 +91,8 @@ import { allSatisfy, assert, assertExhaustive } from './utils';
 
 const FALLBACK_PRECISION = 17;
 
-const asyncMutex = new Mutex();
+// serializes async calls when libz3 is single-threaded
+const globalAsyncMutex = new Mutex();
 
 function isCoercibleRational(obj: any): obj is CoercibleRational {
   // prettier-ignore
@@ -174,6 +175,9 @@ export function createApi(Z3: Z3Core): Z3HighLevel {
     Z3.set_ast_print_mode(contextPtr, Z3_ast_print_mode.Z3_PRINT_SMTLIB2_COMPLIANT);
     Z3.del_config(cfg);
 
+    // with a threaded libz3, long checks of different contexts run on their own workers
+    const asyncMutex = Z3.async_is_parallel() ? new Mutex() : globalAsyncMutex;
+
     function _assertContext(...ctxs: (Context<Name> | { ctx: Context<Name> })[]) {
       ctxs.forEach(other => assert('ctx' in other ? ctx === other.ctx : ctx === other, 'Context mismatch'));
     }
@@ -579,7 +583,7 @@ export function createApi(Z3: Z3Core): Z3HighLevel {
     ///////////////////////////////
 
     async function simplify(e: Expr<Name>): Promise<Expr<Name>> {
-      const result = await Z3.simplify(contextPtr, e.ast);
+      const result = await asyncMutex.runExclusive(() => Z3.simplify(contextPtr, e.ast));
       return _toExpr(check(result));
     }
 
@@ -1,26 +1,29 @@
 // this wrapper works with async-fns to provide promise-based off-thread versions of some functions
 // It's prepended directly by emscripten to the resulting z3-built.js
 
-let capability = null;
-function resolve_async(val) {
+// pending async calls by id; the C wrappers report back the id of the call they finished
+let capabilities = new Map();
+let nextAsyncId = 0;
+
+function resolve_async(id, val) {
   // setTimeout is a workaround for https://github.com/emscripten-core/emscripten/issues/15900
-  if (capability == null) {
+  let cap = capabilities.get(id);
+  if (cap === undefined) {
     return;
   }
-  let cap = capability;
-  capability = null;
+  capabilities.delete(id);
 
   setTimeout(() => {
     cap.resolve(val);
   }, 0);
 }
 
-function reject_async(val) {
-  if (capability == null) {
+function reject_async(id, val) {
+  let cap = capabilities.get(id);
+  if (cap === undefined) {
     return;
   }
-  let cap = capability;
-  capability = null;
+  capabilities.delete(id);
 
   setTimeout(() => {
     cap.reject(val);
@@ -28,12 +31,21 @@ function reject_async(val) {
 }
 
 Module.async_call = function (f, ...args) {
-  if (capability !== null) {
+  // a single-threaded libz3 can only run one call at a time
+  if (capabilities.size > 0 && !Module._async_is_parallel()) {
     throw new Error(`you can't execute multiple async functions at the same time; let the previous one finish first`);
   }
+  let id = nextAsyncId;
+  nextAsyncId = (nextAsyncId + 1) >>> 0;
   let promise = new Promise((resolve, reject) => {
-    capability = { resolve, reject };
+    capabilities.set(id, { resolve, reject });
   });
-  f(...args);
+  Module._set_async_call_id(id);
+  try {
+    f(...args);
+  } catch (e) {
+    capabilities.delete(id);
+    throw e;
+  }
   return promise;
 };
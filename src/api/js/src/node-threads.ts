@@ -0,0 +1,18 @@
+// @ts-ignore no-implicit-any
+import initModule = require('./z3-built-threads');
+
+import { createApi, Z3HighLevel } from './high-level';
+import { init as initWrapper, Z3LowLevel } from './low-level';
+export * from './high-level/types';
+export { Z3Core, Z3LowLevel } from './low-level';
+export * from './low-level/types.__GENERATED__';
+
+/**
+ * Entry point for the threaded build of Z3, see `npm run build:wasm:threads`.
+ * It has the same API as `init` in `node`.
+ * @category Global */
+export async function init(): Promise<Z3HighLevel & Z3LowLevel> {
+  const lowLevel = await initWrapper(initModule);
+  const highLevel = createApi(lowLevel.Z3);
+  return { ...lowLevel, ...highLevel };
+}
@@ -53,6 +53,7 @@ import sys
 import io
 import math
 import copy
+import collections.abc
 if sys.version_info.major >= 3:
     from typing import Iterable
 
@@ -147,6 +148,8 @@ def _get_args(args):
             return args[0]
         elif len(args) == 1 and (isinstance(args[0], set) or isinstance(args[0], AstVector)):
             return [arg for arg in args[0]]
+        elif len(args) == 1 and isinstance(args[0], collections.abc.Iterator):
+            return list(args[0])
         else:
             return args
     except TypeError:  # len is not necessarily defined when args is not a sequence (use reflection?)
@@ -205,12 +208,19 @@ class Context:
                 prev = None
         self.ctx = Z3_mk_context_rc(conf)
         self.owner = True
+        self._dec_refs = []
         self.eh = Z3_set_error_handler(self.ctx, z3_error_handler)
         Z3_set_ast_print_mode(self.ctx, Z3_PRINT_SMTLIB2_COMPLIANT)
         Z3_del_config(conf)
 
+    # ASTs whose Python wrappers were collected and that are waiting to be
+    # released by a single call to Z3_dec_ref_array. Contexts that wrap a
+    # context they do not own release ASTs immediately.
+    _dec_refs = None
+
     def __del__(self):
         if Z3_del_context is not None and self.owner:
+            self._dec_refs = None
             Z3_del_context(self.ctx)
         self.ctx = None
         self.eh = None
@@ -219,6 +229,21 @@ class Context:
         """Return a reference to the actual C pointer to the Z3 context."""
         return self.ctx
 
+    def _dec_ref(self, a):
+        q = self._dec_refs
+        if q is None:
+            Z3_dec_ref(self.ctx, a)
+            return
+        q.append(a)
+        if len(q) >= _dec_ref_batch_size:
+            self._flush_dec_refs()
+
+    def _flush_dec_refs(self):
+        q = self._dec_refs
+        if q and Z3_dec_ref_array is not None:
+            self._dec_refs = []
+            Z3_dec_ref_array(self.ctx, len(q), (Ast * len(q))(*q))
+
     def interrupt(self):
         """Interrupt a solver performing a satisfiability test, a tactic processing a goal, or simplify functions.
 
@@ -232,6 +257,9 @@ class Context:
         return ParamDescrsRef(Z3_get_global_param_descrs(self.ref()), self)
         
 
+# Number of collected ASTs released together by Context._flush_dec_refs
+_dec_ref_batch_size = 1000
+
 # Global Z3 context
 _main_ctx = None
 
@@ -349,7 +377,7 @@ class AstRef(Z3PPObject):
 
     def __del__(self):
         if self.ctx.ref() is not None and self.ast is not None and Z3_dec_ref is not None:
-            Z3_dec_ref(self.ctx.ref(), self.as_ast())
+            self.ctx._dec_ref(self.as_ast())
             self.ast = None
 
     def __deepcopy__(self, memo={}):
@@ -512,6 +540,21 @@ def _ctx_from_ast_args(*args):
     return _ctx_from_ast_arg_list(args)
 
 
+def _same_sort_args(args, ctx, cls):
+    """Return `True` if all arguments are instances of `cls` in `ctx` with the same sort.
+    They can then be passed to an n-ary function without coercion."""
+    s = None
+    for a in args:
+        if not isinstance(a, cls) or isinstance(a, QuantifierRef) or a.ctx is not ctx:
+            return False
+        v = a.sort().ast.value
+        if s is None:
+            s = v
+        elif s != v:
+            return False
+    return True
+
+
 def _to_func_decl_array(args):
     sz = len(args)
     _args = (FuncDecl * sz)()
@@ -1003,7 +1046,17 @@ class ExprRef(AstRef):
         >>> (x + y).sort()
         Real
         """
-        return _sort(self.ctx, self.as_ast())
+        return self._cached_sort(_to_sort_ref)
+
+    # The sort of an expression never changes, so it is computed once.
+    _sort = None
+
+    def _cached_sort(self, mk):
+        s = self._sort
+        if s is None:
+            s = mk(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+            self._sort = s
+        return s
 
     def sort_kind(self):
         """Shorthand for `self.sort().kind()`.
@@ -1576,7 +1629,7 @@ class BoolRef(ExprRef):
     """All Boolean expressions are instances of this class."""
 
     def sort(self):
-        return BoolSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(BoolSortRef)
 
     def __add__(self, other):
         if isinstance(other, BoolRef):
@@ -1921,7 +1974,8 @@ def And(*args):
     if _has_probe(args):
         return _probe_and(args, ctx)
     else:
-        args = _coerce_expr_list(args, ctx)
+        if not _same_sort_args(args, ctx, BoolRef):
+            args = _coerce_expr_list(args, ctx)
         _args, sz = _to_ast_array(args)
         return BoolRef(Z3_mk_and(ctx.ref(), sz, _args), ctx)
 
@@ -1954,7 +2008,8 @@ def Or(*args):
     if _has_probe(args):
         return _probe_or(args, ctx)
     else:
-        args = _coerce_expr_list(args, ctx)
+        if not _same_sort_args(args, ctx, BoolRef):
+            args = _coerce_expr_list(args, ctx)
         _args, sz = _to_ast_array(args)
         return BoolRef(Z3_mk_or(ctx.ref(), sz, _args), ctx)
 
@@ -2445,7 +2500,7 @@ class ArithRef(ExprRef):
         >>> (Real('x') + 1).sort()
         Real
         """
-        return ArithSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(ArithSortRef)
 
     def is_int(self):
         """Return `True` if `self` is an integer expression.
@@ -3549,7 +3604,7 @@ class BitVecRef(ExprRef):
         >>> x.sort() == BitVecSort(32)
         True
         """
-        return BitVecSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(BitVecSortRef)
 
     def size(self):
         """Return the number of bits of the bit-vector expression `self`.
@@ -4608,7 +4663,7 @@ class ArrayRef(ExprRef):
         >>> a.sort()
         Array(Int, Bool)
         """
-        return ArraySortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(ArraySortRef)
 
     def domain(self):
         """Shorthand for `self.sort().domain()`.
@@ -5406,7 +5461,7 @@ class DatatypeRef(ExprRef):
 
     def sort(self):
         """Return the datatype sort of the datatype expression `self`."""
-        return DatatypeSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(DatatypeSortRef)
 
 def DatatypeSort(name, ctx = None):
     """Create a reference to a sort that was declared, or will be declared, as a recursive datatype"""
@@ -6494,6 +6549,23 @@ class ModelRef(Z3PPObject):
         """
         return self.eval(t, model_completion)
 
+    def eval_many(self, ts, model_completion=False):
+        """Evaluate the expressions `ts` in the model `self` in one call.
+
+        >>> x, y = Ints('x y')
+        >>> s = Solver()
+        >>> s.add(x == 1, y == 2)
+        >>> s.check()
+        sat
+        >>> s.model().eval_many([x + y, x < y])
+        [3, True]
+        """
+        _ts, sz = _to_ast_array(ts)
+        r = (Ast * sz)()
+        if not Z3_model_eval_batch(self.ctx.ref(), self.model, sz, _ts, model_completion, r):
+            raise Z3Exception("failed to evaluate expressions in the model")
+        return [_to_expr_ref(r[i], self.ctx) for i in range(sz)]
+
     def __len__(self):
         """Return the number of constant and function declarations in the model `self`.
 
@@ -6739,6 +6811,38 @@ class ModelRef(Z3PPObject):
         return self.translate(self.ctx)
 
 
+def eval_int64(models, ts, model_completion=True):
+    """Evaluate the Boolean, integer or bit-vector expressions `ts` in each of the models `models`.
+
+    Return a pair of ctypes arrays `(values, status)` of length `len(models) * len(ts)`,
+    where the value of `ts[i]` in `models[j]` is at position `j * len(ts) + i`, and the
+    status is 0 where the value is not a numeral that fits into 64 bits.
+    Both arrays support the buffer protocol, e.g., `numpy.frombuffer(values, dtype=numpy.int64)`.
+
+    >>> x = Int('x')
+    >>> s = Solver()
+    >>> s.add(x > 2, x < 4)
+    >>> s.check()
+    sat
+    >>> values, status = eval_int64([s.model()], [x, x + 1, x == 3])
+    >>> list(values), list(status)
+    ([3, 4, 1], [1, 1, 1])
+    """
+    if len(models) == 0 or len(ts) == 0:
+        return (ctypes.c_int64 * 0)(), (ctypes.c_uint * 0)()
+    ctx = models[0].ctx
+    _models = (ModelObj * len(models))()
+    for j in range(len(models)):
+        _models[j] = models[j].model
+    _ts, sz = _to_ast_array(ts)
+    n = len(models) * sz
+    values = (ctypes.c_int64 * n)()
+    status = (ctypes.c_uint * n)()
+    Z3_eval_int64(ctx.ref(), len(models), _models, sz, _ts, model_completion, n,
+                  ctypes.cast(values, ctypes.POINTER(ctypes.c_longlong)), status)
+    return values, status
+
+
 def Model(ctx=None):
     ctx = _get_ctx(ctx)
     return ModelRef(Z3_mk_model(ctx.ref()), ctx)
@@ -7811,7 +7915,7 @@ class FiniteDomainRef(ExprRef):
 
     def sort(self):
         """Return the sort of the finite-domain expression `self`."""
-        return FiniteDomainSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(FiniteDomainSortRef)
 
     def as_string(self):
         """Return a Z3 floating point expression as a Python string."""
@@ -9036,6 +9140,9 @@ def Sum(*args):
     ctx = _ctx_from_ast_arg_list(args)
     if ctx is None:
         return _reduce(lambda a, b: a + b, args, 0)
+    if _same_sort_args(args, ctx, ArithRef):
+        _args, sz = _to_ast_array(args)
+        return ArithRef(Z3_mk_add(ctx.ref(), sz, _args), ctx)
     args = _coerce_expr_list(args, ctx)
     if is_bv(args[0]):
         return _reduce(lambda a, b: a + b, args, 0)
@@ -9062,6 +9169,9 @@ def Product(*args):
     ctx = _ctx_from_ast_arg_list(args)
     if ctx is None:
         return _reduce(lambda a, b: a * b, args, 1)
+    if _same_sort_args(args, ctx, ArithRef):
+        _args, sz = _to_ast_array(args)
+        return ArithRef(Z3_mk_mul(ctx.ref(), sz, _args), ctx)
     args = _coerce_expr_list(args, ctx)
     if is_bv(args[0]):
         return _reduce(lambda a, b: a * b, args, 1)
@@ -9629,7 +9739,7 @@ class FPRef(ExprRef):
         >>> x.sort() == FPSort(8, 24)
         True
         """
-        return FPSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(FPSortRef)
 
     def ebits(self):
         """Retrieves the number of bits reserved for the exponent in the FloatingPoint expression `self`.
@@ -10915,7 +11025,7 @@ class SeqRef(ExprRef):
     """Sequence expression."""
 
     def sort(self):
-        return SeqSortRef(Z3_get_sort(self.ctx_ref(), self.as_ast()), self.ctx)
+        return self._cached_sort(SeqSortRef)
 
     def __add__(self, other):
         return Concat(self, other)
@@ -11668,6 +11778,24 @@ def user_prop_decide(ctx, cb, t, idx, phase):
     t = _to_expr_ref(to_Ast(t_ref), prop.ctx())
     prop.decide(t, idx, phase)
     prop.cb = old_cb
+
+def user_prop_batch(ctx, cb, num_pushes, num_fixed, fixed, values, num_eqs, lhs, rhs):
+    prop = _prop_closures.get(ctx)
+    old_cb = prop.cb
+    prop.cb = cb
+    prop._pending = []
+    try:
+        for i in range(num_pushes):
+            prop.push()
+        pctx = prop.ctx()
+        for i in range(num_fixed):
+            prop.fixed(_to_expr_ref(to_Ast(fixed[i]), pctx), _to_expr_ref(to_Ast(values[i]), pctx))
+        for i in range(num_eqs):
+            prop.eq(_to_expr_ref(to_Ast(lhs[i]), pctx), _to_expr_ref(to_Ast(rhs[i]), pctx))
+        prop._flush_pending()
+    finally:
+        prop._pending = None
+        prop.cb = old_cb
     
 
 _user_prop_push = Z3_push_eh(user_prop_push)
@@ -11679,6 +11807,7 @@ _user_prop_final = Z3_final_eh(user_prop_final)
 _user_prop_eq = Z3_eq_eh(user_prop_eq)
 _user_prop_diseq = Z3_eq_eh(user_prop_diseq)
 _user_prop_decide = Z3_decide_eh(user_prop_decide)
+_user_prop_batch = Z3_batch_eh(user_prop_batch)
 
 
 def PropagateFunction(name, *sig):
@@ -11726,6 +11855,7 @@ class UserPropagateBase:
         self.eq = None
         self.diseq = None
         self.created = None
+        self._pending = None
         if ctx:
             self.fresh_ctx = ctx
         if s:
@@ -11791,6 +11921,17 @@ class UserPropagateBase:
             Z3_solver_propagate_decide(self.ctx_ref(), self.solver.solver, _user_prop_decide)
         self.decide = decide        
 
+    #
+    # Deliver the fixed and eq events of a propagation round, and the pushes
+    # preceding them, with one call from the solver. The registered push, fixed
+    # and eq methods are invoked for the events, and consequences passed to
+    # propagate during the round are sent back to the solver in one call.
+    #
+    def add_batch(self):
+        assert not self._ctx
+        if self.solver:
+            Z3_solver_propagate_batch(self.ctx_ref(), self.solver.solver, _user_prop_batch)
+
     def push(self):
         raise Z3Exception("push needs to be overwritten")
 
@@ -11819,6 +11960,9 @@ class UserPropagateBase:
     # Propagation can only be invoked as during a fixed or final callback.
     #
     def propagate(self, e, ids, eqs=[]):
+        if self._pending is not None:
+            self._pending.append((e, list(ids), list(eqs)))
+            return True
         _ids, num_fixed = _to_ast_array(ids)
         num_eqs = len(eqs)
         _lhs, _num_lhs = _to_ast_array([x for x, y in eqs])
@@ -11826,5 +11970,27 @@ class UserPropagateBase:
         return Z3_solver_propagate_consequence(e.ctx.ref(), ctypes.c_void_p(
             self.cb), num_fixed, _ids, num_eqs, _lhs, _rhs, e.ast)
 
+    def _flush_pending(self):
+        pending = self._pending
+        if not pending:
+            return
+        n = len(pending)
+        conseqs = (Ast * n)()
+        num_fixed = (ctypes.c_uint * n)()
+        num_eqs = (ctypes.c_uint * n)()
+        fixed = []
+        eqs = []
+        for i, (e, ids, es) in enumerate(pending):
+            conseqs[i] = e.as_ast()
+            num_fixed[i] = len(ids)
+            num_eqs[i] = len(es)
+            fixed += ids
+            eqs += es
+        _fixed, total_fixed = _to_ast_array(fixed)
+        _lhs, total_eqs = _to_ast_array([x for x, y in eqs])
+        _rhs, _ = _to_ast_array([y for x, y in eqs])
+        Z3_solver_propagate_consequences(self.ctx_ref(), ctypes.c_void_p(self.cb), n, conseqs,
+                                         num_fixed, total_fixed, _fixed, num_eqs, total_eqs, _lhs, _rhs)
+
     def conflict(self, deps = [], eqs = []):
         self.propagate(BoolVal(False, self.ctx()), deps, eqs)
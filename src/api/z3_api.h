@@ -1356,6 +1356,23 @@ typedef enum {
     Z3_PRINT_SMTLIB2_COMPLIANT
 } Z3_ast_print_mode;
 
+/**
+   \brief Instructions of the term construction program (See #Z3_mk_term_dag).
+
+   Every instruction pushes one term on the stack. Terms are numbered in the order they are pushed.
+
+   - Z3_TERM_LEAF k:         push \c leaves[k].
+   - Z3_TERM_APP d n:        pop \c n terms and push the application of \c decls[d] to them.
+   - Z3_TERM_REF i:          push term number \c i again.
+   - Z3_TERM_NUMERAL s lo hi: push the numeral of sort \c sorts[s] with the signed 64-bit value <tt>hi * 2^32 + lo</tt>.
+*/
+typedef enum {
+    Z3_TERM_LEAF,
+    Z3_TERM_APP,
+    Z3_TERM_REF,
+    Z3_TERM_NUMERAL
+} Z3_term_opcode;
+
 
 /**
    \brief Z3 error codes (See #Z3_get_error_code).
@@ -1440,7 +1457,10 @@ Z3_DECLARE_CLOSURE(Z3_eq_eh,      void, (void* ctx, Z3_solver_callback cb, Z3_as
 Z3_DECLARE_CLOSURE(Z3_final_eh,   void, (void* ctx, Z3_solver_callback cb));
 Z3_DECLARE_CLOSURE(Z3_created_eh, void, (void* ctx, Z3_solver_callback cb, Z3_ast t));
 Z3_DECLARE_CLOSURE(Z3_decide_eh,  void, (void* ctx, Z3_solver_callback cb, Z3_ast t, unsigned idx, bool phase));
+Z3_DECLARE_CLOSURE(Z3_batch_eh,   void, (void* ctx, Z3_solver_callback cb, unsigned num_pushes, unsigned num_fixed, Z3_ast const* fixed, Z3_ast const* values, unsigned num_eqs, Z3_ast const* eq_lhs, Z3_ast const* eq_rhs));
 Z3_DECLARE_CLOSURE(Z3_on_clause_eh, void, (void* ctx, Z3_ast proof_hint, unsigned n, unsigned const* deps, Z3_ast_vector literals));
+Z3_DECLARE_CLOSURE(Z3_check_done_eh, void, (void* ctx, Z3_solver s, Z3_lbool r));
+Z3_DECLARE_CLOSURE(Z3_progress_eh, void, (void* ctx, Z3_stats stats));
 
 
 /**
@@ -1669,6 +1689,17 @@ extern "C" {
     */
     void Z3_API Z3_dec_ref(Z3_context c, Z3_ast a);
 
+    /**
+       \brief Decrement the reference counters of the given ASTs.
+       It is equivalent to calling #Z3_dec_ref on each element of \c asts,
+       and lets garbage collected bindings release ASTs in batches.
+
+       \sa Z3_dec_ref
+
+       def_API('Z3_dec_ref_array', VOID, (_in(CONTEXT), _in(UINT), _in_array(1, AST)))
+    */
+    void Z3_API Z3_dec_ref_array(Z3_context c, unsigned num, Z3_ast const asts[]);
+
     /**
        \brief Set a value of a context parameter.
 
@@ -2256,6 +2287,29 @@ extern "C" {
         unsigned num_args,
         Z3_ast const args[]);
 
+    /**
+       \brief Create a term from a postfix program in one call.
+
+       \c code holds \c num_code words forming a sequence of #Z3_term_opcode instructions
+       followed by their operands. The program must leave exactly one term on the stack,
+       which is returned. If \c num_terms is positive, the first \c num_terms terms pushed
+       by the program are also stored in \c terms. Use #Z3_TERM_REF to share subterms.
+
+       This is equivalent to a sequence of calls to #Z3_mk_app and #Z3_mk_int64,
+       but it avoids the cost of one call per node from other languages.
+
+       \sa Z3_mk_app
+
+       def_API('Z3_mk_term_dag', AST, (_in(CONTEXT), _in(UINT), _in_array(1, UINT), _in(UINT), _in_array(3, FUNC_DECL), _in(UINT), _in_array(5, AST), _in(UINT), _in_array(7, SORT), _in(UINT), _out_array(9, AST)))
+    */
+    Z3_ast Z3_API Z3_mk_term_dag(
+        Z3_context c,
+        unsigned num_code, unsigned const code[],
+        unsigned num_decls, Z3_func_decl const decls[],
+        unsigned num_leaves, Z3_ast const leaves[],
+        unsigned num_sorts, Z3_sort const sorts[],
+        unsigned num_terms, Z3_ast terms[]);
+
     /**
        \brief Declare and create a constant.
 
@@ -5489,6 +5543,38 @@ extern "C" {
     */
     bool Z3_API Z3_model_eval(Z3_context c, Z3_model m, Z3_ast t, bool model_completion, Z3_ast * v);
 
+    /**
+       \brief Evaluate the terms \c terms in the model \c m and store the results in \c values.
+
+       This is equivalent to calling #Z3_model_eval on every term, but it amortizes
+       the cost of the call, and results of shared subterms are computed once.
+
+       \sa Z3_model_eval
+
+       def_API('Z3_model_eval_batch', BOOL, (_in(CONTEXT), _in(MODEL), _in(UINT), _in_array(2, AST), _in(BOOL), _out_array(2, AST)))
+    */
+    bool Z3_API Z3_model_eval_batch(Z3_context c, Z3_model m, unsigned num_terms, Z3_ast const terms[], bool model_completion, Z3_ast values[]);
+
+    /**
+       \brief Evaluate the terms \c terms in each of the models \c models into a numeric buffer.
+
+       The value of term \c i in model \c j is stored at position <tt>j * num_terms + i</tt>
+       of \c values, and \c num_values must be <tt>num_models * num_terms</tt>.
+       Booleans evaluate to 0 or 1, integers to their value and bit-vectors of at most 64 bits
+       to their unsigned value reinterpreted as a signed 64-bit integer. The corresponding entry of
+       \c status is 1 if the result is such a numeral, and 0 otherwise, for instance if the
+       value does not fit into 64 bits or is not a numeral.
+
+       Return the number of entries with status 1.
+
+       \sa Z3_model_eval_batch
+
+       def_API('Z3_eval_int64', UINT, (_in(CONTEXT), _in(UINT), _in_array(1, MODEL), _in(UINT), _in_array(3, AST), _in(BOOL), _in(UINT), _out_array(6, INT64), _out_array(6, UINT)))
+    */
+    unsigned Z3_API Z3_eval_int64(Z3_context c, unsigned num_models, Z3_model const models[],
+                                  unsigned num_terms, Z3_ast const terms[], bool model_completion,
+                                  unsigned num_values, int64_t values[], unsigned status[]);
+
     /**
        \brief Return the interpretation (i.e., assignment) of constant \c a in the model \c m.
        Return \c NULL, if the model does not assign an interpretation for \c a.
@@ -5790,6 +5876,12 @@ extern "C" {
     /**
        \brief Log interaction to a file.
 
+       If \c filename ends with \c .bin, the log uses a compact binary
+       format that is buffered and written by a background thread. It is
+       complete only after #Z3_close_log is called; records still in the
+       buffer are lost if the process terminates without closing the log.
+       Both formats are replayed by \c z3 \c -log.
+
        \sa Z3_append_log
        \sa Z3_close_log
 
@@ -5882,6 +5974,31 @@ extern "C" {
     */
     Z3_string Z3_API Z3_func_decl_to_string(Z3_context c, Z3_func_decl d);
 
+    /**
+       \brief Serialize the given expression in a compact binary format.
+       Shared sub-terms, sorts and declarations are written once.
+       The length of the result is stored in \c length; the result may contain 0 characters.
+
+       \warning The result buffer is statically allocated by Z3. It will
+       be automatically deallocated when #Z3_del_context is invoked.
+       So, the buffer is invalidated in the next call to \c Z3_serialize_ast.
+
+       \sa Z3_deserialize_ast
+
+       def_API('Z3_serialize_ast', CHAR_PTR, (_in(CONTEXT), _in(AST), _out(UINT)))
+    */
+    Z3_char_ptr Z3_API Z3_serialize_ast(Z3_context c, Z3_ast a, unsigned* length);
+
+    /**
+       \brief Reconstruct an expression from the \c sz bytes in \c data produced by #Z3_serialize_ast.
+       The serialized expression may originate from a different context.
+
+       \sa Z3_serialize_ast
+
+       def_API('Z3_deserialize_ast', AST, (_in(CONTEXT), _in(UINT), _in(STRING)))
+    */
+    Z3_ast Z3_API Z3_deserialize_ast(Z3_context c, unsigned sz, Z3_string data);
+
     /**
        \brief Convert the given model into a string.
 
@@ -6650,6 +6767,25 @@ extern "C" {
     */
     Z3_string Z3_API Z3_tactic_get_help(Z3_context c, Z3_tactic t);
 
+    /**
+       \brief Return the report recorded when the parameter \c tactic.profile is set.
+       The report contains a tree with one node per tactic invocation, with its time,
+       the memory before and after, the peak memory and the goal size before and after.
+       Profiling statistics are also added to the statistics of the tactic or solver.
+
+       \sa Z3_reset_tactic_profile
+
+       def_API('Z3_get_tactic_profile', STRING, (_in(CONTEXT),))
+    */
+    Z3_string Z3_API Z3_get_tactic_profile(Z3_context c);
+
+    /**
+       \brief Discard the report returned by #Z3_get_tactic_profile.
+
+       def_API('Z3_reset_tactic_profile', VOID, (_in(CONTEXT),))
+    */
+    void Z3_API Z3_reset_tactic_profile(Z3_context c);
+
     /**
        \brief Return the parameter description set for the given tactic object.
 
@@ -7096,6 +7232,34 @@ extern "C" {
         void*       user_context,
         Z3_on_clause_eh on_clause_eh);
 
+    /**
+       \brief register a callback that receives search telemetry while the solver is checking.
+
+       \param c - context.
+       \param s - solver object.
+       \param interval_ms - milliseconds between two invocations, 0 removes the callback.
+       \param user_context - a context used to maintain state for callbacks.
+       \param progress_eh - a callback that is invoked from the searching thread, without
+                             interrupting search for longer than the callback takes, with
+                             a snapshot of the search statistics. Besides the statistics of
+                             #Z3_solver_get_statistics it contains the entries
+                             \c conflicts/s and \c decisions/s since the previous snapshot,
+                             \c time and the memory use. With parallel cube and conquer
+                             the snapshot describes the cubes that are open, active and closed.
+                             The statistics object is released when the callback returns,
+                             unless the callback increments its reference count.
+
+       Telemetry is produced by solvers based on the SMT core.
+
+       def_API('Z3_solver_register_on_progress', VOID, (_in(CONTEXT), _in(SOLVER), _in(UINT), _in(VOID_PTR), _fnptr(Z3_progress_eh)))
+    */
+    void Z3_API Z3_solver_register_on_progress(
+        Z3_context  c,
+        Z3_solver   s,
+        unsigned    interval_ms,
+        void*       user_context,
+        Z3_progress_eh progress_eh);
+
     /**
        \brief register a user-propagator with the solver.
 
@@ -7175,6 +7339,21 @@ extern "C" {
     */
     void Z3_API Z3_solver_propagate_decide(Z3_context c, Z3_solver s, Z3_decide_eh decide_eh);
 
+    /**
+       \brief register a callback that receives the events of a propagation round in one call.
+       Once it is registered, the events that the callbacks registered with \ref Z3_solver_propagate_fixed
+       and \ref Z3_solver_propagate_eq would receive are buffered and passed to \c batch_eh instead,
+       together with the number of scopes pushed since the previous call. The push callback is no longer invoked.
+       The pop callback is invoked only for scopes that were delivered.
+       The buffered events are delivered before the solver propagates and before any other callback is invoked.
+
+       Assume the callback has the signature: \c batch_eh(context, solver_cb, num_pushes, num_fixed, fixed, values, num_eqs, lhs, rhs).
+       The callback context can be used to propagate consequences, for example with \ref Z3_solver_propagate_consequences.
+
+       def_API('Z3_solver_propagate_batch', VOID, (_in(CONTEXT), _in(SOLVER), _fnptr(Z3_batch_eh)))
+    */
+    void Z3_API Z3_solver_propagate_batch(Z3_context c, Z3_solver s, Z3_batch_eh batch_eh);
+
     /**
         Sets the next (registered) expression to split on.
         The function returns false and ignores the given expression in case the expression is already assigned internally
@@ -7241,6 +7420,30 @@ extern "C" {
 
     bool Z3_API Z3_solver_propagate_consequence(Z3_context c, Z3_solver_callback cb, unsigned num_fixed, Z3_ast const* fixed, unsigned num_eqs, Z3_ast const* eq_lhs, Z3_ast const* eq_rhs, Z3_ast conseq);
 
+    /**
+       \brief propagate several consequences in one call.
+       It is equivalent to calling \ref Z3_solver_propagate_consequence for each consequence in order.
+       The premises of the consequences are stored consecutively: consequence \c i uses the next \c num_fixed[i]
+       terms of \c fixed and the next \c num_eqs[i] equalities of \c lhs and \c rhs.
+
+       \param c - context
+       \param solver_cb - solver callback
+       \param n - number of consequences
+       \param conseqs - array of length \c n of consequences
+       \param num_fixed - array of length \c n with the number of fixed terms used by each consequence
+       \param total_fixed - length of \c fixed, the sum of \c num_fixed
+       \param fixed - terms that are fixed in the current scope
+       \param num_eqs - array of length \c n with the number of equalities used by each consequence
+       \param total_eqs - length of \c lhs and \c rhs, the sum of \c num_eqs
+       \param lhs - left side of equalities
+       \param rhs - right side of equalities
+
+       The function returns the number of consequences that were not discarded.
+
+       def_API('Z3_solver_propagate_consequences', UINT, (_in(CONTEXT), _in(SOLVER_CALLBACK), _in(UINT), _in_array(2, AST), _in_array(2, UINT), _in(UINT), _in_array(5, AST), _in_array(2, UINT), _in(UINT), _in_array(8, AST), _in_array(8, AST)))
+    */
+    unsigned Z3_API Z3_solver_propagate_consequences(Z3_context c, Z3_solver_callback cb, unsigned n, Z3_ast const* conseqs, unsigned const* num_fixed, unsigned total_fixed, Z3_ast const* fixed, unsigned const* num_eqs, unsigned total_eqs, Z3_ast const* eq_lhs, Z3_ast const* eq_rhs);
+
 
     /**
        \brief provide an initialization hint to the solver. The initialization hint is used to calibrate an initial value of the expression that
@@ -7287,6 +7490,47 @@ extern "C" {
     Z3_lbool Z3_API Z3_solver_check_assumptions(Z3_context c, Z3_solver s,
                                                 unsigned num_assumptions, Z3_ast const assumptions[]);
 
+    /**
+       \brief Start checking the assertions of \c s under the given assumptions on a
+       process wide pool of worker threads, and return immediately.
+
+       Use #Z3_solver_check_async_done to poll, #Z3_solver_check_async_wait to wait for
+       the result and #Z3_solver_interrupt to cancel. If \c done_eh is not null, it is
+       called on the worker thread with \c user_ctx and the result once the check finishes.
+       Every started check must be waited for before the next one on the same solver.
+
+       While the check runs, the context of \c s may only be used for
+       #Z3_solver_check_async_done, #Z3_solver_check_async_wait, #Z3_solver_interrupt and #Z3_interrupt.
+       Use one context per concurrent query.
+
+       \sa Z3_solver_check_assumptions
+       \sa Z3_solver_check_async_wait
+
+       def_API('Z3_solver_check_async', VOID, (_in(CONTEXT), _in(SOLVER), _in(UINT), _in_array(2, AST), _in(VOID_PTR), _fnptr(Z3_check_done_eh)))
+    */
+    void Z3_API Z3_solver_check_async(Z3_context c, Z3_solver s,
+                                      unsigned num_assumptions, Z3_ast const assumptions[],
+                                      void* user_ctx, Z3_check_done_eh done_eh);
+
+    /**
+       \brief Return true if the asynchronous check of \c s has completed, or if none was started.
+
+       \sa Z3_solver_check_async
+
+       def_API('Z3_solver_check_async_done', BOOL, (_in(CONTEXT), _in(SOLVER)))
+    */
+    bool Z3_API Z3_solver_check_async_done(Z3_context c, Z3_solver s);
+
+    /**
+       \brief Wait for the asynchronous check of \c s and return its result.
+       Afterwards the model, unsat core and reason unknown can be retrieved as after #Z3_solver_check.
+
+       \sa Z3_solver_check_async
+
+       def_API('Z3_solver_check_async_wait', LBOOL, (_in(CONTEXT), _in(SOLVER)))
+    */
+    Z3_lbool Z3_API Z3_solver_check_async_wait(Z3_context c, Z3_solver s);
+
     /**
        \brief Retrieve congruence class representatives for terms.
 
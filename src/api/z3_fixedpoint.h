@@ -86,6 +86,26 @@ extern "C" {
                                        Z3_func_decl r,
                                        unsigned num_args, unsigned args[]);
 
+    /**
+       \brief Add several Database facts at once.
+
+       \param c - context
+       \param d - fixed point context
+       \param r - relation signature for the rows.
+       \param num_args - total number of elements in \c args.
+       \param args - the rows, stored consecutively.
+
+       The number of arguments \c num_args should be a multiple of the
+       arity of \c r. The call has the same effect as calling
+       #Z3_fixedpoint_add_fact for each row, but the rows are inserted
+       into the relation without a call per row.
+
+       def_API('Z3_fixedpoint_add_facts', VOID, (_in(CONTEXT), _in(FIXEDPOINT), _in(FUNC_DECL), _in(UINT), _in_array(3, UINT)))
+    */
+    void Z3_API Z3_fixedpoint_add_facts(Z3_context c, Z3_fixedpoint d,
+                                        Z3_func_decl r,
+                                        unsigned num_args, unsigned const args[]);
+
     /**
        \brief Assert a constraint to the fixedpoint context.
 
@@ -22,6 +22,7 @@ Notes:
 #include "util/stream_buffer.h"
 #include "util/symbol.h"
 #include "util/trace.h"
+#include<cstring>
 #include<iostream>
 #include<sstream>
 #include<vector>
@@ -39,6 +40,7 @@ struct z3_replayer::imp {
     std::istream &           m_stream;
     int                      m_curr;  // current char;
     int                      m_line;  // line
+    bool                     m_binary = false; // log uses the binary format of api_log.cpp
     svector<char>            m_string;
     symbol                   m_id;
     int64_t                  m_int64;
@@ -163,9 +165,56 @@ struct z3_replayer::imp {
 
     int curr() const { return m_curr; }
     void new_line() { m_line++; }
-    void next() { m_curr = m_stream.get(); }
+    void next() { m_curr = m_stream.rdbuf()->sbumpc(); }
+
+    unsigned char read_byte() {
+        int c = curr();
+        if (c == EOF)
+            throw z3_replayer_exception("unexpected end of file");
+        next();
+        return static_cast<unsigned char>(c);
+    }
+
+    uint64_t read_varint() {
+        uint64_t r = 0;
+        for (unsigned shift = 0; ; shift += 7) {
+            if (shift >= 64)
+                throw z3_replayer_exception("invalid varint");
+            unsigned char b = read_byte();
+            r |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return r;
+        }
+    }
+
+    void read_bytes(char * out, unsigned sz) {
+        for (unsigned i = 0; i < sz; ++i)
+            out[i] = static_cast<char>(read_byte());
+    }
+
+    /**
+       \brief check for the header of a binary log, see binary_log in api_log.cpp.
+    */
+    void read_magic() {
+        static char const magic[] = "Z3BLOG1";
+        if (curr() != 0)
+            return;
+        next();
+        for (char const * s = magic; *s; ++s)
+            if (read_byte() != static_cast<unsigned char>(*s))
+                throw z3_replayer_exception("invalid binary log header");
+        m_binary = true;
+    }
 
     void read_string_core(char delimiter) {
+        if (m_binary) {
+            uint64_t sz = read_varint();
+            m_string.reset();
+            for (uint64_t i = 0; i < sz; ++i)
+                m_string.push_back(static_cast<char>(read_byte()));
+            m_string.push_back(0);
+            return;
+        }
         if (curr() != delimiter)
             throw z3_replayer_exception("invalid string/symbol");
         m_string.reset();
@@ -221,6 +270,11 @@ struct z3_replayer::imp {
     }
 
     void read_int64() {
+        if (m_binary) {
+            uint64_t u = read_varint();
+            m_int64 = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+            return;
+        }
         if (!(curr() == '-' || ('0' <= curr() && curr() <= '9')))
             throw z3_replayer_exception("invalid integer");
         bool sign = false;
@@ -246,6 +300,10 @@ struct z3_replayer::imp {
     }
 
     void read_uint64() {
+        if (m_binary) {
+            m_uint64 = read_varint();
+            return;
+        }
         if (!('0' <= curr() && curr() <= '9'))
             throw z3_replayer_exception("invalid unsigned");
         m_uint64 = 0;
@@ -273,6 +331,12 @@ struct z3_replayer::imp {
 #endif
 
     void read_float() {
+        if (m_binary) {
+            char bytes[sizeof(float)];
+            read_bytes(bytes, sizeof(float));
+            memcpy(&m_float, bytes, sizeof(float));
+            return;
+        }
         m_string.reset();
         while (is_double_char()) {
             m_string.push_back(curr());
@@ -286,6 +350,12 @@ struct z3_replayer::imp {
     }
 
     void read_double() {
+        if (m_binary) {
+            char bytes[sizeof(double)];
+            read_bytes(bytes, sizeof(double));
+            memcpy(&m_double, bytes, sizeof(double));
+            return;
+        }
         m_string.reset();
         while (is_double_char()) {
             m_string.push_back(curr());
@@ -299,6 +369,10 @@ struct z3_replayer::imp {
     }
 
     void read_ptr() {
+        if (m_binary) {
+            m_ptr = static_cast<size_t>(read_varint());
+            return;
+        }
         if (!(('0' <= curr() && curr() <= '9') || ('A' <= curr() && curr() <= 'F') || ('a' <= curr() && curr() <= 'f'))) {
             TRACE("invalid_ptr", tout << "curr: " << curr() << "\n";);
             throw z3_replayer_exception("invalid ptr");
@@ -327,13 +401,15 @@ struct z3_replayer::imp {
     }
 
     void skip_blank() {
+        if (m_binary)
+            return;
         while (true) {
             int c = curr();
             if (c == '\n') {
                 new_line();
                 next();
             }
-            else if (c == ' ' || c == '\t') {
+            else if (c == ' ' || c == '\t' || c == '\r') {
                 next();
             }
             else {
@@ -407,6 +483,7 @@ struct z3_replayer::imp {
         memory::exit_when_out_of_memory(false, nullptr);
         uint64_t counter = 0;
         unsigned tick = 0;
+        read_magic();
         while (true) {
             IF_VERBOSE(1, {
                 counter++; tick++;
@@ -1267,7 +1267,7 @@ decl_plugin * user_sort_plugin::mk_fresh() {
 // -----------------------------------
 
 ast_manager::ast_manager(proof_gen_mode m, char const * trace_file, bool is_format_manager):
-    m_alloc("ast_manager"),
+    m_alloc("ast_manager", true),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1287,7 +1287,7 @@ ast_manager::ast_manager(proof_gen_mode m, char const * trace_file, bool is_form
 }
 
 ast_manager::ast_manager(proof_gen_mode m, std::fstream * trace_stream, bool is_format_manager):
-    m_alloc("ast_manager"),
+    m_alloc("ast_manager", true),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1302,7 +1302,7 @@ ast_manager::ast_manager(proof_gen_mode m, std::fstream * trace_stream, bool is_
 }
 
 ast_manager::ast_manager(ast_manager const & src, bool disable_proofs):
-    m_alloc("ast_manager"),
+    m_alloc("ast_manager", true),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1371,6 +1371,8 @@ static void mark_array_ref(ast_mark& mark, unsigned sz, parameter const * a) {
 
 ast_manager::~ast_manager() {
     SASSERT(is_format_manager() || !m_family_manager.has_family(symbol("format")));
+    m_delete_budget = 0;
+    flush_deleted();
 
     dec_ref(m_bool_sort);
     dec_ref(m_proof_sort);
@@ -1807,74 +1809,111 @@ void ast_manager::delete_node(ast * n) {
 
     SASSERT(m_ast_table.contains(n));
     m_ast_table.push_erase(n);
+    unsigned budget = m_delete_budget == 0 ? UINT_MAX : m_delete_budget;
+    reclaim_erased(budget);
+    while (budget > 0 && !m_deferred_nodes.empty()) {
+        reclaim_node(m_deferred_nodes.back());
+        m_deferred_nodes.pop_back();
+        --budget;
+        reclaim_erased(budget);
+    }
+}
 
+/**
+   \brief reclaim the nodes queued for erasure in m_ast_table.
+   Once the budget is exhausted, the remaining nodes are deferred.
+*/
+void ast_manager::reclaim_erased(unsigned & budget) {
+    ast * n;
     while ((n = m_ast_table.pop_erase())) {
+        if (budget == 0) {
+            m_deferred_nodes.push_back(n);
+            continue;
+        }
+        --budget;
+        reclaim_node(n);
+    }
+}
+
+void ast_manager::flush_deleted() {
+    unsigned budget = UINT_MAX;
+    while (!m_deferred_nodes.empty()) {
+        ast * n = m_deferred_nodes.back();
+        m_deferred_nodes.pop_back();
+        reclaim_node(n);
+        reclaim_erased(budget);
+    }
+}
 
-        CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
-        TRACE("mk_var_bug", tout << "del_ast: " << " " << n->m_ref_count << "\n";);
-        TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
+/**
+   \brief release the children and the memory of n.
+   n was erased from m_ast_table, unreferenced children are queued for erasure.
+*/
+void ast_manager::reclaim_node(ast * n) {
+    CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
+    TRACE("mk_var_bug", tout << "del_ast: " << " " << n->m_ref_count << "\n";);
+    TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
 
-        SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
+    SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
 
 #ifdef RECYCLE_FREE_AST_INDICES
-        if (!m_debug_ref_count) {
-            if (is_decl(n))
-                m_decl_id_gen.recycle(n->m_id);
-            else
-                m_expr_id_gen.recycle(n->m_id);
-        }
+    if (!m_debug_ref_count) {
+        if (is_decl(n))
+            m_decl_id_gen.recycle(n->m_id);
+        else
+            m_expr_id_gen.recycle(n->m_id);
+    }
 #endif
-        switch (n->get_kind()) {
-        case AST_SORT:
-            if (to_sort(n)->m_info != nullptr) {
-                sort_info * info = to_sort(n)->get_info();
-                info->del_eh(*this);
-                dealloc(info);
-            }
-            break;
-        case AST_FUNC_DECL: {
-            func_decl* f = to_func_decl(n);
-            if (f->is_polymorphic())
-                m_poly_roots.erase(f);
-            if (f->m_info != nullptr) {
-                func_decl_info * info = f->get_info();
-                if (info->is_lambda()) {
-                    push_dec_ref(m_lambda_defs[f]);
-                    m_lambda_defs.remove(f);
-                }
-                info->del_eh(*this);
-                dealloc(info);
-            }
-            push_dec_array_ref(f->get_arity(), f->get_domain());
-            push_dec_ref(f->get_range());
-            break;
-        }
-        case AST_APP: {
-            app* a = to_app(n);
-            push_dec_ref(a->get_decl());
-            push_dec_array_ref(a->get_num_args(), a->get_args());
-            break;
-        }
-        case AST_VAR:
-            push_dec_ref(to_var(n)->get_sort());
-            break;
-        case AST_QUANTIFIER: {
-            quantifier* q = to_quantifier(n);
-            push_dec_array_ref(q->get_num_decls(), q->get_decl_sorts());
-            push_dec_ref(q->get_expr());
-            push_dec_ref(q->get_sort());
-            push_dec_array_ref(q->get_num_patterns(), q->get_patterns());
-            push_dec_array_ref(q->get_num_no_patterns(), q->get_no_patterns());
-            break;
+    switch (n->get_kind()) {
+    case AST_SORT:
+        if (to_sort(n)->m_info != nullptr) {
+            sort_info * info = to_sort(n)->get_info();
+            info->del_eh(*this);
+            dealloc(info);
         }
-        default:
-            break;
+        break;
+    case AST_FUNC_DECL: {
+        func_decl* f = to_func_decl(n);
+        if (f->is_polymorphic())
+            m_poly_roots.erase(f);
+        if (f->m_info != nullptr) {
+            func_decl_info * info = f->get_info();
+            if (info->is_lambda()) {
+                push_dec_ref(m_lambda_defs[f]);
+                m_lambda_defs.remove(f);
+            }
+            info->del_eh(*this);
+            dealloc(info);
         }
-        if (m_debug_ref_count) {
-            m_debug_free_indices.insert(n->m_id,0);
-        }       
-        deallocate_node(n, ::get_node_size(n));
+        push_dec_array_ref(f->get_arity(), f->get_domain());
+        push_dec_ref(f->get_range());
+        break;
+    }
+    case AST_APP: {
+        app* a = to_app(n);
+        push_dec_ref(a->get_decl());
+        push_dec_array_ref(a->get_num_args(), a->get_args());
+        break;
+    }
+    case AST_VAR:
+        push_dec_ref(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER: {
+        quantifier* q = to_quantifier(n);
+        push_dec_array_ref(q->get_num_decls(), q->get_decl_sorts());
+        push_dec_ref(q->get_expr());
+        push_dec_ref(q->get_sort());
+        push_dec_array_ref(q->get_num_patterns(), q->get_patterns());
+        push_dec_array_ref(q->get_num_no_patterns(), q->get_no_patterns());
+        break;
+    }
+    default:
+        break;
+    }
+    if (m_debug_ref_count) {
+        m_debug_free_indices.insert(n->m_id,0);
     }
+    deallocate_node(n, ::get_node_size(n));
 }
 
 
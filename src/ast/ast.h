@@ -1499,6 +1499,8 @@ protected:
     proof_gen_mode            m_proof_mode;
     bool                      m_int_real_coercions; // If true, use hack that automatically introduces to_int/to_real when needed.
     ast_table                 m_ast_table;
+    unsigned                  m_delete_budget = 0;  // maximal number of nodes reclaimed per delete_node, 0 means unbounded
+    ptr_vector<ast>           m_deferred_nodes;     // unreferenced nodes whose reclamation was deferred
     obj_map<func_decl, quantifier*> m_lambda_defs;
     id_gen                    m_expr_id_gen;
     id_gen                    m_decl_id_gen;
@@ -1642,6 +1644,20 @@ public:
 
     void debug_ref_count() { m_debug_ref_count = true; }
 
+    /**
+       \brief bound the number of nodes reclaimed when a reference count drops to zero.
+       Nodes beyond the budget are reclaimed by later releases or by flush_deleted,
+       so releasing a large term does not reclaim it all at once. 0 disables the bound.
+    */
+    void set_delete_budget(unsigned budget) { m_delete_budget = budget; }
+
+    /**
+       \brief reclaim all nodes whose reclamation was deferred.
+    */
+    void flush_deleted();
+
+    unsigned get_num_deferred_nodes() const { return m_deferred_nodes.size(); }
+
     void inc_ref(ast* n) {
         if (n) 
             n->inc_ref();
@@ -1686,6 +1702,8 @@ protected:
     }
 
     void delete_node(ast * n);
+    void reclaim_node(ast * n);
+    void reclaim_erased(unsigned & budget);
 
     void * allocate_node(unsigned size) {
         return m_alloc.allocate(size);
@@ -2483,6 +2501,7 @@ typedef app_ref_buffer                proof_ref_buffer;
 // -----------------------------------
 
 typedef obj_mark<expr> expr_mark;
+typedef obj_epoch_mark<expr> expr_epoch_mark;
 
 class expr_sparse_mark {
     obj_hashtable<expr> m_marked;
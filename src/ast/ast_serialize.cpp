@@ -0,0 +1,588 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.cpp
+
+Abstract:
+
+    Compact binary serialization of expressions.
+
+--*/
+
+#include <cstring>
+#include "ast/ast_serialize.h"
+#include "ast/reg_decl_plugins.h"
+#include "util/zstring.h"
+
+namespace {
+    const char     s_magic[3] = { 'Z', '3', 'B' };
+    const unsigned s_version  = 1;
+
+    enum record_kind {
+        R_END = 0,
+        R_SORT,
+        R_FUNC_DECL,
+        R_APP,
+        R_VAR,
+        R_QUANTIFIER,
+        R_ROOT
+    };
+
+    enum param_kind {
+        P_INT = 0,
+        P_AST,
+        P_SYMBOL,
+        P_ZSTRING,
+        P_RATIONAL,
+        P_DOUBLE
+    };
+
+    enum decl_flag {
+        F_LEFT_ASSOC  = 1,
+        F_RIGHT_ASSOC = 2,
+        F_FLAT_ASSOC  = 4,
+        F_COMMUTATIVE = 8,
+        F_CHAINABLE   = 16,
+        F_PAIRWISE    = 32,
+        F_INJECTIVE   = 64,
+        F_SKOLEM      = 128,
+        F_IDEMPOTENT  = 256,
+        F_LAMBDA      = 512
+    };
+}
+
+ast_serializer::ast_serializer(ast_manager& m, std::ostream& out):
+    m(m), m_out(out) {
+    m_out.write(s_magic, sizeof(s_magic));
+    write_byte(s_version);
+}
+
+void ast_serializer::write_uint(uint64_t n) {
+    while (n >= 0x80) {
+        write_byte(static_cast<unsigned char>(n | 0x80));
+        n >>= 7;
+    }
+    write_byte(static_cast<unsigned char>(n));
+}
+
+void ast_serializer::write_string(char const* s, unsigned len) {
+    write_uint(len);
+    m_out.write(s, len);
+}
+
+void ast_serializer::write_symbol(symbol const& s) {
+    if (s.is_null())
+        write_byte(0);
+    else if (s.is_numerical()) {
+        write_byte(1);
+        write_uint(s.get_num());
+    }
+    else {
+        write_byte(2);
+        char const* str = s.bare_str();
+        write_string(str, static_cast<unsigned>(strlen(str)));
+    }
+}
+
+void ast_serializer::write_family(family_id fid) {
+    if (fid == null_family_id)
+        write_symbol(symbol::null);
+    else
+        write_symbol(m.get_family_name(fid));
+}
+
+void ast_serializer::write_parameters(unsigned n, parameter const* ps) {
+    write_uint(n);
+    for (unsigned i = 0; i < n; ++i) {
+        parameter const& p = ps[i];
+        switch (p.get_kind()) {
+        case parameter::PARAM_INT:
+            write_byte(P_INT);
+            // zig-zag encoding keeps small negative integers short.
+            write_uint((static_cast<uint32_t>(p.get_int()) << 1) ^ static_cast<uint32_t>(p.get_int() >> 31));
+            break;
+        case parameter::PARAM_AST:
+            write_byte(P_AST);
+            write_id(p.get_ast());
+            break;
+        case parameter::PARAM_SYMBOL:
+            write_byte(P_SYMBOL);
+            write_symbol(p.get_symbol());
+            break;
+        case parameter::PARAM_ZSTRING: {
+            write_byte(P_ZSTRING);
+            zstring const& s = p.get_zstring();
+            write_uint(s.length());
+            for (unsigned j = 0; j < s.length(); ++j)
+                write_uint(s[j]);
+            break;
+        }
+        case parameter::PARAM_RATIONAL: {
+            write_byte(P_RATIONAL);
+            std::string s = p.get_rational().to_string();
+            write_string(s.c_str(), static_cast<unsigned>(s.size()));
+            break;
+        }
+        case parameter::PARAM_DOUBLE: {
+            write_byte(P_DOUBLE);
+            double d = p.get_double();
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            for (unsigned j = 0; j < 8; ++j)
+                write_byte(static_cast<unsigned char>(bits >> (8 * j)));
+            break;
+        }
+        default:
+            throw default_exception("external parameters cannot be serialized");
+        }
+    }
+}
+
+void ast_serializer::get_children(ast* n, ptr_vector<ast>& children) {
+    children.reset();
+    auto add_params = [&](unsigned sz, parameter const* ps) {
+        for (unsigned i = 0; i < sz; ++i)
+            if (ps[i].is_ast())
+                children.push_back(ps[i].get_ast());
+    };
+    switch (n->get_kind()) {
+    case AST_SORT: {
+        sort* s = to_sort(n);
+        add_params(s->get_num_parameters(), s->get_parameters());
+        break;
+    }
+    case AST_FUNC_DECL: {
+        func_decl* f = to_func_decl(n);
+        add_params(f->get_num_parameters(), f->get_parameters());
+        children.append(f->get_arity(), reinterpret_cast<ast* const*>(f->get_domain()));
+        children.push_back(f->get_range());
+        if (f->get_info() && f->get_info()->is_lambda())
+            children.push_back(m.is_lambda_def(f));
+        break;
+    }
+    case AST_APP:
+        children.push_back(to_app(n)->get_decl());
+        children.append(to_app(n)->get_num_args(), reinterpret_cast<ast* const*>(to_app(n)->get_args()));
+        break;
+    case AST_VAR:
+        children.push_back(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER: {
+        quantifier* q = to_quantifier(n);
+        children.append(q->get_num_decls(), reinterpret_cast<ast* const*>(q->get_decl_sorts()));
+        for (unsigned i = 0; i < q->get_num_children(); ++i)
+            children.push_back(q->get_child(i));
+        break;
+    }
+    default:
+        UNREACHABLE();
+    }
+}
+
+void ast_serializer::visit(ast* root) {
+    if (m_ids.contains(root))
+        return;
+    // iterative post-order traversal; a node is written once all its children have ids.
+    m_todo.push_back(root);
+    while (!m_todo.empty()) {
+        ast* n = m_todo.back();
+        if (m_ids.contains(n)) {
+            m_todo.pop_back();
+            continue;
+        }
+        get_children(n, m_children);
+        bool visited = true;
+        for (ast* c : m_children) {
+            if (!m_ids.contains(c)) {
+                m_todo.push_back(c);
+                visited = false;
+            }
+        }
+        if (!visited)
+            continue;
+        m_todo.pop_back();
+        write_node(n);
+        m_ids.insert(n, m_num_nodes++);
+    }
+}
+
+void ast_serializer::write_node(ast* n) {
+    switch (n->get_kind()) {
+    case AST_SORT:
+        write_sort(to_sort(n));
+        break;
+    case AST_FUNC_DECL:
+        write_func_decl(to_func_decl(n));
+        break;
+    case AST_APP:
+        write_app(to_app(n));
+        break;
+    case AST_VAR:
+        write_byte(R_VAR);
+        write_uint(to_var(n)->get_idx());
+        write_id(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER:
+        write_quantifier(to_quantifier(n));
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+void ast_serializer::write_sort(sort* s) {
+    write_byte(R_SORT);
+    write_symbol(s->get_name());
+    sort_info* si = s->get_info();
+    write_byte(si != nullptr);
+    if (!si)
+        return;
+    write_family(si->get_family_id());
+    write_uint(si->get_decl_kind());
+    sort_size const& sz = si->get_num_elements();
+    if (sz.is_infinite())
+        write_byte(0);
+    else if (sz.is_very_big())
+        write_byte(1);
+    else {
+        write_byte(2);
+        write_uint(sz.size());
+    }
+    write_byte(s->private_parameters());
+    write_parameters(si->get_num_parameters(), si->get_parameters());
+}
+
+void ast_serializer::write_func_decl(func_decl* f) {
+    write_byte(R_FUNC_DECL);
+    write_symbol(f->get_name());
+    write_uint(f->get_arity());
+    for (sort* s : *f)
+        write_id(s);
+    write_id(f->get_range());
+    func_decl_info* fi = f->get_info();
+    write_byte(fi != nullptr);
+    if (!fi)
+        return;
+    write_family(fi->get_family_id());
+    write_uint(fi->get_decl_kind());
+    unsigned flags = 0;
+    if (fi->is_left_associative()) flags |= F_LEFT_ASSOC;
+    if (fi->is_right_associative()) flags |= F_RIGHT_ASSOC;
+    if (fi->is_flat_associative()) flags |= F_FLAT_ASSOC;
+    if (fi->is_commutative()) flags |= F_COMMUTATIVE;
+    if (fi->is_chainable()) flags |= F_CHAINABLE;
+    if (fi->is_pairwise()) flags |= F_PAIRWISE;
+    if (fi->is_injective()) flags |= F_INJECTIVE;
+    if (fi->is_skolem()) flags |= F_SKOLEM;
+    if (fi->is_idempotent()) flags |= F_IDEMPOTENT;
+    if (fi->is_lambda()) flags |= F_LAMBDA;
+    write_uint(flags);
+    write_parameters(fi->get_num_parameters(), fi->get_parameters());
+    if (fi->is_lambda())
+        write_id(m.is_lambda_def(f));
+}
+
+void ast_serializer::write_app(app* a) {
+    write_byte(R_APP);
+    write_id(a->get_decl());
+    write_uint(a->get_num_args());
+    for (expr* arg : *a)
+        write_id(arg);
+}
+
+void ast_serializer::write_quantifier(quantifier* q) {
+    write_byte(R_QUANTIFIER);
+    write_byte(static_cast<unsigned char>(q->get_kind()));
+    write_uint(q->get_num_decls());
+    for (unsigned i = 0; i < q->get_num_decls(); ++i) {
+        write_symbol(q->get_decl_name(i));
+        write_id(q->get_decl_sort(i));
+    }
+    write_id(q->get_expr());
+    write_uint(static_cast<uint32_t>(q->get_weight()));
+    write_symbol(q->get_qid());
+    write_symbol(q->get_skid());
+    write_uint(q->get_num_patterns());
+    for (unsigned i = 0; i < q->get_num_patterns(); ++i)
+        write_id(q->get_pattern(i));
+    write_uint(q->get_num_no_patterns());
+    for (unsigned i = 0; i < q->get_num_no_patterns(); ++i)
+        write_id(q->get_no_pattern(i));
+}
+
+void ast_serializer::operator()(expr* e) {
+    visit(e);
+    write_byte(R_ROOT);
+    write_id(e);
+}
+
+void ast_serializer::finish() {
+    write_byte(R_END);
+    m_out.flush();
+}
+
+ast_deserializer::ast_deserializer(ast_manager& m, std::istream& in):
+    m(m), m_in(in), m_nodes(m) {
+}
+
+void ast_deserializer::fail(char const* msg) {
+    throw default_exception(std::string("invalid serialized expression: ") + msg);
+}
+
+unsigned char ast_deserializer::read_byte() {
+    int c = m_in.get();
+    if (c == std::char_traits<char>::eof())
+        fail("unexpected end of stream");
+    return static_cast<unsigned char>(c);
+}
+
+uint64_t ast_deserializer::read_uint() {
+    uint64_t r = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        unsigned char b = read_byte();
+        r |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+            return r;
+    }
+    fail("integer overflow");
+}
+
+unsigned ast_deserializer::read_unsigned() {
+    uint64_t r = read_uint();
+    if (r > UINT_MAX)
+        fail("integer overflow");
+    return static_cast<unsigned>(r);
+}
+
+std::string ast_deserializer::read_string() {
+    unsigned len = read_unsigned();
+    std::string s(len, '\0');
+    if (len > 0 && !m_in.read(&s[0], len))
+        fail("unexpected end of stream");
+    return s;
+}
+
+symbol ast_deserializer::read_symbol() {
+    switch (read_byte()) {
+    case 0: return symbol::null;
+    case 1: return symbol(read_unsigned());
+    case 2: return symbol(read_string());
+    default: fail("unknown symbol kind");
+    }
+}
+
+family_id ast_deserializer::read_family() {
+    symbol name = read_symbol();
+    if (name.is_null())
+        return null_family_id;
+    if (!m.has_plugin(name))
+        reg_decl_plugins(m);
+    if (!m.has_plugin(name))
+        fail("unknown theory");
+    return m.get_family_id(name);
+}
+
+void ast_deserializer::read_parameters() {
+    m_params.reset();
+    unsigned n = read_unsigned();
+    for (unsigned i = 0; i < n; ++i) {
+        switch (read_byte()) {
+        case P_INT: {
+            uint32_t z = static_cast<uint32_t>(read_uint());
+            m_params.push_back(parameter(static_cast<int>((z >> 1) ^ (0u - (z & 1)))));
+            break;
+        }
+        case P_AST:
+            m_params.push_back(parameter(read_id()));
+            break;
+        case P_SYMBOL:
+            m_params.push_back(parameter(read_symbol()));
+            break;
+        case P_ZSTRING: {
+            unsigned len = read_unsigned();
+            unsigned_vector chs;
+            for (unsigned j = 0; j < len; ++j)
+                chs.push_back(read_unsigned());
+            m_params.push_back(parameter(zstring(len, chs.data())));
+            break;
+        }
+        case P_RATIONAL:
+            m_params.push_back(parameter(rational(read_string().c_str())));
+            break;
+        case P_DOUBLE: {
+            uint64_t bits = 0;
+            for (unsigned j = 0; j < 8; ++j)
+                bits |= static_cast<uint64_t>(read_byte()) << (8 * j);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            m_params.push_back(parameter(d));
+            break;
+        }
+        default:
+            fail("unknown parameter kind");
+        }
+    }
+}
+
+ast* ast_deserializer::read_id() {
+    uint64_t id = read_uint();
+    if (id >= m_nodes.size())
+        fail("reference to an undefined node");
+    return m_nodes.get(static_cast<unsigned>(id));
+}
+
+sort* ast_deserializer::read_sort_id() {
+    ast* n = read_id();
+    if (!is_sort(n))
+        fail("sort expected");
+    return to_sort(n);
+}
+
+expr* ast_deserializer::read_expr_id() {
+    ast* n = read_id();
+    if (!is_expr(n))
+        fail("expression expected");
+    return to_expr(n);
+}
+
+void ast_deserializer::read_header() {
+    char magic[sizeof(s_magic)];
+    if (!m_in.read(magic, sizeof(magic)) || memcmp(magic, s_magic, sizeof(magic)) != 0)
+        fail("bad header");
+    if (read_byte() != s_version)
+        fail("unsupported version");
+    m_header = true;
+}
+
+void ast_deserializer::read_sort() {
+    symbol name = read_symbol();
+    if (!read_byte()) {
+        m_nodes.push_back(m.mk_uninterpreted_sort(name));
+        return;
+    }
+    family_id fid = read_family();
+    decl_kind k = read_unsigned();
+    sort_size sz;
+    switch (read_byte()) {
+    case 0: sz = sort_size::mk_infinite(); break;
+    case 1: sz = sort_size::mk_very_big(); break;
+    case 2: sz = sort_size::mk_finite(read_uint()); break;
+    default: fail("unknown sort size");
+    }
+    bool private_params = read_byte() != 0;
+    read_parameters();
+    m_nodes.push_back(m.mk_sort(name, sort_info(fid, k, sz, m_params.size(), m_params.data(), private_params)));
+}
+
+void ast_deserializer::read_func_decl() {
+    symbol name = read_symbol();
+    unsigned arity = read_unsigned();
+    ptr_buffer<sort> domain;
+    for (unsigned i = 0; i < arity; ++i)
+        domain.push_back(read_sort_id());
+    sort* range = read_sort_id();
+    if (!read_byte()) {
+        m_nodes.push_back(m.mk_func_decl(name, arity, domain.data(), range));
+        return;
+    }
+    family_id fid = read_family();
+    decl_kind k = read_unsigned();
+    unsigned flags = read_unsigned();
+    read_parameters();
+    func_decl_info fi(fid, k, m_params.size(), m_params.data());
+    fi.set_left_associative((flags & F_LEFT_ASSOC) != 0);
+    fi.set_right_associative((flags & F_RIGHT_ASSOC) != 0);
+    fi.set_flat_associative((flags & F_FLAT_ASSOC) != 0);
+    fi.set_commutative((flags & F_COMMUTATIVE) != 0);
+    fi.set_chainable((flags & F_CHAINABLE) != 0);
+    fi.set_pairwise((flags & F_PAIRWISE) != 0);
+    fi.set_injective((flags & F_INJECTIVE) != 0);
+    fi.set_skolem((flags & F_SKOLEM) != 0);
+    fi.set_idempotent((flags & F_IDEMPOTENT) != 0);
+    fi.set_lambda((flags & F_LAMBDA) != 0);
+    func_decl* f = m.mk_func_decl(name, arity, domain.data(), range, fi);
+    m_nodes.push_back(f);
+    if (fi.is_lambda()) {
+        expr* q = read_expr_id();
+        if (!is_lambda(q))
+            fail("lambda expected");
+        m.add_lambda_def(f, to_quantifier(q));
+    }
+}
+
+void ast_deserializer::read_app() {
+    ast* d = read_id();
+    if (!is_func_decl(d))
+        fail("declaration expected");
+    func_decl* f = to_func_decl(d);
+    unsigned num_args = read_unsigned();
+    ptr_buffer<expr> args;
+    for (unsigned i = 0; i < num_args; ++i)
+        args.push_back(read_expr_id());
+    m_nodes.push_back(m.mk_app(f, num_args, args.data()));
+}
+
+void ast_deserializer::read_var() {
+    unsigned idx = read_unsigned();
+    m_nodes.push_back(m.mk_var(idx, read_sort_id()));
+}
+
+void ast_deserializer::read_quantifier() {
+    unsigned char k = read_byte();
+    if (k > lambda_k)
+        fail("unknown quantifier kind");
+    unsigned num_decls = read_unsigned();
+    if (num_decls == 0)
+        fail("quantifier without bound variables");
+    buffer<symbol> names;
+    ptr_buffer<sort> sorts;
+    for (unsigned i = 0; i < num_decls; ++i) {
+        names.push_back(read_symbol());
+        sorts.push_back(read_sort_id());
+    }
+    expr* body = read_expr_id();
+    int weight = static_cast<int>(static_cast<uint32_t>(read_uint()));
+    symbol qid = read_symbol();
+    symbol skid = read_symbol();
+    ptr_buffer<expr> pats, no_pats;
+    unsigned num_pats = read_unsigned();
+    for (unsigned i = 0; i < num_pats; ++i)
+        pats.push_back(read_expr_id());
+    unsigned num_no_pats = read_unsigned();
+    for (unsigned i = 0; i < num_no_pats; ++i)
+        no_pats.push_back(read_expr_id());
+    m_nodes.push_back(m.mk_quantifier(static_cast<quantifier_kind>(k), num_decls, sorts.data(), names.data(), body,
+                                      weight, qid, skid, num_pats, pats.data(), num_no_pats, no_pats.data()));
+}
+
+bool ast_deserializer::operator()(expr_ref& result) {
+    if (!m_header)
+        read_header();
+    while (!m_done) {
+        switch (read_byte()) {
+        case R_END: m_done = true; break;
+        case R_SORT: read_sort(); break;
+        case R_FUNC_DECL: read_func_decl(); break;
+        case R_APP: read_app(); break;
+        case R_VAR: read_var(); break;
+        case R_QUANTIFIER: read_quantifier(); break;
+        case R_ROOT:
+            result = read_expr_id();
+            return true;
+        default:
+            fail("unknown record");
+        }
+    }
+    return false;
+}
+
+bool is_ast_serialization(std::istream& in) {
+    char magic[sizeof(s_magic)];
+    auto pos = in.tellg();
+    bool r = !!in.read(magic, sizeof(magic)) && memcmp(magic, s_magic, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(pos);
+    return r;
+}
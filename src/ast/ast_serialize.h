@@ -0,0 +1,115 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.h
+
+Abstract:
+
+    Compact binary serialization of expressions.
+
+    The format is a versioned stream of node records. Every sort,
+    declaration and expression is written once, after its children,
+    and receives the next node id. Children are referenced by their
+    ids, so shared sub-terms are emitted only once. Integers are
+    written as LEB128 varints. Root records mark the expressions
+    returned to the reader, and the tables persist across roots so a
+    stream of related expressions shares its signature.
+
+    Theory sorts and declarations are recorded by family name, kind
+    and parameters and rebuilt through the plugins of the target
+    manager. Datatype definitions, lambda definitions and external
+    parameters are not serialized; the target manager must already
+    know such declarations.
+
+--*/
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+
+class ast_serializer {
+    ast_manager&           m;
+    std::ostream&          m_out;
+    obj_map<ast, unsigned> m_ids;
+    unsigned               m_num_nodes = 0;
+    ptr_vector<ast>        m_todo;
+    ptr_vector<ast>        m_children;
+
+    void write_byte(unsigned char b) { m_out.put(static_cast<char>(b)); }
+    void write_uint(uint64_t n);
+    void write_string(char const* s, unsigned len);
+    void write_symbol(symbol const& s);
+    void write_family(family_id fid);
+    void write_parameters(unsigned n, parameter const* ps);
+    void write_id(ast* n) { write_uint(m_ids[n]); }
+
+    void get_children(ast* n, ptr_vector<ast>& children);
+    void write_node(ast* n);
+    void write_sort(sort* s);
+    void write_func_decl(func_decl* f);
+    void write_app(app* a);
+    void write_quantifier(quantifier* q);
+    void visit(ast* n);
+
+public:
+    ast_serializer(ast_manager& m, std::ostream& out);
+
+    /**
+       \brief write e, including the nodes that were not written before,
+       followed by a root record.
+    */
+    void operator()(expr* e);
+
+    /**
+       \brief terminate the stream.
+    */
+    void finish();
+};
+
+class ast_deserializer {
+    ast_manager&     m;
+    std::istream&    m_in;
+    ast_ref_vector   m_nodes;
+    bool             m_header = false;
+    bool             m_done = false;
+    buffer<parameter> m_params;
+
+    [[noreturn]] void fail(char const* msg);
+    unsigned char read_byte();
+    uint64_t read_uint();
+    unsigned read_unsigned();
+    std::string read_string();
+    symbol read_symbol();
+    family_id read_family();
+    void read_parameters();
+    ast* read_id();
+    sort* read_sort_id();
+    expr* read_expr_id();
+
+    void read_header();
+    void read_sort();
+    void read_func_decl();
+    void read_app();
+    void read_var();
+    void read_quantifier();
+
+public:
+    ast_deserializer(ast_manager& m, std::istream& in);
+
+    /**
+       \brief read the next root expression.
+       Return false at the end of the stream.
+       Throws default_exception on malformed input.
+    */
+    bool operator()(expr_ref& result);
+};
+
+/**
+   \brief return true if the stream starts with a binary serialization header.
+   The stream position is left unchanged.
+*/
+bool is_ast_serialization(std::istream& in);
@@ -1194,6 +1194,354 @@ public:
 
 };
 
+/**
+   \brief SMT2 printer that writes directly to the output stream.
+
+   The sub-terms of each scope (the root and the body of every quantifier)
+   are counted in one pass. Shared sub-terms of weight at least pp.min_alias_size
+   are bound by let-declarations grouped by their nesting level, and everything
+   else is printed inline on a single line.
+*/
+class smt2_stream_printer {
+    typedef obj_map<expr, std::string> expr2alias;
+    typedef hashtable<symbol, symbol_hash_proc, symbol_eq_proc> symbol_set;
+
+    ast_manager &               m;
+    smt2_pp_environment &       m_env;
+    std::ostream &              m_out;
+    params_ref                  m_single_line;
+    obj_map<func_decl, std::string> m_decl2str;
+    obj_map<sort, std::string>  m_sort2str;
+    obj_map<app, std::string>   m_const2str;
+    expr2alias *                m_aliases = nullptr;
+    unsigned                    m_next_alias_idx = 1;
+    svector<symbol>             m_var_names;
+    symbol_set                  m_var_names_set;
+    string_buffer<>             m_next_name_buffer;
+
+    bool     m_pp_decimal;
+    unsigned m_pp_decimal_precision;
+    bool     m_pp_bv_lits;
+    bool     m_pp_float_real_lits;
+    bool     m_pp_bv_neg;
+    unsigned m_pp_min_alias_size;
+
+    static bool is_leaf(expr * n) {
+        return is_var(n) || (is_app(n) && to_app(n)->get_num_args() == 0);
+    }
+
+    std::string render(format * f) {
+        format_ref r(fm(m));
+        r = f;
+        std::ostringstream strm;
+        pp(strm, r.get(), m, m_single_line);
+        return std::move(strm).str();
+    }
+
+    std::string const & decl2str(func_decl * f) {
+        if (!m_decl2str.contains(f)) {
+            unsigned len;
+            m_decl2str.insert(f, render(m_env.pp_fdecl(f, len)));
+        }
+        return m_decl2str.find(f);
+    }
+
+    std::string const & sort2str(sort * s) {
+        if (!m_sort2str.contains(s))
+            m_sort2str.insert(s, render(m_env.pp_sort(s)));
+        return m_sort2str.find(s);
+    }
+
+    std::string const & const2str(app * c) {
+        if (m_const2str.contains(c))
+            return m_const2str.find(c);
+        std::string r;
+        buffer<symbol> names;
+        if (m_env.get_autil().is_numeral(c) || m_env.get_autil().is_irrational_algebraic_numeral(c))
+            r = render(m_env.pp_arith_literal(c, m_pp_decimal, m_pp_decimal_precision));
+        else if (m_env.get_sutil().str.is_string(c))
+            r = render(m_env.pp_string_literal(c));
+        else if (m_env.get_bvutil().is_numeral(c))
+            r = render(m_env.pp_bv_literal(c, m_pp_bv_lits, m_pp_bv_neg));
+        else if (m_env.get_futil().is_numeral(c))
+            r = render(m_env.pp_float_literal(c, m_pp_bv_lits, m_pp_float_real_lits));
+        else if (m_env.get_dlutil().is_numeral(c))
+            r = render(m_env.pp_datalog_literal(c));
+        else if (m.is_label_lit(c, names)) {
+            r = "(! true";
+            for (symbol const & n : names)
+                r += " :lblpos " + ensure_quote(n);
+            r += ")";
+        }
+        else
+            r = decl2str(c->get_decl());
+        m_const2str.insert(c, r);
+        return m_const2str.find(c);
+    }
+
+    symbol next_name(char const * prefix, unsigned & idx) {
+        while (true) {
+            m_next_name_buffer.reset();
+            m_next_name_buffer.append(prefix);
+            m_next_name_buffer.append("!");
+            m_next_name_buffer.append(idx);
+            symbol r(m_next_name_buffer.c_str());
+            idx++;
+            if (m_env.uses(r) || m_var_names_set.contains(r))
+                continue;
+            return r;
+        }
+    }
+
+    void register_var_names(quantifier * q) {
+        for (unsigned i = 0; i < q->get_num_decls(); i++) {
+            symbol name = q->get_decl_name(i);
+            if (is_smt2_quoted_symbol(name))
+                name = symbol(mk_smt2_quoted_symbol(name));
+            if (name.is_numerical()) {
+                unsigned idx = 1;
+                name = next_name("x", idx);
+            }
+            else if (m_env.uses(name) || m_var_names_set.contains(name)) {
+                unsigned idx = 1;
+                name = next_name(name.bare_str(), idx);
+            }
+            m_var_names.push_back(name);
+            m_var_names_set.insert(name);
+        }
+    }
+
+    void unregister_var_names(unsigned num_decls) {
+        for (unsigned i = 0; i < num_decls; i++) {
+            m_var_names_set.erase(m_var_names.back());
+            m_var_names.pop_back();
+        }
+    }
+
+    void pp_var(var * v) {
+        unsigned idx = v->get_idx();
+        if (idx < m_var_names.size()) {
+            symbol const & s = m_var_names[m_var_names.size() - idx - 1];
+            if (is_smt2_quoted_symbol(s))
+                m_out << mk_smt2_quoted_symbol(s);
+            else
+                m_out << s;
+        }
+        else
+            m_out << "(:var " << idx << ")";
+    }
+
+    /**
+       \brief count the occurrences of the sub-terms of root within the current scope.
+       Quantifiers are scopes of their own, so their bodies are not visited.
+       todo receives the visited compound terms in post-order.
+    */
+    void count_occs(expr * root, obj_map<expr, unsigned> & occs, ptr_vector<expr> & todo) {
+        svector<std::pair<expr *, unsigned>> stack;
+        auto visit = [&](expr * n) {
+            if (is_leaf(n))
+                return;
+            unsigned & c = occs.insert_if_not_there(n, 0);
+            if (c++ == 0)
+                stack.push_back({ n, 0 });
+        };
+        visit(root);
+        while (!stack.empty()) {
+            expr * n = stack.back().first;
+            unsigned i = stack.back().second;
+            if (is_app(n) && i < to_app(n)->get_num_args()) {
+                stack.back().second++;
+                visit(to_app(n)->get_arg(i));
+                continue;
+            }
+            stack.pop_back();
+            todo.push_back(n);
+        }
+    }
+
+    /**
+       \brief print the body of a scope: the let-declarations of
+       its shared sub-terms followed by the term itself.
+    */
+    void pp_scope(expr * root) {
+        expr2alias aliases;
+        expr2alias * old_aliases = m_aliases;
+        obj_map<expr, unsigned> occs;
+        ptr_vector<expr> todo;
+        count_occs(root, occs, todo);
+
+        // lvl(n) = 1 + the maximal level of the aliased sub-terms n depends on.
+        obj_map<expr, std::pair<unsigned, unsigned>> info; // expr -> (weight, level)
+        vector<ptr_vector<expr>> levels;
+        for (expr * n : todo) {
+            unsigned weight = 1, lvl = 0;
+            if (is_app(n)) {
+                for (expr * arg : *to_app(n)) {
+                    if (is_leaf(arg)) {
+                        ++weight;
+                        continue;
+                    }
+                    auto const & ai = info.find(arg);
+                    weight = std::min(UINT_MAX / 2, weight + ai.first);
+                    lvl = std::max(lvl, ai.second);
+                }
+            }
+            if (n != root && occs.find(n) > 1 && (weight >= m_pp_min_alias_size || is_quantifier(n))) {
+                levels.reserve(lvl + 1);
+                levels[lvl].push_back(n);
+                weight = 1;
+                lvl++;
+            }
+            info.insert(n, { weight, lvl });
+        }
+
+        m_aliases = &aliases;
+        unsigned num_lets = 0;
+        for (ptr_vector<expr> const & lvl_decls : levels) {
+            if (lvl_decls.empty())
+                continue;
+            ++num_lets;
+            m_out << "(let (";
+            bool first = true;
+            for (expr * n : lvl_decls) {
+                if (!first)
+                    m_out << "\n      ";
+                first = false;
+                unsigned idx = m_next_alias_idx;
+                symbol a = next_name(ALIAS_PREFIX, idx);
+                m_next_alias_idx = idx;
+                m_out << "(" << a << " ";
+                pp_term(n);
+                m_out << ")";
+                aliases.insert(n, a.str());
+            }
+            m_out << ")\n  ";
+        }
+        pp_term(root);
+        for (unsigned i = 0; i < num_lets; ++i)
+            m_out << ")";
+        m_aliases = old_aliases;
+    }
+
+    void pp_quantifier(quantifier * q) {
+        char const * header = q->get_kind() == forall_k ? "forall" : (q->get_kind() == exists_k ? "exists" : "lambda");
+        register_var_names(q);
+        m_out << "(" << header << " (";
+        unsigned num_decls = q->get_num_decls();
+        for (unsigned i = 0; i < num_decls; ++i) {
+            if (i > 0)
+                m_out << " ";
+            symbol const & s = m_var_names[m_var_names.size() - num_decls + i];
+            m_out << "(" << (is_smt2_quoted_symbol(s) ? mk_smt2_quoted_symbol(s) : s.str()) << " " << sort2str(q->get_decl_sort(i)) << ")";
+        }
+        m_out << ") ";
+        // The current SMT2 frontend uses weight 1 as default.
+        bool has_attributes = q->has_patterns() || q->get_weight() != 1 ||
+            q->get_skid() != symbol::null || (q->get_qid() != symbol::null && !q->get_qid().is_numerical());
+        if (has_attributes)
+            m_out << "(! ";
+        pp_scope(q->get_expr());
+        if (has_attributes) {
+            // patterns are printed without let-declarations.
+            expr2alias no_aliases;
+            expr2alias * old_aliases = m_aliases;
+            m_aliases = &no_aliases;
+            for (unsigned i = 0; i < q->get_num_patterns(); ++i) {
+                m_out << " :pattern ";
+                pp_term(q->get_pattern(i));
+            }
+            for (unsigned i = 0; i < q->get_num_no_patterns(); ++i) {
+                m_out << " :no-pattern ";
+                pp_term(q->get_no_pattern(i));
+            }
+            m_aliases = old_aliases;
+            if (q->get_weight() != 1)
+                m_out << " :weight " << q->get_weight();
+            if (q->get_skid() != symbol::null)
+                m_out << " :skolemid " << ensure_quote(q->get_skid());
+            if (q->get_qid() != symbol::null && !q->get_qid().is_numerical())
+                m_out << " :qid " << ensure_quote(q->get_qid());
+            m_out << ")";
+        }
+        m_out << ")";
+        unregister_var_names(num_decls);
+    }
+
+    /**
+       \brief print root using the aliases of the current scope for its proper sub-terms.
+    */
+    void pp_term(expr * root) {
+        svector<std::pair<expr *, unsigned>> stack;
+        stack.push_back({ root, 0 });
+        while (!stack.empty()) {
+            expr * n = stack.back().first;
+            unsigned i = stack.back().second;
+            if (i == 0) {
+                auto * e = n == root ? nullptr : m_aliases->find_core(n);
+                if (e) {
+                    m_out << e->get_data().m_value;
+                    stack.pop_back();
+                    continue;
+                }
+                if (is_var(n)) {
+                    pp_var(to_var(n));
+                    stack.pop_back();
+                    continue;
+                }
+                if (is_quantifier(n)) {
+                    pp_quantifier(to_quantifier(n));
+                    stack.pop_back();
+                    continue;
+                }
+                app * t = to_app(n);
+                if (t->get_num_args() == 0) {
+                    m_out << const2str(t);
+                    stack.pop_back();
+                    continue;
+                }
+                if (m.is_label(t) || m.is_pattern(t))
+                    m_out << (m.is_label(t) ? "(! " : "(");
+                else
+                    m_out << "(" << decl2str(t->get_decl()) << " ";
+            }
+            app * t = to_app(n);
+            if (i < t->get_num_args()) {
+                if (i > 0)
+                    m_out << " ";
+                stack.back().second++;
+                stack.push_back({ t->get_arg(i), 0 });
+                continue;
+            }
+            buffer<symbol> names;
+            bool is_pos;
+            if (m.is_label(t, is_pos, names))
+                for (symbol const & s : names)
+                    m_out << (is_pos ? " :lblpos " : " :lblneg ") << ensure_quote(s);
+            m_out << ")";
+            stack.pop_back();
+        }
+    }
+
+public:
+    smt2_stream_printer(std::ostream & out, smt2_pp_environment & env, params_ref const & params):
+        m(env.get_manager()),
+        m_env(env),
+        m_out(out) {
+        pp_params p(params);
+        m_pp_decimal = p.decimal();
+        m_pp_decimal_precision = p.decimal_precision();
+        m_pp_bv_lits = p.bv_literals();
+        m_pp_float_real_lits = p.fp_real_literals();
+        m_pp_bv_neg  = p.bv_neg();
+        m_pp_min_alias_size = p.min_alias_size();
+        m_single_line.set_bool("single_line", true);
+    }
+
+    void operator()(expr * n) {
+        pp_scope(n);
+    }
+};
+
 void mk_smt2_format(expr * n, smt2_pp_environment & env, params_ref const & p,
                     unsigned num_vars, char const * var_prefix,
                     format_ref & r, sbuffer<symbol> & var_names) {
@@ -1234,6 +1582,8 @@ void mk_smt2_format(unsigned sz, expr * const* es, smt2_pp_environment & env, pa
 std::ostream & ast_smt2_pp(std::ostream & out, expr * n, smt2_pp_environment & env, params_ref const & p, unsigned indent,
                             unsigned num_vars, char const * var_prefix) {
     if (!n) return out << "null";
+    if (num_vars == 0 && pp_params(p).streaming())
+        return ast_smt2_pp_stream(out, n, env, p);
     ast_manager & m = env.get_manager();
     format_ref r(fm(m));
     sbuffer<symbol> var_names;
@@ -1244,6 +1594,13 @@ std::ostream & ast_smt2_pp(std::ostream & out, expr * n, smt2_pp_environment & e
     return out;
 }
 
+std::ostream & ast_smt2_pp_stream(std::ostream & out, expr * n, smt2_pp_environment & env, params_ref const & p) {
+    if (!n) return out << "null";
+    smt2_stream_printer pr(out, env, p);
+    pr(n);
+    return out;
+}
+
 std::ostream & ast_smt2_pp(std::ostream & out, sort * s, smt2_pp_environment & env, params_ref const & p, unsigned indent) {
     if (s == nullptr) return out << "null";
     ast_manager & m = env.get_manager();
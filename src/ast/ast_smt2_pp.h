@@ -103,6 +103,12 @@ void mk_smt2_format(func_decl * f, smt2_pp_environment & env, params_ref const &
 std::ostream & ast_smt2_pp(std::ostream & out, expr * n, smt2_pp_environment & env, params_ref const & p = params_ref(), unsigned indent = 0, 
                            unsigned num_vars = 0, char const * var_prefix = nullptr);
 std::ostream & ast_smt2_pp(std::ostream & out, sort * s, smt2_pp_environment & env, params_ref const & p = params_ref(), unsigned indent = 0);
+/**
+   \brief print n without building a format document.
+   Shared sub-terms are abbreviated by let-declarations, the layout parameters of the pretty printer are ignored.
+   ast_smt2_pp uses this printer when pp.streaming is set.
+*/
+std::ostream & ast_smt2_pp_stream(std::ostream & out, expr * n, smt2_pp_environment & env, params_ref const & p = params_ref());
 std::ostream & ast_smt2_pp(std::ostream & out, func_decl * f, smt2_pp_environment & env, params_ref const & p = params_ref(), unsigned indent = 0, char const* cmd = "declare-fun");
 std::ostream & ast_smt2_pp(std::ostream & out, func_decl * f, expr* e, smt2_pp_environment & env, params_ref const & p = params_ref(), unsigned indent = 0, char const* cmd = "define-fun", bool reverse = false);
 std::ostream & ast_smt2_pp_rev(std::ostream & out, func_decl * f, expr* e, smt2_pp_environment & env, params_ref const & p = params_ref(), unsigned indent = 0, char const* cmd = "define-fun");
@@ -215,7 +215,7 @@ ast * ast_translation::process(ast const * _n) {
     SASSERT(m_extra_children_stack.empty());
     
     ++m_num_process;
-    if (m_num_process > (1 << 14)) {
+    if (m_max_cache_size != 0 ? m_cache.size() > m_max_cache_size : m_num_process > (1 << 14)) {
         reset_cache();
         m_num_process = 0;
     }
@@ -227,7 +227,10 @@ ast * ast_translation::process(ast const * _n) {
             ast * n = fr.m_n;
             ast * r;         
             TRACE("ast_translation", tout << mk_ll_pp(n, m_from_manager, false) << "\n";);
-            if (fr.m_idx == 0 && n->get_ref_count() > 1) {
+            // frames are processed right after visit missed the cache, so a fresh frame
+            // can only have been translated meanwhile if push_frame pushed it twice
+            // for a polymorphic declaration.
+            if (fr.m_idx == 0 && n->get_ref_count() > 1 && m_from_manager.has_type_vars()) {
                 if (m_cache.find(n, r)) {
                     SASSERT(m_result_stack.size() == fr.m_rpos);
                     m_result_stack.push_back(r);
@@ -41,6 +41,7 @@ class ast_translation {
     unsigned            m_miss_count;
     unsigned            m_insert_count;
     unsigned            m_num_process;
+    unsigned            m_max_cache_size = 0;
 
     void cache(ast * s, ast * t);
     void collect_decl_extra_children(decl * d);
@@ -95,6 +96,16 @@ public:
 
     void reset_cache();
     void cleanup();
+
+    /**
+       \brief bound the number of cached translations.
+       By default the cache is reset every 2^14 calls to translate, which suits
+       short-lived translations. A translation that is kept across calls for the
+       same pair of managers sets a bound instead, so shared subterms are only
+       translated once until the cache grows beyond the bound.
+    */
+    void set_max_cache_size(unsigned sz) { m_max_cache_size = sz; }
+    unsigned cache_size() const { return m_cache.size(); }
     
     unsigned loop_count() const { return m_loop_count; }
     unsigned hit_count() const { return m_hit_count; }
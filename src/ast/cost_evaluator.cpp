@@ -98,3 +98,163 @@ float cost_evaluator::operator()(expr * f, unsigned num_args, float const * args
 
 
 
+void cost_evaluator::compile(expr * f, program & p) {
+    p.m_code.reset();
+    p.m_max_stack = 0;
+    compile(f, p, 0);
+}
+
+/**
+   \brief append the code for f, which leaves its value on top of the stack.
+   depth is the number of values already on the stack.
+*/
+void cost_evaluator::compile(expr * f, program & p, unsigned depth) {
+    typedef program::instr instr;
+    auto & code = p.m_code;
+    auto emit = [&](instr const & i) { code.push_back(i); return code.size() - 1; };
+    auto arg = [&](unsigned idx, unsigned d) { compile(to_app(f)->get_arg(idx), p, d); };
+    auto binary = [&](program::opcode op) {
+        arg(0, depth);
+        arg(1, depth + 1);
+        emit(instr(op));
+    };
+    p.m_max_stack = std::max(p.m_max_stack, depth + 1);
+    if (is_app(f)) {
+        family_id fid = to_app(f)->get_family_id();
+        if (fid == m.get_basic_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_TRUE:     emit(instr(program::PUSH_NUM, 0, 1.0f)); return;
+            case OP_FALSE:    emit(instr(program::PUSH_NUM, 0, 0.0f)); return;
+            case OP_NOT:      arg(0, depth); emit(instr(program::NOT)); return;
+            case OP_AND: 
+            case OP_OR: {
+                bool is_and = to_app(f)->get_decl_kind() == OP_AND;
+                unsigned_vector jumps;
+                for (unsigned i = 0; i < to_app(f)->get_num_args(); ++i) {
+                    arg(i, depth);
+                    jumps.push_back(emit(instr(is_and ? program::JMP_ZERO : program::JMP_NOT_ZERO)));
+                }
+                emit(instr(program::PUSH_NUM, 0, is_and ? 1.0f : 0.0f));
+                unsigned end = emit(instr(program::JMP));
+                for (unsigned j : jumps)
+                    code[j].m_arg = code.size();
+                emit(instr(program::PUSH_NUM, 0, is_and ? 0.0f : 1.0f));
+                code[end].m_arg = code.size();
+                return;
+            }
+            case OP_ITE: {
+                arg(0, depth);
+                unsigned jelse = emit(instr(program::JMP_ZERO));
+                arg(1, depth);
+                unsigned end = emit(instr(program::JMP));
+                code[jelse].m_arg = code.size();
+                arg(2, depth);
+                code[end].m_arg = code.size();
+                return;
+            }
+            case OP_EQ:       binary(program::EQ); return;
+            case OP_XOR:      binary(program::NEQ); return;
+            case OP_IMPLIES: {
+                arg(0, depth);
+                unsigned jtrue = emit(instr(program::JMP_ZERO));
+                arg(1, depth);
+                emit(instr(program::NOT_ZERO));
+                unsigned end = emit(instr(program::JMP));
+                code[jtrue].m_arg = code.size();
+                emit(instr(program::PUSH_NUM, 0, 1.0f));
+                code[end].m_arg = code.size();
+                return;
+            }
+            default:
+                ;
+            }
+        }
+        else if (fid == m_util.get_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_NUM: {
+                rational r = to_app(f)->get_decl()->get_parameter(0).get_rational();
+                emit(instr(program::PUSH_NUM, 0, static_cast<float>(numerator(r).get_int64())/static_cast<float>(denominator(r).get_int64())));
+                return;
+            } 
+            case OP_LE:       binary(program::LE); return;
+            case OP_GE:       binary(program::GE); return;
+            case OP_LT:       binary(program::LT); return;
+            case OP_GT:       binary(program::GT); return;
+            case OP_ADD:      binary(program::ADD); return;
+            case OP_SUB:      binary(program::SUB); return;
+            case OP_UMINUS:   arg(0, depth); emit(instr(program::UMINUS)); return;
+            case OP_MUL:      binary(program::MUL); return;
+            case OP_DIV:      binary(program::DIV); return;
+            default:
+                ;
+            }
+        }
+    }
+    else if (is_var(f)) {
+        emit(instr(program::PUSH_VAR, to_var(f)->get_idx()));
+        return;
+    }
+    emit(instr(program::ERROR));
+}
+
+float cost_evaluator::operator()(program const & p, unsigned num_args, float const * args) {
+    if (m_stack.size() < p.m_max_stack)
+        m_stack.resize(p.m_max_stack);
+    float * stack = m_stack.data();
+    unsigned sp = 0;
+    auto const & code = p.m_code;
+    unsigned sz = code.size();
+    for (unsigned pc = 0; pc < sz; ++pc) {
+        auto const & i = code[pc];
+        switch (i.m_op) {
+        case program::PUSH_NUM: 
+            stack[sp++] = i.m_num; 
+            break;
+        case program::PUSH_VAR:
+            if (i.m_arg < num_args)
+                stack[sp++] = args[num_args - i.m_arg - 1];
+            else {
+                warning_msg("cost function evaluation error");
+                stack[sp++] = 1.0f;
+            }
+            break;
+        case program::JMP:          pc = i.m_arg - 1; break;
+        case program::JMP_ZERO:     if (stack[--sp] == 0.0f) pc = i.m_arg - 1; break;
+        case program::JMP_NOT_ZERO: if (stack[--sp] != 0.0f) pc = i.m_arg - 1; break;
+        case program::NOT:          stack[sp - 1] = stack[sp - 1] == 0.0f ? 1.0f : 0.0f; break;
+        case program::NOT_ZERO:     stack[sp - 1] = stack[sp - 1] != 0.0f ? 1.0f : 0.0f; break;
+        case program::UMINUS:       stack[sp - 1] = - stack[sp - 1]; break;
+        case program::ERROR:
+            warning_msg("cost function evaluation error");
+            stack[sp++] = 1.0f;
+            break;
+        default: {
+            float b = stack[--sp];
+            float & a = stack[sp - 1];
+            switch (i.m_op) {
+            case program::EQ:  a = a == b ? 1.0f : 0.0f; break;
+            case program::NEQ: a = a != b ? 1.0f : 0.0f; break;
+            case program::LE:  a = a <= b ? 1.0f : 0.0f; break;
+            case program::GE:  a = a >= b ? 1.0f : 0.0f; break;
+            case program::LT:  a = a <  b ? 1.0f : 0.0f; break;
+            case program::GT:  a = a >  b ? 1.0f : 0.0f; break;
+            case program::ADD: a = a + b; break;
+            case program::SUB: a = a - b; break;
+            case program::MUL: a = a * b; break;
+            case program::DIV:
+                if (b == 0.0f) {
+                    warning_msg("cost function division by zero");
+                    a = 1.0f;
+                }
+                else 
+                    a = a / b;
+                break;
+            default: 
+                UNREACHABLE();
+            }
+        }
+        }
+    }
+    SASSERT(sp == 1);
+    return stack[0];
+}
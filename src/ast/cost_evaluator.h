@@ -22,11 +22,38 @@ Revision History:
 #include "ast/arith_decl_plugin.h"
 
 class cost_evaluator {
+public:
+    /**
+       \brief cost function compiled into a flat sequence of stack instructions.
+       Boolean connectives and if-then-else use jumps, so the program evaluates 
+       the same sub-terms as the tree walking evaluator.
+    */
+    class program {
+        friend class cost_evaluator;
+        enum opcode { 
+            PUSH_NUM, PUSH_VAR, JMP, JMP_ZERO, JMP_NOT_ZERO, 
+            NOT, NOT_ZERO, EQ, NEQ, LE, GE, LT, GT, ADD, SUB, UMINUS, MUL, DIV, ERROR 
+        };
+        struct instr {
+            opcode   m_op;
+            unsigned m_arg = 0;    // variable index or jump target
+            float    m_num = 0.0f;
+            instr(opcode op, unsigned arg = 0, float num = 0.0f): m_op(op), m_arg(arg), m_num(num) {}
+        };
+        svector<instr> m_code;
+        unsigned       m_max_stack = 0;
+    public:
+        bool empty() const { return m_code.empty(); }
+    };
+
+private:
     ast_manager &   m;
     arith_util      m_util;
     unsigned        m_num_args;
     float const *   m_args;
+    svector<float>  m_stack;
     float eval(expr * f) const;
+    void compile(expr * f, program & p, unsigned depth);
 public:
     cost_evaluator(ast_manager & m);
     /**
@@ -36,6 +63,13 @@ public:
        (VAR (num_args - 1)) is stored in the first position of the array.
     */
     float operator()(expr * f, unsigned num_args, float const * args);
+
+    void compile(expr * f, program & p);
+
+    /**
+       \brief evaluate a compiled cost function, without recursion or allocation.
+    */
+    float operator()(program const & p, unsigned num_args, float const * args);
 };
 
 
@@ -116,6 +116,7 @@ namespace euf {
     }
 
     enode* egraph::mk(expr* f, unsigned generation, unsigned num_args, enode *const* args) {
+        scoped_memory_tag _tag(memory::tag_egraph);
         SASSERT(!find(f));
         force_push();
         enode *n = mk_enode(f, generation, num_args, args);
@@ -625,6 +626,7 @@ namespace euf {
 
 
     bool egraph::propagate() {
+        scoped_memory_tag _tag(memory::tag_egraph);
         force_push();
         unsigned i = 0;
         bool change = true;
@@ -38,34 +38,37 @@ namespace euf {
     typedef id_var_list<> th_var_list;
 
     class enode {
-        expr*         m_expr = nullptr;
-        bool          m_mark1 = false;
-        bool          m_mark2 = false;
-        bool          m_mark3 = false;
-        bool          m_commutative = false;
-        bool          m_interpreted = false;
-        bool          m_cgc_enabled = true;
-        bool          m_merge_tf_enabled = false;
-        bool          m_is_equality = false;    // Does the expression represent an equality
-        bool          m_is_relevant = false;
+        // Fields that are only touched by explanations, theories and e-matching
+        // come first, so that the fields used by merge and congruence
+        // closure are adjacent to the arguments at the end of the object.
+        justification m_justification;
+        justification m_lit_justification;
+        th_var_list   m_th_vars;
+        approx_set    m_lbls;
+        approx_set    m_plbls;
+        enode*        m_target = nullptr;
+        unsigned      m_generation = 0;         // Tracks how many quantifier instantiation rounds were needed to generate this enode.
+        sat::bool_var m_bool_var = sat::null_bool_var;    // SAT solver variable associated with Boolean node
         lbool         m_is_shared = l_undef;
         lbool         m_value = l_undef;        // Assignment by SAT solver for Boolean node
-        sat::bool_var m_bool_var = sat::null_bool_var;    // SAT solver variable associated with Boolean node
-        unsigned      m_class_size = 1;         // Size of the equivalence class if the enode is the root.
-        unsigned      m_table_id = UINT_MAX;       
-        unsigned      m_generation = 0;         // Tracks how many quantifier instantiation rounds were needed to generate this enode.
+        signed char   m_lbl_hash = -1;  // It is different from -1, if enode is used in a pattern
+        unsigned      m_mark1:1 = false;
+        unsigned      m_mark2:1 = false;
+        unsigned      m_mark3:1 = false;
+        unsigned      m_commutative:1 = false;
+        unsigned      m_interpreted:1 = false;
+        unsigned      m_cgc_enabled:1 = true;
+        unsigned      m_merge_tf_enabled:1 = false;
+        unsigned      m_is_equality:1 = false;    // Does the expression represent an equality
+        unsigned      m_is_relevant:1 = false;
+        expr*         m_expr = nullptr;
         enode_vector  m_parents;
-        enode*        m_next   = nullptr;
         enode*        m_root   = nullptr;
-        enode*        m_target = nullptr;
+        enode*        m_next   = nullptr;
         enode*        m_cg     = nullptr;
-        th_var_list   m_th_vars;
-        justification m_justification;
-        justification m_lit_justification;
+        unsigned      m_class_size = 1;         // Size of the equivalence class if the enode is the root.
+        unsigned      m_table_id = UINT_MAX;       
         unsigned      m_num_args = 0;
-        signed char   m_lbl_hash = -1;  // It is different from -1, if enode is used in a pattern
-        approx_set    m_lbls;
-        approx_set    m_plbls;
         enode*        m_args[0];
 
         friend class enode_args;
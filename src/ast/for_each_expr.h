@@ -121,6 +121,11 @@ void for_each_expr(ForEachProc & proc, expr_mark & visited, expr * n) {
     for_each_expr_core<ForEachProc, expr_mark, true, false>(proc, visited, n);
 }
 
+template<typename ForEachProc>
+void for_each_expr(ForEachProc & proc, expr_epoch_mark & visited, expr * n) {
+    for_each_expr_core<ForEachProc, expr_epoch_mark, true, false>(proc, visited, n);
+}
+
 template<typename ForEachProc>
 void for_each_expr(ForEachProc & proc, expr * n) {
     expr_mark visited;
@@ -41,6 +41,10 @@ fpa2bv_converter::fpa2bv_converter(ast_manager & m) :
     m_mpf_manager(m_util.fm()),
     m_mpz_manager(m_mpf_manager.mpz_manager()),
     m_hi_fp_unspecified(true),
+    m_op_decls(m),
+    m_templates(m),
+    m_abstract_decls(m),
+    m_abstractions(m),
     m_extra_assertions(m) {
     m_plugin = static_cast<fpa_decl_plugin*>(m.get_plugin(m.mk_family_id("fpa")));
 }
@@ -4338,6 +4342,161 @@ void fpa2bv_converter::reset() {
     m_uf2bvuf.reset();
     m_min_max_ufs.reset();
     m_extra_assertions.reset();
+    m_op_index.reset();
+    m_op_decls.reset();
+    m_templates.reset();
+    m_abstract_decls.reset();
+    m_abstract2op.reset();
+    m_abstractions.reset();
+}
+
+bool fpa2bv_converter::is_arith_op(func_decl * f) const {
+    if (f->get_family_id() != m_util.get_family_id())
+        return false;
+    switch (f->get_decl_kind()) {
+    case OP_FPA_ADD:
+    case OP_FPA_SUB:
+    case OP_FPA_MUL:
+    case OP_FPA_DIV:
+    case OP_FPA_REM:
+    case OP_FPA_FMA:
+    case OP_FPA_SQRT:
+    case OP_FPA_ROUND_TO_INTEGRAL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void fpa2bv_converter::mk_arith_op_core(func_decl * f, unsigned num, expr * const * args, expr_ref & result) {
+    switch (f->get_decl_kind()) {
+    case OP_FPA_ADD: mk_add(f, num, args, result); break;
+    case OP_FPA_SUB: mk_sub(f, num, args, result); break;
+    case OP_FPA_MUL: mk_mul(f, num, args, result); break;
+    case OP_FPA_DIV: mk_div(f, num, args, result); break;
+    case OP_FPA_REM: mk_rem(f, num, args, result); break;
+    case OP_FPA_FMA: mk_fma(f, num, args, result); break;
+    case OP_FPA_SQRT: mk_sqrt(f, num, args, result); break;
+    case OP_FPA_ROUND_TO_INTEGRAL: mk_round_to_integral(f, num, args, result); break;
+    default: UNREACHABLE();
+    }
+}
+
+bool fpa2bv_converter::get_components(unsigned num, expr * const * args, expr_ref_vector & comps) const {
+    for (unsigned i = 0; i < num; ++i) {
+        if (m_util.is_bv2rm(args[i]))
+            comps.push_back(to_app(args[i])->get_arg(0));
+        else if (m_util.is_fp(args[i]))
+            comps.append(3, to_app(args[i])->get_args());
+        else
+            return false;
+    }
+    return true;
+}
+
+void fpa2bv_converter::mk_op_args(func_decl * f, expr * const * comps, expr_ref_vector & args) {
+    for (unsigned i = 0, k = 0; i < f->get_arity(); ++i) {
+        if (m_util.is_rm(f->get_domain(i)))
+            args.push_back(m_util.mk_bv2rm(comps[k++]));
+        else {
+            args.push_back(m_util.mk_fp(comps[k], comps[k + 1], comps[k + 2]));
+            k += 3;
+        }
+    }
+}
+
+unsigned fpa2bv_converter::op_index(func_decl * f) {
+    unsigned idx;
+    if (!m_op_index.find(f, idx)) {
+        idx = m_op_decls.size();
+        m_op_decls.push_back(f);
+        m_op_index.insert(f, idx);
+        for (unsigned i = 0; i < 6; ++i)
+            m_templates.push_back(nullptr);
+        for (unsigned i = 0; i < 3; ++i)
+            m_abstract_decls.push_back(nullptr);
+    }
+    return idx;
+}
+
+bool fpa2bv_converter::mk_arith_op(func_decl * f, unsigned num, expr * const * args, expr_ref & result) {
+    if ((!m_use_templates && !m_abstract_ops) || !is_arith_op(f))
+        return false;
+    expr_ref_vector comps(m);
+    if (!get_components(num, args, comps))
+        return false;
+    if (m_abstract_ops && !all_of(comps, [&](expr* c) { return m_bv_util.is_numeral(c); })) {
+        mk_abstract_op(f, comps, result);
+        return true;
+    }
+    return m_use_templates && mk_template_op(f, num, args, comps, result);
+}
+
+bool fpa2bv_converter::mk_template_op(func_decl * f, unsigned num, expr * const * args, expr_ref_vector const & comps, expr_ref & result) {
+    // a numeral rounding mode selects its own template. Other numerals are
+    // left to the direct conversion, which folds them.
+    unsigned slot = 5, first = 0;
+    rational r;
+    if (m_util.is_rm(f->get_domain(0)) && m_bv_util.is_numeral(comps.get(0), r)) {
+        if (r >= 5)
+            return false;
+        slot = r.get_unsigned();
+        first = 1;
+    }
+    for (unsigned i = first; i < comps.size(); ++i)
+        if (m_bv_util.is_numeral(comps.get(i)) || !is_ground(comps.get(i)))
+            return false;
+
+    unsigned idx = op_index(f);
+    expr * t = m_templates.get(6 * idx + slot);
+    if (!t) {
+        expr_ref_vector vars(m), targs(m);
+        for (unsigned i = 0; i < comps.size(); ++i)
+            vars.push_back(i < first ? comps.get(i) : m.mk_var(i - first, comps.get(i)->get_sort()));
+        mk_op_args(f, vars.data(), targs);
+        expr_ref tmpl(m);
+        unsigned sz = m_extra_assertions.size();
+        mk_arith_op_core(f, targs.size(), targs.data(), tmpl);
+        if (m_extra_assertions.size() != sz) {
+            m_extra_assertions.shrink(sz);
+            return false;
+        }
+        m_templates.set(6 * idx + slot, tmpl);
+        t = tmpl;
+    }
+    var_subst subst(m, false);
+    result = subst(t, comps.size() - first, comps.data() + first);
+    return true;
+}
+
+void fpa2bv_converter::mk_abstract_op(func_decl * f, expr_ref_vector const & comps, expr_ref & result) {
+    unsigned idx = op_index(f);
+    if (!m_abstract_decls.get(3 * idx)) {
+        ptr_buffer<sort> domain;
+        for (expr * c : comps)
+            domain.push_back(c->get_sort());
+        sort * s = f->get_range();
+        sort * ranges[3] = { m_bv_util.mk_sort(1), m_bv_util.mk_sort(m_util.get_ebits(s)), m_bv_util.mk_sort(m_util.get_sbits(s) - 1) };
+        for (unsigned i = 0; i < 3; ++i)
+            m_abstract_decls.set(3 * idx + i, m.mk_fresh_func_decl("fpa2bv_abs", domain.size(), domain.data(), ranges[i]));
+        m_abstract2op.insert(m_abstract_decls.get(3 * idx), f);
+    }
+    expr_ref sgn(m), exp(m), sig(m);
+    sgn = m.mk_app(m_abstract_decls.get(3 * idx), comps.size(), comps.data());
+    exp = m.mk_app(m_abstract_decls.get(3 * idx + 1), comps.size(), comps.data());
+    sig = m.mk_app(m_abstract_decls.get(3 * idx + 2), comps.size(), comps.data());
+    result = m_util.mk_fp(sgn, exp, sig);
+    m_abstractions.push_back(result);
+}
+
+bool fpa2bv_converter::is_abstraction(expr * e, func_decl * & f, expr_ref_vector & args) {
+    if (!m_util.is_fp(e))
+        return false;
+    expr * sgn = to_app(e)->get_arg(0);
+    if (!is_app(sgn) || !m_abstract2op.find(to_app(sgn)->get_decl(), f))
+        return false;
+    mk_op_args(f, to_app(sgn)->get_args(), args);
+    return true;
 }
 
 func_decl * fpa2bv_converter::mk_bv_uf(func_decl * f, sort * const * domain, sort * range) {
@@ -55,6 +55,15 @@ protected:
     uf2bvuf_t                  m_uf2bvuf;
     special_t                  m_min_max_ufs;
 
+    // circuit templates and abstractions of arithmetic operations, see mk_arith_op.
+    bool                       m_use_templates = false;
+    bool                       m_abstract_ops = false;
+    obj_map<func_decl, unsigned> m_op_index;
+    func_decl_ref_vector       m_op_decls;
+    expr_ref_vector            m_templates;          // 6 per operation: one per rounding mode numeral, one for symbolic rounding modes
+    func_decl_ref_vector       m_abstract_decls;     // 3 per operation: sign, exponent and significand
+    obj_map<func_decl, func_decl*> m_abstract2op;
+
     friend class fpa2bv_model_converter;
     friend class bv2fpa_converter;
 
@@ -151,6 +160,23 @@ public:
 
     void set_unspecified_fp_hi(bool v) { m_hi_fp_unspecified = v; }
 
+    /**
+       \brief arithmetic operations (add, sub, mul, div, rem, fma, sqrt,
+       round-to-integral) are either bit-blasted by instantiating a circuit
+       template, built once per operation, floating-point sort and rounding
+       mode over variables for the components of the arguments, or abstracted
+       by uninterpreted functions on the components of the arguments.
+       The abstractions are recorded in m_abstractions.
+    */
+    void set_use_templates(bool f) { m_use_templates = f; }
+    void set_abstract_ops(bool f) { m_abstract_ops = f; }
+    bool is_arith_op(func_decl * f) const;
+    bool mk_arith_op(func_decl * f, unsigned num, expr * const * args, expr_ref & result);
+    void mk_arith_op_core(func_decl * f, unsigned num, expr * const * args, expr_ref & result);
+    void mk_op_args(func_decl * f, expr * const * comps, expr_ref_vector & args);
+    bool is_abstraction(expr * e, func_decl * & f, expr_ref_vector & args);
+    expr_ref_vector m_abstractions;
+
     void mk_min(func_decl * f, unsigned num, expr * const * args, expr_ref & result);
     void mk_max(func_decl * f, unsigned num, expr * const * args, expr_ref & result);
     void mk_min_i(func_decl * f, unsigned num, expr * const * args, expr_ref & result);
@@ -206,6 +232,11 @@ protected:
 
     void mk_to_bv(func_decl * f, unsigned num, expr * const * args, bool is_signed, expr_ref & result);
 
+    unsigned op_index(func_decl * f);
+    bool get_components(unsigned num, expr * const * args, expr_ref_vector & comps) const;
+    bool mk_template_op(func_decl * f, unsigned num, expr * const * args, expr_ref_vector const & comps, expr_ref & result);
+    void mk_abstract_op(func_decl * f, expr_ref_vector const & comps, expr_ref & result);
+
 private:
     void mk_nan(sort * s, expr_ref & result);
 
@@ -40,6 +40,7 @@ void fpa2bv_rewriter_cfg::updt_local_params(params_ref const & _p) {
     fpa2bv_rewriter_params p(_p);
     bool v = p.hi_fp_unspecified();
     m_conv.set_unspecified_fp_hi(v);
+    m_conv.set_use_templates(p.fp_templates());
 }
 
 void fpa2bv_rewriter_cfg::updt_params(params_ref const & p) {
@@ -103,6 +104,8 @@ br_status fpa2bv_rewriter_cfg::reduce_app(func_decl * f, unsigned num, expr * co
     }
 
     if (m_conv.is_float_family(f)) {
+        if (m_conv.mk_arith_op(f, num, args, result))
+            return BR_DONE;
         switch (f->get_decl_kind()) {
         case OP_FPA_RM_NEAREST_TIES_TO_AWAY:
         case OP_FPA_RM_NEAREST_TIES_TO_EVEN:
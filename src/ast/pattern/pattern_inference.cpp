@@ -112,6 +112,8 @@ pattern_inference_cfg::pattern_inference_cfg(ast_manager & m, pattern_inference_
     m_decompose_patterns(params.m_pi_decompose_patterns),
     m_candidates(m),
     m_pattern_weight_lt(m_candidates_info),
+    m_inferred_trail(m),
+    m_inferred_params(params),
     m_collect(m, *this),
     m_contains_subpattern(*this),
     m_database(m) {
@@ -570,6 +572,22 @@ void pattern_inference_cfg::mk_patterns(unsigned num_bindings,
 
     m_collect(n, num_bindings);
 
+    unsigned max_candidates = std::max(1u, m_params.m_pi_max_candidates);
+    if (m_candidates.size() > max_candidates) {
+        // the filters below are quadratic in the number of candidates.
+        // keep the candidates with the most free variables, smallest first.
+        ptr_vector<app> candidates(m_candidates.size(), m_candidates.data());
+        std::stable_sort(candidates.begin(), candidates.end(), m_pattern_weight_lt);
+        app_ref_vector kept(m);
+        for (unsigned i = 0; i < candidates.size(); ++i) {
+            if (i < max_candidates)
+                kept.push_back(candidates[i]);
+            else
+                m_candidates_info.erase(candidates[i]);
+        }
+        m_candidates.swap(kept);
+    }
+
     TRACE("pattern_inference",
           tout << mk_pp(n, m);
           tout << "\ncandidates:\n";
@@ -615,6 +633,28 @@ void pattern_inference_cfg::mk_patterns(unsigned num_bindings,
 }
 
 
+static bool same_params(pattern_inference_params const& p1, pattern_inference_params const& p2) {
+    return 
+        p1.m_pi_enabled == p2.m_pi_enabled &&
+        p1.m_pi_max_multi_patterns == p2.m_pi_max_multi_patterns &&
+        p1.m_pi_max_candidates == p2.m_pi_max_candidates &&
+        p1.m_pi_block_loop_patterns == p2.m_pi_block_loop_patterns &&
+        p1.m_pi_decompose_patterns == p2.m_pi_decompose_patterns &&
+        p1.m_pi_arith == p2.m_pi_arith &&
+        p1.m_pi_use_database == p2.m_pi_use_database &&
+        p1.m_pi_arith_weight == p2.m_pi_arith_weight &&
+        p1.m_pi_non_nested_arith_weight == p2.m_pi_non_nested_arith_weight &&
+        p1.m_pi_pull_quantifiers == p2.m_pi_pull_quantifiers &&
+        p1.m_pi_nopat_weight == p2.m_pi_nopat_weight &&
+        p1.m_pi_avoid_skolems == p2.m_pi_avoid_skolems &&
+        p1.m_pi_warnings == p2.m_pi_warnings;
+}
+
+void pattern_inference_cfg::reset_inferred() {
+    m_inferred.reset();
+    m_inferred_trail.reset();
+}
+
 bool pattern_inference_cfg::reduce_quantifier(
     quantifier * q, 
     expr * new_body, 
@@ -630,6 +670,37 @@ bool pattern_inference_cfg::reduce_quantifier(
     if (!is_forall(q)) 
         return false;
 
+    // proofs refer to the quantifier being rewritten, so they are not cached.
+    bool use_cache = new_body == q->get_expr() && !m.proofs_enabled();
+    if (!use_cache)
+        return reduce_quantifier_core(q, new_body, new_no_patterns, result, result_pr);
+
+    if (!same_params(m_params, m_inferred_params) || m_inferred.size() > 100000) {
+        reset_inferred();
+        m_inferred_params = m_params;
+    }
+    expr* cached = nullptr;
+    if (m_inferred.find(q, cached)) {
+        if (!cached)
+            return false;
+        result = cached;
+        return true;
+    }
+    bool r = reduce_quantifier_core(q, new_body, new_no_patterns, result, result_pr);
+    m_inferred_trail.push_back(q);
+    if (r)
+        m_inferred_trail.push_back(result);
+    m_inferred.insert(q, r ? result.get() : nullptr);
+    return r;
+}
+
+bool pattern_inference_cfg::reduce_quantifier_core(
+    quantifier * q, 
+    expr * new_body, 
+    expr * const * new_no_patterns,
+    expr_ref & result,
+    proof_ref & result_pr) {
+
     int weight = q->get_weight();
 
     if (m_params.m_pi_use_database) {
@@ -109,6 +109,22 @@ class pattern_inference_cfg :  public default_rewriter_cfg {
 
     pattern_weight_lt          m_pattern_weight_lt;
 
+    // Quantifiers whose body was not rewritten are mapped to the result of
+    // the inference, or to nullptr if they are left unchanged. Hash consing
+    // makes re-asserted quantifiers hit the cache. The cache is flushed when
+    // the parameters or the preferred and forbidden symbols change.
+    obj_map<quantifier, expr*> m_inferred;
+    expr_ref_vector            m_inferred_trail;
+    pattern_inference_params   m_inferred_params;
+
+    void reset_inferred();
+
+    bool reduce_quantifier_core(quantifier * old_q, 
+                                expr * new_body, 
+                                expr * const * new_no_patterns,
+                                expr_ref & result,
+                                proof_ref & result_pr);
+
     //
     // Functor for collecting candidates.
     //
@@ -221,6 +237,7 @@ public:
     
     void register_forbidden_family(family_id fid) {
         SASSERT(fid != m_bfid);
+        reset_inferred();
         m_forbidden.push_back(fid);
     }
 
@@ -229,6 +246,7 @@ public:
        gives preference to patterns rooted by this kind of function symbol.
     */
     void register_preferred(func_decl * f) {
+        reset_inferred();
         m_preferred.insert(f);
     }
 
@@ -10,6 +10,13 @@ Copyright (c) 2015 Microsoft Corporation
 #include "ast/arith_decl_plugin.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "ast/rewriter/var_subst.h"
+#include "ast/ast_translation.h"
+#include "util/scoped_ptr_vector.h"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
 
 #define IS_EQUIV(_e_) m.is_eq(_e_)
 
@@ -108,12 +115,145 @@ bool proof_checker::check(proof* p, expr_ref_vector& side_conditions) {
         }
     }
 
+    reset();
+
+    return result;
+}
+
+void proof_checker::reset() {
     m_hypotheses.reset();
     m_pinned.reset();
     m_todo.reset();
     m_marked.reset();
+}
+
+bool proof_checker::check_step(proof* p, expr_ref_vector& side_conditions) {
+    bool result = check1(p, side_conditions);
+    // the premises are checked by the caller.
+    m_todo.reset();
+    if (!result) {
+        IF_VERBOSE(1, ast_ll_pp(verbose_stream() << "Proof check failed\n", m, p););
+    }
+    return result;
+}
+
+bool proof_checker::check(proof* p, expr_ref_vector& side_conditions, unsigned num_threads) {
+#ifndef SINGLE_THREAD
+    if (num_threads > 1 && !m_dump_lemmas)
+        return check_par(p, side_conditions, num_threads);
+#endif
+    return check(p, side_conditions);
+}
+
+bool proof_checker::check_par(proof* p, expr_ref_vector& side_conditions, unsigned num_threads) {
+#ifdef SINGLE_THREAD
+    return check(p, side_conditions);
+#else
+    // collect the inferences of the proof DAG.
+    // Lemmas discharge the hypotheses of their sub-proofs, the other
+    // inferences only refer to the facts of their premises.
+    ptr_vector<proof> steps, lemmas, todo;
+    ast_mark visited;
+    todo.push_back(p);
+    while (!todo.empty()) {
+        proof* q = todo.back();
+        todo.pop_back();
+        if (visited.is_marked(q))
+            continue;
+        visited.mark(q, true);
+        if (m.is_lemma(q))
+            lemmas.push_back(q);
+        else
+            steps.push_back(q);
+        for (unsigned i = 0; i < m.get_num_parents(q); ++i)
+            todo.push_back(m.get_parent(q, i));
+    }
+    num_threads = std::min(num_threads, steps.size() / 2);
+    if (num_threads <= 1)
+        return check(p, side_conditions);
+
+    // Each worker checks copies of the inferences in its own manager, where
+    // every premise is replaced by an assertion of its fact.
+    // Translation increments reference counts in m, so it is serialized.
+    struct worker {
+        ast_manager     m;
+        proof_checker   m_checker;
+        ast_translation m_tr;
+        expr_ref_vector m_side;
+        proof*          m_failed = nullptr;
+        worker(ast_manager& src): m(src, false), m_checker(m), m_tr(src, m, false), m_side(m) {}
+    };
+    scoped_ptr_vector<worker> workers;
+    for (unsigned i = 0; i < num_threads; ++i)
+        workers.push_back(alloc(worker, m));
+
+    std::mutex mux;
+    std::atomic<unsigned> next(0);
+    std::atomic<bool> failed(false);
+    std::string ex_msg;
+
+    auto run = [&](worker& w) {
+        expr_ref_vector args(w.m);
+        func_decl_ref d(w.m);
+        try {
+            while (!failed) {
+                unsigned i = next++;
+                if (i >= steps.size())
+                    break;
+                proof* q = steps[i];
+                unsigned num_parents = m.get_num_parents(q);
+                args.reset();
+                {
+                    std::lock_guard<std::mutex> lock(mux);
+                    d = w.m_tr(q->get_decl());
+                    for (unsigned j = 0; j < num_parents; ++j)
+                        args.push_back(w.m_tr(m.get_fact(m.get_parent(q, j))));
+                    for (unsigned j = num_parents; j < q->get_num_args(); ++j)
+                        args.push_back(w.m_tr(q->get_arg(j)));
+                }
+                for (unsigned j = 0; j < num_parents; ++j)
+                    args[j] = w.m.mk_asserted(args.get(j));
+                proof_ref step(w.m.mk_app(d, args.size(), args.data()), w.m);
+                if (!w.m_checker.check1(step, w.m_side)) {
+                    w.m_failed = q;
+                    failed = true;
+                }
+                w.m_checker.m_todo.reset();
+            }
+        }
+        catch (z3_exception& ex) {
+            std::lock_guard<std::mutex> lock(mux);
+            ex_msg = ex.what();
+            failed = true;
+        }
+    };
 
+    vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i)
+        threads.push_back(std::thread([&, i]() { run(*workers[i]); }));
+    for (auto& th : threads)
+        th.join();
+
+    if (!ex_msg.empty())
+        throw default_exception(std::move(ex_msg));
+
+    bool result = true;
+    for (worker* w : workers) {
+        if (w->m_failed) {
+            IF_VERBOSE(1, ast_ll_pp(verbose_stream() << "Proof check failed\n", m, w->m_failed););
+            result = false;
+        }
+        ast_translation back(w->m, m, false);
+        for (expr* e : w->m_side)
+            side_conditions.push_back(back(e));
+    }
+
+    for (unsigned i = 0; result && i < lemmas.size(); ++i)
+        result = check_step(lemmas[i], side_conditions);
+
+    reset();
     return result;
+#endif
 }
 
 bool proof_checker::check1(proof* p, expr_ref_vector& side_conditions) {
@@ -68,8 +68,26 @@ public:
     proof_checker(ast_manager& m);
     void set_dump_lemmas(char const * logic = "AUFLIA") { m_dump_lemmas = true; m_logic = logic; } 
     bool check(proof* p, expr_ref_vector& side_conditions);
+
+    /**
+       \brief check the proof DAG using up to num_threads threads.
+       Inferences other than lemmas only depend on the facts of their premises
+       and are checked concurrently; lemmas are checked afterwards.
+    */
+    bool check(proof* p, expr_ref_vector& side_conditions, unsigned num_threads);
+
+    /**
+       \brief check the inference of p, assuming its premises have been checked.
+       Used to check proofs step by step, in topological order, as they are produced.
+       Hypotheses of sub-proofs are cached until reset(), so sub-proofs of lemmas
+       must be kept alive until then.
+    */
+    bool check_step(proof* p, expr_ref_vector& side_conditions);
+    void reset();
+
     bool check_arith_literal(bool is_pos, app* lit, rational const& coeff, expr_ref& sum, bool& is_strict);
 private:
+    bool check_par(proof* p, expr_ref_vector& side_conditions, unsigned num_threads);
     bool check1(proof* p, expr_ref_vector& side_conditions);
     bool check1_basic(proof* p, expr_ref_vector& side_conditions);
     bool check1_spc(proof* p, expr_ref_vector& side_conditions);
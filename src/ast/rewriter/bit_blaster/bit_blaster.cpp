@@ -127,4 +127,5 @@ bit_blaster::bit_blaster(ast_manager & m, bit_blaster_params const & params):
     bit_blaster_tpl<bit_blaster_cfg>(bit_blaster_cfg(m_util, params, m_rw)),
     m_util(m),
     m_rw(m) {
+    set_wallace_multiplier(params.m_bb_wallace_mul);
 }
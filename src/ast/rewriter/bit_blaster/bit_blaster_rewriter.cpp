@@ -136,6 +136,7 @@ struct blaster_rewriter_cfg : public default_rewriter_cfg {
         m_blast_full     = p.get_bool("blast_full", false);
         m_blast_quant    = p.get_bool("blast_quant", false);
         m_blaster.set_max_memory(m_max_memory);
+        m_blaster.set_wallace_multiplier(p.get_bool("wallace_mul", false));
     }
 
     bool rewrite_patterns() const { return true; }
@@ -202,6 +202,11 @@ void bit_blaster_tpl<Cfg>::mk_multiplier(unsigned sz, expr * const * a_bits, exp
         return;
     }
     out_bits.reset();
+    if (m_wallace_mul && sz > 2) {
+        mk_wallace_multiplier(sz, a_bits, b_bits, out_bits);
+        SASSERT(sz == out_bits.size());
+        return;
+    }
 #if 0
     static unsigned counter = 0;
     counter++;
@@ -272,6 +277,82 @@ void bit_blaster_tpl<Cfg>::mk_multiplier(unsigned sz, expr * const * a_bits, exp
 }
 
 
+/**
+   \brief multiplier where the partial products are summed by a Wallace tree.
+   Column k holds the partial products of weight 2^k. Each round compresses 
+   every column with more than two bits using full adders on triples and a half 
+   adder on a remaining pair, carries go to the next column and are dropped 
+   beyond the width. The last two rows are added by a ripple adder. 
+   The depth of the circuit is logarithmic in sz, instead of linear for the array 
+   multiplier. Partial products that simplify to false are not added to the columns.
+*/
+template<typename Cfg>
+void bit_blaster_tpl<Cfg>::mk_wallace_multiplier(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits) {
+    expr_ref_vector pinned(m());
+    vector<ptr_vector<expr>> cols(sz), next(sz);
+    expr_ref t(m()), s(m()), c(m());
+    for (unsigned i = 0; i < sz; i++) {
+        for (unsigned j = 0; i + j < sz; j++) {
+            mk_and(a_bits[j], b_bits[i], t);
+            if (m().is_false(t))
+                continue;
+            pinned.push_back(t);
+            cols[i + j].push_back(t);
+        }
+    }
+    auto needs_reduction = [&]() {
+        for (auto const& col : cols)
+            if (col.size() > 2)
+                return true;
+        return false;
+    };
+    while (needs_reduction()) {
+        checkpoint();
+        for (auto& col : next)
+            col.reset();
+        for (unsigned k = 0; k < sz; k++) {
+            auto const& col = cols[k];
+            if (col.size() <= 2) {
+                next[k].append(col);
+                continue;
+            }
+            bool last = k + 1 == sz;
+            unsigned i = 0;
+            for (; i + 3 <= col.size(); i += 3) {
+                if (last) 
+                    mk_xor3(col[i], col[i + 1], col[i + 2], s);
+                else {
+                    mk_full_adder(col[i], col[i + 1], col[i + 2], s, c);
+                    pinned.push_back(c);
+                    next[k + 1].push_back(c);
+                }
+                pinned.push_back(s);
+                next[k].push_back(s);
+            }
+            if (i + 2 == col.size()) {
+                if (last)
+                    mk_xor(col[i], col[i + 1], s);
+                else {
+                    mk_half_adder(col[i], col[i + 1], s, c);
+                    pinned.push_back(c);
+                    next[k + 1].push_back(c);
+                }
+                pinned.push_back(s);
+                next[k].push_back(s);
+            }
+            else if (i + 1 == col.size())
+                next[k].push_back(col[i]);
+        }
+        cols.swap(next);
+    }
+    ptr_buffer<expr, 128> row1, row2;
+    for (auto const& col : cols) {
+        row1.push_back(col.size() > 0 ? col[0] : m().mk_false());
+        row2.push_back(col.size() > 1 ? col[1] : m().mk_false());
+    }
+    mk_adder(sz, row1.data(), row2.data(), out_bits);
+}
+
 template<typename Cfg>
 void bit_blaster_tpl<Cfg>::mk_umul_no_overflow(unsigned sz, expr* const* a_bits, expr* const* b_bits, expr_ref& result) {
     SASSERT(sz > 0);
@@ -27,7 +27,8 @@ bv2int_translator::bv2int_translator(ast_manager& m, bv2int_translator_trail& ct
     m_args(m),
     m_pinned(m),
     m_vars(m),
-    m_preds(m)
+    m_preds(m),
+    m_range_pinned(m)
 {}
 
 void bv2int_translator::reset(bool is_plugin) {
@@ -36,6 +37,8 @@ void bv2int_translator::reset(bool is_plugin) {
     for (unsigned i = m_translate.size(); i-- > 0; )
         m_translate[i] = nullptr;
     m_is_plugin = is_plugin;
+    m_range.reset();
+    m_range_pinned.reset();
 }
 
 
@@ -176,6 +179,7 @@ void bv2int_translator::translate_app(app* e) {
         if (!m_new_funs.find(f, g)) {
             g = m.mk_fresh_func_decl(e->get_decl()->get_name(), symbol("bv"), f->get_arity(), f->get_domain(), a.mk_int());
             m_new_funs.insert(f, g);
+            m_fun_bits.insert(g, bv.get_bv_size(e));
         }
         f = g;
         m_pinned.push_back(f);
@@ -585,17 +589,139 @@ void bv2int_translator::translate_basic(app* e) {
 }
 
 bool bv2int_translator::is_bounded(expr* x, rational const& N) {
-    return any_of(m_vars, [&](expr* v) {
-        return is_translated(v) && translated(v) == x && bv_size(v) <= N;
-        });
+    rational lo, hi;
+    return get_range(x, lo, hi) && lo >= 0 && hi < N;
+}
+
+/*
+* Compute an interval [lo, hi] that contains every value of the arithmetic term x.
+* Translations of bit-vector variables, bv2int and wrap terms range over [0, 2^k).
+* Ranges of sums, products and quotients follow from the ranges of their arguments.
+*/
+bool bv2int_translator::get_range(expr* x, rational& lo, rational& hi, unsigned depth) {
+    if (a.is_numeral(x, lo)) {
+        hi = lo;
+        return true;
+    }
+    range r;
+    if (m_range.find(x, r)) {
+        lo = r.lo, hi = r.hi;
+        return r.known;
+    }
+    if (!is_app(x) || depth > 32)
+        return false;
+    r.known = compute_range(to_app(x), r.lo, r.hi, depth);
+    m_range.insert(x, r);
+    m_range_pinned.push_back(x);
+    lo = r.lo, hi = r.hi;
+    return r.known;
+}
+
+bool bv2int_translator::compute_range(app* x, rational& lo, rational& hi, unsigned depth) {
+    rational lo1, hi1, c;
+    unsigned sz = 0;
+    expr* t = nullptr, * s = nullptr, * u = nullptr;
+    auto arg_range = [&](expr* arg) { return get_range(arg, lo1, hi1, depth + 1); };
+    if (bv.is_bv2int(x))
+        sz = bv.get_bv_size(x->get_arg(0));
+    else if (m_fun_bits.find(x->get_decl(), sz) || m_wrap_bits.find(x->get_decl(), sz))
+        ;
+    else if (a.is_band(x, sz, t, s) || a.is_shl(x, sz, t, s) || a.is_lshr(x, sz, t, s))
+        ;
+    else if (a.is_add(x)) {
+        lo = hi = 0;
+        for (expr* arg : *x) {
+            if (!arg_range(arg))
+                return false;
+            lo += lo1, hi += hi1;
+        }
+        return true;
+    }
+    else if (a.is_sub(x)) {
+        for (unsigned i = 0; i < x->get_num_args(); ++i) {
+            if (!arg_range(x->get_arg(i)))
+                return false;
+            if (i == 0)
+                lo = lo1, hi = hi1;
+            else
+                lo -= hi1, hi -= lo1;
+        }
+        return true;
+    }
+    else if (a.is_uminus(x, t)) {
+        if (!arg_range(t))
+            return false;
+        lo = -hi1, hi = -lo1;
+        return true;
+    }
+    else if (a.is_mul(x)) {
+        lo = hi = 1;
+        for (expr* arg : *x) {
+            if (!arg_range(arg))
+                return false;
+            rational p1 = lo * lo1, p2 = lo * hi1, p3 = hi * lo1, p4 = hi * hi1;
+            lo = std::min(std::min(p1, p2), std::min(p3, p4));
+            hi = std::max(std::max(p1, p2), std::max(p3, p4));
+        }
+        return true;
+    }
+    else if (a.is_idiv(x, t, s) && a.is_numeral(s, c) && c > 0) {
+        if (!arg_range(t))
+            return false;
+        lo = floor(lo1 / c), hi = floor(hi1 / c);
+        return true;
+    }
+    else if (a.is_mod(x, t, s) && a.is_numeral(s, c) && c > 0) {
+        lo = 0, hi = c - 1;
+        return true;
+    }
+    else if (m.is_ite(x, u, t, s)) {
+        if (!arg_range(t))
+            return false;
+        lo = lo1, hi = hi1;
+        if (!arg_range(s))
+            return false;
+        lo = std::min(lo, lo1), hi = std::max(hi, hi1);
+        return true;
+    }
+    else
+        return false;
+    lo = 0;
+    hi = rational::power_of_two(sz) - 1;
+    return true;
+}
+
+bool bv2int_translator::is_wrap(expr* e, expr*& x, rational& N) const {
+    unsigned sz = 0;
+    if (!is_app(e) || !m_wrap_bits.find(to_app(e)->get_decl(), sz))
+        return false;
+    x = to_app(e)->get_arg(0);
+    N = rational::power_of_two(sz);
+    return true;
+}
+
+/*
+* Create a term that is only constrained to be in the range [0, N).
+* The solver adds the axiom wrap(x) = x mod N when a model violates it.
+*/
+expr* bv2int_translator::mk_wrap(expr* x, rational const& N) {
+    unsigned sz = N.get_num_bits() - 1;
+    func_decl* f = nullptr;
+    if (!m_wrap_funs.find(sz, f)) {
+        sort* i = a.mk_int();
+        f = m.mk_fresh_func_decl("bv.wrap", 1, &i, i);
+        m_pinned.push_back(f);
+        m_wrap_funs.insert(sz, f);
+        m_wrap_bits.insert(f, sz);
+    }
+    return m.mk_app(f, x);
 }
 
 bool bv2int_translator::is_non_negative(expr* bv_expr, expr* e) {
-    auto N = rational::power_of_two(bv.get_bv_size(bv_expr));
-    rational r;
+    rational r, lo, hi;
     if (a.is_numeral(e, r))
         return r >= 0;
-    if (is_bounded(e, N))
+    if (get_range(e, lo, hi) && lo >= 0)
         return true;
     expr* x = nullptr, * y = nullptr;
     if (a.is_mul(e, x, y))
@@ -670,6 +796,8 @@ expr* bv2int_translator::amod(expr* bv_expr, expr* x, rational const& N) {
         r = a.mk_int(mod(v, N));
     else if (is_bounded(x, N))
         r = x;
+    else if (m_lazy_mod && m_is_plugin)
+        r = mk_wrap(x, N);
     else
         r = a.mk_mod(x, a.mk_int(N));
     return r;
@@ -5,6 +5,15 @@ Module Name:
 
     bv2int_translator
     Utilities for translating bit-vector constraints into arithmetic.
+
+    Arithmetic terms are reduced modulo 2^k only when they are used in a
+    position that requires the bit-vector value and when their range is
+    not known to be within [0, 2^k). Ranges are computed from the bounds
+    of bit-vector variables, numerals and the arithmetic operators.
+
+    In lazy mode the remaining reductions are replaced by terms bv.wrap(x)
+    that are only known to be in [0, 2^k). The solver refines them to
+    x mod 2^k when a model violates the reduction.
     
 Author:
 
@@ -25,6 +34,10 @@ public:
 };
 
 class bv2int_translator {
+    struct range {
+        rational lo, hi;
+        bool     known = false;
+    };
     ast_manager& m;
     bv2int_translator_trail& ctx;
     bv_util bv;
@@ -35,6 +48,12 @@ class bv2int_translator {
     ptr_vector<app> m_bv2int, m_int2bv;
     expr_ref_vector m_vars, m_preds;
     bool m_is_plugin = true;
+    bool m_lazy_mod = false;
+    obj_map<func_decl, unsigned> m_fun_bits;    // fresh functions for bit-vector functions -> bit-width
+    u_map<func_decl*> m_wrap_funs;              // bit-width -> wrap function
+    obj_map<func_decl, unsigned> m_wrap_bits;   // wrap function -> bit-width
+    obj_map<expr, range> m_range;
+    expr_ref_vector m_range_pinned;
 
     void set_translated(expr* e, expr* r);
     expr* arg(unsigned i) { return m_args.get(i); }
@@ -42,6 +61,9 @@ class bv2int_translator {
     expr* umod(expr* bv_expr, unsigned i);
     expr* smod(expr* bv_expr, unsigned i);
     bool is_bounded(expr* v, rational const& N);
+    bool get_range(expr* x, rational& lo, rational& hi, unsigned depth = 0);
+    bool compute_range(app* x, rational& lo, rational& hi, unsigned depth);
+    expr* mk_wrap(expr* x, rational const& N);
     bool is_non_negative(expr* bv_expr, expr* e);
     expr_ref mul(expr* x, expr* y);
     expr_ref add(expr* x, expr* y);
@@ -80,5 +102,9 @@ public:
     ptr_vector<app> const& int2bv() const { return m_int2bv; }
 
     void reset(bool is_plugin);
+
+    void set_lazy_mod(bool f) { m_lazy_mod = f; }
+
+    bool is_wrap(expr* e, expr*& x, rational& N) const;
        
 };
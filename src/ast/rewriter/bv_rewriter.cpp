@@ -52,9 +52,176 @@ void bv_rewriter::get_param_descrs(param_descrs & r) {
     bv_rewriter_params::collect_param_descrs(r);
 }
 
+static inline uint64_t mask64(unsigned sz) {
+    return sz >= 64 ? ~0ull : (1ull << sz) - 1;
+}
+
+static inline int64_t to_signed64(uint64_t v, unsigned sz) {
+    if (sz < 64 && (v >> (sz - 1)) & 1)
+        v |= ~mask64(sz);
+    return static_cast<int64_t>(v);
+}
+
+/**
+   \brief fold applications whose arguments are numerals of at most 64 bits 
+   using machine arithmetic. Return false if f is not handled, if an argument 
+   is not a numeral, if the result would be wider than 64 bits, or for 
+   division by zero, which depends on hi_div0.
+*/
+bool bv_rewriter::fold_numerals64(func_decl * f, unsigned num_args, expr * const * args, expr_ref & result) {
+    uint64_t vals[2] = { 0, 0 };
+    unsigned sz = 0;
+    for (unsigned i = 0; i < num_args; ++i) {
+        if (!m_util.is_numeral(args[i]))
+            return false;
+        func_decl * d = to_app(args[i])->get_decl();
+        sz = d->get_parameter(1).get_int();
+        if (sz > 64)
+            return false;
+        if (i < 2)
+            vals[i] = d->get_parameter(0).get_rational().get_uint64();
+    }
+    uint64_t a = vals[0], b = vals[1];
+    uint64_t mask = mask64(sz);
+    auto fold_nary = [&](auto const & op) {
+        uint64_t r = a;
+        for (unsigned i = 1; i < num_args; ++i)
+            r = op(r, i == 1 ? b : to_app(args[i])->get_decl()->get_parameter(0).get_rational().get_uint64());
+        return r & mask;
+    };
+    auto mk_num = [&](uint64_t v, unsigned n) {
+        result = m_util.mk_numeral(rational(v & mask64(n), rational::ui64()), n);
+        return true;
+    };
+    auto mk_bool = [&](bool v) {
+        result = m.mk_bool_val(v);
+        return true;
+    };
+    auto abs64 = [&](uint64_t v) {
+        return to_signed64(v, sz) < 0 ? (0 - v) & mask : v;
+    };
+    bool neg_a = to_signed64(a, sz) < 0, neg_b = to_signed64(b, sz) < 0;
+    
+    switch (f->get_decl_kind()) {
+    case OP_BNEG:   return mk_num(0 - a, sz);
+    case OP_BNOT:   return mk_num(~a, sz);
+    case OP_BADD:   return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x + y; }), sz);
+    case OP_BSUB:   return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x - y; }), sz);
+    case OP_BMUL:   return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x * y; }), sz);
+    case OP_BAND:   return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x & y; }), sz);
+    case OP_BOR:    return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x | y; }), sz);
+    case OP_BXOR:   return mk_num(fold_nary([](uint64_t x, uint64_t y) { return x ^ y; }), sz);
+    case OP_BNAND:  return num_args == 2 && mk_num(~(a & b), sz);
+    case OP_BNOR:   return num_args == 2 && mk_num(~(a | b), sz);
+    case OP_BXNOR:  return num_args == 2 && mk_num(~(a ^ b), sz);
+    case OP_BSHL:   return mk_num(b >= sz ? 0 : a << b, sz);
+    case OP_BLSHR:  return mk_num(b >= sz ? 0 : a >> b, sz);
+    case OP_BASHR:
+        if (b >= sz)
+            return mk_num(neg_a ? mask : 0, sz);
+        return mk_num(static_cast<uint64_t>(to_signed64(a, sz) >> b), sz);
+    case OP_BUDIV:
+    case OP_BUDIV_I:
+        return b != 0 && mk_num(a / b, sz);
+    case OP_BUREM:
+    case OP_BUREM_I:
+        return b != 0 && mk_num(a % b, sz);
+    case OP_BSDIV:
+    case OP_BSDIV_I: {
+        if (b == 0)
+            return false;
+        uint64_t q = abs64(a) / abs64(b);
+        return mk_num(neg_a != neg_b ? 0 - q : q, sz);
+    }
+    case OP_BSREM:
+    case OP_BSREM_I: {
+        if (b == 0)
+            return false;
+        uint64_t r = abs64(a) % abs64(b);
+        return mk_num(neg_a ? 0 - r : r, sz);
+    }
+    case OP_BSMOD:
+    case OP_BSMOD_I: {
+        if (b == 0)
+            return false;
+        uint64_t u = abs64(a) % abs64(b);
+        if (u == 0 || (!neg_a && !neg_b))
+            return mk_num(u, sz);
+        if (neg_a && neg_b)
+            return mk_num(0 - u, sz);
+        if (neg_a)
+            return mk_num(b - u, sz);
+        return mk_num(u + b, sz);
+    }
+    case OP_ULEQ:   return mk_bool(a <= b);
+    case OP_UGEQ:   return mk_bool(a >= b);
+    case OP_ULT:    return mk_bool(a < b);
+    case OP_UGT:    return mk_bool(a > b);
+    case OP_SLEQ:   return mk_bool(to_signed64(a, sz) <= to_signed64(b, sz));
+    case OP_SGEQ:   return mk_bool(to_signed64(a, sz) >= to_signed64(b, sz));
+    case OP_SLT:    return mk_bool(to_signed64(a, sz) < to_signed64(b, sz));
+    case OP_SGT:    return mk_bool(to_signed64(a, sz) > to_signed64(b, sz));
+    case OP_BCOMP:  return mk_num(a == b ? 1 : 0, 1);
+    case OP_BREDOR: return mk_num(a != 0 ? 1 : 0, 1);
+    case OP_BREDAND: return mk_num(a == mask ? 1 : 0, 1);
+    case OP_BIT2BOOL: return mk_bool((a >> f->get_parameter(0).get_int()) & 1);
+    case OP_EXTRACT: {
+        unsigned high = m_util.get_extract_high(f), low = m_util.get_extract_low(f);
+        return mk_num(a >> low, high - low + 1);
+    }
+    case OP_CONCAT: {
+        unsigned n = m_util.get_bv_size(f->get_range());
+        if (n > 64)
+            return false;
+        uint64_t r = 0;
+        for (unsigned i = 0; i < num_args; ++i) {
+            func_decl * d = to_app(args[i])->get_decl();
+            unsigned szi = d->get_parameter(1).get_int();
+            r = (szi == 64 ? 0 : r << szi) | d->get_parameter(0).get_rational().get_uint64();
+        }
+        return mk_num(r, n);
+    }
+    case OP_ZERO_EXT:
+    case OP_SIGN_EXT: {
+        unsigned n = m_util.get_bv_size(f->get_range());
+        if (n > 64)
+            return false;
+        uint64_t r = f->get_decl_kind() == OP_SIGN_EXT ? static_cast<uint64_t>(to_signed64(a, sz)) : a;
+        return mk_num(r, n);
+    }
+    case OP_REPEAT: {
+        unsigned n = m_util.get_bv_size(f->get_range());
+        if (n > 64)
+            return false;
+        uint64_t r = 0;
+        for (unsigned i = n / sz; i-- > 0; )
+            r = (sz == 64 ? 0 : r << sz) | a;
+        return mk_num(r, n);
+    }
+    case OP_ROTATE_LEFT:
+    case OP_ROTATE_RIGHT:
+    case OP_EXT_ROTATE_LEFT:
+    case OP_EXT_ROTATE_RIGHT: {
+        bool left = f->get_decl_kind() == OP_ROTATE_LEFT || f->get_decl_kind() == OP_EXT_ROTATE_LEFT;
+        uint64_t k = (f->get_decl_kind() == OP_ROTATE_LEFT || f->get_decl_kind() == OP_ROTATE_RIGHT) 
+            ? static_cast<uint64_t>(f->get_parameter(0).get_int()) % sz : b % sz;
+        if (k == 0)
+            return mk_num(a, sz);
+        if (!left)
+            k = sz - k;
+        return mk_num((a << k) | (a >> (sz - k)), sz);
+    }
+    default:
+        return false;
+    }
+}
+
 br_status bv_rewriter::mk_app_core(func_decl * f, unsigned num_args, expr * const * args, expr_ref & result) {
     SASSERT(f->get_family_id() == get_fid());
 
+    if (num_args > 0 && fold_numerals64(f, num_args, args, result))
+        return BR_DONE;
+
     br_status st = BR_FAILED;
     switch(f->get_decl_kind()) {
     case OP_BIT0: SASSERT(num_args == 0); result = mk_zero(1); return BR_DONE;
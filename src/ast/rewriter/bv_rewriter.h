@@ -67,6 +67,8 @@ class bv_rewriter : public poly_rewriter<bv_rewriter_core> {
     
     bool is_zero_bit(expr * x, unsigned idx);
 
+    bool fold_numerals64(func_decl * f, unsigned num_args, expr * const * args, expr_ref & result);
+
     br_status mk_ule(expr * a, expr * b, expr_ref & result);
     br_status mk_uge(expr * a, expr * b, expr_ref & result);
     br_status mk_ult(expr * a, expr * b, expr_ref & result);
@@ -33,7 +33,8 @@ bool cached_var_subst::key_eq_proc::operator()(cached_var_subst::key * k1, cache
 cached_var_subst::cached_var_subst(ast_manager & _m):
     m(_m),
     m_proc(m),
-    m_refs(m) {
+    m_refs(m),
+    m_values(m) {
 }
 
 void cached_var_subst::reset() {
@@ -42,6 +43,103 @@ void cached_var_subst::reset() {
     m_region.reset();
     m_new_keys.reset();
     m_key = nullptr;
+    m_templates.reset();
+    m_template_store.reset();
+}
+
+/**
+   \brief return the instantiation template of q, compiling it on first use.
+   Bodies that are ground or contain quantifiers have no template.
+*/
+cached_var_subst::inst_template* cached_var_subst::get_template(quantifier* q) {
+    inst_template* t = nullptr;
+    if (m_templates.find(q, t))
+        return t;
+    expr* body = q->get_expr();
+    if (is_ground(body) || has_quantifiers(body)) {
+        m_templates.insert(q, nullptr);
+        return nullptr;
+    }
+    t = alloc(inst_template);
+    m_template_store.push_back(t);
+    m_templates.insert(q, t);
+    m_refs.push_back(q);
+    m_expr2instr.reset();
+    m_todo.reset();
+    m_todo.push_back(body);
+    while (!m_todo.empty()) {
+        expr* e = m_todo.back();
+        if (m_expr2instr.contains(e)) {
+            m_todo.pop_back();
+            continue;
+        }
+        bool visited = true;
+        if (is_app(e)) {
+            for (expr* arg : *to_app(e)) {
+                if (!is_ground(arg) && !m_expr2instr.contains(arg)) {
+                    m_todo.push_back(arg);
+                    visited = false;
+                }
+            }
+        }
+        if (!visited)
+            continue;
+        m_todo.pop_back();
+        unsigned offset = t->m_slots.size();
+        if (is_app(e))
+            for (expr* arg : *to_app(e))
+                t->m_slots.push_back(is_ground(arg) ? UINT_MAX : m_expr2instr[arg]);
+        m_expr2instr.insert(e, t->m_code.size());
+        t->m_code.push_back({ e, offset });
+    }
+    m_expr2instr.reset();
+    return t;
+}
+
+/**
+   \brief instantiate a template by filling the variable slots with the bindings
+   and rebuilding the applications bottom-up. Following var_subst, an if-then-else
+   whose condition becomes true or false is replaced by the selected branch, and
+   variables without a binding are left unchanged.
+*/
+expr_ref cached_var_subst::instantiate(inst_template const& t, unsigned num_bindings, expr* const* bindings) {
+    m_values.reset();
+    for (auto const& [e, offset] : t.m_code) {
+        if (is_var(e)) {
+            unsigned idx = to_var(e)->get_idx();
+            expr* r = idx < num_bindings ? bindings[num_bindings - idx - 1] : nullptr;
+            m_values.push_back(r ? r : e);
+            continue;
+        }
+        app* a = to_app(e);
+        unsigned sz = a->get_num_args();
+        auto value = [&](unsigned i) {
+            unsigned s = t.m_slots[offset + i];
+            return s == UINT_MAX ? a->get_arg(i) : m_values.get(s);
+        };
+        if (m.is_ite(a)) {
+            expr* c = value(0);
+            if (m.is_true(c)) {
+                m_values.push_back(value(1));
+                continue;
+            }
+            if (m.is_false(c)) {
+                m_values.push_back(value(2));
+                continue;
+            }
+        }
+        m_args.reset();
+        bool changed = false;
+        for (unsigned i = 0; i < sz; ++i) {
+            expr* v = value(i);
+            changed |= v != a->get_arg(i);
+            m_args.push_back(v);
+        }
+        m_values.push_back(changed ? m.mk_app(a->get_decl(), sz, m_args.data()) : a);
+    }
+    expr_ref result(m_values.back(), m);
+    m_values.reset();
+    return result;
 }
 
 expr** cached_var_subst::operator()(quantifier* qa, unsigned num_bindings) {
@@ -75,7 +173,11 @@ expr_ref cached_var_subst::operator()() {
 
     SASSERT(entry->get_data().m_value == 0);
     try {
-        result = m_proc(m_key->m_qa->get_expr(), m_key->m_num_bindings, m_key->m_bindings);
+        inst_template* t = m_key->m_num_bindings > 0 ? get_template(m_key->m_qa) : nullptr;
+        if (t)
+            result = instantiate(*t, m_key->m_num_bindings, m_key->m_bindings);
+        else
+            result = m_proc(m_key->m_qa->get_expr(), m_key->m_num_bindings, m_key->m_bindings);
     }
     catch (...) {
         // CMW: The var_subst reducer was interrupted and m_instances is
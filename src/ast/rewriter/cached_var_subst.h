@@ -20,6 +20,8 @@ Revision History:
 
 #include "ast/rewriter/var_subst.h"
 #include "util/map.h"
+#include "util/obj_hashtable.h"
+#include "util/scoped_ptr_vector.h"
 
 class cached_var_subst {
     struct key {
@@ -36,6 +38,22 @@ class cached_var_subst {
         bool operator()(key * k1, key * k2) const;
     };
     typedef map<key *, expr *, key_hash_proc, key_eq_proc> instances;
+
+    /**
+       \brief instantiation template of a quantifier body without nested quantifiers.
+       The non-ground sub-terms of the body are listed in post-order. An instruction
+       is either a variable or an application whose non-ground arguments refer to
+       earlier instructions; ground arguments are taken from the body.
+    */
+    struct inst_template {
+        struct instr {
+            expr*    m_expr;       // the sub-term of the body
+            unsigned m_args;       // offset of the argument slots in m_slots
+        };
+        svector<instr>    m_code;
+        unsigned_vector   m_slots; // instruction index of each argument, UINT_MAX if ground
+    };
+
     ast_manager&     m;
     var_subst        m_proc;
     expr_ref_vector  m_refs;
@@ -43,6 +61,16 @@ class cached_var_subst {
     region           m_region;
     ptr_vector<key>  m_new_keys; // mapping from num_bindings -> next key
     key*             m_key { nullptr };
+    obj_map<quantifier, inst_template*> m_templates;
+    scoped_ptr_vector<inst_template>    m_template_store;
+    obj_map<expr, unsigned>             m_expr2instr;
+    ptr_vector<expr>                    m_todo;
+    expr_ref_vector                     m_values;
+    ptr_buffer<expr>                    m_args;
+
+    inst_template* get_template(quantifier* q);
+    expr_ref instantiate(inst_template const& t, unsigned num_bindings, expr* const* bindings);
+
 public:
     cached_var_subst(ast_manager & m);
     expr** operator()(quantifier * qa, unsigned num_bindings);
@@ -1055,6 +1055,9 @@ struct pb2bv_rewriter::imp {
         if (enc == symbol("ordered")) return sorting_network_encoding::ordered_at_most;
         if (enc == symbol("unate")) return sorting_network_encoding::unate_at_most;
         if (enc == symbol("circuit")) return sorting_network_encoding::circuit_at_most;
+        if (enc == symbol("totalizer")) return sorting_network_encoding::totalizer_at_most;
+        if (enc == symbol("mtotalizer")) return sorting_network_encoding::mtotalizer_at_most;
+        if (enc == symbol("auto")) return sorting_network_encoding::auto_at_most;
         return sorting_network_encoding::grouped_at_most;
     }
     
@@ -1080,7 +1083,7 @@ struct pb2bv_rewriter::imp {
     void collect_param_descrs(param_descrs& r) const {
         r.insert("keep_cardinality_constraints", CPK_BOOL, "retain cardinality constraints (don't bit-blast them) and use built-in cardinality solver", "false");
         r.insert("pb.solver", CPK_SYMBOL, "encoding used for Pseudo-Boolean constraints: totalizer, sorting, binary_merge, bv, solver. PB constraints are retained if set to 'solver'", "solver");
-        r.insert("cardinality.encoding", CPK_SYMBOL, "encoding used for cardinality constraints: grouped, bimander, ordered, unate, circuit", "none");
+        r.insert("cardinality.encoding", CPK_SYMBOL, "encoding used for cardinality constraints: grouped, bimander, ordered, unate, circuit, totalizer, mtotalizer, auto", "none");
     }
 
     unsigned get_num_steps() const { return m_rw.get_num_steps(); }
@@ -1113,7 +1116,13 @@ struct pb2bv_rewriter::imp {
         st.update("pb-compile-bv", m_compile_bv);
         st.update("pb-compile-card", m_compile_card);
         st.update("pb-aux-variables", m_fresh.size());
-        st.update("pb-aux-clauses", m_rw.m_cfg.m_r.m_sort.m_stats.m_num_compiled_clauses);
+        auto const& sst = m_rw.m_cfg.m_r.m_sort.m_stats;
+        st.update("pb-aux-clauses", sst.m_num_compiled_clauses);
+        st.update("pb-card-sorted", sst.m_num_sorted);
+        st.update("pb-card-unate", sst.m_num_unate);
+        st.update("pb-card-circuit", sst.m_num_circuit);
+        st.update("pb-card-totalizer", sst.m_num_totalizer);
+        st.update("pb-card-mtotalizer", sst.m_num_mtotalizer);
     }
 
 };
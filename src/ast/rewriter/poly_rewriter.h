@@ -36,6 +36,7 @@ protected:
     bool                    m_hoist_mul;
     bool                    m_ast_order;
     bool                    m_hoist_ite;
+    unsigned                m_large_sum_threshold = 128;
     ast_manager& M() { return Config::m; }
 
     bool is_numeral(expr * n) const { return Config::is_numeral(n); }
@@ -63,6 +64,7 @@ protected:
 
     br_status mk_flat_add_core(unsigned num_args, expr * const * args, expr_ref & result);
     br_status mk_nflat_add_core(unsigned num_args, expr * const * args, expr_ref & result);
+    br_status mk_nflat_add_large(unsigned num_args, expr * const * args, expr_ref & result);
 
     void set_curr_sort(sort * s) { m_curr_sort = s; }
 
@@ -116,6 +118,9 @@ public:
 
     void set_sort_sums(bool f) { m_sort_sums = f; }
 
+    // sums with at least this many arguments are merged in a single hashed pass.
+    void set_large_sum_threshold(unsigned n) { m_large_sum_threshold = n; }
+
     bool is_add(expr * n) const { return is_app_of(n, get_fid(), add_decl_kind()); }
     bool is_mul(expr * n) const { return is_app_of(n, get_fid(), mul_decl_kind()); }
     bool is_add(func_decl * f) const { return is_decl_of(f, get_fid(), add_decl_kind()); }
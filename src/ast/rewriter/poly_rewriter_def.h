@@ -528,6 +528,8 @@ int poly_rewriter<Config>::mon_lt::ordinal(expr* e) const {
 
 template<typename Config>
 br_status poly_rewriter<Config>::mk_nflat_add_core(unsigned num_args, expr * const * args, expr_ref & result) {
+    if (num_args >= m_large_sum_threshold)
+        return mk_nflat_add_large(num_args, args, result);
     mon_lt lt(*this);
     SASSERT(num_args >= 2);
     numeral c;
@@ -665,6 +667,105 @@ br_status poly_rewriter<Config>::mk_nflat_add_core(unsigned num_args, expr * con
     }
 }
 
+/**
+   \brief mk_nflat_add_core for sums with many arguments.
+   Coefficients are accumulated in a single pass that maps each power
+   product to its first occurrence, instead of marking the arguments and
+   walking them again to merge and copy the repeated power products.
+   The result is the same as the one produced by mk_nflat_add_core.
+*/
+template<typename Config>
+br_status poly_rewriter<Config>::mk_nflat_add_large(unsigned num_args, expr * const * args, expr_ref & result) {
+    mon_lt lt(*this);
+    SASSERT(num_args >= 2);
+    numeral c, a;
+    unsigned num_coeffs = 0;
+    bool     has_multiple = false;
+    expr *   prev = nullptr;
+    bool     ordered = true;
+    ptr_buffer<expr>     mons;     // first occurrence of each power product
+    ptr_buffer<expr>     pps;
+    buffer<numeral>      coeffs;
+    bool_vector          merged;   // power product occurs more than once
+    obj_hashtable<expr>  numerals;
+    m_expr2pos.reset();
+    for (unsigned i = 0; i < num_args; i++) {
+        expr * arg = args[i];
+        if (is_numeral(arg, a)) {
+            num_coeffs++;
+            c += a;
+            ordered = !m_sort_sums || i == 0;
+            if (numerals.contains(arg))
+                has_multiple = true;
+            else
+                numerals.insert(arg);
+            continue;
+        }
+        if (m_sort_sums && ordered) {
+            if (prev != nullptr && lt(arg, prev))
+                ordered = false;
+            prev = arg;
+        }
+        expr * pp = get_power_product(arg, a);
+        unsigned pos;
+        if (m_expr2pos.find(pp, pos)) {
+            coeffs[pos] += a;
+            merged[pos] = true;
+            has_multiple = true;
+        }
+        else {
+            m_expr2pos.insert(pp, mons.size());
+            mons.push_back(arg);
+            pps.push_back(pp);
+            coeffs.push_back(a);
+            merged.push_back(false);
+        }
+    }
+    // a power product that is also a numeral argument counts as repeated.
+    if (!numerals.empty()) {
+        for (unsigned i = 0; i < pps.size(); ++i) {
+            if (is_numeral(pps[i]) && numerals.contains(pps[i])) {
+                merged[i] = true;
+                has_multiple = true;
+            }
+        }
+    }
+    normalize(c);
+    SASSERT(m_sort_sums || ordered);
+
+    if (!has_multiple && ordered && !m_hoist_mul && !m_hoist_ite) {
+        if (num_coeffs == 0)
+            return BR_FAILED;
+        if (num_coeffs == 1 && is_numeral(args[0], a) && !a.is_zero())
+            return BR_FAILED;
+    }
+    expr_ref_buffer new_args(M());
+    if (!c.is_zero())
+        new_args.push_back(mk_numeral(c));
+    for (unsigned i = 0; i < mons.size(); ++i) {
+        if (!merged[i]) {
+            new_args.push_back(mons[i]);
+            continue;
+        }
+        a = coeffs[i];
+        normalize(a);
+        if (!a.is_zero())
+            new_args.push_back(mk_mul_app(a, pps[i]));
+    }
+    if (m_sort_sums && (has_multiple || !ordered)) {
+        if (c.is_zero())
+            std::sort(new_args.data(), new_args.data() + new_args.size(), lt);
+        else
+            std::sort(new_args.data() + 1, new_args.data() + new_args.size(), lt);
+    }
+    result = mk_add_app(new_args.size(), new_args.data());
+    TRACE("rewriter", tout << result << "\n";);
+    if (hoist_multiplication(result))
+        return BR_REWRITE_FULL;
+    if (hoist_ite(result))
+        return BR_REWRITE_FULL;
+    return BR_DONE;
+}
 
 template<typename Config>
 br_status poly_rewriter<Config>::mk_uminus(expr * arg, expr_ref & result) {
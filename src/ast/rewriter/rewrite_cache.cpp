@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.cpp
+
+Abstract:
+
+    Bounded cache of rewriting results that persists across rewriter calls.
+
+--*/
+
+#include "ast/rewriter/rewrite_cache.h"
+
+expr* rewrite_cache::find(expr* k, unsigned fingerprint) {
+    unsigned idx;
+    if (!m_index.find(key(k, fingerprint), idx)) {
+        ++m_stats.m_misses;
+        return nullptr;
+    }
+    ++m_stats.m_hits;
+    m_entries[idx].m_referenced = true;
+    return m_entries[idx].m_value;
+}
+
+/**
+   \brief advance the clock hand to an entry that was not referenced since
+   the hand last passed it, release the entry and return its position.
+*/
+unsigned rewrite_cache::evict() {
+    while (m_entries[m_hand].m_referenced) {
+        m_entries[m_hand].m_referenced = false;
+        m_hand = (m_hand + 1) % m_entries.size();
+    }
+    unsigned idx = m_hand;
+    m_hand = (m_hand + 1) % m_entries.size();
+    entry& e = m_entries[idx];
+    m_index.erase(key(e.m_key, e.m_fingerprint));
+    m.dec_ref(e.m_key);
+    m.dec_ref(e.m_value);
+    ++m_stats.m_evictions;
+    return idx;
+}
+
+void rewrite_cache::insert(expr* k, unsigned fingerprint, expr* v) {
+    if (m_index.contains(key(k, fingerprint)))
+        return;
+    m.inc_ref(k);
+    m.inc_ref(v);
+    unsigned idx;
+    if (m_entries.size() < m_max_size) {
+        idx = m_entries.size();
+        m_entries.push_back(entry());
+    }
+    else
+        idx = evict();
+    m_entries[idx] = { k, v, fingerprint, false };
+    m_index.insert(key(k, fingerprint), idx);
+}
+
+void rewrite_cache::reset() {
+    for (entry const& e : m_entries) {
+        m.dec_ref(e.m_key);
+        m.dec_ref(e.m_value);
+    }
+    m_entries.reset();
+    m_index.reset();
+    m_hand = 0;
+}
+
+void rewrite_cache::collect_statistics(statistics& st) const {
+    st.update("rewriter.cache-hits", m_stats.m_hits);
+    st.update("rewriter.cache-misses", m_stats.m_misses);
+    st.update("rewriter.cache-evictions", m_stats.m_evictions);
+    st.update("rewriter.cache-size", m_entries.size());
+}
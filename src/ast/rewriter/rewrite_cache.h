@@ -0,0 +1,63 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.h
+
+Abstract:
+
+    Bounded cache of rewriting results that persists across rewriter calls.
+
+    Entries are keyed on an expression and a fingerprint of the rewriter
+    configuration that produced the result. When the cache is full, an entry
+    is evicted using the CLOCK approximation of LRU: each entry has a
+    reference bit that is set on a hit and cleared when the clock hand
+    passes over it.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/map.h"
+#include "util/statistics.h"
+
+class rewrite_cache {
+    typedef std::pair<expr*, unsigned> key;
+    struct key_hash {
+        unsigned operator()(key const& k) const { return k.first->hash() + k.second; }
+    };
+    struct entry {
+        expr*    m_key;
+        expr*    m_value;
+        unsigned m_fingerprint;
+        bool     m_referenced;
+    };
+    struct stats {
+        unsigned m_hits = 0;
+        unsigned m_misses = 0;
+        unsigned m_evictions = 0;
+    };
+    ast_manager&    m;
+    unsigned        m_max_size;
+    svector<entry>  m_entries;
+    map<key, unsigned, key_hash, default_eq<key>> m_index;  // key -> position in m_entries
+    unsigned        m_hand = 0;
+    stats           m_stats;
+
+    unsigned evict();
+
+public:
+    rewrite_cache(ast_manager& m, unsigned max_size): m(m), m_max_size(std::max(1u, max_size)) {}
+    ~rewrite_cache() { reset(); }
+
+    expr* find(expr* k, unsigned fingerprint);
+    void insert(expr* k, unsigned fingerprint, expr* v);
+    void reset();
+
+    unsigned size() const { return m_entries.size(); }
+    unsigned max_size() const { return m_max_size; }
+
+    void collect_statistics(statistics& st) const;
+    void reset_statistics() { m_stats = stats(); }
+};
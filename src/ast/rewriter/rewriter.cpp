@@ -17,6 +17,7 @@ Notes:
 
 --*/
 #include "ast/rewriter/rewriter_def.h"
+#include "ast/rewriter/rewrite_cache.h"
 #include "ast/rewriter/push_app_ite.h"
 #include "ast/rewriter/elim_bounds.h"
 #include "ast/ast_ll_pp.h"
@@ -70,6 +71,8 @@ void rewriter_core::cache_shifted_result(expr * k, unsigned offset, expr * v) {
     SASSERT(k->get_sort() == v->get_sort());
 
     m_cache->insert(k, offset, v);
+    if (m_shared_cache && offset == 0 && m_cache == m_cache_stack[0])
+        m_shared_cache->insert(k, m_shared_fingerprint, v);
 #if 0
     static unsigned num_cached = 0;
     num_cached ++;
@@ -87,6 +90,15 @@ void rewriter_core::cache_result(expr * k, expr * v, proof * pr) {
     m_cache_pr->insert(k, pr);
 }
 
+expr * rewriter_core::get_shared(expr * k) {
+    if (m_cache != m_cache_stack[0])
+        return nullptr;
+    expr * r = m_shared_cache->find(k, m_shared_fingerprint);
+    if (r)
+        m_cache->insert(k, r);
+    return r;
+}
+
 unsigned rewriter_core::get_cache_size() const {
     return m_cache->size();
 }
@@ -21,6 +21,8 @@ Notes:
 #include "ast/ast.h"
 #include "ast/rewriter/rewriter_types.h"
 #include "ast/act_cache.h"
+
+class rewrite_cache;
 #include "util/obj_hashtable.h"
 
 /**
@@ -70,6 +72,8 @@ protected:
         scope(expr * r, unsigned n):m_old_root(r), m_old_num_qvars(n) {}
     };
     svector<scope>             m_scopes;
+    rewrite_cache *            m_shared_cache = nullptr; // results at the top level shared across calls
+    unsigned                   m_shared_fingerprint = 0;
 
     // Return true if the rewriting result of the given expression must be cached.
     bool must_cache(expr * t) const {
@@ -100,6 +104,7 @@ protected:
 
     void cache_result(expr * k, expr * v, proof * pr);
     proof * get_cached_pr(expr * k) const { return static_cast<proof*>(m_cache_pr->find(k)); } 
+    expr * get_shared(expr * k);
 
     void free_memory();
     void begin_scope();
@@ -123,6 +128,15 @@ public:
     void reset();
     void cleanup();
     void set_cancel_check(bool f) { m_cancel_check = f; }
+    /**
+       \brief use c for the results of shared expressions outside of binders.
+       The caller ensures that the results only depend on the configuration
+       identified by fingerprint. c is not used when proofs are generated.
+    */
+    void set_shared_cache(rewrite_cache * c, unsigned fingerprint) { 
+        m_shared_cache = m_proof_gen ? nullptr : c; 
+        m_shared_fingerprint = fingerprint; 
+    }
 #ifdef _TRACE
     void display_stack(std::ostream & out, unsigned pp_depth);
 #endif
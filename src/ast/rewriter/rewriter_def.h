@@ -22,6 +22,7 @@ Notes:
 #include "ast/ast_smt2_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_pp.h"
+#include "util/perf_counters.h"
 
 template<typename Config>
 template<bool ProofGen>
@@ -172,6 +173,8 @@ bool rewriter_tpl<Config>::visit(expr * t, unsigned max_depth) {
             std::cerr << "[rewriter] num-cache-checks: " << checked_cache << std::endl;
 #endif
         expr * r = get_cached(t);
+        if (!r && !ProofGen && m_shared_cache)
+            r = get_shared(t);
         if (r) {
             SASSERT(r->get_sort() == t->get_sort());
             result_stack().push_back(r);
@@ -752,7 +755,7 @@ template<bool ProofGen>
 void rewriter_tpl<Config>::resume_core(expr_ref & result, proof_ref & result_pr) {
     SASSERT(!frame_stack().empty());
     while (!frame_stack().empty()) {
-        if (!m().inc()) {
+        if (!m().limit().tick()) {
             if (m_cancel_check) {
                 reset();
                 throw rewriter_exception(m().limit().get_cancel_msg());
@@ -766,6 +769,8 @@ void rewriter_tpl<Config>::resume_core(expr_ref & result, proof_ref & result_pr)
         check_max_steps();
         if (first_visit(fr) && fr.m_cache_result) {
             expr * r = get_cached(t);
+            if (!r && !ProofGen && m_shared_cache)
+                r = get_shared(t);
             if (r) {
                 SASSERT(r->get_sort() == t->get_sort());
                 result_stack().push_back(r);
@@ -808,6 +813,8 @@ void rewriter_tpl<Config>::resume_core(expr_ref & result, proof_ref & result_pr)
 
 template<typename Config>
 void rewriter_tpl<Config>::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
+    scoped_memory_tag _tag(memory::tag_rewriter);
+    perf_counters::scope _pc(perf_counters::rewriter);
     if (!frame_stack().empty() || m_cache != m_cache_stack[0]) {
         frame_stack().reset();
         result_stack().reset();
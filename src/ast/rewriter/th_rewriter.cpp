@@ -31,6 +31,7 @@ Notes:
 #include "ast/rewriter/recfun_rewriter.h"
 #include "ast/rewriter/seq_rewriter.h"
 #include "ast/rewriter/rewriter_def.h"
+#include "ast/rewriter/rewrite_cache.h"
 #include "ast/rewriter/var_subst.h"
 #include "ast/rewriter/der.h"
 #include "ast/rewriter/expr_safe_replace.h"
@@ -936,11 +937,43 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
     void set_solver(expr_solver* solver) {
         m_cfg.m_seq_rw.set_solver(solver);
     }
+
+    void reset_num_steps() { m_num_steps = 0; }
 };
 
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
     m_params(p) {
     m_imp = alloc(imp, m, p);
+    update_fingerprint();
+}
+
+void th_rewriter::update_fingerprint() {
+    std::ostringstream strm;
+    m_params.display(strm);
+    std::string s = strm.str();
+    m_fingerprint = hash_u_u(string_hash(s.c_str(), static_cast<unsigned>(s.size()), 17), m_config_bits);
+}
+
+/**
+   \brief set up the shared cache for rewriting t.
+   Return true if the result of t is known already.
+*/
+bool th_rewriter::begin_shared(expr * t, expr_ref & result) {
+    bool use = m_shared_cache && !m_has_solver && !m().proofs_enabled() && !m_imp->cfg().m_subst;
+    m_imp->set_shared_cache(use ? m_shared_cache : nullptr, m_fingerprint);
+    if (!use)
+        return false;
+    expr * r = m_shared_cache->find(t, m_fingerprint);
+    if (!r)
+        return false;
+    m_imp->reset_num_steps();
+    result = r;
+    return true;
+}
+
+void th_rewriter::end_shared(expr * t, expr_ref const & result) {
+    if (m_shared_cache && !m_has_solver && !m().proofs_enabled() && !m_imp->cfg().m_subst && m().inc())
+        m_shared_cache->insert(t, m_fingerprint, result);
 }
 
 ast_manager & th_rewriter::m() const {
@@ -950,6 +983,7 @@ ast_manager & th_rewriter::m() const {
 void th_rewriter::updt_params(params_ref const & p) {
     m_params.append(p);
     m_imp->cfg().updt_params(m_params);
+    update_fingerprint();
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -962,10 +996,14 @@ void th_rewriter::get_param_descrs(param_descrs & r) {
 
 void th_rewriter::set_flat_and_or(bool f) {
     m_imp->cfg().m_b_rw.set_flat_and_or(f);
+    m_config_bits = (m_config_bits & ~3u) | (f ? 3u : 1u);
+    update_fingerprint();
 }
 
 void th_rewriter::set_order_eq(bool f) {
     m_imp->cfg().m_b_rw.set_order_eq(f);
+    m_config_bits = (m_config_bits & ~12u) | (f ? 12u : 4u);
+    update_fingerprint();
 }
 
 th_rewriter::~th_rewriter() {
@@ -984,6 +1022,9 @@ void th_rewriter::cleanup() {
     ast_manager & m = m_imp->m();
     m_imp->~imp();
     new (m_imp) imp(m, m_params);
+    m_config_bits = 0;
+    m_has_solver = false;
+    update_fingerprint();
 }
 
 void th_rewriter::reset() {
@@ -994,7 +1035,12 @@ void th_rewriter::reset() {
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());    
     try {
+        if (begin_shared(term, result)) {
+            term = std::move(result);
+            return;
+        }
         m_imp->operator()(term, result);
+        end_shared(term, result);
         term = std::move(result);
     }
     catch (...) {
@@ -1006,7 +1052,10 @@ void th_rewriter::operator()(expr_ref & term) {
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
     try {
+        if (begin_shared(t, result))
+            return;
         m_imp->operator()(t, result);
+        end_shared(t, result);
     }
     catch (...) {
         result = t;
@@ -1018,7 +1067,12 @@ void th_rewriter::operator()(expr * t, expr_ref & result) {
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
     try {
+        if (begin_shared(t, result)) {
+            result_pr = nullptr;
+            return;
+        }
         m_imp->operator()(t, result, result_pr);
+        end_shared(t, result);
     }
     catch (...) {
         result = t;
@@ -1030,6 +1084,7 @@ void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr)
 }
 
 expr_ref th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bindings) {
+    m_imp->set_shared_cache(nullptr, 0);
     return m_imp->operator()(n, num_bindings, bindings);
 }
 
@@ -1059,6 +1114,7 @@ expr_ref th_rewriter::mk_eq(expr* a, expr* b) {
 
 void th_rewriter::set_solver(expr_solver* solver) {
     m_imp->set_solver(solver);
+    m_has_solver = solver != nullptr;
 }
 
 
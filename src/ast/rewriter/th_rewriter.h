@@ -26,10 +26,20 @@ class expr_substitution;
 
 class expr_solver;
 
+class rewrite_cache;
+
 class th_rewriter {
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    rewrite_cache * m_shared_cache = nullptr;
+    unsigned   m_config_bits = 0;    // settings made through set_flat_and_or and set_order_eq
+    unsigned   m_fingerprint = 0;
+    bool       m_has_solver = false;
+
+    void update_fingerprint();
+    bool begin_shared(expr * t, expr_ref & result);
+    void end_shared(expr * t, expr_ref const & result);
 public:
     th_rewriter(ast_manager & m, params_ref const & p = params_ref());
     ~th_rewriter();
@@ -76,5 +86,14 @@ public:
 
     void set_solver(expr_solver* solver);
 
+    /**
+       \brief share rewriting results with other calls and other rewriters through c.
+       Results are keyed on a fingerprint of the parameters, so rewriters with different
+       configurations can use the same cache. The cache is not used while a substitution
+       or a solver is set, when proofs are enabled, or when rewriting with bindings.
+       c is owned by the caller.
+    */
+    void set_shared_cache(rewrite_cache * c) { m_shared_cache = c; }
+
 };
 
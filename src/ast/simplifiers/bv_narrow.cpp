@@ -0,0 +1,255 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    bv_narrow.cpp
+
+Abstract:
+
+    simplifier for narrowing bit-vector operations
+
+Author:
+
+    Nikolaj Bjorner (nbjorner) 2024-04-03.
+
+--*/
+
+#include "ast/ast_pp.h"
+#include "ast/simplifiers/bv_narrow.h"
+
+namespace bv {
+
+    static unsigned num_bits(rational const& r) {
+        return r.is_zero() ? 0 : r.get_num_bits();
+    }
+
+    void narrow::reduce() {
+        collect_bounds();
+        for (unsigned i : indices())
+            if (!m_is_bound[i])
+                narrow_fml(i);
+        m_bits.reset();
+        m_deps.reset();
+        m_cache.reset();
+        m_bounds.m_bound.reset();
+        m_bounds.m_scopes.reset();
+        m_bound_deps.reset();
+        m_pinned_deps.reset();
+    }
+
+    /**
+     * Collect unit bounds from all assertions, including the ones before qhead.
+     * The assertions that provide bounds are not narrowed.
+     */
+    void narrow::collect_bounds() {
+        m_is_bound.reset();
+        m_is_bound.resize(qtail(), false);
+        for (unsigned i = 0; i < qtail(); ++i) {
+            auto const [f, p, d] = m_fmls[i]();
+            expr* t = f, * v = nullptr;
+            while (m.is_not(t, t));
+            interval b;
+            if (!m_bounds.is_bound(t, v, b))
+                continue;
+            if (!m_bounds.assert_expr_core(f, false))
+                // conflicting bounds, the bounds collected so far remain valid.
+                break;
+            m_is_bound[i] = true;
+            if (d) {
+                auto& dep = m_bound_deps.insert_if_not_there(v, nullptr);
+                dep = m.mk_join(dep, d);
+                m_pinned_deps.push_back(dep);
+            }
+        }
+    }
+
+    unsigned narrow::bits(expr* e) const {
+        SASSERT(m_bv.is_bv(e));
+        unsigned r = m_bits.get(e->get_id(), UINT_MAX);
+        return r == UINT_MAX ? m_bv.get_bv_size(e) : r;
+    }
+
+    /**
+     * Compute an upper bound on the number of significant bits of e
+     * from the bounds of its arguments.
+     */
+    void narrow::set_bits(app* e) {
+        expr_dependency* d = nullptr;
+        if (!m_bound_deps.empty()) {
+            for (expr* arg : *e)
+                d = m.mk_join(d, dep(arg));
+        }
+
+        if (m_bv.is_bv(e)) {
+            unsigned sz = m_bv.get_bv_size(e);
+            unsigned r = sz, lo, hi;
+            rational v;
+            expr* x, * y;
+            if (m_bv.is_numeral(e, v))
+                r = num_bits(v);
+            else if (m_bv.is_concat(e)) {
+                unsigned offset = sz;
+                r = 0;
+                for (expr* arg : *e) {
+                    offset -= m_bv.get_bv_size(arg);
+                    if (bits(arg) > 0) {
+                        r = offset + bits(arg);
+                        break;
+                    }
+                }
+            }
+            else if (m_bv.is_extract(e, lo, hi, x))
+                r = bits(x) <= lo ? 0 : std::min(hi + 1, bits(x)) - lo;
+            else if (is_app_of(e, m_bv.get_fid(), OP_ZERO_EXT))
+                r = bits(e->get_arg(0));
+            else if (m_bv.is_bv_add(e)) {
+                // the sum of n numbers below 2^k is below 2^(k + log2(n))
+                r = 0;
+                for (expr* arg : *e)
+                    r = std::max(r, bits(arg));
+                if (r > 0)
+                    for (unsigned n = 1; n < e->get_num_args() && r < sz; n *= 2)
+                        ++r;
+            }
+            else if (m_bv.is_bv_mul(e)) {
+                r = 0;
+                for (expr* arg : *e) {
+                    if (bits(arg) == 0) {
+                        r = 0;
+                        break;
+                    }
+                    r = std::min(sz, r + bits(arg));
+                }
+            }
+            else if (m_bv.is_bv_and(e)) {
+                for (expr* arg : *e)
+                    r = std::min(r, bits(arg));
+            }
+            else if (m_bv.is_bv_or(e) || m_bv.is_bv_xor(e)) {
+                r = 0;
+                for (expr* arg : *e)
+                    r = std::max(r, bits(arg));
+            }
+            else if (m.is_ite(e))
+                r = std::max(bits(e->get_arg(1)), bits(e->get_arg(2)));
+            else if (m_bv.is_bv_urem(e) || m_bv.is_bv_uremi(e))
+                // x urem 0 = x, otherwise x urem y < x
+                r = bits(e->get_arg(0));
+            else if (m_bv.is_bv_lshr(e, x, y)) {
+                r = bits(x);
+                if (m_bv.is_numeral(y, v))
+                    r = v >= rational(r) ? 0 : r - v.get_unsigned();
+            }
+            else if (m_bv.is_bv_shl(e, x, y) && m_bv.is_numeral(y, v))
+                r = v >= rational(sz) ? 0 : (bits(x) == 0 ? 0 : std::min(sz, bits(x) + v.get_unsigned()));
+
+            interval b;
+            if (m_bounds.m_bound.find(e, b) && b.lo() <= b.hi() && num_bits(b.hi()) < r) {
+                r = num_bits(b.hi());
+                expr_dependency* bd = nullptr;
+                if (m_bound_deps.find(e, bd))
+                    d = m.mk_join(d, bd);
+            }
+            SASSERT(r <= sz);
+            m_bits.setx(e->get_id(), r, UINT_MAX);
+        }
+
+        if (d) {
+            m_pinned_deps.push_back(d);
+            m_deps.setx(e->get_id(), d, nullptr);
+        }
+    }
+
+    expr_ref narrow::mk_low(unsigned k, expr* e) {
+        SASSERT(0 < k && k <= m_bv.get_bv_size(e));
+        if (k == m_bv.get_bv_size(e))
+            return expr_ref(e, m);
+        app_ref ext(m_bv.mk_extract(k - 1, 0, e), m);
+        return m_rewriter.mk_app(ext->get_decl(), 1, &e);
+    }
+
+    /**
+     * Build the narrowed version of e given narrowed arguments.
+     * The low k bits of sums, products and bit-wise operations only depend
+     * on the low k bits of the arguments, and when the result has at most
+     * k significant bits the remaining bits are 0.
+     */
+    expr_ref narrow::narrow_app(app* e, expr_ref_vector const& args) {
+        expr* a, * b;
+        if (m_bv.is_bv(e) &&
+            (m_bv.is_bv_add(e) || m_bv.is_bv_mul(e) || m_bv.is_bv_and(e) ||
+             m_bv.is_bv_or(e) || m_bv.is_bv_xor(e) || m.is_ite(e))) {
+            unsigned sz = m_bv.get_bv_size(e);
+            unsigned k = bits(e);
+            if (k < sz) {
+                ++m_stats.m_num_narrowed;
+                if (k == 0)
+                    return expr_ref(m_bv.mk_zero(sz), m);
+                expr_ref_vector nargs(m);
+                for (expr* arg : args)
+                    nargs.push_back(m_bv.is_bv(arg) ? mk_low(k, arg) : expr_ref(arg, m));
+                app_ref low(m.mk_app(e->get_family_id(), e->get_decl_kind(), nargs.size(), nargs.data()), m);
+                expr_ref r = m_rewriter.mk_app(low->get_decl(), nargs);
+                return expr_ref(m_bv.mk_concat(m_bv.mk_zero(sz - k), r), m);
+            }
+        }
+        else if ((m.is_eq(e, a, b) && m_bv.is_bv(a)) || m_bv.is_bv_ule(e, a, b) || m_bv.is_bv_sle(e, a, b)) {
+            // both sides have the same sign bit 0, so signed and unsigned comparison agree.
+            unsigned sz = m_bv.get_bv_size(a);
+            unsigned k = std::max(bits(a), bits(b));
+            if (k < sz) {
+                ++m_stats.m_num_narrowed;
+                if (k == 0)
+                    return expr_ref(m.mk_true(), m);
+                expr_ref la = mk_low(k, args.get(0)), lb = mk_low(k, args.get(1));
+                app_ref low(m.is_eq(e) ? m.mk_eq(la, lb) : m_bv.mk_ule(la, lb), m);
+                return m_rewriter.mk_app(low->get_decl(), low->get_num_args(), low->get_args());
+            }
+        }
+
+        bool change = false;
+        for (unsigned i = 0; i < args.size(); ++i)
+            change |= args.get(i) != e->get_arg(i);
+        if (change)
+            return m_rewriter.mk_app(e->get_decl(), args);
+        return expr_ref(e, m);
+    }
+
+    void narrow::narrow_fml(unsigned i) {
+        auto const [f, p, d] = m_fmls[i]();
+        ptr_vector<expr> todo;
+        expr_ref_vector args(m);
+        todo.push_back(f);
+        while (!todo.empty()) {
+            expr* e = todo.back();
+            if (m_cache.get(e->get_id(), nullptr)) {
+                todo.pop_back();
+                continue;
+            }
+            if (!is_app(e)) {
+                m_cache.setx(e->get_id(), e);
+                todo.pop_back();
+                continue;
+            }
+            unsigned sz = todo.size();
+            for (expr* arg : *to_app(e))
+                if (!m_cache.get(arg->get_id(), nullptr))
+                    todo.push_back(arg);
+            if (sz != todo.size())
+                continue;
+            todo.pop_back();
+            args.reset();
+            for (expr* arg : *to_app(e))
+                args.push_back(m_cache.get(arg->get_id()));
+            set_bits(to_app(e));
+            m_cache.setx(e->get_id(), narrow_app(to_app(e), args));
+            SASSERT(e->get_sort() == m_cache.get(e->get_id())->get_sort());
+        }
+        expr* r = m_cache.get(f->get_id());
+        if (r != f) {
+            TRACE("bv", tout << mk_pp(f, m) << "\n-->\n" << mk_pp(r, m) << "\n");
+            m_fmls.update(i, dependent_expr(m, r, nullptr, m.mk_join(d, dep(f))));
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    bv_narrow.h
+
+Abstract:
+
+    simplifier for narrowing bit-vector operations.
+
+    Unit bounds (x <= C, x = C, ...) are collected from the
+    assertions using bv_bounds_base. An upper bound on the number
+    of significant bits of every bit-vector term is then computed
+    bottom-up from the bounds, numerals, extracts, concatenations
+    and arithmetic. Additions, multiplications, bit-wise operations
+    and if-then-else whose result has k < n significant bits are
+    computed on k bits and zero extended; equalities and comparisons
+    between terms with k < n significant bits compare the low k bits.
+
+    The assertions that provide the bounds are kept unchanged, so
+    the narrowed assertions are equivalent to the original ones.
+
+Author:
+
+    Nikolaj Bjorner (nbjorner) 2024-04-03.
+
+--*/
+
+
+#pragma once
+
+#include "ast/bv_decl_plugin.h"
+#include "ast/simplifiers/dependent_expr_state.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/bv_bounds_base.h"
+
+
+namespace bv {
+
+    class narrow : public dependent_expr_simplifier {
+
+        struct bounds : public bv_bounds_base {
+            bounds(ast_manager& m) : bv_bounds_base(m) {}
+        };
+
+        struct stats {
+            unsigned m_num_narrowed = 0;
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        bv_util                           m_bv;
+        th_rewriter                       m_rewriter;
+        bounds                            m_bounds;
+        obj_map<expr, expr_dependency*>   m_bound_deps;
+        expr_dependency_ref_vector        m_pinned_deps;
+        bool_vector                       m_is_bound;   // assertion index -> asserts a bound
+        unsigned_vector                   m_bits;       // expression id -> significant bits
+        ptr_vector<expr_dependency>       m_deps;       // expression id -> bounds used
+        expr_ref_vector                   m_cache;      // expression id -> narrowed expression
+        stats                             m_stats;
+
+        void collect_bounds();
+        unsigned bits(expr* e) const;
+        expr_dependency* dep(expr* e) const { return m_deps.get(e->get_id(), nullptr); }
+        void set_bits(app* e);
+        expr_ref mk_low(unsigned k, expr* e);
+        expr_ref narrow_app(app* e, expr_ref_vector const& args);
+        void narrow_fml(unsigned i);
+
+    public:
+
+        narrow(ast_manager& m, dependent_expr_state& fmls) :
+            dependent_expr_simplifier(m, fmls), m_bv(m), m_rewriter(m), m_bounds(m), m_pinned_deps(m), m_cache(m) {}
+        char const* name() const override { return "bv-narrow"; }
+        void reduce() override;
+        void collect_statistics(statistics& st) const override { st.update("bv-narrow", m_stats.m_num_narrowed); }
+        void reset_statistics() override { m_stats.reset(); }
+    };
+}
@@ -29,8 +29,11 @@ Abstract:
    - parents - list of parents where orig occurs.
 
   Subterms have reference counts
-  Elegible variables are inserted into a heap ordered by reference counts.
-  Variables that have reference count 1 are examined for invertibility.
+  Elegible variables with reference count 1 are kept on a worklist and examined for invertibility.
+
+  The node graph persists across calls to reduce. Nodes that were rewritten or invalidated
+  are collected at the start of the next call and nodes for the sub-terms of new assertions
+  are added. The graph is rebuilt from scratch after a pop or when proofs are enabled.
 
 Author:
 
@@ -91,11 +94,9 @@ live(t) =
 Only live nodes require updates.
 
 eliminate:
-  while heap is not empty:
-     v = heap.erase_min()
+  while worklist is not empty:
+     v = worklist.pop()
      n = node(v)
-     if n.parents.size() > 1 then
-        return
      if !is_root(n) or !live(n) or n.parents.size() != 1 then 
         continue
      p = n.parents[0]
@@ -119,7 +120,7 @@ eliminate:
 #include "ast/simplifiers/elim_unconstrained.h"
 
 elim_unconstrained::elim_unconstrained(ast_manager& m, dependent_expr_state& fmls) :
-    dependent_expr_simplifier(m, fmls), m_inverter(m), m_lt(*this), m_heap(1024, m_lt), m_trail(m), m_args(m) {
+    dependent_expr_simplifier(m, fmls), m_inverter(m), m_trail(m), m_args(m) {
     std::function<bool(expr*)> is_var = [&](expr* e) {
         return is_uninterp_const(e) && !m_fmls.frozen(e) && get_node(e).is_root() && get_node(e).num_parents() <= 1;
     };
@@ -130,22 +131,16 @@ elim_unconstrained::~elim_unconstrained() {
     reset_nodes();
 }
 
-bool elim_unconstrained::is_var_lt(int v1, int v2) const {   
-    return get_node(v1).num_parents() < get_node(v2).num_parents();
-}
-
 void elim_unconstrained::eliminate() {
-    while (!m_heap.empty()) {
+    while (!m_worklist.empty()) {
         expr_ref r(m);
-        int v = m_heap.erase_min();
+        unsigned v = m_worklist.back();
+        m_worklist.pop_back();
         node& n = get_node(v);
         if (!n.is_root() || n.is_top())
             continue;
-        unsigned num_parents = n.num_parents();
-        if (num_parents == 0)
+        if (n.num_parents() != 1)
             continue;
-        if (num_parents > 1)
-            return;
 
         node& p = n.parent();
         if (!is_child(n, p) || !p.is_root())
@@ -154,8 +149,6 @@ void elim_unconstrained::eliminate() {
         if (!e || !is_app(e) || !is_ground(e)) 
             continue;
 
-        SASSERT(!m_heap.contains(p.term()->get_id()));
-        
         app* t = to_app(e);
         TRACE("elim_unconstrained", tout << "eliminating " << mk_bounded_pp(t, m) << "\n";);
         unsigned sz = m_args.size();
@@ -184,9 +177,8 @@ void elim_unconstrained::eliminate() {
         node& rn = root(r);
         set_root(p, rn);
         expr* rt = rn.term();
-        SASSERT(!m_heap.contains(rt->get_id()));
         if (is_uninterp_const(rt))
-            m_heap.insert(rt->get_id());
+            m_worklist.push_back(rt->get_id());
         else
             m_created_compound = true;
     }
@@ -199,6 +191,8 @@ void elim_unconstrained::set_root(node& n, node& r) {
         return;
     r.add_parents(n.parents());    
     n.set_root(r);
+    touch(n);
+    touch(r);
     for (auto p : n.parents())
         invalidate_parents(*p);
 }
@@ -210,6 +204,7 @@ void elim_unconstrained::invalidate_parents(node& n) {
         node& n = *np;
         if (!n.is_dirty()) {
             n.set_dirty();
+            touch(n);
             for (auto* p : n.parents())
                 todo.push_back(p);            
         }
@@ -235,6 +230,8 @@ elim_unconstrained::node& elim_unconstrained::get_node(expr* t) {
     if (!n) {
         n = alloc(node, m, t);               
         m_nodes[id] = n;
+        if (is_uninterp_const(t) && !m_fmls.frozen(t))
+            m_vars.push_back(id);
         if (is_app(t)) {
             for (auto arg : *to_app(t)) {
                 node& ch = get_node(arg);
@@ -255,6 +252,72 @@ void elim_unconstrained::reset_nodes() {
     for (node* n : m_nodes)
         dealloc(n);
     m_nodes.reset();
+    m_vars.reset();
+    m_touched.reset();
+}
+
+/**
+ * remove the nodes that were rewritten or invalidated since the last call.
+ * The remaining nodes are clean roots and represent their own terms.
+ */
+void elim_unconstrained::collect_garbage() {
+    ptr_vector<node> dead;
+    for (node* n : m_touched) {
+        n->set_touched(false);
+        if (!n->is_root() || n->is_dirty()) {
+            n->set_dead();
+            dead.push_back(n);
+        }
+    }
+    for (node* n : m_touched)
+        if (!n->is_dead())
+            n->remove_dead_parents();
+    m_touched.reset();
+    auto remove_dead_parents = [&](expr* t) {
+        node* ch = m_nodes.get(t->get_id(), nullptr);
+        if (ch && !ch->is_dead())
+            ch->remove_dead_parents();
+    };
+    for (node* n : dead) {
+        expr* t = n->term();
+        if (is_app(t))
+            for (expr* arg : *to_app(t))
+                remove_dead_parents(arg);
+        else if (is_quantifier(t))
+            remove_dead_parents(to_quantifier(t)->get_expr());
+    }
+    for (node* n : dead) {
+        m_nodes[n->term()->get_id()] = nullptr;
+        dealloc(n);
+    }
+}
+
+/**
+ * add nodes for the sub-terms of t that are not yet in the graph.
+ */
+void elim_unconstrained::add_term(expr* t) {
+    ptr_buffer<expr> todo;
+    auto has_node = [&](expr* e) { return e->get_id() < m_nodes.size() && m_nodes[e->get_id()]; };
+    todo.push_back(t);
+    while (!todo.empty()) {
+        expr* e = todo.back();
+        if (has_node(e)) {
+            todo.pop_back();
+            continue;
+        }
+        unsigned sz = todo.size();
+        if (is_app(e)) {
+            for (expr* arg : *to_app(e))
+                if (!has_node(arg))
+                    todo.push_back(arg);
+        }
+        else if (is_quantifier(e) && !has_node(to_quantifier(e)->get_expr()))
+            todo.push_back(to_quantifier(e)->get_expr());
+        if (sz == todo.size()) {
+            get_node(e);
+            todo.pop_back();
+        }
+    }
 }
 
 /**
@@ -262,35 +325,41 @@ void elim_unconstrained::reset_nodes() {
  */
 void elim_unconstrained::init_nodes() {
 
-    m_enable_proofs = false;
     m_trail.reset();
     m_fmls.freeze_suffix();
 
+    bool enable_proofs = false;
     expr_ref_vector terms(m);
     for (unsigned i : indices()) {
         auto [f, p, d] = m_fmls[i]();
         terms.push_back(f);
         if (p)
-            m_enable_proofs = true;
+            enable_proofs = true;
     }
 
-    m_heap.reset();
-    reset_nodes();
-
-    // initialize nodes for terms in the original goal
-    unsigned max_id = 0;
-    for (expr* e : subterms::all(terms))
-        max_id = std::max(max_id, e->get_id());
+    if (m_reset || enable_proofs || m_enable_proofs)
+        reset_nodes();
+    else
+        collect_garbage();
+    m_reset = false;
+    m_enable_proofs = enable_proofs;
+    m_worklist.reset();
 
-    m_nodes.reserve(max_id + 1);
-    m_heap.reserve(max_id + 1);
+    // add nodes for terms in the new formulas
+    for (expr* e : terms)
+        add_term(e);
 
-    for (expr* e : subterms_postorder::all(terms)) {
-        node& n = get_node(e);
-        SASSERT(n.is_root());
-        if (is_uninterp_const(e))
-            m_heap.insert(e->get_id());
+    // variables that became frozen stay frozen until the next pop, which resets the graph.
+    unsigned j = 0;
+    for (unsigned v : m_vars) {
+        node& n = get_node(v);
+        if (m_fmls.frozen(n.term()))
+            continue;
+        m_vars[j++] = v;
+        if (n.num_parents() == 1)
+            m_worklist.push_back(v);
     }
+    m_vars.shrink(j);
 
     // mark top level terms
     for (expr* e : terms)
@@ -351,18 +420,13 @@ expr* elim_unconstrained::reconstruct_term(node& n) {
 }
 
 /**
- * walk nodes starting from lowest depth and reconstruct their normalized forms.
+ * reconstruct the normalized forms of the formulas.
+ * Only dirty nodes below the formulas are revisited, the remaining
+ * dirty nodes are collected at the next call.
  */
 void elim_unconstrained::reconstruct_terms() {
-    ptr_vector<node> nodes;
-    for (node* n : m_nodes)
-        if (n && n->is_root())
-            nodes.push_back(n);
-
-    std::stable_sort(nodes.begin(), nodes.end(), [&](node* a, node* b) { return get_depth(a->term()) < get_depth(b->term()); });
-
-    for (node* n : nodes) 
-        reconstruct_term(*n);    
+    for (unsigned i = qhead(); i < qtail(); ++i)
+        reconstruct_term(root(m_fmls[i].fml()));
 }
 
 
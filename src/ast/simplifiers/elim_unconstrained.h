@@ -14,7 +14,6 @@ Author:
 
 #pragma once
 
-#include "util/heap.h"
 #include "ast/simplifiers/dependent_expr_state.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "ast/converters/expr_inverter.h"
@@ -31,6 +30,8 @@ class elim_unconstrained : public dependent_expr_simplifier {
         ptr_vector<node> m_parents;
         node*            m_root = nullptr;
         bool             m_top = false;
+        bool             m_touched = false;
+        bool             m_dead = false;
     public:
 
         node(ast_manager& m, expr* t) :
@@ -42,6 +43,12 @@ class elim_unconstrained : public dependent_expr_simplifier {
         void set_top() { m_top = true; }
         bool is_top() const { return m_top; }
 
+        void set_touched(bool t) { m_touched = t; }
+        bool is_touched() const { return m_touched; }
+
+        void set_dead() { m_dead = true; }
+        bool is_dead() const { return m_dead; }
+
         void set_dirty() { m_dirty = true; }
         void set_clean() { m_dirty = false; }
         bool is_dirty() const { return m_dirty; }
@@ -50,6 +57,13 @@ class elim_unconstrained : public dependent_expr_simplifier {
         ptr_vector<node> const& parents() const { return m_parents; }
         void add_parent(node& p) { m_parents.push_back(&p); }
         void add_parents(ptr_vector<node> const& ps) { m_parents.append(ps); }
+        void remove_dead_parents() {
+            unsigned j = 0;
+            for (node* p : m_parents)
+                if (!p->is_dead())
+                    m_parents[j++] = p;
+            m_parents.shrink(j);
+        }
         node& parent() const { SASSERT(num_parents() == 1); return *m_parents[0]; }
 
         bool is_root() const { return m_root == this; }
@@ -67,34 +81,30 @@ class elim_unconstrained : public dependent_expr_simplifier {
         expr* term() const { return m_term; }
     };
 
-    struct var_lt {
-        elim_unconstrained& s;
-        var_lt(elim_unconstrained& s) : s(s) {}
-        bool operator()(int v1, int v2) const {
-            return s.is_var_lt(v1, v2);
-        }
-    };
-
     struct stats {
         unsigned m_num_eliminated = 0;
         void reset() { m_num_eliminated = 0; }
     };
     expr_inverter            m_inverter;
     ptr_vector<node>         m_nodes;
-    var_lt                   m_lt;
-    heap<var_lt>             m_heap;
+    unsigned_vector          m_vars;        // uninterpreted constants with nodes that are not frozen
+    unsigned_vector          m_worklist;    // candidate variables with a single parent
+    ptr_vector<node>         m_touched;     // nodes updated since the last garbage collection
     expr_ref_vector          m_trail;
     expr_ref_vector          m_args;
     stats                    m_stats;
     bool                     m_created_compound = false;
     bool                     m_enable_proofs = false;
+    bool                     m_reset = true;
 
-    bool is_var_lt(int v1, int v2) const;
     node& get_node(unsigned n) const { return *m_nodes[n]; }
     node& get_node(expr* t);
     node& root(expr* t) { return get_node(t).root(); }
     void set_root(node& n, node& r);
     void invalidate_parents(node& n);
+    void touch(node& n) { if (!n.is_touched()) { n.set_touched(true); m_touched.push_back(&n); } }
+    void add_term(expr* t);
+    void collect_garbage();
     bool is_child(node const& ch, node const& p);
 
     void init_nodes();
@@ -116,6 +126,8 @@ public:
 
     void reduce() override;
 
+    void pop(unsigned n) override { m_reset = true; }
+
     void collect_statistics(statistics& st) const override { st.update("elim-unconstrained", m_stats.m_num_eliminated); }
 
     void reset_statistics() override { m_stats.reset(); }
@@ -36,6 +36,14 @@ Algorithm for extracting canonical form from an E-graph:
 * We claim the new formula is equivalent.
 * The dependencies for each rewrite can be computed by following the equality justification data-structure.
 
+Incrementality:
+
+* The E-graph and the canonical forms persist across invocations.
+* A merge invalidates the canonical form of the merged class and of the classes of its parents,
+  transitively. Only invalid canonical forms are recomputed.
+* Rounds after the first canonize only assertions that contain a node whose canonical form
+  was recomputed in the round.
+
 
 --*/
 
@@ -58,20 +66,51 @@ namespace euf {
         m_ff = m_egraph.mk(m.mk_false(), 0, 0, nullptr);
         m_rewriter.set_order_eq(true);
         m_rewriter.set_flat_and_or(false);
+        std::function<void(enode*, enode*)> _on_merge = [&](enode* root, enode* other) {
+            m_merged.push_back(root);
+        };
+        m_egraph.set_on_merge(_on_merge);
     }
 
     void completion::reduce() {
         m_has_new_eq = true;
         for (unsigned rounds = 0; m_has_new_eq && rounds <= 3 && !m_fmls.inconsistent(); ++rounds) {
-            ++m_epoch;
+            ++m_round;
             m_has_new_eq = false;
             add_egraph();
+            invalidate_merged();
             map_canonical();
-            read_egraph();
+            read_egraph(rounds == 0);
             IF_VERBOSE(11, verbose_stream() << "(euf.completion :rounds " << rounds << ")\n");
         }
     }
 
+    /**
+    * The canonical form of a class depends on its members and on the
+    * canonical forms of the arguments of its representative.
+    */
+    void completion::invalidate_merged() {
+        enode_vector todo, marked;
+        for (enode* n : m_merged)
+            todo.push_back(n->get_root());
+        m_merged.reset();
+        while (!todo.empty()) {
+            enode* r = todo.back();
+            todo.pop_back();
+            if (r->is_marked2())
+                continue;
+            r->mark2();
+            marked.push_back(r);
+            if (r->get_id() < m_epochs.size())
+                m_epochs[r->get_id()] = 0;
+            for (enode* p : enode_parents(r))
+                if (!p->get_root()->is_marked2())
+                    todo.push_back(p->get_root());
+        }
+        for (enode* r : marked)
+            r->unmark2();
+    }
+
     void completion::add_egraph() {
         m_nodes_to_canonize.reset();
         unsigned sz = qtail();
@@ -104,7 +143,31 @@ namespace euf {
         m_egraph.propagate();
     }
 
-    void completion::read_egraph() {
+    /**
+    * Check if the canonical form of f, its arguments or their arguments
+    * was recomputed in the current round.
+    */
+    bool completion::is_affected(expr* f) {
+        auto is_new = [&](expr* e) {
+            enode* n = m_egraph.find(e);
+            return !n || m_rounds.get(n->get_root()->get_id(), 0) == m_round;
+        };
+        if (is_new(f))
+            return true;
+        if (!is_app(f))
+            return false;
+        for (expr* arg : *to_app(f)) {
+            if (is_new(arg))
+                return true;
+            if (is_app(arg))
+                for (expr* arg2 : *to_app(arg))
+                    if (is_new(arg2))
+                        return true;
+        }
+        return false;
+    }
+
+    void completion::read_egraph(bool all) {
 
         if (m_egraph.inconsistent()) {
             auto* d = explain_conflict();
@@ -116,6 +179,8 @@ namespace euf {
         unsigned sz = qtail();
         for (unsigned i = qhead(); i < sz; ++i) {
             auto [f, p, d] = m_fmls[i]();
+            if (!all && !is_affected(f))
+                continue;
             
             expr_dependency_ref dep(d, m);
             expr_ref g = canonize_fml(f, dep);
@@ -311,6 +376,7 @@ namespace euf {
             m_trail.push(vtrail(m_canonical, n->get_id()));
         m_canonical.setx(n->get_id(), e);
         m_epochs.setx(n->get_id(), m_epoch, 0);
+        m_rounds.setx(n->get_id(), m_round, 0);
     }
 
     expr_dependency* completion::explain_eq(enode* a, enode* b) {
@@ -348,7 +414,7 @@ namespace euf {
             return;
         for (unsigned i = 0; i < m_nodes_to_canonize.size(); ++i) {
             enode* n = m_nodes_to_canonize[i]->get_root();
-            if (n->is_marked1())
+            if (n->is_marked1() || get_canonical(n))
                 continue;
             n->mark1();
             roots.push_back(n);
@@ -361,9 +427,9 @@ namespace euf {
             TRACE("euf_completion", tout << "rep " << m_egraph.bpp(n) << " -> " << m_egraph.bpp(rep) << "\n";
                          for (enode* k : enode_class(n)) tout << m_egraph.bpp(k) << "\n";);
             m_todo.push_back(n->get_expr());
-            for (enode* arg : enode_args(n)) {
+            for (enode* arg : enode_args(rep)) {
                 arg = arg->get_root();
-                if (!arg->is_marked1())
+                if (!arg->is_marked1() && !get_canonical(arg))
                     m_nodes_to_canonize.push_back(arg);
             }
         }
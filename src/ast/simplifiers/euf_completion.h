@@ -36,8 +36,11 @@ namespace euf {
         enode_vector           m_args, m_reps, m_nodes_to_canonize;
         expr_ref_vector        m_canonical, m_eargs;
         expr_dependency_ref_vector m_deps;
-        unsigned               m_epoch = 0;
+        unsigned               m_epoch = 1;        // canonical forms of nodes with a different epoch are invalid
         unsigned_vector        m_epochs;
+        unsigned               m_round = 0;
+        unsigned_vector        m_rounds;           // node id -> round where the canonical form was last set
+        enode_vector           m_merged;           // roots of merges since the last canonization
         th_rewriter            m_rewriter;
         stats                  m_stats;
         bool                   m_has_new_eq = false;
@@ -47,8 +50,10 @@ namespace euf {
         void update_has_new_eq(expr* g);
         expr_ref mk_and(expr* a, expr* b);
         void add_egraph();
+        void invalidate_merged();
         void map_canonical();
-        void read_egraph();
+        void read_egraph(bool all);
+        bool is_affected(expr* f);
         expr_ref canonize(expr* f, expr_dependency_ref& dep);
         expr_ref canonize_fml(expr* f, expr_dependency_ref& dep);
         expr* get_canonical(expr* f, expr_dependency_ref& d);
@@ -60,7 +65,7 @@ namespace euf {
         completion(ast_manager& m, dependent_expr_state& fmls);
         char const* name() const override { return "euf-reduce"; }
         void push() override { m_egraph.push(); dependent_expr_simplifier::push(); }
-        void pop(unsigned n) override { dependent_expr_simplifier::pop(n); m_egraph.pop(n); }
+        void pop(unsigned n) override { dependent_expr_simplifier::pop(n); m_egraph.pop(n); m_merged.reset(); ++m_epoch; }
         void reduce() override;
         void collect_statistics(statistics& st) const override;
         void reset_statistics() override { m_stats.reset(); }
@@ -12,6 +12,8 @@ Author:
 --*/
 
 
+#include <algorithm>
+#include <functional>
 #include "ast/for_each_expr.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/rewriter/macro_replacer.h"
@@ -25,7 +27,10 @@ void model_reconstruction_trail::add_vars(expr* e, ast_mark& free_vars) {
         if (is_app(t) && is_uninterp(t)) {            
             func_decl* f = to_app(t)->get_decl();
             TRACE("simplifier", tout << "add var " << f->get_name() << "\n");
+            if (free_vars.is_marked(f))
+                continue;
             free_vars.mark(f, true);
+            m_new_vars.push_back(f);
             if (m_model_vars.is_marked(f))
                 m_intersects_with_model = true;
         }
@@ -36,6 +41,75 @@ void model_reconstruction_trail::add_vars(expr* e, ast_mark& free_vars) {
 // accumulate a set of dependent exprs, updating m_trail to exclude loose 
 // substitutions that use variables from the dependent expressions.
 
+/**
+* queue the trail entries at or after pos that mention a declaration
+* marked since the last call. todo is kept as a min-heap of entry indices.
+*/
+void model_reconstruction_trail::enqueue_entries(unsigned pos, bool_vector& queued, unsigned_vector& todo) {
+    for (func_decl* f : m_new_vars) {
+        auto* e = m_decl2entries.find_core(f);
+        if (!e)
+            continue;
+        for (unsigned idx : e->get_data().m_value) {
+            if (idx >= pos && !queued[idx]) {
+                queued[idx] = true;
+                todo.push_back(idx);
+                std::push_heap(todo.begin(), todo.end(), std::greater<unsigned>());
+            }
+        }
+    }
+    m_new_vars.reset();
+}
+
+void model_reconstruction_trail::deactivate(unsigned idx) {
+    m_trail[idx]->m_active = false;
+    m_deactivated.push_back(idx);
+}
+
+/**
+* release the entries that replay deactivated.
+* This is only done at the base level: the entries stay in the trail, so
+* indices and the trail stack remain valid, but their definitions and
+* removed formulas are freed and they are dropped from m_decl2entries.
+*/
+void model_reconstruction_trail::compact() {
+    if (m_deactivated.empty() || m_trail_stack.get_num_scopes() > 0)
+        return;
+    for (unsigned idx : m_deactivated) {
+        if (idx >= m_trail.size())
+            continue;
+        entry* t = m_trail[idx];
+        if (t->m_active)
+            continue;
+        bool released = true;
+        for_each_decl(*t, [&](func_decl* f) {
+            m_decl2entries.find_core(f)->get_data().m_value.erase(idx);
+            released = false;
+        });
+        if (released)
+            continue;
+        t->m_subst = nullptr;
+        t->m_defs.reset();
+        t->m_removed.reset();
+        ++m_num_compacted;
+    }
+    m_deactivated.reset();
+}
+
+void model_reconstruction_trail::collect_statistics(statistics& st) const {
+    unsigned num_active = 0, num_removed = 0;
+    for (auto* t : m_trail) {
+        if (!t->m_active)
+            continue;
+        ++num_active;
+        num_removed += t->m_removed.size();
+    }
+    st.update("model trail entries", m_trail.size());
+    st.update("model trail active entries", num_active);
+    st.update("model trail removed formulas", num_removed);
+    st.update("model trail compacted entries", m_num_compacted);
+}
+
 void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumptions, dependent_expr_state& st) {
 
     if (m_trail.empty())
@@ -45,6 +119,7 @@ void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumpt
 
     ast_mark free_vars;
     m_intersects_with_model = false;
+    m_new_vars.reset();
     scoped_ptr<expr_replacer> rp = mk_default_expr_replacer(m, false);
     for (unsigned i = qhead; i < st.qtail(); ++i)        
         add_vars(st[i], free_vars);
@@ -60,7 +135,20 @@ void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumpt
     if (!m_intersects_with_model)
         return;
 
-    for (auto& t : m_trail) {
+    // visit, in trail order, only the entries that mention a free variable.
+    // Entries become candidates as the replay adds variables to free_vars.
+    bool_vector queued(m_trail.size(), false);
+    unsigned_vector todo;
+    unsigned pos = 0;
+    while (true) {
+        enqueue_entries(pos, queued, todo);
+        if (todo.empty())
+            break;
+        std::pop_heap(todo.begin(), todo.end(), std::greater<unsigned>());
+        unsigned idx = todo.back();
+        todo.pop_back();
+        pos = idx + 1;
+        entry* t = m_trail[idx];
         TRACE("simplifier", tout << " active " << t->m_active << " hide " << t->is_hide() << " intersects " << t->intersects(free_vars) << " loose " << t->is_loose() << "\n");
         if (!t->m_active)
             continue;
@@ -80,7 +168,7 @@ void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumpt
                 add_vars(v, free_vars);
                 st.add(dependent_expr(m, m.mk_eq(k, v), nullptr, nullptr));
             }
-            t->m_active = false;
+            deactivate(idx);
             continue;
         }
 
@@ -95,7 +183,7 @@ void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumpt
                 st.add(r);
             }
             m_trail_stack.push(value_trail(t->m_active));
-            t->m_active = false;      
+            deactivate(idx);
             continue;
         }        
         
@@ -178,6 +266,7 @@ void model_reconstruction_trail::replay(unsigned qhead, expr_ref_vector& assumpt
         }        
     }
 
+    compact();
     TRACE("simplifier", st.display(tout));
 }
 
@@ -24,6 +24,7 @@ Author:
 #pragma once
 
 #include "util/scoped_ptr_vector.h"
+#include "util/statistics.h"
 #include "util/trail.h"
 #include "ast/for_each_expr.h"
 #include "ast/rewriter/expr_replacer.h"
@@ -86,6 +87,47 @@ class model_reconstruction_trail {
     func_decl_ref_vector     m_model_vars_trail;
     ast_mark                 m_model_vars;
     bool                     m_intersects_with_model = false;
+    obj_map<func_decl, unsigned_vector> m_decl2entries; // trail entries that define or substitute a declaration
+    ptr_vector<func_decl>    m_new_vars;                // declarations marked since the last call to enqueue_entries
+    unsigned_vector          m_deactivated;             // entries deactivated by replay, candidates for compaction
+    unsigned                 m_num_compacted = 0;
+
+    template<typename F>
+    static void for_each_decl(entry const& t, F const& f) {
+        for (auto const& [d, def, dep] : t.m_defs)
+            f(d.get());
+        if (t.m_subst)
+            for (auto const& [k, v] : t.m_subst->sub())
+                f(to_app(k)->get_decl());
+    }
+
+    struct undo_index : public trail {
+        model_reconstruction_trail& s;
+        undo_index(model_reconstruction_trail& s) : s(s) {}
+        void undo() override {
+            unsigned idx = s.m_trail.size() - 1;
+            for_each_decl(*s.m_trail.back(), [&](func_decl* f) {
+                auto& entries = s.m_decl2entries.find_core(f)->get_data().m_value;
+                while (!entries.empty() && entries.back() >= idx)
+                    entries.pop_back();
+            });
+        }
+    };
+
+    /**
+    * register the last trail entry in m_decl2entries, so that replay
+    * only visits entries whose declarations occur in the new assertions.
+    */
+    void index_last_entry() {
+        unsigned idx = m_trail.size() - 1;
+        for_each_decl(*m_trail.back(), [&](func_decl* f) { m_decl2entries.insert_if_not_there(f, unsigned_vector()).push_back(idx); });
+        m_trail_stack.push(undo_index(*this));
+    }
+
+    void enqueue_entries(unsigned pos, bool_vector& queued, unsigned_vector& todo);
+
+    void deactivate(unsigned idx);
+    void compact();
 
     struct undo_model_var : public trail {
         model_reconstruction_trail& s;
@@ -144,6 +186,7 @@ public:
     void push(expr_substitution* s, vector<dependent_expr> const& removed) {
         m_trail.push_back(alloc(entry, m, s, removed));
         m_trail_stack.push(push_back_vector(m_trail));     
+        index_last_entry();
         for (auto& [k, v] : s->sub())
             add_model_var(to_app(k)->get_decl());
     }
@@ -162,6 +205,7 @@ public:
     void push(func_decl* f, expr* def, expr_dependency* dep, vector<dependent_expr> const& removed) {
         m_trail.push_back(alloc(entry, m, f, def, dep, removed));
         m_trail_stack.push(push_back_vector(m_trail));
+        index_last_entry();
         add_model_var(f);
     }
 
@@ -171,6 +215,7 @@ public:
     void push(vector<std::tuple<func_decl_ref, expr_ref, expr_dependency_ref>> const& defs, vector<dependent_expr> const& removed) {
         m_trail.push_back(alloc(entry, m, defs, removed));
         m_trail_stack.push(push_back_vector(m_trail));
+        index_last_entry();
         for (auto const& [f, def, dep] : defs)
             add_model_var(f);
     }
@@ -187,6 +232,8 @@ public:
      */
     model_converter_ref get_model_converter();
 
+    void collect_statistics(statistics& st) const;
+
     std::ostream& display(std::ostream& out) const;
 };
 
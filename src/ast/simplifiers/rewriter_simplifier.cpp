@@ -0,0 +1,120 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    rewriter_simplifier.cpp
+
+Abstract:
+
+    rewriter simplifier
+
+    Without proofs, the assertions can be rewritten in parallel.
+    They are partitioned into contiguous ranges, each range is copied into
+    a manager owned by a worker thread, rewritten there, and the results are
+    copied back in the order of the assertions, so the outcome does not depend
+    on the scheduling of the workers.
+
+--*/
+
+#include "ast/simplifiers/rewriter_simplifier.h"
+#include "ast/ast_translation.h"
+#include "params/rewriter_params.hpp"
+#include "util/scoped_ptr_vector.h"
+#include <thread>
+
+// minimal number of assertions per worker for parallel rewriting.
+static const unsigned min_assertions_per_thread = 64;
+
+void rewriter_simplifier::updt_params(params_ref const& p) {
+    m_params.append(p);
+    m_rewriter.updt_params(m_params);
+    m_threads = std::max(1u, rewriter_params(m_params).simplify_threads());
+}
+
+void rewriter_simplifier::reduce() {
+    m_num_steps = 0;
+    if (m_threads > 1 && !m.proofs_enabled()) {
+        unsigned_vector idxs;
+        for (unsigned idx : indices())
+            idxs.push_back(idx);
+        if (idxs.size() >= 2 * min_assertions_per_thread) {
+            reduce_parallel(idxs);
+            return;
+        }
+    }
+    expr_ref   new_curr(m);
+    proof_ref  new_pr(m);
+    for (unsigned idx : indices()) {
+        auto d = m_fmls[idx];
+        m_rewriter(d.fml(), new_curr, new_pr);
+        m_num_steps += m_rewriter.get_num_steps();
+        m_fmls.update(idx, dependent_expr(m, new_curr, mp(d.pr(), new_pr), d.dep()));            
+    }
+}
+
+void rewriter_simplifier::reduce_parallel(unsigned_vector const& idxs) {
+    unsigned num_threads = std::min(m_threads, idxs.size() / min_assertions_per_thread);
+    unsigned chunk = (idxs.size() + num_threads - 1) / num_threads;
+    scoped_ptr_vector<ast_manager> pms;
+    scoped_ptr_vector<expr_ref_vector> pfmls;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        pms.push_back(alloc(ast_manager, m, true));
+        pfmls.push_back(alloc(expr_ref_vector, *pms[i]));
+        ast_translation tr(m, *pms[i], false);
+        for (unsigned j = i * chunk; j < std::min(idxs.size(), (i + 1) * chunk); ++j)
+            pfmls[i]->push_back(tr(m_fmls[idxs[j]].fml()));
+    }
+
+    scoped_limits sl(m.limit());
+    for (ast_manager* pm : pms)
+        sl.push_child(&(pm->limit()));
+    unsigned_vector num_steps(num_threads, 0u);
+    vector<std::string> errors(num_threads);
+    auto worker = [&](unsigned i) {
+        try {
+            // private copy of the parameters, copies of params_ref share their
+            // entries through a reference count that is not thread safe.
+            params_ref p;
+            p.set_uint("simplify_threads", 1);
+            p.copy(m_params);
+            th_rewriter rw(*pms[i], p);
+            expr_ref r(*pms[i]);
+            expr_ref_vector& fmls = *pfmls[i];
+            for (unsigned j = 0; j < fmls.size(); ++j) {
+                rw(fmls.get(j), r);
+                num_steps[i] += rw.get_num_steps();
+                fmls[j] = r;
+            }
+        }
+        catch (z3_exception& ex) {
+            errors[i] = ex.what();
+        }
+    };
+    vector<std::thread> threads(num_threads);
+    for (unsigned i = 0; i < num_threads; ++i)
+        threads[i] = std::thread([&, i]() { worker(i); });
+    for (auto& th : threads)
+        th.join();
+
+    for (unsigned i = 0; i < num_threads; ++i)
+        if (!errors[i].empty())
+            throw default_exception(std::move(errors[i]));
+    if (!m.inc())
+        return;
+
+    for (unsigned i = 0; i < num_threads; ++i) {
+        m_num_steps += num_steps[i];
+        m.update_fresh_id(*pms[i]);
+        ast_translation tr(*pms[i], m, false);
+        expr_ref_vector const& fmls = *pfmls[i];
+        for (unsigned j = 0; j < fmls.size(); ++j) {
+            unsigned idx = idxs[i * chunk + j];
+            auto d = m_fmls[idx];
+            expr_ref new_curr(tr(fmls.get(j)), m);
+            if (new_curr != d.fml())
+                m_fmls.update(idx, dependent_expr(m, new_curr, nullptr, d.dep()));
+        }
+    }
+    IF_VERBOSE(3, verbose_stream() << "(simplifier :threads " << num_threads << " :assertions " << idxs.size() << ")\n");
+}
@@ -24,9 +24,12 @@ Author:
 class rewriter_simplifier : public dependent_expr_simplifier {
 
     unsigned               m_num_steps = 0;
+    unsigned               m_threads = 1;
     params_ref             m_params;
     th_rewriter            m_rewriter;
 
+    void reduce_parallel(unsigned_vector const& idxs);
+
 public:
     rewriter_simplifier(ast_manager& m, params_ref const& p, dependent_expr_state& fmls):
         dependent_expr_simplifier(m, fmls),
@@ -36,21 +39,11 @@ public:
 
     char const* name() const override { return "simplifier"; }
         
-    void reduce() override {
-        m_num_steps = 0;
-        expr_ref   new_curr(m);
-        proof_ref  new_pr(m);
-        for (unsigned idx : indices()) {
-            auto d = m_fmls[idx];
-            m_rewriter(d.fml(), new_curr, new_pr);
-            m_num_steps += m_rewriter.get_num_steps();
-            m_fmls.update(idx, dependent_expr(m, new_curr, mp(d.pr(), new_pr), d.dep()));            
-        }
-    }
+    void reduce() override;
     bool supports_proofs() const override { return true; }
     void collect_statistics(statistics& st) const override { st.update("simplifier-steps", m_num_steps); }
     void reset_statistics() override { m_num_steps = 0; }
-    void updt_params(params_ref const& p) override { m_params.append(p); m_rewriter.updt_params(m_params); }
+    void updt_params(params_ref const& p) override;
     void collect_param_descrs(param_descrs& r) override { th_rewriter::get_param_descrs(r); }
 };
 
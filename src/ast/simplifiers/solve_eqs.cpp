@@ -78,6 +78,44 @@ namespace euf {
                 m_next[var2id(eq.var)].push_back(eq);
     }
 
+    /**
+    * Mark the sub-terms of t that contain a variable.
+    * The marks are shared between the equations considered by extract_subst,
+    * so each sub-term is visited once.
+    */
+    void solve_eqs::mark_var_occs(expr* t) {
+        if (m_var_occs_done.is_marked(t))
+            return;
+        SASSERT(m_todo.empty());
+        m_todo.push_back(t);
+        while (!m_todo.empty()) {
+            expr* e = m_todo.back();
+            if (m_var_occs_done.is_marked(e)) {
+                m_todo.pop_back();
+                continue;
+            }
+            unsigned sz = m_todo.size();
+            if (is_app(e)) {
+                for (expr* arg : *to_app(e))
+                    if (!m_var_occs_done.is_marked(arg))
+                        m_todo.push_back(arg);
+            }
+            else if (is_quantifier(e) && !m_var_occs_done.is_marked(to_quantifier(e)->get_expr()))
+                m_todo.push_back(to_quantifier(e)->get_expr());
+            if (sz < m_todo.size())
+                continue;
+            m_todo.pop_back();
+            bool has_var = is_var(e);
+            if (is_app(e))
+                has_var |= any_of(*to_app(e), [&](expr* arg) { return m_has_var_occ.is_marked(arg); });
+            else if (is_quantifier(e))
+                has_var = m_has_var_occ.is_marked(to_quantifier(e)->get_expr());
+            m_var_occs_done.mark(e, true);
+            if (has_var)
+                m_has_var_occ.mark(e, true);
+        }
+    }
+
     /**
     * Build a substitution while assigning levels to terms.
     * The substitution is well-formed when variables are replaced with terms whose
@@ -88,6 +126,8 @@ namespace euf {
         m_id2level.resize(m_id2var.size(), UINT_MAX);
         m_subst_ids.reset();
         m_subst = alloc(expr_substitution, m, true, false);        
+        m_var_occs_done.reset();
+        m_has_var_occ.reset();
 
         auto is_explored = [&](unsigned id) {
             return m_id2level[id] != UINT_MAX;
@@ -125,13 +165,15 @@ namespace euf {
                     // determine if substitution is safe.
                     // all time-stamps must be at or above current level
                     // unexplored variables that are part of substitution are appended to work list.
+                    // sub-terms without variables are skipped.
+                    mark_var_occs(t);
                     SASSERT(m_todo.empty());
                     m_todo.push_back(t);
                     expr_fast_mark1 visited;
                     while (!m_todo.empty()) {
                         expr* e = m_todo.back();
                         m_todo.pop_back();
-                        if (visited.is_marked(e))
+                        if (visited.is_marked(e) || !m_has_var_occ.is_marked(e))
                             continue;
                         visited.mark(e, true);
                         if (is_app(e)) {
@@ -57,6 +57,8 @@ namespace euf {
         ptr_vector<expr>              m_todo;
         expr_mark                     m_visited;
         obj_map<expr, unsigned>       m_num_occs;
+        expr_mark                     m_var_occs_done;  // sub-terms for which m_has_var_occ is computed
+        expr_mark                     m_has_var_occ;    // sub-terms that contain a variable
 
 
         bool is_var(expr* e) const { return e->get_id() < m_var2id.size() && m_var2id[e->get_id()] != UINT_MAX; }
@@ -65,6 +67,7 @@ namespace euf {
         void get_eqs(dep_eq_vector& eqs);
         void filter_unsafe_vars();        
         void extract_subst();
+        void mark_var_occs(expr* t);
         void extract_dep_graph(dep_eq_vector& eqs);
         void normalize();
         void apply_subst(vector<dependent_expr>& old_fmls);
@@ -18,6 +18,7 @@ Author:
 #pragma once
 
 #include "util/stopwatch.h"
+#include "util/profile.h"
 #include "ast/simplifiers/dependent_expr_state.h"
 
 
@@ -78,6 +79,7 @@ public:
             collect_stats _cs(*s);
             m_fmls.reset_updated();
             try {
+                profile::scope _ps(s->name());
                 s->reduce();
                 m_fmls.flatten_suffix();
             }
@@ -383,8 +383,7 @@ namespace sls {
             unsigned bw = 0;
             for (unsigned i = e->get_num_args(); i-- > 0;) {
                 auto const& a = wval(e->get_arg(i));
-                for (unsigned j = 0; j < a.bw; ++j)
-                    val.eval.set(j + bw, a.get_bit(j));
+                val.eval.copy_bits(bw, a.bits(), 0, a.bw);
                 bw += a.bw;
             }
             break;
@@ -395,8 +394,7 @@ namespace sls {
             VERIFY(bv.is_extract(e, lo, hi, child));
             auto const& a = wval(child);
             SASSERT(lo <= hi && hi + 1 <= a.bw && hi - lo + 1 == val.bw);
-            for (unsigned i = lo; i <= hi; ++i)
-                val.eval.set(i - lo, a.get_bit(i));            
+            val.eval.copy_bits(0, a.bits(), lo, hi - lo + 1);
             break;
         }
         case OP_BNOT: {
@@ -419,29 +417,13 @@ namespace sls {
         case OP_BSHL: {
             auto& a = wval(e->get_arg(0));
             auto& b = wval(e->get_arg(1));
-            auto sh = b.to_nat(b.bw);
-            if (sh == 0)
-                val.set(a.bits());
-            else if (sh >= b.bw)
-                val.set_zero();
-            else {
-                for (unsigned i = 0; i < a.bw; ++i)
-                    val.eval.set(i, i >= sh && a.get_bit(i - sh));
-            }
+            val.eval.set_shift_left(a.bits(), b.to_nat(b.bw));
             break;
         }
         case OP_BLSHR: {
             auto& a = wval(e->get_arg(0));
             auto& b = wval(e->get_arg(1));
-            auto sh = b.to_nat(b.bw);
-            if (sh == 0)
-                val.set(a.bits());
-            else if (sh >= b.bw)
-                val.set_zero();
-            else {
-                for (unsigned i = 0; i < a.bw; ++i)
-                    val.eval.set(i, i + sh < a.bw && a.get_bit(i + sh));
-            }
+            val.eval.set_shift_right(a.bits(), b.to_nat(b.bw));
             break;
         }
         case OP_BASHR: {
@@ -457,12 +439,9 @@ namespace sls {
                 val.set(m_tmp);
             }
             else {
-                a.set_zero(m_tmp);
-                for (unsigned i = 0; i < a.bw; ++i)                    
-                    m_tmp.set(i, i + sh < a.bw && a.get_bit(i + sh));
+                val.eval.set_shift_right(a.bits(), sh);
                 if (sign)
-                    val.set_range(m_tmp, a.bw - sh, a.bw, true);
-                val.set(m_tmp);
+                    val.set_range(val.eval, a.bw - sh, a.bw, true);
             }
             break;
         }
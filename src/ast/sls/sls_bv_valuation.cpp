@@ -128,27 +128,59 @@ namespace sls {
             a.copy_to(a.nw, *this);
         else if (shift >= a.bw)
             set_zero();
-        else
-            for (unsigned i = 0; i < bw; ++i)
-                set(i, i + shift < bw ? a.get(i + shift) : false);
+        else {
+            // shift whole digits and carry the remaining bits from the next digit.
+            unsigned const W = 8 * sizeof(digit_t);
+            unsigned ws = shift / W, bs = shift % W;
+            digit_t top = a[nw - 1] & mask;
+            auto digit = [&](unsigned j) { return j + 1 < nw ? a[j] : j + 1 == nw ? top : 0; };
+            for (unsigned i = 0; i < nw; ++i) {
+                digit_t lo = digit(i + ws);
+                (*this)[i] = bs == 0 ? lo : (lo >> bs) | (digit(i + ws + 1) << (W - bs));
+            }
+        }
         return *this;
     }
 
     bvect& bvect::set_shift_left(bvect const& a, bvect const& b) {
-        set_bw(a.bw);
         SASSERT(a.bw == b.bw);
-        unsigned shift = b.to_nat(b.bw);
+        return set_shift_left(a, b.to_nat(b.bw));
+    }
 
+    bvect& bvect::set_shift_left(bvect const& a, unsigned shift) {
+        set_bw(a.bw);
         if (shift == 0)
             a.copy_to(a.nw, *this);
         else if (shift >= a.bw)
             set_zero();
-        else
-            for (unsigned i = bw; i-- > 0; )
-                set(i, i >= shift ? a.get(i - shift) : false);
+        else {
+            unsigned const W = 8 * sizeof(digit_t);
+            unsigned ws = shift / W, bs = shift % W;
+            for (unsigned i = nw; i-- > 0; ) {
+                digit_t hi = i >= ws ? a[i - ws] : 0;
+                digit_t lo = i >= ws + 1 ? a[i - ws - 1] : 0;
+                (*this)[i] = bs == 0 ? hi : (hi << bs) | (lo >> (W - bs));
+            }
+            (*this)[nw - 1] &= mask;
+        }
         return *this;
     }
 
+    void bvect::copy_bits(unsigned lo, bvect const& src, unsigned src_lo, unsigned n) {
+        unsigned const W = 8 * sizeof(digit_t);
+        while (n > 0) {
+            unsigned so = src_lo % W, dof = lo % W;
+            unsigned k = std::min(n, std::min(W - so, W - dof));
+            digit_t m = k == W ? ~(digit_t)0 : (((digit_t)1 << k) - 1);
+            digit_t v = (src[src_lo / W] >> so) & m;
+            digit_t& d = (*this)[lo / W];
+            d = (d & ~(m << dof)) | (v << dof);
+            lo += k;
+            src_lo += k;
+            n -= k;
+        }
+    }
+
     bv_valuation::bv_valuation(unsigned bw) {
         set_bw(bw);
         m_lo.set_bw(bw);
@@ -701,12 +733,25 @@ namespace sls {
     }
 
     void bv_valuation::set_sub(bvect& out, bvect const& a, bvect const& b) const {
-        digit_t c;
-        mpn_manager().sub(a.data(), nw, b.data(), nw, out.data(), &c);
+        if (is_word()) 
+            set_word(out, get_word(a) - get_word(b));
+        else {
+            digit_t c;
+            mpn_manager().sub(a.data(), nw, b.data(), nw, out.data(), &c);
+        }
         clear_overflow_bits(out);
     }
 
     bool bv_valuation::set_add(bvect& out, bvect const& a, bvect const& b) const {
+        if (is_word()) {
+            uint64_t x = get_word(a), r = x + get_word(b);
+            set_word(out, r);
+            // the carry digit is set as by mpn_manager::add
+            out[nw] = nw == 1 ? static_cast<digit_t>(r >> (8 * sizeof(digit_t))) : (r < x);
+            bool ovfl = out[nw] != 0 || has_overflow(out);
+            clear_overflow_bits(out);
+            return ovfl;
+        }
         digit_t c;
         mpn_manager().add(a.data(), nw, b.data(), nw, out.data(), nw + 1, &c);
         bool ovfl = out[nw] != 0 || has_overflow(out);
@@ -717,7 +762,24 @@ namespace sls {
     bool bv_valuation::set_mul(bvect& out, bvect const& a, bvect const& b, bool check_overflow) const {
         out.reserve(2 * nw);
         SASSERT(out.size() >= 2 * nw);
-        mpn_manager().mul(a.data(), nw, b.data(), nw, out.data());
+        if (nw == 1) {
+            uint64_t r = static_cast<uint64_t>(a[0]) * b[0];
+            out[0] = static_cast<digit_t>(r);
+            out[1] = static_cast<digit_t>(r >> (8 * sizeof(digit_t)));
+        }
+        else if (nw == 2 && sizeof(digit_t) == 4) {
+            // full 128-bit product from the four 32x32 partial products.
+            uint64_t a0 = a[0], a1 = a[1], b0 = b[0], b1 = b[1];
+            uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+            uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+            uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+            out[0] = static_cast<digit_t>(p00);
+            out[1] = static_cast<digit_t>(mid);
+            out[2] = static_cast<digit_t>(hi);
+            out[3] = static_cast<digit_t>(hi >> 32);
+        }
+        else
+            mpn_manager().mul(a.data(), nw, b.data(), nw, out.data());
         bool ovfl = false;
         if (check_overflow) {
             ovfl = has_overflow(out);
@@ -66,6 +66,10 @@ namespace sls {
         bvect& set_shift_right(bvect const& a, bvect const& b);
         bvect& set_shift_right(bvect const& a, unsigned shift);
         bvect& set_shift_left(bvect const& a, bvect const& b);
+        bvect& set_shift_left(bvect const& a, unsigned shift);
+
+        // copy bits [src_lo, src_lo + n[ of src to [lo, lo + n[
+        void copy_bits(unsigned lo, bvect const& src, unsigned src_lo, unsigned n);
 
         rational get_value(unsigned nw) const;
 
@@ -295,6 +299,23 @@ namespace sls {
             }
         }
 
+        // bit-vectors of at most 64 bits are evaluated on a single machine word
+        bool is_word() const { return nw * sizeof(digit_t) <= sizeof(uint64_t); }
+
+        uint64_t get_word(bvect const& a) const {
+            SASSERT(is_word());
+            uint64_t r = 0;
+            for (unsigned i = nw; i-- > 0; )
+                r = (r << (4 * sizeof(digit_t)) << (4 * sizeof(digit_t))) | a[i];
+            return r;
+        }
+
+        void set_word(bvect& out, uint64_t v) const {
+            SASSERT(is_word());
+            for (unsigned i = 0; i < nw; ++i, v = v >> (4 * sizeof(digit_t)) >> (4 * sizeof(digit_t)))
+                out[i] = static_cast<digit_t>(v);
+        }
+
         void set_sub(bvect& out, bvect const& a, bvect const& b) const;
         bool set_add(bvect& out, bvect const& a, bvect const& b) const;
         bool set_mul(bvect& out, bvect const& a, bvect const& b, bool check_overflow = true) const;
@@ -19,6 +19,7 @@ Author:
 #include "ast/sls/sls_smt_plugin.h"
 #include "ast/for_each_expr.h"
 #include "ast/bv_decl_plugin.h"
+#include "smt/params/smt_params_helper.hpp"
 
 namespace sls {
 
@@ -51,6 +52,16 @@ namespace sls {
         m_ddfw = alloc(sat::ddfw);
         m_ddfw->set_plugin(this);
         m_ddfw->updt_params(ctx.get_params());
+        if (m_shared) {
+            params_ref p = ctx.get_params();
+            unsigned seed = smt_params_helper(p).random_seed() + m_id;
+            p.set_uint("random_seed", seed);
+            m_ddfw->set_seed(seed);
+            m_context.updt_params(p);
+            m_shared_version = 0;
+            m_shared_units = 0;
+            m_shared_units_added.reset();
+        }
 
         for (auto const& clause : clauses) {
             m_ddfw->add(clause.size(), clause.data());
@@ -180,8 +191,55 @@ namespace sls {
             updated = true;
         if (export_phase_to_sls())
             updated = true;
+        if (import_from_shared())
+            updated = true;
+        return updated;
+    }
+
+    bool smt_plugin::import_from_shared() {
+        if (!m_shared)
+            return false;
+        bool updated = false;
+        if (m_shared->num_units() != m_shared_units) {
+            m_shared_units = m_shared->num_units();
+            for (auto v : m_shared_bool_vars) {
+                lbool u = m_shared->get_unit(v);
+                if (u == l_undef || m_shared_units_added.contains(v))
+                    continue;
+                m_shared_units_added.insert(v);
+                sat::literal sls_lit(m_smt_bool_var2sls_bool_var[v], u == l_false);
+                m_ddfw->add(1, &sls_lit);
+                updated = true;
+            }
+        }
+        unsigned version = m_shared->version();
+        if (version != m_shared_version && m_shared->owner() != m_id) {
+            IF_VERBOSE(3, verbose_stream() << "shared -> SLS phase " << m_id << "\n");
+            for (auto v : m_shared_bool_vars) {
+                lbool ph = m_shared->get_phase(v);
+                if (ph == l_undef)
+                    continue;
+                auto w = m_smt_bool_var2sls_bool_var[v];
+                if ((ph == l_true) != is_true(sat::literal(w, false)))
+                    flip(w);
+                m_ddfw->bias(w) = ph == l_true ? 1 : -1;
+            }
+            updated = true;
+        }
+        m_shared_version = version;
         return updated;
     }
+
+    void smt_plugin::export_to_shared() {
+        if (!m_shared)
+            return;
+        for (auto v : m_shared_bool_vars) {
+            auto w = m_smt_bool_var2sls_bool_var[v];
+            m_shared->set_phase(v, is_true(sat::literal(w, false)));
+        }
+        m_shared->publish(m_id);
+        m_shared_version = m_shared->version();
+    }
     
     bool smt_plugin::export_phase_to_sls() {
         if (!m_has_new_sat_phase)
@@ -303,6 +361,7 @@ namespace sls {
 
     void smt_plugin::on_save_model()  {
         TRACE("sls", display(tout));
+        export_to_shared();
         while (unsat().empty()) {
             m_context.check();
             if (!m_new_clause_added)
@@ -22,6 +22,7 @@ Author:
 #include "util/statistics.h"
 #include <thread>
 #include <mutex>
+#include <memory>
 
 namespace sls {
 
@@ -40,6 +41,54 @@ namespace sls {
     };
 
 
+    //
+    // Phases and units shared by SLS workers and the CDCL solver, indexed
+    // by Boolean variables of the CDCL solver. A worker publishes the
+    // assignment that satisfies its clauses and bumps the version, the
+    // CDCL solver publishes its top-level units. Entries are read and
+    // written without locks. A reader may see a mix of two assignments
+    // that are published concurrently, which is harmless for phase
+    // selection.
+    //
+    class shared_phases {
+        enum : uint8_t { undef_v = 0, false_v = 1, true_v = 2 };
+        unsigned                                 m_size;
+        std::unique_ptr<std::atomic<uint8_t>[]>  m_phase;
+        std::unique_ptr<std::atomic<uint8_t>[]>  m_unit;
+        std::atomic<unsigned>                    m_version = 0;
+        std::atomic<unsigned>                    m_owner = UINT_MAX;
+        std::atomic<unsigned>                    m_num_units = 0;
+
+        static lbool to_lbool(uint8_t v) { return v == undef_v ? l_undef : (v == true_v ? l_true : l_false); }
+    public:
+        shared_phases(unsigned n): m_size(n), m_phase(new std::atomic<uint8_t>[n]), m_unit(new std::atomic<uint8_t>[n]) {
+            for (unsigned i = 0; i < n; ++i)
+                m_phase[i] = undef_v, m_unit[i] = undef_v;
+        }
+        unsigned size() const { return m_size; }
+        void set_phase(sat::bool_var v, bool phase) {
+            if (v < m_size)
+                m_phase[v].store(phase ? true_v : false_v, std::memory_order_relaxed);
+        }
+        lbool get_phase(sat::bool_var v) const {
+            return v < m_size ? to_lbool(m_phase[v].load(std::memory_order_relaxed)) : l_undef;
+        }
+        void publish(unsigned id) {
+            m_owner.store(id, std::memory_order_relaxed);
+            m_version.fetch_add(1, std::memory_order_release);
+        }
+        unsigned version() const { return m_version.load(std::memory_order_acquire); }
+        unsigned owner() const { return m_owner.load(std::memory_order_relaxed); }
+        void set_unit(sat::literal lit) {
+            if (lit.var() < m_size && m_unit[lit.var()].exchange(lit.sign() ? false_v : true_v, std::memory_order_relaxed) == undef_v)
+                m_num_units.fetch_add(1, std::memory_order_release);
+        }
+        lbool get_unit(sat::bool_var v) const {
+            return v < m_size ? to_lbool(m_unit[v].load(std::memory_order_relaxed)) : l_undef;
+        }
+        unsigned num_units() const { return m_num_units.load(std::memory_order_acquire); }
+    };
+
     //
     // m is accessed by the main thread
     // m_sls  is accessed by the sls thread
@@ -75,6 +124,14 @@ namespace sls {
         svector<bool> m_sls_phase;
         svector<double> m_rewards;
         svector<sat::bool_var> m_smt_bool_var2sls_bool_var, m_sls_bool_var2smt_bool_var;
+        shared_phases* m_shared = nullptr;
+        unsigned m_id = 0;
+        unsigned m_shared_version = 0;
+        unsigned m_shared_units = 0;
+        uint_set m_shared_units_added;
+
+        bool import_from_shared();
+        void export_to_shared();
         
         bool is_shared(sat::literal lit);
         void run();
@@ -106,6 +163,12 @@ namespace sls {
         void updt_params(params_ref& p) {}
         std::ostream& display(std::ostream& out) override;
 
+        /**
+           \brief run as worker id exchanging phases and units through s.
+           The worker uses the random seed offset by id.
+        */
+        void set_shared(shared_phases* s, unsigned id) { m_shared = s; m_id = id; }
+
         bool export_to_sls();
         void import_from_sls();
         bool completed() { return m_completed; }
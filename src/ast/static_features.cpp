@@ -20,6 +20,7 @@ Revision History:
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/for_each_expr.h"
+#include <sstream>
 
 static_features::static_features(ast_manager & m):
     m(m),
@@ -663,7 +664,24 @@ void static_features::display(std::ostream & out) const {
     out << "END_STATIC_FEATURES" << "\n";
 }
 
+void static_features::get_features(vector<std::pair<symbol, double>> & result) const {
+    std::stringstream strm;
+    display_primitive(strm);
+    std::string name;
+    double value;
+    std::string line;
+    while (std::getline(strm, line)) {
+        std::istringstream is(line);
+        if (is >> name >> value)
+            result.push_back({ symbol(name.c_str()), value });
+    }
+}
+
 void static_features::get_feature_vector(vector<double> & result) {
+    vector<std::pair<symbol, double>> features;
+    get_features(features);
+    for (auto const& [n, v] : features)
+        result.push_back(v);
 }
 
 bool static_features::is_dense() const {
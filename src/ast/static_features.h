@@ -185,6 +185,10 @@ struct static_features {
     void display_family_data(std::ostream & out, char const * prefix, unsigned_vector const & data) const;
     void display_primitive(std::ostream & out) const;
     void display(std::ostream & out) const;
+    /**
+       \brief features of display_primitive as pairs of name and value, in the same order.
+    */
+    void get_features(vector<std::pair<symbol, double>> & result) const;
     void get_feature_vector(vector<double> & result);
     bool has_uf() const;
     unsigned num_theories() const; 
@@ -0,0 +1,101 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ast_bench.cpp
+
+Abstract:
+
+    Benchmarks for term construction, rewriting and model evaluation.
+
+--*/
+#include "ast/ast.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "model/model.h"
+#include "model/model_evaluator.h"
+#include "bench/bench.h"
+
+/**
+   \brief build a chain of binary applications, every other one is already hash-consed.
+*/
+void bench_ast_mk_app(bench_context& ctx) {
+    unsigned n = 200000 * ctx.scale();
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort* I = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), I, I, I), m);
+    expr_ref_vector terms(m);
+    terms.push_back(m.mk_const(symbol("x"), I));
+    terms.push_back(m.mk_const(symbol("y"), I));
+    ctx.start();
+    for (unsigned i = 0; i < n; ++i) {
+        terms.push_back(m.mk_app(f, terms.get(i), terms.get(i + 1)));
+        m.mk_app(f, terms.get(i), terms.get(i + 1));
+    }
+    ctx.stop();
+    ctx.set_work(2.0 * n, "apps");
+}
+
+/**
+   \brief simplify a conjunction of arithmetic and Boolean redundancies.
+*/
+void bench_rewriter(bench_context& ctx) {
+    unsigned n = 20000 * ctx.scale();
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort* I = a.mk_int();
+    expr_ref_vector fmls(m);
+    for (unsigned i = 0; i < n; ++i) {
+        expr_ref x(m.mk_const(symbol(i), I), m);
+        expr_ref b(m.mk_fresh_const("b", m.mk_bool_sort()), m);
+        expr_ref t(a.mk_add(a.mk_mul(a.mk_int(1), x), a.mk_int(0), a.mk_sub(x, a.mk_int(i))), m);
+        fmls.push_back(m.mk_and(a.mk_le(t, a.mk_int(i + 1)), m.mk_or(m.mk_true(), b), m.mk_eq(m.mk_ite(b, x, a.mk_add(x, a.mk_int(0))), x)));
+    }
+    expr_ref fml(m.mk_and(fmls), m), r(m);
+    th_rewriter rw(m);
+    ctx.start();
+    rw(fml, r);
+    ctx.stop();
+    ctx.set_work(n, "conjuncts");
+}
+
+/**
+   \brief evaluate distinct terms over constants and an uninterpreted function.
+*/
+void bench_model_eval(bench_context& ctx) {
+    unsigned n = 20000 * ctx.scale();
+    unsigned num_entries = 64;
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort* I = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), I, I), m);
+    model_ref mdl = alloc(model, m);
+    func_interp* fi = alloc(func_interp, m, 1);
+    for (unsigned i = 0; i < num_entries; ++i) {
+        expr* arg = a.mk_int(i);
+        fi->insert_entry(&arg, a.mk_int(2 * i));
+    }
+    fi->set_else(a.mk_int(0));
+    mdl->register_decl(f, fi);
+    expr_ref_vector consts(m), terms(m);
+    for (unsigned i = 0; i < n; ++i) {
+        app* c = m.mk_const(symbol(i), I);
+        consts.push_back(c);
+        mdl->register_decl(c->get_decl(), a.mk_int(i % (2 * num_entries)));
+    }
+    for (unsigned i = 0; i + 1 < n; ++i)
+        terms.push_back(a.mk_le(a.mk_add(m.mk_app(f, consts.get(i)), consts.get(i + 1)), a.mk_int(i)));
+    model_evaluator ev(*mdl);
+    expr_ref r(m);
+    ctx.start();
+    for (expr* t : terms)
+        ev(t, r);
+    ctx.stop();
+    ctx.set_work(terms.size(), "terms");
+}
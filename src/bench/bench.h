@@ -0,0 +1,56 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    bench.h
+
+Abstract:
+
+    Interface between z3-bench and the benchmarks it runs.
+
+    A benchmark is a function void bench_<name>(bench_context& ctx)
+    registered in main.cpp. It is called once per warmup run and once
+    per repetition. If it brackets the measured work with ctx.start()
+    and ctx.stop(), only that part is timed, so that building the input
+    does not count. ctx.set_work() reports the amount of work done by
+    one run, from which the throughput is computed.
+
+--*/
+#pragma once
+
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+
+class bench_context {
+    unsigned    m_scale;
+    unsigned    m_seed = 0;
+    stopwatch   m_watch;
+    bool        m_timed = false;
+    double      m_work = 0;
+    char const* m_unit = "items";
+public:
+    bench_context(unsigned scale): m_scale(scale) {}
+
+    // size multiplier set by -scale
+    unsigned scale() const { return m_scale; }
+
+    // seed for generated inputs; it is the same in every run
+    unsigned seed() const { return m_seed; }
+
+    void start() { m_timed = true; m_watch.start(); }
+    void stop() { m_watch.stop(); }
+
+    void set_work(double work, char const* unit) { m_work = work; m_unit = unit; }
+
+    void reset() { m_timed = false; m_watch.reset(); m_work = 0; }
+    bool timed() const { return m_timed; }
+    double seconds() const { return m_watch.get_seconds(); }
+    double work() const { return m_work; }
+    char const* unit() const { return m_unit; }
+};
+
+/**
+   \brief return the value of the statistic with the given key, or 0.
+*/
+double get_statistic(statistics const& st, char const* key);
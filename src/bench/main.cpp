@@ -0,0 +1,300 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    main.cpp
+
+Abstract:
+
+    z3-bench: run performance benchmarks and compare them with a baseline.
+
+    Every benchmark is run -warmup times without measuring and then -reps
+    times. The median and the median absolute deviation (MAD) of the
+    repetitions are reported. With -json:file the results are written as
+    JSON, and with -baseline:file they are compared with the results of
+    an earlier run. A benchmark regresses if its median exceeds the
+    baseline by more than -tolerance and by more than three times its
+    MAD; z3-bench then exits with code 1.
+
+--*/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "util/util.h"
+#include "util/vector.h"
+#include "util/memory_manager.h"
+#include "util/gparams.h"
+#include "util/z3_exception.h"
+#include "util/z3_version.h"
+#include "bench/bench.h"
+
+typedef void (*bench_fn)(bench_context&);
+
+struct bench_entry {
+    char const* m_name;
+    bench_fn    m_fn;
+};
+
+struct bench_result {
+    std::string m_name;
+    unsigned    m_reps = 0;
+    double      m_median = 0;
+    double      m_mad = 0;
+    double      m_work = 0;
+    std::string m_unit;
+};
+
+#define BENCH(NAME) {                                   \
+        void bench_##NAME(bench_context&);              \
+        benches.push_back({ #NAME, bench_##NAME });     \
+    }
+
+static void register_benches(svector<bench_entry>& benches) {
+    BENCH(ast_mk_app);
+    BENCH(rewriter);
+    BENCH(model_eval);
+    BENCH(sat_bcp);
+    BENCH(simplex_pivots);
+    BENCH(ematching);
+    BENCH(parser);
+}
+
+double get_statistic(statistics const& st, char const* key) {
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.is_uint(i) ? st.get_uint_value(i) : st.get_double_value(i);
+    return 0;
+}
+
+static unsigned g_reps = 5;
+static unsigned g_warmup = 1;
+static unsigned g_scale = 1;
+static double   g_tolerance = 0.1;
+static char const* g_json = nullptr;
+static char const* g_baseline = nullptr;
+static bool     g_list = false;
+
+static void display_usage() {
+    std::cout << "z3-bench [version " << Z3_FULL_VERSION << "]. (C) Copyright 2024 Microsoft Corp.\n";
+    std::cout << "Usage: z3-bench [options] [benchmark names]\n";
+    std::cout << "  -h            prints this message.\n";
+    std::cout << "  -list         list the benchmarks.\n";
+    std::cout << "  -reps:n       number of measured repetitions (default: 5).\n";
+    std::cout << "  -warmup:n     number of runs before measuring (default: 1).\n";
+    std::cout << "  -scale:n      multiply the size of the generated inputs by n (default: 1).\n";
+    std::cout << "  -json:file    write the results to file as JSON.\n";
+    std::cout << "  -baseline:f   compare with the JSON results in f.\n";
+    std::cout << "  -tolerance:t  allowed slowdown as a fraction of the baseline (default: 0.1).\n";
+    std::cout << "  param=value   set a global parameter.\n";
+    std::cout << "Without benchmark names, all benchmarks are run.\n";
+}
+
+[[noreturn]] static void error(char const* msg) {
+    std::cerr << "Error: " << msg << "\n";
+    std::cerr << "For usage information: z3-bench -h\n";
+    exit(2);
+}
+
+static unsigned parse_uint(char const* opt, char const* arg) {
+    if (!arg)
+        error((std::string("option argument is missing for -") + opt).c_str());
+    return static_cast<unsigned>(strtoul(arg, nullptr, 10));
+}
+
+static void parse_cmd_line_args(int argc, char** argv, svector<char const*>& names) {
+    for (int i = 1; i < argc; ++i) {
+        char* arg = argv[i];
+        char* eq_pos = nullptr;
+        if (arg[0] == '-' || arg[0] == '/') {
+            char* opt_name = arg + 1;
+            char* opt_arg = nullptr;
+            char* colon = strchr(arg, ':');
+            if (colon) {
+                opt_arg = colon + 1;
+                *colon = 0;
+            }
+            if (strcmp(opt_name, "h") == 0 || strcmp(opt_name, "?") == 0) {
+                display_usage();
+                exit(0);
+            }
+            else if (strcmp(opt_name, "list") == 0)
+                g_list = true;
+            else if (strcmp(opt_name, "reps") == 0)
+                g_reps = std::max(1u, parse_uint(opt_name, opt_arg));
+            else if (strcmp(opt_name, "warmup") == 0)
+                g_warmup = parse_uint(opt_name, opt_arg);
+            else if (strcmp(opt_name, "scale") == 0)
+                g_scale = std::max(1u, parse_uint(opt_name, opt_arg));
+            else if (strcmp(opt_name, "json") == 0 && opt_arg)
+                g_json = opt_arg;
+            else if (strcmp(opt_name, "baseline") == 0 && opt_arg)
+                g_baseline = opt_arg;
+            else if (strcmp(opt_name, "tolerance") == 0 && opt_arg)
+                g_tolerance = strtod(opt_arg, nullptr);
+            else
+                error((std::string("unknown option -") + opt_name).c_str());
+        }
+        else if ((eq_pos = strchr(arg, '='))) {
+            *eq_pos = 0;
+            try {
+                gparams::set(arg, eq_pos + 1);
+            }
+            catch (z3_exception& ex) {
+                std::cerr << ex.what() << "\n";
+            }
+        }
+        else
+            names.push_back(arg);
+    }
+}
+
+static double median(svector<double> v) {
+    std::sort(v.begin(), v.end());
+    unsigned n = v.size();
+    return n % 2 == 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+static bench_result run_bench(bench_entry const& b) {
+    bench_context ctx(g_scale);
+    svector<double> times;
+    for (unsigned i = 0; i < g_warmup + g_reps; ++i) {
+        ctx.reset();
+        stopwatch sw;
+        sw.start();
+        b.m_fn(ctx);
+        sw.stop();
+        if (i >= g_warmup)
+            times.push_back(ctx.timed() ? ctx.seconds() : sw.get_seconds());
+    }
+    bench_result r;
+    r.m_name = b.m_name;
+    r.m_reps = g_reps;
+    r.m_median = median(times);
+    svector<double> dev;
+    for (double t : times)
+        dev.push_back(std::fabs(t - r.m_median));
+    r.m_mad = median(dev);
+    r.m_work = ctx.work();
+    r.m_unit = ctx.unit();
+    return r;
+}
+
+static double throughput(bench_result const& r) {
+    return r.m_median > 0 ? r.m_work / r.m_median : 0;
+}
+
+static void write_json(char const* file, vector<bench_result> const& results) {
+    std::ofstream out(file);
+    if (!out)
+        error((std::string("could not write ") + file).c_str());
+    out << std::setprecision(9);
+    out << "{\n  \"version\": \"" << Z3_FULL_VERSION << "\",\n  \"scale\": " << g_scale << ",\n  \"benchmarks\": [\n";
+    for (unsigned i = 0; i < results.size(); ++i) {
+        auto const& r = results[i];
+        // one benchmark per line, which is what read_baseline expects
+        out << "    {\"name\": \"" << r.m_name << "\", \"reps\": " << r.m_reps
+            << ", \"median\": " << r.m_median << ", \"mad\": " << r.m_mad
+            << ", \"work\": " << r.m_work << ", \"unit\": \"" << r.m_unit
+            << "\", \"throughput\": " << throughput(r) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static bool read_field(std::string const& line, char const* key, std::string& value) {
+    std::string k = std::string("\"") + key + "\": ";
+    size_t pos = line.find(k);
+    if (pos == std::string::npos)
+        return false;
+    pos += k.size();
+    if (pos < line.size() && line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos)
+            return false;
+        value = line.substr(pos + 1, end - pos - 1);
+    }
+    else {
+        size_t end = line.find_first_of(",}", pos);
+        value = line.substr(pos, end - pos);
+    }
+    return true;
+}
+
+static void read_baseline(char const* file, vector<std::pair<std::string, double>>& baseline) {
+    std::ifstream in(file);
+    if (!in)
+        error((std::string("could not read baseline ") + file).c_str());
+    std::string line, name, med;
+    while (std::getline(in, line))
+        if (read_field(line, "name", name) && read_field(line, "median", med))
+            baseline.push_back({ name, strtod(med.c_str(), nullptr) });
+}
+
+static bool compare(vector<bench_result> const& results, vector<std::pair<std::string, double>> const& baseline) {
+    bool ok = true;
+    std::cout << "\ncomparison with " << g_baseline << " (tolerance " << g_tolerance << "):\n";
+    for (auto const& r : results) {
+        auto it = std::find_if(baseline.begin(), baseline.end(), [&](auto const& b) { return b.first == r.m_name; });
+        if (it == baseline.end() || it->second <= 0) {
+            std::cout << "  " << std::left << std::setw(18) << r.m_name << " no baseline\n";
+            continue;
+        }
+        double base = it->second;
+        double ratio = r.m_median / base;
+        bool regressed = r.m_median > base * (1 + g_tolerance) && r.m_median - base > 3 * r.m_mad;
+        std::cout << "  " << std::left << std::setw(18) << r.m_name << std::right << std::fixed << std::setprecision(3)
+                  << " ratio " << ratio << (regressed ? "  REGRESSION" : "") << "\n";
+        ok &= !regressed;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    memory::initialize(0);
+    svector<char const*> names;
+    parse_cmd_line_args(argc, argv, names);
+    svector<bench_entry> benches;
+    register_benches(benches);
+    if (g_list) {
+        for (auto const& b : benches)
+            std::cout << b.m_name << "\n";
+        return 0;
+    }
+    for (char const* n : names)
+        if (!std::any_of(benches.begin(), benches.end(), [&](bench_entry const& b) { return strcmp(b.m_name, n) == 0; }))
+            error((std::string("unknown benchmark ") + n).c_str());
+
+    vector<bench_result> results;
+    for (auto const& b : benches) {
+        if (!names.empty() && !std::any_of(names.begin(), names.end(), [&](char const* n) { return strcmp(b.m_name, n) == 0; }))
+            continue;
+        try {
+            bench_result r = run_bench(b);
+            std::cout << std::left << std::setw(18) << r.m_name << std::right << std::fixed << std::setprecision(6)
+                      << " median " << r.m_median << "s mad " << r.m_mad << "s "
+                      << std::setprecision(0) << throughput(r) << " " << r.m_unit << "/s\n";
+            std::cout.flush();
+            results.push_back(r);
+        }
+        catch (z3_exception& ex) {
+            std::cerr << b.m_name << ": " << ex.what() << "\n";
+            return 2;
+        }
+    }
+    if (g_json)
+        write_json(g_json, results);
+    bool ok = true;
+    if (g_baseline) {
+        vector<std::pair<std::string, double>> baseline;
+        read_baseline(g_baseline, baseline);
+        ok = compare(results, baseline);
+    }
+    memory::finalize();
+    return ok ? 0 : 1;
+}
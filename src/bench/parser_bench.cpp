@@ -0,0 +1,37 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    parser_bench.cpp
+
+Abstract:
+
+    Parsing of a generated SMT-LIB2 script with many assertions.
+
+--*/
+#include <sstream>
+#include "cmd_context/cmd_context.h"
+#include "parsers/smt2/smt2parser.h"
+#include "bench/bench.h"
+
+void bench_parser(bench_context& ctx) {
+    unsigned n = 20000 * ctx.scale();
+    std::ostringstream script;
+    script << "(declare-fun f (Int Int) Int)\n(declare-fun p (Int) Bool)\n";
+    for (unsigned i = 0; i < n; ++i)
+        script << "(declare-const x" << i << " Int)\n";
+    for (unsigned i = 0; i + 1 < n; ++i)
+        script << "(assert (or (p (f x" << i << " x" << (i + 1) << ")) (<= (+ x" << i << " (* 2 x" << (i + 1)
+               << ")) (- " << i << " 1)) (let ((y (f x" << (i + 1) << " " << i << "))) (= y x" << i << "))))\n";
+    std::string text = script.str();
+    std::istringstream is(text);
+    cmd_context cmd;
+    cmd.set_ignore_check(true);
+    ctx.start();
+    bool ok = parse_smt2_commands(cmd, is);
+    ctx.stop();
+    if (!ok)
+        throw default_exception("parser benchmark failed");
+    ctx.set_work(text.size(), "bytes");
+}
@@ -0,0 +1,45 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_bench.cpp
+
+Abstract:
+
+    Boolean constraint propagation on random 3-SAT near the phase transition.
+
+--*/
+#include "util/util.h"
+#include "util/rlimit.h"
+#include "sat/sat_solver.h"
+#include "bench/bench.h"
+
+void bench_sat_bcp(bench_context& ctx) {
+    unsigned num_vars = 2000 * ctx.scale();
+    unsigned num_clauses = (num_vars * 426) / 100;
+    reslimit rl;
+    params_ref p;
+    p.set_uint("max_conflicts", 20000 * ctx.scale());
+    sat::solver s(p, rl);
+    for (unsigned i = 0; i < num_vars; ++i)
+        s.mk_var();
+    random_gen rand(ctx.seed());
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        lits.reset();
+        while (lits.size() < 3) {
+            sat::literal l(rand(num_vars), rand(2) == 0);
+            if (!lits.contains(l) && !lits.contains(~l))
+                lits.push_back(l);
+        }
+        s.mk_clause(lits);
+    }
+    ctx.start();
+    s.check();
+    ctx.stop();
+    statistics st;
+    s.collect_statistics(st);
+    ctx.set_work(get_statistic(st, "sat propagations 2ary") + get_statistic(st, "sat propagations 3ary") +
+                 get_statistic(st, "sat propagations nary"), "propagations");
+}
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    simplex_bench.cpp
+
+Abstract:
+
+    Pivoting of the sparse simplex on random bounded rows.
+
+--*/
+#include "math/simplex/sparse_matrix_def.h"
+#include "math/simplex/simplex.h"
+#include "math/simplex/simplex_def.h"
+#include "util/mpq_inf.h"
+#include "util/util.h"
+#include "util/rlimit.h"
+#include "bench/bench.h"
+
+typedef simplex::simplex<simplex::mpz_ext> Simplex;
+
+/**
+   \brief rows s_j = sum_i c_ij x_i with 0 <= x_i <= 10 and random bounds on s_j.
+*/
+void bench_simplex_pivots(bench_context& ctx) {
+    unsigned num_vars = 300 * ctx.scale();
+    unsigned num_rows = 200 * ctx.scale();
+    unsigned row_size = 8;
+    reslimit rl;
+    Simplex S(rl);
+    unsynch_mpz_manager m;
+    random_gen rand(ctx.seed());
+    for (unsigned i = 0; i < num_vars; ++i) {
+        S.ensure_var(i);
+        S.set_lower(i, mpq_inf(mpq(0), mpq(0)));
+        S.set_upper(i, mpq_inf(mpq(10), mpq(0)));
+    }
+    unsigned_vector vars;
+    scoped_mpz_vector coeffs(m);
+    for (unsigned j = 0; j < num_rows; ++j) {
+        unsigned base = num_vars + j;
+        S.ensure_var(base);
+        vars.reset();
+        coeffs.reset();
+        while (vars.size() < row_size) {
+            unsigned v = rand(num_vars);
+            if (vars.contains(v))
+                continue;
+            vars.push_back(v);
+            coeffs.push_back(mpz(static_cast<int>(rand(11)) - 5));
+        }
+        vars.push_back(base);
+        coeffs.push_back(mpz(-1));
+        S.add_row(base, vars.size(), vars.data(), coeffs.data());
+        int b = static_cast<int>(rand(20)) - 5;
+        S.set_lower(base, mpq_inf(mpq(b), mpq(0)));
+        S.set_upper(base, mpq_inf(mpq(b + 4), mpq(0)));
+    }
+    ctx.start();
+    S.make_feasible();
+    ctx.stop();
+    statistics st;
+    S.collect_statistics(st);
+    ctx.set_work(get_statistic(st, "simplex num pivots"), "pivots");
+}
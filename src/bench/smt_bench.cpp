@@ -0,0 +1,56 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    smt_bench.cpp
+
+Abstract:
+
+    E-matching of quantified axioms against many ground terms.
+
+--*/
+#include "ast/ast.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "smt/params/smt_params.h"
+#include "smt/smt_kernel.h"
+#include "bench/bench.h"
+
+/**
+   \brief the axioms forall x. f(g(x)) = x and forall x. p(g(x)) => x >= 0,
+   with patterns g(x) and p(g(x)), are instantiated for every c_i in p(g(c_i)).
+*/
+void bench_ematching(bench_context& ctx) {
+    unsigned n = 2000 * ctx.scale();
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort* I = a.mk_int();
+    sort* B = m.mk_bool_sort();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), I, I), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), I, I), m);
+    func_decl_ref p(m.mk_func_decl(symbol("p"), I, B), m);
+    symbol x_name("x");
+    expr_ref x(m.mk_var(0, I), m);
+    app_ref gx(m.mk_app(g, x.get()), m), pgx(m.mk_app(p, gx.get()), m);
+    expr* pat1 = m.mk_pattern(gx);
+    expr* pat2 = m.mk_pattern(pgx);
+    expr_ref ax1(m.mk_forall(1, &I, &x_name, m.mk_eq(m.mk_app(f, gx.get()), x), 0, symbol("ax1"), symbol(), 1, &pat1), m);
+    expr_ref ax2(m.mk_forall(1, &I, &x_name, m.mk_implies(pgx, a.mk_ge(x, a.mk_int(0))), 0, symbol("ax2"), symbol(), 1, &pat2), m);
+
+    smt_params fp;
+    smt::kernel k(m, fp);
+    k.assert_expr(ax1);
+    k.assert_expr(ax2);
+    for (unsigned i = 0; i < n; ++i) {
+        app_ref c(m.mk_const(symbol(i), I), m);
+        k.assert_expr(m.mk_app(p, m.mk_app(g, c.get())));
+    }
+    ctx.start();
+    k.check();
+    ctx.stop();
+    statistics st;
+    k.collect_statistics(st);
+    ctx.set_work(get_statistic(st, "quant instantiations"), "instances");
+}
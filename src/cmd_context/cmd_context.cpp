@@ -21,6 +21,8 @@ Notes:
 #include "util/cancel_eh.h"
 #include "util/scoped_ctrl_c.h"
 #include "util/dec_ref_util.h"
+#include "util/profile.h"
+#include "util/perf_counters.h"
 #include "util/scoped_timer.h"
 #include "ast/func_decl_dependencies.h"
 #include "ast/arith_decl_plugin.h"
@@ -35,6 +37,7 @@ Notes:
 #include "ast/ast_pp.h"
 #include "ast/pp.h"
 #include "ast/ast_smt2_pp.h"
+#include "ast/pp_params.hpp"
 #include "ast/ast_ll_pp.h"
 #include "ast/decl_collector.h"
 #include "ast/well_sorted.h"
@@ -52,6 +55,7 @@ Notes:
 #include "cmd_context/basic_cmds.h"
 #include "cmd_context/cmd_context.h"
 #include "solver/slice_solver.h"
+#include "solver/cache_solver.h"
 #include <iostream>
 
 func_decls::func_decls(ast_manager & m, func_decl * f):
@@ -1016,9 +1020,24 @@ void cmd_context::insert(symbol const & s, object_ref * r) {
     m_object_refs.insert(s, r);
 }
 
+/**
+   \brief the model converter of a scope is shared with the enclosing scope
+   until it is updated in the scope.
+*/
+generic_model_converter* cmd_context::ensure_mc0() {
+    unsigned sz = m_mcs.size();
+    if (!mc0())
+        m_mcs.set(sz - 1, alloc(generic_model_converter, m(), "cmd_context"));
+    else if (sz > 1 && m_mcs.get(sz - 2) == mc0()) {
+        ast_translation tr(m(), m());
+        m_mcs.set(sz - 1, mc0()->copy(tr));
+    }
+    return mc0();
+}
+
 void cmd_context::model_add(symbol const & s, unsigned arity, sort *const* domain, expr * t) {
 
-    if (!mc0()) m_mcs.set(m_mcs.size()-1, alloc(generic_model_converter, m(), "cmd_context"));
+    ensure_mc0();
     if (m_solver.get() && !m_solver->mc0()) m_solver->set_model_converter(mc0()); 
 
     func_decl_ref fn(m().mk_func_decl(s, arity, domain, t->get_sort()), m());
@@ -1036,7 +1055,7 @@ void cmd_context::register_fun(symbol const& s, func_decl* fn) {
 }
 
 void cmd_context::model_del(func_decl* f) {
-    if (!mc0()) m_mcs.set(m_mcs.size() - 1, alloc(generic_model_converter, m(), "cmd_context"));
+    ensure_mc0();
     if (m_solver.get() && !m_solver->mc0()) m_solver->set_model_converter(mc0());
     mc0()->hide(f);
 }
@@ -1543,6 +1562,8 @@ void cmd_context::reset(bool finalize) {
 }
 
 void cmd_context::assert_expr(expr * t) {
+    ::scoped_watch _sw(m_stats.m_assert_watch);
+    ++m_stats.m_num_assert;
     scoped_rlimit no_limit(m().limit(), 0);
     if (!m_check_logic(t))
         throw cmd_exception(m_check_logic.get_last_error());
@@ -1562,6 +1583,8 @@ void cmd_context::assert_expr(symbol const & name, expr * t) {
         assert_expr(t);
         return;
     }
+    ::scoped_watch _sw(m_stats.m_assert_watch);
+    ++m_stats.m_num_assert;
     scoped_rlimit no_limit(m().limit(), 0);
 
     m_check_sat_result = nullptr;
@@ -1575,6 +1598,8 @@ void cmd_context::assert_expr(symbol const & name, expr * t) {
 }
 
 void cmd_context::push() {
+    ::scoped_watch _sw(m_stats.m_push_watch);
+    ++m_stats.m_num_push;
     m_check_sat_result = nullptr;
     init_manager();
     m_scopes.push_back(scope());
@@ -1587,8 +1612,7 @@ void cmd_context::push() {
     s.m_assertions_lim         = m_assertions.size();
     if (!m_global_decls)
         pm().push();
-    ast_translation tr(m(), m());
-    m_mcs.push_back(m_mcs.back() ? m_mcs.back()->copy(tr) : nullptr);
+    m_mcs.push_back(m_mcs.back());
     unsigned timeout = m_params.m_timeout;
     m().limit().push(m_params.rlimit());
     cancel_eh<reslimit> eh(m().limit());
@@ -1703,6 +1727,8 @@ void cmd_context::pop(unsigned n) {
     unsigned lvl     = m_scopes.size();
     if (n > lvl)
         throw cmd_exception("invalid pop command, argument is greater than the current stack depth");
+    ::scoped_watch _sw(m_stats.m_pop_watch);
+    m_stats.m_num_pop += n;
     if (m_solver) {
         m_solver->pop(n);
     }
@@ -1710,13 +1736,19 @@ void cmd_context::pop(unsigned n) {
         m_opt->pop(n);
     unsigned new_lvl = lvl - n;
     scope & s        = m_scopes[new_lvl];
+    // datatype declarations are only removed with sort declarations.
+    bool sorts_popped =
+        s.m_psort_decls_stack_lim < m_psort_decls_stack.size() ||
+        s.m_aux_pdecls_lim < m_aux_pdecls.size() ||
+        s.m_psort_inst_stack_lim < m_psort_inst_stack.size();
     restore_func_decls(s.m_func_decls_stack_lim);
     restore_psort_decls(s.m_psort_decls_stack_lim);
     restore_macros(s.m_macros_stack_lim);
     restore_aux_pdecls(s.m_aux_pdecls_lim);
     restore_assertions(s.m_assertions_lim);
     restore_psort_inst(s.m_psort_inst_stack_lim);
-    m_dt_eh.get()->reset();
+    if (sorts_popped)
+        m_dt_eh.get()->reset();
     m_mcs.shrink(m_mcs.size() - n);
     m_scopes.shrink(new_lvl);
     if (!m_global_decls)
@@ -2259,6 +2291,7 @@ void cmd_context::mk_solver() {
     m_params.get_solver_params(p, proofs_enabled, models_enabled, unsat_core_enabled);
     m_solver = (*m_solver_factory)(m(), p, proofs_enabled, models_enabled, unsat_core_enabled, m_logic);
     m_solver = mk_slice_solver(m_solver.get());
+    m_solver = mk_cache_solver(m_solver.get(), p);
 }
 
 
@@ -2290,6 +2323,16 @@ void cmd_context::display_statistics(bool show_total_time, double total_time) {
     st.update("time", get_seconds());
     get_memory_statistics(st);
     get_rlimit_statistics(m().limit(), st);
+    profile::collect_statistics(st);
+    perf_counters::collect_statistics(st);
+    if (m_stats.m_num_push > 0 || m_stats.m_num_assert > 0) {
+        st.update("cmd push", m_stats.m_num_push);
+        st.update("cmd pop", m_stats.m_num_pop);
+        st.update("cmd assert", m_stats.m_num_assert);
+        st.update("cmd push time", m_stats.m_push_watch.get_seconds());
+        st.update("cmd pop time", m_stats.m_pop_watch.get_seconds());
+        st.update("cmd assert time", m_stats.m_assert_watch.get_seconds());
+    }
     if (m_check_sat_result) {
         m_check_sat_result->collect_statistics(st);
     }
@@ -2393,6 +2436,10 @@ void cmd_context::display(std::ostream & out, sort * s, unsigned indent) const {
 }
 
 void cmd_context::display(std::ostream & out, expr * n, unsigned indent, unsigned num_vars, char const * var_prefix, sbuffer<symbol> & var_names) const {
+    if (num_vars == 0 && pp_params().streaming()) {
+        ast_smt2_pp_stream(out, n, get_pp_env());
+        return;
+    }
     format_ns::format_ref f(format_ns::fm(m()));
     pp(n, num_vars, var_prefix, f, var_names);
     if (indent > 0)
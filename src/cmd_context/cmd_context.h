@@ -249,6 +249,7 @@ protected:
     static std::ostringstream    g_error_stream;
 
     generic_model_converter* mc0() { return m_mcs.back(); }
+    generic_model_converter* ensure_mc0();
     sref_vector<generic_model_converter> m_mcs;
     ast_manager *                m_manager;
     bool                         m_own_manager;
@@ -301,6 +302,17 @@ protected:
 
     stopwatch                    m_watch;
 
+    // overhead of scope and assertion commands, reported with the statistics.
+    struct stats {
+        unsigned  m_num_push = 0;
+        unsigned  m_num_pop = 0;
+        unsigned  m_num_assert = 0;
+        stopwatch m_push_watch;
+        stopwatch m_pop_watch;
+        stopwatch m_assert_watch;
+    };
+    stats                        m_stats;
+
     class dt_eh : public new_datatype_eh {
         cmd_context &             m_owner;
         datatype_util             m_dt_util;
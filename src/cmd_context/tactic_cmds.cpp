@@ -27,6 +27,7 @@ Notes:
 #include "ast/ast_smt2_pp.h"
 #include "tactic/tactic.h"
 #include "tactic/tactical.h"
+#include "params/tactic_params.hpp"
 #include "solver/check_sat_result.h"
 #include "cmd_context/cmd_context_to_goal.h"
 #include "cmd_context/echo_tactic.h"
@@ -144,6 +145,19 @@ public:
         t->collect_statistics(stats);
         stats.display_smt2(ctx.regular_stream());
     }
+
+    tactic * mk_tactic(cmd_context & ctx, params_ref const & p) {
+        tactic_params tp;
+        if (tp.profile())
+            reset_tactic_profile();
+        return using_params(mk_profiled(sexpr2tactic(ctx, m_tactic)), p);
+    }
+
+    void display_profile(cmd_context & ctx) {
+        tactic_params tp;
+        if (tp.profile())
+            display_tactic_profile(ctx.regular_stream());
+    }
 };
 
 struct check_sat_tactic_result : public simple_check_sat_result {
@@ -184,7 +198,7 @@ public:
         if (ctx.ignore_check())
             return;
         params_ref p = ctx.params().merge_default_params(ps());
-        tactic_ref tref = using_params(sexpr2tactic(ctx, m_tactic), p);
+        tactic_ref tref = mk_tactic(ctx, p);
         tref->set_logic(ctx.get_logic());
         ast_manager & m = ctx.m();
         unsigned timeout   = p.get_uint("timeout", ctx.params().m_timeout);
@@ -269,6 +283,7 @@ public:
 
         if (p.get_bool("print_statistics", false))
             display_statistics(ctx, tref.get());
+        display_profile(ctx);
     }
 };
 
@@ -297,7 +312,7 @@ public:
         if (ctx.ignore_check())
             return;
         params_ref p = ctx.params().merge_default_params(ps());
-        tactic_ref tref = using_params(sexpr2tactic(ctx, m_tactic), p);
+        tactic_ref tref = mk_tactic(ctx, p);
         {
             tactic & t = *(tref.get());
             ast_manager & m = ctx.m();
@@ -382,6 +397,7 @@ public:
 
             if (p.get_bool("print_statistics", false))
                 display_statistics(ctx, tref.get());
+            display_profile(ctx);
         }
     }
 };
@@ -396,7 +412,7 @@ void install_core_tactic_cmds(cmd_context & ctx) {
     ctx.insert(alloc(help_tactic_cmd));
     ctx.insert(alloc(check_sat_using_tactic_cmd));
     ctx.insert(alloc(apply_tactic_cmd));
-    install_tactics(ctx);
+    ctx.set_installer(install_tactics);
 }
 
 static tactic * mk_and_then(cmd_context & ctx, sexpr * n) {
@@ -36,7 +36,14 @@ void tactic_manager::finalize_tactic_manager() {
     m_name2probe.reset();
 }
 
+void tactic_manager::install() {
+    installer f = m_installer;
+    m_installer = nullptr;
+    f(*this);
+}
+
 void tactic_manager::insert(tactic_cmd * c) {
+    ensure_installed();
     symbol const & s = c->get_name();
     SASSERT(!m_name2tactic.contains(s));
     m_name2tactic.insert(s, c);
@@ -44,6 +51,7 @@ void tactic_manager::insert(tactic_cmd * c) {
 }
 
 void tactic_manager::insert(simplifier_cmd * c) {
+    ensure_installed();
     symbol const & s = c->get_name();
     SASSERT(!m_name2simplifier.contains(s));
     m_name2simplifier.insert(s, c);
@@ -51,6 +59,7 @@ void tactic_manager::insert(simplifier_cmd * c) {
 }
 
 void tactic_manager::insert(probe_info * p) {
+    ensure_installed();
     symbol const & s = p->get_name();
     SASSERT(!m_name2probe.contains(s));
     m_name2probe.insert(s, p);
@@ -58,18 +67,21 @@ void tactic_manager::insert(probe_info * p) {
 }
 
 tactic_cmd * tactic_manager::find_tactic_cmd(symbol const & s) const {
+    ensure_installed();
     tactic_cmd * c = nullptr;
     m_name2tactic.find(s, c);
     return c;
 }
 
 simplifier_cmd * tactic_manager::find_simplifier_cmd(symbol const & s) const {
+    ensure_installed();
     simplifier_cmd * c = nullptr;
     m_name2simplifier.find(s, c);
     return c;
 }
 
 probe_info * tactic_manager::find_probe(symbol const & s) const {
+    ensure_installed();
     probe_info * p = nullptr;
     m_name2probe.find(s, p);
     return p;
@@ -22,7 +22,10 @@ Notes:
 #include "util/dictionary.h"
 
 class tactic_manager {
+public:
+    typedef void (*installer)(tactic_manager & ctx);
 protected:
+    installer                m_installer = nullptr;
     dictionary<tactic_cmd*>  m_name2tactic;
     dictionary<probe_info*>  m_name2probe;
     dictionary<simplifier_cmd*> m_name2simplifier;
@@ -30,9 +33,21 @@ protected:
     ptr_vector<simplifier_cmd> m_simplifiers;
     ptr_vector<probe_info>   m_probes;
     void finalize_tactic_manager();
+
+    /**
+       \brief run the pending installer, if any. Built-in tactics, simplifiers and
+       probes are registered on the first lookup instead of when the context is created.
+    */
+    void ensure_installed() const {
+        if (m_installer)
+            const_cast<tactic_manager*>(this)->install();
+    }
+    void install();
 public:
     ~tactic_manager();
 
+    void set_installer(installer f) { m_installer = f; }
+
     void insert(tactic_cmd * c);
     void insert(simplifier_cmd* c);
     void insert(probe_info * p);
@@ -40,16 +55,16 @@ public:
     probe_info * find_probe(symbol const & s) const;     
     simplifier_cmd* find_simplifier_cmd(symbol const& s) const;
 
-    unsigned num_tactics() const { return m_tactics.size(); }
-    unsigned num_probes() const { return m_probes.size(); }
-    unsigned num_simplifiers() const { return m_simplifiers.size(); }
-    tactic_cmd * get_tactic(unsigned i) const { return m_tactics[i]; }
-    probe_info * get_probe(unsigned i) const { return m_probes[i]; }
-    simplifier_cmd *get_simplifier(unsigned i) const { return m_simplifiers[i]; }
+    unsigned num_tactics() const { ensure_installed(); return m_tactics.size(); }
+    unsigned num_probes() const { ensure_installed(); return m_probes.size(); }
+    unsigned num_simplifiers() const { ensure_installed(); return m_simplifiers.size(); }
+    tactic_cmd * get_tactic(unsigned i) const { ensure_installed(); return m_tactics[i]; }
+    probe_info * get_probe(unsigned i) const { ensure_installed(); return m_probes[i]; }
+    simplifier_cmd *get_simplifier(unsigned i) const { ensure_installed(); return m_simplifiers[i]; }
 
-    ptr_vector<simplifier_cmd> const& simplifiers() const { return m_simplifiers; }
-    ptr_vector<tactic_cmd> const& tactics() const { return m_tactics; }
-    ptr_vector<probe_info> const& probes() const { return m_probes; }
+    ptr_vector<simplifier_cmd> const& simplifiers() const { ensure_installed(); return m_simplifiers; }
+    ptr_vector<tactic_cmd> const& tactics() const { ensure_installed(); return m_tactics; }
+    ptr_vector<probe_info> const& probes() const { ensure_installed(); return m_probes; }
     
         
 };
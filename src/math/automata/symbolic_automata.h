@@ -63,6 +63,10 @@ class symbolic_automata {
             m_rep = 0;
         }
 
+        block(block const& b) = default;
+
+        block(block&& b) noexcept = default;
+
         block& operator=(block const& b) {
             m_set = b.m_set;
             m_rep = 0;
@@ -104,7 +108,15 @@ public:
     automaton_t* mk_difference(automaton_t& a, automaton_t& b);
     automaton_t* mk_product(automaton_t& a, automaton_t& b);
 
+    // emptiness checks that explore the product on the fly.
+    // l_true if the product is empty, l_false if a word is accepted, l_undef if the
+    // Boolean algebra could not decide a guard.
+    lbool is_product_empty(automaton_t& a, automaton_t& b);
+    // l_true if the language of a is contained in the language of b.
+    lbool is_difference_empty(automaton_t& a, automaton_t& b);
+
 private:
+    bool is_init_final(automaton_t& a);
     automaton_t* mk_determinstic_param(automaton_t& a, bool flip_acceptance);
     
     vector<std::pair<vector<bool>, ref_t> > generate_min_terms(vector<ref_t> &constraints) {
@@ -54,7 +54,11 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_total
     }
     new_mvs.push_back(move_t(m, dead_state, dead_state, m_ba.mk_true()));
 
-    // TBD private: automaton_t::append_moves(0, a, new_mvs);
+    for (unsigned i = 0; i < dead_state; ++i) {
+        for (move_t const& mv : a.get_moves_from(i)) {
+            new_mvs.push_back(mv);
+        }
+    }
     
     return alloc(automaton_t, m, a.init(), a.final_states(), new_mvs);        
 }
@@ -80,10 +84,10 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_minim
 
 template<class T, class M>
 void symbolic_automata<T, M>::add_block(block const& p1, unsigned p0_index, unsigned_vector& blocks, vector<block>& pblocks, unsigned_vector& W) {
-    block& p0 = pblocks[p0_index];
-    if (p1.size() < p0.size()) {
+    if (p1.size() < pblocks[p0_index].size()) {
         unsigned p1_index = pblocks.size();
         pblocks.push_back(p1);
+        block& p0 = pblocks[p0_index];
         for (uint_set::iterator it = p1.begin(), end = p1.end(); it != end; ++it) {
             p0.remove(*it);
             blocks[*it] = p1_index;
@@ -122,7 +126,13 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_minim
         
     refs_t trail(m);
     u_map<T*> gamma;
-    moves_t mvs;
+    // gamma maps a state to the guard of its moves into the splitter R.
+    // States without moves into R, which may share a block with states
+    // that have them, move into R on no character.
+    auto gamma_of = [&](unsigned q) {
+        T* t = nullptr;
+        return gamma.find(q, t) ? t : m_ba.mk_false();
+    };
     while (!W.empty()) {
         block R(pblocks[W.back()]);
         W.pop_back();
@@ -130,11 +140,11 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_minim
         uint_set::iterator it = R.begin(), end = R.end();
         for (; it != end; ++it) {
             unsigned dst = *it;
-            mvs.reset();
-            a.get_moves_to(dst, mvs);
+            // a has no epsilon moves: use the stored moves into dst, which keep their sources.
+            typename automaton_t::moves const& mvs = a.get_moves_to(dst);
             for (unsigned i = 0; i < mvs.size(); ++i) {
                 unsigned src = mvs[i].src();
-                if (pblocks[src].size() > 1) {
+                if (pblocks[blocks[src]].size() > 1) {
                     T* t = mvs[i].t();
                     T* t1;
                     if (gamma.find(src, t1)) {
@@ -178,11 +188,11 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_minim
                     block p1;
                     p1.insert(*bi);
                     bool split_found = false;
-                    ref_t psi(gamma[*bi], m); 
+                    ref_t psi(gamma_of(*bi), m);
                     ++bi;
                     for (; bi != be; ++bi) {
                         unsigned q = *bi;
-                        ref_t phi(gamma[q], m);
+                        ref_t phi(gamma_of(q), m);
                         if (split_found) {
                             ref_t phi_and_psi(m_ba.mk_and(phi, psi), m);
                             switch (m_ba.is_sat(phi_and_psi)) {
@@ -275,7 +285,7 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_minim
 
 template<class T, class M>
 typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_determinstic(automaton_t& a) {
-    return mk_determinstic_param(a);
+    return mk_determinstic_param(a, false);
 }
 
 template<class T, class M>
@@ -485,6 +495,155 @@ typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_produ
 
 template<class T, class M>
 typename symbolic_automata<T, M>::automaton_t* symbolic_automata<T, M>::mk_difference(automaton_t& a, automaton_t& b) {
-    return mk_product(a,mk_complement(b));
+    scoped_ptr<automaton_t> c = mk_complement(b);
+    if (!c) {
+        return nullptr;
+    }
+    return mk_product(a, *c);
+}
+
+template<class T, class M>
+bool symbolic_automata<T, M>::is_init_final(automaton_t& a) {
+    unsigned_vector init;
+    a.get_epsilon_closure(a.init(), init);
+    for (unsigned s : init) {
+        if (a.is_final_state(s)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+   \brief check emptiness of the intersection of a and b without building the product.
+   Pairs of states are explored depth first from the initial pair and the search
+   stops at the first pair of final states.
+*/
+template<class T, class M>
+lbool symbolic_automata<T, M>::is_product_empty(automaton_t& a, automaton_t& b) {
+    if (a.is_empty() || b.is_empty()) {
+        return l_true;
+    }
+    if (is_init_final(a) && is_init_final(b)) {
+        return l_false;
+    }
+    u2_map<unsigned> visited;
+    svector<unsigned_pair> todo;
+    unsigned_pair init_pair(a.init(), b.init());
+    todo.push_back(init_pair);
+    visited.insert(init_pair, 0);
+    moves_t mvsA, mvsB;
+    while (!todo.empty()) {
+        unsigned_pair curr_pair = todo.back();
+        todo.pop_back();
+        mvsA.reset(); mvsB.reset();
+        a.get_moves_from(curr_pair.first,  mvsA, true);
+        if (mvsA.empty()) {
+            continue;
+        }
+        b.get_moves_from(curr_pair.second, mvsB, true);
+        for (move_t const& mvA : mvsA) {
+            for (move_t const& mvB : mvsB) {
+                unsigned_pair tgt_pair(mvA.dst(), mvB.dst());
+                if (visited.contains(tgt_pair)) {
+                    continue;
+                }
+                ref_t ab(m_ba.mk_and(mvA.t(), mvB.t()), m);
+                lbool is_sat = m_ba.is_sat(ab);
+                if (is_sat == l_false) {
+                    continue;
+                }
+                if (is_sat == l_undef) {
+                    return l_undef;
+                }
+                if (a.is_final_state(tgt_pair.first) && b.is_final_state(tgt_pair.second)) {
+                    return l_false;
+                }
+                visited.insert(tgt_pair, 0);
+                todo.push_back(tgt_pair);
+            }
+        }
+    }
+    return l_true;
+}
+
+/**
+   \brief check whether the language of a is contained in the language of b.
+   The complement of b is determinized on the fly: the search visits pairs of a state
+   of a and a set of states of b, and a move of a is split into the min-terms of the
+   moves of b it overlaps. Only the subsets of states of b that are reachable together
+   with a state of a are constructed.
+*/
+template<class T, class M>
+lbool symbolic_automata<T, M>::is_difference_empty(automaton_t& a, automaton_t& b) {
+    if (a.is_empty()) {
+        return l_true;
+    }
+    map<uint_set, unsigned, uint_set::hash, uint_set::eq> s2id;
+    vector<uint_set> id2s;
+    uint_set set;
+    unsigned_vector init_states;
+    b.get_epsilon_closure(b.init(), init_states);
+    for (unsigned s : init_states) {
+        set.insert(s);
+    }
+    if (is_init_final(a) && !b.is_final_configuration(set)) {
+        return l_false;
+    }
+    s2id.insert(set, 0);
+    id2s.push_back(set);
+
+    u2_map<unsigned> visited;
+    svector<unsigned_pair> todo;
+    unsigned_pair init_pair(a.init(), 0);
+    todo.push_back(init_pair);
+    visited.insert(init_pair, 0);
+    moves_t mvsA, mvsB;
+    vector<ref_t> predicates;
+    vector<std::pair<vector<bool>, ref_t> > min_terms;
+    vector<bool> curr_bv;
+    while (!todo.empty()) {
+        unsigned_pair curr_pair = todo.back();
+        todo.pop_back();
+        mvsA.reset(); mvsB.reset();
+        a.get_moves_from(curr_pair.first, mvsA, true);
+        if (mvsA.empty()) {
+            continue;
+        }
+        b.get_moves_from_states(id2s[curr_pair.second], mvsB);
+        predicates.reset();
+        for (move_t const& mvB : mvsB) {
+            predicates.push_back(ref_t(mvB.t(), m));
+        }
+        for (move_t const& mvA : mvsA) {
+            min_terms.reset();
+            ref_t guard(mvA.t(), m);
+            generate_min_terms_rec(predicates, min_terms, 0, curr_bv, guard);
+            for (auto const& mt : min_terms) {
+                set.reset();
+                for (unsigned i = 0; i < mvsB.size(); ++i) {
+                    if (mt.first[i]) {
+                        set.insert(mvsB[i].dst());
+                    }
+                }
+                unsigned id;
+                if (!s2id.find(set, id)) {
+                    id = id2s.size();
+                    s2id.insert(set, id);
+                    id2s.push_back(set);
+                }
+                unsigned_pair tgt_pair(mvA.dst(), id);
+                if (visited.contains(tgt_pair)) {
+                    continue;
+                }
+                if (a.is_final_state(tgt_pair.first) && !b.is_final_configuration(set)) {
+                    return l_false;
+                }
+                visited.insert(tgt_pair, 0);
+                todo.push_back(tgt_pair);
+            }
+        }
+    }
+    return l_true;
 }
 
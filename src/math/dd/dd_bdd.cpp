@@ -111,6 +111,7 @@ namespace dd {
     bool bdd_manager::check_result(op_entry*& e1, op_entry const* e2, BDD a, BDD b, BDD c) {
         if (e1 != e2) {
             SASSERT(e2->m_result != null_bdd);
+            ++m_stats.m_cache_hits;
             push_entry(e1);
             e1 = nullptr;
             return true;            
@@ -120,6 +121,7 @@ namespace dd {
             e1->m_bdd2 = b;
             e1->m_op = c;
             SASSERT(e1->m_result == null_bdd);
+            ++m_stats.m_cache_misses;
             return false;        
         }
     }
@@ -264,6 +266,7 @@ namespace dd {
     }    
 
     void bdd_manager::try_reorder() {
+        ++m_stats.m_num_reorder;
         gc();        
         for (auto* e : m_op_cache) {
             m_alloc.deallocate(sizeof(*e), e);
@@ -805,7 +808,15 @@ namespace dd {
         m_free_nodes.reverse();
     }
 
+    /**
+       Cached results survive gc as long as their arguments and result are
+       live and the cache pays off: when fewer than 1/cache_min_hit_ratio of
+       the lookups since the previous gc were hits, all completed entries
+       are flushed so that the cache does not grow with the node table.
+    */
     void bdd_manager::gc() {
+        ++m_stats.m_num_gc;
+        m_stats.m_max_nodes = std::max(m_stats.m_max_nodes, m_nodes.size());
         m_free_nodes.reset();
         IF_VERBOSE(13, verbose_stream() << "(bdd :gc " << m_nodes.size() << ")\n";);
         bool_vector reachable(m_nodes.size(), false);
@@ -844,22 +855,25 @@ namespace dd {
         std::sort(m_free_nodes.begin(), m_free_nodes.end());
         m_free_nodes.reverse();
 
-        ptr_vector<op_entry> to_delete, to_keep;
+        unsigned hits = m_stats.m_cache_hits - m_gc_hits;
+        unsigned misses = m_stats.m_cache_misses - m_gc_misses;
+        m_gc_hits = m_stats.m_cache_hits;
+        m_gc_misses = m_stats.m_cache_misses;
+        bool flush = (uint64_t)hits * cache_min_hit_ratio < (uint64_t)hits + misses;
+        if (flush)
+            ++m_stats.m_cache_flushes;
+        auto is_live = [&](BDD b) { return b <= bdd_no_op + 2 || reachable[b]; };
+        ptr_vector<op_entry> to_delete;
         for (auto* e : m_op_cache) {            
-            if (e->m_result != null_bdd) {
+            if (e->m_result == null_bdd)
+                continue;
+            if (flush || !is_live(e->m_bdd1) || !is_live(e->m_bdd2) || !is_live(e->m_op) || !is_live(e->m_result))
                 to_delete.push_back(e);
-            }
-            else {
-                to_keep.push_back(e);
-            }
         }
-        m_op_cache.reset();
         for (op_entry* e : to_delete) {
+            m_op_cache.remove(e);
             m_alloc.deallocate(sizeof(*e), e);
         }
-        for (op_entry* e : to_keep) {
-            m_op_cache.insert(e);
-        }
 
         m_node_table.reset();
         // re-populate node cache
@@ -872,6 +886,17 @@ namespace dd {
         SASSERT(well_formed());
     }
 
+    void bdd_manager::collect_statistics(statistics& st) const {
+        st.update("bdd cache hits", m_stats.m_cache_hits);
+        st.update("bdd cache misses", m_stats.m_cache_misses);
+        st.update("bdd cache flushes", m_stats.m_cache_flushes);
+        st.update("bdd cache size", m_op_cache.size());
+        st.update("bdd gc", m_stats.m_num_gc);
+        st.update("bdd reorder", m_stats.m_num_reorder);
+        st.update("bdd max nodes", std::max(m_stats.m_max_nodes, m_nodes.size()));
+        st.update("bdd live nodes", m_nodes.size() - m_free_nodes.size());
+    }
+
     void bdd_manager::init_mark() {
         m_mark.resize(m_nodes.size());
         ++m_mark_level;
@@ -22,6 +22,7 @@ Revision History:
 #include "util/map.h"
 #include "util/small_object_allocator.h"
 #include "util/rational.h"
+#include "util/statistics.h"
 
 namespace dd {
 
@@ -107,12 +108,25 @@ namespace dd {
 
         struct eq_entry {
             bool operator()(op_entry * a, op_entry * b) const { 
-                return a->m_bdd1 == b->m_bdd2 && a->m_bdd2 == b->m_bdd2 && a->m_op == b->m_op;
+                return a->m_bdd1 == b->m_bdd1 && a->m_bdd2 == b->m_bdd2 && a->m_op == b->m_op;
             }
         };
 
         typedef ptr_hashtable<op_entry, hash_entry, eq_entry> op_table;
 
+        struct stats {
+            unsigned m_cache_hits = 0;
+            unsigned m_cache_misses = 0;
+            unsigned m_cache_flushes = 0;
+            unsigned m_num_gc = 0;
+            unsigned m_num_reorder = 0;
+            unsigned m_max_nodes = 0;
+        };
+
+        // gc keeps the live entries of the op cache while the share of lookups
+        // that hit since the previous gc is at least 1/cache_min_hit_ratio.
+        static const unsigned cache_min_hit_ratio = 8;
+
         svector<bdd_node>          m_nodes;
         op_table                   m_op_cache;
         node_table                 m_node_table;
@@ -135,6 +149,9 @@ namespace dd {
         unsigned_vector            m_reorder_rc;
         cost_metric                m_cost_metric;
         BDD                        m_cost_bdd;
+        stats                      m_stats;
+        unsigned                   m_gc_hits = 0;      // cache hits, misses at the last gc
+        unsigned                   m_gc_misses = 0;
 
         BDD make_node(unsigned level, BDD l, BDD r);
         bool is_new_node() const { return m_is_new_node; }
@@ -269,6 +286,8 @@ namespace dd {
         void gc();
         void try_reorder();
         void try_cnf_reorder(bdd const& b);
+
+        void collect_statistics(statistics& st) const;
     };
 
     class bdd {
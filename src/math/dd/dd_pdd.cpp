@@ -1613,6 +1613,13 @@ namespace dd {
         }
     }
 
+    /**
+       The unique table and the operation cache survive garbage collection:
+       dead nodes are removed from the node table one by one, and cached
+       results whose arguments and result are still reachable are kept.
+       Rebuilding both for every collection is quadratic when the set of
+       long-lived nodes is large compared to the nodes that die.
+    */
     void pdd_manager::gc() {
         init_dmark();
         m_free_nodes.reset();
@@ -1628,6 +1635,8 @@ namespace dd {
                     m_free_values.push_back(m_mpq_table.find(val(i)).m_value_index);
                     m_mpq_table.remove(val(i));  
                 }
+                if (!m_nodes[i].is_internal())
+                    m_node_table.remove(m_nodes[i]);
                 m_nodes[i].set_internal();
                 SASSERT(m_nodes[i].m_refcount == 0);
                 m_free_nodes.push_back(i);       
@@ -1637,30 +1646,19 @@ namespace dd {
         std::sort(m_free_nodes.begin(), m_free_nodes.end());
         m_free_nodes.reverse();
 
-        ptr_vector<op_entry> to_delete, to_keep;
+        ptr_vector<op_entry> to_delete;
         for (auto* e : m_op_cache) {            
-            if (e->m_result != null_pdd)
+            if (e->m_result != null_pdd &&
+                !(reachable[e->m_pdd1] && reachable[e->m_pdd2] && reachable[e->m_result]))
                 to_delete.push_back(e);            
-            else 
-                to_keep.push_back(e);            
         }
-        m_op_cache.reset();
-        for (op_entry* e : to_delete) 
+        for (op_entry* e : to_delete) {
+            m_op_cache.remove(e);
             m_alloc.deallocate(sizeof(*e), e);
-        
-        for (op_entry* e : to_keep) 
-            m_op_cache.insert(e);        
+        }
 
         m_factor_cache.reset();
 
-        m_node_table.reset();
-        // re-populate node cache
-        for (unsigned i = m_nodes.size(); i-- > 2; ) {
-            if (reachable[i]) {
-                SASSERT(m_nodes[i].m_index == i);
-                m_node_table.insert(m_nodes[i]);
-            }
-        }
         SASSERT(well_formed());
     }
 
@@ -113,7 +113,9 @@ namespace dd {
             }
         };
         
-        typedef hashtable<node, hash_node, eq_node> node_table;
+        // gc removes dead nodes one by one; backward-shift deletion keeps
+        // the table free of tombstones.
+        typedef core_hashtable<default_hash_entry<node>, hash_node, eq_node, true> node_table;
 
         struct const_info {
             unsigned m_value_index;
@@ -143,7 +145,7 @@ namespace dd {
 
         struct eq_entry {
             bool operator()(op_entry * a, op_entry * b) const { 
-                return a->m_pdd1 == b->m_pdd2 && a->m_pdd2 == b->m_pdd2 && a->m_op == b->m_op;
+                return a->m_pdd1 == b->m_pdd1 && a->m_pdd2 == b->m_pdd2 && a->m_op == b->m_op;
             }
         };
 
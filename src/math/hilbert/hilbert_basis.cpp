@@ -838,10 +838,7 @@ lbool hilbert_basis::saturate_orig(num_vector const& ineq, bool is_eq) {
     for (; it != end(); ++it) {
         offset_t idx = *it;
         values v = vec(idx);
-        v.weight() = get_weight(v, ineq);
-        for (unsigned k = 0; k < m_current_ineq; ++k) {
-            v.weight(k) = get_weight(v, m_ineqs[k]);        
-        }
+        update_weights(v, ineq);
         add_goal(idx);
         if (m_use_support) {
             support.insert(idx.m_offset);
@@ -911,10 +908,7 @@ lbool hilbert_basis::saturate(num_vector const& ineq, bool is_eq) {
     for (unsigned i = 0; i < m_basis.size(); ++i) {
         offset_t idx = m_basis[i];
         values v = vec(idx);
-        v.weight() = get_weight(v, ineq);
-        for (unsigned k = 0; k < m_current_ineq; ++k) {
-            v.weight(k) = get_weight(v, m_ineqs[k]);        
-        }
+        update_weights(v, ineq);
         m_index->insert(idx, v);
         if (v.weight().is_zero()) {
             m_zero.push_back(idx);
@@ -1172,6 +1166,31 @@ hilbert_basis::sign_t hilbert_basis::get_sign(offset_t idx) const {
     return zero;
 }
 
+/**
+   \brief set the weights of a basis vector before saturating with 'ineq'.
+
+   The weights for the inequalities before m_current_ineq - 1 are up to date:
+   select_inequality only permutes the remaining inequalities, and resolve
+   maintains the weights as sums. The weight for the previous inequality is
+   the current weight, so only the weight for 'ineq' is evaluated.
+*/
+void hilbert_basis::update_weights(values& v, num_vector const& ineq) const {
+    if (m_current_ineq > 0) {
+        v.weight(m_current_ineq - 1) = v.weight();
+    }
+    v.weight() = get_weight(v, ineq);
+    SASSERT(weights_are_valid(v));
+}
+
+bool hilbert_basis::weights_are_valid(values const& v) const {
+    for (unsigned k = 0; k < m_current_ineq; ++k) {
+        if (v.weight(k) != get_weight(v, m_ineqs[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 hilbert_basis::numeral hilbert_basis::get_weight(values const & val, num_vector const& ineq) const {
     numeral result(0);
     unsigned num_vars = get_num_vars();
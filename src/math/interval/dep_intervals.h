@@ -20,6 +20,7 @@
   --*/
 
 #pragma once
+#include "util/buffer.h"
 #include "util/dependency.h"
 #include "util/region.h"
 #include "util/rational.h"
@@ -343,7 +344,7 @@ public:
 
     template <typename T> 
     void linearize(u_dependency* dep, T& expl) const {
-        vector<unsigned, false> v;
+        sbuffer<unsigned> v;
         m_dep_manager.linearize(dep, v);
         for (auto ci: v)
             expl.push_back(ci);
@@ -479,10 +479,73 @@ public:
         return ret;
     }
 
+    /**
+       \brief efficacy of the cut t >= k: the distance by which the current
+       solution violates it, relative to the norm of t.
+    */
+    double gomory::cut_efficacy(lar_term const& t, mpq const& k) {
+        double val = 0, norm = 0;
+        for (lar_term::ival p : t) {
+            double c = p.coeff().get_double();
+            val += c * lra.get_column_value(p.j()).x.get_double();
+            norm += c * c;
+        }
+        if (norm == 0)
+            return 0;
+        return (k.get_double() - val) / std::sqrt(norm);
+    }
+
+    /**
+       \brief cosine of the angle between the normals of two cuts.
+    */
+    static double cut_parallelism(lar_term const& t1, lar_term const& t2) {
+        u_map<double> coeffs;
+        double n1 = 0, n2 = 0, dot = 0;
+        for (lar_term::ival p : t1) {
+            double c = p.coeff().get_double();
+            coeffs.insert(p.j(), c);
+            n1 += c * c;
+        }
+        for (lar_term::ival p : t2) {
+            double c = p.coeff().get_double(), c1 = 0;
+            n2 += c * c;
+            if (coeffs.find(p.j(), c1))
+                dot += c * c1;
+        }
+        if (n1 == 0 || n2 == 0)
+            return 0;
+        return std::abs(dot) / std::sqrt(n1 * n2);
+    }
+
+    /**
+       \brief keep at most num_cuts candidates: greedily by decreasing efficacy,
+       skipping cuts that are nearly parallel to a cut that was already kept.
+    */
+    void gomory::select_cuts(vector<cut_candidate>& cuts, unsigned num_cuts) {
+        const double max_parallelism = 0.95;
+        for (auto& c : cuts)
+            c.m_efficacy = cut_efficacy(c.m_t, c.m_k);
+        std::stable_sort(cuts.begin(), cuts.end(), [](cut_candidate const& a, cut_candidate const& b) {
+            return a.m_efficacy > b.m_efficacy;
+        });
+        vector<cut_candidate> selected;
+        for (auto& c : cuts) {
+            if (selected.size() >= num_cuts)
+                break;
+            if (any_of(selected, [&](cut_candidate const& s) { return cut_parallelism(s.m_t, c.m_t) > max_parallelism; }))
+                continue;
+            selected.push_back(c);
+        }
+        TRACE("gomory_cut", tout << "selected " << selected.size() << " of " << cuts.size() << " cuts\n";);
+        cuts.swap(selected);
+    }
+
     lia_move gomory::get_gomory_cuts(unsigned num_cuts) {
         struct cut_result {lar_term t; mpq k; u_dependency *dep;};
         vector<cut_result> big_cuts;
-        unsigned_vector columns_for_cuts = gomory_select_int_infeasible_vars(num_cuts);
+        unsigned oversample = std::max(1u, lia.settings().gomory_oversample());
+        unsigned_vector columns_for_cuts = gomory_select_int_infeasible_vars(num_cuts * oversample);
+        vector<cut_candidate> cuts;
         bool has_small_cut = false;
 
         // define inline helper functions
@@ -520,12 +583,21 @@ public:
             else if (cc.m_polarity == row_polarity::MIN)
                 lra.update_column_type_and_bound(j, lp::lconstraint_kind::GE, ceil(lra.get_column_value(j).x), add_deps(cc.m_dep, row, j));
             
-            if (!is_small_cut(lia.m_t)) {
-                big_cuts.push_back({cc.m_t, cc.m_k, cc.m_dep});
+            cuts.push_back({cc.m_t, cc.m_k, cc.m_dep, 0});
+            if (lia.settings().get_cancel_flag())
+                return lia_move::cancelled;
+        }
+
+        if (cuts.size() > num_cuts)
+            select_cuts(cuts, num_cuts);
+
+        for (auto const& c : cuts) {
+            if (!is_small_cut(c.m_t)) {
+                big_cuts.push_back({c.m_t, c.m_k, c.m_dep});
                 continue;
             }
             has_small_cut = true;
-            add_cut(cc.m_t, cc.m_k, cc.m_dep);
+            add_cut(c.m_t, c.m_k, c.m_dep);
             if (lia.settings().get_cancel_flag())
                 return lia_move::cancelled;
         }
@@ -27,7 +27,15 @@ namespace lp {
     class gomory {
         class int_solver& lia;
         class lar_solver& lra;
+        struct cut_candidate {
+            lar_term      m_t;
+            mpq           m_k;
+            u_dependency* m_dep;
+            double        m_efficacy;
+        };
         unsigned_vector gomory_select_int_infeasible_vars(unsigned num_cuts);
+        double cut_efficacy(lar_term const& t, mpq const& k);
+        void select_cuts(vector<cut_candidate>& cuts, unsigned num_cuts);
         bool is_gomory_cut_target(lpvar j); 
         u_dependency* add_deps(u_dependency*, const row_strip<mpq>&, lpvar);
     public:
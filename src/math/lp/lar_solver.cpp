@@ -174,7 +174,7 @@ namespace lp {
 
     void lar_solver::fill_explanation_from_crossed_bounds_column(explanation& evidence) const {
         // this is the case when the lower bound is in conflict with the upper one
-        svector<constraint_index> deps;
+        sbuffer<constraint_index> deps;
         SASSERT(m_crossed_bounds_deps != nullptr);
         m_dependencies.linearize(m_crossed_bounds_deps, deps);
         for (auto d : deps)
@@ -997,7 +997,7 @@ namespace lp {
             const column& ul = m_columns[j];
 
             u_dependency* bound_constr_i = adj_sign < 0 ? ul.upper_bound_witness() : ul.lower_bound_witness();
-            svector<constraint_index> deps;
+            sbuffer<constraint_index> deps;
             m_dependencies.linearize(bound_constr_i, deps);
             for (auto d : deps) {
                 lp_assert(m_constraints.valid_index(d));
@@ -103,6 +103,7 @@ namespace lp_api {
         unsigned m_conflicts;
         unsigned m_bound_propagations1;
         unsigned m_bound_propagations2;
+        unsigned m_bound_propagations_batched;
         unsigned m_assert_diseq;
         unsigned m_assert_eq;
         unsigned m_gomory_cuts;
@@ -124,6 +125,7 @@ namespace lp_api {
             st.update("arith-conflicts", m_conflicts);
             st.update("arith-bound-propagations-lp", m_bound_propagations1);
             st.update("arith-bound-propagations-cheap", m_bound_propagations2);
+            st.update("arith-bound-propagations-batched", m_bound_propagations_batched);
             st.update("arith-diseq", m_assert_diseq);
             st.update("arith-eq",    m_assert_eq);
             st.update("arith-gomory-cuts", m_gomory_cuts);
@@ -22,6 +22,7 @@ Revision History:
 #include <set>
 #include <string>
 #include "util/vector.h"
+#include "util/perf_counters.h"
 #include "math/lp/lp_utils.h"
 #include "math/lp/lp_core_solver_base.h"
 namespace lp {
@@ -253,6 +254,7 @@ divide_row_by_pivot(unsigned pivot_row, unsigned pivot_col) {
 }
 template <typename T, typename X> bool lp_core_solver_base<T, X>::
 pivot_column_tableau(unsigned j, unsigned piv_row_index) {
+    perf_counters::scope _pc(perf_counters::lp_pivot);
 	if (!divide_row_by_pivot(piv_row_index, j))
         return false;
     auto &column = m_A.m_columns[j];
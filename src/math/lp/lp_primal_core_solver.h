@@ -50,6 +50,10 @@ namespace lp {
         unsigned m_bland_mode_threshold;
         unsigned m_left_basis_repeated;
         vector<unsigned> m_leaving_candidates;
+        // dual steepest edge weights of the tableau rows, valid if the stamp of the row is m_dse_epoch.
+        svector<double>   m_dse_weights;
+        svector<unsigned> m_dse_stamps;
+        unsigned          m_dse_epoch = 0;
 
         std::list<unsigned> m_non_basis_list;
         void sort_non_basis();
@@ -237,6 +241,61 @@ namespace lp {
 
     int find_leaving_and_t_tableau(unsigned entering, X &t);
 
+    /**
+       \brief floating point lower bound on the ratio for one bound b of column j.
+       diff is b - x in the direction of movement. If the bound only limits
+       theta when x is beyond it, \c only_if_beyond is set and the bound is
+       ignored when x is certainly on the near side.
+    */
+    static void approx_bound_ratio(double b, double x, double abs_m, bool only_if_beyond, double & r) {
+        const double eps = 1e-9;
+        double diff = b - x;
+        double err = eps * (std::abs(b) + std::abs(x));
+        if (only_if_beyond && diff <= -err)
+            return;
+        double lo = std::max(0.0, diff - err) / abs_m * (1 - eps);
+        r = std::min(r, lo);
+    }
+
+    /**
+       \brief return true if limit_theta_on_basis_column(j, m, ratio, unlimited) certainly
+       leaves theta unlimited or produces a ratio larger than t.
+       Every limiting ratio is 0 or (b - x) / m for a bound b on the side of
+       the movement, so the minimum of these estimates, lowered by the
+       rounding error, bounds it from below independently of the case
+       analysis. Only the rational part of the values is compared.
+    */
+    bool ratio_exceeds(unsigned j, const T & m, double t) const {
+        double am = approx_value(m);
+        double x = approx_value(this->m_x[j]);
+        double r = std::numeric_limits<double>::infinity();
+        bool pos = am > 0;
+        auto add_bound = [&](X const& b, bool forward) {
+            double bv = approx_value(b);
+            if (pos)
+                approx_bound_ratio(bv, x, am, !forward, r);
+            else
+                approx_bound_ratio(x, bv, -am, !forward, r);
+        };
+        switch (this->m_column_types[j]) {
+        case column_type::free_column:
+            break;
+        case column_type::lower_bound:
+            add_bound(this->m_lower_bounds[j], !pos);
+            break;
+        case column_type::upper_bound:
+            add_bound(this->m_upper_bounds[j], pos);
+            break;
+        default:
+            add_bound(this->m_lower_bounds[j], !pos);
+            add_bound(this->m_upper_bounds[j], pos);
+            break;
+        }
+        if (std::isnan(r) || !std::isfinite(x) || !std::isfinite(am) || am == 0)
+            return false;
+        return r > t + 1e-9 * std::abs(t);
+    }
+
     void limit_theta(const X &lim, X &theta, bool &unlimited) {
         if (unlimited) {
             theta = lim;
@@ -345,6 +404,68 @@ namespace lp {
         return this->inf_heap().min_value();
     }
 
+    static double approx_value(mpq const& a) { return a.get_double(); }
+    static double approx_value(numeric_pair<mpq> const& a) { return a.x.get_double(); }
+
+    /**
+       \brief squared norm of tableau row i, the dual steepest edge weight of its basic variable.
+    */
+    double dse_weight(unsigned i) {
+        if (i >= m_dse_weights.size()) {
+            m_dse_weights.resize(i + 1, 0);
+            m_dse_stamps.resize(i + 1, 0);
+        }
+        if (m_dse_stamps[i] != m_dse_epoch) {
+            double w = 0;
+            for (const row_cell<T> &rc : this->m_A.m_rows[i]) {
+                double c = approx_value(rc.coeff());
+                w += c * c;
+            }
+            m_dse_weights[i] = w;
+            m_dse_stamps[i] = m_dse_epoch;
+        }
+        return m_dse_weights[i];
+    }
+
+    void invalidate_dse_weights(unsigned entering) {
+        for (const auto &c : this->m_A.m_columns[entering])
+            if (c.var() < m_dse_stamps.size())
+                m_dse_stamps[c.var()] = m_dse_epoch - 1;
+    }
+
+    /**
+       \brief dual steepest edge pricing: among the first infeasible basic columns
+       in the heap, pick the one with the largest squared infeasibility relative to
+       the weight of its row. Columns whose infeasibility is only in the
+       infinitesimal part are scored as if it was tiny, and ties keep the smaller index.
+    */
+    int find_dse_leaving_column() {
+        const unsigned max_candidates = 64;
+        int best = -1;
+        double best_score = -1;
+        unsigned n = 0;
+        for (int j : this->inf_heap()) {
+            if (++n > max_candidates)
+                break;
+            double d = std::abs(approx_value(this->m_x[j]) - approx_value(get_val_for_leaving(j)));
+            if (!std::isfinite(d))
+                return find_smallest_inf_column();
+            double w = dse_weight(this->m_basis_heading[j]);
+            double score = (d * d + 1e-30) / std::max(w, 1e-30);
+            if (score > best_score || (score == best_score && j < best)) {
+                best_score = score;
+                best = j;
+            }
+        }
+        return best;
+    }
+
+    int find_leaving_column_tableau_rows() {
+        if (!m_bland_mode_tableau && this->m_settings.dual_steepest_edge())
+            return find_dse_leaving_column();
+        return find_smallest_inf_column();
+    }
+
     const X &get_val_for_leaving(unsigned j) const {
         lp_assert(!this->column_is_feasible(j));
         switch (this->m_column_types[j]) {
@@ -367,7 +488,7 @@ namespace lp {
     }
 
     void one_iteration_tableau_rows() {
-        int leaving = find_smallest_inf_column();
+        int leaving = find_leaving_column_tableau_rows();
         if (leaving == -1) {
             this->set_status(lp_status::OPTIMAL);
             return;
@@ -397,8 +518,9 @@ namespace lp {
         TRACE("lar_solver_feas", tout << "entering = " << entering << ", leaving = " << leaving << ", new_val_for_leaving = " << new_val_for_leaving << ", theta = " << theta << "\n";);
         TRACE("lar_solver_feas", tout << "leaving = " << leaving
                                  << " removed from inf_heap()\n";);
-        // this will remove the leaving from the heap
-        this->inf_heap().erase_min();
+        this->inf_heap().erase(leaving);
+        if (this->m_settings.dual_steepest_edge())
+            invalidate_dse_weights(entering);
         advance_on_entering_and_leaving_tableau_rows(entering, leaving, theta);
         if (this->current_x_is_feasible())
             this->set_status(lp_status::OPTIMAL);
@@ -630,6 +752,8 @@ namespace lp {
     bool update_basis_and_x_tableau(int entering, int leaving, X const &tt);
     void init_reduced_costs_tableau();
     void init_tableau_rows() {
+        // row weights from earlier runs may refer to rows that changed since
+        m_dse_epoch += 2;
         m_bland_mode_tableau = false;
         m_left_basis_tableau.reset();
         m_left_basis_repeated = 0;
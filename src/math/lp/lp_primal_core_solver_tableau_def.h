@@ -221,18 +221,26 @@ template <typename T, typename X> int lp_primal_core_solver<T, X>::find_leaving_
     }
 
     X ratio;
+    bool prefilter = this->m_settings.float_prefilter();
+    double approx_t = approx_value(t);
     for (;k < col_size; k++) {
         const column_cell & c = col[k];
         unsigned i = c.var();
         const T & ed = this->m_A.get_val(c);
          lp_assert(!numeric_traits<T>::is_zero(ed));
         unsigned j = this->m_basis[i];
+        T m = -ed * m_sign_of_entering_delta;
+        if (prefilter && ratio_exceeds(j, m, approx_t)) {
+            ++this->m_settings.stats().m_ratio_prefiltered;
+            continue;
+        }
         unlimited = true;
-        limit_theta_on_basis_column(j, -ed * m_sign_of_entering_delta, ratio, unlimited);
+        limit_theta_on_basis_column(j, m, ratio, unlimited);
         if (unlimited) continue;
         unsigned i_nz = this->m_A.m_rows[i].size();
         if (ratio < t) {
             t = ratio;
+            approx_t = approx_value(t);
             m_leaving_candidates.clear();
             m_leaving_candidates.push_back(j);
             row_min_nz = i_nz;
@@ -32,4 +32,7 @@ void lp::lp_settings::updt_params(params_ref const& _p) {
     report_frequency = p.arith_rep_freq();
     m_simplex_strategy = static_cast<lp::simplex_strategy_enum>(p.arith_simplex_strategy());
     m_nlsat_delay = p.arith_nl_delay();
+    m_float_prefilter = p.arith_float_prefilter();
+    m_dual_steepest_edge = p.arith_dual_steepest_edge();
+    m_gomory_oversample = p.arith_gomory_oversample();
 }
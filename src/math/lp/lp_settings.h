@@ -126,8 +126,11 @@ struct statistics {
     unsigned m_cross_nested_forms = 0;
     unsigned m_grobner_calls = 0;
     unsigned m_grobner_conflicts = 0;
+    unsigned m_grobner_reused = 0;
+    unsigned m_grobner_steps = 0;
     unsigned m_offset_eqs = 0;
     unsigned m_fixed_eqs = 0;
+    unsigned m_ratio_prefiltered = 0;
     ::statistics m_st = {};
 
     void reset() {
@@ -152,8 +155,11 @@ struct statistics {
         st.update("arith-horner-cross-nested-forms", m_cross_nested_forms);
         st.update("arith-grobner-calls", m_grobner_calls);
         st.update("arith-grobner-conflicts", m_grobner_conflicts);
+        st.update("arith-grobner-reused", m_grobner_reused);
+        st.update("arith-grobner-steps", m_grobner_steps);
         st.update("arith-offset-eqs", m_offset_eqs);
         st.update("arith-fixed-eqs", m_fixed_eqs);
+        st.update("arith-ratio-prefiltered", m_ratio_prefiltered);
         st.update("arith-nla-add-bounds", m_nla_add_bounds);
         st.update("arith-nla-propagate-bounds", m_nla_propagate_bounds);
         st.update("arith-nla-propagate-eq", m_nla_propagate_eq);
@@ -228,8 +234,14 @@ private:
     bool             m_enable_hnf = true;
     bool             m_print_external_var_name = false;
     bool             m_propagate_eqs = false;
+    bool             m_float_prefilter = true;
+    bool             m_dual_steepest_edge = false;
+    unsigned         m_gomory_oversample = 1;
 public:
+    unsigned gomory_oversample() const { return m_gomory_oversample; }
+    bool dual_steepest_edge() const { return m_dual_steepest_edge; }
     bool print_external_var_name() const { return m_print_external_var_name; }
+    bool float_prefilter() const { return m_float_prefilter; }
     bool propagate_eqs() const { return m_propagate_eqs;}
     unsigned hnf_cut_period() const { return m_hnf_cut_period; }
     void set_hnf_cut_period(unsigned period) { m_hnf_cut_period = period;  }
@@ -33,6 +33,7 @@ namespace nla {
     /**
      * Accumulate product of variables in monomial starting at position 'start'
      */
+    template <dep_intervals::with_deps_t wd>
     void monomial_bounds::compute_product(unsigned start, monic const& m, scoped_dep_interval& product) {
         scoped_dep_interval vi(dep);
         unsigned power = 1;
@@ -41,8 +42,8 @@ namespace nla {
             var2interval(v, vi);
             ++i;
             for (power = 1; i < m.size() && m.vars()[i] == v; ++i, ++power);
-            dep.power<dep_intervals::with_deps>(vi, power, vi);            
-            dep.mul<dep_intervals::with_deps>(product, vi, product);
+            dep.power<wd>(vi, power, vi);            
+            dep.mul<wd>(product, vi, product);
         }
     }
 
@@ -244,6 +245,8 @@ namespace nla {
         bool do_propagate_down = !is_free(m.var()) && num_free <= 1;
         if (!do_propagate_up && !do_propagate_down)
             return false;
+        if (!can_propagate(m, num_free, free_var))
+            return false;
         scoped_dep_interval product(dep);
         scoped_dep_interval vi(dep), mi(dep);
         scoped_dep_interval other_product(dep);
@@ -258,7 +261,7 @@ namespace nla {
 
             if (do_propagate_down && (num_free == 0 || free_var == v)) {
                 dep.set<dep_intervals::with_deps>(other_product, product);
-                compute_product(i, m, other_product);
+                compute_product<dep_intervals::with_deps>(i, m, other_product);
                 if (propagate_down(m, mi, v, power, other_product))
                     return true;
             }
@@ -267,6 +270,44 @@ namespace nla {
         return do_propagate_up && propagate_value(product, m.var());
     }
 
+    /**
+     * Evaluate the intervals of propagate(m) without dependencies and check
+     * whether a bound would be propagated. Most monomials propagate nothing,
+     * and joining dependencies allocates in the dependency manager, so the
+     * intervals are recomputed with dependencies only when a lemma is created.
+     */
+    bool monomial_bounds::can_propagate(monic const& m, unsigned num_free, lpvar free_var) {
+        bool do_propagate_up   = num_free == 0;
+        bool do_propagate_down = !is_free(m.var()) && num_free <= 1;
+        scoped_dep_interval product(dep);
+        scoped_dep_interval vi(dep), mi(dep);
+        scoped_dep_interval other_product(dep);
+        var2interval(m.var(), mi);
+        dep.set_value(product, rational::one());
+        unsigned power;
+        for (unsigned i = 0; i < m.size(); ) {
+            lpvar v = m.vars()[i];
+            ++i;
+            for (power = 1; i < m.size() && v == m.vars()[i]; ++i, ++power); 
+            var2interval(v, vi);
+            dep.power<dep_intervals::without_deps>(vi, power, vi);
+
+            if (do_propagate_down && (num_free == 0 || free_var == v)) {
+                dep.set<dep_intervals::without_deps>(other_product, product);
+                compute_product<dep_intervals::without_deps>(i, m, other_product);
+                if (dep.separated_from_zero(other_product)) {
+                    scoped_dep_interval range(dep);
+                    dep.div<dep_intervals::without_deps>(mi, other_product, range);
+                    if (should_propagate_upper(range, v, power) || should_propagate_lower(range, v, power))
+                        return true;
+                }
+            }
+            dep.mul<dep_intervals::without_deps>(product, vi, product);
+        }
+        return do_propagate_up && 
+            (should_propagate_upper(product, m.var(), 1) || should_propagate_lower(product, m.var(), 1));
+    }
+
     bool monomial_bounds::propagate_down(monic const& m, dep_interval& mi, lpvar v, unsigned power, dep_interval& product) {
         if (!dep.separated_from_zero(product)) 
             return false;
@@ -362,7 +403,7 @@ namespace nla {
 
     lp::explanation monomial_bounds::get_explanation(u_dependency* dep) {
         lp::explanation exp;
-        svector<lp::constraint_index> cs;
+        sbuffer<lp::constraint_index> cs;
         c().lra.dep_manager().linearize(dep, cs);
         for (auto d : cs)
             exp.add_pair(d, mpq(1));
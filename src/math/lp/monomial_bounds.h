@@ -25,7 +25,9 @@ namespace nla {
         bool propagate_down(monic const& m, lpvar u);
         bool propagate_value(dep_interval& range, lpvar v);
         bool propagate_value(dep_interval& range, lpvar v, unsigned power);
+        template <dep_intervals::with_deps_t wd>
         void compute_product(unsigned start, monic const& m, scoped_dep_interval& i);
+        bool can_propagate(monic const& m, unsigned num_free, lpvar free_var);
         bool propagate(monic const& m);
         void propagate_fixed_to_zero(monic const& m, lpvar fixed_to_zero);
         void propagate_fixed(monic const& m, rational const& k);
@@ -1448,6 +1448,29 @@ void core::check_weighted(unsigned sz, std::pair<unsigned, std::function<void(vo
     }
 }
 
+/**
+   \brief weight w of family f used by check_weighted.
+   With arith.nl.adaptive the weight is scaled by the smoothed fraction of
+   the calls of f that produced lemmas, so an unproductive family is
+   still tried, but rarely.
+*/
+unsigned core::family_weight(family f, unsigned w) const {
+    if (!params().arith_nl_adaptive())
+        return w;
+    auto const& s = m_families[f];
+    return std::max(1u, (16 * w * (s.m_hits + 1)) / (s.m_calls + 2));
+}
+
+void core::run_family(family f, std::function<void(void)> const& fn) {
+    unsigned num_lemmas = m_lemmas.size(), num_literals = m_literals.size();
+    bool check_feasible = m_check_feasible;
+    fn();
+    auto& s = m_families[f];
+    s.m_calls++;
+    if (m_lemmas.size() > num_lemmas || m_literals.size() > num_literals || m_check_feasible != check_feasible)
+        s.m_hits++;
+}
+
 lbool core::check_power(lpvar r, lpvar x, lpvar y) {
     clear();
     return m_powers.check(r, x, y, m_lemmas);
@@ -1506,14 +1529,14 @@ lbool core::check() {
         m_monomial_bounds.propagate();
     
     {
-        std::function<void(void)> check1 = [&]() { if (no_effect() && run_horner) m_horner.horner_lemmas(); };
-        std::function<void(void)> check2 = [&]() { if (no_effect() && run_grobner) m_grobner(); };
-        std::function<void(void)> check3 = [&]() { if (no_effect() && run_bounds) add_bounds(); };
+        std::function<void(void)> check1 = [&]() { if (no_effect() && run_horner) run_family(horner_f, [&]() { m_horner.horner_lemmas(); }); };
+        std::function<void(void)> check2 = [&]() { if (no_effect() && run_grobner) run_family(grobner_f, [&]() { m_grobner(); }); };
+        std::function<void(void)> check3 = [&]() { if (no_effect() && run_bounds) run_family(bounds_f, [&]() { add_bounds(); }); };
 
         std::pair<unsigned, std::function<void(void)>> checks[] =
-            { {1, check1},
-              {1, check2},
-              {1, check3} };
+            { {family_weight(horner_f, 1), check1},
+              {family_weight(grobner_f, 1), check2},
+              {family_weight(bounds_f, 1), check3} };
         check_weighted(3, checks);
 
         if (lp_settings().get_cancel_flag())
@@ -1537,17 +1560,17 @@ lbool core::check() {
 
 
     if (no_effect()) {
-        std::function<void(void)> check1 = [&]() { m_order.order_lemma();
+        std::function<void(void)> check1 = [&]() { run_family(order_f, [&]() { m_order.order_lemma(); });
         };
-        std::function<void(void)> check2 = [&]() { m_monotone.monotonicity_lemma();
+        std::function<void(void)> check2 = [&]() { run_family(monotone_f, [&]() { m_monotone.monotonicity_lemma(); });
         };
-        std::function<void(void)> check3 = [&]() { m_tangents.tangent_lemma();
+        std::function<void(void)> check3 = [&]() { run_family(tangent_f, [&]() { m_tangents.tangent_lemma(); });
         };
         
         std::pair<unsigned, std::function<void(void)>> checks[] = 
-            { { 6, check1 }, 
-              { 2, check2 }, 
-              { 1, check3 }};
+            { { family_weight(order_f, 6), check1 }, 
+              { family_weight(monotone_f, 2), check2 }, 
+              { family_weight(tangent_f, 1), check3 }};
         check_weighted(3, checks);
 
         unsigned num_calls = lp_settings().stats().m_nla_calls;
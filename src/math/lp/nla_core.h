@@ -102,6 +102,16 @@ class core {
     lpvar                    m_patched_var = 0;
     monic const*             m_patched_monic = nullptr;      
 
+    // lemma families scheduled by check_weighted
+    enum family { horner_f, grobner_f, bounds_f, order_f, monotone_f, tangent_f, num_families };
+    struct family_stats {
+        unsigned m_calls = 0;
+        unsigned m_hits = 0;
+    };
+    family_stats             m_families[num_families];
+
+    unsigned family_weight(family f, unsigned w) const;
+    void run_family(family f, std::function<void(void)> const& fn);
     void check_weighted(unsigned sz, std::pair<unsigned, std::function<void(void)>>* checks);
     void add_bounds();
 
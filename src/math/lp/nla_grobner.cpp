@@ -51,10 +51,25 @@ namespace nla {
         }
         
         lp_settings().stats().m_grobner_calls++;
-        find_nl_cluster();        
+        find_nl_cluster();
+
+        // the basis and the checks on it are a function of the fingerprint,
+        // so an unchanged cluster would miss again.
+        vector<rational> fp;
+        fingerprint(fp);
+        if (fp == m_last_miss) {
+            lp_settings().stats().m_grobner_reused++;
+            ++m_delay_base;
+            if (m_quota > 0)
+                --m_quota;
+            return;
+        }
+        m_last_miss.reset();
+
         if (!configure())
             return;
         m_solver.saturate();
+        lp_settings().stats().m_grobner_steps += m_solver.get_stats().m_compute_steps;
 
         if (m_delay_base > 0)
             --m_delay_base;
@@ -82,6 +97,7 @@ namespace nla {
 
         // for (auto e : m_solver.equations()) check_missing_propagation(*e);
         
+        m_last_miss.swap(fp);
         ++m_delay_base;
         if (m_quota > 0)
            --m_quota;
@@ -212,7 +228,7 @@ namespace nla {
 
     void grobner::explain(dd::solver::equation const& eq, lp::explanation& exp) {
         u_dependency_manager dm;
-        vector<unsigned, false> lv;
+        sbuffer<unsigned> lv;
         dm.linearize(eq.dep(), lv);
         for (unsigned ci : lv)
             exp.push_back(ci);
@@ -593,6 +609,44 @@ namespace nla {
     }
 
 
+    /**
+       \brief summarize the input of the Grobner step: the variable weights that
+       determine the variable order, the rows and bounds of the cluster, and the
+       values of its variables and of the monics.
+    */
+    void grobner::fingerprint(vector<rational>& fp) {
+        unsigned n = lra.column_count();
+        fp.push_back(rational(n));
+        for (unsigned j = 0; j < n; ++j)
+            fp.push_back(rational(c().get_var_weight(j)));
+        fp.push_back(rational(c().m_to_refine.size()));
+        for (lpvar j : c().m_to_refine)
+            fp.push_back(rational(j));
+        auto add_bound = [&](lp::impq const& b) {
+            fp.push_back(b.x);
+            fp.push_back(b.y);
+        };
+        for (lpvar j : c().active_var_set()) {
+            fp.push_back(rational(j));
+            fp.push_back(val(j));
+            fp.push_back(rational(static_cast<unsigned>(lra.get_column_type(j))));
+            if (lra.column_has_lower_bound(j))
+                add_bound(lra.get_lower_bound(j));
+            if (lra.column_has_upper_bound(j))
+                add_bound(lra.get_upper_bound(j));
+            if (lra.is_base(j)) {
+                auto const& row = lra.basic2row(j);
+                fp.push_back(rational(row.size()));
+                for (auto const& p : row) {
+                    fp.push_back(rational(p.var()));
+                    fp.push_back(p.coeff());
+                }
+            }
+        }
+        for (auto const& m : c().emons())
+            fp.push_back(val(m.var()));
+    }
+
     void grobner::display_matrix_of_m_rows(std::ostream & out) const {
         const auto& matrix = lra.A_r();
         out << m_rows.size() << " rows" << "\n";
@@ -27,6 +27,7 @@ namespace nla {
         unsigned                 m_delay_base = 0;
         unsigned                 m_delay = 0;
         bool                     m_add_all_eqs = false;
+        vector<rational>         m_last_miss;    // fingerprint of the last call that produced no lemma
         std::unordered_map<unsigned_vector, lpvar, hash_svector> m_mon2var;
 
         lp::lp_settings& lp_settings();
@@ -59,6 +60,7 @@ namespace nla {
         void set_level2var();
         void find_nl_cluster();
         void prepare_rows_and_active_vars();
+        void fingerprint(vector<rational>& fp);
         void add_var_and_its_factors_to_q_and_collect_new_rows(lpvar j, svector<lpvar>& q);           
         void add_row(const vector<lp::row_cell<rational>>& row);
         void add_fixed_monic(unsigned j);
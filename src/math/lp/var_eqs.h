@@ -19,6 +19,7 @@
   --*/
 
 #pragma once
+#include "util/buffer.h"
 #include "util/union_find.h"
 #include "math/lp/nla_defs.h"
 #include "util/rational.h"
@@ -220,7 +221,7 @@ public:
 
     void explain_eq(eq_justification const& eq, lp::explanation& e) const {
         u_dependency_manager dm;
-        unsigned_vector deps;
+        sbuffer<unsigned> deps;
         for (auto* dep : eq) {
             deps.reset();
             dm.linearize(dep, deps);
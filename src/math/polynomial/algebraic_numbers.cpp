@@ -19,6 +19,7 @@ Notes:
 #include "util/mpbq.h"
 #include "util/basic_interval.h"
 #include "util/scoped_ptr_vector.h"
+#include "util/map.h"
 #include "util/mpbqi.h"
 #include "util/timeit.h"
 #include "util/common_msgs.h"
@@ -57,6 +58,21 @@ namespace algebraic_numbers {
     typedef upolynomial::scoped_numeral_vector scoped_upoly;
     typedef upolynomial::factors factors;
 
+    /**
+       \brief Refined isolating intervals of the roots of a minimal polynomial.
+       Cells that represent the same root with the same minimal polynomial
+       share the refinement work through this entry.
+    */
+    struct root_entry {
+        unsigned           m_hash;
+        root_entry *       m_next;
+        scoped_upoly       m_p;
+        scoped_mpbq_vector m_lowers;
+        scoped_mpbq_vector m_uppers;
+        root_entry(upoly_manager & um, mpbq_manager & bm, unsigned h):
+            m_hash(h), m_next(nullptr), m_p(um), m_lowers(bm), m_uppers(bm) {}
+    };
+
     void manager::get_param_descrs(param_descrs & r) {
         algebraic_params::collect_param_descrs(r);
     }
@@ -89,12 +105,19 @@ namespace algebraic_numbers {
         bool                       m_factor;
         polynomial::factor_params  m_factor_params;
         int                        m_zero_accuracy;
+        bool                       m_root_cache_enabled;
+
+        // shared refinement of roots of minimal polynomials
+        static const unsigned      max_root_entries = 1024;
+        scoped_ptr_vector<root_entry> m_root_entries;
+        u_map<root_entry*>         m_root_cache;
 
         // statistics
         unsigned                 m_compare_cheap;
         unsigned                 m_compare_sturm;
         unsigned                 m_compare_refine;
         unsigned                 m_compare_poly_eq;
+        unsigned                 m_root_cache_hits;
 
         imp(reslimit& lim, manager & w, unsynch_mpq_manager & m, params_ref const & p, small_object_allocator & a):
             m_limit(lim),
@@ -136,6 +159,7 @@ namespace algebraic_numbers {
             m_compare_sturm   = 0;
             m_compare_refine  = 0;
             m_compare_poly_eq = 0;
+            m_root_cache_hits = 0;
         }
 
         void collect_statistics(statistics & st) {
@@ -144,6 +168,7 @@ namespace algebraic_numbers {
             st.update("algebraic compare sturm", m_compare_sturm);
             st.update("algebraic compare refine", m_compare_refine);
             st.update("algebraic compare poly", m_compare_poly_eq);
+            st.update("algebraic root cache hits", m_root_cache_hits);
 #endif
         }
 
@@ -155,6 +180,7 @@ namespace algebraic_numbers {
             m_factor_params.m_p_trials = p.factor_num_primes();
             m_factor_params.m_max_search_size = p.factor_search_size();
             m_zero_accuracy            = -static_cast<int>(p.zero_accuracy());
+            m_root_cache_enabled       = p.root_cache();
         }
 
         unsynch_mpq_manager & qm() {
@@ -769,6 +795,86 @@ namespace algebraic_numbers {
             return r;
         }
 
+        unsigned root_hash(algebraic_cell const * c) const {
+            unsigned h = c->m_p_sz;
+            for (unsigned i = 0; i < c->m_p_sz; i++)
+                h = combine_hash(h, mpz_manager<false>::hash(c->m_p[i]));
+            return h;
+        }
+
+        root_entry * find_root_entry(algebraic_cell const * c, unsigned h) {
+            root_entry * e = nullptr;
+            m_root_cache.find(h, e);
+            for (; e; e = e->m_next)
+                if (upm().eq(c->m_p_sz, c->m_p, e->m_p.size(), e->m_p.data()))
+                    return e;
+            return nullptr;
+        }
+
+        /**
+           \brief Two isolating intervals of a square-free polynomial where one
+           contains the other isolate the same root.
+           If the cache contains an interval for the root of c that is strictly
+           inside the interval of c, then use it.
+        */
+        bool refine_from_cache(algebraic_cell * c) {
+            root_entry * e = find_root_entry(c, root_hash(c));
+            if (!e)
+                return false;
+            for (unsigned i = 0; i < e->m_lowers.size(); i++) {
+                mpbq const & l = e->m_lowers[i];
+                mpbq const & u = e->m_uppers[i];
+                if (bqm().ge(l, lower(c)) && bqm().le(u, upper(c)) && (bqm().gt(l, lower(c)) || bqm().lt(u, upper(c)))) {
+                    set_interval(c, l, u);
+                    update_sign_lower(c);
+                    m_root_cache_hits++;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+           \brief Record the interval of c, replacing a cached interval of the
+           same root that contains it.
+        */
+        void publish_root(algebraic_cell const * c) {
+            unsigned h = root_hash(c);
+            root_entry * e = find_root_entry(c, h);
+            if (!e) {
+                if (m_root_entries.size() >= max_root_entries) {
+                    m_root_cache.reset();
+                    m_root_entries.reset();
+                }
+                e = alloc(root_entry, upm(), bqm(), h);
+                upm().set(c->m_p_sz, c->m_p, e->m_p);
+                root_entry * head = nullptr;
+                m_root_cache.find(h, head);
+                e->m_next = head;
+                m_root_cache.insert(h, e);
+                m_root_entries.push_back(e);
+            }
+            for (unsigned i = 0; i < e->m_lowers.size(); i++) {
+                mpbq & l = e->m_lowers[i];
+                mpbq & u = e->m_uppers[i];
+                if (bqm().le(l, lower(c)) && bqm().ge(u, upper(c))) {
+                    bqm().set(l, lower(c));
+                    bqm().set(u, upper(c));
+                    return;
+                }
+                if (bqm().ge(l, lower(c)) && bqm().le(u, upper(c)))
+                    return;
+            }
+            // a square-free polynomial of degree d has at most d real roots,
+            // partially overlapping intervals of the same root may add more.
+            if (e->m_lowers.size() >= 2 * c->m_p_sz) {
+                e->m_lowers.reset();
+                e->m_uppers.reset();
+            }
+            e->m_lowers.push_back(lower(c));
+            e->m_uppers.push_back(upper(c));
+        }
+
         /**
            \brief Refine isolating interval associated with algebraic number.
            This procedure is a noop if algebraic number is basic.
@@ -785,7 +891,12 @@ namespace algebraic_numbers {
             if (a.is_basic())
                 return false;
             algebraic_cell * c = a.to_algebraic();
+            bool shared = c->m_minimal && m_root_cache_enabled;
+            if (shared && refine_from_cache(c))
+                return true;
             if (refine_core(c)) {
+                if (shared)
+                    publish_root(c);
                 return true;
             }
             else {
@@ -1702,6 +1702,10 @@ namespace polynomial {
         return p->id();
     }
 
+    unsigned manager::ref_count(polynomial const * p) {
+        return p->ref_count();
+    }
+
     bool manager::is_unit(monomial const * m) {
         return m->size() == 0;
     }
@@ -4644,8 +4648,10 @@ namespace polynomial {
                         #endif
                     }
                     catch (const sparse_mgcd_failed &) {
-                        flet<bool> use_prs(m_use_prs_gcd, false);
-                        gcd_prs(u, v, x, r);
+                        // the skeleton of the first image did not fit the other images,
+                        // retry with dense interpolation before falling back to prs.
+                        flet<bool> use_sparse(m_use_sparse_gcd, false);
+                        mod_gcd(u, v, u_var_degrees, v_var_degrees, r);
                     }
                 }
             }
@@ -7004,6 +7010,11 @@ namespace polynomial {
         return m_imp->m().set_z();
     }
 
+    void manager::set_gcd_kind(gcd_kind k) {
+        m_imp->m_use_sparse_gcd = k == sparse_modular_gcd;
+        m_imp->m_use_prs_gcd = k == prs_gcd;
+    }
+
     void manager::set_zp(numeral const & p) {
         return m_imp->m().set_zp(p);
     }
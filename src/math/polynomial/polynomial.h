@@ -222,6 +222,19 @@ namespace polynomial {
         void set_zp(numeral const & p);
         void set_zp(uint64_t p);
 
+        enum gcd_kind {
+            sparse_modular_gcd, // modular GCD with sparse (Zippel) interpolation, the default
+            dense_modular_gcd,  // modular GCD with dense interpolation
+            prs_gcd             // subresultant polynomial remainder sequences
+        };
+
+        /**
+           \brief Select the algorithm used by gcd for multivariate polynomials over Z.
+           Univariate polynomials use modular GCD unless prs_gcd is selected,
+           and polynomials over Z_p always use prs.
+        */
+        void set_gcd_kind(gcd_kind k);
+
         /**
            \brief Abstract event handler.
         */
@@ -280,6 +293,11 @@ namespace polynomial {
            This id can be used to implement efficient mappings from polynomial to data.
         */
         static unsigned id(polynomial const * p);
+
+        /**
+           \brief Return the number of references to \c p.
+        */
+        static unsigned ref_count(polynomial const * p);
         
 
         /**
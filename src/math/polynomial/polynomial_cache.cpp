@@ -40,6 +40,7 @@ namespace polynomial {
         unsigned           m_hash;
         unsigned           m_result_sz;
         polynomial **      m_result;
+        unsigned           m_last_use;
         
         psc_chain_entry(polynomial const * p, polynomial const * q, var x, unsigned h):
             m_p(p),
@@ -47,7 +48,8 @@ namespace polynomial {
             m_x(x),
             m_hash(h),
             m_result_sz(0),
-            m_result(nullptr) {
+            m_result(nullptr),
+            m_last_use(0) {
         }
         
         struct hash_proc { unsigned operator()(psc_chain_entry const * entry) const { return entry->m_hash; } };
@@ -64,12 +66,14 @@ namespace polynomial {
         unsigned           m_hash;
         unsigned           m_result_sz;
         polynomial **      m_result;
+        unsigned           m_last_use;
         
         factor_entry(polynomial const * p, unsigned h):
             m_p(p),
             m_hash(h),
             m_result_sz(0),
-            m_result(nullptr) {
+            m_result(nullptr),
+            m_last_use(0) {
         }
         
         struct hash_proc { unsigned operator()(factor_entry const * entry) const { return entry->m_hash; } };
@@ -85,6 +89,12 @@ namespace polynomial {
     typedef chashtable<psc_chain_entry*, psc_chain_entry::hash_proc, psc_chain_entry::eq_proc> psc_chain_cache;
     typedef chashtable<factor_entry*, factor_entry::hash_proc, factor_entry::eq_proc> factor_cache;
     
+    struct cache_stats {
+        unsigned m_hits = 0;
+        unsigned m_misses = 0;
+        unsigned m_evictions = 0;
+    };
+
     struct cache::imp { 
         manager &                m;
         polynomial_table         m_poly_table;
@@ -93,6 +103,9 @@ namespace polynomial {
         polynomial_ref_vector    m_cached_polys;
         svector<char>            m_in_cache;
         small_object_allocator & m_allocator;
+        unsigned                 m_clock = 0;
+        unsigned                 m_max_entries = 0;
+        cache_stats              m_stats;
 
         imp(manager & _m):m(_m), m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), m_cached_polys(m), m_allocator(m.allocator()) {
         }
@@ -150,6 +163,8 @@ namespace polynomial {
             if (entry != old_entry) {
                 entry->~psc_chain_entry();
                 m_allocator.deallocate(sizeof(psc_chain_entry), entry);
+                old_entry->m_last_use = ++m_clock;
+                m_stats.m_hits++;
                 S.reset();
                 for (unsigned i = 0; i < old_entry->m_result_sz; i++) {
                     S.push_back(old_entry->m_result[i]);
@@ -165,6 +180,9 @@ namespace polynomial {
                     S.set(i, h);
                     entry->m_result[i] = h;
                 }
+                entry->m_last_use = ++m_clock;
+                m_stats.m_misses++;
+                evict_if_needed();
             }
         }
 
@@ -177,6 +195,8 @@ namespace polynomial {
             if (entry != old_entry) {
                 entry->~factor_entry();
                 m_allocator.deallocate(sizeof(factor_entry), entry);
+                old_entry->m_last_use = ++m_clock;
+                m_stats.m_hits++;
                 distinct_factors.reset();
                 for (unsigned i = 0; i < old_entry->m_result_sz; i++) {
                     distinct_factors.push_back(old_entry->m_result[i]);
@@ -193,8 +213,78 @@ namespace polynomial {
                     distinct_factors.push_back(h);
                     entry->m_result[i] = h;
                 }
+                entry->m_last_use = ++m_clock;
+                m_stats.m_misses++;
+                evict_if_needed();
             }
         }
+
+        /**
+           \brief Evict the least recently used half of the psc chain and factor
+           entries, and the polynomials that are referenced only by the cache.
+           It is invoked after a new entry was added, so the arguments and
+           results of the newest entry are kept.
+        */
+        void evict_if_needed() {
+            if (m_max_entries == 0 || m_psc_chain_cache.size() + m_factor_cache.size() <= m_max_entries)
+                return;
+            m_stats.m_evictions++;
+            ptr_vector<psc_chain_entry> pscs;
+            ptr_vector<factor_entry> factors;
+            unsigned_vector stamps;
+            for (auto * e : m_psc_chain_cache) {
+                pscs.push_back(e);
+                stamps.push_back(e->m_last_use);
+            }
+            for (auto * e : m_factor_cache) {
+                factors.push_back(e);
+                stamps.push_back(e->m_last_use);
+            }
+            unsigned mid = stamps.size() / 2;
+            std::nth_element(stamps.begin(), stamps.begin() + mid, stamps.end());
+            unsigned threshold = stamps[mid];
+
+            svector<char> keep;
+            auto mark = [&](polynomial const * p) { keep.setx(m.id(p), true, false); };
+            m_psc_chain_cache.reset();
+            for (auto * e : pscs) {
+                if (e->m_last_use < threshold) {
+                    del_psc_chain_entry(e);
+                    continue;
+                }
+                m_psc_chain_cache.insert(e);
+                mark(e->m_p);
+                mark(e->m_q);
+                for (unsigned i = 0; i < e->m_result_sz; i++)
+                    mark(e->m_result[i]);
+            }
+            m_factor_cache.reset();
+            for (auto * e : factors) {
+                if (e->m_last_use < threshold) {
+                    del_factor_entry(e);
+                    continue;
+                }
+                m_factor_cache.insert(e);
+                mark(e->m_p);
+                for (unsigned i = 0; i < e->m_result_sz; i++)
+                    mark(e->m_result[i]);
+            }
+
+            ptr_buffer<polynomial> live;
+            m_poly_table.reset();
+            for (polynomial * p : m_cached_polys) {
+                if (keep.get(pid(p), false) || manager::ref_count(p) > 1) {
+                    live.push_back(p);
+                    m_poly_table.insert(p);
+                }
+                else {
+                    m_in_cache[pid(p)] = false;
+                }
+            }
+            polynomial_ref_vector cached_polys(m);
+            cached_polys.append(live.size(), live.data());
+            m_cached_polys.swap(cached_polys);
+        }
     };
 
     cache::cache(manager & m) {
@@ -223,7 +313,21 @@ namespace polynomial {
     
     void cache::reset() {
         manager & _m = m();
+        unsigned max_entries = m_imp->m_max_entries;
+        cache_stats st = m_imp->m_stats;
         dealloc(m_imp);
         m_imp = alloc(imp, _m);
+        m_imp->m_max_entries = max_entries;
+        m_imp->m_stats = st;
+    }
+
+    void cache::set_max_entries(unsigned n) {
+        m_imp->m_max_entries = n;
+    }
+
+    void cache::collect_statistics(statistics & st) const {
+        st.update("polynomial cache hits", m_imp->m_stats.m_hits);
+        st.update("polynomial cache misses", m_imp->m_stats.m_misses);
+        st.update("polynomial cache evictions", m_imp->m_stats.m_evictions);
     }
 };
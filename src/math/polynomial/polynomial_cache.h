@@ -19,6 +19,7 @@ Notes:
 #pragma once
 
 #include "math/polynomial/polynomial.h"
+#include "util/statistics.h"
 
 namespace polynomial {
 
@@ -37,6 +38,14 @@ namespace polynomial {
         void psc_chain(polynomial const * p, polynomial const * q, var x, polynomial_ref_vector & S);
         void factor(polynomial const * p, polynomial_ref_vector & distinct_factors);
         void reset();
+        /**
+           \brief bound the number of cached psc chains and factorizations.
+           When the bound is exceeded, the least recently used half of the
+           entries is evicted, together with the polynomials that are only
+           referenced by the cache. 0 means unbounded.
+        */
+        void set_max_entries(unsigned n);
+        void collect_statistics(statistics & st) const;
     };
 };
 
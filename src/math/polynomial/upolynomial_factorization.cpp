@@ -1012,6 +1012,52 @@ static unsigned mignotte_bound(z_manager & upm, numeral_vector const & f, numera
     return e;
 }
 
+// Cauchy bound 1 + max_{i < n} |f_i| / |f_n| on the absolute value of the complex roots of f, rounded up.
+static void root_bound(z_manager & upm, numeral_vector const & f, numeral & bound) {
+    unsynch_mpz_manager & zm = upm.m().m();
+    scoped_mpz tmp(zm), lc(zm), one(zm);
+    zm.set(one, 1);
+    zm.reset(bound);
+    for (unsigned i = 0; i + 1 < f.size(); ++ i) {
+        zm.set(tmp, f[i]);
+        zm.abs(tmp);
+        if (zm.gt(tmp, bound)) {
+            zm.set(bound, tmp);
+        }
+    }
+    zm.set(lc, f.back());
+    zm.abs(lc);
+    zm.add(bound, lc, bound);
+    zm.sub(bound, one, bound);
+    zm.div(bound, lc, bound);
+    zm.add(bound, one, bound);
+}
+
+// The trace test of the recombination: a factor h of degree d of f gives the true factor
+// lc(f)/lc(h) * h = lc(f) * prod (x - r_j) of lc(f)*f, whose coefficient of x^(d-1) is
+// -lc(f) * sum r_j. Its absolute value is at most |lc(f)| * d * root_bound. The lifted
+// factors only give this coefficient modulo p^e, as lc * trace. It is exact in the
+// symmetric representation when the bound is below p^e/2, and then a larger value rules
+// out the combination without computing the product and dividing.
+static bool trace_test_fails(z_manager & upm, zp_numeral_manager & zpe_nm, numeral const & trace, 
+                             numeral const & lc, unsigned d, numeral const & bound) {
+    unsynch_mpz_manager & zm = upm.m().m();
+    scoped_mpz t(zm), max_t(zm);
+    zm.set(max_t, d);
+    zm.mul(max_t, bound, max_t);
+    zm.set(t, lc);
+    zm.abs(t);
+    zm.mul(max_t, t, max_t);
+    zm.add(max_t, max_t, t);
+    if (!zm.lt(t, zpe_nm.p())) {
+        return false;
+    }
+    zm.mul(lc, trace, t);
+    zpe_nm.p_normalize(t);
+    zm.abs(t);
+    return zm.gt(t, max_t);
+}
+
 /**
    \brief Given f from Z[x] that is square free, it factors it.
    This method also assumes f is primitive.
@@ -1182,6 +1228,10 @@ bool factor_square_free(z_manager & upm, numeral_vector const & f, factors & fs,
     // the leading coefficient of f_pp mod p^e
     scoped_numeral f_pp_lc(nm);
     zpe_nm.set(f_pp_lc, f_pp.back());
+
+    // the roots of the remaining f_pp are roots of f_pp now
+    scoped_numeral f_root_bound(nm), trace(nm);
+    root_bound(upm, f_pp, f_root_bound);
     
     // we always keep in f_pp the actual primitive part f_pp*lc(f_pp)
     upm.mul(f_pp, f_pp_lc);
@@ -1221,6 +1271,11 @@ bool factor_square_free(z_manager & upm, numeral_vector const & f, factors & fs,
                 remove = false;
                 continue;
             }
+            it.get_left_trace(trace);
+            if (trace_test_fails(upm, zpe_nm, trace, f_pp_lc, it.current_degree(), f_root_bound)) {
+                remove = false;
+                continue;
+            }
             it.left(trial_factor);
         } 
         else {
@@ -1232,6 +1287,11 @@ bool factor_square_free(z_manager & upm, numeral_vector const & f, factors & fs,
                 remove = false;
                 continue;
             }
+            it.get_right_trace(trace);
+            if (trace_test_fails(upm, zpe_nm, trace, f_pp_lc, upm.degree(f_pp) - it.current_degree(), f_root_bound)) {
+                remove = false;
+                continue;
+            }
             it.right(trial_factor);
         }
 
@@ -386,6 +386,36 @@ namespace upolynomial {
             }
         }
 
+        /**
+           \brief Store in out the sum of the coefficients of x^(d-1) of the selected (monic)
+           factors, i.e., the coefficient of x^(d-1) of their product of degree d.
+        */
+        void get_left_trace(numeral & out) const {
+            zp_numeral_manager & nm = m_factors.upm().m();
+            nm.reset(out);
+            for (int i = 0; i < m_current_size; ++ i) {
+                numeral_vector const & f = m_factors[m_current[i]];
+                nm.add(out, f[f.size() - 2], out);
+            }
+        }
+
+        void get_right_trace(numeral & out) const {
+            zp_numeral_manager & nm = m_factors.upm().m();
+            nm.reset(out);
+            unsigned selection_i = 0;
+            for (unsigned current = 0; current < m_factors.distinct_factors(); ++ current) {
+                if (!m_enabled[current]) {
+                    continue;
+                }
+                if (selection_i < m_current.size() && (int) current == m_current[selection_i]) {
+                    selection_i ++;
+                    continue;
+                }
+                numeral_vector const & f = m_factors[current];
+                nm.add(out, f[f.size() - 2], out);
+            }
+        }
+
         void right(numeral_vector & out) const {
             SASSERT(m_current_size > 0);
             zp_manager & upm = m_factors.upm();
@@ -280,14 +280,27 @@ namespace realclosure {
         array<polynomial> const & prs() const { return m_prs; }
     };
 
+    /**
+       \brief Sign of q(x) for an algebraic extension x, obtained with Tarski queries.
+    */
+    struct sign_entry {
+        polynomial   m_q;
+        int          m_sign;
+    };
+
     struct algebraic : public extension {
         polynomial   m_p;
         mpbqi        m_iso_interval;
         sign_det *   m_sign_det; //!< != 0         if m_iso_interval constrains more than one root of m_p.
         unsigned     m_sc_idx;   //!< != UINT_MAX  if m_sign_det != 0, in this case m_sc_idx < m_sign_det->m_sign_conditions.size()
         bool         m_depends_on_infinitesimals;  //!< True if the polynomial p depends on infinitesimal extensions.
+        sign_entry * m_sign_cache;      //!< signs of polynomials at this root, replaced round-robin.
+        unsigned     m_sign_cache_capacity;
+        unsigned     m_sign_cache_size;
+        unsigned     m_sign_cache_next;
 
-        algebraic(unsigned idx):extension(ALGEBRAIC, idx), m_sign_det(nullptr), m_sc_idx(0), m_depends_on_infinitesimals(false) {}
+        algebraic(unsigned idx):extension(ALGEBRAIC, idx), m_sign_det(nullptr), m_sc_idx(0), m_depends_on_infinitesimals(false),
+                                m_sign_cache(nullptr), m_sign_cache_capacity(0), m_sign_cache_size(0), m_sign_cache_next(0) {}
 
         polynomial const & p() const { return m_p; }
         bool depends_on_infinitesimals() const { return m_depends_on_infinitesimals; }
@@ -393,6 +406,7 @@ namespace realclosure {
         unsigned                       m_ini_precision; //!< initial precision for transcendentals, infinitesimals, etc.
         unsigned                       m_max_precision; //!< Maximum precision for interval arithmetic techniques, it switches to complete methods after that
         unsigned                       m_inf_precision; //!< 2^m_inf_precision is used as the lower bound of oo and -2^m_inf_precision is used as the upper_bound of -oo
+        unsigned                       m_sign_cache_capacity; //!< maximum number of signs cached per algebraic extension
         scoped_mpbq                    m_plus_inf_approx; // lower bound for binary rational intervals used to approximate an infinite positive value
         scoped_mpbq                    m_minus_inf_approx; // upper bound for binary rational intervals used to approximate an infinite negative value
         bool                           m_lazy_algebraic_normalization;
@@ -736,6 +750,7 @@ namespace realclosure {
             m_inf_precision      = p.inf_precision();
             m_max_precision      = p.max_precision();
             m_lazy_algebraic_normalization = p.lazy_algebraic_normalization();
+            m_sign_cache_capacity = p.sign_cache_size();
             bqm().power(mpbq(2), m_inf_precision, m_plus_inf_approx);
             bqm().set(m_minus_inf_approx, m_plus_inf_approx);
             bqm().neg(m_minus_inf_approx);
@@ -825,9 +840,22 @@ namespace realclosure {
             bqim().del(a->m_interval);
             bqim().del(a->m_iso_interval);
             dec_ref_sign_det(a->m_sign_det);
+            reset_sign_cache(a);
             allocator().deallocate(sizeof(algebraic), a);
         }
 
+        void reset_sign_cache(algebraic * a) {
+            if (a->m_sign_cache == nullptr)
+                return;
+            for (unsigned i = 0; i < a->m_sign_cache_size; i++)
+                reset_p(a->m_sign_cache[i].m_q);
+            allocator().deallocate(sizeof(sign_entry) * a->m_sign_cache_capacity, a->m_sign_cache);
+            a->m_sign_cache = nullptr;
+            a->m_sign_cache_capacity = 0;
+            a->m_sign_cache_size = 0;
+            a->m_sign_cache_next = 0;
+        }
+
         void del_transcendental(transcendental * t) {
             bqim().del(t->m_interval);
             allocator().deallocate(sizeof(transcendental), t);
@@ -4728,9 +4756,46 @@ namespace realclosure {
             }
         }
 
+        /**
+           \brief Return true if the sign of q(x) is in the sign cache of x, and store it in s.
+        */
+        bool find_cached_sign(polynomial const & q, algebraic * x, int & s) {
+            for (unsigned i = 0; i < x->m_sign_cache_size; i++) {
+                sign_entry const & e = x->m_sign_cache[i];
+                if (struct_eq(e.m_q, q)) {
+                    s = e.m_sign;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void cache_sign(polynomial const & q, algebraic * x, int s) {
+            if (m_sign_cache_capacity == 0 || q.empty())
+                return;
+            if (x->m_sign_cache == nullptr) {
+                x->m_sign_cache_capacity = m_sign_cache_capacity;
+                x->m_sign_cache = static_cast<sign_entry*>(allocator().allocate(sizeof(sign_entry) * x->m_sign_cache_capacity));
+            }
+            unsigned i = x->m_sign_cache_next;
+            if (i < x->m_sign_cache_size) {
+                reset_p(x->m_sign_cache[i].m_q);
+            }
+            else {
+                new (x->m_sign_cache + i) sign_entry();
+                x->m_sign_cache_size++;
+            }
+            set_p(x->m_sign_cache[i].m_q, q.size(), q.data());
+            x->m_sign_cache[i].m_sign = s;
+            x->m_sign_cache_next = (i + 1) % x->m_sign_cache_capacity;
+        }
+
         /**
            \brief If q(x) != 0, return true and store in r an interval that contains the value q(x), but does not contain 0.
                   If q(x) == 0, return false
+
+           The signs determined by Tarski queries are cached in x, since the same polynomial
+           is often evaluated at x again when values over the same field are reconstructed.
         */
         bool expensive_algebraic_poly_interval(polynomial const & q, algebraic * x, mpbqi & r) {
             polynomial_interval(q, x->interval(), r);
@@ -4742,6 +4807,32 @@ namespace realclosure {
                 }
                 return true;
             }
+            int s;
+            if (find_cached_sign(q, x, s)) {
+                if (s == 0)
+                    return false;
+                if (x->sdt() == nullptr && !depends_on_infinitesimals(q, x))
+                    refine_until_sign_determined(q, x, r);
+                else if (s > 0)
+                    set_lower_zero(r);
+                else
+                    set_upper_zero(r);
+                SASSERT(!contains_zero(r));
+                return true;
+            }
+            bool nz = sign_algebraic_poly_interval(q, x, r);
+            if (!nz)
+                cache_sign(q, x, 0);
+            else
+                cache_sign(q, x, !r.lower_is_inf() && bqm().is_nonneg(r.lower()) ? 1 : -1);
+            return nz;
+        }
+
+        /**
+           \brief Auxiliary method for expensive_algebraic_poly_interval.
+           It uses Tarski queries to determine the sign of q(x), where the interval of q(x) contains 0.
+        */
+        bool sign_algebraic_poly_interval(polynomial const & q, algebraic * x, mpbqi & r) {
             int num_roots = x->num_roots_inside_interval();
             SASSERT(x->sdt() != 0 || num_roots == 1);
             polynomial const & p = x->p();
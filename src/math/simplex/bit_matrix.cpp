@@ -65,10 +65,14 @@ bit_matrix::row bit_matrix::add_row() {
 }
 
 bit_matrix::row& bit_matrix::row::operator+=(row const& other) {
-    for (unsigned i = 0; i < m.m_num_chunks; ++i) {
+    add(other, 0);
+    return *this;
+}
+
+void bit_matrix::row::add(row const& other, unsigned from_chunk) {
+    for (unsigned i = from_chunk; i < m.m_num_chunks; ++i) {
         r[i] ^= other.r[i];
     }
-    return *this;
 }
 
 struct bit_matrix::report {
@@ -91,8 +95,9 @@ void bit_matrix::basic_solve() {
         auto ci = r.begin();
         if (ci != r.end()) {
             unsigned c = *ci;
+            // columns before c are zero in r
             for (row& r2 : *this) {
-                if (r2 != r && r2[c]) r2 += r;
+                if (r2 != r && r2[c]) r2.add(r, c >> 6);
             }
         }        
     }
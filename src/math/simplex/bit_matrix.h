@@ -52,6 +52,8 @@ public:
         void set(unsigned i) { SASSERT((i >> 6) < m.m_num_chunks); r[i >> 6] |= (1ull << (i & 63)); }
         void unset(unsigned i) { SASSERT((i >> 6) < m.m_num_chunks); r[i >> 6] &= ~(1ull << (i & 63)); }
         row& operator+=(row const& other);
+        // add other, whose chunks below from_chunk are known to be zero.
+        void add(row const& other, unsigned from_chunk);
 
         // using pointer equality:
         bool operator==(row const& other) const { return r == other.r; }
@@ -1734,14 +1734,73 @@ namespace opt {
             d.substitute(v, new_def);
     }
     
+    /**
+       \brief estimate the number of rows created by projecting x.
+       Variables that are only bounded from one side are retired with their rows,
+       variables in an equality are substituted, and otherwise the small case
+       of project resolves every pair of lower and upper bounds.
+       Variables in divisibility, mod or div constraints, which introduce case
+       splits and fresh variables, are projected last.
+    */
+    unsigned model_based_opt::elimination_cost(unsigned x) const {
+        unsigned lub = 0, glb = 0;
+        bool has_eq = false;
+        for (unsigned row_id : m_var2row_ids[x]) {
+            row const& r = m_rows[row_id];
+            if (!r.m_alive)
+                continue;
+            rational a = r.get_coefficient(x);
+            if (a.is_zero())
+                continue;
+            switch (r.m_type) {
+            case t_eq: has_eq = true; break;
+            case t_mod: case t_div: case t_divides: return UINT_MAX;
+            default: if (a.is_pos()) ++lub; else ++glb; break;
+            }
+        }
+        if (lub == 0 || glb == 0)
+            return 0;
+        if (has_eq)
+            return lub + glb;
+        if ((lub <= 2 || glb <= 2) && lub <= 3 && glb <= 3)
+            return lub * glb;
+        return lub + glb;
+    }
+
     vector<model_based_opt::def> model_based_opt::project(unsigned num_vars, unsigned const* vars, bool compute_def) {
+        // pick the cheapest variable first. The scan is quadratic in the number
+        // of variables, so long lists are projected in the given order.
+        static const unsigned max_reorder = 64;
         m_result.reset();
-        for (unsigned i = 0; i < num_vars; ++i) {
-            m_result.push_back(project(vars[i], compute_def));
-            eliminate(vars[i], m_result.back());
-            TRACE("opt", display(tout << "After projecting: v" << vars[i] << "\n"););
+        unsigned_vector order;
+        bool_vector done(num_vars, false);
+        for (unsigned k = 0; k < num_vars; ++k) {
+            unsigned best = k;
+            if (num_vars <= max_reorder) {
+                unsigned best_cost = UINT_MAX;
+                best = UINT_MAX;
+                for (unsigned i = 0; i < num_vars; ++i) {
+                    if (done[i])
+                        continue;
+                    unsigned cost = elimination_cost(vars[i]);
+                    if (best == UINT_MAX || cost < best_cost) {
+                        best = i;
+                        best_cost = cost;
+                    }
+                    if (cost == 0)
+                        break;
+                }
+            }
+            done[best] = true;
+            order.push_back(best);
+            m_result.push_back(project(vars[best], compute_def));
+            eliminate(vars[best], m_result.back());
+            TRACE("opt", display(tout << "After projecting: v" << vars[best] << "\n"););
         }
-        return m_result;
+        vector<def> result(num_vars);
+        for (unsigned k = 0; k < num_vars; ++k)
+            result[order[k]] = m_result[k];
+        return result;
     }
 
 }
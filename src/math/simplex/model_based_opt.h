@@ -104,6 +104,8 @@ namespace opt {
         vector<model_based_opt::def> m_result;
 
         void eliminate(unsigned v, def const& d);
+
+        unsigned elimination_cost(unsigned x) const;
         
         bool invariant();
         bool invariant(unsigned index, row const& r);
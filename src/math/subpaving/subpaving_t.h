@@ -522,6 +522,7 @@ private:
     unsigned                  m_num_mk_bounds;
     unsigned                  m_num_splits;
     unsigned                  m_num_visited;
+    unsigned                  m_num_pruned;
     
     // Temporary
     numeral                   m_tmp1, m_tmp2, m_tmp3;
@@ -565,6 +566,7 @@ private:
     node * mk_node(node * parent = nullptr);
     void del_node(node * n);
     void del_nodes();
+    void del_closed_subtree(node * n);
 
     void del(interval & a);
     void del_clauses(ptr_vector<clause> & cs);
@@ -965,6 +965,23 @@ void context_t<C>::del_nodes() {
     }
 }
 
+/**
+   \brief Delete the inconsistent leaf n, and every ancestor other than the root
+   whose children were all deleted. Closed leaves are never selected again,
+   so deleting them keeps the tree, and the node budget max_nodes, proportional
+   to the open part of the search.
+*/
+template<typename C>
+void context_t<C>::del_closed_subtree(node * n) {
+    SASSERT(n->inconsistent());
+    while (n != m_root && n->first_child() == nullptr) {
+        node * p = n->parent();
+        del_node(n);
+        m_num_pruned++;
+        n = p;
+    }
+}
+
 template<typename C>
 void context_t<C>::push_front(node * n) {
     SASSERT(n->first_child() == 0);
@@ -1839,6 +1856,7 @@ void context_t<C>::operator()() {
         if (n->inconsistent()) {
             TRACE("subpaving_main", tout << "node #" << n->id() << " is inconsistent.\n";);
             // TODO: conflict resolution
+            del_closed_subtree(n);
             continue;
         }
         if (n->depth() >= m_max_depth) {
@@ -1884,6 +1902,7 @@ void context_t<C>::reset_statistics() {
     m_num_mk_bounds = 0;
     m_num_splits    = 0;
     m_num_visited   = 0;
+    m_num_pruned    = 0;
 }
 
 template<typename C>
@@ -1893,6 +1912,7 @@ void context_t<C>::collect_statistics(statistics & st) const {
     st.update("splits",     m_num_splits);
     st.update("nodes",      m_num_nodes);
     st.update("visited",    m_num_visited);
+    st.update("pruned",     m_num_pruned);
 }
 
 // -----------------------------------
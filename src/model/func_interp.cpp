@@ -177,6 +177,16 @@ bool func_interp::is_constant() const {
    args_are_values to true if for all entries e e.args_are_values() is true.
 */
 func_entry * func_interp::get_entry(expr * const * args) const {
+    if (m_entries.size() >= index_threshold) {
+        if (!m_index)
+            build_index();
+        func_entry * e = nullptr;
+        if (m_index->find(args, e))
+            return e;
+        // pointer-distinct unique values are never equal, so the index is complete for them.
+        if (m_num_non_unique == 0 && has_unique_args(args))
+            return nullptr;
+    }
     for (func_entry* curr : m_entries) {
         if (curr->eq_args(m(), m_arity, args))
             return curr;
@@ -184,6 +194,34 @@ func_entry * func_interp::get_entry(expr * const * args) const {
     return nullptr;
 }
 
+bool func_interp::has_unique_args(expr * const * args) const {
+    for (unsigned i = 0; i < m_arity; ++i)
+        if (!m().is_unique_value(args[i]))
+            return false;
+    return true;
+}
+
+void func_interp::build_index() const {
+    m_index = alloc(entry_index, args_hash(m_arity), args_eq(m_arity));
+    m_num_non_unique = 0;
+    for (func_entry * curr : m_entries)
+        index_entry(curr);
+}
+
+void func_interp::index_entry(func_entry * e) const {
+    m_index->insert_if_not_there(e->get_args(), e);
+    if (!has_unique_args(e->get_args()))
+        ++m_num_non_unique;
+}
+
+void func_interp::unindex_entry(func_entry * e) {
+    func_entry * f = nullptr;
+    if (m_index->find(e->get_args(), f) && f == e)
+        m_index->erase(e->get_args());
+    if (!has_unique_args(e->get_args()))
+        --m_num_non_unique;
+}
+
 void func_interp::insert_entry(expr * const * args, expr * r) {
     reset_interp_cache();
     func_entry * entry = get_entry(args);
@@ -214,10 +252,14 @@ void func_interp::insert_new_entry(expr * const * args, expr * r) {
     if (!new_entry->args_are_values())
         m_args_are_values = false;
     m_entries.push_back(new_entry);
+    if (m_index)
+        index_entry(new_entry);
 }
 
 void func_interp::del_entry(unsigned idx) {
     auto* e = m_entries[idx];
+    if (m_index)
+        unindex_entry(e);
     m_entries[idx] = m_entries.back();
     m_entries.pop_back();
     e->deallocate(m(), m_arity);
@@ -278,6 +320,7 @@ void func_interp::compress() {
     if (j < m_entries.size()) {
         reset_interp_cache();
         m_entries.shrink(j);
+        m_index = nullptr;
     }
     // other compression, if else is a default branch.
     // or function encode identity.
@@ -302,6 +345,7 @@ void func_interp::compress() {
             curr->deallocate(m(), m_arity);
         }
         m_entries.reset();
+        m_index = nullptr;
         reset_interp_cache();
         expr_ref new_else(m().mk_var(0, m_else->get_sort()), m());
         m().inc_ref(new_else);
@@ -29,6 +29,7 @@ Revision History:
 --*/
 #pragma once
 
+#include "util/map.h"
 #include "ast/ast.h"
 #include "ast/ast_translation.h"
 
@@ -64,9 +65,38 @@ public:
 };
 
 class func_interp {
+    struct args_hash {
+        unsigned m_arity;
+        args_hash(unsigned arity): m_arity(arity) {}
+        unsigned operator()(expr * const * args) const {
+            unsigned h = m_arity;
+            for (unsigned i = 0; i < m_arity; ++i)
+                h = combine_hash(h, args[i]->get_id());
+            return h;
+        }
+    };
+    struct args_eq {
+        unsigned m_arity;
+        args_eq(unsigned arity): m_arity(arity) {}
+        bool operator()(expr * const * a, expr * const * b) const {
+            for (unsigned i = 0; i < m_arity; ++i)
+                if (a[i] != b[i])
+                    return false;
+            return true;
+        }
+    };
+    typedef map<expr * const *, func_entry *, args_hash, args_eq> entry_index;
+
+    // interpretations with at least this many entries are indexed by their arguments
+    static const unsigned  index_threshold = 16;
+
     ast_manager &          m_manager;
     unsigned               m_arity;
     ptr_vector<func_entry> m_entries;
+    // index of m_entries by argument pointers, built on the first lookup in a large interpretation.
+    mutable scoped_ptr<entry_index> m_index;
+    // number of indexed entries with an argument that is not a unique value.
+    mutable unsigned       m_num_non_unique = 0;
     expr *                 m_else;
     bool                   m_args_are_values; //!< true if forall e in m_entries e.args_are_values() == true
 
@@ -76,6 +106,11 @@ class func_interp {
 
     void reset_interp_cache();
 
+    bool has_unique_args(expr * const * args) const;
+    void build_index() const;
+    void index_entry(func_entry * e) const;
+    void unindex_entry(func_entry * e);
+
     expr * get_interp_core() const;
 
     expr_ref get_array_interp_core(func_decl * f) const;
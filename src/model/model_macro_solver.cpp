@@ -24,6 +24,10 @@ void base_macro_solver::set_else_interp(func_decl* f, expr* f_else) {
         m_model->register_decl(f, fi);
     }
     fi->set_else(f_else);
+    if (m_else_decls) {
+        m_else_decls->push_back(f);
+        m_else_defs->push_back(f_else);
+    }
     TRACE("model_finder", tout << f->get_name() << " " << mk_pp(f_else, m) << "\n";);
 }
 
@@ -32,6 +32,8 @@ protected:
     ast_manager& m;
     quantifier2macro_infos& m_q2info;
     model_core* m_model;
+    func_decl_ref_vector* m_else_decls = nullptr;
+    expr_ref_vector* m_else_defs = nullptr;
 
     quantifier_macro_info* get_qinfo(quantifier* q) const {
         return m_q2info(q);
@@ -50,6 +52,14 @@ public:
 
     virtual ~base_macro_solver() = default;
 
+    /**
+       \brief record the else interpretations assigned by the solver in decls and defs.
+    */
+    void set_else_log(func_decl_ref_vector& decls, expr_ref_vector& defs) {
+        m_else_decls = &decls;
+        m_else_defs = &defs;
+    }
+
     /**
        \brief Try to satisfy quantifiers in qs by using macro definitions.
        Store in new_qs the quantifiers that were not satisfied.
@@ -29,6 +29,7 @@ Revision History:
 #include "ast/scoped_proof.h"
 #include "ast/ast_pp_util.h"
 #include "ast/ast_util.h"
+#include "ast/converters/generic_model_converter.h"
 #include "muz/base/dl_context.h"
 #include "muz/base/fp_params.hpp"
 
@@ -246,6 +247,8 @@ namespace datalog {
         m_preds.reset();
         m_preds_by_name.reset();
         reset_dealloc_values(m_sorts);
+        m_transformations.reset();
+        m_pending_transformation = nullptr;
         m_engine = nullptr;
         m_rel = nullptr;
     }
@@ -681,6 +684,29 @@ namespace datalog {
         add_table_fact(pred, fact);
     }
 
+    void context::add_table_facts(func_decl * pred, unsigned num_facts, table_element const* args) {
+        if (!is_uninterp(pred)) {
+            std::stringstream strm;
+            strm << "Predicate " << pred->get_name() << " when used for facts should be uninterpreted";        
+            throw default_exception(strm.str());
+        }
+        if (num_facts == 0)
+            return;
+        if (get_engine() == DATALOG_ENGINE) {
+            ensure_engine();
+            m_rel->add_facts(pred, num_facts, args);
+        }
+        else {
+            unsigned n = pred->get_arity();
+            table_fact fact;
+            for (unsigned i = 0; i < num_facts; ++i, args += n) {
+                fact.reset();
+                fact.append(n, args);
+                add_table_fact(pred, fact);
+            }
+        }
+    }
+
     void context::close() {
         SASSERT(!m_closed);
         if (!m_rule_set.close()) {
@@ -733,6 +759,85 @@ namespace datalog {
         }
     }
 
+    void context::add_model_converter(model_converter* mc) {
+        m_mc = concat(m_mc.get(), mc);
+        if (m_pending_transformation && mc)
+            m_pending_transformation->m_mcs.push_back(mc);
+    }
+
+    void context::add_proof_converter(proof_converter* pc) {
+        m_pc = concat(m_pc.get(), pc);
+        if (m_pending_transformation && pc)
+            m_pending_transformation->m_pcs.push_back(pc);
+    }
+
+    bool context::transformation::same_key(transformation const& other) const {
+        if (m_rules.size() != other.m_rules.size() || m_query.size() != other.m_query.size())
+            return false;
+        for (unsigned i = 0; i < m_rules.size(); ++i)
+            if (m_rules.get(i) != other.m_rules.get(i))
+                return false;
+        for (unsigned i = 0; i < m_query.size(); ++i)
+            if (m_query.get(i) != other.m_query.get(i))
+                return false;
+        return m_params == other.m_params;
+    }
+
+    bool context::find_transformed_rules() {
+        m_pending_transformation = nullptr;
+        SASSERT(m_closed);
+        if (get_params().xform_transformation_cache() == 0 || m_rule_set.get_output_predicates().size() != 1)
+            return false;
+        func_decl* q = m_rule_set.get_output_predicate();
+        scoped_ptr<transformation> t = alloc(transformation, m_rule_manager, m);
+        for (rule* r : m_rule_set) {
+            if (r->get_decl() != q) {
+                t->m_rules.push_back(r);
+                continue;
+            }
+            // the query predicate is fresh for every query, so only its 
+            // arguments and the body of its rules identify the query.
+            t->m_query.push_back(nullptr);
+            t->m_query.append(r->get_head()->get_num_args(), r->get_head()->get_args());
+            for (unsigned i = 0; i < r->get_tail_size(); ++i) 
+                t->m_query.push_back(r->is_neg_tail(i) ? m.mk_not(r->get_tail(i)) : r->get_tail(i));
+        }
+        std::stringstream strm;
+        m_params_ref.display(strm);
+        t->m_params = strm.str();
+        for (transformation* e : m_transformations) {
+            if (!e->same_key(*t))
+                continue;
+            IF_VERBOSE(2, verbose_stream() << "(fp.reuse-transformed-rules)\n");
+            m_rule_set.reopen();
+            m_rule_set.replace_rules(*e->m_result);
+            m_rule_set.ensure_closed();
+            if (m_mc) {
+                generic_model_converter* mc = alloc(generic_model_converter, m, "dl_rule");
+                mc->hide(e->m_query_pred);
+                add_model_converter(mc);
+            }
+            for (model_converter* mc : e->m_mcs)
+                add_model_converter(mc);
+            for (proof_converter* pc : e->m_pcs)
+                add_proof_converter(pc);
+            return true;
+        }
+        t->m_query_pred = q;
+        m_pending_transformation = t.detach();
+        return false;
+    }
+
+    void context::insert_transformed_rules() {
+        scoped_ptr<transformation> t = m_pending_transformation.detach();
+        if (!t || canceled())
+            return;
+        t->m_result = alloc(rule_set, m_rule_set);
+        if (m_transformations.size() >= get_params().xform_transformation_cache())
+            m_transformations.reset();
+        m_transformations.push_back(t.detach());
+    }
+
     void context::record_transformed_rules() {
         m_transformed_rule_set.replace_rules(m_rule_set);
     }
@@ -22,6 +22,7 @@ Revision History:
 #include "util/map.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "util/str_hashtable.h"
+#include "util/scoped_ptr_vector.h"
 #include "ast/rewriter/var_subst.h"
 #include "muz/base/dl_costs.h"
 #include "ast/dl_decl_plugin.h"
@@ -117,6 +118,7 @@ namespace datalog {
         virtual bool result_contains_fact(relation_fact const& f) = 0;
         virtual void add_fact(func_decl* pred, relation_fact const& fact) = 0;
         virtual void add_fact(func_decl* pred, table_fact const& fact) = 0;
+        virtual void add_facts(func_decl* pred, unsigned num_facts, table_element const* facts) = 0;
         virtual bool has_facts(func_decl * pred) const = 0;
         virtual void store_relation(func_decl * pred, relation_base * rel) = 0;
         virtual void inherit_predicate_kind(func_decl* new_pred, func_decl* orig_pred) = 0;
@@ -192,6 +194,25 @@ namespace datalog {
         model_converter_ref m_mc;
         proof_converter_ref m_pc;
 
+        /**
+           \brief result of the default transformation of a rule set.
+           The key consists of the rules that are not query rules, the heads and
+           tails of the query rules and the parameters.
+        */
+        struct transformation {
+            rule_ref_vector             m_rules;
+            expr_ref_vector             m_query;
+            std::string                 m_params;
+            scoped_ptr<rule_set>        m_result;
+            func_decl_ref               m_query_pred;
+            sref_vector<model_converter> m_mcs;
+            sref_vector<proof_converter> m_pcs;
+            transformation(rule_manager& rm, ast_manager& m): m_rules(rm), m_query(m), m_query_pred(m) {}
+            bool same_key(transformation const& other) const;
+        };
+        scoped_ptr_vector<transformation> m_transformations;
+        scoped_ptr<transformation>        m_pending_transformation;
+
         rel_context_base*               m_rel;
         scoped_ptr<engine_base>         m_engine;
 
@@ -448,6 +469,12 @@ namespace datalog {
         void add_table_fact(func_decl * pred, const table_fact & fact);
         void add_table_fact(func_decl * pred, unsigned num_args, unsigned args[]);
 
+        /**
+           \brief Add \c num_facts facts to \c pred. The arguments of the facts are stored
+           consecutively in \c args.
+        */
+        void add_table_facts(func_decl * pred, unsigned num_facts, table_element const* args);
+
         /**
            \brief To be called after all rules are added.
         */
@@ -462,9 +489,19 @@ namespace datalog {
         void ensure_opened();
 
         model_converter_ref& get_model_converter() { return m_mc; }
-        void add_model_converter(model_converter* mc) { m_mc = concat(m_mc.get(), mc); }
+        void add_model_converter(model_converter* mc);
         proof_converter_ref& get_proof_converter() { return m_pc; }
-        void add_proof_converter(proof_converter* pc) { m_pc = concat(m_pc.get(), pc); }
+        void add_proof_converter(proof_converter* pc);
+
+        /**
+           \brief Replace the closed rule set by the cached result of transforming 
+           the same rules for the same query and parameters, and re-add the
+           model and proof converters that the transformation produced.
+           Return false if there is no such result. The transformed rules are
+           then cached by \c insert_transformed_rules.
+        */
+        bool find_transformed_rules();
+        void insert_transformed_rules();
 
         void transform_rules(rule_transformer& transf);
         void transform_rules(rule_transformer::plugin* plugin);
@@ -483,7 +483,13 @@ namespace datalog {
             q_at_level = m.mk_implies(q, p);
             b.assert_expr(q_at_level);
             expr* qr = q.get();
-            return b.m_solver->check_sat(1, &qr);
+            lbool res = b.m_solver->check_sat(1, &qr);
+            if (res == l_false) {
+                // retire the activation literal, so that the solver 
+                // can discard the query clause of this level.
+                b.assert_expr(m.mk_not(q));
+            }
+            return res;
         }
 
         proof_ref get_proof(model_ref& md, func_decl* pred, app* prop, unsigned level) {
@@ -1303,7 +1309,13 @@ namespace datalog {
         lbool check(unsigned level) {
             expr_ref level_query = mk_level_predicate(b.m_query_pred, level);
             expr* q = level_query.get();
-            return b.m_solver->check_sat(1, &q);
+            lbool res = b.m_solver->check_sat(1, &q);
+            if (res == l_false) {
+                // the unrolling entails that the query is unreachable at this level.
+                // Asserting it lets the next levels propagate it without re-deriving it.
+                b.assert_expr(m.mk_not(q));
+            }
+            return res;
         }
 
         expr_ref mk_level_predicate(func_decl* p, unsigned level) {
@@ -14,7 +14,14 @@ Copyright (c) 2015 Microsoft Corporation
 #include "util/warning.h"
 #include<iostream>
 #include<sstream>
+#include<fstream>
 #include<cstdio>
+#ifndef _WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace datalog;
 
@@ -167,6 +174,61 @@ public:
     bool eof() const { return m_eof; }
 };
 
+/**
+   \brief Contents of a file. The file is mapped into memory when the platform
+   supports it, and read into a buffer otherwise.
+*/
+class file_contents {
+    char const* m_begin = nullptr;
+    char const* m_end = nullptr;
+    void*       m_mapped = nullptr;
+    size_t      m_size = 0;
+    std::vector<char> m_data;
+    bool        m_ok = false;
+public:
+    file_contents(char const* fname) {
+#ifndef _WINDOWS
+        int fd = open(fname, O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                size_t size = static_cast<size_t>(st.st_size);
+                void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    madvise(data, size, MADV_SEQUENTIAL);
+                    m_mapped = data;
+                    m_size = size;
+                    m_begin = static_cast<char const*>(data);
+                    m_end = m_begin + size;
+                    m_ok = true;
+                }
+            }
+            close(fd);
+            if (m_ok)
+                return;
+        }
+#endif
+        std::ifstream in(fname, std::ios::binary);
+        if (in.fail())
+            return;
+        m_data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m_begin = m_data.data();
+        m_end = m_begin + m_data.size();
+        m_ok = true;
+    }
+
+    ~file_contents() {
+#ifndef _WINDOWS
+        if (m_mapped)
+            munmap(m_mapped, m_size);
+#endif
+    }
+
+    bool operator()() const { return m_ok; }
+    char const* begin() const { return m_begin; }
+    char const* end() const { return m_end; }
+};
+
 class char_reader {
     line_reader m_line_reader;
     char const* m_line;
@@ -1331,33 +1393,42 @@ private:
         m_lexer = nullptr;
     }
 
-    bool parse_rel_line(char * full_line, uint64_vector & args) {
+    /**
+       \brief Parse the numbers of the line [ptr, end), which does not contain a newline.
+       Return false if the line is empty or a comment.
+    */
+    bool parse_rel_line(char const * ptr, char const * end, uint64_vector & args) {
         SASSERT(args.empty());
-        cut_off_comment(full_line);
-        if(full_line[0]==0) {
-            return false;
+        char const * eol = ptr;
+        while (eol < end && *eol != '#' && *eol != '\r') {
+            eol++;
         }
-        const char * ptr = full_line;
-
-        bool last = false;
-        do {
-            while(*ptr==' ') { ptr++; }
-            if(*ptr==0) {
+        while (true) {
+            while (ptr < eol && *ptr == ' ') { ptr++; }
+            if (ptr == eol) {
                 break;
             }
-            uint64_t num;
-            if(!read_uint64(ptr, num)) {
+            if (*ptr < '0' || *ptr > '9') {
                 throw default_exception(default_exception::fmt(), "number expected on line %d in file %s", 
                     m_current_line, m_current_file.c_str());
             }
-            if(*ptr!=' ' && *ptr!=0) {
+            uint64_t num = 0;
+            for (; ptr < eol && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+                uint64_t digit = *ptr - '0';
+                if (num > (UINT64_MAX - digit) / 10) {
+                    throw default_exception(default_exception::fmt(), "number expected on line %d in file %s", 
+                        m_current_line, m_current_file.c_str());
+                }
+                num = 10 * num + digit;
+            }
+            if (ptr < eol && *ptr != ' ') {
                 throw default_exception(default_exception::fmt(), 
                                         "' ' expected to separate numbers on line %d in file %s, got '%s'", 
-                                        m_current_line, m_current_file.c_str(), ptr);
+                                        m_current_line, m_current_file.c_str(), std::string(ptr, eol).c_str());
             }
             args.push_back(num);
-        } while(!last);
-        return true;
+        }
+        return !args.empty();
     }
 
     void parse_rel_file(const std::string & fname) {
@@ -1380,18 +1451,27 @@ private:
         sort * const * arg_sorts = pred->get_domain();
 
         uint64_vector args;
-        table_fact fact;
-
-        //std::ifstream stm(fname.c_str(), std::ios_base::binary);
-        //SASSERT(!stm.fail());
-        //line_reader rdr(stm);
-        line_reader rdr(fname.c_str());
-        while(!rdr.eof()) {
+        // facts are collected in chunks and added to the relation in bulk.
+        static const unsigned chunk_size = 4096;
+        table_fact facts;
+        unsigned num_facts = 0;
+
+        file_contents in(fname.c_str());
+        if (!in()) {
+            throw default_exception(default_exception::fmt(), "could not open file %s", m_current_file.c_str());
+        }
+        char const * ptr = in.begin();
+        char const * end = in.end();
+        while (ptr < end) {
             m_current_line++;
-            char * full_line = rdr.get_line();
-
+            char const * eol = static_cast<char const*>(memchr(ptr, '\n', end - ptr));
+            if (!eol) {
+                eol = end;
+            }
             args.reset();
-            if(!parse_rel_line(full_line, args)) {
+            bool has_fact = parse_rel_line(ptr, eol, args);
+            ptr = eol + 1;
+            if (!has_fact) {
                 continue;
             }
             if(args.size()!=pred_arity) {
@@ -1400,7 +1480,7 @@ private:
             }
 
             bool fact_fail = false;
-            fact.reset();
+            unsigned sz = facts.size();
             for(unsigned i=0;i<pred_arity; i++) {
                 uint64_t const_num = args[i];
                 table_element c;
@@ -1408,13 +1488,19 @@ private:
                     fact_fail = true;
                     break;
                 }
-                fact.push_back(c);
+                facts.push_back(c);
             }
             if(fact_fail) {
+                facts.shrink(sz);
                 continue;
             }
-            m_context.add_table_fact(pred, fact);
+            if (++num_facts == chunk_size) {
+                m_context.add_table_facts(pred, num_facts, facts.data());
+                facts.reset();
+                num_facts = 0;
+            }
         }
+        m_context.add_table_facts(pred, num_facts, facts.data());
     }
 
     void finish_map_files() {
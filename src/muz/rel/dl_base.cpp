@@ -249,6 +249,16 @@ namespace datalog {
         }
     }
 
+    void table_base::add_facts(unsigned fact_cnt, const table_element * facts) {
+        unsigned sz = get_signature().size();
+        table_fact f;
+        for (unsigned i = 0; i < fact_cnt; i++) {
+            f.reset();
+            f.append(sz, facts + i*sz);
+            add_fact(f);
+        }
+    }
+
 
     void table_base::reset() {
         vector<table_fact> to_remove;
@@ -1075,6 +1075,11 @@ namespace datalog {
         virtual void remove_fact(table_element const* fact) = 0;
         virtual void remove_facts(unsigned fact_cnt, const table_fact * facts);
         virtual void remove_facts(unsigned fact_cnt, const table_element * facts);
+
+        /**
+           \brief Add \c fact_cnt facts whose columns are stored consecutively in \c facts.
+        */
+        virtual void add_facts(unsigned fact_cnt, const table_element * facts);
         void reset() override;
 
         class row_interface;
@@ -21,10 +21,19 @@ Revision History:
 #include "util/stopwatch.h"
 #include "muz/base/dl_context.h"
 #include "muz/base/dl_util.h"
+#include "muz/base/fp_params.hpp"
 #include "muz/rel/dl_instruction.h"
 #include "muz/rel/rel_context.h"
+#include "muz/rel/dl_sparse_table.h"
+#include "muz/rel/dl_table_relation.h"
 #include "util/debug.h"
 #include "util/warning.h"
+#include "util/scoped_ptr_vector.h"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace datalog {
 
@@ -121,6 +130,27 @@ namespace datalog {
              m_timelimit_ms < static_cast<unsigned>(1000*m_stopwatch->get_current_seconds()));
     }
 
+    void execution_context::stats::add(stats const& other) {
+        m_join += other.m_join;
+        m_project += other.m_project;
+        m_filter += other.m_filter;
+        m_total += other.m_total;
+        m_unary_singleton += other.m_unary_singleton;
+        m_filter_by_negation += other.m_filter_by_negation;
+        m_select_equal_project += other.m_select_equal_project;
+        m_join_project += other.m_join_project;
+        m_project_rename += other.m_project_rename;
+        m_union += other.m_union;
+        m_filter_interp_project += other.m_filter_interp_project;
+        m_filter_id += other.m_filter_id;
+        m_filter_eq += other.m_filter_eq;
+        m_min += other.m_min;
+    }
+
+    unsigned execution_context::num_threads() const {
+        return m_context.get_params().datalog_threads();
+    }
+
     void execution_context::collect_statistics(statistics& st) const {
         st.update("dl.joins",   m_stats.m_join);
         st.update("dl.project", m_stats.m_project);
@@ -179,6 +209,12 @@ namespace datalog {
         IF_VERBOSE(2, display(ctx, verbose_stream()););
     }
 
+    static void add_register(unsigned_vector & regs, execution_context::reg_idx r) {
+        if (r != execution_context::void_register) {
+            regs.push_back(r);
+        }
+    }
+
     class instr_io : public instruction {
         bool m_store;
         func_decl_ref m_pred;
@@ -249,6 +285,10 @@ namespace datalog {
         std::ostream& display_head_impl(execution_context const& ctx, std::ostream & out) const override {
             return out << "dealloc " << m_reg;
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(writes, m_reg);
+            return true;
+        }
     };
 
     instruction * instruction::mk_dealloc(reg_idx reg) {
@@ -284,6 +324,11 @@ namespace datalog {
         std::ostream& display_head_impl(execution_context const& ctx, std::ostream & out) const override {
             return out << (m_clone ? "clone " : "move ") << m_src << " into " << m_tgt;
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(m_clone ? reads : writes, m_src);
+            add_register(writes, m_tgt);
+            return true;
+        }
     };
 
     instruction * instruction::mk_clone(reg_idx from, reg_idx to) {
@@ -413,6 +458,12 @@ namespace datalog {
             print_container(m_cols2, out);
             return out << " into " << m_res;
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_rel1);
+            add_register(reads, m_rel2);
+            add_register(writes, m_res);
+            return true;
+        }
     };
 
     instruction * instruction::mk_join(reg_idx rel1, reg_idx rel2, unsigned col_cnt,
@@ -461,6 +512,10 @@ namespace datalog {
             return out << "filter_equal " << m_reg << " col: " << m_col << " val: "
                        << ctx.get_rel_context().get_rmanager().to_nice_string(m_value);
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(writes, m_reg);
+            return true;
+        }
     };
 
     instruction * instruction::mk_filter_equal(ast_manager & m, reg_idx reg, const relation_element & value, 
@@ -509,6 +564,10 @@ namespace datalog {
         void make_annotations(execution_context & ctx) override {
             ctx.set_register_annotation(m_reg, "filter_identical");
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(writes, m_reg);
+            return true;
+        }
     };
 
     instruction * instruction::mk_filter_identical(reg_idx reg, unsigned col_cnt, const unsigned * identical_cols) {
@@ -733,6 +792,13 @@ namespace datalog {
             }
             return out;
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_src);
+            add_register(writes, m_tgt);
+            add_register(writes, m_delta);
+            return true;
+        }
+        bool is_union() const override { return true; }
     };
 
     instruction * instruction::mk_union(reg_idx src, reg_idx tgt, reg_idx delta) {
@@ -796,6 +862,11 @@ namespace datalog {
             s << (m_projection ? "project " : "rename ") << a;
             ctx.set_register_annotation(m_tgt, s.str());
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_src);
+            add_register(writes, m_tgt);
+            return true;
+        }
     };
 
     instruction * instruction::mk_projection(reg_idx src, unsigned col_cnt, const unsigned * removed_cols, 
@@ -874,6 +945,12 @@ namespace datalog {
             ctx.get_register_annotation(m_rel2, s2);
             ctx.set_register_annotation(m_res, "join project " + s1 + " " + s2);            
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_rel1);
+            add_register(reads, m_rel2);
+            add_register(writes, m_res);
+            return true;
+        }
     };
 
     instruction * instruction::mk_join_project(reg_idx rel1, reg_idx rel2, unsigned joined_col_cnt,
@@ -933,6 +1010,11 @@ namespace datalog {
               << ctx.get_rel_context().get_rmanager().to_nice_string(m_value) << " " << s1;
             ctx.set_register_annotation(m_result, s.str());            
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_src);
+            add_register(writes, m_result);
+            return true;
+        }
     };
 
     instruction * instruction::mk_select_equal_and_project(ast_manager & m, reg_idx src, 
@@ -990,6 +1072,11 @@ namespace datalog {
             ctx.get_register_annotation(m_neg_rel, s);
             ctx.set_register_annotation(m_tgt, "filter by negation " + s);            
         }
+        bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const override {
+            add_register(reads, m_neg_rel);
+            add_register(writes, m_tgt);
+            return true;
+        }
     };
 
     instruction * instruction::mk_filter_by_negation(reg_idx tgt, reg_idx neg_rel, unsigned col_cnt,
@@ -1133,11 +1220,24 @@ namespace datalog {
         }
         m_data.reset();
         m_observer = nullptr;
+        m_schedule.reset();
+        m_scheduled = false;
     }
 
     bool instruction_block::perform(execution_context & ctx) const {
+#ifndef SINGLE_THREAD
+        unsigned num_threads = ctx.num_threads();
+        if (num_threads > 1) {
+            return perform_parallel(ctx, num_threads);
+        }
+#endif
+        return perform(ctx, 0, m_data.size());
+    }
+
+    bool instruction_block::perform(execution_context & ctx, unsigned begin, unsigned end) const {
         cost_recorder crec;
-        for (instruction * instr : m_data) {
+        for (unsigned i = begin; i < end; ++i) {
+            instruction * instr = m_data[i];
             crec.start(instr); //finish is performed by the next start() or by the destructor of crec
 
             TRACE("dl", instr->display_head_impl(ctx, tout << "% ") << "\n";);
@@ -1149,6 +1249,222 @@ namespace datalog {
         return true;
     }
 
+    /**
+       \brief split the block into rule evaluations and group consecutive
+       evaluations that use disjoint registers.
+
+       A rule evaluation is a sequence of instructions over registers that ends with
+       a union, followed by the deallocations of its registers. Its computation also
+       must not use registers of the merges of earlier evaluations in the group,
+       since these are only updated when all computations are done.
+       Reads are required to be disjoint as well, because sparse tables build indexes
+       lazily and use their reserve for lookups.
+    */
+    void instruction_block::mk_schedule() const {
+        m_schedule.reset();
+        unsigned_vector reads, writes, regs;
+        uint_set seen, merge_regs, group_regs;
+        bool new_group = true;
+        unsigned sz = m_data.size();
+        for (unsigned i = 0; i < sz; ) {
+            regs.reset();
+            seen.reset();
+            unsigned j = i;
+            for (; j < sz && !m_data[j]->is_union(); ++j) {
+                reads.reset();
+                writes.reset();
+                if (!m_data[j]->get_registers(reads, writes)) {
+                    break;
+                }
+                reads.append(writes);
+                for (unsigned r : reads) {
+                    if (!seen.contains(r)) {
+                        seen.insert(r);
+                        regs.push_back(r);
+                    }
+                }
+            }
+            if (j == i || j == sz || !m_data[j]->is_union()) {
+                m_schedule.push_back(segment({ i, i, i + 1, true, unsigned_vector() }));
+                new_group = true;
+                ++i;
+                continue;
+            }
+            merge_regs.reset();
+            reads.reset();
+            writes.reset();
+            m_data[j]->get_registers(reads, writes);
+            reads.append(writes);
+            for (unsigned r : reads) {
+                merge_regs.insert(r);
+            }
+            unsigned k = j + 1;
+            for (; k < sz; ++k) {
+                reads.reset();
+                writes.reset();
+                if (!m_data[k]->get_registers(reads, writes) || !reads.empty()) {
+                    break;
+                }
+                bool is_local = all_of(writes, [&](unsigned r) { return seen.contains(r) || merge_regs.contains(r); });
+                if (!is_local) {
+                    break;
+                }
+            }
+            if (!new_group && any_of(regs, [&](unsigned r) { return group_regs.contains(r); })) {
+                new_group = true;
+            }
+            if (new_group) {
+                group_regs.reset();
+            }
+            for (unsigned r : regs) {
+                group_regs.insert(r);
+            }
+            for (unsigned r : merge_regs) {
+                group_regs.insert(r);
+            }
+            m_schedule.push_back(segment({ i, j, k, new_group, regs }));
+            new_group = false;
+            i = k;
+        }
+        m_scheduled = true;
+    }
+
+    /**
+       \brief check that the relations used by the computations of segments
+       in [begin, end) are sparse tables, the only relations that are not
+       shared with the AST manager or other relations.
+    */
+    bool instruction_block::is_thread_safe(execution_context const & ctx, unsigned begin, unsigned end) const {
+        for (unsigned i = begin; i < end; ++i) {
+            for (unsigned r : m_schedule[i].m_regs) {
+                relation_base const * rel = ctx.reg(r);
+                if (!rel) {
+                    continue;
+                }
+                if (!rel->from_table()) {
+                    return false;
+                }
+                table_base const & t = static_cast<table_relation const *>(rel)->get_table();
+                if (!dynamic_cast<sparse_table_plugin const *>(&t.get_plugin())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool instruction_block::perform_parallel(execution_context & ctx, unsigned num_threads) const {
+        if (!m_scheduled) {
+            mk_schedule();
+        }
+        unsigned sz = m_schedule.size();
+        for (unsigned i = 0; i < sz; ) {
+            unsigned j = i + 1;
+            while (j < sz && !m_schedule[j].m_new_group) {
+                ++j;
+            }
+            if (j > i + 1 && is_thread_safe(ctx, i, j)) {
+                if (!perform_concurrently(ctx, i, j, num_threads)) {
+                    return false;
+                }
+                for (unsigned k = i; k < j; ++k) {
+                    if (!perform(ctx, m_schedule[k].m_merge, m_schedule[k].m_end)) {
+                        return false;
+                    }
+                }
+            }
+            else if (!perform(ctx, m_schedule[i].m_begin, m_schedule[j - 1].m_end)) {
+                return false;
+            }
+            i = j;
+        }
+        return true;
+    }
+
+    /**
+       \brief perform the computations of the segments in [begin, end).
+       Each thread has its own execution context, which owns the registers of
+       its segments while they are computed.
+    */
+    bool instruction_block::perform_concurrently(execution_context & ctx, unsigned begin, unsigned end, 
+                                                 unsigned num_threads) const {
+#ifdef SINGLE_THREAD
+        UNREACHABLE();
+        return false;
+#else
+        num_threads = std::min(num_threads, end - begin);
+        context & dctx = ctx.get_rel_context().get_context();
+        scoped_ptr_vector<execution_context> ctxs;
+        for (unsigned t = 0; t < num_threads; ++t) {
+            ctxs.push_back(alloc(execution_context, dctx));
+        }
+        auto get_ctx = [&](unsigned i) -> execution_context & { return *ctxs[(i - begin) % num_threads]; };
+        for (unsigned i = begin; i < end; ++i) {
+            for (unsigned r : m_schedule[i].m_regs) {
+                if (ctx.reg(r)) {
+                    get_ctx(i).set_reg(r, ctx.release_reg(r));
+                }
+            }
+        }
+
+        std::atomic<bool> completed(true);
+        std::mutex mux;
+        enum { NO_EX, ERROR_EX, DEFAULT_EX } ex_kind = NO_EX;
+        std::string ex_msg;
+        unsigned error_code = 0;
+        auto worker = [&](unsigned t) {
+            try {
+                for (unsigned i = begin + t; i < end && completed; i += num_threads) {
+                    segment const & s = m_schedule[i];
+                    if (!perform(*ctxs[t], s.m_begin, s.m_merge)) {
+                        completed = false;
+                    }
+                }
+            }
+            catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
+                completed = false;
+                ex_kind = ERROR_EX;
+                error_code = err.error_code();
+            }
+            catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
+                completed = false;
+                if (ex_kind == NO_EX) {
+                    ex_kind = DEFAULT_EX;
+                    ex_msg = ex.what();
+                }
+            }
+        };
+        vector<std::thread> threads(num_threads - 1);
+        for (unsigned t = 1; t < num_threads; ++t) {
+            threads[t - 1] = std::thread([&, t]() { worker(t); });
+        }
+        worker(0);
+        for (auto & th : threads) {
+            th.join();
+        }
+
+        for (unsigned i = begin; i < end; ++i) {
+            execution_context & w = get_ctx(i);
+            for (unsigned r : m_schedule[i].m_regs) {
+                if (w.reg(r)) {
+                    ctx.set_reg(r, w.release_reg(r));
+                }
+            }
+        }
+        for (execution_context * w : ctxs) {
+            ctx.m_stats.add(w->m_stats);
+        }
+        switch (ex_kind) {
+        case ERROR_EX: throw z3_error(error_code);
+        case DEFAULT_EX: throw default_exception(std::move(ex_msg));
+        default: break;
+        }
+        return completed;
+#endif
+    }
+
     void instruction_block::process_all_costs() {
         for (auto* t : m_data) {
             t->process_all_costs();
@@ -94,11 +94,14 @@ namespace datalog {
             unsigned m_min;
             stats() { reset(); }
             void reset() { memset(this, 0, sizeof(*this)); }
+            void add(stats const& other);
         };
         stats m_stats;
 
         void collect_statistics(statistics& st) const;
 
+        unsigned num_threads() const;
+
         /**
            \brief Return reference to \c i -th register that contains pointer to a relation.
 
@@ -245,6 +248,19 @@ namespace datalog {
 
         virtual void make_annotations(execution_context & ctx)  = 0;
 
+        /**
+           \brief Collect the registers read and written by the instruction.
+
+           Return false if the instruction may use state other than the relations in
+           these registers. Such instructions are never performed concurrently.
+        */
+        virtual bool get_registers(unsigned_vector & reads, unsigned_vector & writes) const { return false; }
+
+        /**
+           \brief Return true if the instruction adds its source to a predicate relation.
+        */
+        virtual bool is_union() const { return false; }
+
         void display(execution_context const& ctx, std::ostream & out) const {
             display_indented(ctx, out, "");
         }
@@ -322,8 +338,36 @@ namespace datalog {
         };
     private:
         typedef ptr_vector<instruction> instr_seq_type;
+
+        /**
+           \brief A rule evaluation in the block.
+
+           Instructions in [m_begin, m_merge) compute the derived relation using only the
+           registers in m_regs, and instructions in [m_merge, m_end) add it to the head
+           relation. Segments of a group do not share registers with the other segments
+           of the group, so their computations can be performed concurrently as long as
+           the merges are performed in order afterwards.
+           Instructions that cannot be performed concurrently form their own segment
+           with an empty computation.
+        */
+        struct segment {
+            unsigned        m_begin;
+            unsigned        m_merge;
+            unsigned        m_end;
+            bool            m_new_group;
+            unsigned_vector m_regs;
+        };
+
         instr_seq_type m_data;
         instruction_observer* m_observer;
+        mutable vector<segment> m_schedule;
+        mutable bool m_scheduled = false;
+
+        void mk_schedule() const;
+        bool perform(execution_context & ctx, unsigned begin, unsigned end) const;
+        bool perform_parallel(execution_context & ctx, unsigned num_threads) const;
+        bool perform_concurrently(execution_context & ctx, unsigned begin, unsigned end, unsigned num_threads) const;
+        bool is_thread_safe(execution_context const & ctx, unsigned begin, unsigned end) const;
     public:
         instruction_block() : m_observer(nullptr) {}
         ~instruction_block();
@@ -331,6 +375,7 @@ namespace datalog {
 
         void push_back(instruction * i) { 
             m_data.push_back(i);
+            m_scheduled = false;
             if (m_observer) {
                 m_observer->notify(i);
             }
@@ -348,6 +393,9 @@ namespace datalog {
 
            The execution can terminate before completion if the function 
            \c execution_context::should_terminate() returns true.
+
+           When datalog.threads is above 1, the computations of independent rule
+           evaluations over sparse tables are performed concurrently.
         */
         bool perform(execution_context & ctx) const;
 
@@ -278,6 +278,8 @@ namespace datalog {
 
         virtual void update(const sparse_table & t) {}
 
+        virtual key_indexer * clone(const sparse_table & t) const = 0;
+
         virtual query_result get_matching_offsets(const key_value & key) const = 0;
     };
 
@@ -312,6 +314,10 @@ namespace datalog {
             m_keys(key_len*sizeof(table_element)), 
             m_first_nonindexed(0) {}
 
+        key_indexer * clone(const sparse_table & t) const override {
+            return alloc(general_key_indexer, *this);
+        }
+
         void update(const sparse_table & t) override {
             if (m_first_nonindexed == t.m_data.after_last_offset()) {
                 return;
@@ -406,6 +412,10 @@ namespace datalog {
             m_key_fact.resize(t.get_signature().size());
         }
 
+        key_indexer * clone(const sparse_table & t) const override {
+            return alloc(full_signature_key_indexer, m_key_cols.size(), m_key_cols.data(), t);
+        }
+
         query_result get_matching_offsets(const key_value & key) const override {
             unsigned key_len = m_key_cols.size();
             for (unsigned i=0; i<key_len; i++) {
@@ -494,6 +504,27 @@ namespace datalog {
         m_key_indexes.reset();
     }
 
+    void sparse_table::copy_indexes(const sparse_table & t) {
+        SASSERT(m_key_indexes.empty());
+        for (auto const& kv : t.m_key_indexes) {
+            if (kv.m_value) {
+                m_key_indexes.insert(kv.m_key, kv.m_value->clone(*this));
+            }
+        }
+    }
+
+    void sparse_table::remove_offsets(svector<store_offset> & offsets) {
+        if (offsets.empty()) {
+            return;
+        }
+        //the largest offsets are at the end, so we can remove them one by one
+        while (!offsets.empty()) {
+            m_data.remove_offset(offsets.back());
+            offsets.pop_back();
+        }
+        reset_indexes();
+    }
+
     void sparse_table::write_into_reserve(const table_element* f) {
         TRACE("dl_table_relation", tout << "\n";);
         m_data.ensure_reserve();
@@ -516,6 +547,14 @@ namespace datalog {
         add_reserve_content();
     }
 
+    void sparse_table::add_facts(unsigned fact_cnt, const table_element * facts) {
+        unsigned sz = get_signature().size();
+        for (unsigned i = 0; i < fact_cnt; ++i, facts += sz) {
+            write_into_reserve(facts);
+            add_reserve_content();
+        }
+    }
+
     bool sparse_table::add_reserve_content() {
         return m_data.insert_reserve_content();
     }
@@ -750,6 +789,7 @@ namespace datalog {
 
 
     void sparse_table_plugin::reset() {
+        lock_guard lock(m_pool_lock);
         table_pool::iterator it = m_pool.begin();
         table_pool::iterator end = m_pool.end();
         for (; it!=end; ++it) {
@@ -775,6 +815,7 @@ namespace datalog {
         const table_signature & sig = t->get_signature();
         t->reset();
 
+        lock_guard lock(m_pool_lock);
         sp_table_vector * & vect = m_pool.insert_if_not_there(sig, nullptr);
         if (vect == nullptr) {
             vect = alloc(sp_table_vector);
@@ -787,6 +828,7 @@ namespace datalog {
     table_base * sparse_table_plugin::mk_empty(const table_signature & s) {
         SASSERT(can_handle_signature(s));
 
+        lock_guard lock(m_pool_lock);
         sp_table_vector * vect;
         if (!m_pool.find(s, vect) || vect->empty()) {
             return alloc(sparse_table, *this, s);
@@ -799,6 +841,9 @@ namespace datalog {
     sparse_table * sparse_table_plugin::mk_clone(const sparse_table & t) {
         sparse_table * res = get(mk_empty(t.get_signature()));
         res->m_data = t.m_data;
+        // the rows keep their offsets, so indexes built on t, for instance
+        // over a relation that is loaded in every saturation, remain valid.
+        res->copy_indexes(t);
         return res;
     }
 
@@ -1243,6 +1288,81 @@ namespace datalog {
 
     };
 
+    /**
+       Selections scan the rows in their native representation and remove
+       the offsets of the rows that fail, instead of going through facts.
+    */
+    class sparse_table_plugin::filter_equal_fn : public table_mutator_fn {
+        typedef sparse_table::store_offset store_offset;
+        const table_element m_value;
+        const unsigned      m_col;
+    public:
+        filter_equal_fn(const table_element & value, unsigned col) 
+            : m_value(value), m_col(col) {}
+
+        void operator()(table_base & tb) override {
+            verbose_action  _va("filter_equal");
+            sparse_table & t = get(tb);
+            const sparse_table::column_layout & layout = t.m_column_layout;
+            svector<store_offset> to_remove;
+            const char * base = t.m_data.begin();
+            store_offset after_last = t.m_data.after_last_offset();
+            for (store_offset ofs = 0; ofs < after_last; ofs += t.m_fact_size) {
+                if (layout.get(base + ofs, m_col) != m_value) {
+                    to_remove.push_back(ofs);
+                }
+            }
+            t.remove_offsets(to_remove);
+        }
+    };
+
+    table_mutator_fn * sparse_table_plugin::mk_filter_equal_fn(const table_base & t, 
+            const table_element & value, unsigned col) {
+        if (!check_kind(t)) {
+            return nullptr;
+        }
+        return alloc(filter_equal_fn, value, col);
+    }
+
+    class sparse_table_plugin::filter_identical_fn : public table_mutator_fn {
+        typedef sparse_table::store_offset store_offset;
+        const unsigned_vector m_cols;
+    public:
+        filter_identical_fn(unsigned col_cnt, const unsigned * identical_cols) 
+            : m_cols(col_cnt, identical_cols) {
+            SASSERT(col_cnt >= 2);
+        }
+
+        void operator()(table_base & tb) override {
+            verbose_action  _va("filter_identical");
+            sparse_table & t = get(tb);
+            const sparse_table::column_layout & layout = t.m_column_layout;
+            svector<store_offset> to_remove;
+            const char * base = t.m_data.begin();
+            store_offset after_last = t.m_data.after_last_offset();
+            unsigned sz = m_cols.size();
+            for (store_offset ofs = 0; ofs < after_last; ofs += t.m_fact_size) {
+                const char * row = base + ofs;
+                table_element val = layout.get(row, m_cols[0]);
+                for (unsigned i = 1; i < sz; ++i) {
+                    if (layout.get(row, m_cols[i]) != val) {
+                        to_remove.push_back(ofs);
+                        break;
+                    }
+                }
+            }
+            t.remove_offsets(to_remove);
+        }
+    };
+
+    table_mutator_fn * sparse_table_plugin::mk_filter_identical_fn(const table_base & t, unsigned col_cnt, 
+            const unsigned * identical_cols) {
+        if (!check_kind(t) || col_cnt < 2) {
+            return nullptr;
+        }
+        return alloc(filter_identical_fn, col_cnt, identical_cols);
+    }
+
     table_intersection_filter_fn * sparse_table_plugin::mk_filter_by_negation_fn(const table_base & t, 
             const table_base & negated_obj, unsigned joined_col_cnt, 
             const unsigned * t_cols, const unsigned * negated_cols) { 
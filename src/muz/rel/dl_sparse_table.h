@@ -27,6 +27,7 @@ Revision History:
 #include "util/buffer.h"
 #include "util/hashtable.h"
 #include "util/map.h"
+#include "util/mutex.h"
 #include "util/ref_vector.h"
 #include "util/vector.h"
 
@@ -47,12 +48,15 @@ namespace datalog {
         class negation_filter_fn;
         class select_equal_and_project_fn;
         class negated_join_fn;
+        class filter_equal_fn;
+        class filter_identical_fn;
 
         typedef ptr_vector<sparse_table> sp_table_vector;
         typedef map<table_signature, sp_table_vector *, 
             table_signature::hash, table_signature::eq > table_pool;
 
         table_pool m_pool;
+        mutex      m_pool_lock; // rules of a round can be evaluated concurrently
 
         void recycle(sparse_table * t);
 
@@ -89,6 +93,10 @@ namespace datalog {
             const unsigned * permutation_cycle) override;
         table_transformer_fn * mk_select_equal_and_project_fn(const table_base & t,
             const table_element & value, unsigned col) override;
+        table_mutator_fn * mk_filter_equal_fn(const table_base & t, const table_element & value,
+            unsigned col) override;
+        table_mutator_fn * mk_filter_identical_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * identical_cols) override;
         table_intersection_filter_fn * mk_filter_by_negation_fn(const table_base & t,
                 const table_base & negated_obj, unsigned joined_col_cnt,
                 const unsigned * t_cols, const unsigned * negated_cols) override;
@@ -308,6 +316,8 @@ namespace datalog {
         friend class sparse_table_plugin::project_fn;
         friend class sparse_table_plugin::negation_filter_fn;
         friend class sparse_table_plugin::select_equal_and_project_fn;
+        friend class sparse_table_plugin::filter_equal_fn;
+        friend class sparse_table_plugin::filter_identical_fn;
 
         class our_iterator_core;
         class key_indexer;
@@ -419,6 +429,16 @@ namespace datalog {
 
         void reset_indexes();
 
+        /**
+           \brief Copy the indexers of \c t, whose rows have the same offsets as this table.
+        */
+        void copy_indexes(const sparse_table & t);
+
+        /**
+           \brief Remove the facts at \c offsets, given in increasing order.
+        */
+        void remove_offsets(svector<store_offset> & offsets);
+
         static void copy_columns(const column_layout & src_layout, const column_layout & dest_layout, 
             unsigned start_index, unsigned after_last, const char * src, char * dest, 
             unsigned & dest_idx, unsigned & pre_projection_idx, const unsigned * & next_removed);
@@ -478,6 +498,7 @@ namespace datalog {
 
         bool empty() const override { return row_count()==0; }
         void add_fact(const table_fact & f) override;
+        void add_facts(unsigned fact_cnt, const table_element * facts) override;
         bool contains_fact(const table_fact & f) const override;
         bool fetch_fact(table_fact & f) const override;
         void ensure_fact(const table_fact & f) override;
@@ -177,7 +177,12 @@ public:
         unsigned i = 0;
         for ( ; i < sz; ++i, ++j) {
             if (m.contains(*m_elems[i], *t)) {
+                // the elements are pairwise non-subsuming, so no remaining 
+                // element can be contained in t. Keep the rest unchecked.
                 found = true;
+                for (; i < sz; ++i, ++j) 
+                    m_elems[j] = m_elems[i];
+                break;
             }
             else if (m.contains(*t, *m_elems[i])) {
                 m.deallocate(m_elems[i]);
@@ -574,6 +574,24 @@ namespace datalog {
         }
     }
 
+    void rel_context::add_facts(func_decl* pred, unsigned num_facts, table_element const* facts) {
+        get_rmanager().reset_saturated_marks();
+        relation_base & rel0 = get_relation(pred);
+        if (rel0.from_table()) {
+            table_relation & rel = static_cast<table_relation &>(rel0);
+            rel.get_table().add_facts(num_facts, facts);
+        }
+        else {
+            unsigned n = pred->get_arity();
+            table_fact fact;
+            for (unsigned i = 0; i < num_facts; ++i, facts += n) {
+                fact.reset();
+                fact.append(n, facts);
+                add_fact(pred, fact);
+            }
+        }
+    }
+
     bool rel_context::has_facts(func_decl * pred) const {
         relation_base* r = try_get_relation(pred);
         return r && !r->empty();
@@ -106,6 +106,7 @@ namespace datalog {
         */
         void add_fact(func_decl* pred, relation_fact const& fact) override;
         void add_fact(func_decl* pred, table_fact const& fact) override;
+        void add_facts(func_decl* pred, unsigned num_facts, table_element const* facts) override;
 
         /** \brief check if facts were added to relation
         */
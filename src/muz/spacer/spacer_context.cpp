@@ -39,6 +39,7 @@ Notes:
 #include "ast/scoped_proof.h"
 #include "ast/rewriter/expr_safe_replace.h"
 #include "ast/expr_abstract.h"
+#include "ast/ast_serialize.h"
 #include "model/model_smt2_pp.h"
 #include "tactic/core/blast_term_ite_tactic.h"
 #include "smt/tactic/unit_subsumption_tactic.h"
@@ -760,6 +761,7 @@ void pred_transformer::collect_statistics(statistics& st) const
     st.update("SPACER num reach queries", m_stats.m_num_reach_queries);
 
     st.update("SPACER num ctp blocked", m_stats.m_num_ctp_blocked);
+    st.update("SPACER num push skipped", m_stats.m_num_push_skipped);
     st.update("SPACER num is_invariant", m_stats.m_num_is_invariant);
     st.update("SPACER num lemma jumped", m_stats.m_num_lemma_level_jump);
 
@@ -971,6 +973,7 @@ void pred_transformer::add_lemma_core(lemma* lemma, bool ground_only)
     if (is_infty_level(lvl)) { m_stats.m_num_invariants++; }
 
     if (lemma->is_ground()) {
+        ++m_solver_version;
         if (is_infty_level(lvl)) { m_solver->assert_expr(l); }
         else {
             ensure_level (lvl);
@@ -1020,6 +1023,7 @@ void pred_transformer::add_lemma_from_child (pred_transformer& child,
         for (unsigned j = 0; j < inst.size(); ++j) {
             TRACE("spacer_detail", tout << "child property: "
                   << mk_pp(inst.get (j), m) << "\n";);
+            ++m_solver_version;
             if (is_infty_level(lvl)) {
                 m_solver->assert_expr(inst.get(j));
             }
@@ -1243,6 +1247,59 @@ void pred_transformer::add_cover(unsigned level, expr* property, bool bg)
     }
 }
 
+/**
+   \brief add a lemma from a lemma store, given over bound variables like
+   covers, at the level where it is known to hold. Lemmas that do not hold
+   in the initial frame are dropped.
+*/
+bool pred_transformer::seed_lemma(expr* property)
+{
+    expr_ref result(property, m), v(m), c(m);
+    expr_substitution sub(m);
+    for (unsigned i = 0; i < sig_size(); ++i) {
+        c = m.mk_const(pm.o2n(sig(i), 0));
+        v = m.mk_var(i, sig(i)->get_range());
+        sub.insert(v, c);
+    }
+    scoped_ptr<expr_replacer> rep = mk_default_expr_replacer(m, false);
+    rep->set_substitution(&sub);
+    (*rep)(result);
+    if (!is_ground(result))
+        return false;
+
+    ensure_level(0);
+    lemma_ref lem = alloc(lemma, m, result, 0);
+    unsigned solver_level;
+    if (!is_invariant(0, lem.get(), solver_level))
+        return false;
+    return add_lemma(result, solver_level, false);
+}
+
+/**
+   \brief collect the ground lemmas at level or above over bound variables.
+*/
+void pred_transformer::get_stored_lemmas(unsigned level, expr_ref_vector& out)
+{
+    expr_ref_vector lemmas(m);
+    m_frames.get_frame_geq_lemmas(level, lemmas);
+    expr_ref v(m), c(m), tmp(m);
+    expr_substitution sub(m);
+    for (unsigned i = 0; i < sig_size(); ++i) {
+        c = m.mk_const(pm.o2n(sig(i), 0));
+        v = m.mk_var(i, sig(i)->get_range());
+        sub.insert(c, v);
+    }
+    scoped_ptr<expr_replacer> rep = mk_default_expr_replacer(m, false);
+    rep->set_substitution(&sub);
+    for (expr* l : lemmas) {
+        if (is_quantifier(l))
+            continue;
+        tmp = l;
+        (*rep)(tmp);
+        out.push_back(tmp);
+    }
+}
+
 void pred_transformer::propagate_to_infinity (unsigned level) {
     m_frames.propagate_to_infinity (level);
 }
@@ -1531,6 +1588,7 @@ bool pred_transformer::is_invariant(unsigned level, lemma* lem,
     else if (r == l_true) {
         // TBD: optionally remove unused symbols from the model
         if (mdl_ref_ptr) {lem->set_ctp(*mdl_ref_ptr);}
+        if (level == next_level(lem->level())) {lem->set_no_push(m_solver_version);}
     }
     else {lem->reset_ctp();}
 
@@ -1846,6 +1904,7 @@ app* pred_transformer::extend_initial (expr *e)
 
     // -- extend the initial condition
     ic = m.mk_or (m_extend_lit, e, v);
+    ++m_solver_version;
     m_solver->assert_expr (ic);
 
     // -- remember the new extend literal
@@ -2103,6 +2162,15 @@ bool pred_transformer::frames::propagate_to_next_level (unsigned level)
     for (unsigned i = 0, sz = m_lemmas.size(); i < sz && m_lemmas [i]->level() <= level;) {
         if (m_lemmas [i]->level () < level) {++i; continue;}
 
+        // -- nothing was asserted since pushing this lemma last failed
+        // -- background invariants of predecessors are not versioned
+        if (!m_pt.ctx.use_bg_invs() && m_lemmas[i]->is_no_push(m_pt.m_solver_version)) {
+            ++m_pt.m_stats.m_num_push_skipped;
+            all = false;
+            ++i;
+            continue;
+        }
+
         unsigned solver_level;
         if (m_pt.is_invariant(tgt_level, m_lemmas.get(i), solver_level)) {
             m_lemmas [i]->set_level (solver_level);
@@ -2308,6 +2376,10 @@ context::context(fp_params const& params, ast_manager& m) :
     m_pool0 = alloc(solver_pool, pool0_base.get(), max_num_contexts);
     m_pool1 = alloc(solver_pool, pool1_base.get(), max_num_contexts);
     m_pool2 = alloc(solver_pool, pool2_base.get(), max_num_contexts);
+    for (solver_pool* pool : {m_pool0.get(), m_pool1.get(), m_pool2.get()})
+        pool->set_recycle(params.spacer_pool_recycle_size(),
+                          params.spacer_pool_recycle_retired(),
+                          params.spacer_pool_recycle_latency());
 
     m_lmma_cluster = alloc(lemma_cluster_finder, m);
     updt_params();
@@ -2742,9 +2814,83 @@ void context::simplify_formulas() {
     }
 }
 
+/**
+   \brief seed the frames with the lemmas of the lemma store.
+   The store is a serialization of implications (=> (p x0 ... xn) lemma)
+   where the arguments of p are the bound variables 0, ..., n.
+*/
+void context::load_lemma_store()
+{
+    if (!m_params.spacer_lemma_store().is_non_empty_string())
+        return;
+    std::ifstream in(m_params.spacer_lemma_store().str(), std::ios::binary);
+    if (!in)
+        return;
+    unsigned num_read = 0;
+    try {
+        ast_deserializer d(m, in);
+        expr_ref e(m);
+        expr *h = nullptr, *body = nullptr;
+        while (d(e)) {
+            if (!m.is_implies(e, h, body) || !is_app(h))
+                continue;
+            pred_transformer* pt = nullptr;
+            app* head = to_app(h);
+            if (!m_rels.find(head->get_decl(), pt))
+                continue;
+            bool is_sig = head->get_num_args() == pt->sig_size();
+            for (unsigned i = 0; is_sig && i < head->get_num_args(); ++i)
+                is_sig = is_var(head->get_arg(i)) && to_var(head->get_arg(i))->get_idx() == i;
+            if (!is_sig)
+                continue;
+            ++num_read;
+            if (pt->seed_lemma(body))
+                m_stats.m_num_lemmas_seeded++;
+        }
+    }
+    catch (default_exception& ex) {
+        IF_VERBOSE(1, verbose_stream() << "(spacer: ignoring lemma store: " << ex.what() << ")\n";);
+    }
+    IF_VERBOSE(1, verbose_stream() << "(spacer: seeded " << m_stats.m_num_lemmas_seeded
+               << " of " << num_read << " stored lemmas)\n";);
+}
+
+/**
+   \brief write the invariants of every predicate to the lemma store.
+*/
+void context::save_lemma_store()
+{
+    if (!m_params.spacer_lemma_store().is_non_empty_string())
+        return;
+    std::ofstream out(m_params.spacer_lemma_store().str(), std::ios::binary);
+    if (!out)
+        return;
+    unsigned level = m_last_result == l_false ? m_inductive_lvl : infty_level();
+    ast_serializer s(m, out);
+    expr_ref_vector lemmas(m), args(m);
+    expr_ref e(m);
+    for (auto const& kv : m_rels) {
+        pred_transformer& pt = *kv.m_value;
+        lemmas.reset();
+        pt.get_stored_lemmas(level, lemmas);
+        if (lemmas.empty())
+            continue;
+        args.reset();
+        for (unsigned i = 0; i < pt.sig_size(); ++i)
+            args.push_back(m.mk_var(i, pt.sig(i)->get_range()));
+        app_ref head(m.mk_app(pt.head(), args.size(), args.data()), m);
+        for (expr* l : lemmas) {
+            e = m.mk_implies(head, l);
+            s(e);
+        }
+    }
+    s.finish();
+}
+
 lbool context::solve(unsigned from_lvl)
 {
     m_last_result = l_undef;
+    load_lemma_store();
     try {
         if (m_use_gpdr) {
             SASSERT(from_lvl == 0);
@@ -2782,6 +2928,10 @@ lbool context::solve(unsigned from_lvl)
         m_stats.m_cex_depth = get_cex_depth ();
     }
 
+    if (m_last_result != l_undef) {
+        save_lemma_store();
+    }
+
     if (m_params.print_statistics ()) {
         statistics st;
         collect_statistics (st);
@@ -4175,6 +4325,7 @@ void context::collect_statistics(statistics& st) const
     st.update ("time.spacer.solve.reach.children",
                m_create_children_watch.get_seconds ());
     st.update("spacer.lemmas_imported", m_stats.m_num_lemmas_imported);
+    st.update("spacer.lemmas_seeded", m_stats.m_num_lemmas_seeded);
     st.update("spacer.lemmas_discarded", m_stats.m_num_lemmas_discarded);
 
     for (unsigned i = 0; i < m_lemma_generalizers.size(); ++i) {
@@ -136,6 +136,8 @@ class lemma {
     unsigned m_external:1;    // external lemma from another solver
     unsigned m_blocked:1;     // blocked by CTP
     unsigned m_background:1;  // background assumed fact
+    unsigned m_no_push_lvl = UINT_MAX;     // level at which pushing failed
+    unsigned m_no_push_version = UINT_MAX; // solver version at which pushing failed
     // clang-format on
     // clang-format off
 
@@ -178,6 +180,11 @@ class lemma {
     bool is_blocked() { return m_blocked; }
     void set_blocked(bool v) { m_blocked = v; }
 
+    // pushing the lemma from its current level failed when the solver of
+    // its predicate transformer had the given version
+    void set_no_push(unsigned version) { m_no_push_lvl = m_lvl; m_no_push_version = version; }
+    bool is_no_push(unsigned version) const { return m_no_push_lvl == m_lvl && m_no_push_version == version; }
+
     bool is_inductive() const { return is_infty_level(m_lvl); }
     unsigned level() const { return m_lvl; }
     unsigned init_level() const { return m_init_lvl; }
@@ -222,6 +229,8 @@ class pred_transformer {
         unsigned m_num_lemma_level_jump; // lemma learned at higher level than
                                          // expected
         unsigned m_num_reach_queries;
+        unsigned m_num_push_skipped;     // num of times an unchanged solver
+                                         // blocked lemma pushing
         // clang-format on
         // clang-format off
 
@@ -508,6 +517,7 @@ class pred_transformer {
     stopwatch                    m_ctp_watch;
     stopwatch                    m_mbp_watch;
     bool                         m_has_quantified_frame; // True when a quantified lemma is in the frame
+    unsigned                     m_solver_version = 0;   // number of formulas asserted in m_solver
     cluster_db                   m_cluster_db;
     // clang-format on
     // clang-format off
@@ -575,6 +585,8 @@ class pred_transformer {
     unsigned get_num_levels() const { return m_frames.size(); }
     expr_ref get_cover_delta(func_decl *p_orig, int level);
     void add_cover(unsigned level, expr *property, bool bg = false);
+    bool seed_lemma(expr *property);
+    void get_stored_lemmas(unsigned level, expr_ref_vector &out);
     expr_ref get_reachable();
 
     std::ostream &display(std::ostream &strm) const;
@@ -1104,6 +1116,7 @@ class context {
         unsigned m_num_lemmas;
         unsigned m_num_restarts;
         unsigned m_num_lemmas_imported;
+        unsigned m_num_lemmas_seeded;
         unsigned m_num_lemmas_discarded;
         unsigned m_num_conj;
         unsigned m_num_conj_success;
@@ -1211,6 +1224,8 @@ class context {
 
     // Functions used by search.
     lbool solve_core(unsigned from_lvl = 0);
+    void load_lemma_store();
+    void save_lemma_store();
     bool is_requeue(pob &n);
     bool check_reachability();
     bool propagate(unsigned min_prop_lvl, unsigned max_prop_lvl,
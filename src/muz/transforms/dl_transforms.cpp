@@ -45,6 +45,8 @@ namespace datalog {
 
         rule_transformer transf(ctx);
         ctx.ensure_closed();
+        if (ctx.find_transformed_rules())
+            return;
         transf.reset();
         transf.register_plugin(alloc(datalog::mk_coi_filter, ctx));
         transf.register_plugin(alloc(datalog::mk_interp_tail_simplifier, ctx));
@@ -99,5 +101,6 @@ namespace datalog {
 
         transf.register_plugin(alloc(datalog::mk_elim_term_ite, ctx, 35010));
         ctx.transform_rules(transf);
+        ctx.insert_transformed_rules();
     }
 }
@@ -30,14 +30,29 @@ namespace nlsat {
     class assignment : public polynomial::var2anum {
         scoped_anum_vector m_values;
         bool_vector      m_assigned;
+        // m_stamps[x] is the time at which x was last assigned.
+        // m_epoch changes when values are moved without being assigned.
+        unsigned_vector  m_stamps;
+        unsigned         m_time = 0;
+        unsigned         m_epoch = 0;
+
+        void touch(var x) {
+            m_stamps.reserve(x+1, 0);
+            if (++m_time == 0)
+                ++m_epoch;
+            m_stamps[x] = m_time;
+        }
     public:
         assignment(anum_manager & _m):m_values(_m) {}
         anum_manager & am() const { return m_values.m(); }
         void swap(assignment & other) noexcept {
             m_values.swap(other.m_values);
             m_assigned.swap(other.m_assigned);
+            ++m_epoch;
+            ++other.m_epoch;
         }
         void copy(assignment const& other) {
+            ++m_epoch;
             m_assigned.reset();
             m_assigned.append(other.m_assigned);
             m_values.reserve(m_assigned.size(), anum());
@@ -53,12 +68,14 @@ namespace nlsat {
             m_assigned.reserve(x+1, false); 
             m_assigned[x] = true;
             am().swap(m_values[x], v); 
+            touch(x);
         }
         void set(var x, anum const & v) {
             m_values.reserve(x+1, anum());
             m_assigned.reserve(x+1, false); 
             m_assigned[x] = true;
             am().set(m_values[x], v); 
+            touch(x);
         }
         void reset(var x) { if (x < m_assigned.size()) m_assigned[x] = false; }
         void reset() { m_assigned.reset(); }
@@ -67,8 +84,16 @@ namespace nlsat {
         anum_manager & m() const override { return am(); }
         bool contains(var x) const override { return is_assigned(x); }
         anum const & operator()(var x) const override { SASSERT(is_assigned(x)); return value(x); }
+        /**
+           \brief A value computed from the values of variables xs at time() is still
+           valid if epoch() is unchanged and stamp(x) <= time for each x in xs.
+        */
+        unsigned stamp(var x) const { return m_stamps.get(x, 0); }
+        unsigned time() const { return m_time; }
+        unsigned epoch() const { return m_epoch; }
         void swap(var x, var y) noexcept {
             SASSERT(x < m_values.size() && y < m_values.size());
+            ++m_epoch;
             std::swap(m_assigned[x], m_assigned[y]);
             std::swap(m_values[x], m_values[y]);
         }
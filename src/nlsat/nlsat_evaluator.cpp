@@ -32,6 +32,24 @@ namespace nlsat {
         scoped_anum_vector       m_tmp_values;
         scoped_anum_vector       m_add_roots_tmp;
         scoped_anum_vector       m_inf_tmp;
+
+        // signs of polynomials in the current assignment, indexed by polynomial id.
+        // An entry is valid while none of the variables of the polynomial
+        // was reassigned, see assignment::stamp. Cached polynomials are kept
+        // alive so that their ids are not reused.
+        struct sign_entry {
+            poly *   m_poly = nullptr;
+            unsigned m_time = 0;
+            unsigned m_epoch = 0;
+            unsigned m_vars_begin = 0;
+            unsigned m_vars_end = 0;
+            ::sign   m_sign = sign_zero;
+        };
+        static const unsigned    max_sign_cache_vars = 1 << 20;
+        svector<sign_entry>      m_sign_cache;
+        unsigned_vector          m_sign_cache_vars;
+        polynomial_ref_vector    m_sign_cache_polys;
+        var_vector               m_vars_tmp;
         
         // sign tables: light version
         struct sign_table {
@@ -371,6 +389,7 @@ namespace nlsat {
             m_tmp_values(m_am),
             m_add_roots_tmp(m_am),
             m_inf_tmp(m_am),
+            m_sign_cache_polys(pm),
             m_sign_table_tmp(m_am) {
         }
 
@@ -384,9 +403,43 @@ namespace nlsat {
            \pre All variables of p are assigned in the current interpretation.
         */
         ::sign eval_sign(poly * p) {
-            // TODO: check if it is useful to cache results
             SASSERT(m_assignment.is_assigned(max_var(p)));
-            return m_am.eval_sign_at(polynomial_ref(p, m_pm), m_assignment);
+            unsigned id = m_pm.id(p);
+            m_sign_cache.reserve(id + 1);
+            sign_entry & e = m_sign_cache[id];
+            if (e.m_poly == p && e.m_epoch == m_assignment.epoch()) {
+                bool valid = true;
+                for (unsigned i = e.m_vars_begin; valid && i < e.m_vars_end; ++i)
+                    valid = m_assignment.stamp(m_sign_cache_vars[i]) <= e.m_time;
+                if (valid)
+                    return e.m_sign;
+            }
+            ::sign s = m_am.eval_sign_at(polynomial_ref(p, m_pm), m_assignment);
+            if (e.m_poly != p) {
+                if (m_sign_cache_vars.size() > max_sign_cache_vars) {
+                    reset_sign_cache();
+                    m_sign_cache.reserve(id + 1);
+                }
+                sign_entry & f = m_sign_cache[id];
+                m_vars_tmp.reset();
+                m_pm.vars(p, m_vars_tmp);
+                f.m_poly = p;
+                f.m_vars_begin = m_sign_cache_vars.size();
+                m_sign_cache_vars.append(m_vars_tmp);
+                f.m_vars_end = m_sign_cache_vars.size();
+                m_sign_cache_polys.push_back(p);
+            }
+            sign_entry & f = m_sign_cache[id];
+            f.m_time = m_assignment.time();
+            f.m_epoch = m_assignment.epoch();
+            f.m_sign = s;
+            return s;
+        }
+
+        void reset_sign_cache() {
+            m_sign_cache.reset();
+            m_sign_cache_vars.reset();
+            m_sign_cache_polys.reset();
         }
         
         bool satisfied(int sign, atom::kind k) {
@@ -16,6 +16,8 @@ Abstract:
     - rc2t:       implementation of rc2 heuristic using totalizerx
     - rc2-binary: hybrid of rc2 and binary maxres. Perform one step of binary maxres. 
                   If there are more than 16 soft constraints create a cardinality constraint.
+    - core-boosted: maxres for a bounded time, followed by SAT-UNSAT linear search 
+                  on the reformulated soft constraints.
 
 
     MaxRes is a core-guided approach to maxsat.
@@ -62,6 +64,7 @@ Notes:
 #include "ast/pb_decl_plugin.h"
 #include "ast/ast_util.h"
 #include "ast/ast_smt_pp.h"
+#include "util/timer.h"
 #include "model/model_smt2_pp.h"
 #include "solver/solver.h"
 #include "solver/mus.h"
@@ -74,7 +77,13 @@ Notes:
 #include "opt/maxsmt.h"
 #include "opt/maxcore.h"
 #include "opt/totalizer.h"
+#include "ast/ast_translation.h"
+#include <algorithm>
 #include <iostream>
+#ifndef SINGLE_THREAD
+#include <mutex>
+#include <thread>
+#endif
 
 using namespace opt;
 
@@ -85,12 +94,14 @@ public:
         s_primal_dual,
         s_primal_binary,
         s_rc2,
-        s_primal_binary_rc2
+        s_primal_binary_rc2,
+        s_core_boosted
     };
 private:
     struct stats {
         unsigned m_num_cores;
         unsigned m_num_cs;
+        unsigned m_num_ub_models;
         stats() { reset(); }
         void reset() {
             memset(this, 0, sizeof(*this));
@@ -107,8 +118,112 @@ private:
         expr_ref_vector const& soft() override { return i.m_asms; }
     };
 
+#ifndef SINGLE_THREAD
+    /**
+       \brief search for low-cost assignments on a clone of the SAT solver in a
+       separate thread. The search greedily extends a satisfiable set of
+       soft constraints, heaviest first, and publishes which soft constraints
+       its best model satisfies. Only the search thread uses the manager of
+       the clone, so nothing but these flags is shared with the main thread.
+    */
+    class ub_search {
+        ast_manager         m;
+        ref<solver>         m_solver;
+        expr_ref_vector     m_soft;
+        vector<rational>    m_weights;
+        std::mutex          m_mux;
+        bool                m_new = false;
+        rational            m_cost;
+        bool_vector         m_satisfied;
+        std::thread         m_thread;
+
+        void search() {
+            unsigned n = m_soft.size();
+            unsigned_vector order;
+            for (unsigned i = 0; i < n; ++i)
+                order.push_back(i);
+            std::stable_sort(order.begin(), order.end(), [&](unsigned i, unsigned j) { return m_weights[i] > m_weights[j]; });
+            bool_vector sat(n, false);
+            expr_ref_vector asms(m);
+            model_ref mdl;
+            for (unsigned i : order) {
+                if (sat[i])
+                    continue;
+                asms.push_back(m_soft.get(i));
+                lbool r = m_solver->check_sat(asms);
+                if (r == l_undef)
+                    return;
+                if (r == l_false) {
+                    asms.pop_back();
+                    continue;
+                }
+                m_solver->get_model(mdl);
+                if (!mdl)
+                    return;
+                rational cost(0);
+                for (unsigned j = 0; j < n; ++j) {
+                    if (!mdl->is_true(m_soft.get(j)))
+                        cost += m_weights[j];
+                    else if (!sat[j]) {
+                        sat[j] = true;
+                        if (j != i)
+                            asms.push_back(m_soft.get(j));
+                    }
+                }
+                std::lock_guard<std::mutex> lock(m_mux);
+                if (!m_new || cost < m_cost) {
+                    m_cost = cost;
+                    m_satisfied = sat;
+                    m_new = true;
+                }
+            }
+        }
+
+        void run() {
+            try {
+                search();
+            }
+            catch (z3_exception& ex) {
+                IF_VERBOSE(1, verbose_stream() << "(opt.maxres upper bound search: " << ex.what() << ")\n");
+            }
+        }
+
+    public:
+        ub_search(solver& s, expr_ref_vector const& soft, vector<rational> const& weights, params_ref const& p):
+            m(soft.get_manager(), true),
+            m_soft(m),
+            m_weights(weights) {
+            ast_translation tr(soft.get_manager(), m);
+            m_solver = s.translate(m, p);
+            for (expr* e : soft)
+                m_soft.push_back(tr(e));
+            m_thread = std::thread([this]() { run(); });
+        }
+
+        ~ub_search() {
+            m.limit().cancel();
+            m_thread.join();
+        }
+
+        /**
+           \brief retrieve the soft constraints satisfied by a model of cost 
+           below \c bound that was found since the last call.
+        */
+        bool get_model(rational const& bound, bool_vector& satisfied) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            if (!m_new || m_cost >= bound)
+                return false;
+            m_new = false;
+            satisfied = m_satisfied;
+            return true;
+        }
+    };
+    scoped_ptr<ub_search> m_ub_search;
+#endif
+
     stats            m_stats;
     expr_ref_vector  m_B;
+    expr_ref_vector  m_ub_asms;
     expr_ref_vector  m_asms;
     expr_ref_vector  m_defs;
     obj_map<expr, rational> m_asm2weight;
@@ -134,7 +249,9 @@ private:
     bool             m_enable_lns = false;             // enable LNS improvements
     unsigned         m_lns_conflicts = 1000;           // number of conflicts used for LNS improvement
     bool             m_enable_core_rotate = false;     // enable core rotation
+    bool             m_ub_thread = false;              // search for upper bounds in a separate thread
     bool             m_use_totalizer = true;           // use totalizer instead of cardinality encoding
+    unsigned         m_core_boosted_ms = 2000;         // core-guided search time before linear search
     std::string      m_trace_id;
     typedef ptr_vector<expr> exprs;
 
@@ -143,7 +260,7 @@ public:
            vector<soft>& soft,
            strategy_t st):
         maxsmt_solver_base(c, soft, index),
-        m_B(m), m_asms(m), m_defs(m),
+        m_B(m), m_ub_asms(m), m_asms(m), m_defs(m),
         m_new_core(m),
         m_mus(c.get_solver()),
         m_trail(m),
@@ -167,6 +284,9 @@ public:
         case s_primal_binary_rc2:
             m_trace_id = "rc2bin";
             break;
+        case s_core_boosted:
+            m_trace_id = "core-boosted";
+            break;
         default:
             UNREACHABLE();
             break;
@@ -227,6 +347,48 @@ public:
         trace_bounds(m_trace_id.c_str());
     }
 
+    /**
+       \brief start searching for upper bounds on a clone of the SAT solver.
+    */
+    void start_ub_search() {
+#ifndef SINGLE_THREAD
+        m_ub_search = nullptr;
+        m_ub_asms.reset();
+        if (!m_ub_thread || !m_c.sat_enabled() || m_asms.empty())
+            return;
+        vector<rational> weights;
+        for (expr* a : m_asms)
+            weights.push_back(get_weight(a));
+        m_ub_asms.append(m_asms);
+        m_ub_search = alloc(ub_search, s(), m_asms, weights, m_params);
+#endif
+    }
+
+    void stop_ub_search() {
+#ifndef SINGLE_THREAD
+        m_ub_search = nullptr;
+#endif
+    }
+
+    /**
+       \brief recover the best model of the upper bound search, if it improves 
+       the current upper bound, by checking its satisfied soft constraints.
+    */
+    void adopt_ub_model() {
+#ifndef SINGLE_THREAD
+        bool_vector satisfied;
+        if (!m_ub_search || !m_ub_search->get_model(m_upper, satisfied))
+            return;
+        expr_ref_vector asms(m);
+        for (unsigned i = 0; i < satisfied.size(); ++i)
+            if (satisfied[i])
+                asms.push_back(m_ub_asms.get(i));
+        IF_VERBOSE(2, verbose_stream() << "(opt.maxres upper bound model)\n");
+        ++m_stats.m_num_ub_models;
+        check_sat(asms.size(), asms.data());
+#endif
+    }
+
     lbool mus_solver() {
         lbool is_sat = l_true;
         if (!init()) return l_undef;
@@ -234,7 +396,14 @@ public:
         trace();
         improve_model();
         if (is_sat != l_true) return is_sat;
+        start_ub_search();
+        timer core_timer;
         while (m_lower < m_upper) {
+            adopt_ub_model();
+            if (m_lower >= m_upper)
+                break;
+            if (m_st == s_core_boosted && core_timer.ms_timeout(m_core_boosted_ms))
+                return linear_search();
             TRACE("opt_verbose",
                   s().display(tout << m_asms << "\n") << "\n";
                   display(tout););
@@ -271,13 +440,101 @@ public:
         return l_true;
     }
 
+    /**
+       \brief SAT-UNSAT linear search on the reformulated soft constraints.
+
+       After core-guided search the cost of a model is m_lower plus the weight
+       of the assumptions it falsifies. Each improving model tightens a 
+       pseudo-Boolean bound on the falsified assumptions. The bounds are 
+       stratified by weight: the assumptions of the heaviest weights are 
+       improved first, under a scope, and the bound of the last stratum 
+       ranges over all assumptions, starting from the best model.
+    */
+    lbool linear_search() {
+        stop_ub_search();
+        if (!m_model) {
+            lbool is_sat = check_sat(0, nullptr);
+            if (is_sat != l_true)
+                return is_sat;
+            if (!m_model)
+                return l_undef;
+        }
+        vector<rational> levels;
+        for (expr* a : m_asms)
+            levels.push_back(get_weight(a));
+        std::sort(levels.begin(), levels.end(), [](rational const& a, rational const& b) { return a > b; });
+        // each stratum includes assumptions of at most half the weight of the previous one.
+        unsigned j = 0;
+        for (rational const& w : levels)
+            if (j == 0 || w * 2 <= levels[j - 1])
+                levels[j++] = w;
+        levels.shrink(j);
+        IF_VERBOSE(1, verbose_stream() << "(opt.core-boosted :linear-search " << m_asms.size() 
+                   << " :strata " << levels.size() << ")\n");
+        model_ref mdl = m_model;
+        lbool is_sat = l_false;
+        for (unsigned l = 0; l < levels.size(); ++l) {
+            bool is_last = l + 1 == levels.size();
+            expr_ref_vector nasms(m);
+            vector<rational> weights;
+            for (expr* a : m_asms) {
+                if (is_last || get_weight(a) >= levels[l]) {
+                    nasms.push_back(mk_not(m, a));
+                    weights.push_back(get_weight(a));
+                }
+            }
+            if (is_last) {
+                mdl = m_model;
+                is_sat = improve_stratum(mdl, nasms, weights);
+            }
+            else {
+                solver::scoped_push _sp(s());
+                is_sat = improve_stratum(mdl, nasms, weights);
+            }
+            if (is_sat == l_undef)
+                return l_undef;
+        }
+        found_optimum();
+        trace();
+        return l_true;
+    }
+
+    /**
+       \brief improve the weight of the falsified assumptions nasms until 
+       no better model exists.
+    */
+    lbool improve_stratum(model_ref& mdl, expr_ref_vector const& nasms, vector<rational> const& weights) {
+        pb_util u(m);
+        while (m.inc()) {
+            rational k(0);
+            for (unsigned i = 0; i < nasms.size(); ++i)
+                if (mdl->is_true(nasms.get(i)))
+                    k += weights[i];
+            if (k.is_zero())
+                return l_false;
+            add(u.mk_lt(nasms.size(), weights.data(), nasms.data(), k));
+            lbool is_sat = check_sat(0, nullptr);
+            if (is_sat != l_true)
+                return is_sat;
+            s().get_model(mdl);
+            if (!mdl)
+                return l_undef;
+            mdl->set_model_completion(true);
+        }
+        return l_undef;
+    }
+
     lbool primal_dual_solver() {
         if (!init()) return l_undef;
         lbool is_sat = init_local();
         trace();
         exprs cs;
         if (is_sat != l_true) return is_sat;
+        start_ub_search();
         while (m_lower < m_upper) {
+            adopt_ub_model();
+            if (m_lower >= m_upper)
+                break;
             is_sat = check_sat_hill_climb(m_asms);
             if (!m.inc()) {
                 return l_undef;
@@ -369,21 +626,28 @@ public:
 
     lbool operator()() override {
         m_defs.reset();
+        lbool r = l_undef;
         switch(m_st) {
         case s_primal:
         case s_primal_binary:
         case s_rc2:
         case s_primal_binary_rc2:
-            return mus_solver();
+        case s_core_boosted:
+            r = mus_solver();
+            break;
         case s_primal_dual:
-            return primal_dual_solver();
+            r = primal_dual_solver();
+            break;
         }
-        return l_undef;
+        stop_ub_search();
+        return r;
     }
 
     void collect_statistics(statistics& st) const override {
         st.update("maxsat-cores", m_stats.m_num_cores);
         st.update("maxsat-correction-sets", m_stats.m_num_cs);
+        if (m_stats.m_num_ub_models > 0)
+            st.update("maxsat-upper-bound-models", m_stats.m_num_ub_models);
     }
 
     lbool get_cores(vector<weighted_core>& cores) {
@@ -1060,8 +1324,11 @@ public:
         m_dump_benchmarks =         p.dump_benchmarks();
         m_enable_lns =              p.enable_lns();
         m_enable_core_rotate =      p.enable_core_rotate();
+        m_ub_thread =               p.maxres_upper_bound_thread();
         m_lns_conflicts =           p.lns_conflicts();
+        m_lns.set_threads(m_c.sat_enabled() ? p.lns_threads() : 1);
         m_use_totalizer =           p.rc2_totalizer();
+        m_core_boosted_ms =         p.core_boosted_core_ms();
 	if (m_c.num_objectives() > 1)
 	  m_add_upper_bound_block = false;
     }
@@ -1156,6 +1423,11 @@ opt::maxsmt_solver_base* opt::mk_rc2bin(
     return alloc(maxcore, c, id, soft, maxcore::s_primal_binary_rc2);
 }
 
+opt::maxsmt_solver_base* opt::mk_core_boosted(
+    maxsat_context& c, unsigned id, vector<soft>& soft) {
+    return alloc(maxcore, c, id, soft, maxcore::s_core_boosted);
+}
+
 opt::maxsmt_solver_base* opt::mk_maxres_binary(
     maxsat_context& c, unsigned id, vector<soft>& soft) {
     return alloc(maxcore, c, id, soft, maxcore::s_primal_binary);
@@ -94,6 +94,8 @@ namespace opt {
         // return true;
 
         preprocess pp(s());
+        pp.set_merge_equivalent(opt_params(m_params).maxsat_merge_equivalent());
+        pp.set_native_cardinality(m_c.sat_enabled());
         rational lower(0);
         bool r = pp(m_soft, lower);
 
@@ -195,6 +197,8 @@ namespace opt {
             m_msolver = mk_rc2(m_c, m_index, m_soft);
         else if (maxsat_engine == symbol("rc2bin"))             
             m_msolver = mk_rc2bin(m_c, m_index, m_soft);
+        else if (maxsat_engine == symbol("core-boosted"))             
+            m_msolver = mk_core_boosted(m_c, m_index, m_soft);
         else if (maxsat_engine == symbol("pd-maxres"))             
             m_msolver = mk_primal_dual_maxres(m_c, m_index, m_soft);
         else if (maxsat_engine == symbol("wmax")) 
@@ -583,6 +583,27 @@ namespace opt {
         return result;
     }
 
+    void context::get_objective(unsigned i, expr_ref& term, bool& is_max) {
+        objective const& obj = m_objectives[i];
+        switch (obj.m_type) {
+        case O_MINIMIZE:
+        case O_MAXIMIZE:
+            term = obj.m_term;
+            is_max = obj.m_type == O_MAXIMIZE;
+            break;
+        case O_MAXSMT: {
+            // the satisfied weight of the soft constraints.
+            bool is_int = all_of(obj.m_weights, [](rational const& w) { return w.is_int(); });
+            expr_ref_vector sum(m);
+            for (unsigned j = 0; j < obj.m_terms.size(); ++j)
+                sum.push_back(m.mk_ite(obj.m_terms[j], m_arith.mk_numeral(obj.m_weights[j], is_int), m_arith.mk_numeral(rational::zero(), is_int)));
+            term = sum.empty() ? expr_ref(m_arith.mk_numeral(rational::zero(), true), m) : expr_ref(m_arith.mk_add(sum), m);
+            is_max = true;
+            break;
+        }
+        }
+    }
+
     expr_ref context::mk_cmp(bool is_ge, model_ref& mdl, objective const& obj) {
         rational k(0);
         expr_ref val(m), result(m);
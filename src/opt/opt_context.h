@@ -257,6 +257,7 @@ namespace opt {
         expr_ref mk_gt(unsigned i, model_ref& model) override;
         expr_ref mk_ge(unsigned i, model_ref& model) override;
         expr_ref mk_le(unsigned i, model_ref& model) override;
+        void get_objective(unsigned i, expr_ref& term, bool& is_max) override;
 
         generic_model_converter& fm() override { return *m_fm; }
         smt::context& smt_context() override { return m_opt_solver->get_context(); }
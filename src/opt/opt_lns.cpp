@@ -17,11 +17,16 @@ Author:
 
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_pp.h"
+#include "ast/ast_translation.h"
 #include "ast/pb_decl_plugin.h"
 #include "opt/maxsmt.h"
 #include "opt/opt_lns.h"
 #include "params/sat_params.hpp"
 #include <algorithm>
+#ifndef SINGLE_THREAD
+#include <mutex>
+#include <thread>
+#endif
 
 namespace opt {
 
@@ -59,8 +64,11 @@ namespace opt {
         save_defaults(old_p);
         set_lns_params();
         update_best_model(mdl);
-        for (unsigned i = 0; i < 2; ++i)
-            improve_bs();
+        if (m_num_threads > 1)
+            improve_parallel();
+        else 
+            for (unsigned i = 0; i < 2; ++i)
+                improve_bs();
         IF_VERBOSE(1, verbose_stream() << "(opt.lns :relax-cores " << m_cores.size() << ")\n");
         relax_cores();
         s.updt_params(old_p);
@@ -68,8 +76,215 @@ namespace opt {
         return m_num_improves;
     }
 
+    rational lns::soft_cost(model& mdl) {
+        rational cost(0);
+        for (expr* e : ctx.soft())
+            if (!mdl.is_true(e))
+                cost += ctx.weight(e);
+        return cost;
+    }
+
+#ifdef SINGLE_THREAD
+
+    class lns::incumbent {
+    public:
+        void update(unsigned, rational const&, bool_vector const&) {}
+    };
+
+    void lns::improve_parallel() {
+        for (unsigned i = 0; i < 2; ++i)
+            improve_bs();
+    }
+
+#else
+
+    /**
+       \brief best assignment to the soft constraints found so far. 
+       Only the truth values of the soft constraints and their cost are
+       shared, so that every worker accesses only its own manager.
+    */
+    class lns::incumbent {
+        std::mutex          m_mux;
+        rational            m_cost;
+        bool_vector         m_satisfied;
+        unsigned            m_owner = UINT_MAX;
+    public:
+        incumbent(rational const& cost, bool_vector const& sat): m_cost(cost), m_satisfied(sat) {}
+
+        bool update(unsigned owner, rational const& cost, bool_vector const& sat) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            if (cost >= m_cost)
+                return false;
+            m_cost = cost;
+            m_satisfied = sat;
+            m_owner = owner;
+            return true;
+        }
+
+        void get(bool_vector& sat) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            sat = m_satisfied;
+        }
+
+        // the worker that found the incumbent, UINT_MAX for the main thread.
+        unsigned owner() {
+            std::lock_guard<std::mutex> lock(m_mux);
+            return m_owner;
+        }
+    };
+
+    /**
+       \brief harden soft constraints in random order on a copy of the solver,
+       starting from the incumbent assignment.
+    */
+    struct lns::worker {
+        unsigned            m_id;
+        ast_manager         m;
+        ref<solver>         m_solver;
+        expr_ref_vector     m_soft;
+        vector<rational>    m_weights;
+        random_gen          m_rand;
+        model_ref           m_best;
+        incumbent&          m_incumbent;
+
+        worker(unsigned id, solver& s, expr_ref_vector const& soft, vector<rational> const& weights, 
+               params_ref const& p, incumbent& inc):
+            m_id(id),
+            m(soft.get_manager(), true),
+            m_soft(m),
+            m_weights(weights),
+            m_rand(id),
+            m_incumbent(inc) {
+            ast_translation tr(soft.get_manager(), m);
+            m_solver = s.translate(m, p);
+            m_solver->updt_params(p);
+            for (expr* e : soft)
+                m_soft.push_back(tr(e));
+        }
+
+        void round() {
+            unsigned n = m_soft.size();
+            bool_vector sat;
+            m_incumbent.get(sat);
+            expr_ref_vector hardened(m);
+            unsigned_vector unprocessed;
+            for (unsigned i = 0; i < n; ++i) {
+                if (sat[i])
+                    hardened.push_back(m_soft.get(i));
+                else
+                    unprocessed.push_back(i);
+            }
+            shuffle(unprocessed.size(), unprocessed.data(), m_rand);
+            model_ref mdl;
+            for (unsigned i : unprocessed) {
+                if (!m.inc())
+                    return;
+                if (sat[i])
+                    continue;
+                hardened.push_back(m_soft.get(i));
+                switch (m_solver->check_sat(hardened)) {
+                case l_true: {
+                    m_solver->get_model(mdl);
+                    if (!mdl)
+                        return;
+                    rational cost(0);
+                    for (unsigned j = 0; j < n; ++j) {
+                        if (!mdl->is_true(m_soft.get(j)))
+                            cost += m_weights[j];
+                        else if (!sat[j]) {
+                            sat[j] = true;
+                            if (j != i)
+                                hardened.push_back(m_soft.get(j));
+                        }
+                    }
+                    if (m_incumbent.update(m_id, cost, sat))
+                        m_best = mdl;
+                    break;
+                }
+                case l_false:
+                    hardened[hardened.size() - 1] = m.mk_not(m_soft.get(i));
+                    break;
+                case l_undef:
+                    hardened.pop_back();
+                    break;
+                }
+            }
+        }
+
+        void run() {
+            try {
+                for (unsigned r = 0; r < 2 && m.inc(); ++r)
+                    round();
+            }
+            catch (z3_exception& ex) {
+                IF_VERBOSE(1, verbose_stream() << "(opt.lns worker " << m_id << ": " << ex.what() << ")\n");
+            }
+        }
+    };
+
+    /**
+       \brief run the sequential hardening on the main solver while the
+       other threads harden copies of the solver. The best model of a worker
+       is translated back once all threads are done.
+    */
+    void lns::improve_parallel() {
+        expr_ref_vector const& soft = ctx.soft();
+        vector<rational> weights;
+        bool_vector sat;
+        for (expr* e : soft) {
+            weights.push_back(ctx.weight(e));
+            sat.push_back(m_best_model->is_true(e));
+        }
+        incumbent inc(soft_cost(*m_best_model), sat);
+        params_ref p(s.get_params());
+        scoped_ptr_vector<worker> workers;
+        for (unsigned i = 1; i < m_num_threads; ++i) {
+            workers.push_back(alloc(worker, i, s, soft, weights, p, inc));
+            if (m_best_phase)
+                workers.back()->m_solver->set_phase(m_best_phase.get());
+        }
+        vector<std::thread> threads;
+        for (worker* w : workers)
+            threads.push_back(std::thread([w]() { w->run(); }));
+        flet<incumbent*> _inc(m_incumbent, &inc);
+        try {
+            for (unsigned i = 0; i < 2; ++i)
+                improve_bs();
+        }
+        catch (...) {
+            for (worker* w : workers)
+                w->m.limit().cancel();
+            for (auto& th : threads)
+                th.join();
+            throw;
+        }
+        if (!m.inc())
+            for (worker* w : workers)
+                w->m.limit().cancel();
+        for (auto& th : threads)
+            th.join();
+        unsigned owner = inc.owner();
+        if (owner == UINT_MAX || !m.inc())
+            return;
+        worker& w = *workers[owner - 1];
+        ast_translation tr(w.m, m);
+        model_ref mdl = w.m_best->translate(tr);
+        IF_VERBOSE(1, verbose_stream() << "(opt.lns :worker " << owner << " :cost " << soft_cost(*mdl) << ")\n");
+        ++m_num_improves;
+        ctx.update_model(mdl);
+        update_best_model(mdl);
+    }
+
+#endif
+
     void lns::update_best_model(model_ref& mdl) {
         rational cost = ctx.cost(*mdl);
+        if (m_incumbent) {
+            bool_vector sat;
+            for (expr* e : ctx.soft())
+                sat.push_back(mdl->is_true(e));
+            m_incumbent->update(UINT_MAX, soft_cost(*mdl), sat);
+        }
         if (m_best_cost.is_zero() || m_best_cost >= cost) {
             m_best_cost = cost;
             m_best_model = mdl;
@@ -16,6 +16,11 @@ Abstract:
     The soft constraints are assumed sorted by weight, such that the highest 
     weight soft constraint is first, followed by soft constraints of lower weight.
 
+    With several threads, workers run the same hardening on copies of the
+    solver, each in its own random order. They share the best assignment to
+    the soft constraints through an incumbent store and start each round
+    from it.
+
 Author:
 
     Nikolaj Bjorner (nbjorner) 2021-02-01
@@ -48,6 +53,7 @@ namespace opt {
         bool             m_cores_are_valid { true };
         bool             m_enable_scoped_bounding { false };
         unsigned         m_best_bound { 0 };
+        unsigned         m_num_threads { 1 };
 
         rational         m_best_cost;
         model_ref        m_best_model;
@@ -58,6 +64,9 @@ namespace opt {
         expr_mark               m_is_assumption;
 
         struct scoped_bounding;
+        class incumbent;
+        struct worker;
+        incumbent*       m_incumbent { nullptr };
 
         void update_best_model(model_ref& mdl);
         void improve_bs();
@@ -71,10 +80,17 @@ namespace opt {
         lbool improve_step(model_ref& mdl, expr* e);
         void relax_cores();
         unsigned improve_linear(model_ref& mdl);
+        void improve_parallel();
+        rational soft_cost(model& mdl);
 
     public:
         lns(solver& s, lns_context& ctx);
         void set_conflicts(unsigned c) { m_max_conflicts = c; }
+        /**
+           \brief set the number of threads. Threads other than the first 
+           work on translated copies of the solver.
+        */
+        void set_threads(unsigned n) { m_num_threads = std::max(1u, n); }
         unsigned climb(model_ref& mdl);
     };
 };
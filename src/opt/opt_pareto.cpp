@@ -21,14 +21,29 @@ Notes:
 #include "opt/opt_pareto.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
 #include "model/model_smt2_pp.h"
+#include "smt/smt_solver.h"
+#include "opt/opt_params.hpp"
+#include <atomic>
+#include <thread>
 
 namespace opt {
 
     // ---------------------
     // GIA pareto algorithm
-   
+
+    gia_pareto::gia_pareto(ast_manager & m, pareto_callback& cb, solver* s, params_ref & p):
+        pareto_base(m, cb, s, p) {
+        m_num_threads = opt_params(p).pareto_threads();
+    }
+
     lbool gia_pareto::operator()() {
+        if (m_front_computed)
+            return next_front_point();
         expr_ref fml(m);
         lbool is_sat = m_solver->check_sat(0, nullptr);
         if (is_sat == l_true) {
@@ -59,10 +74,256 @@ namespace opt {
             SASSERT(is_sat == l_false);
             is_sat = l_true;
             mk_not_dominated_by();
+            if (m_num_threads > 1 && cb.num_objectives() > 1)
+                m_front_computed = search_boxes();
         }
         return is_sat;
     }
 
+    lbool gia_pareto::next_front_point() {
+        if (m_front_head == m_front.size())
+            return l_false;
+        m_model = m_front.get(m_front_head++);
+        m_labels.reset();
+        return l_true;
+    }
+
+#ifdef SINGLE_THREAD
+
+    bool gia_pareto::search_boxes() {
+        return false;
+    }
+
+#else
+
+    /**
+       \brief the points that are not dominated by a Pareto point P
+       are split into one box per objective: box i contains the
+       points that are better than P in objective i and no better
+       than P in the objectives before i. Each box has its own manager
+       and solver, and the GIA loop enumerates the Pareto front
+       within the box.
+    */
+    struct gia_pareto::box {
+        ast_manager               m;
+        ref<solver>               m_solver;
+        arith_util                m_arith;
+        bv_util                   m_bv;
+        expr_ref_vector           m_terms;
+        bool_vector               m_is_max;
+        unsigned                  m_index;
+        vector<rational>          m_bound;
+        vector<vector<rational>>  m_values;
+        sref_vector<model>        m_models;
+        lbool                     m_status = l_undef;
+
+        box(ast_manager& src, expr_ref_vector const& fmls, expr_ref_vector const& terms, bool_vector const& is_max,
+            unsigned index, vector<rational> const& bound, params_ref const& p):
+            m(src, true),
+            m_arith(m),
+            m_bv(m),
+            m_terms(m),
+            m_is_max(is_max),
+            m_index(index),
+            m_bound(bound) {
+            ast_translation tr(src, m);
+            m_solver = mk_smt_solver(m, p, symbol::null);
+            for (expr* f : fmls)
+                m_solver->assert_expr(tr(f));
+            for (expr* t : terms)
+                m_terms.push_back(tr(t));
+        }
+
+        // objective i is at least as good as k, or at most as good as k.
+        expr_ref mk_cmp(unsigned i, bool is_ge, rational const& k) {
+            expr* t = m_terms.get(i);
+            if (!m_is_max[i])
+                is_ge = !is_ge;
+            expr_ref v(m);
+            if (m_bv.is_bv(t)) {
+                v = m_bv.mk_numeral(k, m_bv.get_bv_size(t));
+                return expr_ref(is_ge ? m_bv.mk_ule(v, t) : m_bv.mk_ule(t, v), m);
+            }
+            v = m_arith.mk_numeral(k, m_arith.is_int(t));
+            return expr_ref(is_ge ? m_arith.mk_ge(t, v) : m_arith.mk_ge(v, t), m);
+        }
+
+        expr_ref mk_gt(unsigned i, rational const& k) {
+            return expr_ref(m.mk_not(mk_cmp(i, false, k)), m);
+        }
+
+        bool get_values(model& mdl, vector<rational>& values) {
+            values.reset();
+            rational k;
+            unsigned sz;
+            for (expr* t : m_terms) {
+                expr_ref v = mdl(t);
+                if (!m_arith.is_numeral(v, k) && !m_bv.is_numeral(v, k, sz))
+                    return false;
+                values.push_back(k);
+            }
+            return true;
+        }
+
+        void mk_dominates(vector<rational> const& values) {
+            expr_ref_vector fmls(m), gt(m);
+            for (unsigned i = 0; i < values.size(); ++i) {
+                fmls.push_back(mk_cmp(i, true, values[i]));
+                gt.push_back(mk_gt(i, values[i]));
+            }
+            fmls.push_back(mk_or(gt));
+            m_solver->assert_expr(mk_and(fmls));
+        }
+
+        void mk_not_dominated_by(vector<rational> const& values) {
+            expr_ref_vector le(m);
+            for (unsigned i = 0; i < values.size(); ++i)
+                le.push_back(mk_cmp(i, false, values[i]));
+            m_solver->assert_expr(m.mk_not(mk_and(le)));
+        }
+
+        lbool search() {
+            m_solver->assert_expr(mk_gt(m_index, m_bound[m_index]));
+            for (unsigned j = 0; j < m_index; ++j)
+                m_solver->assert_expr(mk_cmp(j, false, m_bound[j]));
+            vector<rational> values;
+            model_ref mdl;
+            while (true) {
+                lbool is_sat = m_solver->check_sat(0, nullptr);
+                if (is_sat != l_true)
+                    return is_sat == l_false ? l_true : l_undef;
+                m_solver->get_model(mdl);
+                {
+                    solver::scoped_push _s(*m_solver.get());
+                    while (is_sat == l_true) {
+                        if (!mdl || !m.inc())
+                            return l_undef;
+                        mdl->set_model_completion(true);
+                        if (!get_values(*mdl, values))
+                            return l_undef;
+                        mk_dominates(values);
+                        is_sat = m_solver->check_sat(0, nullptr);
+                        if (is_sat == l_true)
+                            m_solver->get_model(mdl);
+                    }
+                }
+                if (is_sat == l_undef)
+                    return l_undef;
+                m_values.push_back(values);
+                m_models.push_back(mdl.get());
+                mk_not_dominated_by(values);
+            }
+        }
+
+        void run() {
+            try {
+                m_status = search();
+            }
+            catch (z3_exception& ex) {
+                IF_VERBOSE(1, verbose_stream() << "(opt.pareto box " << m_index << ": " << ex.what() << ")\n");
+                m_status = l_undef;
+            }
+        }
+    };
+
+    /**
+       \brief enumerate the remaining Pareto front in parallel once the
+       first point m_model is known. The local fronts of the boxes are
+       merged by removing points that are dominated by points of other
+       boxes. Returns false if some box could not be completed, in which
+       case the enumeration continues sequentially on the main solver.
+    */
+    bool gia_pareto::search_boxes() {
+        unsigned n = cb.num_objectives();
+        expr_ref_vector terms(m), fmls(m);
+        bool_vector is_max;
+        vector<rational> bound;
+        arith_util a(m);
+        bv_util bv(m);
+        for (unsigned i = 0; i < n; ++i) {
+            expr_ref t(m);
+            bool mx = false;
+            cb.get_objective(i, t, mx);
+            expr_ref v = (*m_model)(t);
+            rational k;
+            unsigned sz;
+            if (!a.is_numeral(v, k) && !bv.is_numeral(v, k, sz))
+                return false;
+            terms.push_back(t);
+            is_max.push_back(mx);
+            bound.push_back(k);
+        }
+        m_solver->get_assertions(fmls);
+        params_ref p(m_params);
+        scoped_ptr_vector<box> boxes;
+        scoped_limits sl(m.limit());
+        for (unsigned i = 0; i < n; ++i) {
+            boxes.push_back(alloc(box, m, fmls, terms, is_max, i, bound, p));
+            sl.push_child(&boxes.back()->m.limit());
+        }
+        std::atomic<unsigned> next(0);
+        auto work = [&]() {
+            for (unsigned i = next++; i < n; i = next++)
+                boxes[i]->run();
+        };
+        unsigned num_threads = std::min(n, m_num_threads);
+        vector<std::thread> threads;
+        for (unsigned i = 0; i < num_threads; ++i)
+            threads.push_back(std::thread(work));
+        for (auto& th : threads)
+            th.join();
+        if (!m.inc())
+            return false;
+        for (box* b : boxes)
+            if (b->m_status != l_true)
+                return false;
+
+        // orient all objectives for maximization.
+        struct point { vector<rational> m_values; box* m_box; unsigned m_idx; };
+        vector<point> points;
+        for (box* b : boxes) {
+            for (unsigned j = 0; j < b->m_values.size(); ++j) {
+                point pt;
+                for (unsigned i = 0; i < n; ++i)
+                    pt.m_values.push_back(is_max[i] ? b->m_values[j][i] : -b->m_values[j][i]);
+                pt.m_box = b;
+                pt.m_idx = j;
+                points.push_back(pt);
+            }
+        }
+        auto dominates = [&](point const& p1, point const& p2) {
+            bool gt = false;
+            for (unsigned i = 0; i < n; ++i) {
+                if (p1.m_values[i] < p2.m_values[i])
+                    return false;
+                gt |= p1.m_values[i] > p2.m_values[i];
+            }
+            return gt;
+        };
+        unsigned num_dominated = 0;
+        for (point const& p1 : points) {
+            bool is_dominated = false;
+            for (point const& p2 : points)
+                if (p1.m_box != p2.m_box && dominates(p2, p1)) {
+                    is_dominated = true;
+                    break;
+                }
+            if (is_dominated) {
+                ++num_dominated;
+                continue;
+            }
+            ast_translation tr(p1.m_box->m, m);
+            model_ref mdl = p1.m_box->m_models[p1.m_idx]->translate(tr);
+            mdl->set_model_completion(true);
+            m_front.push_back(mdl.get());
+        }
+        IF_VERBOSE(1, verbose_stream() << "(opt.pareto :boxes " << n << " :points " << m_front.size() 
+                   << " :dominated " << num_dominated << ")\n");
+        return true;
+    }
+
+#endif
+
     void pareto_base::mk_dominates() {
         unsigned sz = cb.num_objectives();
         expr_ref fml(m);
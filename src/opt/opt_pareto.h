@@ -31,6 +31,8 @@ namespace opt {
         virtual expr_ref mk_gt(unsigned i, model_ref& model) = 0;
         virtual expr_ref mk_ge(unsigned i, model_ref& model) = 0;
         virtual expr_ref mk_le(unsigned i, model_ref& model) = 0;
+        // arithmetic or bit-vector term of objective i and its direction.
+        virtual void get_objective(unsigned i, expr_ref& term, bool& is_max) = 0;
         virtual void fix_model(model_ref& m) = 0;
     };
     class pareto_base {
@@ -80,13 +82,19 @@ namespace opt {
         void mk_not_dominated_by();            
     };
     class gia_pareto : public pareto_base {
+        struct box;
+        unsigned            m_num_threads = 1;
+        bool                m_front_computed = false;
+        sref_vector<model>  m_front;
+        unsigned            m_front_head = 0;
+
+        bool search_boxes();
+        lbool next_front_point();
     public:
         gia_pareto(ast_manager & m, 
                    pareto_callback& cb, 
                    solver* s, 
-                   params_ref & p):
-            pareto_base(m, cb, s, p) {            
-        }
+                   params_ref & p);
 
         lbool operator()() override;
     };
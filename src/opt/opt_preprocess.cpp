@@ -10,6 +10,9 @@ Abstract:
     Pre-processing for MaxSMT
 
     Find mutexes - at most 1 constraints and modify soft constraints and bounds.
+    Remove soft constraints that are fixed by unit hard constraints, cancel
+    complementary soft constraints and merge soft constraints that are 
+    equivalent by unit propagation.
 
 Author:
 
@@ -28,10 +31,20 @@ Notes:
    maxsst x and y and z, u . x + y + z >= 2 and F
    lower bound decreased by 2
 
+   maxsat x : w1, not x : w2
+=>
+   maxsat x : w1 - w2
+   lower bound increased by w2, if w1 >= w2
+
+   maxsat x : w1, y : w2 . F => (x <=> y)
+=>
+   maxsat x : w1 + w2
+
 --*/
 
 
 #include "opt/opt_preprocess.h"
+#include "ast/pb_decl_plugin.h"
 #include "util/max_cliques.h"
 
 namespace opt {
@@ -121,6 +134,122 @@ namespace opt {
         return true;        
     }
 
+    void preprocess::set_soft(vector<soft>& softs, expr_ref_vector const& fmls, obj_map<expr, rational> const& new_soft) {
+        softs.reset();
+        rational w;
+        for (expr* f : fmls)
+            if (new_soft.find(f, w))
+                softs.push_back(soft(expr_ref(f, m), w, false));
+        m_trail.reset();
+    }
+
+    /**
+       \brief remove soft constraints that are fixed by unit hard constraints 
+       and cancel the common weight of complementary soft constraints.
+    */
+    void preprocess::simplify_units(vector<soft>& softs, rational& lower) {
+        expr_ref_vector fmls(m);
+        obj_map<expr, rational> new_soft = soft2map(softs, fmls);
+        expr_ref_vector units = s.get_units();
+        obj_hashtable<expr> unit_set;
+        for (expr* u : units)
+            unit_set.insert(u);
+        unsigned num_fixed = 0, num_complements = 0;
+        for (expr* f : fmls) {
+            rational w, w2;
+            if (!new_soft.find(f, w))
+                continue;
+            expr_ref nf(mk_not(m, f), m);
+            if (unit_set.contains(f)) {
+                new_soft.remove(f);
+                ++num_fixed;
+            }
+            else if (unit_set.contains(nf)) {
+                lower += w;
+                new_soft.remove(f);
+                ++num_fixed;
+            }
+            else if (new_soft.find(nf, w2)) {
+                rational d = std::min(w, w2);
+                lower += d;
+                if (w == d)
+                    new_soft.remove(f);
+                else
+                    new_soft[f] = w - d;
+                if (w2 == d)
+                    new_soft.remove(nf);
+                else
+                    new_soft[nf] = w2 - d;
+                ++num_complements;
+            }
+        }
+        if (num_fixed + num_complements == 0) {
+            m_trail.reset();
+            return;
+        }
+        IF_VERBOSE(1, verbose_stream() << "(opt.maxsat fixed: " << num_fixed << " complements: " << num_complements << ")\n";);
+        set_soft(softs, fmls, new_soft);
+    }
+
+    /**
+       \brief merge soft constraints that imply each other by unit propagation
+       and remove soft constraints whose negation is implied.
+    */
+    bool preprocess::merge_equivalent(vector<soft>& softs, rational& lower) {
+        expr_ref_vector fmls(m);
+        obj_map<expr, rational> new_soft = soft2map(softs, fmls);
+        params_ref p;
+        p.set_uint("max_conflicts", 1);
+        s.updt_params(p);
+
+        u_map<expr*> ids;
+        for (expr* f : fmls)
+            ids.insert(f->get_id(), f);
+
+        u_map<uint_set> implies;
+        unsigned num_fixed = 0;
+        for (expr* f : fmls) {
+            lbool is_sat;
+            expr_ref_vector trail = propagate(f, is_sat);
+            if (is_sat == l_false) {
+                lower += new_soft[f];
+                s.assert_expr(m.mk_not(f));
+                new_soft.remove(f);
+                ++num_fixed;
+                continue;
+            }
+            if (!m.inc())
+                break;
+            uint_set imp;
+            for (expr* g : trail)
+                if (g != f && ids.contains(g->get_id()))
+                    imp.insert(g->get_id());
+            implies.insert(f->get_id(), imp);
+        }
+
+        p.set_uint("max_conflicts", UINT_MAX);
+        s.updt_params(p);
+        if (!m.inc())
+            return false;
+
+        unsigned num_merged = 0;
+        for (expr* f : fmls) {
+            if (!new_soft.contains(f))
+                continue;
+            for (unsigned id : implies[f->get_id()]) {
+                expr* g = ids[id];
+                if (new_soft.contains(g) && implies[id].contains(f->get_id())) {
+                    new_soft[f] += new_soft[g];
+                    new_soft.remove(g);
+                    ++num_merged;
+                }
+            }
+        }
+        IF_VERBOSE(1, verbose_stream() << "(opt.maxsat fixed: " << num_fixed << " equivalent: " << num_merged << ")\n";);
+        set_soft(softs, fmls, new_soft);
+        return true;
+    }
+
     obj_map<expr, rational> preprocess::soft2map(vector<soft> const& softs, expr_ref_vector& fmls) {
         obj_map<expr, rational> new_soft;
         for (soft const& sf : softs) {
@@ -205,6 +334,11 @@ namespace opt {
         mutex.reset();
         mutex.append(_mutex.size(), _mutex.data());
 
+        if (m_native_cardinality && mutex.size() > 2) {
+            pb_util pb(m);
+            s.assert_expr(pb.mk_at_most_k(mutex.size(), mutex.data(), 1));
+        }
+
         rational weight(0), sum1(0), sum2(0);
         vector<rational> weights;
         for (expr* e : mutex) {
@@ -232,6 +366,9 @@ namespace opt {
     preprocess::preprocess(solver& s):  m(s.get_manager()), s(s), m_trail(m) {}
     
     bool preprocess::operator()(vector<soft>& soft, rational& lower) {
+        simplify_units(soft, lower);
+        if (m_merge_equivalent && !merge_equivalent(soft, lower))
+            return false;
         if (!find_mutexes(soft, lower))
             return false;
         if (false && !prop_mutexes(soft, lower))
@@ -27,17 +27,26 @@ namespace opt {
         ast_manager&     m;
         solver&          s;
         expr_ref_vector  m_trail;
+        bool             m_merge_equivalent = false;
+        bool             m_native_cardinality = false;
 
         expr_ref_vector propagate(expr* f, lbool& is_sat);
         obj_map<expr, rational> soft2map(vector<soft> const& softs, expr_ref_vector& fmls);
         bool find_mutexes(vector<soft>& softs, rational& lower);
         bool prop_mutexes(vector<soft>& softs, rational& lower);
         void process_mutex(expr_ref_vector& mutex, obj_map<expr, rational>& new_soft, rational& lower);
+        void simplify_units(vector<soft>& softs, rational& lower);
+        bool merge_equivalent(vector<soft>& softs, rational& lower);
+        void set_soft(vector<soft>& softs, expr_ref_vector const& fmls, obj_map<expr, rational> const& new_soft);
 
         obj_map<expr, rational> dualize(obj_map<expr, rational> const& soft, expr_ref_vector& fmls);
 
     public:
         preprocess(solver& s);
+        // merge soft constraints that are equivalent by unit propagation.
+        void set_merge_equivalent(bool f) { m_merge_equivalent = f; }
+        // assert at-most-one constraints of mutexes as cardinality constraints.
+        void set_native_cardinality(bool f) { m_native_cardinality = f; }
         bool operator()(vector<soft>& soft, rational& lower);
     };
 };
@@ -416,6 +416,18 @@ namespace opt {
         return get_optimizer().value(v);
     }
     
+    /**
+       \brief upper bound of objective obj_index from the linear relaxation
+       of the constraints asserted at base level.
+    */
+    bool opt_solver::relaxation_bound(unsigned i, inf_eps& r) {
+        {
+            // force base level
+            solver::scoped_push _push(*this);
+        }
+        return get_optimizer().relaxation_bound(m_objective_vars[i], r);
+    }
+
     expr_ref opt_solver::mk_ge(unsigned var, inf_eps const& _val) {
         if (!_val.is_finite()) {
             return expr_ref(_val.is_pos() ? m.mk_false() : m.mk_true(), m);
@@ -125,6 +125,7 @@ namespace opt {
         bool maximize_objectives1(expr_ref_vector& blockers);
         inf_eps const & saved_objective_value(unsigned obj_index);
         inf_eps current_objective_value(unsigned obj_index);
+        bool relaxation_bound(unsigned obj_index, inf_eps& r);
         model* get_model_idx(unsigned obj_index) { return m_models[obj_index]; }
 
         bool was_unknown() const { return m_was_unknown; }
@@ -282,6 +282,71 @@ namespace opt {
         return l_true;
     }
 
+    /*
+        Bisection between the best objective value and the bound of the 
+        linear relaxation. Each check either raises the lower bound to at
+        least the midpoint or lowers the upper bound below it, so the number
+        of checks is logarithmic in the width of the initial interval. 
+        Applies to integer objectives with a finite relaxation bound, 
+        otherwise it falls back to geometric_lex.
+    */
+    lbool optsmt::bisect_lex(unsigned obj_index, bool is_maximize) {
+        arith_util arith(m);
+        if (!arith.is_int(m_objs.get(obj_index)))
+            return geometric_lex(obj_index, is_maximize);
+
+        for (unsigned i = 0; i < obj_index; ++i) 
+            commit_assignment(i);
+
+        expr_ref bound(m);
+        auto improve = [&]() {
+            m_s->maximize_objective(obj_index, bound);
+            m_s->get_model(m_model);
+            SASSERT(m_model);
+            update_lower_lex(obj_index, m_s->saved_objective_value(obj_index), is_maximize);
+        };
+
+        lbool is_sat = m_s->check_sat(0, nullptr);
+        if (is_sat != l_true)
+            return is_sat;
+        improve();
+        inf_eps ub;
+        if (!m.inc())
+            return l_undef;
+        if (!m_lower[obj_index].is_finite() || !m_s->relaxation_bound(obj_index, ub) || !ub.is_finite())
+            return geometric_lex(obj_index, is_maximize);
+
+        rational lo = floor(m_lower[obj_index].get_rational());
+        rational hi = floor(ub.get_rational());
+        if (ub.get_rational().is_int() && ub.get_infinitesimal().is_neg())
+            hi -= 1;
+        IF_VERBOSE(2, verbose_stream() << "(optsmt.bisect :lower " << lo << " :relaxation " << hi << ")\n";);
+        while (lo < hi && m.inc()) {
+            rational mid = floor((lo + hi + 1) / rational(2));
+            m_s->push();
+            m_s->assert_expr(m_s->mk_ge(obj_index, inf_eps(mid)));
+            is_sat = m_s->check_sat(0, nullptr);
+            if (is_sat == l_true) {
+                improve();
+                lo = std::max(mid, floor(m_lower[obj_index].get_rational()));
+            }
+            m_s->pop(1);
+            if (is_sat == l_false)
+                hi = mid - 1;
+            if (is_sat == l_undef)
+                return l_undef;
+        }
+        if (!m.inc())
+            return l_undef;
+
+        // set the solution tight.
+        m_upper[obj_index] = m_lower[obj_index];    
+        for (unsigned i = obj_index+1; i < m_lower.size(); ++i) {
+            m_lower[i] = inf_eps(rational(-1), inf_rational(0));
+        }
+        return l_true;
+    }
+
     bool optsmt::can_increment_delta(vector<inf_eps> const& lower, unsigned i) {
         arith_util arith(m);
         inf_eps max_delta;
@@ -505,6 +570,9 @@ namespace opt {
         if (is_maximize && m_optsmt_engine == symbol("symba")) {
             return symba_opt();
         }
+        else if (m_optsmt_engine == symbol("bisect")) {
+            return bisect_lex(obj_index, is_maximize);
+        }
         else {
             return geometric_lex(obj_index, is_maximize);
         }
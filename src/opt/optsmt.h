@@ -83,6 +83,8 @@ namespace opt {
 
         lbool geometric_lex(unsigned idx, bool is_maximize);
 
+        lbool bisect_lex(unsigned idx, bool is_maximize);
+
         void set_max(vector<inf_eps>& dst, vector<inf_eps> const& src, expr_ref_vector& fmls);
 
         expr_ref update_lower();
@@ -25,7 +25,10 @@ namespace opt {
     
     void totalizer::ensure_bound(node* n, unsigned k) {
         auto& lits = n->m_literals;
-        if (k > lits.size())
+        k = std::min(k, lits.size());
+        // outputs are created from the highest missing one downwards, so 
+        // the outputs 1..k of n and its children exist if output k exists.
+        if (k == 0 || lits.get(k - 1))
             return;
         auto* l = n->m_left;
         auto* r = n->m_right;
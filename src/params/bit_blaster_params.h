@@ -21,6 +21,7 @@ Revision History:
 struct bit_blaster_params {
     bool  m_bb_ext_gates;
     bool  m_bb_quantifiers;
+    bool  m_bb_wallace_mul = false;
     bit_blaster_params() :
         m_bb_ext_gates(false),
         m_bb_quantifiers(false) {
@@ -35,6 +36,7 @@ struct bit_blaster_params {
     void display(std::ostream & out) const {
         out << "m_bb_ext_gates=" << m_bb_ext_gates << '\n';
         out << "m_bb_quantifiers=" << m_bb_quantifiers << '\n';
+        out << "m_bb_wallace_mul=" << m_bb_wallace_mul << '\n';
     }
 };
 
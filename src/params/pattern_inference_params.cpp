@@ -23,6 +23,7 @@ void pattern_inference_params::updt_params(params_ref const & _p) {
     pattern_inference_params_helper p(_p);
     m_pi_enabled                 = p.enabled();
     m_pi_max_multi_patterns      = p.max_multi_patterns();
+    m_pi_max_candidates          = p.max_candidates();
     m_pi_block_loop_patterns     = p.block_loop_patterns();
     m_pi_decompose_patterns      = p.decompose_patterns();
     m_pi_arith                   = static_cast<arith_pattern_inference_kind>(p.arith());
@@ -38,6 +39,7 @@ void pattern_inference_params::updt_params(params_ref const & _p) {
 void pattern_inference_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_pi_enabled);
     DISPLAY_PARAM(m_pi_max_multi_patterns);
+    DISPLAY_PARAM(m_pi_max_candidates);
     DISPLAY_PARAM(m_pi_block_loop_patterns);
     DISPLAY_PARAM(m_pi_decompose_patterns);
     DISPLAY_PARAM(m_pi_arith);
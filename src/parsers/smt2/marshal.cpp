@@ -19,10 +19,12 @@ Abstract:
 #include "ast/ast_smt_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "ast/ast_serialize.h"
 
 std::ostream &marshal(std::ostream &os, expr_ref e, ast_manager &m) {
-    ast_smt_pp pp(m);
-    pp.display_smt2(os, e);
+    ast_serializer s(m, os);
+    s(e);
+    s.finish();
     return os;
 }
 
@@ -34,6 +36,14 @@ std::string marshal(expr_ref e, ast_manager &m) {
 
 
 expr_ref unmarshal(std::istream &is, ast_manager &m) {
+    if (is_ast_serialization(is)) {
+        expr_ref r(m);
+        ast_deserializer d(m, is);
+        if (!d(r))
+            r = nullptr;
+        return r;
+    }
+    // fall back to SMT2 text produced by earlier versions.
     cmd_context ctx(false, &m);
     ctx.set_ignore_check(true);
     if (!parse_smt2_commands(ctx, is)) { 
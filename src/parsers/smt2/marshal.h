@@ -8,6 +8,9 @@ Abstract:
 
    marshaling and unmarshaling of expressions
 
+   Expressions are marshaled in the binary format of ast_serialize.h.
+   unmarshal also accepts SMT2 text.
+
    --*/
 #pragma once
 
@@ -31,7 +31,12 @@ Revision History:
 #include "parsers/smt2/smt2scanner.h"
 #include "parsers/util/pattern_validation.h"
 #include "parsers/util/parser_params.hpp"
+#include "ast/ast_translation.h"
+#include "util/scoped_ptr_vector.h"
 #include<sstream>
+#ifndef SINGLE_THREAD
+#include<thread>
+#endif
 
 namespace smt2 {
     typedef cmd_exception parser_exception;
@@ -3134,6 +3139,10 @@ namespace smt2 {
             m_scanner.reset_input(is, interactive);
         }
 
+        void set_line(unsigned line) {
+            m_scanner.set_line(line);
+        }
+
         sexpr_ref parse_sexpr_ref() {
             m_num_bindings    = 0;
             m_num_open_paren = 0;
@@ -3235,9 +3244,259 @@ namespace smt2 {
     };
 
     void free_parser(parser * p) { dealloc(p); }
+
+#ifndef SINGLE_THREAD
+
+    /**
+       \brief Parallel parsing of non-interactive input.
+
+       The input is split into top-level commands by matching parentheses.
+       Commands are parsed in order by one parser, except for runs of large
+       assert commands. The assertions of a run are partitioned into
+       contiguous ranges, and each range is parsed by a worker thread into a
+       private cmd_context that first replays the declarations seen so far.
+       The results are translated back and asserted in the order of the input.
+       If a worker fails, the run is parsed again sequentially, so errors are
+       reported as usual. Named assertions, and runs following commands whose
+       effect cannot be replayed, such as datatype declarations, are parsed
+       sequentially.
+    */
+    class parallel_parser {
+        struct command {
+            unsigned    m_begin;
+            unsigned    m_end;
+            unsigned    m_line;
+            std::string m_head;
+        };
+
+        // minimal number of bytes in the assertions of a worker.
+        static const unsigned min_bytes_per_thread = 1 << 16;
+
+        cmd_context&       m_ctx;
+        std::string const& m_text;
+        params_ref const&  m_params;
+        char const*        m_filename;
+        unsigned           m_threads;
+        vector<command>    m_cmds;
+        std::string        m_decls;
+        scoped_ptr<parser> m_parser;
+
+        bool skip_quoted(unsigned& i, char q) {
+            for (++i; i < m_text.size(); ++i) {
+                if (q == '"' && m_text[i] == '"') {
+                    if (i + 1 < m_text.size() && m_text[i + 1] == '"')
+                        ++i;
+                    else
+                        return true;
+                }
+                else if (q == '|' && m_text[i] == '|')
+                    return true;
+            }
+            return false;
+        }
+
+        // split the text into top-level commands, fail if it is not a sequence of balanced commands.
+        bool split() {
+            unsigned depth = 0, line = 1;
+            command cmd;
+            for (unsigned i = 0; i < m_text.size(); ++i) {
+                char c = m_text[i];
+                switch (c) {
+                case '\n':
+                    ++line;
+                    break;
+                case ';':
+                    while (i + 1 < m_text.size() && m_text[i + 1] != '\n')
+                        ++i;
+                    break;
+                case '"':
+                case '|': {
+                    unsigned j = i;
+                    if (!skip_quoted(i, c))
+                        return false;
+                    for (; j < i; ++j)
+                        line += m_text[j] == '\n';
+                    break;
+                }
+                case '(':
+                    if (depth++ == 0) {
+                        cmd.m_begin = i;
+                        cmd.m_line = line;
+                        unsigned j = i + 1;
+                        while (j < m_text.size() && isspace(m_text[j]))
+                            ++j;
+                        unsigned k = j;
+                        while (k < m_text.size() && !isspace(m_text[k]) && m_text[k] != '(' && m_text[k] != ')')
+                            ++k;
+                        cmd.m_head = m_text.substr(j, k - j);
+                    }
+                    break;
+                case ')':
+                    if (depth == 0)
+                        return false;
+                    if (--depth == 0) {
+                        cmd.m_end = i + 1;
+                        m_cmds.push_back(cmd);
+                    }
+                    break;
+                default:
+                    if (depth == 0 && !isspace(c))
+                        return false;
+                    break;
+                }
+            }
+            return depth == 0;
+        }
+
+        std::string text(unsigned lo, unsigned hi) const {
+            return m_text.substr(m_cmds[lo].m_begin, m_cmds[hi - 1].m_end - m_cmds[lo].m_begin);
+        }
+
+        unsigned size(unsigned i) const { return m_cmds[i].m_end - m_cmds[i].m_begin; }
+
+        bool is_named(unsigned i) const {
+            return m_text.find(":named", m_cmds[i].m_begin) < m_cmds[i].m_end;
+        }
+
+        static bool is_replayed(std::string const& h) {
+            return h == "declare-fun" || h == "declare-const" || h == "declare-sort" || h == "define-sort" ||
+                h == "define-fun" || h == "define-const" || h == "push" || h == "pop";
+        }
+
+        static bool is_neutral(std::string const& h) {
+            return h == "assert" || h == "check-sat" || h == "check-sat-assuming" || h == "set-info" ||
+                h == "set-option" || h == "set-logic" || h == "echo" || h == "exit" || h == "eval" || h == "simplify" ||
+                h.compare(0, 4, "get-") == 0;
+        }
+
+        // parse the commands [lo, hi) with the sequential parser.
+        bool parse_sequential(unsigned lo, unsigned hi) {
+            if (lo == hi)
+                return true;
+            std::istringstream is(text(lo, hi));
+            if (m_parser)
+                m_parser->reset_input(is, false);
+            else
+                m_parser = alloc(parser, m_ctx, is, false, m_params, m_filename);
+            m_parser->set_line(m_cmds[lo].m_line);
+            return (*m_parser)();
+        }
+
+        // parse the assertions [lo, hi) in parallel, return false to fall back to sequential parsing.
+        bool parse_parallel(unsigned lo, unsigned hi) {
+            unsigned total = 0;
+            for (unsigned i = lo; i < hi; ++i)
+                total += size(i);
+            unsigned num_threads = std::min(m_threads, std::min(hi - lo, total / min_bytes_per_thread));
+            if (num_threads < 2)
+                return false;
+            unsigned_vector bounds;
+            bounds.push_back(lo);
+            unsigned acc = 0;
+            for (unsigned i = lo; i < hi && bounds.size() < num_threads; ++i) {
+                acc += size(i);
+                if (acc >= (total / num_threads) * bounds.size())
+                    bounds.push_back(i + 1);
+            }
+            bounds.push_back(hi);
+            num_threads = bounds.size() - 1;
+
+            scoped_ptr_vector<cmd_context> ctxs;
+            vector<std::ostringstream> outs(num_threads);
+            for (unsigned i = 0; i < num_threads; ++i) {
+                ctxs.push_back(alloc(cmd_context, false, nullptr, m_ctx.get_logic()));
+                ctxs[i]->set_global_decls(m_ctx.global_decls());
+                ctxs[i]->set_regular_stream(outs[i]);
+                ctxs[i]->set_diagnostic_stream(outs[i]);
+                ctxs[i]->m();
+            }
+            svector<bool> ok(num_threads, false);
+            auto worker = [&](unsigned i) {
+                try {
+                    params_ref p;
+                    p.copy(m_params);
+                    p.set_uint("threads", 1);
+                    std::istringstream is(m_decls + text(bounds[i], bounds[i + 1]));
+                    ok[i] = parse_smt2_commands(*ctxs[i], is, false, p, m_filename) &&
+                        ctxs[i]->assertions().size() == bounds[i + 1] - bounds[i];
+                }
+                catch (z3_exception&) {
+                    ok[i] = false;
+                }
+            };
+            vector<std::thread> threads(num_threads);
+            for (unsigned i = 0; i < num_threads; ++i)
+                threads[i] = std::thread([&, i]() { worker(i); });
+            for (auto& th : threads)
+                th.join();
+            for (bool b : ok)
+                if (!b)
+                    return false;
+            for (unsigned i = 0; i < num_threads; ++i) {
+                ast_translation tr(ctxs[i]->m(), m_ctx.m(), false);
+                for (expr* a : ctxs[i]->assertions()) {
+                    expr_ref f(tr(a), m_ctx.m());
+                    m_ctx.assert_expr(f);
+                    m_ctx.print_success();
+                }
+            }
+            IF_VERBOSE(3, verbose_stream() << "(smt2-parser :threads " << num_threads << " :assertions " << (hi - lo) << ")\n");
+            return true;
+        }
+
+    public:
+        parallel_parser(cmd_context& ctx, std::string const& text, params_ref const& p, char const* filename, unsigned threads):
+            m_ctx(ctx), m_text(text), m_params(p), m_filename(filename), m_threads(threads) {}
+
+        bool operator()() {
+            if (!split()) {
+                std::istringstream is(m_text);
+                parser p(m_ctx, is, false, m_params, m_filename);
+                return p();
+            }
+            bool ok = true, replay = true;
+            unsigned start = 0, n = m_cmds.size();
+            for (unsigned i = 0; i < n; ) {
+                std::string const& h = m_cmds[i].m_head;
+                if (h == "assert" && replay) {
+                    unsigned j = i;
+                    while (j < n && m_cmds[j].m_head == "assert" && !is_named(j))
+                        ++j;
+                    if (j > i + 1) {
+                        ok &= parse_sequential(start, i);
+                        if (!parse_parallel(i, j))
+                            ok &= parse_sequential(i, j);
+                        start = j;
+                    }
+                    i = std::max(i + 1, j);
+                    continue;
+                }
+                if (is_replayed(h))
+                    m_decls.append(m_text, m_cmds[i].m_begin, size(i)).push_back('\n');
+                else if (!is_neutral(h))
+                    replay = false;
+                ++i;
+                if (h == "exit")
+                    return parse_sequential(start, i) && ok;
+            }
+            return parse_sequential(start, n) && ok;
+        }
+    };
+#endif
 };
 
 bool parse_smt2_commands(cmd_context & ctx, std::istream & is, bool interactive, params_ref const & ps, char const * filename) {
+#ifndef SINGLE_THREAD
+    unsigned threads = parser_params(ps).threads();
+    if (threads > 1 && !interactive && !ctx.interactive_mode()) {
+        std::string text;
+        char block[1 << 16];
+        while (is.read(block, sizeof(block)) || is.gcount() > 0)
+            text.append(block, static_cast<size_t>(is.gcount()));
+        smt2::parallel_parser p(ctx, text, ps, filename, threads);
+        return p();
+    }
+#endif
     smt2::parser p(ctx, is, interactive, ps, filename);
     return p();
 }
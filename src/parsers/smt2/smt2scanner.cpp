@@ -16,11 +16,19 @@ Author:
 Revision History:
 
 --*/
+#include <cstring>
 #include "parsers/smt2/smt2scanner.h"
 #include "parsers/util/parser_params.hpp"
 
 namespace smt2 {
 
+    static const uint64_t s_pow10[] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+        1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+        100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+        1000000000000000000ull
+    };
+
     void scanner::next() {
         if (m_cache_input)
             m_cache.push_back(m_curr);
@@ -36,7 +44,7 @@ namespace smt2 {
             m_bpos++;
         }
         else {
-            m_stream->read(m_buffer, SCANNER_BUFFER_SIZE);
+            m_stream->read(m_buffer.data(), SCANNER_BUFFER_SIZE);
             m_bend = static_cast<unsigned>(m_stream->gcount());
             m_bpos = 0;
             if (m_bpos == m_bend) {
@@ -50,10 +58,29 @@ namespace smt2 {
         m_spos++;
     }
 
+    /**
+       \brief same as calling next() k times, for k <= m_bend - m_bpos.
+    */
+    void scanner::advance(unsigned k) {
+        SASSERT(is_buffered() && k <= m_bend - m_bpos);
+        if (k == 0)
+            return;
+        if (m_cache_input)
+            m_cache.append(k, buffered_begin());
+        m_bpos += k;
+        m_spos += k;
+        m_curr = m_buffer[m_bpos - 1];
+    }
+
     void scanner::read_comment() {
         SASSERT(curr() == ';');
         next();
         while (true) {
+            if (is_buffered()) {
+                char const* b = buffered_begin();
+                char const* e = static_cast<char const*>(memchr(b, '\n', buffered_end() - b));
+                advance(static_cast<unsigned>((e ? e : buffered_end() - 1) - b));
+            }
             char c = curr();
             if (m_at_eof)
                 return;
@@ -119,6 +146,15 @@ namespace smt2 {
 
     scanner::token scanner::read_symbol_core() {
         while (!m_at_eof) {
+            if (!m_interactive) {
+                char const* b = buffered_begin();
+                char const* p = b;
+                char const* e = buffered_end() - 1;
+                while (p < e && is_symbol_char(*p))
+                    ++p;
+                m_string.append(static_cast<unsigned>(p - b), b);
+                advance(static_cast<unsigned>(p - b));
+            }
             char c = curr();
             signed char n = m_normalized[static_cast<unsigned char>(c)];
             if (n == 'a' || n == '0' || n == '-') {
@@ -142,6 +178,23 @@ namespace smt2 {
 
     scanner::token scanner::read_symbol() {
         SASSERT(m_normalized[static_cast<unsigned>(curr())] == 'a' || curr() == ':' || curr() == '-');
+        if (!m_interactive) {
+            // intern the symbol in place when it ends inside the buffer
+            char* b = m_buffer.data() + m_bpos - 1;
+            char* e = m_buffer.data() + m_bend;
+            char* p = b + 1;
+            while (p < e && is_symbol_char(*p))
+                ++p;
+            if (p < e) {
+                char delim = *p;
+                *p = 0;
+                m_id = symbol(b);
+                *p = delim;
+                advance(static_cast<unsigned>(p - b));
+                TRACE("scanner", tout << "new symbol: " << m_id << "\n";);
+                return SYMBOL_TOKEN;
+            }
+        }
         m_string.reset();
         m_string.push_back(curr());
         next();
@@ -150,17 +203,26 @@ namespace smt2 {
 
     scanner::token scanner::read_number() {
         SASSERT('0' <= curr() && curr() <= '9');
-        rational q(1);
-        m_number = rational(curr() - '0');
+        // digits are accumulated in machine words of up to 18 digits
+        uint64_t chunk = curr() - '0';
+        unsigned chunk_len = 1;
+        unsigned num_decimals = 0;
+        m_number.reset();
         next();
         bool is_float = false;
 
         while (!m_at_eof) {
             char c = curr();
             if ('0' <= c && c <= '9') {
-                m_number = rational(10)*m_number + rational(c - '0');
+                if (chunk_len == 18) {
+                    m_number = m_number * rational(s_pow10[chunk_len], rational::ui64()) + rational(chunk, rational::ui64());
+                    chunk = 0;
+                    chunk_len = 0;
+                }
+                chunk = 10 * chunk + (c - '0');
+                ++chunk_len;
                 if (is_float)
-                    q *= rational(10);
+                    ++num_decimals;
                 next();
             }
             else if (c == '.') {
@@ -173,8 +235,9 @@ namespace smt2 {
                 break;
             }
         }
+        m_number = m_number * rational(s_pow10[chunk_len], rational::ui64()) + rational(chunk, rational::ui64());
         if (is_float)
-            m_number /= q;
+            m_number /= power(rational(10), num_decimals);
         TRACE("scanner", tout << "new number: " << m_number << "\n";);
         return is_float ? FLOAT_TOKEN : INT_TOKEN;
     }
@@ -222,29 +285,38 @@ namespace smt2 {
         SASSERT(curr() == '#');
         next();
         char c = curr();
+        // digits are accumulated in machine words of up to 60 bits
+        uint64_t chunk = 0;
+        unsigned chunk_bits = 0;
+        auto flush = [&]() {
+            if (chunk_bits > 0)
+                m_number = m_number * rational::power_of_two(chunk_bits) + rational(chunk, rational::ui64());
+            chunk = 0;
+            chunk_bits = 0;
+        };
         if (c == 'x') {
             next();
             c = curr();
             m_number  = rational(0);
             m_bv_size = 0;
             while (true) {
-                if ('0' <= c && c <= '9') {
-                    m_number *= rational(16);
-                    m_number += rational(c - '0');
-                }
-                else if ('a' <= c && c <= 'f') {
-                    m_number *= rational(16);
-                    m_number += rational(10 + (c - 'a'));
-                }
-                else if ('A' <= c && c <= 'F') {
-                    m_number *= rational(16);
-                    m_number += rational(10 + (c - 'A'));
-                }
+                unsigned d;
+                if ('0' <= c && c <= '9')
+                    d = c - '0';
+                else if ('a' <= c && c <= 'f')
+                    d = 10 + (c - 'a');
+                else if ('A' <= c && c <= 'F')
+                    d = 10 + (c - 'A');
                 else {
                     if (m_bv_size == 0)
                         throw scanner_exception("invalid empty bit-vector literal", m_line, m_spos);
+                    flush();
                     return BV_TOKEN;
                 }
+                if (chunk_bits == 60)
+                    flush();
+                chunk = (chunk << 4) | d;
+                chunk_bits += 4;
                 m_bv_size += 4;
                 next();
                 c = curr();
@@ -256,14 +328,17 @@ namespace smt2 {
             m_number  = rational(0);
             m_bv_size = 0;
             while (c == '0' || c == '1') {
-                m_number *= rational(2);
-                m_number += rational(c - '0');
+                if (chunk_bits == 60)
+                    flush();
+                chunk = (chunk << 1) | unsigned(c - '0');
+                ++chunk_bits;
                 m_bv_size++;
                 next();
                 c = curr();
             }
             if (m_bv_size == 0)
                 throw scanner_exception("invalid empty bit-vector literal", m_line, m_spos);
+            flush();
             return BV_TOKEN;
         }
         else if (c == '|') {
@@ -289,6 +364,8 @@ namespace smt2 {
         m_stream(&stream),
         m_cache_input(false) {
 
+        m_buffer.resize(SCANNER_BUFFER_SIZE);
+
 
         for (int i = 0; i < 256; ++i) {
             m_normalized[i] = (signed char) i;
@@ -340,6 +417,14 @@ namespace smt2 {
 
             switch (m_normalized[(unsigned char) c]) {
             case ' ':
+                if (is_buffered()) {
+                    char const* b = buffered_begin();
+                    char const* p = b + 1;
+                    char const* e = buffered_end();
+                    while (p < e && m_normalized[static_cast<unsigned char>(*p)] == ' ')
+                        ++p;
+                    advance(static_cast<unsigned>(p - b - 1));
+                }
                 next();
                 break;
             case '\n':
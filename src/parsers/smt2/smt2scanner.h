@@ -44,8 +44,8 @@ namespace smt2 {
         unsigned           m_bv_size;
         // end of data
         signed char        m_normalized[256];
-#define SCANNER_BUFFER_SIZE 1024
-        char               m_buffer[SCANNER_BUFFER_SIZE];
+#define SCANNER_BUFFER_SIZE (64*1024)
+        svector<char>      m_buffer;
         unsigned           m_bpos;
         unsigned           m_bend;
         svector<char>      m_string;
@@ -59,6 +59,18 @@ namespace smt2 {
         char curr() const { return m_curr; }
         void new_line() { m_line++; m_spos = 0; }
         void next();
+
+        // Fast paths, for non-interactive input, scan the block buffer directly.
+        // The current character is m_buffer[m_bpos - 1] and the characters
+        // after it in the buffer are m_buffer[m_bpos..m_bend).
+        char const* buffered_begin() const { return m_buffer.data() + m_bpos - 1; }
+        char const* buffered_end() const { return m_buffer.data() + m_bend; }
+        bool is_buffered() const { return !m_interactive && !m_at_eof; }
+        void advance(unsigned k);
+        bool is_symbol_char(char c) const {
+            signed char n = m_normalized[static_cast<unsigned char>(c)];
+            return n == 'a' || n == '0' || n == '-';
+        }
         
     public:
         
@@ -78,6 +90,7 @@ namespace smt2 {
         scanner(cmd_context & ctx, std::istream& stream, bool interactive = false);  
         
         int get_line() const { return m_line; }
+        void set_line(int line) { m_line = line; }
         int get_pos() const { return m_pos; }
         symbol const & get_id() const { return m_id; }
         rational get_number() const { return m_number; }
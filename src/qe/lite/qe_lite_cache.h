@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    qe_lite_cache.h
+
+Abstract:
+
+    Cache of light-weight quantifier elimination results.
+
+    qe_lite and qel are called repeatedly on the same formula and
+    variables, for instance by model-based projection on the same cube.
+    Since formulas are hash-consed, an entry is keyed by the formula
+    and stores the variables it was projected on, the resulting formula
+    and the variables that were not eliminated. The cache is reset when
+    it grows beyond its capacity.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/statistics.h"
+
+class qe_lite_cache {
+    struct entry {
+        app_ref_vector m_vars_in;
+        app_ref_vector m_vars_out;
+        expr_ref       m_fml_out;
+        entry(ast_manager& m): m_vars_in(m), m_vars_out(m), m_fml_out(m) {}
+    };
+    ast_manager&              m;
+    expr_ref_vector           m_keys;
+    obj_map<expr, entry*>     m_cache;
+    scoped_ptr_vector<entry>  m_entries;
+    unsigned                  m_capacity;
+    unsigned                  m_hits = 0;
+    unsigned                  m_misses = 0;
+
+public:
+    qe_lite_cache(ast_manager& m, unsigned capacity = 1024): m(m), m_keys(m), m_capacity(capacity) {}
+
+    /**
+       \brief retrieve the result of eliminating vars from fml.
+    */
+    bool find(app_ref_vector& vars, expr_ref& fml) {
+        entry* e = nullptr;
+        if (!m_cache.find(fml, e) || e->m_vars_in != vars) {
+            ++m_misses;
+            return false;
+        }
+        ++m_hits;
+        vars.reset();
+        vars.append(e->m_vars_out);
+        fml = e->m_fml_out;
+        return true;
+    }
+
+    void insert(app_ref_vector const& vars_in, expr* fml_in, app_ref_vector const& vars_out, expr* fml_out) {
+        if (m_capacity == 0)
+            return;
+        entry* e = nullptr;
+        if (!m_cache.find(fml_in, e)) {
+            if (m_entries.size() >= m_capacity)
+                reset();
+            e = alloc(entry, m);
+            m_entries.push_back(e);
+            m_keys.push_back(fml_in);
+            m_cache.insert(fml_in, e);
+        }
+        e->m_vars_in.reset();
+        e->m_vars_in.append(vars_in);
+        e->m_vars_out.reset();
+        e->m_vars_out.append(vars_out);
+        e->m_fml_out = fml_out;
+    }
+
+    void reset() {
+        m_cache.reset();
+        m_entries.reset();
+        m_keys.reset();
+    }
+
+    void collect_statistics(char const* hits, char const* misses, statistics& st) const {
+        st.update(hits, m_hits);
+        st.update(misses, m_misses);
+    }
+};
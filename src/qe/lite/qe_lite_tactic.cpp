@@ -35,6 +35,7 @@ Revision History:
 #include "tactic/tactical.h"
 #include "qe/mbp/mbp_solve_plugin.h"
 #include "qe/lite/qe_lite_tactic.h"
+#include "qe/lite/qe_lite_cache.h"
 #include "tactic/dependent_expr_state_tactic.h"
 
 
@@ -2269,6 +2270,7 @@ private:
     qel::ar_der  m_array_der;
     elim_star    m_elim_star;
     th_rewriter  m_rewriter;
+    qe_lite_cache m_cache;
 
     bool m_use_array_der;
     bool has_unique_non_ground(expr_ref_vector const& fmls, unsigned& index) {
@@ -2295,12 +2297,26 @@ public:
         m_array_der(m),
         m_elim_star(*this),
         m_rewriter(m),
+        m_cache(m),
         m_use_array_der(use_array_der) {}
 
+    void collect_statistics(statistics& st) const {
+        m_cache.collect_statistics("qe-lite cache hits", "qe-lite cache misses", st);
+    }
+
     void operator()(app_ref_vector& vars, expr_ref& fml) {
         if (vars.empty()) {
             return;
         }
+        if (m_cache.find(vars, fml))
+            return;
+        app_ref_vector vars_in(vars);
+        expr_ref fml_in(fml);
+        elim(vars, fml);
+        m_cache.insert(vars_in, fml_in, vars, fml);
+    }
+
+    void elim(app_ref_vector& vars, expr_ref& fml) {
         expr_ref tmp(fml);
         quantifier_ref q(m);
         proof_ref pr(m);
@@ -2396,6 +2412,10 @@ void qe_lite::operator()(app_ref_vector& vars, expr_ref& fml) {
 }
 
 
+void qe_lite::collect_statistics(statistics& st) const {
+    m_impl->collect_statistics(st);
+}
+
 void qe_lite::operator()(expr_ref& fml, proof_ref& pr) {
     (*m_impl)(fml, pr);
 }
@@ -23,6 +23,7 @@ Revision History:
 #include "ast/ast.h"
 #include "util/uint_set.h"
 #include "util/params.h"
+#include "util/statistics.h"
 #include "ast/simplifiers/dependent_expr_state.h"
 
 class tactic;
@@ -48,6 +49,11 @@ public:
     */
     void operator()(app_ref_vector& vars, expr_ref& fml);
 
+    /**
+       \brief add the hits and misses of the cache of results of operator()(vars, fml).
+    */
+    void collect_statistics(statistics& st) const;
+
     /**
        \brief
        Apply light-weight quantifier elimination to variables present/absent in the index set.
@@ -21,18 +21,31 @@ Author:
 
 --*/
 #include "qe/lite/qel.h"
+#include "qe/lite/qe_lite_cache.h"
 #include "qe/mbp/mbp_term_graph.h"
 
 class qel::impl {
 private:
     ast_manager &m;
+    qe_lite_cache m_cache;
 
 public:
-    impl(ast_manager &m, params_ref const &p) : m(m) {}
+    impl(ast_manager &m, params_ref const &p) : m(m), m_cache(m) {}
+
+    void collect_statistics(statistics &st) const {
+        m_cache.collect_statistics("qel cache hits", "qel cache misses", st);
+    }
 
     void operator()(app_ref_vector &vars, expr_ref &fml) {
         if (vars.empty()) return;
+        if (m_cache.find(vars, fml)) return;
+        app_ref_vector vars_in(vars);
+        expr_ref fml_in(fml);
+        elim(vars, fml);
+        m_cache.insert(vars_in, fml_in, vars, fml);
+    }
 
+    void elim(app_ref_vector &vars, expr_ref &fml) {
         mbp::term_graph tg(m);
         tg.set_vars(vars);
 
@@ -50,3 +63,7 @@ qel::~qel() { dealloc(m_impl); }
 void qel::operator()(app_ref_vector &vars, expr_ref &fml) {
     (*m_impl)(vars, fml);
 }
+
+void qel::collect_statistics(statistics &st) const {
+    m_impl->collect_statistics(st);
+}
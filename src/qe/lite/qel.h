@@ -26,6 +26,7 @@ Author:
 #include "ast/ast.h"
 #include "ast/ast_util.h"
 #include "util/params.h"
+#include "util/statistics.h"
 #include "util/uint_set.h"
 
 class qel {
@@ -43,4 +44,9 @@ public:
        set of variables that were not eliminated.
     */
     void operator()(app_ref_vector &vars, expr_ref &fml);
+
+    /**
+       \brief Add the hits and misses of the cache of previous results.
+    */
+    void collect_statistics(statistics &st) const;
 };
@@ -31,6 +31,7 @@ Revision History:
 #include "ast/scoped_proof.h"
 #include "ast/seq_decl_plugin.h"
 #include "util/gparams.h"
+#include "util/stopwatch.h"
 #include "model/model_evaluator.h"
 #include "model/model_pp.h"
 #include "qe/lite/qe_lite_tactic.h"
@@ -153,15 +154,30 @@ class mbproj::impl {
     th_rewriter                     m_rw;
     ptr_vector<mbp::project_plugin> m_plugins;
 
+    // statistics
+    enum { arith_w, datatype_w, array_w, qel_w, num_watches };
+    stopwatch                       m_watch[num_watches];
+    unsigned_vector                 m_plugin2watch;
+    unsigned                        m_num_calls = 0;
+
+    // kept across calls so that their caches are reused
+    scoped_ptr<qe_lite>             m_qe_lite;
+    scoped_ptr<qel>                 m_qel;
+
     // parameters
     bool m_reduce_all_selects;
     bool m_dont_sub;
     bool m_use_qel;
 
-    void add_plugin(mbp::project_plugin* p) {
+    void add_plugin(mbp::project_plugin* p, unsigned w) {
         family_id fid = p->get_family_id();
         SASSERT(!m_plugins.get(fid, nullptr));
         m_plugins.setx(fid, p, nullptr);
+        m_plugin2watch.setx(fid, w, num_watches);
+    }
+
+    stopwatch& watch(mbp::project_plugin* p) {
+        return m_watch[m_plugin2watch[p->get_family_id()]];
     }
 
     mbp::project_plugin* get_plugin(app* var) {
@@ -349,9 +365,9 @@ public:
     }
 
     impl(ast_manager& m, params_ref const& p) :m(m), m_params(p), m_rw(m) {
-        add_plugin(alloc(mbp::arith_project_plugin, m));
-        add_plugin(alloc(mbp::datatype_project_plugin, m));
-        add_plugin(alloc(mbp::array_project_plugin, m));
+        add_plugin(alloc(mbp::arith_project_plugin, m), arith_w);
+        add_plugin(alloc(mbp::datatype_project_plugin, m), datatype_w);
+        add_plugin(alloc(mbp::array_project_plugin, m), array_w);
         updt_params(p);
     }
 
@@ -360,6 +376,8 @@ public:
     }
 
     void updt_params(params_ref const& p) {
+        m_qe_lite = nullptr;
+        m_qel = nullptr;
         m_params.append(p);
         m_reduce_all_selects = m_params.get_bool("reduce_all_selects", false);
         m_dont_sub = m_params.get_bool("dont_sub", false);
@@ -380,7 +398,10 @@ public:
                 fmls.reset();
                 flatten_and(e, fmls);
                 for (auto* p : m_plugins) {
-                    if (p && p->solve(model, vars, fmls)) {
+                    if (!p)
+                        continue;
+                    scoped_watch _sw(watch(p));
+                    if (p->solve(model, vars, fmls)) {
                         change = true;
                     }
                 }
@@ -397,7 +418,10 @@ public:
         while (change && !vars.empty()) {
             change = solve(model, vars, fmls);
             for (auto* p : m_plugins) {
-                if (p && p->solve(model, vars, fmls)) {
+                if (!p)
+                    continue;
+                scoped_watch _sw(watch(p));
+                if (p->solve(model, vars, fmls)) {
                     change = true;
                 }
             }
@@ -418,6 +442,20 @@ public:
         e = mk_and(fmls);
         return any_of(subterms::all(e), [&](expr* c) { return seq.is_char(c) || seq.is_seq(c); });
     }
+    void collect_statistics(statistics& st) const {
+        st.update("mbp calls", m_num_calls);
+        st.update("time.mbp.arith", m_watch[arith_w].get_seconds());
+        st.update("time.mbp.datatype", m_watch[datatype_w].get_seconds());
+        st.update("time.mbp.array", m_watch[array_w].get_seconds());
+        st.update("time.mbp.qel", m_watch[qel_w].get_seconds());
+        if (m_qe_lite)
+            m_qe_lite->collect_statistics(st);
+        if (m_qel)
+            m_qel->collect_statistics(st);
+    }
+
+    void inc_calls() { ++m_num_calls; }
+
     void operator()(bool force_elim, app_ref_vector& vars, model& model, expr_ref_vector& fmls) {
             //don't use mbp_qel on some theories where model evaluation is
             //incomplete This is not a limitation of qel. Fix this either by
@@ -451,14 +489,21 @@ public:
             app_ref_vector new_vars(m);
             progress = false;
             for (mbp::project_plugin* p : m_plugins) {
-                if (p)
+                if (p) {
+                    scoped_watch _sw(watch(p));
                     (*p)(model, vars, fmls);
+                }
             }
             while (!vars.empty() && !fmls.empty() && m.limit().inc()) {
                 var = vars.back();
                 vars.pop_back();
                 mbp::project_plugin* p = get_plugin(var);
-                if (p && p->project1(model, var, vars, fmls)) {
+                bool projected = false;
+                if (p) {
+                    scoped_watch _sw(watch(p));
+                    projected = p->project1(model, var, vars, fmls);
+                }
+                if (projected) {
                     progress = true;
                 }
                 else {
@@ -497,8 +542,9 @@ public:
     }
 
     void do_qe_lite(app_ref_vector& vars, expr_ref& fml) {
-        qe_lite qe(m, m_params, false);
-        qe(vars, fml);
+        if (!m_qe_lite)
+            m_qe_lite = alloc(qe_lite, m, m_params, false);
+        (*m_qe_lite)(vars, fml);
         m_rw(fml);
         TRACE("qe", tout << "After qe_lite:\n" << fml << "\n" << "Vars: " << vars << "\n";);
         SASSERT(!m.is_false(fml));
@@ -506,8 +552,10 @@ public:
 
 
     void do_qel(app_ref_vector &vars, expr_ref &fml) {
-        qel qe(m, m_params);
-        qe(vars, fml);
+        scoped_watch _sw(m_watch[qel_w]);
+        if (!m_qel)
+            m_qel = alloc(qel, m, m_params);
+        (*m_qel)(vars, fml);
         m_rw(fml);
         TRACE("qe", tout << "After qel:\n"
                          << fml << "\n"
@@ -523,6 +571,7 @@ public:
     }
 
   void qel_project(app_ref_vector &vars, model &mdl, expr_ref &fml, bool reduce_all_selects) {
+      scoped_watch _sw(m_watch[qel_w]);
       flatten_and(fml);
       mbp::mbp_qel mbptg(m, m_params);
       mbptg(vars, fml, mdl);
@@ -706,14 +755,20 @@ void mbproj::get_param_descrs(param_descrs& r) {
 
 void mbproj::operator()(bool force_elim, app_ref_vector& vars, model& mdl, expr_ref_vector& fmls) {
     scoped_no_proof _sp(fmls.get_manager());
+    m_impl->inc_calls();
     (*m_impl)(force_elim, vars, mdl, fmls);
 }
 
 void mbproj::spacer(app_ref_vector& vars, model& mdl, expr_ref& fml) {
     scoped_no_proof _sp(fml.get_manager());
+    m_impl->inc_calls();
     m_impl->spacer(vars, mdl, fml);
 }
 
+void mbproj::collect_statistics(statistics& st) const {
+    m_impl->collect_statistics(st);
+}
+
 void mbproj::solve(model& model, app_ref_vector& vars, expr_ref_vector& fmls) {
     scoped_no_proof _sp(fmls.get_manager());
     m_impl->preprocess_solve(model, vars, fmls);
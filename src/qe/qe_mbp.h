@@ -22,6 +22,7 @@ Revision History:
 
 #include "ast/ast.h"
 #include "util/params.h"
+#include "util/statistics.h"
 #include "model/model.h"
 #include "math/simplex/model_based_opt.h"
 
@@ -67,6 +68,13 @@ namespace qe {
            - dont_sub (false)
         */
         void spacer(app_ref_vector& vars, model& mdl, expr_ref& fml);
+
+        /**
+           \brief
+           Add the number of projections and the time spent in each theory plugin
+           and in the term graph (QEL) projection.
+        */
+        void collect_statistics(statistics& st) const;
     };
 }
 
@@ -40,6 +40,8 @@ Notes:
 #include "qe/qe.h"
 #include "ast/rewriter/label_rewriter.h"
 #include "util/params.h"
+#include "util/gparams.h"
+#include "tactic/tactical.h"
 
 namespace qe {
 
@@ -534,11 +536,13 @@ namespace qe {
         expr_ref m_last_assert;
         
     public:
-        kernel(ast_manager& m):
+        kernel(ast_manager& m, params_ref const& p):
             m(m),
             m_solver(nullptr),
             m_last_assert(m)
         {
+            if (p.contains("random_seed"))
+                m_params.set_uint("random_seed", p.get_uint("random_seed", 0));
             m_params.set_bool("model", true);
             m_params.set_uint("relevancy", 0);
             m_params.set_uint("case_split_strategy", CS_ACTIVITY_WITH_CACHE);
@@ -1240,9 +1244,10 @@ namespace qe {
         
         qsat(ast_manager& m, params_ref const& p, qsat_mode mode):
             m(m),
+            m_params(p),
             m_mbp(m),
-            m_fa(m),
-            m_ex(m),
+            m_fa(m, p),
+            m_ex(m, p),
             m_pred_abs(m),
             m_answer(m),
             m_asms(m),
@@ -1352,6 +1357,7 @@ namespace qe {
         
         void collect_statistics(statistics & st) const override {
             st.copy(m_st);
+            m_mbp.collect_statistics(st);
             m_fa.collect_statistics(st);
             m_ex.collect_statistics(st);        
             m_pred_abs.collect_statistics(st);
@@ -1497,7 +1503,19 @@ namespace qe {
 };
 
 tactic * mk_qsat_tactic(ast_manager& m, params_ref const& p) {
-    return alloc(qe::qsat, m, p, qe::qsat_sat);
+    unsigned num_threads = p.get_uint("qsat_threads", gparams::get_module("smt"), 1);
+    if (num_threads <= 1)
+        return alloc(qe::qsat, m, p, qe::qsat_sat);
+    // The strands only differ in the random seed of their kernels.
+    // par translates the goal for each of them.
+    unsigned seed = p.get_uint("random_seed", gparams::get_module("smt"), 0);
+    ptr_buffer<tactic> ts;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        params_ref q(p);
+        q.set_uint("random_seed", seed + i);
+        ts.push_back(alloc(qe::qsat, m, q, qe::qsat_sat));
+    }
+    return par(ts.size(), ts.data());
 }
 
 tactic * mk_qe2_tactic(ast_manager& m, params_ref const& p) {   
@@ -20,6 +20,13 @@ Revision History:
 #undef max
 #undef min
 #include "sat/sat_solver.h"
+#include <fstream>
+#ifndef _WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 template<typename Buffer>
 static bool is_whitespace(Buffer & in) {
@@ -144,6 +151,41 @@ bool parse_dimacs(std::istream & in, std::ostream& err, sat::solver & solver) {
     return parse_dimacs_core(_in, err, solver);
 }
 
+bool parse_dimacs(char const * file_name, std::ostream& err, sat::solver & solver) {
+#ifndef _WINDOWS
+    int fd = open(file_name, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_t size = static_cast<size_t>(st.st_size);
+            void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data != MAP_FAILED) {
+                struct unmap {
+                    void* data; size_t size;
+                    ~unmap() { munmap(data, size); }
+                };
+                unmap _unmap{ data, size };
+                madvise(data, size, MADV_SEQUENTIAL);
+                char const* begin = static_cast<char const*>(data);
+                dimacs::memory_buffer _in(begin, begin + size);
+                return parse_dimacs_core(_in, err, solver);
+            }
+        }
+        else
+            close(fd);
+    }
+#endif
+    std::ifstream in(file_name, std::ios::binary);
+    if (in.bad() || in.fail()) {
+        err << "(error \"failed to open file '" << file_name << "'\")\n";
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    dimacs::memory_buffer _in(data.data(), data.data() + data.size());
+    return parse_dimacs_core(_in, err, solver);
+}
+
 
 namespace dimacs {
 
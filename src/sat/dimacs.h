@@ -25,6 +25,9 @@ Revision History:
 
 bool parse_dimacs(std::istream & s, std::ostream& err, sat::solver & solver);
 
+// parse a DIMACS file that is mapped into memory (read into memory if mapping is unavailable).
+bool parse_dimacs(char const * file_name, std::ostream& err, sat::solver & solver);
+
 namespace dimacs {
     struct lex_error : public std::exception {};
 
@@ -52,6 +55,26 @@ namespace dimacs {
         unsigned line() const { return m_line; }
     };
 
+    class memory_buffer {
+        char const*    m_curr;
+        char const*    m_end;
+        unsigned       m_line = 0;
+    public:
+        memory_buffer(char const* begin, char const* end):
+            m_curr(begin), m_end(end) {}
+
+        int operator *() const {
+            return m_curr < m_end ? static_cast<unsigned char>(*m_curr) : EOF;
+        }
+
+        void operator ++() {
+            ++m_curr;
+            if (m_curr < m_end && *m_curr == '\n') ++m_line;
+        }
+
+        unsigned line() const { return m_line; }
+    };
+
     struct drat_record {
         // a clause populates m_lits and m_status
         // a node populates m_node_id, m_name, m_args
@@ -470,6 +470,111 @@ namespace sat {
         }
     }
     
+    struct clause_glue_lt {
+        bool operator()(clause * c1, clause * c2) const { 
+            return c1->glue() < c2->glue() || (c1->glue() == c2->glue() && c1->size() < c2->size()); 
+        }
+    };
+
+    void asymm_branch::vivify_learned() {
+        if (!m_vivify)
+            return;
+        s.propagate(false);
+        if (s.m_inconsistent)
+            return;
+        SASSERT(s.scope_lvl() == 0);
+        stopwatch sw;
+        sw.start();
+        unsigned vivified = m_vivified, vivify_literals = m_vivify_literals;
+        bool_vector saved_phase(s.m_phase);
+        flet<bool> _is_probing(s.m_is_probing, true);
+        clause_vector& clauses = s.m_learned;
+        // clauses of small glue are the most valuable ones.
+        std::stable_sort(clauses.begin(), clauses.end(), clause_glue_lt());
+        int64_t counter = m_vivify_limit;
+        clause_vector::iterator it  = clauses.begin();
+        clause_vector::iterator it2 = it;
+        clause_vector::iterator end = clauses.end();
+        try {
+            for (; it != end; ++it) {
+                clause& c = *(*it);
+                if (counter > 0 && !s.inconsistent() && !c.was_removed() && !c.frozen() && 
+                    !c.was_vivified() && c.size() > 2 && c.glue() <= m_vivify_glue) {
+                    s.checkpoint();
+                    if (!vivify(c, counter))
+                        continue; // clause was removed
+                }
+                *it2 = *it;
+                ++it2;
+            }
+            clauses.set_end(it2);
+        }
+        catch (solver_exception & ex) {
+            for (; it != end; ++it, ++it2) 
+                *it2 = *it;
+            clauses.set_end(it2);
+            s.m_phase = saved_phase;
+            throw ex;
+        }
+        s.m_phase = saved_phase;
+        sw.stop();
+        IF_VERBOSE(2, verbose_stream() << " (sat-vivify :clauses " << (m_vivified - vivified) 
+                   << " :literals " << (m_vivify_literals - vivify_literals) << " " << sw << ")\n";);
+    }
+
+    /**
+       \brief vivify clause c. The negation of the literals in c is propagated in order (without c).
+       - a literal that becomes false is removed from c,
+       - if a literal becomes true, or the propagation produces a conflict,
+         the remaining literals are removed from c.
+       Return false if the clause was removed.
+    */
+    bool asymm_branch::vivify(clause& c, int64_t& counter) {
+        for (literal lit : c) 
+            if (s.value(lit) == l_true)
+                return true; // satisfied clauses are removed by the cleaner.
+        c.set_vivified(true);
+        counter -= c.size();
+        scoped_detach scoped_d(s, c);
+        VERIFY(s.m_trail.size() == s.m_qhead);
+        unsigned sz = c.size(), trail_sz = s.m_trail.size();
+        bool shortened = false;
+        m_tmp.reset();
+        s.push();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal lit = c[i];
+            lbool val = s.value(lit);
+            if (val == l_false) {
+                shortened = true;
+                continue;
+            }
+            m_tmp.push_back(lit);
+            if (val == l_true) {
+                shortened |= i + 1 < sz;
+                break;
+            }
+            s.assign_scoped(~lit);
+            s.propagate_core(false); // c is detached, must not use propagate()
+            if (s.inconsistent()) {
+                shortened |= i + 1 < sz;
+                break;
+            }
+        }
+        counter -= s.m_trail.size() - trail_sz;
+        s.pop(1);
+        if (!shortened)
+            return true;
+        // move the remaining literals to the front of the clause.
+        unsigned j = 0;
+        for (unsigned i = 0; i < sz; ++i) 
+            if (m_tmp.contains(c[i])) 
+                std::swap(c[i], c[j++]);
+        TRACE("asymm_branch", tout << "vivify " << c << " to " << j << " literals\n";);
+        ++m_vivified;
+        m_vivify_literals += sz - j;
+        return re_attach(scoped_d, c, j);
+    }
+    
     void asymm_branch::updt_params(params_ref const & _p) {
         sat_asymm_branch_params p(_p);
         m_asymm_branch         = p.asymm_branch();
@@ -480,6 +585,9 @@ namespace sat {
         m_asymm_branch_all     = p.asymm_branch_all();
         if (m_asymm_branch_limit > UINT_MAX)
             m_asymm_branch_limit = UINT_MAX;
+        m_vivify               = p.vivify();
+        m_vivify_glue          = p.vivify_glue();
+        m_vivify_limit         = p.vivify_limit();
     }
 
     void asymm_branch::collect_param_descrs(param_descrs & d) {
@@ -489,12 +597,16 @@ namespace sat {
     void asymm_branch::collect_statistics(statistics & st) const {
         st.update("sat elim literals", m_elim_literals);
         st.update("sat tr", m_tr);
+        st.update("sat vivified clauses", m_vivified);
+        st.update("sat vivified literals", m_vivify_literals);
     }
 
     void asymm_branch::reset_statistics() {
         m_elim_literals = 0;
         m_elim_learned_literals = 0;
         m_tr = 0;
+        m_vivified = 0;
+        m_vivify_literals = 0;
     }
 
 };
@@ -45,10 +45,16 @@ namespace sat {
         bool       m_asymm_branch_all;
         int64_t    m_asymm_branch_limit;
 
+        bool       m_vivify;
+        unsigned   m_vivify_glue;
+        int64_t    m_vivify_limit;
+
         // stats
         unsigned   m_elim_literals;
         unsigned   m_elim_learned_literals;
         unsigned   m_tr;
+        unsigned   m_vivified;
+        unsigned   m_vivify_literals;
 
         literal_vector m_pos, m_neg; // literals (complements of literals) in clauses sorted by discovery time (m_left in BIG).
         svector<std::pair<literal, unsigned>> m_pos1, m_neg1;
@@ -90,11 +96,20 @@ namespace sat {
 
         bool propagate_literal(clause const& c, literal l);
 
+        bool vivify(clause& c, int64_t& counter);
+
     public:
         asymm_branch(solver & s, params_ref const & p);
 
         void operator()(bool force);
 
+        /**
+           \brief vivify learned clauses of small glue by propagating the negation
+           of their literals and removing literals that are implied false, or the
+           suffix following a literal that is implied true or causes a conflict.
+         */
+        void vivify_learned();
+
         void updt_params(params_ref const & p);
         static void collect_param_descrs(param_descrs & d);
 
@@ -32,6 +32,7 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_vivified(false),
         m_inact_rounds(0),
         m_glue(255),
         m_psm(255) {
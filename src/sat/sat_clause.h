@@ -50,6 +50,7 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_vivified:1;
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
@@ -101,6 +102,9 @@ namespace sat {
         clause_offset get_new_offset() const;
         void set_new_offset(clause_offset off); 
 
+        bool was_vivified() const { return m_vivified; }
+        void set_vivified(bool f) { m_vivified = f; }
+
         bool on_reinit_stack() const { return m_reinit_stack; }
         void set_reinit_stack(bool f) { m_reinit_stack = f; }
     };
@@ -84,6 +84,9 @@ namespace sat {
         m_propagate_prefetch = p.propagate_prefetch();
         m_inprocess_max   = p.inprocess_max();
         m_inprocess_out   = p.inprocess_out();
+        m_inprocess_adaptive = p.inprocess_adaptive();
+        m_inprocess_min_ratio = p.inprocess_min_ratio();
+        m_inprocess_max_backoff = p.inprocess_max_backoff();
 
         m_random_freq     = p.random_freq();
         m_random_seed     = p.random_seed();
@@ -96,6 +99,11 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_threads     = p.threads();
+        m_cube_and_conquer = p.cube_and_conquer();
+        m_cube_and_conquer_depth = p.cube_and_conquer_depth();
+        m_cube_and_conquer_conflicts = p.cube_and_conquer_conflicts();
+        m_par_share_max_size = p.threads_share_size();
+        m_par_share_max_glue = p.threads_share_glue();
         m_ddfw_search     = p.ddfw_search();
         m_ddfw_threads    = p.ddfw_threads();
         m_prob_search     = p.prob_search();
@@ -111,6 +119,8 @@ namespace sat {
         m_anf_simplify      = p.anf();
         m_anf_delay         = p.anf_delay();
         m_anf_exlin         = p.anf_exlin();
+        m_gauss             = p.gauss();
+        m_gauss_max_xors    = p.gauss_max_xors();
         m_cut_simplify      = p.cut();
         m_cut_delay         = p.cut_delay();
         m_cut_aig           = p.cut_aig();
@@ -122,6 +132,7 @@ namespace sat {
         m_cut_force         = p.cut_force();
         m_lookahead_simplify = p.lookahead_simplify();
         m_lookahead_double = p.lookahead_double();
+        m_lookahead_threads = std::max(1u, p.lookahead_threads());
         m_lookahead_simplify_bca = p.lookahead_simplify_bca();
         if (p.lookahead_reward() == symbol("heule_schur")) 
             m_lookahead_reward = heule_schur_reward;
@@ -187,6 +198,7 @@ namespace sat {
         m_gc_k            = std::min(255u, p.gc_k());
         m_gc_burst        = p.gc_burst();
         m_gc_defrag       = p.gc_defrag();
+        m_gc_defrag_interval = std::max(1u, p.gc_defrag_interval());
 
         m_force_cleanup   = p.force_cleanup();
 
@@ -210,6 +222,7 @@ namespace sat {
              m_smt_proof_check ||
              m_drat_check_sat);
         m_drat_binary     = p.drat_binary();
+        m_drat_async      = p.drat_async();
         m_drat_activity   = p.drat_activity();
         m_dyn_sub_res     = p.dyn_sub_res();
 
@@ -223,6 +236,10 @@ namespace sat {
             throw sat_param_exception("invalid branching heuristic: accepted heuristics are 'vsids' or 'chb'");
 
         m_anti_exploration = p.branching_anti_exploration();
+        m_vmtf = p.branching_vmtf();
+        m_vmtf_conflicts = std::max(1u, p.branching_vmtf_conflicts());
+        m_vmtf_factor = std::max(1.0, p.branching_vmtf_factor());
+        m_vmtf_stable_restart = std::max(1u, p.branching_vmtf_stable_restart());
         m_step_size_init = 0.40;
         m_step_size_dec  = 0.000001;
         m_step_size_min  = 0.06;
@@ -257,6 +274,7 @@ namespace sat {
             m_pb_lemma_format = PB_LEMMA_PB;
         else
             throw sat_param_exception("invalid PB lemma format: 'cardinality' or 'pb' expected");
+        m_pb_sort_watch = p.pb_sort_watch();
         
         m_card_solver = p.cardinality_solver();
         m_xor_solver = false; // prevent users from playing with this option
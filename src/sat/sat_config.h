@@ -106,12 +106,20 @@ namespace sat {
         double             m_slow_glue_avg;
         unsigned           m_inprocess_max;
         symbol             m_inprocess_out;
+        bool               m_inprocess_adaptive;
+        double             m_inprocess_min_ratio;
+        unsigned           m_inprocess_max_backoff;
         double             m_random_freq;
         unsigned           m_random_seed;
         unsigned           m_burst_search;
         bool               m_enable_pre_simplify;
         unsigned           m_max_conflicts;
         unsigned           m_num_threads;
+        bool               m_cube_and_conquer;
+        unsigned           m_cube_and_conquer_depth;
+        unsigned           m_cube_and_conquer_conflicts;
+        unsigned           m_par_share_max_size;
+        unsigned           m_par_share_max_glue;
         bool               m_ddfw_search;
         unsigned           m_ddfw_threads;
         bool               m_prob_search;
@@ -132,6 +140,8 @@ namespace sat {
         bool               m_anf_simplify;
         unsigned           m_anf_delay;
         bool               m_anf_exlin;
+        bool               m_gauss;
+        unsigned           m_gauss_max_xors;
         bool               m_lookahead_simplify;
         bool               m_lookahead_simplify_bca;
         cutoff_t           m_lookahead_cube_cutoff;
@@ -143,6 +153,7 @@ namespace sat {
         double             m_lookahead_cube_psat_trigger;
         reward_t           m_lookahead_reward;
         bool               m_lookahead_double;
+        unsigned           m_lookahead_threads;
         bool               m_lookahead_global_autarky;
         double             m_lookahead_delta_fraction;
         bool               m_lookahead_use_learned;
@@ -162,6 +173,7 @@ namespace sat {
         unsigned           m_gc_k;
         bool               m_gc_burst;
         bool               m_gc_defrag;
+        unsigned           m_gc_defrag_interval;
 
         bool               m_force_cleanup;
 
@@ -178,6 +190,7 @@ namespace sat {
         bool               m_drat;
         bool               m_drat_disable;
         bool               m_drat_binary;
+        bool               m_drat_async;
         symbol             m_drat_file;
         bool               m_smt_proof_check;
         bool               m_drat_check_unsat;
@@ -188,10 +201,15 @@ namespace sat {
         bool               m_xor_solver;
         pb_resolve         m_pb_resolve;
         pb_lemma_format    m_pb_lemma_format;
+        bool               m_pb_sort_watch;
         
         // branching heuristic settings.
         branching_heuristic m_branching_heuristic;
         bool               m_anti_exploration;
+        bool               m_vmtf;
+        unsigned           m_vmtf_conflicts;
+        double             m_vmtf_factor;
+        unsigned           m_vmtf_stable_restart;
         double             m_step_size_init;
         double             m_step_size_dec;
         double             m_step_size_min;
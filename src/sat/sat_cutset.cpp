@@ -81,12 +81,13 @@ namespace sat {
     void cut_set::push_back(on_update_t& on_add, cut const& c) {
         SASSERT(m_max_size > 0);
         if (!m_cuts) {
-            m_cuts = new (*m_region) cut[m_max_size];
+            m_cuts = m_arena->allocate(m_max_size);
         }
         if (m_size == m_max_size) {
+            cut* new_cuts = m_arena->allocate(2 * m_max_size);
+            std::copy(m_cuts, m_cuts + m_size, new_cuts);
+            m_arena->release(m_cuts, m_max_size);
             m_max_size *= 2;
-            cut* new_cuts = new (*m_region) cut[m_max_size];
-            std::uninitialized_copy(m_cuts, m_cuts + m_size, new_cuts);
             m_cuts = new_cuts;
         }
         if (m_var != UINT_MAX && on_add) on_add(m_var, c);
@@ -107,14 +108,13 @@ namespace sat {
         m_cuts[idx] = m_cuts[--m_size]; 
     }
 
-    void cut_set::init(region& r, unsigned max_sz, unsigned v) { 
+    void cut_set::init(cut_arena& a, unsigned max_sz, unsigned v) { 
         m_var = v;
         m_size = 0;
-        SASSERT(!m_region || m_cuts);
-        VERIFY(!m_region || m_max_size > 0);
-        if (!m_region) {
+        VERIFY(!m_arena || m_max_size > 0);
+        if (!m_arena) {
             m_max_size = 2; // max_sz;
-            m_region = &r;
+            m_arena = &a;
             m_cuts = nullptr;
         }
     }
@@ -161,17 +161,43 @@ namespace sat {
         static std::string table2string(unsigned num_input, uint64_t table);
     };
 
+    /**
+       \brief arena for the cut arrays of cut sets.
+       Arrays have power-of-two capacities. The array a cut set outgrows is
+       reused by the next cut set that grows to the same capacity.
+     */
+    class cut_arena {
+        region                  m_region;
+        vector<ptr_vector<cut>> m_free;
+    public:
+        cut* allocate(unsigned capacity) {
+            unsigned i = log2(capacity);
+            if (i < m_free.size() && !m_free[i].empty()) {
+                cut* cuts = m_free[i].back();
+                m_free[i].pop_back();
+                return cuts;
+            }
+            return new (m_region) cut[capacity];
+        }
+
+        void release(cut* cuts, unsigned capacity) {
+            unsigned i = log2(capacity);
+            m_free.reserve(i + 1);
+            m_free[i].push_back(cuts);
+        }
+    };
+
     class cut_set {
         unsigned m_var;
-        region*  m_region;
+        cut_arena* m_arena;
         unsigned m_size;
         unsigned m_max_size;
         cut *    m_cuts;
     public:
         typedef std::function<void(unsigned v, cut const& c)> on_update_t;
 
-        cut_set(): m_var(UINT_MAX), m_region(nullptr), m_size(0), m_max_size(0), m_cuts(nullptr) {}
-        void init(region& r, unsigned max_sz, unsigned v);
+        cut_set(): m_var(UINT_MAX), m_arena(nullptr), m_size(0), m_max_size(0), m_cuts(nullptr) {}
+        void init(cut_arena& a, unsigned max_sz, unsigned v);
         bool insert(on_update_t& on_add, on_update_t& on_del, cut const& c);
         bool no_duplicates() const;
         unsigned var() const { return m_var; }
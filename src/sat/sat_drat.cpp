@@ -20,11 +20,133 @@ Notes:
 
 --*/
 
+#include <condition_variable>
+#include <thread>
 #include "util/rational.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_drat.h"
 
 namespace sat {
+
+    /**
+       \brief stream buffer that moves the I/O of proof steps to a background thread.
+
+       The search thread formats proof steps into a chunk it owns exclusively,
+       so emitting a step is a copy into memory. Full chunks are handed to the writer
+       thread and recycled after they are written. The number of chunks in flight is
+       bounded; the search thread waits only when the writer falls behind by more
+       than that.
+     */
+    class async_streambuf : public std::streambuf {
+        static const size_t   chunk_size = 1 << 20;
+        static const unsigned max_chunks = 16;
+        std::ostream&               m_out;
+        std::mutex                  m_mux;
+        std::condition_variable     m_cv;
+        std::vector<char>           m_chunk;
+        std::vector<std::vector<char>> m_queue;   // chunks to be written
+        std::vector<std::vector<char>> m_free;    // written chunks for reuse
+        unsigned                    m_num_chunks = 1;
+        bool                        m_writing = false;
+        bool                        m_done = false;
+        std::thread                 m_thread;
+
+        void reset_chunk() {
+            m_chunk.resize(chunk_size);
+            setp(m_chunk.data(), m_chunk.data() + m_chunk.size());
+        }
+
+        // hand off the current chunk and obtain a fresh one.
+        void hand_off() {
+            size_t n = pptr() - pbase();
+            if (n == 0)
+                return;
+            m_chunk.resize(n);
+            std::unique_lock<std::mutex> lock(m_mux);
+            m_cv.wait(lock, [&]() { return !m_free.empty() || m_num_chunks < max_chunks; });
+            m_queue.push_back(std::move(m_chunk));
+            if (m_free.empty()) {
+                ++m_num_chunks;
+                m_chunk = std::vector<char>();
+            }
+            else {
+                m_chunk = std::move(m_free.back());
+                m_free.pop_back();
+            }
+            lock.unlock();
+            m_cv.notify_all();
+            reset_chunk();
+        }
+
+        void write_loop() {
+            std::vector<std::vector<char>> chunks;
+            std::unique_lock<std::mutex> lock(m_mux);
+            while (true) {
+                m_cv.wait(lock, [&]() { return m_done || !m_queue.empty(); });
+                if (m_queue.empty())
+                    break;
+                chunks.swap(m_queue);
+                m_writing = true;
+                lock.unlock();
+                for (auto const& c : chunks)
+                    m_out.write(c.data(), c.size());
+                lock.lock();
+                m_writing = false;
+                for (auto& c : chunks)
+                    m_free.push_back(std::move(c));
+                chunks.clear();
+                m_cv.notify_all();
+            }
+            m_out.flush();
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            hand_off();
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(char const* s, std::streamsize n) override {
+            std::streamsize k = n;
+            while (k > 0) {
+                if (pptr() == epptr())
+                    hand_off();
+                std::streamsize m = std::min<std::streamsize>(k, epptr() - pptr());
+                memcpy(pptr(), s, static_cast<size_t>(m));
+                pbump(static_cast<int>(m));
+                s += m;
+                k -= m;
+            }
+            return n;
+        }
+
+        int sync() override {
+            hand_off();
+            std::unique_lock<std::mutex> lock(m_mux);
+            m_cv.wait(lock, [&]() { return m_queue.empty() && !m_writing; });
+            return 0;
+        }
+
+    public:
+        async_streambuf(std::ostream& out): m_out(out) {
+            reset_chunk();
+            m_thread = std::thread([this]() { write_loop(); });
+        }
+
+        ~async_streambuf() override {
+            hand_off();
+            {
+                std::lock_guard<std::mutex> lock(m_mux);
+                m_done = true;
+            }
+            m_cv.notify_all();
+            m_thread.join();
+        }
+    };
     
     drat::drat(solver& s) :
         s(s)
@@ -32,6 +154,11 @@ namespace sat {
         if (s.get_config().m_drat && s.get_config().m_drat_file.is_non_empty_string()) {
             auto mode = s.get_config().m_drat_binary ? (std::ios_base::binary | std::ios_base::out | std::ios_base::trunc) : std::ios_base::out;
             m_out = alloc(std::ofstream, s.get_config().m_drat_file.str(), mode);
+            if (s.get_config().m_drat_async) {
+                m_file = m_out;
+                m_async = alloc(async_streambuf, *m_file);
+                m_out = alloc(std::ostream, m_async);
+            }
             if (s.get_config().m_drat_binary) 
                 std::swap(m_out, m_bout);            
         }
@@ -42,6 +169,8 @@ namespace sat {
         if (m_bout) m_bout->flush();
         dealloc(m_out);
         dealloc(m_bout);
+        dealloc(m_async);
+        dealloc(m_file);
         for (auto & [c, st] : m_proof) 
             m_alloc.del_clause(&c);            
         m_proof.reset();
@@ -52,6 +52,8 @@ namespace sat {
         clause_allocator        m_alloc;
         std::ostream*           m_out = nullptr;
         std::ostream*           m_bout = nullptr;
+        std::streambuf*         m_async = nullptr;  // asynchronous writer behind m_out or m_bout
+        std::ostream*           m_file = nullptr;   // file written by m_async
         svector<std::pair<clause&, status>> m_proof;
         svector<std::pair<literal, clause*>> m_units;
         vector<watch>           m_watches;
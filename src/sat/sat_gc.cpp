@@ -18,6 +18,7 @@ Revision History:
 --*/
 
 
+#include "util/profile.h"
 #include "sat/sat_solver.h"
 
 namespace sat {
@@ -36,6 +37,7 @@ namespace sat {
 
     void solver::do_gc() {
         if (!should_gc()) return;
+        profile::scope _ps("sat.gc");
         TRACE("sat", tout << m_conflicts_since_gc << " " << m_gc_threshold << "\n";);
         unsigned gc = m_stats.m_gc_clause;
         m_conflicts_since_gc = 0;
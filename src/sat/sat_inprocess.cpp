@@ -0,0 +1,158 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.cpp
+
+Abstract:
+
+    Adaptive scheduling of inprocessing techniques.
+
+--*/
+
+#include "sat/sat_inprocess.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    char const* inprocess_scheduler::name(kind k) {
+        switch (k) {
+        case scc_k: return "scc";
+        case simplifier_k: return "simplifier";
+        case simplifier_learned_k: return "simplifier-learned";
+        case probing_k: return "probing";
+        case asymm_branch_k: return "asymm-branch";
+        case vivify_k: return "vivify";
+        case lookahead_k: return "lookahead";
+        case anf_k: return "anf";
+        case gauss_k: return "gauss";
+        case cut_k: return "cut";
+        default: UNREACHABLE(); return "";
+        }
+    }
+
+    void inprocess_scheduler::updt_params(bool enabled, double min_ratio, unsigned max_backoff) {
+        m_enabled = enabled;
+        m_min_ratio = min_ratio;
+        m_max_backoff = std::max(1u, max_backoff);
+    }
+
+    /**
+       \brief size of the clause database as seen by inprocessing.
+       Binary clauses are counted through the watch lists, each fixed or
+       eliminated variable counts as one removed literal.
+     */
+    uint64_t inprocess_scheduler::size() const {
+        uint64_t sz = 0;
+        for (clause* c : s.clauses())
+            sz += c->size();
+        for (clause* c : s.learned())
+            sz += c->size();
+        for (auto const& wl : s.m_watches)
+            for (auto const& w : wl)
+                if (w.is_binary_clause())
+                    ++sz;
+        unsigned num_vars = s.num_vars();
+        for (bool_var v = 0; v < num_vars; ++v)
+            if (!s.was_eliminated(v) && (s.value(v) == l_undef || s.lvl(v) > 0))
+                ++sz;
+        return sz;
+    }
+
+    void inprocess_scheduler::stop(kind k, uint64_t size_before, stopwatch& sw) {
+        technique& t = m_techniques[k];
+        uint64_t size_after = size();
+        uint64_t removed = size_before > size_after ? size_before - size_after : 0;
+        double time = sw.get_seconds();
+        ++t.m_calls;
+        t.m_removed += removed;
+        t.m_time += time;
+        t.m_payoff = removed / (time + 0.001);
+        t.m_ran = true;
+    }
+
+    void inprocess_scheduler::end_round() {
+        if (!m_enabled)
+            return;
+        double total = 0;
+        unsigned n = 0;
+        for (technique const& t : m_techniques) {
+            if (t.m_ran) {
+                total += t.m_payoff;
+                ++n;
+            }
+        }
+        if (n == 0)
+            return;
+        double avg = total / n;
+        for (unsigned k = 0; k < num_kinds; ++k) {
+            technique& t = m_techniques[k];
+            if (!t.m_ran)
+                continue;
+            t.m_ran = false;
+            if (t.m_payoff > 0 && t.m_payoff >= m_min_ratio * avg) {
+                t.m_backoff = 1;
+                t.m_delay = 0;
+            }
+            else {
+                t.m_delay = t.m_backoff;
+                t.m_backoff = std::min(2 * t.m_backoff, m_max_backoff);
+                IF_VERBOSE(2, verbose_stream() << "(sat.inprocess :throttle " << name(static_cast<kind>(k)) << " :rounds " << t.m_delay << ")\n";);
+            }
+        }
+    }
+
+    // statistics keep the key pointers, so the keys are static.
+    static char const* const s_stat_keys[inprocess_scheduler::num_kinds][4] = {
+        { "sat inprocess scc calls", "sat inprocess scc skips", "sat inprocess scc removed", "sat inprocess scc time" },
+        { "sat inprocess simplifier calls", "sat inprocess simplifier skips", "sat inprocess simplifier removed", "sat inprocess simplifier time" },
+        { "sat inprocess simplifier-learned calls", "sat inprocess simplifier-learned skips", "sat inprocess simplifier-learned removed", "sat inprocess simplifier-learned time" },
+        { "sat inprocess probing calls", "sat inprocess probing skips", "sat inprocess probing removed", "sat inprocess probing time" },
+        { "sat inprocess asymm-branch calls", "sat inprocess asymm-branch skips", "sat inprocess asymm-branch removed", "sat inprocess asymm-branch time" },
+        { "sat inprocess vivify calls", "sat inprocess vivify skips", "sat inprocess vivify removed", "sat inprocess vivify time" },
+        { "sat inprocess lookahead calls", "sat inprocess lookahead skips", "sat inprocess lookahead removed", "sat inprocess lookahead time" },
+        { "sat inprocess anf calls", "sat inprocess anf skips", "sat inprocess anf removed", "sat inprocess anf time" },
+        { "sat inprocess gauss calls", "sat inprocess gauss skips", "sat inprocess gauss removed", "sat inprocess gauss time" },
+        { "sat inprocess cut calls", "sat inprocess cut skips", "sat inprocess cut removed", "sat inprocess cut time" }
+    };
+
+    void inprocess_scheduler::collect_statistics(statistics& st) const {
+        if (!m_enabled)
+            return;
+        for (unsigned k = 0; k < num_kinds; ++k) {
+            technique const& t = m_techniques[k];
+            if (t.m_calls == 0 && t.m_skips == 0)
+                continue;
+            char const* const* keys = s_stat_keys[k];
+            st.update(keys[0], t.m_calls);
+            st.update(keys[1], t.m_skips);
+            st.update(keys[2], static_cast<double>(t.m_removed));
+            st.update(keys[3], t.m_time);
+        }
+    }
+
+    void inprocess_scheduler::reset_statistics() {
+        for (technique& t : m_techniques) {
+            t.m_calls = 0;
+            t.m_skips = 0;
+            t.m_removed = 0;
+            t.m_time = 0;
+        }
+    }
+
+    std::ostream& inprocess_scheduler::display(std::ostream& out) const {
+        for (unsigned k = 0; k < num_kinds; ++k) {
+            technique const& t = m_techniques[k];
+            if (t.m_calls == 0 && t.m_skips == 0)
+                continue;
+            out << "(sat.inprocess " << name(static_cast<kind>(k))
+                << " :calls " << t.m_calls
+                << " :skips " << t.m_skips
+                << " :removed " << t.m_removed
+                << " :time " << t.m_time
+                << " :removed/sec " << (t.m_removed / (t.m_time + 0.001)) << ")\n";
+        }
+        return out;
+    }
+};
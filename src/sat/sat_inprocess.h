@@ -0,0 +1,109 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.h
+
+Abstract:
+
+    Adaptive scheduling of inprocessing techniques.
+
+    Each technique is measured by the reduction of the clause database
+    (literals in clauses, fixed and eliminated variables) per second it
+    spends. Techniques whose payoff falls behind the payoff of the other
+    techniques in the same simplification round are skipped for an
+    exponentially growing number of rounds. A technique returns to
+    every round as soon as it pays off again.
+
+--*/
+#pragma once
+
+#include "sat/sat_types.h"
+#include "util/statistics.h"
+#include "util/stopwatch.h"
+
+namespace sat {
+
+    class solver;
+
+    class inprocess_scheduler {
+    public:
+        enum kind {
+            scc_k,
+            simplifier_k,
+            simplifier_learned_k,
+            probing_k,
+            asymm_branch_k,
+            vivify_k,
+            lookahead_k,
+            anf_k,
+            gauss_k,
+            cut_k,
+            num_kinds
+        };
+
+    private:
+        struct technique {
+            unsigned m_calls   { 0 };
+            unsigned m_skips   { 0 };
+            uint64_t m_removed { 0 };
+            double   m_time    { 0 };
+            double   m_payoff  { 0 };   // payoff of the last call
+            unsigned m_backoff { 1 };
+            unsigned m_delay   { 0 };   // number of rounds to skip
+            bool     m_ran     { false };
+        };
+
+        solver&   s;
+        bool      m_enabled { false };
+        double    m_min_ratio { 0.05 };
+        unsigned  m_max_backoff { 16 };
+        technique m_techniques[num_kinds];
+
+        uint64_t size() const;
+        void stop(kind k, uint64_t size_before, stopwatch& sw);
+
+    public:
+        inprocess_scheduler(solver& s): s(s) {}
+
+        void updt_params(bool enabled, double min_ratio, unsigned max_backoff);
+
+        /**
+           \brief run the technique f unless it is currently throttled.
+         */
+        template<typename F>
+        void operator()(kind k, F f) {
+            if (!m_enabled) {
+                f();
+                return;
+            }
+            technique& t = m_techniques[k];
+            if (t.m_delay > 0) {
+                --t.m_delay;
+                ++t.m_skips;
+                return;
+            }
+            uint64_t sz = size();
+            stopwatch sw;
+            sw.start();
+            f();
+            sw.stop();
+            stop(k, sz, sw);
+        }
+
+        /**
+           \brief compare the payoff of the techniques that ran in the current round
+           and throttle the ones that fall behind.
+         */
+        void end_round();
+
+        void collect_statistics(statistics& st) const;
+
+        void reset_statistics();
+
+        std::ostream& display(std::ostream& out) const;
+
+        static char const* name(kind k);
+    };
+};
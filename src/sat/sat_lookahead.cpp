@@ -21,6 +21,8 @@ Notes:
 --*/
 
 #include <cmath>
+#include <mutex>
+#include <thread>
 #include "sat/sat_solver.h"
 #include "sat/sat_lookahead.h"
 #include "sat/sat_scc.h"
@@ -1072,19 +1074,27 @@ namespace sat {
 
     void lookahead::push(literal lit, unsigned level) { 
         SASSERT(m_search_mode == lookahead_mode::searching);
-        m_binary_trail_lim.push_back(m_binary_trail.size());
-        m_trail_lim.push_back(m_trail.size());
-        m_num_tc1_lim.push_back(m_num_tc1);
-        m_qhead_lim.push_back(m_qhead);
+        push_scope();
         scoped_level _sl(*this, level);
         m_assumptions.push_back(~lit);
         assign(lit);
         propagate();
     }
 
+    void lookahead::push_scope() {
+        m_binary_trail_lim.push_back(m_binary_trail.size());
+        m_trail_lim.push_back(m_trail.size());
+        m_num_tc1_lim.push_back(m_num_tc1);
+        m_qhead_lim.push_back(m_qhead);
+    }
+
     void lookahead::pop() { 
         SASSERT(!m_assumptions.empty());
         m_assumptions.pop_back();
+        pop_scope();
+    }
+
+    void lookahead::pop_scope() {
         m_inconsistent = false;
         SASSERT(m_search_mode == lookahead_mode::searching);
 
@@ -1747,6 +1757,10 @@ namespace sat {
 
     void lookahead::compute_lookahead_reward() {
         TRACE("sat", display_lookahead(tout); );
+        if (use_parallel_lookahead()) {
+            compute_lookahead_reward_parallel();
+            return;
+        }
         m_delta_decrease = pow(m_config.m_delta_rho, 1.0 / (double)m_lookahead.size());
         unsigned base = 2;
         bool change = true;
@@ -1824,6 +1838,133 @@ namespace sat {
         TRACE("sat", display_lookahead(tout); );
     }
 
+    bool lookahead::use_parallel_lookahead() const {
+        // extensions and proof logging share state with the main solver.
+        return get_config().m_lookahead_threads > 1 && !m_s.m_ext && !m_s.m_config.m_drat && m_lookahead.size() > 1;
+    }
+
+    /**
+       \brief score the lookahead candidates on copies of the lookahead state.
+
+       Worker i evaluates candidates i, i + n, i + 2n, ... with single lookahead.
+       The rewards are transferred to the main state and failed literals are
+       assigned to false. The scores match the sequential version up to learned
+       binary clauses, which are local to each copy, and double lookahead,
+       which is not used.
+    */
+    void lookahead::compute_lookahead_reward_parallel() {
+        unsigned num_workers = std::min(get_config().m_lookahead_threads, m_lookahead.size());
+        while (m_workers.size() < num_workers) {
+            lookahead* w = alloc(lookahead, m_s);
+            w->init_search();
+            m_workers.push_back(w);
+        }
+        bool change = true;
+        while (change && !inconsistent()) {
+            change = false;
+            checkpoint();
+            std::mutex mux;
+            std::string ex_msg;
+            auto worker = [&](unsigned id) {
+                try {
+                    m_workers[id]->sync_units(*this);
+                    m_workers[id]->score_candidates(*this, id, num_workers);
+                }
+                catch (z3_exception& ex) {
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (ex_msg.empty())
+                        ex_msg = ex.what();
+                }
+            };
+#ifdef SINGLE_THREAD
+            for (unsigned id = 0; id < num_workers; ++id)
+                worker(id);
+#else
+            vector<std::thread> threads;
+            for (unsigned id = 1; id < num_workers; ++id)
+                threads.push_back(std::thread(worker, id));
+            worker(0);
+            for (auto& th : threads)
+                th.join();
+#endif
+            if (!ex_msg.empty()) {
+                m_workers.reset();
+                throw solver_exception(ex_msg.c_str());
+            }
+            // candidates are scored from the units, so there is no reward to inherit from parents.
+            for (auto const& lo : m_lookahead)
+                set_lookahead_reward(lo.m_lit, 0);
+            for (unsigned id = 0; id < num_workers && !inconsistent(); ++id) {
+                lookahead& w = *m_workers[id];
+                if (w.inconsistent()) {
+                    // the units of the main state are inconsistent with the clauses.
+                    set_conflict();
+                    break;
+                }
+                for (auto const& r : w.m_results) {
+                    if (!r.m_failed) {
+                        set_lookahead_reward(r.m_lit, r.m_reward);
+                        continue;
+                    }
+                    if (!is_undef(r.m_lit))
+                        continue;
+                    TRACE("sat", tout << "backtracking and setting " << ~r.m_lit << "\n";);
+                    lookahead_backtrack();
+                    assign(~r.m_lit);
+                    propagate();
+                    change = true;
+                    if (inconsistent())
+                        break;
+                }
+            }
+        }
+        lookahead_backtrack();
+    }
+
+    /**
+       \brief assign the units of the main lookahead state p in a fresh scope.
+    */
+    void lookahead::sync_units(lookahead const& p) {
+        scoped_level _sl(*this, c_fixed_truth);
+        m_search_mode = lookahead_mode::searching;
+        lookahead_backtrack();
+        if (!m_trail_lim.empty())
+            pop_scope();
+        push_scope();
+        for (literal l : p.m_trail) 
+            if (p.is_true_at(l, c_fixed_truth) && !inconsistent())
+                assign(l);
+        propagate();
+    }
+
+    void lookahead::score_candidates(lookahead const& p, unsigned id, unsigned num_workers) {
+        m_results.reset();
+        if (inconsistent())
+            return;
+        scoped_level _sl(*this, c_fixed_truth);
+        if (m_config.m_reward_type == ternary_reward) {
+            m_heur_copy = *p.m_heur;
+            m_heur = &m_heur_copy;
+        }
+        // clear stamps from previous rounds, the levels restart at 2.
+        for (bool_var x : m_freevars) 
+            set_undef(literal(x, false));
+        unsigned level = 2;
+        for (unsigned i = id; i < p.m_lookahead.size(); i += num_workers) {
+            literal lit = p.m_lookahead[i].m_lit;
+            if (!is_undef(lit))
+                continue;
+            checkpoint();
+            m_lookahead_reward = 0;
+            unsigned num_units = push_lookahead1(lit, level);
+            bool failed = inconsistent();
+            pop_lookahead1(lit, num_units);
+            m_results.push_back({ lit, m_lookahead_reward, failed });
+            level += 2;
+        }
+        lookahead_backtrack();
+    }
+
     literal lookahead::select_literal() {
         literal l = null_literal;
         double h = 0;
@@ -21,6 +21,7 @@ Notes:
 
 
 #include "util/small_object_allocator.h"
+#include "util/scoped_ptr_vector.h"
 #include "sat/sat_elim_eqs.h"
 
 namespace pb {
@@ -238,6 +239,25 @@ namespace sat {
         const unsigned         c_fixed_truth = UINT_MAX - 1;
         vector<watch_list>     m_watches;       // literal: watch structure
         svector<lit_info>      m_lits;          // literal: attributes.
+
+        // ------------------------------------
+        // parallel lookahead
+        // workers hold a copy of the clauses and replay the units of the main lookahead
+        // state before scoring a share of its lookahead candidates.
+
+        struct lookahead_result {
+            literal m_lit;
+            double  m_reward;
+            bool    m_failed;
+        };
+        scoped_ptr_vector<lookahead> m_workers;
+        svector<lookahead_result>    m_results;  // worker: scores of the last round
+        svector<double>              m_heur_copy; // worker: fitness copied from the main state
+
+        bool use_parallel_lookahead() const;
+        void compute_lookahead_reward_parallel();
+        void sync_units(lookahead const& p);
+        void score_candidates(lookahead const& p, unsigned id, unsigned num_workers);
         double                 m_lookahead_reward; // metric associated with current lookahead1 literal.
         literal_vector         m_wstack;        // windofall stack that is populated in lookahead1 mode
         unsigned               m_last_prefix_length;
@@ -503,6 +523,8 @@ namespace sat {
         
         void push(literal lit, unsigned level);
         void pop();
+        void push_scope();
+        void pop_scope();
         bool push_lookahead2(literal lit, unsigned level);
         unsigned push_lookahead1(literal lit, unsigned level);
         void pop_lookahead1(literal lit, unsigned num_units);
@@ -580,6 +602,7 @@ namespace sat {
         }
 
         ~lookahead() {
+            m_workers.reset();
             m_s.rlimit().pop_child();
             for (nary* n : m_nary_clauses) { 
                 m_allocator.deallocate(n->obj_size(), n);
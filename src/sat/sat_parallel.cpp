@@ -22,69 +22,184 @@ Revision History:
 
 namespace sat {
 
-    void parallel::vector_pool::next(unsigned& index) {
-        SASSERT(index < m_size);
-        unsigned n = index + 2 + get_length(index);
-        index = (n >= m_size) ? 0 : n;
+    parallel::clause_ring::~clause_ring() {
+        if (m_data)
+            dealloc_vect(m_data, m_capacity);
     }
 
-    void parallel::vector_pool::reserve(unsigned num_threads, unsigned sz) {
-        m_vectors.reset();
-        m_vectors.resize(sz, 0);
-        m_heads.reset();
-        m_heads.resize(num_threads, 0);
-        m_at_end.reset();
-        m_at_end.resize(num_threads, true);
+    void parallel::clause_ring::reserve(unsigned sz) {
+        if (m_data)
+            dealloc_vect(m_data, m_capacity);
+        m_capacity = 2;
+        while (m_capacity < sz)
+            m_capacity *= 2;
+        m_data = alloc_vect<std::atomic<unsigned>>(m_capacity);
         m_tail = 0;
-        m_size = sz;
+        m_reserved = 0;
     }
-    
-    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
-        SASSERT(m_tail < m_size);
-        unsigned capacity = n + 2;
-        m_vectors.reserve(m_size + capacity, 0);
-        IF_VERBOSE(3, verbose_stream() << owner << ": begin-add " << n << " tail: " << m_tail << " size: " << m_size << "\n";);
-        for (unsigned i = 0; i < m_heads.size(); ++i) {
-            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
-                next(m_heads[i]);
-            }
-            m_at_end[i] = false;
+
+    // only the owner of the ring adds entries.
+    void parallel::clause_ring::add(unsigned n, literal const* lits) {
+        if (n + 1 > m_capacity)
+            return;
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        // announce the range that is about to be overwritten before writing it.
+        m_reserved.store(tail + n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        set(tail, n);
+        for (unsigned i = 0; i < n; ++i)
+            set(tail + 1 + i, lits[i].index());
+        m_tail.store(tail + n + 1, std::memory_order_release);
+    }
+
+    bool parallel::clause_ring::get(uint64_t& head, literal_vector& lits) const {
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        if (head >= tail)
+            return false;
+        if (tail - head > m_capacity) {
+            // entries were overwritten before they were consumed.
+            head = tail;
+            return false;
+        }
+        unsigned n = get(head);
+        bool valid = n + 1 <= tail - head;
+        lits.reset();
+        for (unsigned i = 0; valid && i < n; ++i)
+            lits.push_back(to_literal(get(head + 1 + i)));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!valid || m_reserved.load(std::memory_order_relaxed) - head > m_capacity) {
+            // the producer wrapped around while the entry was copied.
+            head = m_tail.load(std::memory_order_acquire);
+            return false;
         }
-        m_vectors[m_tail++] = owner;
-        m_vectors[m_tail++] = n;    
+        head += n + 1;
+        return true;
     }
 
-    void parallel::vector_pool::add_vector_elem(unsigned e) {
-        m_vectors[m_tail++] = e;
+    void parallel::cube_pool::reset(unsigned num_workers) {
+        m_queues.reset();
+        m_queues.resize(num_workers);
+        m_heads.reset();
+        m_heads.resize(num_workers, 0);
+        m_core.reset();
+        m_num_active = 0;
+        m_num_cubes = 0;
+        m_num_steals = 0;
+        m_done = false;
+        m_canceled = false;
+        m_canceler = UINT_MAX;
+    }
+
+    void parallel::cube_pool::add_cube(unsigned owner, literal_vector const& cube) {
+        std::lock_guard<std::mutex> lock(m_mux);
+        m_queues[owner].push_back(cube);
+        ++m_num_cubes;
+        m_cond.notify_one();
     }
 
-    void parallel::vector_pool::end_add_vector() {
-        if (m_tail >= m_size) 
-            m_tail = 0;
+    bool parallel::cube_pool::pop(unsigned owner, literal_vector& cube) {
+        if (is_empty(owner))
+            return false;
+        auto& q = m_queues[owner];
+        cube.reset();
+        cube.append(q.back());
+        q.pop_back();
+        if (m_heads[owner] == q.size()) {
+            q.reset();
+            m_heads[owner] = 0;
+        }
+        return true;
     }
 
+    bool parallel::cube_pool::steal(unsigned owner, literal_vector& cube) {
+        unsigned victim = UINT_MAX, max_size = 0;
+        for (unsigned i = 0; i < m_queues.size(); ++i) {
+            unsigned sz = m_queues[i].size() - m_heads[i];
+            if (i != owner && sz > max_size) {
+                max_size = sz;
+                victim = i;
+            }
+        }
+        if (victim == UINT_MAX)
+            return false;
+        // the oldest cubes are the shortest ones and represent the largest amount of work.
+        auto& q = m_queues[victim];
+        unsigned& head = m_heads[victim];
+        cube.reset();
+        cube.append(q[head]);
+        q[head++].reset();
+        if (head == q.size()) {
+            q.reset();
+            head = 0;
+        }
+        ++m_num_steals;
+        return true;
+    }
 
-    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
-        unsigned head = m_heads[owner];      
-        unsigned iterations = 0;
-        while (head != m_tail || !m_at_end[owner]) {
-            ++iterations;
-            SASSERT(head < m_size && m_tail < m_size);            
-            bool is_self = owner == get_owner(head);
-            next(m_heads[owner]);
-            IF_VERBOSE(static_cast<unsigned>(iterations > m_size ? 0 : 3), verbose_stream() << owner << ": [" << head << ":" << m_heads[owner] << "] tail: " << m_tail << "\n";);
-            m_at_end[owner] = (m_heads[owner] == m_tail);
-            if (!is_self) {
-                n = get_length(head);
-                ptr = get_ptr(head);
+    bool parallel::cube_pool::get_cube(unsigned owner, literal_vector& cube) {
+        std::unique_lock<std::mutex> lock(m_mux);
+        while (!m_done) {
+            if (pop(owner, cube) || steal(owner, cube)) {
+                ++m_num_active;
                 return true;
             }
-            head = m_heads[owner];
+            if (m_num_active == 0) {
+                // every cube was refuted.
+                m_done = true;
+                m_cond.notify_all();
+                break;
+            }
+            m_cond.wait(lock);
         }
         return false;
     }
 
-    parallel::parallel(solver& s): m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
+    void parallel::cube_pool::cube_refuted(literal_vector const& core) {
+        std::lock_guard<std::mutex> lock(m_mux);
+        for (literal lit : core)
+            if (!m_core.contains(lit))
+                m_core.push_back(lit);
+    }
+
+    void parallel::cube_pool::cube_done() {
+        std::lock_guard<std::mutex> lock(m_mux);
+        SASSERT(m_num_active > 0);
+        --m_num_active;
+        // wake up idle workers so they can detect that the pool is exhausted.
+        if (m_num_active == 0)
+            m_cond.notify_all();
+    }
+
+    void parallel::cube_pool::cancel(unsigned owner) {
+        std::lock_guard<std::mutex> lock(m_mux);
+        if (!m_done) {
+            m_done = true;
+            m_canceled = true;
+            m_canceler = owner;
+        }
+        m_cond.notify_all();
+    }
+
+    parallel::parallel(solver& s): 
+        m_share_max_size(s.get_config().m_par_share_max_size),
+        m_share_max_glue(s.get_config().m_par_share_max_glue),
+        m_num_clauses(0), 
+        m_consumer_ready(false), 
+        m_scoped_rlimit(s.rlimit()) {}
+
+    void parallel::reserve(unsigned num_owners, unsigned sz) {
+        m_rings.reset();
+        m_heads.reset();
+        m_lits.reset();
+        for (unsigned i = 0; i < num_owners; ++i) {
+            m_rings.push_back(alloc(clause_ring));
+            m_rings.back()->reserve(sz);
+        }
+        m_heads.resize(num_owners);
+        for (auto& h : m_heads)
+            h.resize(num_owners, 0);
+        m_lits.resize(num_owners);
+    }
 
     parallel::~parallel() {
         reset();
@@ -143,61 +258,52 @@ namespace sat {
     }
 
     void parallel::share_clause(solver& s, literal l1, literal l2) {        
-        if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
-        flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  l1 << " " << l2 << "\n";);
-        {
-            lock_guard lock(m_mux);
-            m_pool.begin_add_vector(s.m_par_id, 2);
-            m_pool.add_vector_elem(l1.index());
-            m_pool.add_vector_elem(l2.index());            
-            m_pool.end_add_vector();
-        }        
+        literal lits[2] = { l1, l2 };
+        share_clause(s, 2, lits);
     }
 
     void parallel::share_clause(solver& s, clause const& c) {        
-        if (s.get_config().m_num_threads == 1 || !enable_add(c) || s.m_par_syncing_clauses) return;
+        if (!enable_add(c)) return;
+        share_clause(s, c.size(), c.begin());
+    }
+
+    void parallel::share_clause(solver& s, unsigned n, literal const* lits) {
+        if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        unsigned n = c.size();
-        unsigned owner = s.m_par_id;
-        IF_VERBOSE(3, verbose_stream() << owner << ": share " <<  c << "\n";);
-        lock_guard lock(m_mux);
-        m_pool.begin_add_vector(owner, n);                
-        for (unsigned i = 0; i < n; ++i) 
-            m_pool.add_vector_elem(c[i].index());
-        m_pool.end_add_vector();        
+        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " << literal_vector(n, lits) << "\n";);
+        m_rings[s.m_par_id]->add(n, lits);
     }
 
     void parallel::get_clauses(solver& s) {
         if (s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        lock_guard lock(m_mux);
         _get_clauses(s);        
     }
 
     void parallel::_get_clauses(solver& s) {
-        unsigned n;
-        unsigned const* ptr;
         unsigned owner = s.m_par_id;
-        while (m_pool.get_vector(owner, n, ptr)) {
-            m_lits.reset();
-            bool usable_clause = true;
-            for (unsigned i = 0; usable_clause && i < n; ++i) {
-                literal lit(to_literal(ptr[i]));                
-                m_lits.push_back(lit);
-                usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
-            }
-            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << m_lits << "\n";);
-            SASSERT(n >= 2);
-            if (usable_clause) {
-                s.mk_clause_core(m_lits.size(), m_lits.data(), sat::status::redundant());
+        literal_vector& lits = m_lits[owner];
+        for (unsigned producer = 0; producer < m_rings.size(); ++producer) {
+            if (producer == owner)
+                continue;
+            while (m_rings[producer]->get(m_heads[owner][producer], lits)) {
+                bool usable_clause = true;
+                for (unsigned i = 0; usable_clause && i < lits.size(); ++i) {
+                    literal lit = lits[i];
+                    usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
+                }
+                IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << lits << "\n";);
+                SASSERT(lits.size() >= 2);
+                if (usable_clause) {
+                    s.mk_clause_core(lits.size(), lits.data(), sat::status::redundant());
+                }
             }
-        }        
+        }
     }
 
     bool parallel::enable_add(clause const& c) const {
         // plingeling, glucose heuristic:
-        return (c.size() <= 40 && c.glue() <= 8) || c.glue() <= 2;
+        return (c.size() <= m_share_max_size && c.glue() <= m_share_max_glue) || c.glue() <= 2;
     }
 
     void parallel::_from_solver(solver& s) {
@@ -276,5 +382,130 @@ namespace sat {
         return copied;
     }
     
-};
+    void parallel::init_cubes(solver& s, unsigned num_workers) {
+        m_cubes.reset(num_workers);
+        unsigned depth = s.get_config().m_cube_and_conquer_depth;
+        if (depth == 0) {
+            // aim for a few cubes per worker.
+            depth = 2;
+            while ((1u << depth) < 4 * num_workers && depth < 16)
+                ++depth;
+        }
+        solver cuber(s.m_params, s.rlimit());
+        cuber.copy(s, true);
+        cuber.m_config.m_lookahead_cube_cutoff = depth_cutoff;
+        cuber.m_config.m_lookahead_cube_depth = depth;
+        vector<literal_vector> cubes;
+        bool_var_vector vars;
+        literal_vector cube;
+        while (true) {
+            vars.reset();
+            lbool r = cuber.cube(vars, cube, UINT_MAX);
+            if (r == l_false && !cubes.empty())
+                // every branch was either emitted as a cube or refuted by lookahead.
+                break;
+            if (r != l_undef || cube.empty()) {
+                // the formula was decided by lookahead or could not be split.
+                // Let the workers discover the result starting from the empty cube.
+                cubes.reset();
+                cubes.push_back(literal_vector());
+                break;
+            }
+            cubes.push_back(cube);
+        }
+        // distribute cubes round-robin; the last cube of each queue is solved first.
+        for (unsigned i = 0; i < cubes.size(); ++i)
+            m_cubes.add_cube(i % num_workers, cubes[i]);
+        IF_VERBOSE(1, verbose_stream() << "(sat.cube-and-conquer :depth " << depth << " :cubes " << cubes.size() << ")\n";);
+    }
 
+    bool_var parallel::select_split_var(solver& s, literal_vector const& cube) {
+        bool_vector in_cube(s.m_par_num_vars, false);
+        for (literal lit : cube)
+            if (lit.var() < s.m_par_num_vars)
+                in_cube[lit.var()] = true;
+        bool_var best = null_bool_var;
+        for (bool_var v = 0; v < s.m_par_num_vars; ++v) {
+            if (in_cube[v] || s.was_eliminated(v))
+                continue;
+            if (s.value(v) != l_undef && s.lvl(v) == 0)
+                continue;
+            if (best == null_bool_var || s.m_activity[v] > s.m_activity[best])
+                best = v;
+        }
+        return best;
+    }
+
+    lbool parallel::conquer(solver& s, unsigned num_lits, literal const* lits) {
+        unsigned owner = s.m_par_id;
+        literal_vector cube, asms, core;
+        unsigned max_conflicts = s.m_config.m_max_conflicts;
+        flet<unsigned> _max_conflicts(s.m_config.m_max_conflicts, max_conflicts);
+        unsigned budget = std::min(max_conflicts, std::max(1u, s.get_config().m_cube_and_conquer_conflicts));
+        auto is_cube_lit = [&](literal l) {
+            return cube.contains(l) && std::find(lits, lits + num_lits, l) == lits + num_lits;
+        };
+        while (m_cubes.get_cube(owner, cube)) {
+            asms.reset();
+            asms.append(num_lits, lits);
+            asms.append(cube);
+            s.m_config.m_max_conflicts = budget;
+            bool_var v = null_bool_var;
+            lbool r;
+            while (true) {
+                r = s.check(asms.size(), asms.data());
+                if (r != l_undef || !s.rlimit().inc() || s.m_reason_unknown != "sat.max.conflicts")
+                    break;
+                if (s.m_config.m_max_conflicts == max_conflicts)
+                    break;
+                v = select_split_var(s, cube);
+                if (v != null_bool_var)
+                    break;
+                // nothing left to split on, solve the cube without a budget.
+                s.m_config.m_max_conflicts = max_conflicts;
+            }
+            IF_VERBOSE(2, verbose_stream() << "(sat.cube-and-conquer :worker " << owner << " :cube " << cube.size() << " " << r << ")\n";);
+            if (r == l_true) {
+                m_cubes.cancel(owner);
+                return l_true;
+            }
+            if (r == l_false) {
+                if (!any_of(s.get_core(), is_cube_lit)) {
+                    // the refutation does not depend on the cube.
+                    m_cubes.cancel(owner);
+                    return l_false;
+                }
+                core.reset();
+                for (literal lit : s.get_core())
+                    if (!is_cube_lit(lit))
+                        core.push_back(lit);
+                m_cubes.cube_refuted(core);
+            }
+            else if (v == null_bool_var) {
+                m_cubes.cube_done();
+                m_cubes.cancel(owner);
+                return l_undef;
+            }
+            else {
+                // the preferred phase is pushed last so that its cube is solved next.
+                literal lit(v, !s.m_phase[v]);
+                cube.push_back(~lit);
+                m_cubes.add_cube(owner, cube);
+                cube.back() = lit;
+                m_cubes.add_cube(owner, cube);
+            }
+            m_cubes.cube_done();
+        }
+        if (!m_cubes.is_refuted())
+            return l_undef;
+        s.m_core.reset();
+        s.m_core.append(m_cubes.core());
+        return l_false;
+    }
+
+    void parallel::collect_cube_statistics(statistics& st) const {
+        st.update("sat cubes", m_cubes.num_cubes());
+        st.update("sat cube steals", m_cubes.num_steals());
+    }
+
+};
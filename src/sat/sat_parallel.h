@@ -24,31 +24,70 @@ Revision History:
 #include "util/rlimit.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/mutex.h"
+#include "util/statistics.h"
+#include <atomic>
+#include <condition_variable>
 
 namespace sat {
 
     class parallel {
 
-        // shared pool of learned clauses.
-        class vector_pool {
-            unsigned_vector m_vectors;
-            unsigned        m_size{ 0 };
-            unsigned        m_tail{ 0 };
-            unsigned_vector m_heads;
-            bool_vector   m_at_end;
-            void next(unsigned& index);
-            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
-            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
-            unsigned const* get_ptr(unsigned index) const { return m_vectors.data() + index + 2; }
+        // lock-free exchange of learned clauses.
+        // Every producer owns a ring buffer that only it writes to. Consumers keep
+        // a read position per producer and validate, in the style of a sequence lock,
+        // that the entries they copied were not overwritten while reading.
+        // Entries are reclaimed implicitly when the producer wraps around; consumers
+        // that fall behind by more than the capacity skip to the current tail.
+        class clause_ring {
+            std::atomic<unsigned>* m_data { nullptr };
+            unsigned               m_capacity { 0 };
+            std::atomic<uint64_t>  m_tail { 0 };      // end of published entries
+            std::atomic<uint64_t>  m_reserved { 0 };  // end of entries being written
+            unsigned get(uint64_t i) const { return m_data[i & (m_capacity - 1)].load(std::memory_order_relaxed); }
+            void set(uint64_t i, unsigned e) { m_data[i & (m_capacity - 1)].store(e, std::memory_order_relaxed); }
         public:
-            void reserve(unsigned num_owners, unsigned sz);
-            void begin_add_vector(unsigned owner, unsigned n);
-            void end_add_vector();
-            void add_vector_elem(unsigned e);
-            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+            ~clause_ring();
+            void reserve(unsigned sz);
+            void add(unsigned n, literal const* lits);
+            bool get(uint64_t& head, literal_vector& lits) const;
+        };
+
+        // work-stealing pool of open cubes used in cube-and-conquer mode.
+        // Each worker owns a queue. It pushes and pops cubes at the back of its own
+        // queue and steals from the front of the longest queue of another worker
+        // when its own queue is empty.
+        class cube_pool {
+            std::mutex                 m_mux;
+            std::condition_variable    m_cond;
+            vector<vector<literal_vector>> m_queues;
+            unsigned_vector            m_heads;
+            unsigned                   m_num_active{ 0 };
+            unsigned                   m_num_cubes{ 0 };
+            unsigned                   m_num_steals{ 0 };
+            bool                       m_done{ false };
+            bool                       m_canceled{ false };
+            unsigned                   m_canceler{ UINT_MAX };
+            literal_vector             m_core;
+            bool is_empty(unsigned owner) const { return m_heads[owner] == m_queues[owner].size(); }
+            bool pop(unsigned owner, literal_vector& cube);
+            bool steal(unsigned owner, literal_vector& cube);
+        public:
+            void reset(unsigned num_workers);
+            void add_cube(unsigned owner, literal_vector const& cube);
+            bool get_cube(unsigned owner, literal_vector& cube);
+            void cube_refuted(literal_vector const& core);
+            void cube_done();
+            void cancel(unsigned owner);
+            unsigned canceler() const { return m_canceler; }
+            bool is_refuted() const { return m_done && !m_canceled; }
+            literal_vector const& core() const { return m_core; }
+            unsigned num_cubes() const { return m_num_cubes; }
+            unsigned num_steals() const { return m_num_steals; }
         };
 
         bool enable_add(clause const& c) const;
+        void share_clause(solver& s, unsigned n, literal const* lits);
+        bool_var select_split_var(solver& s, literal_vector const& cube);
         void _get_clauses(solver& s);
         void _from_solver(solver& s);
         void _to_solver(solver& s);
@@ -58,10 +97,15 @@ namespace sat {
         typedef hashtable<unsigned, u_hash, u_eq> index_set;
         literal_vector m_units;
         index_set      m_unit_set;
-        literal_vector m_lits;
-        vector_pool    m_pool;
         mutex          m_mux;
 
+        // for clause exchange:
+        unsigned                       m_share_max_size;
+        unsigned                       m_share_max_glue;
+        scoped_ptr_vector<clause_ring> m_rings;
+        vector<svector<uint64_t>>      m_heads;  // m_heads[consumer][producer]
+        vector<literal_vector>         m_lits;   // m_lits[consumer]
+
         // for exchange with local search:
         unsigned           m_num_clauses;
         scoped_ptr<solver> m_solver_copy;
@@ -71,6 +115,9 @@ namespace sat {
         scoped_limits      m_scoped_rlimit;
         vector<reslimit>   m_limits;
         ptr_vector<solver> m_solvers;
+
+        // for cube-and-conquer:
+        cube_pool          m_cubes;
         
     public:
 
@@ -85,7 +132,7 @@ namespace sat {
         void push_child(reslimit& rl);
 
         // reserve space
-        void reserve(unsigned num_owners, unsigned sz) { m_pool.reserve(num_owners, sz); }
+        void reserve(unsigned num_owners, unsigned sz);
 
         solver& get_solver(unsigned i) { return *m_solvers[i]; }
 
@@ -110,6 +157,20 @@ namespace sat {
         void to_solver(i_local_search& s);
         
         bool copy_solver(solver& s);
+
+        // cube-and-conquer: create the initial cubes using lookahead on a copy of s.
+        void init_cubes(solver& s, unsigned num_workers);
+
+        // cube-and-conquer: solve cubes from the shared pool until the pool is exhausted,
+        // a model is found, or the formula is found to be unsatisfiable.
+        lbool conquer(solver& s, unsigned num_lits, literal const* lits);
+
+        void cancel_cubes() { m_cubes.cancel(UINT_MAX); }
+
+        // cube-and-conquer: true if the worker owner stopped the pool.
+        bool stopped_cubes(unsigned owner) const { return m_cubes.canceler() == owner; }
+
+        void collect_cube_statistics(statistics& st) const;
     };
 
 };
@@ -77,9 +77,8 @@ namespace sat {
      * Remove all clauses after cl that are in the cone of influence of cl.
      * The coi is defined inductively: C is in coi of cl if it contains ~l
      * or it contains ~l' where l' is implied by a clause in the coi of cl.
-     * Possible optimization: 
-     * - check if clause contains a literal that is on implied on the trail
-     *   if it doesn't contain any such literal, bypass the trail adjustment.
+     * If cl contains no literal that is true, it is not on the trail and 
+     * the trail is left unchanged without scanning it.
      */
 
     void proof_trim::prune_trail(literal_vector const& cl, clause* cp) {
@@ -91,6 +90,13 @@ namespace sat {
         if (cl.empty())
             return;
 
+        if (all_of(cl, [&](literal lit) { return s.value(lit) != l_true; })) {
+            s.m_inconsistent = false;
+            s.m_qhead = s.m_trail.size();
+            s.propagate(false);
+            return;
+        }
+
         for (literal lit : cl) 
             m_in_clause.insert(lit.index());
 
@@ -25,6 +25,10 @@ Revision History:
 #include "sat/sat_integrity_checker.h"
 #include "util/stopwatch.h"
 #include "util/trace.h"
+#include <atomic>
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
 
 namespace sat {
 
@@ -1814,16 +1818,24 @@ namespace sat {
             return false;
         if (c2.was_removed() && !c2.contains(~l))
             return false;
+        m_elim_counter -= c1.size() + c2.size();
+        return resolve(c1, c2, l, r, m_visited);
+    }
+
+    /**
+       \brief Resolve clauses c1 and c2 using the marks in visited.
+       Only reads the clauses, so it can run concurrently on disjoint visited vectors.
+    */
+    bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited) {
         SASSERT(c1.contains(l));
         SASSERT(c2.contains(~l));
         bool res = true;
-        m_elim_counter -= c1.size() + c2.size();
         unsigned sz1 = c1.size();
         for (unsigned i = 0; i < sz1; ++i) {
             literal l1 = c1[i];
             if (l == l1)
                 continue;
-            m_visited[l1.index()] = true;
+            visited[l1.index()] = true;
             r.push_back(l1);
         }
 
@@ -1833,21 +1845,21 @@ namespace sat {
             literal l2 = c2[i];
             if (not_l == l2)
                 continue;
-            if ((~l2).index() >= m_visited.size()) {
-                //s.display(std::cout << l2 << " " << s.num_vars() << " " << m_visited.size() << "\n");
+            if ((~l2).index() >= visited.size()) {
+                //s.display(std::cout << l2 << " " << s.num_vars() << " " << visited.size() << "\n");
                 UNREACHABLE();
             }
-            if (m_visited[(~l2).index()]) {
+            if (visited[(~l2).index()]) {
                 res = false;
                 break;
             }
-            if (!m_visited[l2.index()])
+            if (!visited[l2.index()])
                 r.push_back(l2);
         }
 
         for (unsigned i = 0; i < sz1; ++i) {
             literal l1 = c1[i];
-            m_visited[l1.index()] = false;
+            visited[l1.index()] = false;
         }
         return res;
     }
@@ -1913,25 +1925,25 @@ namespace sat {
         }
     }
 
-    bool simplifier::try_eliminate(bool_var v) {
-        if (value(v) != l_undef)
-            return false;
-
+    /**
+       \brief Check the occurrence and literal cutoffs for eliminating v.
+    */
+    bool simplifier::within_res_cutoffs(bool_var v, unsigned & num_pos, unsigned & num_neg, unsigned & before_lits) {
         literal pos_l(v, false);
         literal neg_l(v, true);
         unsigned num_bin_pos = num_nonlearned_bin(pos_l);
         unsigned num_bin_neg = num_nonlearned_bin(neg_l);
         clause_use_list & pos_occs = m_use_list.get(pos_l);
         clause_use_list & neg_occs = m_use_list.get(neg_l);
-        unsigned num_pos = pos_occs.num_irredundant() + num_bin_pos;
-        unsigned num_neg = neg_occs.num_irredundant() + num_bin_neg;
+        num_pos = pos_occs.num_irredundant() + num_bin_pos;
+        num_neg = neg_occs.num_irredundant() + num_bin_neg;
 
         TRACE("sat_simplifier", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << "\n";);
 
         if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
             return false;
 
-        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2;
+        before_lits = num_bin_pos*2 + num_bin_neg*2;
 
         for (auto it = pos_occs.mk_iterator(); !it.at_end(); it.next()) {
             if (!it.curr().is_learned())
@@ -1953,6 +1965,84 @@ namespace sat {
         if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
             s.m_clauses.size() <= m_res_cls_cutoff1)
             return false;
+        return true;
+    }
+
+    /**
+       \brief Add the resolvent c of an eliminated variable.
+    */
+    void simplifier::add_resolvent(literal_vector & c) {
+        if (cleanup_clause(c)) 
+            return; // clause is already satisfied.
+        switch (c.size()) {
+        case 0:
+            s.set_conflict();
+            break;
+        case 1:
+            propagate_unit(c[0]);
+            break;
+        case 2:
+            s.m_stats.m_mk_bin_clause++;
+            add_non_learned_binary_clause(c[0], c[1]);
+            back_subsumption1(c[0], c[1], false);
+            break;
+        default: {
+            if (c.size() == 3)
+                s.m_stats.m_mk_ter_clause++;
+            else
+                s.m_stats.m_mk_clause++;
+            clause * new_c = s.alloc_clause(c.size(), c.data(), false);
+
+            if (s.m_config.m_drat) s.m_drat.add(*new_c, status::redundant());
+            s.m_clauses.push_back(new_c);
+
+            m_use_list.insert(*new_c);
+            if (m_sub_counter > 0)
+                back_subsumption1(*new_c);
+            else
+                back_subsumption0(*new_c);
+            break;
+        }
+        }
+    }
+
+    /**
+       \brief Record v as eliminated and save the clauses it occurs in to the model converter.
+    */
+    void simplifier::mk_eliminated(bool_var v) {
+        ++s.m_stats.m_elim_var_res;
+        VERIFY(!is_external(v));
+        model_converter::entry & mc_entry = s.m_mc.mk(model_converter::ELIM_VAR, v);
+        save_clauses(mc_entry, m_pos_cls);
+        save_clauses(mc_entry, m_neg_cls);
+        s.set_eliminated(v, true);
+    }
+
+    /**
+       \brief Remove the clauses of an eliminated variable.
+    */
+    void simplifier::remove_elim_clauses(bool_var v) {
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        remove_bin_clauses(pos_l);
+        remove_bin_clauses(neg_l);
+        clause_use_list& pos_occs = m_use_list.get(pos_l);
+        clause_use_list& neg_occs = m_use_list.get(neg_l);
+        remove_clauses(pos_occs, pos_l);
+        remove_clauses(neg_occs, neg_l);
+        pos_occs.reset();
+        neg_occs.reset();
+    }
+
+    bool simplifier::try_eliminate(bool_var v) {
+        if (value(v) != l_undef)
+            return false;
+
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        unsigned num_pos = 0, num_neg = 0, before_lits = 0;
+        if (!within_res_cutoffs(v, num_pos, num_neg, before_lits))
+            return false;
 
         m_pos_cls.reset();
         m_neg_cls.reset();
@@ -1989,12 +2079,7 @@ namespace sat {
         m_elim_counter -= num_pos * num_neg + before_lits;
 
         // eliminate variable
-        ++s.m_stats.m_elim_var_res;
-        VERIFY(!is_external(v));
-        model_converter::entry & mc_entry = s.m_mc.mk(model_converter::ELIM_VAR, v);
-        save_clauses(mc_entry, m_pos_cls);
-        save_clauses(mc_entry, m_neg_cls);
-        s.set_eliminated(v, true);
+        mk_eliminated(v);
         m_elim_counter -= num_pos * num_neg + before_lits;
 
         for (auto & c1 : m_pos_cls) {
@@ -2005,55 +2090,183 @@ namespace sat {
                 if (!resolve(c1, c2, pos_l, m_new_cls))
                     continue;                
                 TRACE("sat_simplifier", tout << c1 << "\n" << c2 << "\n-->\n" << m_new_cls << "\n";);
-                if (cleanup_clause(m_new_cls)) {
-                    continue; // clause is already satisfied.
-                }
-                switch (m_new_cls.size()) {
-                case 0:
-                    s.set_conflict();
-                    break;
-                case 1:
-                    propagate_unit(m_new_cls[0]);
-                    break;
-                case 2:
-                    s.m_stats.m_mk_bin_clause++;
-                    add_non_learned_binary_clause(m_new_cls[0], m_new_cls[1]);
-                    back_subsumption1(m_new_cls[0], m_new_cls[1], false);
-                    break;
-                default:
-                    if (m_new_cls.size() == 3)
-                        s.m_stats.m_mk_ter_clause++;
-                    else
-                        s.m_stats.m_mk_clause++;
-                    clause * new_c = s.alloc_clause(m_new_cls.size(), m_new_cls.data(), false);
-
-                    if (s.m_config.m_drat) s.m_drat.add(*new_c, status::redundant());
-                    s.m_clauses.push_back(new_c);
-
-                    m_use_list.insert(*new_c);
-                    if (m_sub_counter > 0)
-                        back_subsumption1(*new_c);
-                    else
-                        back_subsumption0(*new_c);
-                    break;
-                }
+                add_resolvent(m_new_cls);
                 if (s.inconsistent())
                     return true;
             }
         }
-        remove_bin_clauses(pos_l);
-        remove_bin_clauses(neg_l);
-        {
-            clause_use_list& pos_occs = m_use_list.get(pos_l);
-            clause_use_list& neg_occs = m_use_list.get(neg_l);
-            remove_clauses(pos_occs, pos_l);
-            remove_clauses(neg_occs, neg_l);
-            pos_occs.reset();
-            neg_occs.reset();
+        remove_elim_clauses(v);
+        return true;
+    }
+
+    /**
+       \brief Compute the resolvents of the candidate j.
+       The clauses of j are only read, so jobs of candidates that share
+       no clauses can be processed concurrently, each with its own visited vector.
+    */
+    void simplifier::compute_resolvents(elim_job & j, svector<char> & visited) {
+        literal pos_l(j.m_var, false);
+        unsigned before_clauses = j.m_num_pos + j.m_num_neg;
+        unsigned after_clauses = 0;
+        j.m_eliminable = false;
+        j.m_work = 0;
+        j.m_lits.reset();
+        j.m_ends.reset();
+        for (clause_wrapper const& c1 : j.m_pos) {
+            for (clause_wrapper const& c2 : j.m_neg) {
+                j.m_work += c1.size() + c2.size();
+                unsigned sz = j.m_lits.size();
+                if (!resolve(c1, c2, pos_l, j.m_lits, visited)) {
+                    j.m_lits.shrink(sz);
+                    continue;
+                }
+                if (++after_clauses > before_clauses) 
+                    return;
+                j.m_ends.push_back(j.m_lits.size());
+            }
         }
+        j.m_eliminable = true;
+    }
+
+    /**
+       \brief Eliminate the candidate j using its precomputed resolvents.
+       Committing earlier candidates of the batch may have strengthened or removed
+       clauses of j by subsumption or unit propagation. The clauses of j are
+       collected again and j falls back to try_eliminate if they changed.
+    */
+    bool simplifier::commit_eliminate(elim_job & j) {
+        bool_var v = j.m_var;
+        if (value(v) != l_undef)
+            return false;
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        unsigned num_pos = 0, num_neg = 0, before_lits = 0;
+        bool unchanged = 
+            within_res_cutoffs(v, num_pos, num_neg, before_lits) &&
+            num_pos == j.m_num_pos && num_neg == j.m_num_neg && before_lits == j.m_before_lits;
+        if (unchanged) {
+            m_pos_cls.reset();
+            m_neg_cls.reset();
+            collect_clauses(pos_l, m_pos_cls);
+            collect_clauses(neg_l, m_neg_cls);
+            // clauses only shrink, so equal literal counts and clause identities imply equal clauses.
+            auto same = [](clause_wrapper_vector const& cs1, clause_wrapper_vector const& cs2) {
+                if (cs1.size() != cs2.size())
+                    return false;
+                for (unsigned i = 0; i < cs1.size(); ++i) {
+                    clause_wrapper const& c1 = cs1[i];
+                    clause_wrapper const& c2 = cs2[i];
+                    if (c1.is_binary() != c2.is_binary())
+                        return false;
+                    if (c1.is_binary() ? (c1[0] != c2[0] || c1[1] != c2[1]) : c1.get_clause() != c2.get_clause())
+                        return false;
+                }
+                return true;
+            };
+            unchanged = same(m_pos_cls, j.m_pos) && same(m_neg_cls, j.m_neg);
+        }
+        if (!unchanged) {
+            ++m_num_elim_retries;
+            return try_eliminate(v);
+        }
+        m_elim_counter -= j.m_work;
+        if (!j.m_eliminable)
+            return false;
+
+        TRACE("sat_simplifier", tout << "eliminate " << v << ", before: " << (num_pos + num_neg) << " after: " << j.m_ends.size() << "\n";);
+        m_elim_counter -= j.m_work + 3 * (num_pos * num_neg + before_lits);
+        mk_eliminated(v);
+        unsigned start = 0;
+        for (unsigned end : j.m_ends) {
+            m_new_cls.reset();
+            m_new_cls.append(end - start, j.m_lits.data() + start);
+            start = end;
+            add_resolvent(m_new_cls);
+            if (s.inconsistent())
+                return true;
+        }
+        remove_elim_clauses(v);
         return true;
     }
 
+    /**
+       \brief Eliminate variables in batches of candidates that pairwise share no clauses.
+       Resolvents of a batch are computed by m_res_threads threads, and the candidates 
+       are then eliminated serially in the order of vars.
+    */
+    void simplifier::elim_vars_parallel(bool_var_vector const & vars) {
+        unsigned num_threads = m_res_threads;
+        unsigned max_batch = 128 * num_threads;
+        vector<elim_job> jobs;
+        svector<char> selected(s.num_vars(), false);
+        vector<svector<char>> visited(num_threads);
+        for (auto& vs : visited)
+            vs.resize(2 * s.num_vars(), false);
+        unsigned i = 0;
+        while (i < vars.size() && m_elim_counter >= 0 && !s.inconsistent()) {
+            checkpoint();
+            // select the next batch of independent candidates
+            for (elim_job const& j : jobs)
+                selected[j.m_var] = false;
+            jobs.reset();
+            for (; i < vars.size() && jobs.size() < max_batch; ++i) {
+                bool_var v = vars[i];
+                if (is_external(v) || value(v) != l_undef)
+                    continue;
+                elim_job j;
+                j.m_var = v;
+                if (!within_res_cutoffs(v, j.m_num_pos, j.m_num_neg, j.m_before_lits)) {
+                    // try_eliminate would fail as well, only BDD elimination could apply.
+                    if (!elim_vars_bdd_enabled())
+                        continue;
+                    j.m_num_pos = UINT_MAX;
+                }
+                collect_clauses(literal(v, false), j.m_pos);
+                collect_clauses(literal(v, true), j.m_neg);
+                bool independent = true;
+                for (auto const* cs : { &j.m_pos, &j.m_neg }) 
+                    for (clause_wrapper const& c : *cs)
+                        for (literal l : c)
+                            independent &= !selected[l.var()];
+                if (!independent)
+                    break;
+                selected[v] = true;
+                jobs.push_back(std::move(j));
+            }
+            if (jobs.empty())
+                break;
+
+            std::atomic<unsigned> next(0);
+            auto worker = [&](unsigned id) {
+                for (unsigned k = next++; k < jobs.size(); k = next++)
+                    if (jobs[k].m_num_pos != UINT_MAX)
+                        compute_resolvents(jobs[k], visited[id]);
+            };
+#ifdef SINGLE_THREAD
+            worker(0);
+#else
+            unsigned n = std::min(num_threads, jobs.size());
+            vector<std::thread> threads;
+            for (unsigned k = 1; k < n; ++k)
+                threads.push_back(std::thread(worker, k));
+            worker(0);
+            for (auto& th : threads)
+                th.join();
+#endif
+            ++m_num_elim_batches;
+
+            sat::elim_vars elim_bdd(*this);
+            for (elim_job& j : jobs) {
+                if (m_elim_counter < 0 || s.inconsistent())
+                    break;
+                if (j.m_num_pos != UINT_MAX && commit_eliminate(j)) 
+                    m_num_elim_vars++;
+                else if (elim_vars_bdd_enabled() && value(j.m_var) == l_undef && elim_bdd(j.m_var))
+                    m_num_elim_vars++;
+            }
+        }
+    }
+
     struct simplifier::elim_var_report {
         simplifier & m_simplifier;
         stopwatch    m_watch;
@@ -2080,6 +2293,13 @@ namespace sat {
         elim_var_report rpt(*this);
         bool_var_vector vars;
         order_vars_for_elim(vars);
+        if (m_res_threads > 1) {
+            elim_vars_parallel(vars);
+            m_pos_cls.finalize();
+            m_neg_cls.finalize();
+            m_new_cls.finalize();
+            return;
+        }
         sat::elim_vars elim_bdd(*this);
         for (bool_var v : vars) {
             checkpoint();
@@ -2123,6 +2343,7 @@ namespace sat {
         m_res_lit_cutoff3         = p.resolution_lit_cutoff_range3();
         m_res_cls_cutoff1         = p.resolution_cls_cutoff1();
         m_res_cls_cutoff2         = p.resolution_cls_cutoff2();
+        m_res_threads             = std::max(1u, p.resolution_threads());
         m_subsumption             = p.subsumption();
         m_subsumption_limit       = p.subsumption_limit();
         m_elim_vars               = p.elim_vars();
@@ -2139,6 +2360,8 @@ namespace sat {
         st.update("sat subsumed", m_num_subsumed);
         st.update("sat subs resolution", m_num_sub_res);
         st.update("sat elim literals", m_num_elim_lits);
+        st.update("sat elim var batches", m_num_elim_batches);
+        st.update("sat elim var retries", m_num_elim_retries);
         st.update("sat bce",  m_num_bce);
         st.update("sat cce",  m_num_cce);
         st.update("sat acce", m_num_acce);
@@ -2156,6 +2379,8 @@ namespace sat {
         m_num_sub_res = 0;
         m_num_elim_lits = 0;
         m_num_elim_vars = 0;
+        m_num_elim_batches = 0;
+        m_num_elim_retries = 0;
         m_num_bca = 0;
         m_num_ate = 0;
     }
@@ -99,6 +99,7 @@ namespace sat {
         unsigned               m_res_lit_cutoff3;
         unsigned               m_res_cls_cutoff1;
         unsigned               m_res_cls_cutoff2;
+        unsigned               m_res_threads;
 
         bool                   m_subsumption;
         unsigned               m_subsumption_limit;
@@ -117,6 +118,8 @@ namespace sat {
         unsigned               m_num_elim_vars;
         unsigned               m_num_sub_res;
         unsigned               m_num_elim_lits;
+        unsigned               m_num_elim_batches;
+        unsigned               m_num_elim_retries;
 
         bool                   m_learned_in_use_lists;
         unsigned               m_old_num_elim_vars;
@@ -199,13 +202,35 @@ namespace sat {
         clause_wrapper_vector m_neg_cls;
         literal_vector m_new_cls;
         bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r);
+        static bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited);
         void save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs);
         void add_non_learned_binary_clause(literal l1, literal l2);
         void remove_bin_clauses(literal l);
         void remove_clauses(clause_use_list const & cs, literal l);
+        bool within_res_cutoffs(bool_var v, unsigned & num_pos, unsigned & num_neg, unsigned & before_lits);
+        void add_resolvent(literal_vector & c);
+        void mk_eliminated(bool_var v);
+        void remove_elim_clauses(bool_var v);
         bool try_eliminate(bool_var v);
         void elim_vars();
 
+        // elimination candidate whose resolvents are computed concurrently.
+        struct elim_job {
+            bool_var              m_var = null_bool_var;
+            unsigned              m_num_pos = 0;
+            unsigned              m_num_neg = 0;
+            unsigned              m_before_lits = 0;
+            clause_wrapper_vector m_pos;
+            clause_wrapper_vector m_neg;
+            bool                  m_eliminable = false;
+            unsigned              m_work = 0;
+            literal_vector        m_lits;  // resolvents, concatenated
+            unsigned_vector       m_ends;  // end offset of each resolvent in m_lits
+        };
+        void compute_resolvents(elim_job & j, svector<char> & visited);
+        bool commit_eliminate(elim_job & j);
+        void elim_vars_parallel(bool_var_vector const & vars);
+
         struct blocked_cls_report;
         struct subsumption_report;
         struct elim_var_report;
@@ -24,6 +24,9 @@ Revision History:
 #endif
 #include "util/luby.h"
 #include "util/trace.h"
+#include "util/event_trace.h"
+#include "util/profile.h"
+#include "util/perf_counters.h"
 #include "util/max_cliques.h"
 #include "util/gparams.h"
 #include "sat/sat_solver.h"
@@ -32,6 +35,7 @@ Revision History:
 #include "sat/sat_ddfw_wrapper.h"
 #include "sat/sat_prob.h"
 #include "sat/sat_anf_simplifier.h"
+#include "sat/sat_xor_gauss.h"
 #include "sat/sat_cut_simplifier.h"
 #if defined(_MSC_VER) && !defined(_M_ARM) && !defined(_M_ARM64)
 # include <xmmintrin.h>
@@ -53,6 +57,7 @@ namespace sat {
         m_scc(*this, p),
         m_asymm_branch(*this, p),
         m_probing(*this, p),
+        m_inprocess(*this),
         m_mus(*this),
         m_binspr(*this),
         m_inconsistent(false),
@@ -141,6 +146,7 @@ namespace sat {
         m_canceled.reset();
         m_reasoned.reset();
         m_case_split_queue.reset();
+        m_vmtf.reset();
         m_simplifier.reset_todos();
         m_qhead = 0;
         m_trail.reset();
@@ -276,6 +282,7 @@ namespace sat {
         m_canceled[v] = 0;
         m_reasoned[v] = 0;
         m_case_split_queue.mk_var_eh(v);
+        m_vmtf.mk_var(v);
         m_simplifier.insert_elim_todo(v);
     }
 
@@ -317,6 +324,7 @@ namespace sat {
         m_canceled.push_back(0);
         m_reasoned.push_back(0);
         m_case_split_queue.mk_var_eh(v);
+        m_vmtf.mk_var(v);
         m_simplifier.insert_elim_todo(v);
         SASSERT(!was_eliminated(v));
         return v;
@@ -661,10 +669,11 @@ namespace sat {
     }
 
     void solver::defrag_clauses() {
-        m_defrag_threshold = 2;
+        m_defrag_threshold = m_config.m_gc_defrag_interval;
         if (memory_pressure()) return;
         pop(scope_lvl());
-        IF_VERBOSE(2, verbose_stream() << "(sat-defrag)\n");
+        m_stats.m_defrag++;
+        IF_VERBOSE(2, verbose_stream() << "(sat-defrag :memory " << cls_allocator().get_allocation_size() << ")\n");
         clause_allocator& alloc = m_cls_allocator[!m_cls_allocator_idx];
         ptr_vector<clause> new_clauses, new_learned;
         for (clause* c : m_clauses) c->unmark_used();
@@ -702,20 +711,16 @@ namespace sat {
             }
         }
 
-        // reallocate ternary clauses.
+        // reallocate clauses that are not watched.
         for (clause* c : m_clauses) {
-            if (!c->was_used()) {
-                SASSERT(c->size() == 3);
+            if (!c->was_used()) 
                 new_clauses.push_back(alloc.copy_clause(*c));
-            }
             dealloc_clause(c);
         }
 
         for (clause* c : m_learned) {
-            if (!c->was_used()) {
-                SASSERT(c->size() == 3);
+            if (!c->was_used()) 
                 new_learned.push_back(alloc.copy_clause(*c));
-            }
             dealloc_clause(c);
         }
         m_clauses.swap(new_clauses);
@@ -723,6 +728,7 @@ namespace sat {
 
         cls_allocator().finalize();
         m_cls_allocator_idx = !m_cls_allocator_idx;
+        IF_VERBOSE(2, verbose_stream() << "(sat-defrag :new-memory " << cls_allocator().get_allocation_size() << ")\n");
 
         reinit_assumptions();
     }
@@ -920,15 +926,8 @@ namespace sat {
             }
         }
         
-        if (m_config.m_propagate_prefetch) {
-#if defined(__GNUC__) || defined(__clang__)
-            __builtin_prefetch((const char*)((m_watches[l.index()].data())));
-#else
-    #if !defined(_M_ARM) && !defined(_M_ARM64)
-            _mm_prefetch((const char*)((m_watches[l.index()].data())), _MM_HINT_T1);
-    #endif
-#endif
-        }
+        if (m_config.m_propagate_prefetch) 
+            prefetch(m_watches[l.index()].data());
 
         SASSERT(!l.sign() || !m_phase[v]);
         SASSERT(l.sign()  || m_phase[v]);
@@ -938,6 +937,16 @@ namespace sat {
         SASSERT(value(~l) == l_false);
     }
 
+    void solver::prefetch(void const* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch((const char*)(p));
+#else
+    #if !defined(_M_ARM) && !defined(_M_ARM64)
+        _mm_prefetch((const char*)(p), _MM_HINT_T1);
+    #endif
+#endif
+    }
+
     lbool solver::status(clause const & c) const {
         bool found_undef = false;
         for (literal lit : c) {
@@ -985,6 +994,8 @@ namespace sat {
     }
 
     bool solver::propagate(bool update) {
+        profile::scope _ps("sat.propagate");
+        perf_counters::scope _pc(perf_counters::sat_propagate);
         unsigned qhead = m_qhead;
         bool r = propagate_core(update);
         if (m_config.m_branching_heuristic == BH_CHB) {
@@ -1027,12 +1038,21 @@ namespace sat {
         watch_list::iterator it = wlist.begin();
         watch_list::iterator it2 = it;
         watch_list::iterator end = wlist.end();
+        // clauses of watches that are prefetch_distance ahead are loaded while
+        // the current watch is processed, unless their blocked literal is true.
+        const unsigned prefetch_distance = 4;
+        watch_list::iterator pf = m_config.m_propagate_prefetch ? it + std::min(prefetch_distance, wlist.size()) : end;
 #define CONFLICT_CLEANUP() {                    \
                 for (; it != end; ++it, ++it2)  \
                     *it2 = *it;                 \
                 wlist.set_end(it2);             \
             }
         for (; it != end; ++it) {
+            if (pf != end) {
+                if (pf->is_clause() && value(pf->get_blocked_literal()) != l_true)
+                    prefetch(cls_allocator().get_clause(pf->get_clause_offset()));
+                ++pf;
+            }
             switch (it->get_kind()) {
             case watched::BINARY:
                 l1 = it->get_literal();
@@ -1225,6 +1245,7 @@ namespace sat {
     //
     // -----------------------
     lbool solver::check(unsigned num_lits, literal const* lits) {
+        scoped_memory_tag _tag(memory::tag_sat);
         init_reason_unknown();
         pop_to_base_level();
         m_stats.m_units = init_trail_size();
@@ -1500,6 +1521,9 @@ namespace sat {
 
         sat::parallel par(*this);
         par.reserve(num_threads, 1 << 12);
+        bool cube_and_conquer = m_config.m_cube_and_conquer && num_extra_solvers > 0 && !m_ext;
+        if (cube_and_conquer)
+            par.init_cubes(*this, num_extra_solvers + 1);
         par.init_solvers(*this, num_extra_solvers);
         for (unsigned i = 0; i < ls.size(); ++i) {
             par.push_child(ls[i]->rlimit());
@@ -1522,14 +1546,19 @@ namespace sat {
             try {
                 lbool r = l_undef;
                 if (IS_AUX_SOLVER(i)) {
-                    r = par.get_solver(i).check(num_lits, lits);
+                    solver& s = par.get_solver(i);
+                    r = cube_and_conquer ? par.conquer(s, num_lits, lits) : s.check(num_lits, lits);
                 }
                 else if (IS_LOCAL_SEARCH(i)) {
                     r = ls[i-local_search_offset]->check(num_lits, lits, &par);
                 }
                 else {
-                    r = check(num_lits, lits);
+                    r = cube_and_conquer ? par.conquer(*this, num_lits, lits) : check(num_lits, lits);
                 }
+                if (cube_and_conquer && r == l_undef && !IS_LOCAL_SEARCH(i) && 
+                    !par.stopped_cubes(IS_AUX_SOLVER(i) ? i : num_extra_solvers))
+                    // the worker stopped because the cube pool was closed by another worker.
+                    return;
                 bool first = false;
                 {
                     std::lock_guard<std::mutex> lock(mux);
@@ -1540,6 +1569,7 @@ namespace sat {
                     }
                 }
                 if (first) {
+                    par.cancel_cubes();
                     for (unsigned j = 0; j < ls.size(); ++j) {
                         ls[j]->rlimit().cancel();
                     }
@@ -1562,10 +1592,12 @@ namespace sat {
             catch (z3_error & err) {
                 error_code = err.error_code();
                 ex_kind = ERROR_EX;                
+                par.cancel_cubes();
             }
             catch (z3_exception & ex) {
                 ex_msg = ex.what();
                 ex_kind = DEFAULT_EX;    
+                par.cancel_cubes();
             }
         };
 
@@ -1598,6 +1630,8 @@ namespace sat {
         if (!canceled) {
             rlimit().reset_cancel();
         }
+        if (cube_and_conquer)
+            par.collect_cube_statistics(m_aux_stats);
         par.reset();
         set_par(nullptr, 0);
         ls.reset();
@@ -1668,6 +1702,9 @@ namespace sat {
                 return next;
         }
 
+        if (m_focused) 
+            return m_vmtf.next([&](bool_var v) { return is_decision_candidate(v); });
+
         while (!m_case_split_queue.empty()) {
             if (m_config.m_anti_exploration) {
                 next = m_case_split_queue.min_var();
@@ -1983,8 +2020,12 @@ namespace sat {
         m_force_conflict_analysis = false;
         m_restart_threshold       = m_config.m_restart_initial;
         m_luby_idx                = 1;
+        m_focused                 = m_config.m_vmtf;
+        m_mode_conflicts          = m_config.m_vmtf_conflicts;
+        m_next_mode_switch        = m_mode_conflicts;
+        m_vmtf_bumped.reset();
         m_gc_threshold            = m_config.m_gc_initial;
-        m_defrag_threshold        = 2;
+        m_defrag_threshold        = m_config.m_gc_defrag_interval;
         m_restarts                = 0;
         m_last_position_log       = 0;
         m_restart_logs            = 0;
@@ -2045,19 +2086,19 @@ namespace sat {
         m_cleaner(m_config.m_force_cleanup);
         CASSERT("sat_simplify_bug", check_invariant());
 
-        m_scc();
+        m_inprocess(inprocess_scheduler::scc_k, [&]() { m_scc(); });
         CASSERT("sat_simplify_bug", check_invariant());
 
         if (m_ext) {
             m_ext->pre_simplify();
         }
       
-        m_simplifier(false);
+        m_inprocess(inprocess_scheduler::simplifier_k, [&]() { m_simplifier(false); });
 
         CASSERT("sat_simplify_bug", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
         if (!m_learned.empty()) {
-            m_simplifier(true);
+            m_inprocess(inprocess_scheduler::simplifier_learned_k, [&]() { m_simplifier(true); });
             CASSERT("sat_missed_prop", check_missed_propagation());
             CASSERT("sat_simplify_bug", check_invariant());
         }
@@ -2071,15 +2112,18 @@ namespace sat {
             m_ext->simplify();
         }
 
-        m_probing();
+        m_inprocess(inprocess_scheduler::probing_k, [&]() { m_probing(); });
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
-        m_asymm_branch(false);
+        m_inprocess(inprocess_scheduler::asymm_branch_k, [&]() { m_asymm_branch(false); });
+        m_inprocess(inprocess_scheduler::vivify_k, [&]() { m_asymm_branch.vivify_learned(); });
 
         if (m_config.m_lookahead_simplify && !m_ext) {
-            lookahead lh(*this);
-            lh.simplify(true);
-            lh.collect_statistics(m_aux_stats);
+            m_inprocess(inprocess_scheduler::lookahead_k, [&]() {
+                lookahead lh(*this);
+                lh.simplify(true);
+                lh.collect_statistics(m_aux_stats);
+            });
         }
 
         reinit_assumptions();
@@ -2104,18 +2148,30 @@ namespace sat {
         }
 
         if (m_config.m_anf_simplify && m_simplifications > m_config.m_anf_delay && !inconsistent()) {
-            anf_simplifier anf(*this);
-            anf_simplifier::config cfg;
-            cfg.m_enable_exlin = m_config.m_anf_exlin;
-            anf();
-            anf.collect_statistics(m_aux_stats);
-            // TBD: throttle anf_delay based on yield
+            m_inprocess(inprocess_scheduler::anf_k, [&]() {
+                anf_simplifier anf(*this);
+                anf_simplifier::config cfg;
+                cfg.m_enable_exlin = m_config.m_anf_exlin;
+                anf();
+                anf.collect_statistics(m_aux_stats);
+            });
+        }
+
+        if (m_config.m_gauss && !inconsistent()) {
+            m_inprocess(inprocess_scheduler::gauss_k, [&]() {
+                xor_gauss gauss(*this, m_config.m_gauss_max_xors);
+                gauss();
+                gauss.collect_statistics(m_aux_stats);
+            });
         }
         
         if (m_cut_simplifier && m_simplifications > m_config.m_cut_delay && !inconsistent()) {
-            (*m_cut_simplifier)();
+            m_inprocess(inprocess_scheduler::cut_k, [&]() { (*m_cut_simplifier)(); });
         }
 
+        m_inprocess.end_round();
+        IF_VERBOSE(3, m_inprocess.display(verbose_stream()););
+
         if (m_config.m_inprocess_out.is_non_empty_string()) {
             std::ofstream fout(m_config.m_inprocess_out.str());
             if (fout) {
@@ -2269,10 +2325,11 @@ namespace sat {
     }
 
     bool solver::should_restart() const {
+        if (m_config.m_vmtf && m_conflicts_since_init >= m_next_mode_switch && scope_lvl() > search_lvl()) return true;
         if (m_conflicts_since_restart <= m_restart_threshold) return false;
         if (scope_lvl() < 2 + search_lvl()) return false;
         if (m_case_split_queue.empty()) return false;
-        if (m_config.m_restart != RS_EMA) return true;
+        if (current_restart() != RS_EMA) return true;
         return 
             m_fast_glue_avg + search_lvl() <= scope_lvl() && 
             m_config.m_restart_margin * m_slow_glue_avg <= m_fast_glue_avg;
@@ -2345,6 +2402,7 @@ namespace sat {
     void solver::do_restart(bool to_base) {        
         m_stats.m_restart++;
         m_restarts++;
+        EVENT_TRACE(restart_k, m_stats.m_restart, m_stats.m_conflict);
         if (m_conflicts_since_init >= m_restart_next_out && get_verbosity_level() >= 1) {
             if (0 == m_restart_next_out) {
                 m_restart_next_out = 1;
@@ -2354,10 +2412,13 @@ namespace sat {
             }
             log_stats();
         }
-        TRACE("sat", tout << "restart " << restart_level(to_base) << "\n";);
+        unsigned num_scopes = restart_level(to_base);
+        TRACE("sat", tout << "restart " << num_scopes << "\n";);
+        if (update_mode())
+            num_scopes = scope_lvl() - search_lvl();
         IF_VERBOSE(30, display_status(verbose_stream()););
-        TRACE("sat", tout << "restart " << restart_level(to_base) << "\n";);
-        pop_reinit(restart_level(to_base));
+        m_stats.m_reused_levels += scope_lvl() - search_lvl() - num_scopes;
+        pop_reinit(num_scopes);
         set_next_restart();        
     }
 
@@ -2365,6 +2426,16 @@ namespace sat {
         SASSERT(!m_case_split_queue.empty());
         if (to_base || scope_lvl() == search_lvl()) 
             return scope_lvl() - search_lvl();        
+        else if (m_focused) {
+            // keep the decisions that were bumped more recently than the next decision.
+            bool_var next = m_vmtf.next([&](bool_var v) { return is_decision_candidate(v); });
+            if (next == null_bool_var)
+                return scope_lvl() - search_lvl();
+            unsigned n = search_lvl();
+            for (; n < scope_lvl() && m_vmtf.stamp(scope_literal(n).var()) > m_vmtf.stamp(next); ++n) {
+            }
+            return scope_lvl() - n;
+        }
         else {
             bool_var next = m_case_split_queue.min_var();
 
@@ -2383,9 +2454,11 @@ namespace sat {
 #endif
             // pop trail from bottom
             unsigned n = search_lvl();
+            // keep the decisions that are more active than next, they
+            // would be re-decided in the same order after a full restart.
             for (; n < scope_lvl() && m_case_split_queue.more_active(scope_literal(n).var(), next); ++n) {
             }
-            return n - search_lvl();
+            return scope_lvl() - n;
         }
     }
 
@@ -2394,15 +2467,44 @@ namespace sat {
         set_activity(v, new_act);
     }
 
+    /**
+       \brief alternate between focused and stable mode.
+       The number of conflicts spent in a mode grows geometrically.
+     */
+    bool solver::update_mode() {
+        if (!m_config.m_vmtf || m_conflicts_since_init < m_next_mode_switch)
+            return false;
+        m_focused = !m_focused;
+        ++m_stats.m_mode_switches;
+        m_vmtf_bumped.reset();
+        m_mode_conflicts = static_cast<unsigned>(std::min(m_mode_conflicts * m_config.m_vmtf_factor, static_cast<double>(UINT_MAX / 2)));
+        m_next_mode_switch = m_conflicts_since_init + m_mode_conflicts;
+        m_luby_idx = 1;
+        m_restart_threshold = restart_unit();
+        IF_VERBOSE(2, verbose_stream() << "(sat.mode " << (m_focused ? "focused" : "stable") << " :conflicts " << m_conflicts_since_init << ")\n";);
+        return true;
+    }
+
+    /**
+       \brief move the variables bumped in the last conflict to the front of m_vmtf,
+       preserving their relative order.
+     */
+    void solver::bump_vmtf() {
+        std::sort(m_vmtf_bumped.begin(), m_vmtf_bumped.end(), [&](bool_var a, bool_var b) { return m_vmtf.stamp(a) < m_vmtf.stamp(b); });
+        for (bool_var v : m_vmtf_bumped)
+            m_vmtf.bump(v, value(v) == l_undef);
+        m_vmtf_bumped.reset();
+    }
+
     void solver::set_next_restart() {
         m_conflicts_since_restart = 0;
-        switch (m_config.m_restart) {
+        switch (current_restart()) {
         case RS_GEOMETRIC:
             m_restart_threshold = static_cast<unsigned>(m_restart_threshold * m_config.m_restart_factor);
             break;
         case RS_LUBY:
             m_luby_idx++;
-            m_restart_threshold = m_config.m_restart_initial * get_luby(m_luby_idx);
+            m_restart_threshold = restart_unit() * get_luby(m_luby_idx);
             break;
         case RS_EMA:
             m_restart_threshold = m_config.m_restart_initial;
@@ -2441,6 +2543,7 @@ namespace sat {
         m_conflicts_since_restart++;
         m_conflicts_since_gc++;
         m_stats.m_conflict++;
+        EVENT_TRACE(conflict_k, m_stats.m_conflict, scope_lvl());
         if (m_step_size > m_config.m_step_size_min)
             m_step_size -= m_config.m_step_size_dec;        
 
@@ -2656,6 +2759,8 @@ namespace sat {
         }
         m_lemma.reset();
         TRACE("sat_conflict_detail", tout << "consistent " << (!m_inconsistent) << " scopes: " << scope_lvl() << " backtrack: " << backtrack_lvl << " backjump: " << backjump_lvl << "\n";);
+        if (m_focused)
+            bump_vmtf();
         decay_activity();
         updt_phase_counters();
     }
@@ -3592,6 +3697,7 @@ namespace sat {
 
         for (bool_var w = m_justification.size(); w-- > v;) {
             m_case_split_queue.del_var_eh(w);
+            m_vmtf.del_var(w);
             m_probing.reset_cache(literal(w, true));
             m_probing.reset_cache(literal(w, false));
         }
@@ -3625,8 +3731,10 @@ namespace sat {
         scope & s        = m_scopes[new_lvl];
         m_inconsistent   = false; // TBD: use model seems to make this redundant: s.m_inconsistent;
         unassign_vars(s.m_trail_lim, new_lvl);
-        for (bool_var v : m_vars_to_free)
+        for (bool_var v : m_vars_to_free) {
             m_case_split_queue.del_var_eh(v);
+            m_vmtf.del_var(v);
+        }
         m_scope_lvl -= num_scopes;
         reinit_clauses(s.m_clauses_to_reinit_lim);
         m_scopes.shrink(new_lvl);
@@ -3651,6 +3759,7 @@ namespace sat {
             m_assignment[(~l).index()] = l_undef;
             SASSERT(value(v) == l_undef);
             m_case_split_queue.unassign_var_eh(v);
+            m_vmtf.unassign(v);
             if (m_config.m_anti_exploration) {
                 m_canceled[v] = m_stats.m_conflict;
             }
@@ -3762,6 +3871,7 @@ namespace sat {
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
         m_scc.updt_params(p);
+        m_inprocess.updt_params(m_config.m_inprocess_adaptive, m_config.m_inprocess_min_ratio, m_config.m_inprocess_max_backoff);
         m_rand.set_seed(m_config.m_random_seed);
         m_step_size = m_config.m_step_size_init;
         m_drat.updt_config();
@@ -3791,6 +3901,7 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_inprocess.collect_statistics(st);
         if (m_ext) m_ext->collect_statistics(st);
         if (m_local_search) m_local_search->collect_statistics(st);
         if (m_cut_simplifier) m_cut_simplifier->collect_statistics(st);
@@ -3803,6 +3914,7 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        m_inprocess.reset_statistics();
         m_aux_stats.reset();
     }
 
@@ -4757,6 +4869,7 @@ namespace sat {
         st.update("sat mk var", m_mk_var);
         st.update("sat gc clause", m_gc_clause);
         st.update("sat del clause", m_del_clause);
+        st.update("sat defrag", m_defrag);
         st.update("sat conflicts", m_conflict);
         st.update("sat decisions", m_decision);
         st.update("sat propagations 2ary", m_bin_propagate);
@@ -4771,6 +4884,8 @@ namespace sat {
         st.update("sat elim bool vars bdd", m_elim_var_bdd);
         st.update("sat backjumps", m_backjumps);
         st.update("sat backtracks", m_backtracks);
+        st.update("sat restart reused levels", m_reused_levels);
+        st.update("sat mode switches", m_mode_switches);
     }
 
     void stats::reset() {
@@ -41,6 +41,8 @@ Revision History:
 #include "sat/sat_asymm_branch.h"
 #include "sat/sat_cut_simplifier.h"
 #include "sat/sat_probing.h"
+#include "sat/sat_inprocess.h"
+#include "sat/sat_vmtf.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_binspr.h"
 #include "sat/sat_drat.h"
@@ -70,6 +72,7 @@ namespace sat {
         unsigned m_restart;
         unsigned m_gc_clause;
         unsigned m_del_clause;
+        unsigned m_defrag;
         unsigned m_minimized_lits;
         unsigned m_dyn_sub_res;
         unsigned m_non_learned_generation;
@@ -79,6 +82,8 @@ namespace sat {
         unsigned m_units;
         unsigned m_backtracks;
         unsigned m_backjumps;
+        unsigned m_reused_levels;
+        unsigned m_mode_switches;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -112,6 +117,7 @@ namespace sat {
         scc                     m_scc;
         asymm_branch            m_asymm_branch;
         probing                 m_probing;
+        inprocess_scheduler     m_inprocess;
         bool                    m_is_probing { false };
         mus                     m_mus;           // MUS for minimal core extraction
         binspr                  m_binspr;
@@ -166,6 +172,11 @@ namespace sat {
         backoff                 m_rephase;
         backoff                 m_reorder;
         var_queue<unsigned_vector> m_case_split_queue;
+        vmtf_queue              m_vmtf;
+        bool_var_vector         m_vmtf_bumped;
+        bool                    m_focused = false;  // decide by m_vmtf instead of m_case_split_queue
+        unsigned                m_mode_conflicts = 0;
+        unsigned                m_next_mode_switch = 0;
         unsigned                m_qhead;
         unsigned                m_scope_lvl;
         unsigned                m_search_lvl;
@@ -221,6 +232,7 @@ namespace sat {
         friend class bcd;
         friend class mus;
         friend class probing;
+        friend class inprocess_scheduler;
         friend class simplifier;
         friend class scc;
         friend class pb::solver;
@@ -416,10 +428,11 @@ namespace sat {
         void set_conflict(justification c) { set_conflict(c, null_literal); }
         void set_conflict() { set_conflict(justification(0)); }
         lbool status(clause const & c) const;        
+        static void prefetch(void const* p);
         clause_offset get_offset(clause const & c) const { return cls_allocator().get_offset(&c); }
 
         bool limit_reached() {
-            if (!m_rlimit.inc()) {
+            if (!m_rlimit.tick()) {
                 m_model_is_current = false;
                 TRACE("sat", tout << "canceled\n";);
                 m_reason_unknown = "sat.canceled";
@@ -589,6 +602,11 @@ namespace sat {
         bool should_cancel();
         bool should_restart() const;
         void set_next_restart();
+        restart_strategy current_restart() const { return m_focused || !m_config.m_vmtf ? m_config.m_restart : RS_LUBY; }
+        unsigned restart_unit() const { return m_focused || !m_config.m_vmtf ? m_config.m_restart_initial : m_config.m_vmtf_stable_restart; }
+        bool update_mode();
+        void bump_vmtf();
+        bool is_decision_candidate(bool_var v) const { return value(v) == l_undef && !was_eliminated(v); }
         void update_activity(bool_var v, double p);
         bool reached_max_conflicts();
         void sort_watch_lits();
@@ -806,6 +824,8 @@ namespace sat {
             unsigned & act = m_activity[v];
             act += m_activity_inc;
             m_case_split_queue.activity_increased_eh(v);
+            if (m_focused)
+                m_vmtf_bumped.push_back(v);
             if (act > (1 << 24))
                 rescale_activity();
         }
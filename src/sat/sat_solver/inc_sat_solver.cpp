@@ -418,6 +418,56 @@ public:
         return result;
     }
 
+    void get_lemmas(unsigned max_size, expr_ref_vector& lemmas) override {
+        expr_ref_vector lit2expr(m);
+        lit2expr.resize(m_solver.num_vars() * 2);
+        m_map.mk_inv(lit2expr);
+        // theory atoms created during search are only known to the euf solver.
+        auto* ext = dynamic_cast<euf::solver*>(m_solver.get_extension());
+        if (ext) {
+            for (sat::bool_var v = 0; v < m_solver.num_vars(); ++v) {
+                sat::literal lit(v, false);
+                if (!lit2expr.get(lit.index()) && ext->bool_var2expr(v)) {
+                    lit2expr[lit.index()] = ext->literal2expr(lit);
+                    lit2expr[(~lit).index()] = ext->literal2expr(~lit);
+                }
+            }
+        }
+        expr_ref_vector lits(m);
+        auto add_lemma = [&](unsigned n, sat::literal const* clause) {
+            lits.reset();
+            for (unsigned i = 0; i < n; ++i) {
+                expr* e = lit2expr.get(clause[i].index());
+                if (!e || m_solver.was_eliminated(clause[i].var()))
+                    return;
+                lits.push_back(e);
+            }
+            lemmas.push_back(mk_or(lits));
+        };
+        for (sat::clause* c : m_solver.learned())
+            if (c->size() <= max_size && !c->was_removed())
+                add_lemma(c->size(), c->begin());
+        if (max_size >= 2) {
+            for (unsigned l_idx = 0; l_idx < 2 * m_solver.num_vars(); ++l_idx) {
+                sat::literal l1 = ~sat::to_literal(l_idx);
+                for (sat::watched const& w : m_solver.get_wlist(~l1)) {
+                    // every binary clause is watched by both literals.
+                    if (!w.is_binary_learned_clause() || l1.index() > w.get_literal().index())
+                        continue;
+                    sat::literal lits2[2] = { l1, w.get_literal() };
+                    add_lemma(2, lits2);
+                }
+            }
+        }
+        if (!ext || m_solver.scope_lvl() > 0)
+            return;
+        for (euf::enode* n : ext->get_egraph().nodes()) {
+            euf::enode* r = n->get_root();
+            if (n != r && !m.is_bool(n->get_expr()))
+                lemmas.push_back(m.mk_eq(n->get_expr(), r->get_expr()));
+        }
+    }
+
     proof * get_proof_core() override {
         return nullptr;
     }
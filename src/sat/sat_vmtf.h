@@ -0,0 +1,116 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_vmtf.h
+
+Abstract:
+
+    Variable move-to-front decision queue.
+
+    Variables are kept in a doubly linked list ordered by the time they were
+    last bumped. Bumping moves a variable to the front of the list. The search
+    pointer satisfies the invariant that every variable bumped more recently
+    than the search pointer is assigned, so selecting the next decision only
+    walks over variables that were assigned since the last unassignment.
+
+--*/
+#pragma once
+
+#include "sat/sat_types.h"
+
+namespace sat {
+
+    class vmtf_queue {
+        struct link {
+            bool_var m_prev = null_bool_var;
+            bool_var m_next = null_bool_var;
+        };
+        svector<link>     m_links;
+        svector<uint64_t> m_stamp;        // 0 if the variable is not in the queue
+        uint64_t          m_num_stamps = 0;
+        bool_var          m_first = null_bool_var;   // least recently bumped
+        bool_var          m_last = null_bool_var;    // most recently bumped
+        bool_var          m_search = null_bool_var;
+
+        void dequeue(bool_var v) {
+            link& l = m_links[v];
+            if (l.m_prev == null_bool_var) m_first = l.m_next; else m_links[l.m_prev].m_next = l.m_next;
+            if (l.m_next == null_bool_var) m_last = l.m_prev; else m_links[l.m_next].m_prev = l.m_prev;
+            if (m_search == v)
+                m_search = l.m_prev != null_bool_var ? l.m_prev : l.m_next;
+            l.m_prev = l.m_next = null_bool_var;
+        }
+
+        void enqueue(bool_var v) {
+            link& l = m_links[v];
+            l.m_prev = m_last;
+            l.m_next = null_bool_var;
+            if (m_last == null_bool_var) m_first = v; else m_links[m_last].m_next = v;
+            m_last = v;
+            m_stamp[v] = ++m_num_stamps;
+        }
+
+    public:
+
+        bool contains(bool_var v) const { return v < m_stamp.size() && m_stamp[v] != 0; }
+
+        uint64_t stamp(bool_var v) const { return m_stamp[v]; }
+
+        /**
+           \brief insert v as the most recently bumped variable.
+         */
+        void mk_var(bool_var v) {
+            if (v >= m_links.size()) {
+                m_links.resize(v + 1);
+                m_stamp.resize(v + 1, 0);
+            }
+            if (contains(v))
+                dequeue(v);
+            enqueue(v);
+            m_search = v;
+        }
+
+        void del_var(bool_var v) {
+            if (!contains(v))
+                return;
+            dequeue(v);
+            m_stamp[v] = 0;
+        }
+
+        void bump(bool_var v, bool is_unassigned) {
+            if (!contains(v))
+                return;
+            if (v != m_last) {
+                dequeue(v);
+                enqueue(v);
+            }
+            if (is_unassigned)
+                m_search = v;
+        }
+
+        void unassign(bool_var v) {
+            if (contains(v) && (m_search == null_bool_var || m_stamp[v] > m_stamp[m_search]))
+                m_search = v;
+        }
+
+        /**
+           \brief the most recently bumped variable for which is_available holds,
+           null_bool_var if there is none.
+         */
+        template<typename P>
+        bool_var next(P const& is_available) {
+            while (m_search != null_bool_var && !is_available(m_search))
+                m_search = m_links[m_search].m_prev;
+            return m_search;
+        }
+
+        void reset() {
+            m_links.reset();
+            m_stamp.reset();
+            m_num_stamps = 0;
+            m_first = m_last = m_search = null_bool_var;
+        }
+    };
+}
@@ -31,6 +31,9 @@ namespace sat {
        4) A external constraint-idx: for external constraints.
 
        For binary clauses: we use a bit to store whether the binary clause was learned or not.
+
+       For clauses, the blocked literal is a literal of the clause other than the watched one.
+       Propagation only dereferences the clause when the blocked literal is not true.
        
        Remark: there are no clause objects for binary clauses.
     */
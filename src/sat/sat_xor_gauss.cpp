@@ -0,0 +1,182 @@
+/*++
+  Copyright (c) 2024 Microsoft Corporation
+
+  Module Name:
+
+   sat_xor_gauss.cpp
+
+  Abstract:
+
+    Gauss-Jordan elimination of xor constraints.
+
+  --*/
+
+#include "util/stopwatch.h"
+#include "math/simplex/bit_matrix.h"
+#include "sat/sat_xor_gauss.h"
+#include "sat/sat_xor_finder.h"
+#include "sat/sat_elim_eqs.h"
+
+namespace sat {
+
+    struct xor_gauss::report {
+        xor_gauss& g;
+        stopwatch  m_watch;
+        report(xor_gauss& g): g(g) { m_watch.start(); }
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(2,
+                       verbose_stream() << " (sat.gauss"
+                       << " :xors " << g.m_stats.m_num_xors
+                       << " :components " << g.m_stats.m_num_components
+                       << " :units " << g.m_stats.m_num_units
+                       << " :eqs " << g.m_stats.m_num_eqs
+                       << m_watch << ")\n");
+        }
+    };
+
+    void xor_gauss::operator()() {
+        if (s.inconsistent())
+            return;
+        report _report(*this);
+        extract_xors();
+        if (m_xors.empty())
+            return;
+
+        // partition the xors into components of shared variables.
+        union_find_default_ctx ctx;
+        union_find<> vars(ctx);
+        unsigned num_vars = s.num_vars();
+        for (unsigned v = 0; v < num_vars; ++v)
+            vars.mk_var();
+        for (auto const& x : m_xors)
+            for (unsigned i = 1; i < x.size(); ++i)
+                vars.merge(x[0].var(), x[i].var());
+        unsigned_vector root2comp(num_vars, UINT_MAX);
+        vector<unsigned_vector> components;
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            unsigned r = vars.find(m_xors[i][0].var());
+            if (root2comp[r] == UINT_MAX) {
+                root2comp[r] = components.size();
+                components.push_back(unsigned_vector());
+            }
+            components[root2comp[r]].push_back(i);
+        }
+
+        union_find_default_ctx ctx2;
+        union_find<> eqs(ctx2);
+        for (unsigned i = 2 * num_vars; i-- > 0; )
+            eqs.mk_var();
+        m_col.reset();
+        m_col.resize(num_vars, UINT_MAX);
+        unsigned num_eqs = m_stats.m_num_eqs;
+        for (auto const& component : components) {
+            if (s.inconsistent())
+                break;
+            if (component.size() > m_max_xors) {
+                ++m_stats.m_num_skipped;
+                continue;
+            }
+            ++m_stats.m_num_components;
+            solve(component, eqs);
+        }
+        if (!s.inconsistent() && num_eqs < m_stats.m_num_eqs) {
+            elim_eqs elim(s);
+            elim(eqs);
+        }
+    }
+
+    /**
+       \brief extract xor constraints from the irredundant clauses.
+       An extracted xor x1, .., xn encodes that an odd number of its literals is true.
+     */
+    void xor_gauss::extract_xors() {
+        m_xors.reset();
+        std::function<void(literal_vector const&)> f = [&](literal_vector const& x) {
+            m_xors.push_back(x);
+        };
+        clause_vector clauses(s.clauses());
+        xor_finder xf(s);
+        xf.set(f);
+        xf(clauses);
+        m_stats.m_num_xors += m_xors.size();
+    }
+
+    /**
+       \brief solve the xors in component.
+       Column i of the matrix corresponds to the unassigned variable m_vars[i],
+       the last column is the right-hand side.
+     */
+    void xor_gauss::solve(unsigned_vector const& component, union_find<>& eqs) {
+        m_vars.reset();
+        for (unsigned i : component) {
+            for (literal lit : m_xors[i]) {
+                bool_var v = lit.var();
+                if (s.value(v) == l_undef && m_col[v] == UINT_MAX) {
+                    m_col[v] = m_vars.size();
+                    m_vars.push_back(v);
+                }
+            }
+        }
+        unsigned rhs = m_vars.size();
+        bit_matrix bm;
+        bm.reset(rhs + 1);
+        for (unsigned i : component) {
+            auto r = bm.add_row();
+            bool parity = true;
+            for (literal lit : m_xors[i]) {
+                bool_var v = lit.var();
+                parity ^= lit.sign();
+                if (s.value(v) == l_undef)
+                    r.set(m_col[v], !r[m_col[v]]);
+                else
+                    parity ^= s.value(v) == l_true;
+            }
+            r.set(rhs, parity);
+        }
+        bm.solve();
+
+        for (auto const& r : bm) {
+            unsigned cols[2];
+            unsigned n = 0;
+            for (unsigned c : r) {
+                if (c == rhs || n == 3)
+                    break;
+                if (n < 2)
+                    cols[n] = c;
+                ++n;
+            }
+            bool parity = r[rhs];
+            if (n == 0 && parity) {
+                IF_VERBOSE(2, verbose_stream() << "(sat.gauss :conflict)\n");
+                s.set_conflict();
+                break;
+            }
+            else if (n == 1) {
+                literal lit(m_vars[cols[0]], !parity);
+                TRACE("sat_gauss", tout << "unit " << lit << "\n";);
+                s.assign_unit(lit);
+                ++m_stats.m_num_units;
+            }
+            else if (n == 2) {
+                // x + y = parity
+                literal x(m_vars[cols[0]], false);
+                literal y(m_vars[cols[1]], parity);
+                TRACE("sat_gauss", tout << "equivalence " << x << " == " << y << "\n";);
+                eqs.merge(x.index(), y.index());
+                eqs.merge((~x).index(), (~y).index());
+                ++m_stats.m_num_eqs;
+            }
+        }
+        for (bool_var v : m_vars)
+            m_col[v] = UINT_MAX;
+    }
+
+    void xor_gauss::collect_statistics(statistics& st) const {
+        st.update("sat gauss xors", m_stats.m_num_xors);
+        st.update("sat gauss components", m_stats.m_num_components);
+        st.update("sat gauss skipped components", m_stats.m_num_skipped);
+        st.update("sat gauss units", m_stats.m_num_units);
+        st.update("sat gauss eqs", m_stats.m_num_eqs);
+    }
+}
@@ -0,0 +1,56 @@
+/*++
+  Copyright (c) 2024 Microsoft Corporation
+
+  Module Name:
+
+   sat_xor_gauss.h
+
+  Abstract:
+
+    Gauss-Jordan elimination of xor constraints.
+
+    Xors are extracted from clauses and split into connected
+    components that share variables. Each component is solved
+    over GF(2) in a word-packed bit_matrix. Rows of the reduced
+    matrix with no variables, one variable or two variables
+    yield conflicts, units and equivalences.
+
+  --*/
+#pragma once
+
+#include "util/statistics.h"
+#include "util/union_find.h"
+#include "sat/sat_types.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    class xor_gauss {
+        struct report;
+
+        struct stats {
+            unsigned m_num_xors = 0;
+            unsigned m_num_components = 0;
+            unsigned m_num_skipped = 0;
+            unsigned m_num_units = 0;
+            unsigned m_num_eqs = 0;
+        };
+
+        solver&          s;
+        unsigned         m_max_xors;
+        stats            m_stats;
+        vector<literal_vector> m_xors;
+        unsigned_vector  m_col;         // variable -> column in the current component
+        bool_var_vector  m_vars;        // column -> variable
+
+        void extract_xors();
+        void solve(unsigned_vector const& component, union_find<>& eqs);
+
+    public:
+        xor_gauss(solver& s, unsigned max_xors): s(s), m_max_xors(max_xors) {}
+
+        void operator()();
+
+        void collect_statistics(statistics& st) const;
+    };
+}
@@ -106,7 +106,7 @@ namespace arith {
             solver& m_imp;
         public:
             resource_limit(solver& i) : m_imp(i) { }
-            bool get_cancel_flag() override { return !m_imp.m.inc(); }
+            bool get_cancel_flag() override { return !m_imp.m.limit().tick(); }
         };
 
         struct var_value_eq {
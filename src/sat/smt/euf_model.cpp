@@ -130,10 +130,23 @@ namespace euf {
             n->mark1();
             deps.insert(n, nullptr);
         }
+        // group the candidate roots by sort once, instead of scanning
+        // all nodes for every fresh value.
+        obj_map<sort, unsigned> sort2idx;
+        vector<ptr_vector<enode>> roots_of_sort;
         for (enode* n : fresh_values)
+            if (!sort2idx.contains(n->get_sort())) {
+                sort2idx.insert(n->get_sort(), roots_of_sort.size());
+                roots_of_sort.push_back(ptr_vector<enode>());
+            }
+        unsigned idx = 0;
+        if (!fresh_values.empty())
             for (enode* r : m_egraph.nodes())
-                if (r->is_root() && r->get_sort() == n->get_sort() && !r->is_marked1())
-                    deps.add(n, r);
+                if (r->is_root() && !r->is_marked1() && sort2idx.find(r->get_sort(), idx))
+                    roots_of_sort[idx].push_back(r);
+        for (enode* n : fresh_values)
+            for (enode* r : roots_of_sort[sort2idx[n->get_sort()]])
+                deps.add(n, r);
         for (enode* n : fresh_values)
             n->unmark1();
         
@@ -34,8 +34,12 @@ namespace intblast {
         bv(m),
         a(m),
         trail(ctx),
-        m_translator(m, trail)
-    {}
+        m_translator(m, trail),
+        m_wraps(m)
+    {
+        m_lazy_mod = ctx.get_config().m_bv_intblast_lazy_mod;
+        m_translator.set_lazy_mod(m_lazy_mod);
+    }
 
     euf::theory_var solver::mk_var(euf::enode* n) {
         auto r = euf::th_euf_solver::mk_var(n);
@@ -124,15 +128,94 @@ namespace intblast {
             expr* e = preds[m_preds_qhead];
             expr_ref r(m_translator.translated(e), m);
             ctx.get_rewriter()(r);
+            ptr_vector<expr> wraps;
+            if (m_lazy_mod)
+                collect_wraps(r, wraps);
             auto a = expr2literal(e);
             auto b = mk_literal(r);
             ctx.mark_relevant(b);
 //            verbose_stream() << "add-predicate-axiom: " << mk_pp(e, m) << " == " << r << "\n";
             add_equiv(a, b);
+            for (expr* w : wraps)
+                add_wrap(w);
         }
         return true;
     }
 
+    void solver::collect_wraps(expr* r, ptr_vector<expr>& wraps) {
+        ptr_vector<expr> todo;
+        ast_fast_mark1 visited;
+        todo.push_back(r);
+        visited.mark(r);
+        while (!todo.empty()) {
+            expr* e = todo.back();
+            todo.pop_back();
+            if (!is_app(e) || expr2enode(e))
+                continue;
+            expr* x;
+            rational N;
+            if (m_translator.is_wrap(e, x, N))
+                wraps.push_back(e);
+            for (expr* arg : *to_app(e))
+                if (!visited.is_marked(arg)) {
+                    visited.mark(arg);
+                    todo.push_back(arg);
+                }
+        }
+    }
+
+    void solver::add_wrap(expr* w) {
+        expr* x;
+        rational N;
+        VERIFY(m_translator.is_wrap(w, x, N));
+        m_wraps.push_back(w);
+        ctx.push(push_back_vector(m_wraps));
+        auto lo = ctx.mk_literal(a.mk_ge(w, a.mk_int(0)));
+        auto hi = ctx.mk_literal(a.mk_le(w, a.mk_int(N - 1)));
+        ctx.mark_relevant(lo);
+        ctx.mark_relevant(hi);
+        add_unit(lo);
+        add_unit(hi);
+    }
+
+    /**
+     * Ensure that wrap(x) = x mod N in the current model.
+     * If x is in range the cheaper axiom 0 <= x < N => wrap(x) = x is added.
+     */
+    bool solver::refine_wraps() {
+        arith::arith_value av(ctx);
+        bool refined = false;
+        for (expr* w : m_wraps) {
+            expr* x = nullptr;
+            rational N, vx, vw;
+            VERIFY(m_translator.is_wrap(w, x, N));
+            if (av.get_value(x, vx) && av.get_value(w, vw)) {
+                if (vw == mod(vx, N))
+                    continue;
+                if (vx >= 0 && vx < N) {
+                    auto lo = ctx.mk_literal(a.mk_ge(x, a.mk_int(0)));
+                    auto hi = ctx.mk_literal(a.mk_le(x, a.mk_int(N - 1)));
+                    auto eq = eq_internalize(w, x);
+                    ctx.mark_relevant(lo);
+                    ctx.mark_relevant(hi);
+                    ctx.mark_relevant(eq);
+                    add_clause(~lo, ~hi, eq);
+                    refined = true;
+                    continue;
+                }
+            }
+            expr_ref xModN(a.mk_mod(x, a.mk_int(N)), m);
+            ctx.internalize(xModN);
+            if (expr2enode(w)->get_root() == expr2enode(xModN)->get_root())
+                continue;
+            auto eq = eq_internalize(w, xModN);
+            ctx.mark_relevant(eq);
+            add_unit(eq);
+            refined = true;
+        }
+        return refined;
+    }
+
     bool solver::unit_propagate() {
         return add_bound_axioms() || add_predicate_axioms();
     }    
@@ -415,6 +498,8 @@ namespace intblast {
                 return sat::check_result::CR_CONTINUE;
             }
         }
+        if (refine_wraps())
+            return sat::check_result::CR_CONTINUE;
         return sat::check_result::CR_DONE; 
     }
 
@@ -80,8 +80,14 @@ namespace intblast {
 
 
 
+        bool m_lazy_mod = false;
+        expr_ref_vector m_wraps;        // wrap terms in internalized predicates
+
         bool add_bound_axioms();
         bool add_predicate_axioms();
+        void collect_wraps(expr* r, ptr_vector<expr>& wraps);
+        void add_wrap(expr* w);
+        bool refine_wraps();
 
         euf::theory_var mk_var(euf::enode* n) override;
 
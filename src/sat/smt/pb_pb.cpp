@@ -132,6 +132,11 @@ namespace pb {
         VERIFY(lit() == sat::null_literal || s.value(lit()) == l_true);
         unsigned sz = size(), bound = k();
 
+        // watch the heaviest literals first, so fewer watches cover the bound.
+        // The partition below keeps the order of the non-false literals.
+        if (s.get_config().m_pb_sort_watch)
+            std::stable_sort(m_wlits, m_wlits + sz, [](wliteral const& a, wliteral const& b) { return a.first > b.first; });
+
         // put the non-false literals into the head.
         unsigned slack = 0, slack1 = 0, num_watch = 0, j = 0;
         for (unsigned i = 0; i < sz; ++i) {
@@ -3080,6 +3080,14 @@ namespace q {
 
         enode *                     m_root = nullptr;  // temp field
         enode *                     m_other = nullptr; // temp field
+
+        // parents of m_root grouped by label hash, built on demand during on_merge.
+        // Candidate collection for a path tree whose filter has a single label hash
+        // only visits the parents in the matching group.
+        enode *                     m_bucket_root = nullptr;
+        enode_vector                m_bucket_parents;
+        unsigned                    m_bucket_begin[APPROX_SET_CAPACITY + 1];
+        static const unsigned       m_min_bucket_parents = 32;
         bool                        m_check_missing_instances = false;        
 
         enode_vector * mk_tmp_vector() {
@@ -3458,6 +3466,25 @@ namespace q {
                 (n2->get_root() == m_other && n1->get_root() == m_root);
         }
 
+        void bucket_parents(enode * r) {
+            m_bucket_root = r;
+            for (unsigned & b : m_bucket_begin)
+                b = 0;
+            for (enode * p : euf::enode_parents(r))
+                if (!p->is_equality())
+                    ++m_bucket_begin[m_lbl_hasher(p->get_decl()) + 1];
+            for (unsigned h = 0; h < APPROX_SET_CAPACITY; ++h)
+                m_bucket_begin[h + 1] += m_bucket_begin[h];
+            m_bucket_parents.reset();
+            m_bucket_parents.resize(m_bucket_begin[APPROX_SET_CAPACITY], nullptr);
+            unsigned pos[APPROX_SET_CAPACITY];
+            for (unsigned h = 0; h < APPROX_SET_CAPACITY; ++h)
+                pos[h] = m_bucket_begin[h];
+            for (enode * p : euf::enode_parents(r))
+                if (!p->is_equality())
+                    m_bucket_parents[pos[m_lbl_hasher(p->get_decl())]++] = p;
+        }
+
         /**
            \brief Collect new E-matching candidates using the inverted path index t.
         */
@@ -3529,7 +3556,17 @@ namespace q {
 #endif
 
                     TRACE("mam_path_tree", tout << "processing: #" << curr_child->get_expr_id() << "\n";);
-                    for (enode* curr_parent : euf::enode_parents(curr_child)) {
+                    enode * const * parents_begin = euf::enode_parents(curr_child).begin();
+                    enode * const * parents_end   = euf::enode_parents(curr_child).end();
+                    if (curr_child == m_root && filter.size() == 1 && curr_child->num_parents() >= m_min_bucket_parents) {
+                        if (m_bucket_root != curr_child)
+                            bucket_parents(curr_child);
+                        unsigned h = *filter.begin();
+                        parents_begin = m_bucket_parents.data() + m_bucket_begin[h];
+                        parents_end   = m_bucket_parents.data() + m_bucket_begin[h + 1];
+                    }
+                    for (enode * const * it = parents_begin; it != parents_end; ++it) {
+                        enode * curr_parent = *it;
 #ifdef _PROFILE_PATH_TREE
                         if (curr_parent->is_equality())
                             t->m_num_eq_visited++;
@@ -3853,6 +3890,7 @@ namespace q {
         void on_merge(enode * root, enode * other) override {            
             flet<enode *> l1(m_other, other);
             flet<enode *> l2(m_root, root);
+            m_bucket_root = nullptr;
 
             TRACE("mam", tout << "on_merge: #" << other->get_expr_id() << " #" << root->get_expr_id() << "\n";);
             TRACE("mam_inc_bug_detail", m_egraph.display(tout););
@@ -76,6 +76,8 @@ struct goal2sat::imp : public sat::sat_internalizer {
     bool                        m_default_external;
     bool                        m_euf = false;
     bool                        m_top_level = false;
+    bool                        m_streaming = false;
+    unsigned                    m_sweep_size = 0;
     sat::literal_vector         aig_lits;
     
     imp(ast_manager & _m, params_ref const & p, sat::solver_core & s, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external):
@@ -100,6 +102,7 @@ struct goal2sat::imp : public sat::sat_internalizer {
         m_ite_extra  = p.get_bool("ite_extra", true);
         m_max_memory = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
         m_euf = sp.euf() || sp.smt();
+        m_streaming = sp.cnf_streaming();
     }
 
     void throw_op_not_handled(std::string const& s) {
@@ -944,7 +947,52 @@ struct goal2sat::imp : public sat::sat_internalizer {
     }
 
 
+    /**
+       \brief remove cached definitions of subformulas that are only referenced by the cache.
+       No formula that remains to be converted contains them. Releasing a cached formula
+       can release the cached subformulas it contains, so the sweep is repeated until
+       nothing changes. Sweeps start when the cache has doubled since the last sweep.
+    */
+    void sweep_cache() {
+        if (m_cache_trail.size() < 2 * m_sweep_size + 1024)
+            return;
+        unsigned lim = m_cache_lim.empty() ? 0 : m_cache_lim.back();
+        bool change = true;
+        while (change) {
+            change = false;
+            unsigned j = lim;
+            for (unsigned i = lim; i < m_cache_trail.size(); ++i) {
+                app* t = m_cache_trail.get(i);
+                if (t->get_ref_count() == 1) {
+                    sat::literal lit;
+                    if (m_app2lit.find(t, lit)) {
+                        m_app2lit.remove(t);
+                        m_lit2app.remove(lit.index());
+                    }
+                    change = true;
+                }
+                else 
+                    m_cache_trail.set(j++, t);
+            }
+            m_cache_trail.shrink(j);
+        }
+        m_sweep_size = m_cache_trail.size();
+    }
+
     void operator()(goal const & g) {
+        convert(g, nullptr);
+    }
+
+    void operator()(goal & g) {
+        bool stream = m_streaming && !m_euf && !g.proofs_enabled();
+        convert(g, stream ? &g : nullptr);
+    }
+
+    /**
+       \brief convert the formulas of g. 
+       When the goal is passed as \c consume, each formula is replaced by true after it is converted.
+    */
+    void convert(goal const & g, goal* consume) {
         scoped_reset _reset(*this);
         collect_boolean_interface(g, m_interface_vars);
         unsigned size = g.size();
@@ -983,7 +1031,11 @@ struct goal2sat::imp : public sat::sat_internalizer {
             TRACE("goal2sat", tout << mk_bounded_pp(f, m, 2) << "\n";);
             process(f);
         skip_dep:
-            ;
+            if (consume) {
+                consume->update(idx, m.mk_true(), nullptr, nullptr);
+                f = nullptr;
+                sweep_cache();
+            }
         }
     }
 
@@ -1071,6 +1123,11 @@ void goal2sat::operator()(goal const & g, params_ref const & p, sat::solver_core
     (*m_imp)(g);    
 }
 
+void goal2sat::operator()(goal & g, params_ref const & p, sat::solver_core & t, atom2bool_var & m, dep2asm_map& dep2asm, bool default_external) {
+    init(g.m(), p, t, m, dep2asm, default_external);
+    (*m_imp)(g);    
+}
+
 void goal2sat::operator()(unsigned n, expr* const* fmls) {
     SASSERT(m_imp);
     (*m_imp)(n, fmls);
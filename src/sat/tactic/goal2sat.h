@@ -67,6 +67,13 @@ public:
     */
     void operator()(goal const & g, params_ref const & p, sat::solver_core & t, atom2bool_var & m, dep2asm_map& dep2asm, bool default_external = false);
 
+    /**
+       \brief "Compile" the goal into the given sat solver.
+       With sat.cnf.streaming the formulas of g are replaced by true as they are converted,
+       so the memory they use can be released during the conversion.
+    */
+    void operator()(goal & g, params_ref const & p, sat::solver_core & t, atom2bool_var & m, dep2asm_map& dep2asm, bool default_external = false);
+
     void operator()(unsigned n, expr* const* fmls);
 
     void init(ast_manager& m, params_ref const & p, sat::solver_core & t, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external);
@@ -65,6 +65,10 @@ class sat_tactic : public tactic {
             atom2bool_var map(m);
             obj_map<expr, sat::literal> dep2asm;
             sat::literal_vector assumptions;
+            expr_ref_vector fmls_to_validate(m);
+            if (gparams::get_ref().get_bool("model_validate", false)) 
+                for (unsigned i = 0; i < g->size(); ++i) 
+                    fmls_to_validate.push_back(g->form(i));
             m_goal2sat(*g, m_params, *m_solver, map, dep2asm);
             TRACE("sat", tout << "interpreted_atoms: " << m_goal2sat.has_interpreted_funs() << "\n";
                   func_decl_ref_vector funs(m);
@@ -73,11 +77,6 @@ class sat_tactic : public tactic {
                       tout << mk_ismt2_pp(f, m) << "\n";
                   );
 
-            expr_ref_vector fmls_to_validate(m);
-            if (gparams::get_ref().get_bool("model_validate", false)) 
-                for (unsigned i = 0; i < g->size(); ++i) 
-                    fmls_to_validate.push_back(g->form(i));
-
             g->reset();
             g->m().compact_memory();
 
@@ -18,6 +18,8 @@ Revision History:
 
 --*/
 #include<iostream>
+#include<string>
+#include<vector>
 #include "util/memory_manager.h"
 #include "util/trace.h"
 #include "util/debug.h"
@@ -52,6 +54,21 @@ static input_kind   g_input_kind          = IN_UNSPECIFIED;
 bool                g_display_statistics  = false;
 bool                g_display_model       = false;
 static bool         g_display_istatistics = false;
+static bool         g_server              = false;
+static char const * g_server_socket       = nullptr;
+static std::vector<std::pair<std::string, std::string>> g_cmd_line_params;
+
+static void set_param(char const * key, char const * value) {
+    gparams::set(key, value);
+    g_cmd_line_params.push_back({ key, value });
+}
+
+static void reset_params() {
+    gparams::reset();
+    for (auto const & [k, v] : g_cmd_line_params)
+        gparams::set(k.c_str(), v.c_str());
+    env_params::updt_params();
+}
 
 static void error(const char * msg) {
     std::cerr << "Error: " << msg << "\n";
@@ -85,6 +102,7 @@ void display_usage() {
     std::cout << "  -lp         use parser for a modest subset of CPLEX LP input format.\n";
     std::cout << "  -log        use parser for Z3 log input format.\n";
     std::cout << "  -in         read formula from standard input.\n";
+    std::cout << "  -server[:socket]  answer SMT2 requests on a Unix socket, or on standard input/output.\n";
     std::cout << "  -model      display model for satisfiable SMT.\n";
     std::cout << "\nMiscellaneous:\n";
     std::cout << "  -h, -?      prints this message.\n";
@@ -192,6 +210,10 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             else if (strcmp(opt_name, "in") == 0) {
                 g_standard_input = true;
             }
+            else if (strcmp(opt_name, "server") == 0) {
+                g_server = true;
+                g_server_socket = opt_arg;
+            }
             else if (strcmp(opt_name, "dimacs") == 0) {
                 g_input_kind = IN_DIMACS;
             }
@@ -209,7 +231,7 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             }
             else if (strcmp(opt_name, "st") == 0) {
                 g_display_statistics = true; 
-                gparams::set("stats", "true");
+                set_param("stats", "true");
             }
             else if (strcmp(opt_name, "model") == 0) {
                 g_display_model = true;
@@ -234,7 +256,7 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             else if (strcmp(opt_name, "t") == 0) {
                 if (!opt_arg)
                     error("option argument (-t:timeout) is missing.");
-                gparams::set("timeout", opt_arg);
+                set_param("timeout", opt_arg);
             }
             else if (strcmp(opt_name, "nw") == 0) {
                 enable_warning_messages(false);
@@ -287,7 +309,7 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             else if (strcmp(opt_name, "memory") == 0) {
                 if (!opt_arg)
                     error("option argument (-memory:val) is missing.");
-                gparams::set("memory_max_size", opt_arg);
+                set_param("memory_max_size", opt_arg);
             }
             else if (strcmp(opt_name, "tactics") == 0) {
                 if (!opt_arg)
@@ -315,7 +337,7 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             char * key   = argv[i];
             *eq_pos      = 0;
             char * value = eq_pos+1; 
-            gparams::set(key, value);
+            set_param(key, value);
         }
         else {
             if (get_extension(arg) && strcmp(get_extension(arg), "drat") == 0) {
@@ -344,6 +366,12 @@ int STD_CALL main(int argc, char ** argv) {
         parse_cmd_line_args(input_file, argc, argv);
         env_params::updt_params();
 
+        if (g_server) {
+            return_value = serve_smtlib2_commands(g_server_socket, reset_params);
+            disable_timeout();
+            memory::finalize();
+            return return_value;
+        }
         if (g_input_file && g_standard_input) {
             error("using standard input to read formula.");
         }
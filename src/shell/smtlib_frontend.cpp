@@ -19,10 +19,20 @@ Revision History:
 
 --*/
 #include<iostream>
+#include<sstream>
+#include<cstdio>
 #include<time.h>
 #include<signal.h>
+#ifndef _WINDOWS
+#include<unistd.h>
+#include<sys/socket.h>
+#include<sys/un.h>
+#endif
 #include "util/timeout.h"
 #include "util/mutex.h"
+#include "util/event_trace.h"
+#include "util/profile.h"
+#include "util/gparams.h"
 #include "parsers/smt2/smt2parser.h"
 #include "muz/fp/dl_cmds.h"
 #include "cmd_context/extra_cmds/dbg_cmds.h"
@@ -61,14 +71,36 @@ static void display_model() {
     }
 }
 
+static void display_event_trace() {
+    if (event_trace::enabled())
+        event_trace::dump(std::cerr);
+}
+
+static void write_profile() {
+    if (!profile::enabled())
+        return;
+    std::string file = gparams::get_value("profile_file");
+    if (file.empty())
+        return;
+    std::ofstream out(file);
+    if (out.bad() || out.fail()) {
+        std::cerr << "(error \"failed to open file '" << file << "'\")" << std::endl;
+        return;
+    }
+    profile::dump_folded(out);
+}
+
 static void on_timeout() {
     display_statistics();
+    display_event_trace();
+    write_profile();
     _Exit(0);
 }
 
 static void STD_CALL on_ctrl_c(int) {
     signal (SIGINT, SIG_DFL);
     display_statistics();
+    display_event_trace();
     raise(SIGINT);
 }
 
@@ -154,12 +186,7 @@ void help_probes() {
         std::cout << "- " << cmd->get_name() << " " << cmd->get_descr() << "\n";
 }
 
-unsigned read_smtlib2_commands(char const * file_name) {
-    g_start_time = clock();
-    register_on_timeout_proc(on_timeout);
-    signal(SIGINT, on_ctrl_c);
-    cmd_context ctx;
-
+static void install_cmds(cmd_context & ctx) {
     ctx.set_solver_factory(mk_smt_strategic_solver_factory());
     install_dl_cmds(ctx);
     install_dbg_cmds(ctx);
@@ -168,6 +195,15 @@ unsigned read_smtlib2_commands(char const * file_name) {
     install_opt_cmds(ctx);
     install_smt2_extra_cmds(ctx);
     install_proof_cmds(ctx);
+}
+
+unsigned read_smtlib2_commands(char const * file_name) {
+    g_start_time = clock();
+    register_on_timeout_proc(on_timeout);
+    signal(SIGINT, on_ctrl_c);
+    cmd_context ctx;
+
+    install_cmds(ctx);
 
     g_cmd_context = &ctx;
     signal(SIGINT, on_ctrl_c);
@@ -187,7 +223,97 @@ unsigned read_smtlib2_commands(char const * file_name) {
 
     display_statistics();
     display_model();
+    write_profile();
     g_cmd_context = nullptr;
     return result ? 0 : 1;
 }
 
+
+/**
+   \brief run one request in a fresh command context and return its output.
+*/
+static std::string run_request(std::string const & script, unsigned timeout, unsigned rlimit) {
+    std::ostringstream out;
+    try {
+        cmd_context ctx;
+        install_cmds(ctx);
+        ctx.set_regular_stream(out);
+        ctx.set_diagnostic_stream(out);
+        if (timeout != 0)
+            ctx.params().m_timeout = timeout;
+        if (rlimit != 0)
+            ctx.params().set_rlimit(rlimit);
+        std::istringstream in(script);
+        parse_smt2_commands(ctx, in);
+    }
+    catch (z3_exception & ex) {
+        out << "(error \"" << ex.what() << "\")\n";
+    }
+    return out.str();
+}
+
+/**
+   \brief serve the requests of one client until end of input.
+
+   A request is a header line "<length> [<timeout-ms> [<rlimit>]]" followed by
+   <length> bytes of SMT2 commands. The response is a line with the length
+   of the output followed by the output.
+*/
+static void serve_client(FILE * in, FILE * out, std::function<void()> const & reset_params) {
+    char header[256];
+    std::string script;
+    while (fgets(header, sizeof(header), in)) {
+        unsigned long length = 0, timeout = 0, rlimit = 0;
+        if (sscanf(header, "%lu %lu %lu", &length, &timeout, &rlimit) < 1)
+            break;
+        script.resize(length);
+        if (length > 0 && fread(&script[0], 1, length, in) != length)
+            break;
+        std::string result = run_request(script, static_cast<unsigned>(timeout), static_cast<unsigned>(rlimit));
+        // options set by the request must not leak into the next one.
+        reset_params();
+        fprintf(out, "%lu\n", static_cast<unsigned long>(result.size()));
+        fwrite(result.data(), 1, result.size(), out);
+        fflush(out);
+    }
+}
+
+unsigned serve_smtlib2_commands(char const * socket_path, std::function<void()> const & reset_params) {
+    if (!socket_path || !*socket_path) {
+        serve_client(stdin, stdout, reset_params);
+        return 0;
+    }
+#ifdef _WINDOWS
+    std::cerr << "(error \"socket server mode is not supported on this platform\")" << std::endl;
+    return ERR_CMD_LINE;
+#else
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        std::cerr << "(error \"socket path is too long\")" << std::endl;
+        return ERR_CMD_LINE;
+    }
+    strcpy(addr.sun_path, socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        std::cerr << "(error \"failed to listen on socket '" << socket_path << "'\")" << std::endl;
+        return ERR_OPEN_FILE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    while (true) {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0)
+            continue;
+        FILE * in = fdopen(client, "r");
+        FILE * out = fdopen(dup(client), "w");
+        if (in && out)
+            serve_client(in, out, reset_params);
+        if (in)
+            fclose(in);
+        if (out)
+            fclose(out);
+    }
+#endif
+}
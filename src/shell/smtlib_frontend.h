@@ -18,8 +18,18 @@ Revision History:
 --*/
 #pragma once
 
+#include <functional>
+
 unsigned read_smtlib_file(char const * benchmark_file);
 unsigned read_smtlib2_commands(char const * command_file);
+
+/**
+   \brief keep the process alive and answer SMT2 scripts sent over the Unix
+   socket socket_path, or over standard input and output if socket_path is empty.
+   Every script runs in a fresh command context; reset_params restores the
+   global parameters after each one.
+*/
+unsigned serve_smtlib2_commands(char const * socket_path, std::function<void()> const & reset_params);
 void help_tactics();
 void help_simplifiers();
 void help_probes();
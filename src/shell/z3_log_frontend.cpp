@@ -43,7 +43,7 @@ void replay_z3_log(char const * file_name) {
         solve(file_name, std::cin);
     }
     else {
-        std::ifstream in(file_name);
+        std::ifstream in(file_name, std::ios::in | std::ios::binary);
         if (in.bad() || in.fail()) {
             std::cerr << "Error: failed to open file \"" << file_name << "\".\n";
             exit(ERR_OPEN_FILE);
@@ -178,6 +178,7 @@ class dl_graph {
     
     vector<edge_id_vector>  m_out_edges;  // per var
     vector<edge_id_vector>  m_in_edges;   // per var
+    vector<edge_id_vector>  m_enabled_out_edges; // per var, enabled out edges in the order they were enabled
 
     struct scope {
         unsigned m_edges_lim;
@@ -384,12 +385,10 @@ private:
                 return false;
             }
             
-            for (edge_id e_id : m_out_edges[source]) {
+            for (edge_id e_id : m_enabled_out_edges[source]) {
                 edge & e     = m_edges[e_id];
                 SASSERT(e.get_source() == source);
-                if (!e.is_enabled()) {
-                    continue;
-                }
+                SASSERT(e.is_enabled());
                 set_gamma(e, gamma);
                 
                 if (gamma.is_neg()) {
@@ -478,6 +477,7 @@ public:
             m_assignment .push_back(numeral());
             m_out_edges  .push_back(edge_id_vector());
             m_in_edges   .push_back(edge_id_vector());
+            m_enabled_out_edges.push_back(edge_id_vector());
             m_gamma      .push_back(numeral());
             m_mark       .push_back(DL_UNMARKED);
             m_parent     .push_back(null_edge_id);
@@ -517,6 +517,7 @@ public:
         bool r = true;
         if (!e.is_enabled()) {
             e.enable(m_timestamp);
+            m_enabled_out_edges[e.get_source()].push_back(id);
             m_last_enabled_edge = id;
             m_timestamp++;
             if (!is_feasible(e)) {
@@ -876,7 +877,10 @@ public:
         scope & s              = m_trail_stack[new_lvl];
         for (unsigned i = m_enabled_edges.size(); i > s.m_enabled_edges_lim; ) {
             --i;
-            m_edges[m_enabled_edges[i]].disable();
+            edge & e = m_edges[m_enabled_edges[i]];
+            SASSERT(m_enabled_out_edges[e.get_source()].back() == m_enabled_edges[i]);
+            m_enabled_out_edges[e.get_source()].pop_back();
+            e.disable();
         }
         m_enabled_edges.shrink(s.m_enabled_edges_lim);
         unsigned old_num_edges = s.m_edges_lim;
@@ -1178,6 +1182,7 @@ public:
         m_edges             .reset();
         m_in_edges          .reset();
         m_out_edges         .reset();
+        m_enabled_out_edges .reset();
         m_trail_stack       .reset();
         m_gamma             .reset();
         m_mark              .reset();
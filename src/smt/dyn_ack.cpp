@@ -189,11 +189,13 @@ namespace smt {
         m_qhead = 0;
         m_num_instances = 0;
         m_num_propagations_since_last_gc = 0;
+        m_sketch.init(m_params.m_dack_sketch);
 
         m_triple.m_app2num_occs.reset();
         reset_app_triples();
         m_triple.m_to_instantiate.reset();
         m_triple.m_qhead = 0;
+        m_triple.m_sketch.init(m_params.m_dack_eq ? m_params.m_dack_sketch : 0);
     }
 
     void dyn_ack_manager::cg_eh(app * n1, app * n2) {
@@ -210,12 +212,20 @@ namespace smt {
             return;
         }
         unsigned num_occs = 0;
+        bool admitted = false;
         if (m_app_pair2num_occs.find(n1, n2, num_occs)) {
             TRACE("dyn_ack", tout << "used_cg_eh:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << num_occs << "\n";);
             num_occs++;
         }
         else {
             num_occs = 1;
+            if (m_sketch.enabled()) {
+                // the pair enters the exact table with its estimated number of occurrences.
+                num_occs = m_sketch.inc(hash_u_u(n1->get_id(), n2->get_id()));
+                if (num_occs < sketch_admit())
+                    return;
+                admitted = true;
+            }
             m.inc_ref(n1);
             m.inc_ref(n2);
             m_app_pairs.push_back(p);
@@ -226,7 +236,7 @@ namespace smt {
         unsigned num_occs2 = 0;
         SASSERT(m_app_pair2num_occs.find(n1, n2, num_occs2) && num_occs == num_occs2);
 #endif
-        if (num_occs == m_params.m_dack_threshold) {
+        if (num_occs == m_params.m_dack_threshold || (admitted && num_occs > m_params.m_dack_threshold)) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << num_occs << "\n";);
             m_to_instantiate.push_back(p);
         }
@@ -245,6 +255,7 @@ namespace smt {
             return;
         }
         unsigned num_occs = 0;
+        bool admitted = false;
         if (m_triple.m_app2num_occs.find(n1, n2, r, num_occs)) {
             TRACE("dyn_ack", tout << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\n"
                   << mk_pp(r, m) << "\n" << "\nnum_occs: " << num_occs << "\n";);
@@ -252,6 +263,12 @@ namespace smt {
         }
         else {
             num_occs = 1;
+            if (m_triple.m_sketch.enabled()) {
+                num_occs = m_triple.m_sketch.inc(combine_hash(hash_u_u(n1->get_id(), n2->get_id()), r->get_id()));
+                if (num_occs < sketch_admit())
+                    return;
+                admitted = true;
+            }
             m.inc_ref(n1);
             m.inc_ref(n2);
             m.inc_ref(r);
@@ -263,7 +280,7 @@ namespace smt {
         unsigned num_occs2 = 0;
         SASSERT(m_triple.m_app2num_occs.find(n1, n2, r, num_occs2) && num_occs == num_occs2);
 #endif
-        if (num_occs == m_params.m_dack_threshold) {
+        if (num_occs == m_params.m_dack_threshold || (admitted && num_occs > m_params.m_dack_threshold)) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) 
                   << "\n" << mk_pp(r, m) 
                   << "\nnum_occs: " << num_occs << "\n";);
@@ -296,6 +313,7 @@ namespace smt {
         TRACE("dyn_ack", tout << "dyn_ack GC\n";);
         m_to_instantiate.reset();
         m_qhead = 0;
+        m_sketch.decay(m_params.m_dack_gc_inv_decay);
         svector<app_pair>::iterator it  = m_app_pairs.begin();
         svector<app_pair>::iterator end = m_app_pairs.end();
         svector<app_pair>::iterator it2 = it;
@@ -373,10 +391,14 @@ namespace smt {
         if (m_params.m_dack == dyn_ack_strategy::DACK_DISABLED)
             return;
         m_num_propagations_since_last_gc++;
-        if (m_num_propagations_since_last_gc > m_params.m_dack_gc) {
+        if (m_num_propagations_since_last_gc > m_params.m_dack_gc ||
+            (m_sketch.enabled() && m_app_pairs.size() > m_sketch.width())) {
             gc();
             m_num_propagations_since_last_gc = 0;
         }
+        // with a sketch the number of exact counters for triples is bounded as well.
+        if (m_triple.m_sketch.enabled() && m_triple.m_apps.size() > m_triple.m_sketch.width())
+            gc_triples();
         unsigned max_instances  = static_cast<unsigned>(m_context.get_num_conflicts() * m_params.m_dack_factor);
         while (m_num_instances < max_instances && m_qhead < m_to_instantiate.size()) {
             app_pair & p = m_to_instantiate[m_qhead];
@@ -518,6 +540,7 @@ namespace smt {
         TRACE("dyn_ack", tout << "dyn_ack GC\n";);
         m_triple.m_to_instantiate.reset();
         m_triple.m_qhead = 0;
+        m_triple.m_sketch.decay(m_params.m_dack_gc_inv_decay);
         svector<app_triple>::iterator it  = m_triple.m_apps.begin();
         svector<app_triple>::iterator end = m_triple.m_apps.end();
         svector<app_triple>::iterator it2 = it;
@@ -29,6 +29,53 @@ namespace smt {
 
     class context;
 
+    /**
+       \brief Count-min sketch with conservative updates.
+       It over-approximates the number of occurrences of a key
+       using a fixed number of counters.
+    */
+    class dyn_ack_sketch {
+        static const unsigned num_rows = 4;
+        unsigned         m_log_width = 0;
+        unsigned_vector  m_counters;
+
+        unsigned idx(unsigned row, unsigned h) const {
+            return (row << m_log_width) | (hash_u_u(h, row) & ((1u << m_log_width) - 1));
+        }
+
+    public:
+        void init(unsigned log_width) {
+            m_log_width = log_width;
+            m_counters.reset();
+            if (log_width > 0)
+                m_counters.resize(num_rows << log_width, 0);
+        }
+
+        bool enabled() const { return m_log_width > 0; }
+
+        unsigned width() const { return 1u << m_log_width; }
+
+        /**
+           \brief increment the estimate of the key with hash h and return the new estimate.
+        */
+        unsigned inc(unsigned h) {
+            unsigned est = UINT_MAX;
+            for (unsigned r = 0; r < num_rows; ++r)
+                est = std::min(est, m_counters[idx(r, h)]);
+            for (unsigned r = 0; r < num_rows; ++r) {
+                unsigned & c = m_counters[idx(r, h)];
+                if (c == est)
+                    ++c;
+            }
+            return est + 1;
+        }
+
+        void decay(double f) {
+            for (unsigned & c : m_counters)
+                c = static_cast<unsigned>(c * f);
+        }
+    };
+
     class dyn_ack_manager {
         typedef std::pair<app *, app *>           app_pair;
         typedef obj_pair_map<app, app, unsigned>  app_pair2num_occs;
@@ -53,6 +100,7 @@ namespace smt {
         unsigned                                   m_num_propagations_since_last_gc;
         app_pair_set                               m_instantiated;
         clause2app_pair                            m_clause2app_pair;
+        dyn_ack_sketch                             m_sketch;
 
         struct _triple {
             app_triple2num_occs                    m_app2num_occs;
@@ -63,12 +111,14 @@ namespace smt {
             unsigned                               m_num_propagations_since_last_gc;
             app_triple_set                         m_instantiated;
             clause2app_triple                      m_clause2apps;
+            dyn_ack_sketch                         m_sketch;
         };
         _triple                                    m_triple;
         
 
 
         void gc();
+        unsigned sketch_admit() const { return std::max(1u, m_params.m_dack_threshold / 2); }
         void reset_app_pairs();
         friend class dyn_ack_clause_del_eh;
         void del_clause_eh(clause * cls);
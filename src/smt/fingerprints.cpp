@@ -20,16 +20,20 @@ Revision History:
 
 namespace smt {
 
-    fingerprint::fingerprint(region & r, void * d, unsigned d_h, expr* def, unsigned n, enode * const * args):
+    fingerprint::fingerprint(void * d, unsigned d_h, expr* def, unsigned n, enode * const * args):
         m_data(d), 
         m_data_hash(d_h),
         m_def(def),
         m_num_args(n), 
-        m_args(nullptr) {
-        m_args = new (r) enode*[n];
+        m_args(reinterpret_cast<enode**>(this + 1)) {
         memcpy(m_args, args, sizeof(enode*) * n);
     }
 
+    fingerprint * fingerprint::mk(region & r, void * d, unsigned d_h, expr* def, unsigned n, enode * const * args) {
+        void * mem = r.allocate(sizeof(fingerprint) + sizeof(enode*) * n);
+        return new (mem) fingerprint(d, d_h, def, n, args);
+    }
+
     bool fingerprint_set::fingerprint_eq_proc::operator()(fingerprint const * f1, fingerprint const * f2) const {
         if (f1->get_data() != f2->get_data()) 
             return false;
@@ -88,15 +92,17 @@ namespace smt {
             return nullptr;
         for (unsigned i = 0; i < num_args; i++)
             d->m_args[i] = d->m_args[i]->get_root();
-        if (m_set.contains(d)) {
+        // probe once: the entry holds the dummy until it is replaced by the new fingerprint.
+        set::entry * e = nullptr;
+        if (!m_set.insert_if_not_there_core(d, e)) {
             TRACE("fingerprint_bug", tout << "failed: " << *d;);
             return nullptr;
         }
         TRACE("fingerprint_bug", tout << "inserting @" << m_scopes.size() << " " << *d;);
-        fingerprint * f = new (m_region) fingerprint(m_region, data, data_hash, def, num_args, d->m_args);
+        fingerprint * f = fingerprint::mk(m_region, data, data_hash, def, num_args, d->m_args);
+        e->set_data(f);
         m_fingerprints.push_back(f);
         m_defs.push_back(def);
-        m_set.insert(f);
         return f;
     }
 
@@ -129,6 +135,12 @@ namespace smt {
         unsigned size     = m_fingerprints.size();
         if (old_size == 0 && size > 0) 
             m_set.reset();
+        else if (old_size < size - old_size) {
+            // rebuilding from the retained prefix is cheaper than erasing, and leaves no deleted entries.
+            m_set.reset();
+            for (unsigned i = 0; i < old_size; i++)
+                m_set.insert(m_fingerprints[i]);
+        }
         else {
             for (unsigned i = old_size; i < size; i++) 
                 m_set.erase(m_fingerprints[i]);
@@ -33,8 +33,12 @@ namespace smt {
 
         friend class fingerprint_set;
         fingerprint() = default;
+        fingerprint(void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
     public:
-        fingerprint(region & r, void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
+        /**
+           \brief allocate a fingerprint in r with its arguments stored inline after it.
+        */
+        static fingerprint * mk(region & r, void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
         void * get_data() const { return m_data; }
         expr * get_def() const { return m_def; }
         unsigned get_data_hash() const { return m_data_hash; }
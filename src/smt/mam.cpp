@@ -2007,31 +2007,21 @@ namespace {
             TRACE("trigger_bug", tout << "execute for code tree:\n"; t->display(tout););
             init(t);
 #define CLEANUP  for (enode* app : t->get_candidates()) if (app->is_marked()) app->unset_mark();
-            if (t->filter_candidates()) {
-                for (enode* app : t->get_candidates()) {
-                    TRACE("trigger_bug", tout << "candidate\n" << mk_ismt2_pp(app->get_expr(), m) << "\n";);
-                    if (!app->is_marked() && app->is_cgr()) {
-                        if (m_context.resource_limits_exceeded() || !execute_core(t, app)) {
-                            CLEANUP;
-                            return false;
-                        }
-                        app->set_mark();
-                    }
-                }
-                CLEANUP;
-                
-            }
-            else {
-                for (enode* app : t->get_candidates()) {
-                    TRACE("trigger_bug", tout << "candidate\n" << mk_ismt2_pp(app->get_expr(), m) << "\n";);
-                    if (app->is_cgr()) {
-                        TRACE("trigger_bug", tout << "is_cgr\n";);
-                        // scoped_suspend_rlimit susp(m.limit(), false);
-                        if (m_context.resource_limits_exceeded() || !execute_core(t, app))
-                            return false;
+            // The candidates of a round are collected from both new relevant enodes and
+            // the inverted path index, so the same enode can be added several times.
+            // Executing a candidate twice in a round produces the same matches, so
+            // duplicates are filtered for every code tree.
+            for (enode* app : t->get_candidates()) {
+                TRACE("trigger_bug", tout << "candidate\n" << mk_ismt2_pp(app->get_expr(), m) << "\n";);
+                if (!app->is_marked() && app->is_cgr()) {
+                    if (m_context.resource_limits_exceeded() || !execute_core(t, app)) {
+                        CLEANUP;
+                        return false;
                     }
+                    app->set_mark();
                 }
             }
+            CLEANUP;
             return true;
         }
 
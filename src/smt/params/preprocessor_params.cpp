@@ -31,6 +31,7 @@ void preprocessor_params::updt_local_params(params_ref const & _p) {
     m_solve_eqs               = p.solve_eqs();
     m_ng_lift_ite             = static_cast<lift_ite_kind>(p.q_lift_ite());
     m_bound_simplifier        = p.bound_simplifier();
+    m_bb_wallace_mul          = p.bv_wallace_mul();
 }
 
 void preprocessor_params::updt_params(params_ref const & p) {
@@ -36,10 +36,12 @@ struct qi_params {
     unsigned           m_qi_max_lazy_multipattern_matching = 2;
     bool               m_qi_profile = false;
     unsigned           m_qi_profile_freq = UINT_MAX;
+    bool               m_qi_cost_histogram = false;
     quick_checker_mode m_qi_quick_checker = MC_NO;
     bool               m_qi_lazy_quick_checker = true;
     bool               m_qi_promote_unsat = true;
     unsigned           m_qi_max_instances = UINT_MAX;
+    unsigned           m_qi_max_pending = UINT_MAX;
     bool               m_qi_lazy_instantiation = false;
     bool               m_qi_conservative_final_check = false;
     bool               m_qe_lite = false;
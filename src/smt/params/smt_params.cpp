@@ -33,6 +33,9 @@ void smt_params::updt_local_params(params_ref const & _p) {
     if (m_phase_selection > PS_THEORY) throw default_exception("illegal phase selection numeral");
     m_phase_caching_on = p.phase_caching_on();
     m_phase_caching_off = p.phase_caching_off();
+    m_phase_target = p.phase_target();
+    m_rephase = p.phase_rephase();
+    m_internalize_retain = p.internalize_retain();
     m_restart_strategy = static_cast<restart_strategy>(p.restart_strategy());
     if (m_restart_strategy > RS_ARITHMETIC) throw default_exception("illegal restart strategy numeral");
     m_restart_factor = p.restart_factor();
@@ -48,8 +51,13 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_threads       = p.threads();
     m_threads_max_conflicts  = p.threads_max_conflicts();
     m_threads_cube_frequency = p.threads_cube_frequency();
+    m_threads_persistent     = p.threads_persistent();
+    m_threads_cube_and_conquer = p.threads_cube_and_conquer();
     m_core_validate = p.core_validate();
     m_sls_enable = p.sls_enable();
+    m_sls_threads = p.sls_threads();
+    m_fp_abstract_ops = p.fp_abstract_ops();
+    m_recfun_lazy = p.recfun_lazy();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
     m_up_persist_clauses = p.up_persist_clauses();
@@ -66,6 +74,7 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_axioms2files = sp.axioms2files();
     m_lemmas2console = sp.lemmas2console();
     m_instantiations2console = sp.instantiations2console();
+    m_consequences_chunk = sp.consequences_chunk();
     m_proof_log = sp.proof_log();
     
 }
@@ -117,12 +126,17 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_phase_selection);
     DISPLAY_PARAM(m_phase_caching_on);
     DISPLAY_PARAM(m_phase_caching_off);
+    DISPLAY_PARAM(m_phase_target);
+    DISPLAY_PARAM(m_rephase);
+    DISPLAY_PARAM(m_internalize_retain);
     DISPLAY_PARAM(m_minimize_lemmas);
     DISPLAY_PARAM(m_max_conflicts);
     DISPLAY_PARAM(m_cube_depth);
     DISPLAY_PARAM(m_threads);
     DISPLAY_PARAM(m_threads_max_conflicts);
     DISPLAY_PARAM(m_threads_cube_frequency);
+    DISPLAY_PARAM(m_threads_persistent);
+    DISPLAY_PARAM(m_threads_cube_and_conquer);
     DISPLAY_PARAM(m_simplify_clauses);
     DISPLAY_PARAM(m_tick);
     DISPLAY_PARAM(m_display_features);
@@ -161,6 +175,8 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_old_clause_relevancy);
     DISPLAY_PARAM(m_inv_clause_decay);
 
+    DISPLAY_PARAM(m_consequences_chunk);
+
     DISPLAY_PARAM(m_axioms2files);
     DISPLAY_PARAM(m_lemmas2console);
     DISPLAY_PARAM(m_logic);
@@ -99,6 +99,9 @@ struct smt_params : public preprocessor_params,
     phase_selection  m_phase_selection = phase_selection::PS_CACHING_CONSERVATIVE;
     unsigned         m_phase_caching_on = 700;
     unsigned         m_phase_caching_off = 100;
+    bool             m_phase_target = false;
+    unsigned         m_rephase = 0;
+    unsigned         m_internalize_retain = 0;
     bool             m_minimize_lemmas = true;
     unsigned         m_max_conflicts = UINT_MAX;
     unsigned         m_restart_max;
@@ -106,6 +109,8 @@ struct smt_params : public preprocessor_params,
     unsigned         m_threads = 1;
     unsigned         m_threads_max_conflicts = UINT_MAX;
     unsigned         m_threads_cube_frequency = 2;
+    bool             m_threads_persistent = false;
+    bool             m_threads_cube_and_conquer = false;
     bool             m_simplify_clauses = true;
     unsigned         m_tick = 1000;
     bool             m_display_features = false;
@@ -115,6 +120,9 @@ struct smt_params : public preprocessor_params,
     bool             m_clause_proof = false;
     symbol           m_proof_log;
     bool             m_sls_enable = false;
+    unsigned         m_sls_threads = 1;
+    bool             m_fp_abstract_ops = false;
+    bool             m_recfun_lazy = false;
 
     // -----------------------------------
     //
@@ -179,6 +187,13 @@ struct smt_params : public preprocessor_params,
 
     bool             m_up_persist_clauses = false;
 
+    // -----------------------------------
+    //
+    // Consequence finding
+    //
+    // -----------------------------------
+    unsigned          m_consequences_chunk = 100;
+
     // -----------------------------------
     //
     // SMT-LIB (debug) pretty printer
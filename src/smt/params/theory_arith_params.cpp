@@ -37,6 +37,7 @@ void theory_arith_params::updt_params(params_ref const & _p) {
     m_arith_eager_eq_axioms = p.arith_eager_eq_axioms();
     m_arith_auto_config_simplex = p.arith_auto_config_simplex();
     m_arith_validate = p.arith_validate();
+    m_arith_bprop_batch = p.arith_bprop_batch();
     m_nl_arith_propagate_linear_monomials = p.arith_nl_propagate_linear_monomials();
     m_nl_arith_optimize_bounds = p.arith_nl_optimize_bounds();
     m_nl_arith_cross_nested = p.arith_nl_cross_nested();
@@ -60,6 +61,7 @@ void theory_arith_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_arith_skip_rows_with_big_coeffs);
     DISPLAY_PARAM(m_arith_max_lemma_size);
     DISPLAY_PARAM(m_arith_small_lemma_size);
+    DISPLAY_PARAM(m_arith_bprop_batch);
     DISPLAY_PARAM(m_arith_reflect);
     DISPLAY_PARAM(m_arith_ignore_int);
     DISPLAY_PARAM(m_arith_lazy_pivoting_lvl);
@@ -62,6 +62,7 @@ struct theory_arith_params {
     bool                    m_arith_skip_rows_with_big_coeffs = true;
     unsigned                m_arith_max_lemma_size = 128; 
     unsigned                m_arith_small_lemma_size = 16;
+    bool                    m_arith_bprop_batch = false;
     bool                    m_arith_reflect = true;
     bool                    m_arith_ignore_int = false;
     unsigned                m_arith_lazy_pivoting_lvl = 0;
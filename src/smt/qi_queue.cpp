@@ -18,11 +18,13 @@ Revision History:
 --*/
 #include "util/warning.h"
 #include "util/stats.h"
+#include "util/event_trace.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/rewriter/var_subst.h"
 #include "smt/smt_context.h"
 #include "smt/qi_queue.h"
+#include <algorithm>
 #include <iostream>
 
 namespace smt {
@@ -60,6 +62,8 @@ namespace smt {
             warning_msg("invalid new_gen function '%s', switching to default one", m_params.m_qi_new_gen.c_str());
             VERIFY(m_parser.parse_string("cost", m_new_gen_function));
         }
+        m_evaluator.compile(m_cost_function, m_cost_program);
+        m_evaluator.compile(m_new_gen_function, m_new_gen_program);
         m_eager_cost_threshold = m_params.m_qi_eager_threshold;
     }
 
@@ -119,15 +123,21 @@ namespace smt {
 
     float qi_queue::get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
         q::quantifier_stat * stat = set_values(q, pat, generation, min_top_generation, max_top_generation, 0);
-        float r = m_evaluator(m_cost_function, m_vals.size(), m_vals.data());
+        float r = m_evaluator(m_cost_program, m_vals.size(), m_vals.data());
         stat->update_max_cost(r);
+        if (m_params.m_qi_cost_histogram) {
+            unsigned b = 0;
+            for (float c = r; c >= 1.0f && b + 1 < qi_queue_stats::num_cost_buckets; c /= 2.0f)
+                ++b;
+            m_stats.m_cost_histogram[b]++;
+        }
         return r;
     }
 
     unsigned qi_queue::get_new_gen(quantifier * q, unsigned generation, float cost) {
         // max_top_generation and min_top_generation are not available for computing inc_gen
         set_values(q, nullptr, generation, 0, 0, cost);
-        float r = m_evaluator(m_new_gen_function, m_vals.size(), m_vals.data());
+        float r = m_evaluator(m_new_gen_program, m_vals.size(), m_vals.data());
         if (q->get_weight() > 0 || r > 0)
             return static_cast<unsigned>(r);
         return std::max(generation + 1, static_cast<unsigned>(r));
@@ -147,7 +157,24 @@ namespace smt {
         m_new_entries.push_back(entry(f, cost, generation));
     }
 
+    /**
+       \brief Keep the qi.max_pending cheapest new entries.
+       The fingerprints of the discarded entries stay in the fingerprint set,
+       so they are not matched again before the scope is popped.
+    */
+    void qi_queue::bound_new_entries() {
+        unsigned max_pending = m_params.m_qi_max_pending;
+        if (m_new_entries.size() <= max_pending)
+            return;
+        std::nth_element(m_new_entries.begin(), m_new_entries.begin() + max_pending, m_new_entries.end(),
+                         [](entry const& a, entry const& b) { return a.m_cost < b.m_cost; });
+        m_stats.m_num_dropped_instances += m_new_entries.size() - max_pending;
+        m_new_entries.shrink(max_pending);
+    }
+
     void qi_queue::instantiate() {
+        EVENT_TRACE(qi_round_k, m_new_entries.size(), m_context.get_scope_level());
+        bound_new_entries();
         unsigned since_last_check = 0;
         for (entry & curr : m_new_entries) {
             if (m_context.get_cancel_flag()) {
@@ -164,6 +191,11 @@ namespace smt {
                 TRACE("qi_unsat", tout << "promoting instance that produces a conflict\n" << mk_pp(qa, m) << "\n";);
                 instantiate(curr);
             }
+            else if (curr.m_cost > m_params.m_qi_lazy_threshold) {
+                // final_check_eh only instantiates delayed entries below the lazy threshold.
+                TRACE("qi_queue", tout << "pruning quantifier instantiation... " << f << "\ncost: " << curr.m_cost << "\n";);
+                m_stats.m_num_pruned_instances++;
+            }
             else {
                 TRACE("qi_queue", tout << "delaying quantifier instantiation... " << f << "\n" << mk_pp(qa, m) << "\ncost: " << curr.m_cost << "\n";);
                 m_delayed_entries.push_back(curr);
@@ -499,11 +531,26 @@ namespace smt {
     void qi_queue::collect_statistics(::statistics & st) const {
         st.update("quant instantiations", m_stats.m_num_instances);
         st.update("lazy quant instantiations", m_stats.m_num_lazy_instances);
+        st.update("duplicate quant instances", m_stats.m_num_duplicate_instances);
+        st.update("pruned quant instances", m_stats.m_num_pruned_instances);
+        st.update("dropped quant instances", m_stats.m_num_dropped_instances);
         st.update("missed quant instantiations", m_delayed_entries.size());
         float min, max;
         get_min_max_costs(min, max);
         st.update("min missed qa cost", min);
         st.update("max missed qa cost", max);
+        if (m_params.m_qi_cost_histogram) {
+            // statistics keep the key pointers, so the keys are static.
+            static char const* const keys[qi_queue_stats::num_cost_buckets] = {
+                "quant cost [0,1)", "quant cost [1,2)", "quant cost [2,4)", "quant cost [4,8)",
+                "quant cost [8,16)", "quant cost [16,32)", "quant cost [32,64)", "quant cost [64,128)",
+                "quant cost [128,256)", "quant cost [256,512)", "quant cost [512,1024)", "quant cost [1024,2048)",
+                "quant cost [2048,4096)", "quant cost [4096,8192)", "quant cost [8192,16384)", "quant cost >= 16384"
+            };
+            for (unsigned i = 0; i < qi_queue_stats::num_cost_buckets; ++i)
+                if (m_stats.m_cost_histogram[i] > 0)
+                    st.update(keys[i], m_stats.m_cost_histogram[i]);
+        }
 #if 0
         if (m_params.m_qi_profile) {
             out << "missed/delayed quantifier instances:\n";
@@ -33,7 +33,12 @@ namespace smt {
     class context;
 
     struct qi_queue_stats {
+        static const unsigned num_cost_buckets = 16;
         unsigned m_num_instances, m_num_lazy_instances;
+        unsigned m_num_duplicate_instances; // instances rejected by the fingerprint set
+        unsigned m_num_pruned_instances;    // delayed instances above the lazy threshold, they are never instantiated
+        unsigned m_num_dropped_instances;   // instances discarded because a round exceeded qi.max_pending
+        unsigned m_cost_histogram[num_cost_buckets]; // bucket 0: cost < 1, bucket i: 2^(i-1) <= cost < 2^i
         void reset() { memset(this, 0, sizeof(qi_queue_stats)); }
         qi_queue_stats() { reset(); }
     };
@@ -49,6 +54,8 @@ namespace smt {
         expr_ref                      m_new_gen_function;
         cost_parser                   m_parser;
         cost_evaluator                m_evaluator;
+        cost_evaluator::program       m_cost_program;
+        cost_evaluator::program       m_new_gen_program;
         cached_var_subst              m_subst;
         svector<float>                m_vals;
         double                        m_eager_cost_threshold;
@@ -75,6 +82,7 @@ namespace smt {
         float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
         unsigned get_new_gen(quantifier * q, unsigned generation, float cost);
         void instantiate(entry & ent);
+        void bound_new_entries();
         void get_min_max_costs(float & min, float & max) const;
         void display_instance_profile(fingerprint * f, quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned proof_id, unsigned generation);
 
@@ -86,6 +94,10 @@ namespace smt {
            f->get_data() is the quantifier.
         */
         void insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
+        /**
+           \brief Record an instance that was not inserted because its fingerprint was already known.
+        */
+        void insert_duplicate() { m_stats.m_num_duplicate_instances++; }
         void instantiate();
         bool has_work() const { return !m_new_entries.empty(); }
         void init_search_eh();
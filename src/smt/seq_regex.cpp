@@ -30,6 +30,7 @@ namespace smt {
         ctx(th.get_context()),
         m(th.get_manager()),
         m_state_to_expr(m),
+        m_cache_trail(m),
         m_state_graph(state_graph::state_pp(this, pp_state)) { }
 
     seq_util& seq_regex::u() { return th.m_util; }
@@ -417,9 +418,15 @@ namespace smt {
     expr_ref seq_regex::is_nullable_wrapper(expr* r) {
         STRACE("seq_regex", tout << "nullable: " << mk_pp(r, m) << std::endl;);
 
+        expr* cached = nullptr;
+        if (m_nullable_cache.find(r, cached))
+            return expr_ref(cached, m);
         expr_ref result = seq_rw().is_nullable(r);
         //TODO: rewrite seems unnecessary here
         rewrite(result);
+        m_cache_trail.push_back(r);
+        m_cache_trail.push_back(result);
+        m_nullable_cache.insert(r, result);
 
         STRACE("seq_regex", tout << "nullable result: " << mk_pp(result, m) << std::endl;);
         STRACE("seq_regex_brief", tout << "n(" << state_str(r) << ")="
@@ -437,7 +444,7 @@ namespace smt {
 
         // Uses canonical variable (:var 0) for the derivative element
         // Substitute (:var 0) with the actual element
-        expr_ref der = seq_rw().mk_derivative(r);
+        expr_ref der(cached_derivative(r), m);
         var_subst subst(m);
         der = subst(der, ele);
 
@@ -450,6 +457,20 @@ namespace smt {
         return der;
     }
 
+    /*
+       Symbolic derivative of r wrt (:var 0), memoized per regex state.
+    */
+    expr* seq_regex::cached_derivative(expr* r) {
+        expr* d = nullptr;
+        if (m_derivative_cache.find(r, d))
+            return d;
+        expr_ref der = seq_rw().mk_derivative(r);
+        m_cache_trail.push_back(r);
+        m_cache_trail.push_back(der);
+        m_derivative_cache.insert(r, der);
+        return der;
+    }
+
     void seq_regex::propagate_eq(expr* r1, expr* r2) {
         TRACE("seq_regex", tout << "propagate EQ: " << mk_pp(r1, m) << ", " << mk_pp(r2, m) << std::endl;);
         STRACE("seq_regex_brief", tout << "PEQ ";);
@@ -650,7 +671,7 @@ namespace smt {
     */
     void seq_regex::get_derivative_targets(expr* r, expr_ref_vector& targets) {
         // constructs the derivative wrt (:var 0)
-        expr_ref d(seq_rw().mk_derivative(r), m);
+        expr_ref d(cached_derivative(r), m);
 
         // use DFS to collect all the targets (leaf regexes) in d.
         expr* _1 = nullptr, * e1 = nullptr, * e2 = nullptr;
@@ -117,6 +117,18 @@ namespace smt {
         /* map from uninterpreted regex constants to assigned regex expressions by EQ */
         // expr_map                       m_const_to_expr;
         unsigned                       m_max_state_graph_size { 10000 };
+        /*
+            Derivative automaton shared by all membership constraints.
+            Maps a regex state to its nullability and to its symbolic
+            derivative wrt (:var 0). The derivative is an ite over character
+            classes whose leaves are the successor states. Entries are kept
+            for the lifetime of the solver, unlike the bounded operation
+            cache of the sequence rewriter.
+        */
+        obj_map<expr, expr*>           m_nullable_cache;
+        obj_map<expr, expr*>           m_derivative_cache;
+        expr_ref_vector                m_cache_trail;
+        expr* cached_derivative(expr* r);
         // Convert between expressions and states (IDs)
         unsigned get_state_id(expr* e);
         expr* get_expr_from_id(unsigned id);
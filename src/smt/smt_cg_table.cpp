@@ -87,7 +87,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table, entry_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -170,8 +170,8 @@ namespace smt {
     void cg_table::display_binary(std::ostream& out, void* t) const {
         binary_table* tb = UNTAG(binary_table*, t);
         out << "b ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " " << cg_binary_hash()(n) << " ";
+        for (auto const& e : *tb) {
+            out << e.m_node->get_owner_id() << " " << e.m_hash << " ";
         }
         out << "\n";
     }
@@ -179,8 +179,8 @@ namespace smt {
     void cg_table::display_binary_comm(std::ostream& out, void* t) const {
         comm_table* tb = UNTAG(comm_table*, t);
         out << "bc ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (auto const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -188,8 +188,8 @@ namespace smt {
     void cg_table::display_unary(std::ostream& out, void* t) const {
         unary_table* tb = UNTAG(unary_table*, t);
         out << "un ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (auto const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -197,8 +197,8 @@ namespace smt {
     void cg_table::display_nary(std::ostream& out, void* t) const {
         table* tb = UNTAG(table*, t);
         out << "nary ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (auto const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -213,19 +213,19 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(mk_unary_entry(n)).m_node;
             return enode_bool_pair(n_prime, false);
         case BINARY:
-            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
-            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
+            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(mk_binary_entry(n)).m_node;
+            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << mk_binary_entry(n).m_hash << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
                   display_binary(tout, t); tout << "contains_ptr: " << contains_ptr(n) << "\n";); 
             return enode_bool_pair(n_prime, false);
         case BINARY_COMM:
             m_commutativity = false;
-            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(mk_comm_entry(n)).m_node;
             return enode_bool_pair(n_prime, m_commutativity);
         default:
-            n_prime = UNTAG(table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(table*, t)->insert_if_not_there(mk_nary_entry(n)).m_node;
             return enode_bool_pair(n_prime, false);
         }
     }
@@ -235,17 +235,17 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            UNTAG(unary_table*, t)->erase(n);
+            UNTAG(unary_table*, t)->erase(mk_unary_entry(n));
             break;
         case BINARY:
-            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " contains: " << contains_ptr(n) << "\n";);
-            UNTAG(binary_table*, t)->erase(n);
+            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << mk_binary_entry(n).m_hash << " contains: " << contains_ptr(n) << "\n";);
+            UNTAG(binary_table*, t)->erase(mk_binary_entry(n));
             break;
         case BINARY_COMM:
-            UNTAG(comm_table*, t)->erase(n);
+            UNTAG(comm_table*, t)->erase(mk_comm_entry(n));
             break;
         default:
-            UNTAG(table*, t)->erase(n);
+            UNTAG(table*, t)->erase(mk_nary_entry(n));
             break;
         }
     }
@@ -254,7 +254,42 @@ namespace smt {
     void cg_table::display_compact(std::ostream & out) const {
     }
 
+    /**
+       \brief the roots and hashes cached in the entries of the tables
+       coincide with the current roots of the arguments.
+    */
     bool cg_table::check_invariant() const {
+        for (void* t : m_tables) {
+            switch (GET_TAG(t)) {
+            case UNARY:
+                for (auto const& e : *UNTAG(unary_table*, t)) {
+                    unary_entry c = mk_unary_entry(e.m_node);
+                    if (c.m_root != e.m_root || c.m_hash != e.m_hash)
+                        return false;
+                }
+                break;
+            case BINARY:
+                for (auto const& e : *UNTAG(binary_table*, t)) {
+                    binary_entry c = mk_binary_entry(e.m_node);
+                    if (c.m_root1 != e.m_root1 || c.m_root2 != e.m_root2 || c.m_hash != e.m_hash)
+                        return false;
+                }
+                break;
+            case BINARY_COMM:
+                for (auto const& e : *UNTAG(comm_table*, t)) {
+                    binary_entry c = mk_comm_entry(e.m_node);
+                    if (c.m_root1 != e.m_root1 || c.m_root2 != e.m_root2 || c.m_hash != e.m_hash)
+                        return false;
+                }
+                break;
+            case NARY:
+                for (auto const& e : *UNTAG(table*, t)) {
+                    if (mk_nary_entry(e.m_node).m_hash != e.m_hash)
+                        return false;
+                }
+                break;
+            }
+        }
         return true;
     }
 
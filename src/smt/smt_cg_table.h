@@ -30,72 +30,69 @@ namespace smt {
 
     /**
        \brief Congruence table.
+
+       The entries of the unary and binary tables store the roots of the
+       arguments and the hash inline, the entries of the n-ary tables store
+       the hash. An enode is removed from the table before the root of one of
+       its arguments changes and it is reinserted afterwards (see
+       context::remove_parents_from_cg_table and
+       context::reinsert_parents_into_cg_table), so the cached values of the
+       entries in the table are always up to date. Lookups along collision
+       chains and rehashing do not have to chase the argument and root
+       pointers of the stored enodes.
     */
     class cg_table {
-        struct cg_unary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 1);
-                return n->get_arg(0)->get_root()->hash();
-            }
+
+        struct unary_entry {
+            enode *  m_node = nullptr;
+            enode *  m_root = nullptr;
+            unsigned m_hash = 0;
         };
 
-        struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 1);
-                SASSERT(n2->get_num_args() == 1);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
-            }
+        struct binary_entry {
+            enode *  m_node = nullptr;
+            enode *  m_root1 = nullptr;
+            enode *  m_root2 = nullptr;
+            unsigned m_hash = 0;
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
-        
-        struct cg_binary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                return combine_hash(n->get_arg(0)->get_root()->hash(), n->get_arg(1)->get_root()->hash());
-            }
+        struct nary_entry {
+            enode *  m_node = nullptr;
+            unsigned m_hash = 0;
         };
 
-        struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
+        struct entry_hash {
+            template<typename E>
+            unsigned operator()(E const & e) const { return e.m_hash; }
+        };
+
+        struct cg_unary_eq {
+            bool operator()(unary_entry const & e1, unary_entry const & e2) const {
+                SASSERT(e1.m_node->get_decl() == e2.m_node->get_decl());
+                return e1.m_root == e2.m_root;
             }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
-        
-        struct cg_comm_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                unsigned h1 = n->get_arg(0)->get_root()->hash();
-                unsigned h2 = n->get_arg(1)->get_root()->hash();
-                if (h1 > h2)
-                    std::swap(h1, h2);
-                return hash_u((h1 << 16) | (h2 & 0xFFFF));
+        typedef chashtable<unary_entry, entry_hash, cg_unary_eq> unary_table;
+
+        struct cg_binary_eq {
+            bool operator()(binary_entry const & e1, binary_entry const & e2) const {
+                SASSERT(e1.m_node->get_decl() == e2.m_node->get_decl());
+                return e1.m_root1 == e2.m_root1 && e1.m_root2 == e2.m_root2;
             }
         };
-        
+
+        typedef chashtable<binary_entry, entry_hash, cg_binary_eq> binary_table;
+
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                enode * c1_1 = n1->get_arg(0)->get_root();
-                enode * c1_2 = n1->get_arg(1)->get_root();
-                enode * c2_1 = n2->get_arg(0)->get_root();
-                enode * c2_2 = n2->get_arg(1)->get_root();
-                if (c1_1 == c2_1 && c1_2 == c2_2) {
+            bool operator()(binary_entry const & e1, binary_entry const & e2) const {
+                SASSERT(e1.m_node->get_decl() == e2.m_node->get_decl());
+                if (e1.m_root1 == e2.m_root1 && e1.m_root2 == e2.m_root2) {
                     return true;
                 }
-                if (c1_1 == c2_2 && c1_2 == c2_1) {
+                if (e1.m_root1 == e2.m_root2 && e1.m_root2 == e2.m_root1) {
                     m_commutativity = true;
                     return true;
                 }
@@ -103,7 +100,7 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+        typedef chashtable<binary_entry, entry_hash, cg_comm_eq> comm_table;
 
         struct cg_hash {
             unsigned operator()(enode * n) const;
@@ -113,7 +110,53 @@ namespace smt {
             bool operator()(enode * n1, enode * n2) const;
         };
 
-        typedef chashtable<enode*, cg_hash, cg_eq> table;
+        struct cg_nary_eq {
+            bool operator()(nary_entry const & e1, nary_entry const & e2) const {
+                return e1.m_hash == e2.m_hash && cg_eq()(e1.m_node, e2.m_node);
+            }
+        };
+
+        typedef chashtable<nary_entry, entry_hash, cg_nary_eq> table;
+
+        static unary_entry mk_unary_entry(enode * n) {
+            SASSERT(n->get_num_args() == 1);
+            unary_entry e;
+            e.m_node = n;
+            e.m_root = n->get_arg(0)->get_root();
+            e.m_hash = e.m_root->hash();
+            return e;
+        }
+
+        static binary_entry mk_binary_entry(enode * n) {
+            SASSERT(n->get_num_args() == 2);
+            binary_entry e;
+            e.m_node  = n;
+            e.m_root1 = n->get_arg(0)->get_root();
+            e.m_root2 = n->get_arg(1)->get_root();
+            e.m_hash  = combine_hash(e.m_root1->hash(), e.m_root2->hash());
+            return e;
+        }
+
+        static binary_entry mk_comm_entry(enode * n) {
+            SASSERT(n->get_num_args() == 2);
+            binary_entry e;
+            e.m_node  = n;
+            e.m_root1 = n->get_arg(0)->get_root();
+            e.m_root2 = n->get_arg(1)->get_root();
+            unsigned h1 = e.m_root1->hash();
+            unsigned h2 = e.m_root2->hash();
+            if (h1 > h2)
+                std::swap(h1, h2);
+            e.m_hash = hash_u((h1 << 16) | (h2 & 0xFFFF));
+            return e;
+        }
+
+        static nary_entry mk_nary_entry(enode * n) {
+            nary_entry e;
+            e.m_node = n;
+            e.m_hash = cg_hash()(n);
+            return e;
+        }
 
         ast_manager &                 m_manager;
         bool                          m_commutativity; //!< true if the last found congruence used commutativity
@@ -157,46 +200,41 @@ namespace smt {
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
+                return UNTAG(unary_table*, t)->contains(mk_unary_entry(n));
             case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
+                return UNTAG(binary_table*, t)->contains(mk_binary_entry(n));
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
+                return UNTAG(comm_table*, t)->contains(mk_comm_entry(n));
             default:
-                return UNTAG(table*, t)->contains(n);
+                return UNTAG(table*, t)->contains(mk_nary_entry(n));
             }
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = nullptr;
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : nullptr;
-            default:
-                return UNTAG(table*, t)->find(n, r) ? r : nullptr;
+            case UNARY: {
+                unary_entry r;
+                return UNTAG(unary_table*, t)->find(mk_unary_entry(n), r) ? r.m_node : nullptr;
+            }
+            case BINARY: {
+                binary_entry r;
+                return UNTAG(binary_table*, t)->find(mk_binary_entry(n), r) ? r.m_node : nullptr;
+            }
+            case BINARY_COMM: {
+                binary_entry r;
+                return UNTAG(comm_table*, t)->find(mk_comm_entry(n), r) ? r.m_node : nullptr;
+            }
+            default: {
+                nary_entry r;
+                return UNTAG(table*, t)->find(mk_nary_entry(n), r) ? r.m_node : nullptr;
+            }
             }
         }
 
         bool contains_ptr(enode * n) const {
-            enode * r;
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
-            default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
-            }
+            return find(n) == n;
         }
 
         void reset();
@@ -634,100 +634,114 @@ namespace smt {
         unmark_justifications(old_js_qhead);
     }
 
+    bool conflict_resolution::is_poisoned(bool_var v) const {
+        return v < m_min_poison.size() && m_min_poison[v] == m_min_stamp;
+    }
+
+    void conflict_resolution::poison(bool_var v) {
+        if (v >= m_min_poison.size())
+            m_min_poison.resize(v + 1, 0);
+        m_min_poison[v] = m_min_stamp;
+    }
+
     /**
-       \brief Process an antecedent for lemma minimization.
+       \brief Push a frame for var whose antecedents are the literals that
+       must be implied by marked literals for var to be redundant.
+       Return false if var is a decision or an assumption above the base level.
     */
-    bool conflict_resolution::process_antecedent_for_minimization(literal antecedent) {
-        bool_var var = antecedent.var();
-        unsigned lvl = m_ctx.get_assign_level(var);
-        if (!m_ctx.is_marked(var) && lvl > m_ctx.get_base_level()) {
-            if (m_lvl_set.may_contain(lvl)) {
-                m_ctx.set_mark(var);
-                m_unmark.push_back(var);
-                m_lemma_min_stack.push_back(var);
-            }
-            else {
-                return false;
+    bool conflict_resolution::push_min_frame(bool_var var) {
+        unsigned begin = m_min_antecedents.size();
+        b_justification js = m_ctx.get_justification(var);
+        SASSERT(js != null_b_justification);
+        switch (js.get_kind()) {
+        case b_justification::CLAUSE: {
+            clause * cls      = js.get_clause();
+            unsigned num_lits = cls->get_num_literals();
+            unsigned pos      = (*cls)[1].var() == var;
+            for (unsigned i = 0; i < num_lits; i++) {
+                if (pos != i) {
+                    SASSERT((*cls)[i].var() != var);
+                    m_min_antecedents.push_back(~(*cls)[i]);
+                }
             }
+            // Invoking justification2literals_core will not reset the caches for visited justifications and eqs.
+            // The method unmark_justifications must be invoked to reset these caches.
+            if (cls->get_justification())
+                justification2literals_core(cls->get_justification(), m_min_antecedents);
+            break;
         }
-        return true;
-    }
-
-    bool conflict_resolution::process_justification_for_minimization(justification * js) {
-        literal_vector & antecedents = m_tmp_literal_vector;
-        antecedents.reset();
-        // Invoking justification2literals_core will not reset the caches for visited justifications and eqs.
-        // The method unmark_justifications must be invoked to reset these caches.
-        // Remark: The method reset_unmark_and_justifications invokes unmark_justifications.
-        justification2literals_core(js, antecedents);
-        for (literal l : antecedents) 
-            if (!process_antecedent_for_minimization(l))
+        case b_justification::BIN_CLAUSE:
+            m_min_antecedents.push_back(js.get_literal());
+            break;
+        case b_justification::AXIOM:
+            // it is a decision variable from a previous scope level or an assumption
+            if (m_ctx.get_assign_level(var) > m_ctx.get_base_level())
                 return false;
+            break;
+        case b_justification::JUSTIFICATION:
+            if (m_ctx.is_assumption(var))
+                return false;
+            justification2literals_core(js.get_justification(), m_min_antecedents);
+            break;
+        }
+        m_min_frames.push_back(min_frame(var, begin, m_min_antecedents.size()));
         return true;
     }
 
     /**
        \brief Return true if lit is implied by other marked literals
        and/or literals assigned at the base level.
+
+       The antecedents are explored depth first. A variable is marked as soon
+       as all its antecedents are known to be implied, so the result is shared
+       with the remaining literals of the lemma. When the search fails, the
+       variables on the current path are poisoned for the rest of the conflict,
+       and the marks set by the failed search are retracted: a justification
+       expanded by a frame on the failed path is not expanded again by its
+       other consequents, so their marks may depend on the failed path.
+
        The set lvl_set is used as an optimization.
-       The idea is to stop the recursive search with a failure
+       The idea is to stop the search with a failure
        as soon as we find a literal assigned in a level that is not in lvl_set.
     */
     bool conflict_resolution::implied_by_marked(literal lit) {
-        m_lemma_min_stack.reset();  // avoid recursive function
-        m_lemma_min_stack.push_back(lit.var());
         unsigned old_size     = m_unmark.size();
         unsigned old_js_qhead = m_todo_js_qhead;
-
-        while (!m_lemma_min_stack.empty()) {
-            bool_var var       = m_lemma_min_stack.back();
-            m_lemma_min_stack.pop_back();
-            b_justification js = m_ctx.get_justification(var);
-            SASSERT(js != null_b_justification);
-            switch(js.get_kind()) {
-            case b_justification::CLAUSE: {
-                clause * cls      = js.get_clause();
-                unsigned num_lits = cls->get_num_literals();
-                unsigned pos      = (*cls)[1].var() == var;
-                for (unsigned i = 0; i < num_lits; i++) {
-                    if (pos != i) {
-                        literal l = (*cls)[i];
-                        SASSERT(l.var() != var);
-                        if (!process_antecedent_for_minimization(~l)) {
-                            reset_unmark_and_justifications(old_size, old_js_qhead);
-                            return false;
-                        }
-                    }
+        m_min_frames.reset();
+        m_min_antecedents.reset();
+        bool ok = push_min_frame(lit.var());
+        while (ok && !m_min_frames.empty()) {
+            min_frame & f = m_min_frames.back();
+            if (f.m_pos == f.m_end) {
+                bool_var var = f.m_var;
+                m_min_antecedents.shrink(f.m_begin);
+                m_min_frames.pop_back();
+                if (!m_min_frames.empty()) {
+                    // lit is already marked as a literal of the lemma.
+                    m_ctx.set_mark(var);
+                    m_unmark.push_back(var);
                 }
-                justification * js = cls->get_justification();
-                if (js && !process_justification_for_minimization(js)) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
-                }
-                break;
+                continue;
             }
-            case b_justification::BIN_CLAUSE:
-                if (!process_antecedent_for_minimization(js.get_literal())) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
-                }
-                break;
-            case b_justification::AXIOM:
-                // it is a decision variable from a previous scope level or an assumption
-                if (m_ctx.get_assign_level(var) > m_ctx.get_base_level()) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
-                }
-                break;
-            case b_justification::JUSTIFICATION:
-                if (m_ctx.is_assumption(var) || !process_justification_for_minimization(js.get_justification())) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
-                }
-                break;
+            bool_var var = m_min_antecedents[f.m_pos++].var();
+            unsigned lvl = m_ctx.get_assign_level(var);
+            if (m_ctx.is_marked(var) || lvl <= m_ctx.get_base_level())
+                continue;
+            if (is_poisoned(var) || !m_lvl_set.may_contain(lvl)) {
+                ok = false;
+            }
+            else if (!push_min_frame(var)) {
+                poison(var);
+                ok = false;
             }
         }
-        return true;
+        if (ok)
+            return true;
+        for (min_frame const & f : m_min_frames)
+            poison(f.m_var);
+        m_min_frames.reset();
+        reset_unmark_and_justifications(old_size, old_js_qhead);
+        return false;
     }
 
     /**
@@ -739,6 +753,10 @@ namespace smt {
         m_unmark.reset();
 
         m_lvl_set   = get_lemma_approx_level_set();
+        if (++m_min_stamp == 0) {
+            m_min_poison.fill(0);
+            m_min_stamp = 1;
+        }
 
         unsigned sz   = m_lemma.size();
         unsigned i    = 1; // the first literal is the FUIP
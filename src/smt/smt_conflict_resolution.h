@@ -179,14 +179,26 @@ namespace smt {
         void process_antecedent(literal antecedent, unsigned & num_marks);
         void process_justification(literal consequent, justification * js, unsigned & num_marks);
 
+        struct min_frame {
+            bool_var m_var;
+            unsigned m_begin;  // antecedents of m_var are at [m_begin, m_end) in m_min_antecedents
+            unsigned m_end;
+            unsigned m_pos;
+            min_frame(bool_var v, unsigned b, unsigned e): m_var(v), m_begin(b), m_end(e), m_pos(b) {}
+        };
+
         bool_var_vector m_unmark;
-        bool_var_vector m_lemma_min_stack;
+        svector<min_frame> m_min_frames;
+        literal_vector  m_min_antecedents;
+        unsigned_vector m_min_poison;       // m_min_poison[v] == m_min_stamp if v is not redundant in the current conflict
+        unsigned        m_min_stamp = 0;
         level_approx_set m_lvl_set;
         level_approx_set get_lemma_approx_level_set();
         void reset_unmark(unsigned old_size);
         void reset_unmark_and_justifications(unsigned old_size, unsigned old_js_qhead);
-        bool process_antecedent_for_minimization(literal antecedent);
-        bool process_justification_for_minimization(justification * js);
+        bool is_poisoned(bool_var v) const;
+        void poison(bool_var v);
+        bool push_min_frame(bool_var var);
         bool implied_by_marked(literal lit);
         void minimize_lemma();
 
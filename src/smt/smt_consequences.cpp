@@ -375,7 +375,7 @@ namespace smt {
         m_case_split_queue->init_search_eh();
         unsigned num_iterations = 0;
         unsigned num_fixed_eqs = 0;
-        unsigned chunk_size = 100; 
+        unsigned chunk_size = std::max(1u, m_fparams.m_consequences_chunk);
 
         init_assumptions(assumptions);
         num_units = 0;
@@ -441,6 +441,8 @@ namespace smt {
                                                        unfixed.size(), num_fixed_eqs););
             TRACE("context", display_consequence_progress(tout, num_iterations, m_var2val.size(), conseq.size(),
                                                        unfixed.size(), num_fixed_eqs););
+            if (m_progress_callback)
+                m_progress_callback->consequence_progress(conseq.size(), unfixed.size(), m_var2val.size());
         }
 
         end_search();
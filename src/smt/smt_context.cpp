@@ -20,6 +20,9 @@ Revision History:
 #include "util/luby.h"
 #include "util/warning.h"
 #include "util/timeit.h"
+#include "util/event_trace.h"
+#include "util/profile.h"
+#include "util/perf_counters.h"
 #include "util/union_find.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
@@ -65,11 +68,17 @@ namespace smt {
         m_lemma_id(0),
         m_progress_callback(nullptr),
         m_next_progress_sample(0),
+        m_next_telemetry_sample(0),
+        m_last_telemetry_time(0),
+        m_last_telemetry_conflicts(0),
+        m_last_telemetry_decisions(0),
         m_clause_proof(*this),
         m_fingerprints(m, m_region),
         m_b_internalized_stack(m),
         m_e_internalized_stack(m),
         m_l_internalized_stack(m),
+        m_popped_pinned(m),
+        m_retain_todo(m),
         m_final_check_idx(0),
         m_cg_table(m),
         m_conflict(null_b_justification),
@@ -188,6 +197,7 @@ namespace smt {
     }
 
     context::~context() {
+        dealloc(m_par);
         flush();
         m_asserted_formulas.finalize();
     }
@@ -1701,6 +1711,8 @@ namespace smt {
        congruences cannot be retracted to a consistent state.
      */
     bool context::propagate() {
+        profile::scope _ps("smt.propagate");
+        perf_counters::scope _pc(perf_counters::smt_propagate);
         TRACE("propagate", tout << "propagating... " << m_qhead << ":" << m_assigned_literals.size() << "\n";);
         while (true) {
             if (inconsistent())
@@ -1793,6 +1805,18 @@ namespace smt {
         bool_var_data & d = m_bdata[var];
         if (d.try_true_first())
             return true;
+        if (m_fparams.m_phase_target && m_phase_cache_on && var < m_target_phase.size() && m_target_phase[var] != l_undef) {
+            switch (m_fparams.m_phase_selection) {
+            case PS_CACHING:
+            case PS_CACHING_CONSERVATIVE:
+            case PS_CACHING_CONSERVATIVE2:
+            case PS_THEORY:
+                TRACE("phase_selection", tout << "using target phase, is_pos: " << (m_target_phase[var] == l_true) << ", var: p" << var << "\n";);
+                return m_target_phase[var] == l_true;
+            default:
+                break;
+            }
+        }
         switch (m_fparams.m_phase_selection) {
         case PS_THEORY:
             if (m_phase_cache_on && d.m_phase_available) {
@@ -1906,6 +1930,71 @@ namespace smt {
         return true;
     }
     
+    /**
+       \brief Record the current assignment as the target phase (and best phase)
+       if the trail is longer than the trail of the current target (best) phase.
+       The assignment of variables that are not on the trail is retained
+       from previous targets.
+    */
+    void context::update_target_phase() {
+        unsigned sz = m_assigned_literals.size();
+        bool update_target = m_fparams.m_phase_target && sz > m_target_trail_size;
+        bool update_best   = m_fparams.m_rephase > 0 && sz > m_best_trail_size;
+        if (!update_target && !update_best)
+            return;
+        unsigned num_vars = get_num_bool_vars();
+        if (update_target) {
+            m_target_trail_size = sz;
+            m_target_phase.reserve(num_vars, l_undef);
+            for (literal l : m_assigned_literals)
+                m_target_phase[l.var()] = l.sign() ? l_false : l_true;
+        }
+        if (update_best) {
+            m_best_trail_size = sz;
+            m_best_phase.reserve(num_vars, l_undef);
+            for (literal l : m_assigned_literals)
+                m_best_phase[l.var()] = l.sign() ? l_false : l_true;
+        }
+    }
+
+    /**
+       \brief Reset the cached phases, cycling through
+       best, original, best, inverted, best, random.
+       The target phase is cleared so that it is rebuilt from the new phases.
+    */
+    void context::rephase() {
+        m_stats.m_num_rephases++;
+        unsigned kind = m_num_rephases++ % 6;
+        unsigned num_vars = get_num_bool_vars();
+        for (bool_var v = 0; v < num_vars; ++v) {
+            bool_var_data & d = m_bdata[v];
+            switch (kind) {
+            case 1: // original
+                d.m_phase_available = false;
+                break;
+            case 3: // inverted
+                d.m_phase_available = true;
+                d.m_phase = !m_phase_default;
+                break;
+            case 5: // random
+                d.m_phase_available = true;
+                d.m_phase = m_random() % 2 == 0;
+                break;
+            default: // best
+                if (v < m_best_phase.size() && m_best_phase[v] != l_undef) {
+                    d.m_phase_available = true;
+                    d.m_phase = m_best_phase[v] == l_true;
+                }
+                break;
+            }
+        }
+        static char const* const names[6] = { "best", "original", "best", "inverted", "best", "random" };
+        IF_VERBOSE(2, verbose_stream() << "(smt.rephase :kind " << names[kind] << " :best-trail " << m_best_trail_size << ")\n";);
+        m_target_phase.reset();
+        m_target_trail_size = 0;
+        m_rephase_lim = m_stats.m_num_conflicts + m_fparams.m_rephase * (m_num_rephases + 1);
+    }
+
     /**
        \brief Update counter that is used to enable/disable phase caching.
     */
@@ -2725,6 +2814,7 @@ namespace smt {
        \brief Delete low activity lemmas
     */
     inline void context::del_inactive_lemmas() {
+        profile::scope _ps("smt.gc");
         if (m_fparams.m_lemma_gc_strategy == LGC_NONE)
             return;
         else if (m_fparams.m_lemma_gc_half)
@@ -3009,6 +3099,7 @@ namespace smt {
         bool was_consistent = !inconsistent();
         try {
             internalize_assertions(); // internalize assertions before invoking m_asserted_formulas.push_scope
+            internalize_retained();
         } catch (cancel_exception&) {
             throw default_exception("Resource limits hit in push");
         }
@@ -3026,6 +3117,8 @@ namespace smt {
         bs.m_lemmas_lim = m_lemmas.size();
         bs.m_inconsistent = inconsistent();
         bs.m_simp_qhead_lim = m_simp_qhead;
+        bs.m_enodes_lim = m_e_internalized_stack.size();
+        bs.m_bool_vars_lim = m_b_internalized_stack.size();
         m_base_lvl++;
         m_search_lvl++; // Not really necessary. But, it is useful to enforce the invariant m_search_lvl >= m_base_lvl
         SASSERT(m_base_lvl <= m_scope_lvl);
@@ -3035,7 +3128,92 @@ namespace smt {
         SASSERT (num_scopes > 0);
         if (num_scopes > m_scope_lvl) return;
         pop_to_base_lvl();
+        if (m_fparams.m_internalize_retain > 0)
+            count_popped_terms(num_scopes);
         pop_scope(num_scopes);
+        // persistent parallel workers hold copies of the popped assertions.
+        dealloc(m_par);
+        m_par = nullptr;
+    }
+
+    /**
+       \brief Count the compound terms internalized in the user scopes that are
+       about to be popped. Terms that reach the threshold smt.internalize.retain
+       are internalized at the base level by the next push.
+       The counts are reclaimed lazily, when the table of counts outgrows
+       the number of internalized terms.
+    */
+    void context::count_popped_terms(unsigned num_scopes) {
+        if (num_scopes > m_base_scopes.size())
+            return;
+        base_scope const & bs = m_base_scopes[m_base_scopes.size() - num_scopes];
+        unsigned threshold = m_fparams.m_internalize_retain;
+        if (m_popped_pinned.size() > 4 * m_e_internalized_stack.size() + 10000) {
+            m_popped_counts.reset();
+            m_popped_pinned.reset();
+        }
+        ast_mark seen;
+        auto count = [&](expr * e) {
+            if (!is_app(e) || to_app(e)->get_num_args() == 0 || ::has_quantifiers(e) || seen.is_marked(e))
+                return;
+            seen.mark(e, true);
+            unsigned & c = m_popped_counts.insert_if_not_there(e, 0);
+            if (c == 0)
+                m_popped_pinned.push_back(e);
+            if (++c == threshold)
+                m_retain_todo.push_back(e);
+        };
+        for (unsigned i = bs.m_enodes_lim; i < m_e_internalized_stack.size(); ++i)
+            count(m_e_internalized_stack.get(i));
+        for (unsigned i = bs.m_bool_vars_lim; i < m_b_internalized_stack.size(); ++i)
+            count(m_b_internalized_stack.get(i));
+    }
+
+    /**
+       \brief Return true if the uninterpreted constants of e are internalized.
+       Retained terms must not introduce symbols that were only used in popped scopes.
+    */
+    bool context::is_over_internalized_constants(expr * e) {
+        ast_mark visited;
+        ptr_buffer<expr> todo;
+        todo.push_back(e);
+        while (!todo.empty()) {
+            expr * curr = todo.back();
+            todo.pop_back();
+            if (visited.is_marked(curr))
+                continue;
+            visited.mark(curr, true);
+            if (!is_app(curr))
+                return false;
+            app * a = to_app(curr);
+            if (a->get_num_args() == 0) {
+                if (is_uninterp_const(a) && !e_internalized(a) && !b_internalized(a))
+                    return false;
+                continue;
+            }
+            if (e_internalized(a) || b_internalized(a))
+                continue;
+            for (expr * arg : *a)
+                todo.push_back(arg);
+        }
+        return true;
+    }
+
+    void context::internalize_retained() {
+        if (m_retain_todo.empty())
+            return;
+        if (!inconsistent()) {
+            for (expr * e : m_retain_todo) {
+                if (e_internalized(e) || b_internalized(e) || !is_over_internalized_constants(e))
+                    continue;
+                TRACE("internalize_retain", tout << mk_pp(e, m) << "\n";);
+                internalize(e, false);
+                m_stats.m_num_retained++;
+                if (inconsistent())
+                    break;
+            }
+        }
+        m_retain_todo.reset();
     }
 
     /**
@@ -3609,15 +3787,15 @@ namespace smt {
        and before internalizing any formulas.
     */
     lbool context::setup_and_check(bool reset_cancel) {
+        scoped_memory_tag _tag(memory::tag_smt);
         if (!check_preamble(reset_cancel)) return l_undef;
         SASSERT(m_scope_lvl == 0);
         SASSERT(!m_setup.already_configured());
         setup_context(m_fparams.m_auto_config);
 
         if (m_fparams.m_threads > 1 && !m.has_trace_stream()) {
-            parallel p(*this);
             expr_ref_vector asms(m);
-            return p(asms);
+            return check_parallel(asms);
         }
 
         try {
@@ -3637,6 +3815,20 @@ namespace smt {
         }
     }
 
+    /**
+       \brief Check using parallel workers. In persistent mode the worker contexts
+       are owned by m_par and reused by later checks until a scope is popped.
+    */
+    lbool context::check_parallel(expr_ref_vector const& asms) {
+        if (!m_fparams.m_threads_persistent) {
+            parallel p(*this);
+            return p(asms);
+        }
+        if (!m_par) 
+            m_par = alloc(parallel, *this);
+        return (*m_par)(asms);
+    }
+
     config_mode context::get_config_mode(bool use_static_features) const {
         if (!m_fparams.m_auto_config)
             return CFG_BASIC;
@@ -3676,13 +3868,13 @@ namespace smt {
     }
 
     lbool context::check(unsigned num_assumptions, expr * const * assumptions, bool reset_cancel) {
+        scoped_memory_tag _tag(memory::tag_smt);
         if (!check_preamble(reset_cancel)) return l_undef;
         SASSERT(at_base_level());
         setup_context(false);
         if (m_fparams.m_threads > 1 && !m.has_trace_stream()) {            
             expr_ref_vector asms(m, num_assumptions, assumptions);
-            parallel p(*this);
-            return p(asms);
+            return check_parallel(asms);
         }
         lbool r = l_undef;
         do {
@@ -3754,6 +3946,10 @@ namespace smt {
         m_phase_default                = false;
         m_case_split_queue             ->init_search_eh();
         m_next_progress_sample         = 0;
+        m_next_telemetry_sample        = 0;
+        m_last_telemetry_time          = 0;
+        m_last_telemetry_conflicts     = m_stats.m_num_conflicts;
+        m_last_telemetry_decisions     = m_stats.m_num_decisions;
         m_sls_completed                = l_undef;
         if (m.has_type_vars() && !m_theories.get_plugin(poly_family_id))
             register_plugin(alloc(theory_polymorphism, *this));
@@ -3887,10 +4083,17 @@ namespace smt {
             // execute the restart
             m_stats.m_num_restarts++;
             m_num_restarts++;
+            EVENT_TRACE(restart_k, m_stats.m_num_restarts, m_stats.m_num_conflicts);
             if (m_scope_lvl > curr_lvl) {
                 pop_scope(m_scope_lvl - curr_lvl);
                 SASSERT(at_search_level());
             }
+            if (m_fparams.m_rephase > 0) {
+                if (m_rephase_lim == 0)
+                    m_rephase_lim = m_fparams.m_rephase;
+                if (m_stats.m_num_conflicts >= m_rephase_lim)
+                    rephase();
+            }
             for (theory* th : m_theory_set) 
                 if (!inconsistent()) 
                     th->restart_eh();
@@ -4014,6 +4217,31 @@ namespace smt {
         }
     }
 
+    /**
+       \brief report the search statistics, the conflict and decision rates since the
+       previous sample, and the memory use to the progress callback.
+       The first sample of a search only sets the reference point.
+    */
+    void context::telemetry_sample() {
+        double now = m_timer.get_seconds();
+        if (m_next_telemetry_sample != 0) {
+            ::statistics st;
+            collect_statistics(st);
+            double elapsed = now - m_last_telemetry_time;
+            if (elapsed > 0) {
+                st.update("conflicts/s", (m_stats.m_num_conflicts - m_last_telemetry_conflicts) / elapsed);
+                st.update("decisions/s", (m_stats.m_num_decisions - m_last_telemetry_decisions) / elapsed);
+            }
+            st.update("time", now);
+            get_memory_statistics(st);
+            m_progress_callback->telemetry_sample(st);
+        }
+        m_last_telemetry_time = now;
+        m_last_telemetry_conflicts = m_stats.m_num_conflicts;
+        m_last_telemetry_decisions = m_stats.m_num_decisions;
+        m_next_telemetry_sample = static_cast<unsigned>(now * 1000) + m_progress_callback->telemetry_interval();
+    }
+
     bool context::resource_limits_exceeded() {
         if (m_searching) {
             // Some of the flags only make sense to check when searching.
@@ -4030,6 +4258,9 @@ namespace smt {
                     m_progress_callback->slow_progress_sample();
                     m_next_progress_sample = (unsigned)(m_timer.get_seconds() * 1000) + m_fparams.m_progress_sampling_freq;
                 }
+                if (m_progress_callback->telemetry_interval() > 0 && 
+                    (m_next_telemetry_sample == 0 || m_timer.ms_timeout(m_next_telemetry_sample)))
+                    telemetry_sample();
             }
         }
 
@@ -4045,6 +4276,7 @@ namespace smt {
     }
 
     final_check_status context::final_check() {
+        profile::scope _ps("smt.final-check");
         TRACE("final_check", tout << "final_check inconsistent: " << inconsistent() << "\n"; display(tout); display_normalized_enodes(tout););
         CASSERT("relevancy", check_relevancy());
         
@@ -4075,7 +4307,11 @@ namespace smt {
             if (m_final_check_idx < num_th) {
                 theory * th = m_theory_set[m_final_check_idx];
                 IF_VERBOSE(100, verbose_stream() << "(smt.final-check \"" << th->get_name() << "\")\n";);
-                ok = th->final_check_eh();
+                {
+                    profile::scope _ps(th->get_name());
+                    ok = th->final_check_eh();
+                }
+                EVENT_TRACE(final_check_k, th->get_id(), ok);
                 TRACE("final_check_step", tout << "final check '" << th->get_name() << " ok: " << ok << " inconsistent " << inconsistent() << "\n";);
                 if (get_cancel_flag()) {
                     f = CANCELED;
@@ -4129,7 +4365,7 @@ namespace smt {
         if (m.proofs_enabled() && m_fparams.m_check_proof) {
             proof_checker pf(m);
             expr_ref_vector side_conditions(m);
-            pf.check(pr, side_conditions);
+            pf.check(pr, side_conditions, m_fparams.m_threads);
         }
     }
 
@@ -4146,8 +4382,10 @@ namespace smt {
 
 
     bool context::resolve_conflict() {
+        update_target_phase();
         m_stats.m_num_conflicts++;
         m_num_conflicts ++;
+        EVENT_TRACE(conflict_k, m_stats.m_num_conflicts, m_scope_lvl);
         m_num_conflicts_since_restart ++;
         m_num_conflicts_since_lemma_gc ++;
         switch (m_conflict.get_kind()) {
@@ -109,6 +109,10 @@ namespace smt {
         mutable unsigned            m_lemma_id;
         progress_callback *         m_progress_callback;
         unsigned                    m_next_progress_sample;
+        unsigned                    m_next_telemetry_sample;
+        double                      m_last_telemetry_time;
+        unsigned                    m_last_telemetry_conflicts;
+        unsigned                    m_last_telemetry_decisions;
         clause_proof                m_clause_proof;
         region                      m_region;
         fingerprint_set             m_fingerprints;
@@ -120,6 +124,11 @@ namespace smt {
         expr_ref_vector             m_e_internalized_stack; // stack of the expressions already internalized as enodes.
         quantifier_ref_vector       m_l_internalized_stack;
 
+        // terms internalized in popped user scopes, see smt.internalize.retain
+        obj_map<expr, unsigned>     m_popped_counts;  // number of popped user scopes a term was internalized in
+        expr_ref_vector             m_popped_pinned;
+        expr_ref_vector             m_retain_todo;    // terms to internalize at the next push
+
         ptr_vector<justification>   m_justifications;
 
         unsigned                    m_final_check_idx = 0; // circular counter used for implementing fairness
@@ -202,6 +211,12 @@ namespace smt {
         bool                        m_phase_cache_on { true };
         unsigned                    m_phase_counter { 0 }; //!< auxiliary variable used to decide when to turn on/off phase caching
         bool                        m_phase_default { false }; //!< default phase when using phase caching
+        svector<lbool>              m_target_phase;        //!< assignment of the longest trail since the last rephase
+        svector<lbool>              m_best_phase;          //!< assignment of the longest trail so far
+        unsigned                    m_target_trail_size { 0 };
+        unsigned                    m_best_trail_size { 0 };
+        unsigned                    m_num_rephases { 0 };
+        unsigned                    m_rephase_lim { 0 };
 
         // A conflict is usually a single justification. That is, a justification
         // for false. If m_not_l is not null_literal, then m_conflict is a
@@ -667,6 +682,8 @@ namespace smt {
             unsigned                m_lemmas_lim;
             unsigned                m_simp_qhead_lim;
             unsigned                m_inconsistent;
+            unsigned                m_enodes_lim;
+            unsigned                m_bool_vars_lim;
         };
 
         svector<scope>              m_scopes;
@@ -674,6 +691,12 @@ namespace smt {
 
         void push_scope();
 
+        void count_popped_terms(unsigned num_scopes);
+
+        bool is_over_internalized_constants(expr * e);
+
+        void internalize_retained();
+
         unsigned pop_scope_core(unsigned num_scopes);
 
         void pop_scope(unsigned num_scopes);
@@ -1181,6 +1204,10 @@ namespace smt {
 
         bool guess(bool_var var, lbool phase);
 
+        void update_target_phase();
+
+        void rephase();
+
     protected:
         bool m_has_case_split = true;
         bool decide();
@@ -1578,6 +1605,8 @@ namespace smt {
         bool check_preamble(bool reset_cancel);
         lbool check_finalize(lbool r);
 
+        lbool check_parallel(expr_ref_vector const& asms);
+
         // -----------------------------------
         //
         // API
@@ -1683,6 +1712,8 @@ namespace smt {
 
         bool resource_limits_exceeded();
 
+        void telemetry_sample();
+
         failure get_last_search_failure() const;
 
         proof * get_proof();
@@ -1804,6 +1835,12 @@ namespace smt {
             m_user_propagator->register_decide(r);
         }
 
+        void user_propagate_register_batch(user_propagator::batch_eh_t& r) {
+            if (!m_user_propagator)
+                throw default_exception("user propagator must be initialized");
+            m_user_propagator->register_batch(r);
+        }
+
         void user_propagate_initialize_value(expr* var, expr* value);
 
         bool watches_fixed(enode* n) const;
@@ -17,6 +17,7 @@ Revision History:
 
 --*/
 #include "smt/smt_context.h"
+#include "smt/smt_parallel.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_pp_util.h"
@@ -407,11 +408,17 @@ namespace smt {
 
     void context::collect_statistics(::statistics & st) const {
         st.copy(m_aux_stats);
+        if (m_par)
+            m_par->collect_statistics(st);
         st.update("conflicts", m_stats.m_num_conflicts);
         st.update("decisions", m_stats.m_num_decisions);
         st.update("propagations", m_stats.m_num_propagations + m_stats.m_num_bin_propagations);
         st.update("binary propagations", m_stats.m_num_bin_propagations);
         st.update("restarts", m_stats.m_num_restarts);
+        if (m_stats.m_num_rephases > 0)
+            st.update("rephases", m_stats.m_num_rephases);
+        if (m_stats.m_num_retained > 0)
+            st.update("retained terms", m_stats.m_num_retained);
         st.update("final checks", m_stats.m_num_final_checks);
         st.update("added eqs", m_stats.m_num_add_eq);
         st.update("mk clause", m_stats.m_num_mk_clause);
@@ -394,6 +394,40 @@ namespace smt {
     void ext_theory_eq_propagation_justification::log(context& ctx) {
     }
 
+    void ext_theory_log_justification::get_antecedents(conflict_resolution & cr) {
+        literal const * lits = m_log.lits(m_idx);
+        for (unsigned i = 0, n = m_log.num_lits(m_idx); i < n; ++i)
+            cr.mark_literal(lits[i]);
+        enode_pair const * eqs = m_log.eqs(m_idx);
+        for (unsigned i = 0, n = m_log.num_eqs(m_idx); i < n; ++i)
+            cr.mark_eq(eqs[i].first, eqs[i].second);
+    }
+
+    proof * ext_theory_log_justification::mk_proof(conflict_resolution & cr) {
+        ptr_buffer<proof> prs;
+        bool visited = true;
+        literal const * lits = m_log.lits(m_idx);
+        for (unsigned i = 0, n = m_log.num_lits(m_idx); i < n; ++i) {
+            proof * pr = cr.get_proof(lits[i]);
+            visited &= pr != nullptr;
+            if (pr)
+                prs.push_back(pr);
+        }
+        enode_pair const * eqs = m_log.eqs(m_idx);
+        for (unsigned i = 0, n = m_log.num_eqs(m_idx); i < n; ++i) {
+            proof * pr = cr.get_proof(eqs[i].first, eqs[i].second);
+            visited &= pr != nullptr;
+            if (pr)
+                prs.push_back(pr);
+        }
+        if (!visited)
+            return nullptr;
+        ast_manager & m = cr.get_manager();
+        expr_ref fact(m);
+        cr.get_context().literal2expr(m_consequent, fact);
+        return m.mk_th_lemma(m_th_id, fact, prs.size(), prs.data());
+    }
+
     
     theory_lemma_justification::theory_lemma_justification(family_id fid, context & ctx, unsigned num_lits, literal const * lits,
                                                            unsigned num_params, parameter* params):
@@ -393,6 +393,87 @@ namespace smt {
         char const * get_name() const override { return "ext-theory-eq-propagation"; }
     };  
 
+    /**
+       \brief Explanations of theory propagations owned by a theory.
+       An explanation is stored once and referenced by index from the justifications
+       of all literals it implies. The theory pushes and pops the log together with
+       its scopes, so an entry lives as long as the justifications of its scope.
+    */
+    class explanation_log {
+        struct entry {
+            unsigned m_lits_begin;
+            unsigned m_eqs_begin;
+        };
+        svector<entry>      m_entries;
+        literal_vector      m_lits;
+        svector<enode_pair> m_eqs;
+        unsigned_vector     m_lim;
+
+        unsigned lits_end(unsigned idx) const { return idx + 1 < m_entries.size() ? m_entries[idx + 1].m_lits_begin : m_lits.size(); }
+        unsigned eqs_end(unsigned idx) const { return idx + 1 < m_entries.size() ? m_entries[idx + 1].m_eqs_begin : m_eqs.size(); }
+    public:
+        unsigned add(unsigned num_lits, literal const * lits, unsigned num_eqs, enode_pair const * eqs) {
+            m_entries.push_back({ m_lits.size(), m_eqs.size() });
+            m_lits.append(num_lits, lits);
+            m_eqs.append(num_eqs, eqs);
+            return m_entries.size() - 1;
+        }
+
+        unsigned size() const { return m_entries.size(); }
+        unsigned num_lits(unsigned idx) const { return lits_end(idx) - m_entries[idx].m_lits_begin; }
+        unsigned num_eqs(unsigned idx) const { return eqs_end(idx) - m_entries[idx].m_eqs_begin; }
+        literal const * lits(unsigned idx) const { return m_lits.data() + m_entries[idx].m_lits_begin; }
+        enode_pair const * eqs(unsigned idx) const { return m_eqs.data() + m_entries[idx].m_eqs_begin; }
+
+        bool matches(unsigned idx, unsigned num_lits, literal const * lits, unsigned num_eqs, enode_pair const * eqs) const {
+            if (idx >= m_entries.size() || num_lits != this->num_lits(idx) || num_eqs != this->num_eqs(idx))
+                return false;
+            literal const * ls = this->lits(idx);
+            for (unsigned i = 0; i < num_lits; ++i)
+                if (ls[i] != lits[i])
+                    return false;
+            enode_pair const * es = this->eqs(idx);
+            for (unsigned i = 0; i < num_eqs; ++i)
+                if (es[i] != eqs[i])
+                    return false;
+            return true;
+        }
+
+        void push_scope() { m_lim.push_back(m_entries.size()); }
+
+        void pop_scope(unsigned num_scopes) {
+            unsigned sz = m_lim[m_lim.size() - num_scopes];
+            m_lim.shrink(m_lim.size() - num_scopes);
+            if (sz < m_entries.size()) {
+                m_lits.shrink(m_entries[sz].m_lits_begin);
+                m_eqs.shrink(m_entries[sz].m_eqs_begin);
+                m_entries.shrink(sz);
+            }
+        }
+    };
+
+    /**
+       \brief Theory propagation whose antecedents are an entry of an explanation_log.
+       It does not copy the antecedents and does not record proof parameters.
+    */
+    class ext_theory_log_justification : public justification {
+        theory_id               m_th_id;
+        unsigned                m_idx;
+        literal                 m_consequent;
+        explanation_log const & m_log;
+    public:
+        ext_theory_log_justification(theory_id th_id, explanation_log const & log, unsigned idx, literal consequent):
+            m_th_id(th_id), m_idx(idx), m_consequent(consequent), m_log(log) {}
+
+        void get_antecedents(conflict_resolution & cr) override;
+
+        theory_id get_from_theory() const override { return m_th_id; }
+
+        proof * mk_proof(conflict_resolution & cr) override;
+
+        char const * get_name() const override { return "ext-theory-log-propagation"; }
+    };
+
     /**
        \brief A theory lemma is similar to a theory axiom, but it is attached to a CLS_AUX_LEMMA clause instead of CLS_AUX.
        So, it cannot be stored in the heap, and it is unsafe to store literals, since it may be deleted during backtracking.
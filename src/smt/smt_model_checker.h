@@ -84,7 +84,7 @@ namespace smt {
         quantifier * get_flat_quantifier(quantifier * q);
 
         struct is_model_value {};
-        expr_mark m_visited;
+        expr_epoch_mark m_visited;
         bool contains_model_value(expr * e);
         void add_instance(quantifier * q, expr_ref_vector const & bindings, unsigned max_generation, expr * def);
         bool is_safe_for_mbqi(quantifier * q) const;
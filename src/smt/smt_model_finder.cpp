@@ -67,7 +67,7 @@ namespace smt {
             ast_manager&            m;
             obj_map<expr, unsigned> m_elems; // and the associated generation
             obj_map<expr, expr*>    m_inv;
-            expr_mark               m_visited;
+            expr_epoch_mark         m_visited;
         public:
             instantiation_set(ast_manager& m) :m(m) {}
 
@@ -541,7 +541,7 @@ namespace smt {
             }
 
             struct found_array : public std::exception {};
-            expr_mark m_visited;
+            expr_epoch_mark m_visited;
             void operator()(expr* n) {
                 if (m_array.is_array(n))
                     throw found_array();
@@ -2317,7 +2317,8 @@ namespace smt {
         m_analyzer(alloc(quantifier_analyzer, *this, m)),
         m_auf_solver(alloc(auf_solver, m)),
         m_dependencies(m),
-        m_new_constraints(m) {
+        m_new_constraints(m),
+        m_macro_cache(m) {
     }
 
     model_finder::~model_finder() {
@@ -2352,6 +2353,7 @@ namespace smt {
         quantifier_info* new_info = alloc(quantifier_info, *this, m, q);
         m_q2info.insert(q, new_info);
         m_quantifiers.push_back(q);
+        m_macro_cache.reset();
         m_analyzer->operator()(new_info);
         TRACE("model_finder", tout << "after analyzer:\n"; new_info->display(tout););
     }
@@ -2365,6 +2367,8 @@ namespace smt {
     void model_finder::restore_quantifiers(unsigned old_size) {
         unsigned curr_size = m_quantifiers.size();
         SASSERT(old_size <= curr_size);
+        if (old_size < curr_size)
+            m_macro_cache.reset();
         for (unsigned i = old_size; i < curr_size; i++) {
             quantifier* q = m_quantifiers[i];
             SASSERT(m_q2info.contains(q));
@@ -2435,12 +2439,14 @@ namespace smt {
 
     void model_finder::process_simple_macros(ptr_vector<quantifier>& qs, ptr_vector<quantifier>& residue, proto_model* mdl) {
         simple_macro_solver sms(m, *this);
+        sms.set_else_log(m_macro_cache.m_decls, m_macro_cache.m_defs);
         sms(*mdl, qs, residue);
         TRACE("model_finder", tout << "model after processing simple macros:\n"; model_pp(tout, *mdl););
     }
 
     void model_finder::process_hint_macros(ptr_vector<quantifier>& qs, ptr_vector<quantifier>& residue, proto_model* mdl) {
         hint_macro_solver hms(m, *this);
+        hms.set_else_log(m_macro_cache.m_decls, m_macro_cache.m_defs);
         hms(*mdl, qs, residue);
         TRACE("model_finder", tout << "model after processing simple macros:\n"; model_pp(tout, *mdl););
     }
@@ -2448,6 +2454,7 @@ namespace smt {
     void model_finder::process_non_auf_macros(ptr_vector<quantifier>& qs, ptr_vector<quantifier>& residue, proto_model* mdl) {
         non_auf_macro_solver nas(m, *this, m_dependencies);
         nas.set_mbqi_force_template(m_context->get_fparams().m_mbqi_force_template);
+        nas.set_else_log(m_macro_cache.m_decls, m_macro_cache.m_defs);
         nas(*mdl, qs, residue);
         TRACE("model_finder", tout << "model after processing non auf macros:\n"; model_pp(tout, *mdl););
     }
@@ -2469,19 +2476,60 @@ namespace smt {
         if (m_quantifiers.empty())
             return;
         ptr_vector<quantifier> qs;
-        ptr_vector<quantifier> residue;
         collect_relevant_quantifiers(qs);
         if (qs.empty())
             return;
         TRACE("model_finder", tout << "trying to satisfy quantifiers, given model:\n"; model_pp(tout, *m););
         cleanup_quantifier_infos(qs);
+        if (!replay_macros(qs, m))
+            process_macros(qs, m);
+        process_auf(qs, m);
+    }
+
+    /**
+       \brief Run the macro solvers on qs and record their result.
+       On return qs contains the quantifiers for the auf solver.
+    */
+    void model_finder::process_macros(ptr_vector<quantifier>& qs, proto_model* m) {
+        ptr_vector<quantifier> residue;
+        m_macro_cache.reset();
+        m_macro_cache.m_qs.append(qs);
         m_dependencies.reset();
 
         process_simple_macros(qs, residue, m);
         process_hint_macros(qs, residue, m);
         process_non_auf_macros(qs, residue, m);
         qs.append(residue);
-        process_auf(qs, m);
+
+        for (quantifier* q : m_macro_cache.m_qs)
+            m_macro_cache.m_the_one.push_back(get_quantifier_info(q)->get_the_one());
+        m_macro_cache.m_auf_qs.append(qs);
+        m_macro_cache.m_valid = true;
+    }
+
+    /**
+       \brief Reuse the result of the macro solvers if the relevant quantifiers
+       are the ones of the previous call.
+    */
+    bool model_finder::replay_macros(ptr_vector<quantifier>& qs, proto_model* m) {
+        if (!m_macro_cache.m_valid || m_macro_cache.m_qs != qs)
+            return false;
+        TRACE("model_finder", tout << "reusing macros of the previous model\n";);
+        unsigned sz = m_macro_cache.m_decls.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            func_decl* f = m_macro_cache.m_decls.get(i);
+            func_interp* fi = m->get_func_interp(f);
+            if (fi == nullptr) {
+                fi = alloc(func_interp, this->m, f->get_arity());
+                m->register_decl(f, fi);
+            }
+            fi->set_else(m_macro_cache.m_defs.get(i));
+        }
+        for (unsigned i = 0; i < m_macro_cache.m_qs.size(); ++i)
+            get_quantifier_info(m_macro_cache.m_qs[i])->set_the_one(m_macro_cache.m_the_one[i]);
+        qs.reset();
+        qs.append(m_macro_cache.m_auf_qs);
+        return true;
     }
 
     quantifier* model_finder::get_flat_quantifier(quantifier* q) {
@@ -88,6 +88,21 @@ namespace smt {
         
         expr_ref_vector                        m_new_constraints; // new constraints for fresh constants created by the model finder
 
+        // Result of the macro solvers for the relevant quantifiers of the last call to fix_model.
+        // The macro solvers only depend on the quantifiers, so the result is replayed
+        // as long as the set of relevant quantifiers does not change.
+        struct macro_cache {
+            bool                   m_valid = false;
+            ptr_vector<quantifier> m_qs;          // relevant quantifiers
+            ptr_vector<func_decl>  m_the_one;     // the macro head satisfying each quantifier in m_qs
+            ptr_vector<quantifier> m_auf_qs;      // quantifiers passed to the auf solver
+            func_decl_ref_vector   m_decls;       // else interpretations set by the macro solvers
+            expr_ref_vector        m_defs;
+            macro_cache(ast_manager& m): m_decls(m), m_defs(m) {}
+            void reset() { m_valid = false; m_qs.reset(); m_the_one.reset(); m_auf_qs.reset(); m_decls.reset(); m_defs.reset(); }
+        };
+        macro_cache                            m_macro_cache;
+
         void restore_quantifiers(unsigned old_size);
         quantifier_info * get_quantifier_info(quantifier * q);
         void collect_relevant_quantifiers(ptr_vector<quantifier> & qs) const;
@@ -96,6 +111,8 @@ namespace smt {
         void process_hint_macros(ptr_vector<quantifier> & qs, ptr_vector<quantifier> & residue, proto_model * m);
         void process_non_auf_macros(ptr_vector<quantifier> & qs, ptr_vector<quantifier> & residue, proto_model * m);
         void process_auf(ptr_vector<quantifier> const & qs, proto_model * m);
+        bool replay_macros(ptr_vector<quantifier> & qs, proto_model * m);
+        void process_macros(ptr_vector<quantifier> & qs, proto_model * m);
         instantiation_set const * get_uvar_inst_set(quantifier * q, unsigned i);
         void checkpoint();
 
@@ -24,6 +24,29 @@ Author:
 #include "smt/smt_parallel.h"
 #include "smt/smt_lookahead.h"
 
+namespace smt {
+
+    void parallel::reset_workers() {
+        for (context* c : m_pctxs) 
+            c->collect_statistics(ctx.m_aux_stats);
+        m_import_tr.reset();
+        m_export_tr.reset();
+        m_pctxs.reset();
+        m_pms.reset();
+        m_params.reset();
+        m_units.reset();
+        m_unit_set.reset();
+        m_export_lim.reset();
+        m_import_lim.reset();
+        m_num_formulas = 0;
+    }
+
+    void parallel::collect_statistics(::statistics& st) const {
+        for (context* c : m_pctxs)
+            c->collect_statistics(st);
+    }
+}
+
 #ifdef SINGLE_THREAD
 
 namespace smt {
@@ -36,8 +59,20 @@ namespace smt {
 #else
 
 #include <thread>
+#include <atomic>
+#include <condition_variable>
 
 namespace smt {
+
+    static void cube(context& ctx, expr_ref_vector& lasms, expr_ref& c) {
+        lookahead lh(ctx);
+        c = lh.choose();
+        if (c) {
+            if ((ctx.get_random_value() % 2) == 0) 
+                c = c.get_manager().mk_not(c);
+            lasms.push_back(c);
+        }
+    }
     
     lbool parallel::operator()(expr_ref_vector const& asms) {
 
@@ -55,6 +90,11 @@ namespace smt {
             return result;
         }        
 
+        if (ctx.get_fparams().m_threads_cube_and_conquer)
+            return check_cubes(asms, num_threads, thread_max_conflicts, max_conflicts);
+        if (ctx.get_fparams().m_threads_persistent)
+            return check_persistent(asms, num_threads, thread_max_conflicts, max_conflicts);
+
         enum par_exception_kind {
             DEFAULT_EX,
             ERROR_EX
@@ -92,16 +132,6 @@ namespace smt {
             sl.push_child(&(new_m->limit()));
         }
 
-        auto cube = [](context& ctx, expr_ref_vector& lasms, expr_ref& c) {
-            lookahead lh(ctx);
-            c = lh.choose();
-            if (c) {
-                if ((ctx.get_random_value() % 2) == 0) 
-                    c = c.get_manager().mk_not(c);
-                lasms.push_back(c);
-            }
-        };
-
         obj_hashtable<expr> unit_set;
         expr_ref_vector unit_trail(ctx.m);
         unsigned_vector unit_lim;
@@ -262,5 +292,516 @@ namespace smt {
         return result;
     }
 
+
+    // bound on the translations cached for each pair of ctx.m and a worker manager.
+    static const unsigned max_translation_cache = 1 << 16;
+
+    /**
+       \brief create worker contexts as copies of ctx.
+    */
+    void parallel::init_workers(unsigned num_threads) {
+        reset_workers();
+        ast_manager& m = ctx.m;
+        for (unsigned i = 0; i < num_threads; ++i) 
+            m_params.push_back(alloc(smt_params, ctx.get_fparams()));
+        for (unsigned i = 0; i < num_threads; ++i) {
+            ast_manager* new_m = alloc(ast_manager, m, true);
+            m_pms.push_back(new_m);
+            m_pctxs.push_back(alloc(context, *new_m, *m_params[i], ctx.get_params()));
+            context& new_ctx = *m_pctxs.back();
+            context::copy(ctx, new_ctx, true);
+            new_ctx.set_random_seed(i + ctx.get_fparams().m_random_seed);
+            m_import_tr.push_back(alloc(ast_translation, m, *new_m, false));
+            m_export_tr.push_back(alloc(ast_translation, *new_m, m, false));
+            m_import_tr.back()->set_max_cache_size(max_translation_cache);
+            m_export_tr.back()->set_max_cache_size(max_translation_cache);
+        }
+        m_export_lim.resize(num_threads, 0);
+        m_import_lim.resize(num_threads, 0);
+        m_num_formulas = ctx.m_asserted_formulas.get_num_formulas();
+    }
+
+    /**
+       \brief assert the formulas added to ctx since the workers were last synchronized.
+       Formulas of ctx below its queue head are not rewritten any more, so the 
+       workers only have to receive the suffix.
+    */
+    void parallel::sync_workers() {
+        ast_manager& m = ctx.m;
+        asserted_formulas& af = ctx.m_asserted_formulas;
+        unsigned sz = af.get_num_formulas();
+        for (unsigned i = 0; i < m_pctxs.size(); ++i) {
+            context& pctx = *m_pctxs[i];
+            pctx.pop_to_base_lvl();
+            pctx.m.update_fresh_id(m);
+            ast_translation& tr = *m_import_tr[i];
+            for (unsigned j = m_num_formulas; j < sz; ++j) 
+                if (!m.is_true(af.get_formula(j)))
+                    pctx.assert_expr(tr(af.get_formula(j)));
+        }
+        IF_VERBOSE(1, verbose_stream() << "(smt.thread :sync " << (sz - m_num_formulas) << ")\n");
+        m_num_formulas = sz;
+    }
+
+    /**
+       \brief check asms using worker contexts that are kept across calls.
+       Each worker runs with a growing conflict budget and exchanges its units 
+       with the other workers through m_units after each budget, without waiting
+       for the other workers.
+     */
+    lbool parallel::check_persistent(expr_ref_vector const& asms, unsigned num_threads, unsigned thread_max_conflicts, unsigned max_conflicts) {
+        ast_manager& m = ctx.m;
+        if (m_pctxs.size() != num_threads || ctx.m_asserted_formulas.get_num_formulas() < m_num_formulas)
+            init_workers(num_threads);
+        else
+            sync_workers();
+
+        enum par_exception_kind {
+            DEFAULT_EX,
+            ERROR_EX
+        };
+
+        scoped_limits sl(m.limit());
+        for (ast_manager* pm : m_pms)
+            sl.push_child(&(pm->limit()));
+        std::mutex mux;
+        lbool result = l_undef;
+        unsigned finished_id = UINT_MAX;
+        std::string        ex_msg;
+        par_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        std::atomic<bool> done(false);
+        unsigned cube_frequency = std::max(1u, ctx.get_fparams().m_threads_cube_frequency);
+
+        // import the units of the other workers and export the new units of worker i.
+        auto exchange = [&](unsigned i) {
+            context& pctx = *m_pctxs[i];
+            ast_manager& pm = *m_pms[i];
+            pctx.pop_to_base_lvl();
+            expr_ref_vector imported(pm);
+            unsigned num_exported = 0;
+            {
+                std::lock_guard<std::mutex> lock(mux);
+                pm.update_fresh_id(m);
+                m.update_fresh_id(pm);
+                ast_translation& tr_in = *m_import_tr[i];
+                for (unsigned j = m_import_lim[i]; j < m_units.size(); ++j) 
+                    imported.push_back(tr_in(m_units.get(j)));
+                ast_translation& tr_out = *m_export_tr[i];
+                auto const& lits = pctx.assigned_literals();
+                for (unsigned j = m_export_lim[i]; j < lits.size(); ++j) {
+                    literal lit = lits[j];
+                    expr_ref e(pctx.bool_var2expr(lit.var()), pm);
+                    if (lit.sign()) e = pm.mk_not(e);
+                    expr_ref ce(tr_out(e.get()), m);
+                    if (!m.is_true(ce) && !m_unit_set.contains(ce)) {
+                        m_unit_set.insert(ce);
+                        m_units.push_back(ce);
+                        ++num_exported;
+                    }
+                }
+                m_export_lim[i] = lits.size();
+                m_import_lim[i] = m_units.size();
+            }
+            for (expr* e : imported)
+                pctx.assert_expr(e);
+            IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :exported " << num_exported << " :imported " << imported.size() << ")\n");
+        };
+
+        auto worker_thread = [&](unsigned i) {
+            try {
+                context& pctx = *m_pctxs[i];
+                ast_manager& pm = *m_pms[i];
+                expr_ref_vector pasms(pm);
+                {
+                    std::lock_guard<std::mutex> lock(mux);
+                    ast_translation& tr = *m_import_tr[i];
+                    pasms.append(tr(asms));
+                }
+                unsigned budget = thread_max_conflicts;
+                unsigned num_conflicts = 0;
+                for (unsigned round = 0; !done; ++round) {
+                    expr_ref_vector lasms(pasms);
+                    expr_ref c(pm);
+                    unsigned max_c = std::min(budget, max_conflicts - num_conflicts);
+                    pctx.get_fparams().m_max_conflicts = max_c;
+                    if (round > 0 && (round % cube_frequency) == 0)
+                        cube(pctx, lasms, c);
+                    IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :round " << round;
+                               if (c) verbose_stream() << " :cube " << mk_bounded_pp(c, pm, 3);
+                               verbose_stream() << ")\n";);
+                    lbool r = pctx.check(lasms.size(), lasms.data());
+                    num_conflicts += std::min(pctx.m_num_conflicts, max_conflicts - num_conflicts);
+
+                    if (r == l_undef && !pm.limit().is_canceled() && pctx.m_num_conflicts >= max_c && num_conflicts < max_conflicts) {
+                        exchange(i);
+                        budget = budget > UINT_MAX / 2 ? UINT_MAX : 2 * budget;
+                        continue;
+                    }
+                    if (r == l_false && c && pctx.unsat_core().contains(c)) {
+                        IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :learn " << mk_bounded_pp(c, pm, 3) << ")\n");
+                        pctx.assert_expr(mk_not(mk_and(pctx.unsat_core())));
+                        exchange(i);
+                        continue;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(mux);
+                        if (finished_id == UINT_MAX) {
+                            finished_id = i;
+                            result = r;
+                            done = true;
+                        }
+                        else if (r != l_undef && result == l_undef) {
+                            finished_id = i;
+                            result = r;
+                            return;
+                        }
+                        else 
+                            return;
+                    }
+                    for (ast_manager* om : m_pms) 
+                        if (om != &pm) om->limit().cancel();
+                    return;
+                }
+            }
+            catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (finished_id == UINT_MAX) {
+                    error_code = err.error_code();
+                    ex_kind = ERROR_EX;
+                    done = true;
+                }
+            }
+            catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (finished_id == UINT_MAX) {
+                    ex_msg = ex.what();
+                    ex_kind = DEFAULT_EX;
+                    done = true;
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (finished_id == UINT_MAX) {
+                    ex_msg = "unknown exception";
+                    ex_kind = ERROR_EX;
+                    done = true;
+                }
+            }
+        };
+
+        vector<std::thread> threads(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) 
+            threads[i] = std::thread([&, i]() { worker_thread(i); });
+        for (auto & th : threads) 
+            th.join();
+        for (ast_manager* pm : m_pms)
+            pm->limit().reset_cancel();
+
+        if (finished_id == UINT_MAX) {
+            // the workers may be left in an arbitrary state.
+            reset_workers();
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(std::move(ex_msg));
+            }
+        }
+
+        model_ref mdl;
+        context& pctx = *m_pctxs[finished_id];
+        m.update_fresh_id(*m_pms[finished_id]);
+        ast_translation& tr = *m_export_tr[finished_id];
+        switch (result) {
+        case l_true:
+            pctx.get_model(mdl);
+            if (mdl)
+                ctx.set_model(mdl->translate(tr));
+            break;
+        case l_false:
+            ctx.m_unsat_core.reset();
+            for (expr* e : pctx.unsat_core())
+                ctx.m_unsat_core.push_back(tr(e));
+            break;
+        default:
+            break;
+        }
+        return result;
+    }
+
+    /**
+       \brief cube and conquer.
+       Cubes form a tree rooted in the empty cube. Workers take open cubes from a
+       shared queue and check them with a conflict budget. A cube that is not 
+       decided within its budget is split on the literal chosen by lookahead. 
+       The formula is unsatisfiable when all leaves of the tree are refuted, and 
+       the unsat core is the union of the assumptions used to refute the leaves.
+     */
+    lbool parallel::check_cubes(expr_ref_vector const& asms, unsigned num_threads, unsigned thread_max_conflicts, unsigned max_conflicts) {
+        ast_manager& m = ctx.m;
+        if (!ctx.get_fparams().m_threads_persistent || m_pctxs.size() != num_threads || ctx.m_asserted_formulas.get_num_formulas() < m_num_formulas)
+            init_workers(num_threads);
+        else
+            sync_workers();
+
+        enum par_exception_kind {
+            DEFAULT_EX,
+            ERROR_EX
+        };
+
+        struct cube_node {
+            unsigned m_parent;
+            unsigned m_lit;     // index into lits, UINT_MAX for the root
+            unsigned m_depth;
+            unsigned m_budget;
+        };
+        svector<cube_node> nodes;
+        expr_ref_vector lits(m);
+        unsigned_vector queue;
+        unsigned qhead = 0;
+        unsigned num_active = 0;
+        unsigned num_unsat = 0, num_splits = 0, max_depth = 0;
+        unsigned num_conflicts = 0;
+        bool incomplete = false;
+        obj_hashtable<expr> core_set;
+        expr_ref_vector core(m);
+        nodes.push_back({ UINT_MAX, UINT_MAX, 0, thread_max_conflicts });
+        queue.push_back(0);
+
+        scoped_limits sl(m.limit());
+        for (ast_manager* pm : m_pms)
+            sl.push_child(&(pm->limit()));
+        std::mutex mux;
+        std::condition_variable cond;
+        lbool result = l_undef;
+        unsigned finished_id = UINT_MAX;
+        std::string        ex_msg;
+        par_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        bool done = false;
+        bool has_exception = false;
+
+        auto cube_of = [&](unsigned id, ptr_vector<expr>& cube) {
+            for (; nodes[id].m_lit != UINT_MAX; id = nodes[id].m_parent)
+                cube.push_back(lits.get(nodes[id].m_lit));
+        };
+
+        // cube progress is reported by the worker that closes a cube once the interval elapsed.
+        progress_callback* progress = ctx.m_progress_callback;
+        timer progress_timer;
+        unsigned next_progress_sample = progress ? progress->telemetry_interval() : 0;
+        auto report_progress = [&]() {
+            if (next_progress_sample == 0 || !progress_timer.ms_timeout(next_progress_sample))
+                return;
+            double now = progress_timer.get_seconds();
+            ::statistics st;
+            st.update("conflicts", num_conflicts);
+            st.update("conflicts/s", num_conflicts / now);
+            st.update("cubes", nodes.size());
+            st.update("cubes open", queue.size() - qhead);
+            st.update("cubes active", num_active);
+            st.update("cubes unsat", num_unsat);
+            st.update("cube splits", num_splits);
+            st.update("cube depth", max_depth);
+            st.update("time", now);
+            get_memory_statistics(st);
+            progress->telemetry_sample(st);
+            next_progress_sample = static_cast<unsigned>(now * 1000) + progress->telemetry_interval();
+        };
+
+        auto finish = [&](unsigned i, lbool r) {
+            if (finished_id == UINT_MAX) {
+                finished_id = i;
+                result = r;
+            }
+            done = true;
+            for (ast_manager* pm : m_pms)
+                pm->limit().cancel();
+        };
+
+        auto worker_thread = [&](unsigned i) {
+            context& pctx = *m_pctxs[i];
+            ast_manager& pm = *m_pms[i];
+            try {
+                expr_ref_vector pasms(pm);
+                {
+                    std::lock_guard<std::mutex> lock(mux);
+                    ast_translation& tr = *m_import_tr[i];
+                    pasms.append(tr(asms));
+                }
+                while (true) {
+                    unsigned id;
+                    expr_ref_vector lasms(pasms);
+                    ptr_vector<expr> cube;
+                    {
+                        std::unique_lock<std::mutex> lock(mux);
+                        cond.wait(lock, [&]() { return done || qhead < queue.size() || num_active == 0; });
+                        if (done)
+                            return;
+                        if (qhead == queue.size()) {
+                            // all cubes are closed
+                            if (!incomplete) 
+                                finish(i, l_false);
+                            done = true;
+                            cond.notify_all();
+                            return;
+                        }
+                        id = queue[qhead++];
+                        ++num_active;
+                        cube_of(id, cube);
+                        ast_translation& tr = *m_import_tr[i];
+                        for (expr* e : cube)
+                            lasms.push_back(tr(e));
+                    }
+                    cube_node n = nodes[id];
+                    pctx.get_fparams().m_max_conflicts = n.m_budget;
+                    IF_VERBOSE(2, verbose_stream() << "(smt.cube :thread " << i << " :id " << id << " :depth " << n.m_depth << " :budget " << n.m_budget << ")\n");
+                    lbool r = pctx.check(lasms.size(), lasms.data());
+                    bool is_canceled = pm.limit().is_canceled();
+                    bool uses_cube = false;
+                    expr_ref split(pm);
+                    if (r == l_false) {
+                        for (unsigned j = pasms.size(); j < lasms.size() && !uses_cube; ++j)
+                            uses_cube = pctx.unsat_core().contains(lasms.get(j));
+                        if (uses_cube)
+                            pctx.assert_expr(mk_not(mk_and(pctx.unsat_core())));
+                    }
+                    else if (r == l_undef && !is_canceled && pctx.m_num_conflicts >= n.m_budget) {
+                        lookahead lh(pctx);
+                        split = lh.choose();
+                        if (split && pm.is_not(split))
+                            split = to_app(split)->get_arg(0);
+                        if (split && any_of(lasms, [&](expr* e) { expr* a = nullptr; return e == split || (pm.is_not(e, a) && a == split); }))
+                            split = nullptr;
+                    }
+
+                    std::lock_guard<std::mutex> lock(mux);
+                    --num_active;
+                    num_conflicts += pctx.m_num_conflicts;
+                    if (done) 
+                        ;
+                    else if (r == l_true) 
+                        finish(i, l_true);
+                    else if (r == l_false && !uses_cube) 
+                        finish(i, l_false);
+                    else if (r == l_false) {
+                        ++num_unsat;
+                        for (unsigned j = 0; j < pasms.size(); ++j) {
+                            if (pctx.unsat_core().contains(pasms.get(j)) && !core_set.contains(asms[j])) {
+                                core_set.insert(asms[j]);
+                                core.push_back(asms[j]);
+                            }
+                        }
+                        IF_VERBOSE(2, verbose_stream() << "(smt.cube :id " << id << " :parent " << (int)n.m_parent << " :depth " << n.m_depth << " :unsat)\n");
+                    }
+                    else if (is_canceled) 
+                        finish(i, l_undef);
+                    else if (num_conflicts >= max_conflicts) 
+                        finish(i, l_undef);
+                    else if (pctx.m_num_conflicts < n.m_budget) {
+                        // the worker gave up on the cube for another reason than the budget.
+                        incomplete = true;
+                        IF_VERBOSE(2, verbose_stream() << "(smt.cube :id " << id << " :depth " << n.m_depth << " :unknown)\n");
+                    }
+                    else if (split) {
+                        ++num_splits;
+                        ast_translation& tr = *m_export_tr[i];
+                        lits.push_back(tr(split.get()));
+                        lits.push_back(m.mk_not(lits.back()));
+                        unsigned budget = n.m_budget > UINT_MAX / 2 ? UINT_MAX : 2 * n.m_budget;
+                        for (unsigned k = 2; k > 0; --k) {
+                            queue.push_back(nodes.size());
+                            nodes.push_back({ id, lits.size() - k, n.m_depth + 1, budget });
+                        }
+                        max_depth = std::max(max_depth, n.m_depth + 1);
+                        IF_VERBOSE(2, verbose_stream() << "(smt.cube :id " << id << " :depth " << n.m_depth << " :split " << mk_bounded_pp(lits.back(), m, 3) << ")\n");
+                    }
+                    else {
+                        // no literal to split on, retry with a larger budget.
+                        nodes[id].m_budget = n.m_budget > UINT_MAX / 2 ? UINT_MAX : 2 * n.m_budget;
+                        queue.push_back(id);
+                    }
+                    if (!done)
+                        report_progress();
+                    cond.notify_all();
+                }
+            }
+            catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (finished_id == UINT_MAX) {
+                    error_code = err.error_code();
+                    ex_kind = ERROR_EX;
+                }
+                has_exception = true;
+                done = true;
+                cond.notify_all();
+            }
+            catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (finished_id == UINT_MAX) {
+                    ex_msg = ex.what();
+                    ex_kind = DEFAULT_EX;
+                }
+                has_exception = true;
+                done = true;
+                cond.notify_all();
+            }
+        };
+
+        vector<std::thread> threads(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) 
+            threads[i] = std::thread([&, i]() { worker_thread(i); });
+        for (auto & th : threads) 
+            th.join();
+        for (ast_manager* pm : m_pms)
+            pm->limit().reset_cancel();
+
+        ctx.m_aux_stats.update("smt cubes", nodes.size());
+        ctx.m_aux_stats.update("smt cubes unsat", num_unsat);
+        ctx.m_aux_stats.update("smt cube splits", num_splits);
+        ctx.m_aux_stats.update("smt cube depth", max_depth);
+        IF_VERBOSE(1, verbose_stream() << "(smt.cube :cubes " << nodes.size() << " :unsat " << num_unsat 
+                   << " :splits " << num_splits << " :depth " << max_depth << ")\n");
+
+        if (finished_id == UINT_MAX && has_exception) {
+            reset_workers();
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(std::move(ex_msg));
+            }
+        }
+
+        if (finished_id != UINT_MAX) {
+            context& pctx = *m_pctxs[finished_id];
+            m.update_fresh_id(*m_pms[finished_id]);
+        ast_translation& tr = *m_export_tr[finished_id];
+            model_ref mdl;
+            switch (result) {
+            case l_true:
+                pctx.get_model(mdl);
+                if (mdl)
+                    ctx.set_model(mdl->translate(tr));
+                break;
+            case l_false:
+                // the last refuted cube may be the root or one of the leaves.
+                ctx.m_unsat_core.reset();
+                for (expr* e : pctx.unsat_core()) {
+                    expr_ref te(tr(e), m);
+                    if (asms.contains(te) && !core_set.contains(te)) {
+                        core_set.insert(te);
+                        core.push_back(te);
+                    }
+                }
+                ctx.m_unsat_core.append(core);
+                break;
+            default:
+                break;
+            }
+        }
+        if (!ctx.get_fparams().m_threads_persistent)
+            reset_workers();
+        return result;
+    }
+
 }
 #endif
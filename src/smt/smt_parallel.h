@@ -18,17 +18,41 @@ Revision History:
 --*/
 #pragma once
 
+#include "util/scoped_ptr_vector.h"
 #include "smt/smt_context.h"
 
 namespace smt {
 
     class parallel {
         context& ctx;
+
+        // worker contexts kept across checks in persistent mode (smt.threads.persistent).
+        scoped_ptr_vector<smt_params>  m_params;
+        scoped_ptr_vector<ast_manager> m_pms;
+        scoped_ptr_vector<context>     m_pctxs;
+        scoped_ptr_vector<ast_translation> m_import_tr; // translations from ctx.m to the worker managers
+        scoped_ptr_vector<ast_translation> m_export_tr; // translations from the worker managers to ctx.m
+        unsigned                       m_num_formulas = 0; // formulas of ctx copied to the workers
+        obj_hashtable<expr>            m_unit_set;
+        expr_ref_vector                m_units;            // units shared by the workers, over ctx.m
+        unsigned_vector                m_export_lim;       // exported prefix of the assigned literals of each worker
+        unsigned_vector                m_import_lim;       // prefix of m_units imported by each worker
+
+        void init_workers(unsigned num_threads);
+        void sync_workers();
+        void reset_workers();
+        lbool check_persistent(expr_ref_vector const& asms, unsigned num_threads, unsigned thread_max_conflicts, unsigned max_conflicts);
+        lbool check_cubes(expr_ref_vector const& asms, unsigned num_threads, unsigned thread_max_conflicts, unsigned max_conflicts);
+
     public:
-        parallel(context& ctx): ctx(ctx) {}
+        parallel(context& ctx): ctx(ctx), m_units(ctx.get_manager()) {}
+
+        ~parallel() { reset_workers(); }
 
         lbool operator()(expr_ref_vector const& asms);
 
+        void collect_statistics(::statistics& st) const;
+
     };
 
 }
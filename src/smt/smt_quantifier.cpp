@@ -312,6 +312,9 @@ namespace smt {
                 m_qi_queue.insert(f, pat, max_generation, min_top_generation, max_top_generation); // TODO
                 m_num_instances++;
             }
+            else {
+                m_qi_queue.insert_duplicate();
+            }
 
             CTRACE("bindings", f != nullptr, 
                   tout << expr_ref(q, m()) << "\n";
@@ -127,8 +127,8 @@ namespace smt {
         expr_ref_vector                m_relevant_exprs; 
         uint_set                       m_is_relevant;
         typedef list<relevancy_eh *>   relevancy_ehs;
-        obj_map<expr, relevancy_ehs *> m_relevant_ehs;
-        obj_map<expr, relevancy_ehs *> m_watches[2];
+        ptr_vector<relevancy_ehs>      m_relevant_ehs; // expression id -> handlers
+        ptr_vector<relevancy_ehs>      m_watches[2];   // expression id -> watches on false/true
         struct eh_trail {
             enum class kind { POS_WATCH, NEG_WATCH, HANDLER };
             kind   m_kind;
@@ -158,32 +158,36 @@ namespace smt {
             }
         }
 
+        // expressions with handlers or watches are referenced by m_trail, so their ids are stable.
+        static relevancy_ehs * get_ehs(ptr_vector<relevancy_ehs> const & ehs, expr * n) {
+            unsigned id = n->get_id();
+            return id < ehs.size() ? ehs[id] : nullptr;
+        }
+
+        static void set_ehs(ptr_vector<relevancy_ehs> & ehs, expr * n, relevancy_ehs * r) {
+            unsigned id = n->get_id();
+            if (id >= ehs.size()) {
+                if (r == nullptr)
+                    return;
+                ehs.resize(id + 1, nullptr);
+            }
+            ehs[id] = r;
+        }
+
         relevancy_ehs * get_handlers(expr * n) {
-            relevancy_ehs * r = nullptr;
-            m_relevant_ehs.find(n, r);
-            SASSERT(m_relevant_ehs.contains(n) || r == 0);
-            return r;
+            return get_ehs(m_relevant_ehs, n);
         }
 
         void set_handlers(expr * n, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_relevant_ehs.erase(n);
-            else
-                m_relevant_ehs.insert(n, ehs);
+            set_ehs(m_relevant_ehs, n, ehs);
         }
 
         relevancy_ehs * get_watches(expr * n, bool val) {
-            relevancy_ehs * r = nullptr;
-            m_watches[val ? 1 : 0].find(n, r);
-            SASSERT(m_watches[val ? 1 : 0].contains(n) || r == 0);
-            return r;
+            return get_ehs(m_watches[val ? 1 : 0], n);
         }
 
         void set_watches(expr * n, bool val, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_watches[val ? 1 : 0].erase(n);
-            else
-                m_watches[val ? 1 : 0].insert(n, ehs);
+            set_ehs(m_watches[val ? 1 : 0], n, ehs);
         }
 
         void push_trail(eh_trail const & t) {
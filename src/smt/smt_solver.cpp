@@ -93,7 +93,12 @@ namespace {
             if (mc0()) 
                 result->set_model_converter(mc0()->translate(translator));
 
+            // copies made while minimizing a core test subsets of the names,
+            // so the names are not made assumptions of the copy. The copied
+            // context already contains the implications they guard.
             for (auto & [k, v] : m_name2assertion) {
+                if (m_minimizing_core)
+                    break;
                 expr* val = translator(k);
                 expr* key = translator(v);
                 result->assert_expr(val, key);
@@ -252,6 +257,10 @@ namespace {
             m_context.user_propagate_register_decide(c);
         }
 
+        void user_propagate_register_batch(user_propagator::batch_eh_t& c) override {
+            m_context.user_propagate_register_batch(c);
+        }
+
         void user_propagate_initialize_value(expr* var, expr* value) override {
             m_context.user_propagate_initialize_value(var, value);
         }
@@ -280,6 +289,7 @@ namespace {
             if (!m_minimizing_core && smt_params_helper(get_params()).core_minimize()) {
                 scoped_minimize_core scm(*this);
                 mus mus(*this);
+                mus.set_num_threads(smt_params_helper(get_params()).core_minimize_threads());
                 mus.add_soft(r.size(), r.data());
                 expr_ref_vector r2(m);
                 if (l_true == mus.get_mus(r2)) {
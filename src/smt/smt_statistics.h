@@ -28,6 +28,8 @@ namespace smt {
         unsigned m_num_decisions;
         unsigned m_num_add_eq;
         unsigned m_num_restarts;
+        unsigned m_num_rephases;
+        unsigned m_num_retained;
         unsigned m_num_final_checks;
         unsigned m_num_mk_bool_var;
         unsigned m_num_del_bool_var;
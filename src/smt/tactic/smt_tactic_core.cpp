@@ -324,6 +324,7 @@ public:
     user_propagator::eq_eh_t    m_diseq_eh;
     user_propagator::created_eh_t m_created_eh;
     user_propagator::decide_eh_t m_decide_eh;
+    user_propagator::batch_eh_t m_batch_eh;
     void* m_on_clause_ctx = nullptr;
     user_propagator::on_clause_eh_t m_on_clause_eh;
 
@@ -342,6 +343,7 @@ public:
         if (m_diseq_eh)   m_ctx->user_propagate_register_diseq(m_diseq_eh);
         if (m_created_eh) m_ctx->user_propagate_register_created(m_created_eh);
         if (m_decide_eh) m_ctx->user_propagate_register_decide(m_decide_eh);
+        if (m_batch_eh) m_ctx->user_propagate_register_batch(m_batch_eh);
 
         for (expr* v : m_vars) 
             m_ctx->user_propagate_register_expr(v);
@@ -358,6 +360,7 @@ public:
         m_diseq_eh = nullptr;
         m_created_eh = nullptr;
         m_decide_eh = nullptr;
+        m_batch_eh = nullptr;
         m_on_clause_eh = nullptr;
         m_on_clause_ctx = nullptr;
     }
@@ -407,6 +410,10 @@ public:
         m_decide_eh = decide_eh;
     }
 
+    void user_propagate_register_batch(user_propagator::batch_eh_t& batch_eh) override {
+        m_batch_eh = batch_eh;
+    }
+
     void user_propagate_initialize_value(expr* var, expr* value) override {
         m_values.push_back({expr_ref(var, m), expr_ref(value, m)});
     }
@@ -315,6 +315,11 @@ namespace smt {
         
         if (d1->m_is_array) {
             SASSERT(m_var_data[v2]->m_is_array);
+            if (m_params.m_array_model_check && m_params.m_array_delay_exp_axiom) {
+                m_delayed_extensionality.push_back(enode_pair(get_enode(v1), get_enode(v2)));
+                m_trail_stack.push(push_back_vector<enode_pair_vector>(m_delayed_extensionality));
+                return;
+            }
             instantiate_extensionality(get_enode(v1), get_enode(v2));
         }
     }
@@ -401,6 +406,12 @@ namespace smt {
     final_check_status theory_array::assert_delayed_axioms() {
         if (!m_params.m_array_delay_exp_axiom)
             return FC_DONE;
+        if (m_params.m_array_model_check) {
+            final_check_status r = assert_delayed_extensionality();
+            if (assert_violated_axioms() == FC_CONTINUE)
+                r = FC_CONTINUE;
+            return r;
+        }
         final_check_status r = FC_DONE;
         unsigned num_vars = get_num_vars();
         for (unsigned v = 0; v < num_vars; v++) {
@@ -411,6 +422,113 @@ namespace smt {
         return r;
     }
 
+    unsigned theory_array::model_entry_hash::operator()(model_entry const & e) const {
+        unsigned h = e.m_array->hash();
+        for (unsigned i = 1; i < e.m_select->get_num_args(); ++i)
+            h = combine_hash(h, e.m_select->get_arg(i)->get_root()->hash());
+        return h;
+    }
+
+    bool theory_array::model_entry_eq::operator()(model_entry const & e1, model_entry const & e2) const {
+        if (e1.m_array != e2.m_array)
+            return false;
+        SASSERT(e1.m_select->get_num_args() == e2.m_select->get_num_args());
+        for (unsigned i = 1; i < e1.m_select->get_num_args(); ++i)
+            if (e1.m_select->get_arg(i)->get_root() != e2.m_select->get_arg(i)->get_root())
+                return false;
+        return true;
+    }
+
+    /**
+       \brief Propagate the selects of every array class upward through the stores
+       over it, as the model generator does, and instantiate the select-store
+       axioms of the positions that receive two different values.
+    */
+    final_check_status theory_array::assert_violated_axioms() {
+        m_stats.m_num_model_checks++;
+        m_model_index.reset();
+        m_model_todo.reset();
+        unsigned num_vars = get_num_vars();
+        for (unsigned v = 0; v < num_vars; v++) {
+            var_data * d = m_var_data[v];
+            if (!is_root(v) || !d->m_is_array)
+                continue;
+            enode * r = get_enode(v)->get_root();
+            for (enode * sel : d->m_parent_selects) {
+                model_entry e;
+                e.m_array = r;
+                e.m_select = sel;
+                if (ctx.is_relevant(sel) && !m_model_index.contains(e)) {
+                    m_model_index.insert(e);
+                    m_model_todo.push_back(e);
+                }
+            }
+        }
+        bool violated = false, progress = false;
+        for (unsigned qhead = 0; qhead < m_model_todo.size(); ++qhead) {
+            model_entry e = m_model_todo[qhead];
+            theory_var v = e.m_array->get_th_var(get_id());
+            if (v == null_theory_var)
+                continue;
+            enode * sel = e.m_select;
+            for (enode * store : m_var_data[find(v)]->m_parent_stores) {
+                if (!ctx.is_relevant(store) || store->get_arg(0)->get_root() != e.m_array)
+                    continue;
+                unsigned num_args = sel->get_num_args();
+                unsigned i = 1;
+                for (; i < num_args && sel->get_arg(i)->get_root() == store->get_arg(i)->get_root(); ++i)
+                    ;
+                if (i == num_args)
+                    continue; // the position is overwritten by the store
+                model_entry p;
+                p.m_array = store->get_root();
+                p.m_select = sel;
+                p.m_store = store;
+                auto * other = m_model_index.find_core(p);
+                if (!other) {
+                    m_model_index.insert(p);
+                    m_model_todo.push_back(p);
+                    continue;
+                }
+                model_entry const & q = other->get_data();
+                if (q.m_select->get_root() == sel->get_root())
+                    continue;
+                TRACE("array", tout << "model check violation: #" << store->get_owner_id() << " #" << sel->get_owner_id()
+                      << " #" << q.m_select->get_owner_id() << "\n";);
+                violated = true;
+                m_stats.m_num_model_violations++;
+                if (instantiate_axiom2b(sel, store))
+                    progress = true;
+                if (q.m_store && instantiate_axiom2b(q.m_select, q.m_store))
+                    progress = true;
+            }
+        }
+        if (violated && !progress) {
+            // the violated axioms were instantiated in an enclosing scope, fall back to eager instantiation.
+            for (unsigned v = 0; v < num_vars; v++)
+                if (m_var_data[v]->m_prop_upward && instantiate_axiom2b_for(v))
+                    progress = true;
+        }
+        return progress ? FC_CONTINUE : FC_DONE;
+    }
+
+    /**
+       \brief Instantiate the delayed extensionality axioms of disequal arrays
+       that are not already distinguished by a pair of disequal selects.
+    */
+    final_check_status theory_array::assert_delayed_extensionality() {
+        final_check_status r = FC_DONE;
+        for (auto const& [a1, a2] : m_delayed_extensionality) {
+            if (a1->get_root() == a2->get_root())
+                continue;
+            unsigned num_extensionality = m_stats.m_num_extensionality;
+            instantiate_extensionality(a1, a2);
+            if (num_extensionality != m_stats.m_num_extensionality)
+                r = FC_CONTINUE;
+        }
+        return r;
+    }
+
     final_check_status theory_array::mk_interface_eqs_at_final_check() {
         unsigned n = mk_interface_eqs();
         m_stats.m_num_eq_splits += n;
@@ -423,6 +541,7 @@ namespace smt {
         m_trail_stack.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
+        m_delayed_extensionality.reset();
         theory_array_base::reset_eh();
     }
 
@@ -471,6 +590,10 @@ namespace smt {
         st.update("array exp ax2", m_stats.m_num_axiom2b);
         st.update("array ext ax", m_stats.m_num_extensionality);
         st.update("array splits", m_stats.m_num_eq_splits);
+        if (m_params.m_array_model_check) {
+            st.update("array model checks", m_stats.m_num_model_checks);
+            st.update("array model violations", m_stats.m_num_model_violations);
+        }
     }
 
 };
@@ -26,6 +26,7 @@ namespace smt {
 
     struct theory_array_stats {
         unsigned   m_num_axiom1, m_num_axiom2a, m_num_axiom2b, m_num_extensionality, m_num_eq_splits;
+        unsigned   m_num_model_checks, m_num_model_violations;
         unsigned   m_num_map_axiom, m_num_default_map_axiom;
         unsigned   m_num_select_const_axiom, m_num_default_store_axiom, m_num_default_const_axiom, m_num_default_as_array_axiom;
         unsigned   m_num_select_as_array_axiom, m_num_default_lambda_axiom;
@@ -53,6 +54,32 @@ namespace smt {
         trail_stack                     m_trail_stack;
         unsigned                        m_final_check_idx;
 
+        // --------------------------------------------------
+        // Model check (array.model_check)
+        //
+        // The candidate model of an array class is given by its selects,
+        // and by the selects of the arguments of its stores propagated upward
+        // at positions that are not overwritten, as done by propagate_selects
+        // when the model is built. The model index maps an array class and the
+        // classes of the indices to the select that determines the value.
+        // An upward select-store axiom is only violated if two selects
+        // with different values land on the same position.
+        // --------------------------------------------------
+        struct model_entry {
+            enode * m_array = nullptr;  // root of the array class
+            enode * m_select = nullptr; // select giving the value at the position
+            enode * m_store = nullptr;  // store the select was propagated through, nullptr for a select of the class
+        };
+        struct model_entry_hash { unsigned operator()(model_entry const & e) const; };
+        struct model_entry_eq { bool operator()(model_entry const & e1, model_entry const & e2) const; };
+        typedef hashtable<model_entry, model_entry_hash, model_entry_eq> model_index;
+        model_index                     m_model_index;
+        svector<model_entry>            m_model_todo;
+        enode_pair_vector               m_delayed_extensionality;
+
+        final_check_status assert_violated_axioms();
+        final_check_status assert_delayed_extensionality();
+
         theory_var mk_var(enode * n) override;
         bool internalize_atom(app * atom, bool gate_ctx) override;
         bool internalize_term(app * term) override;
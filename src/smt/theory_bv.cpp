@@ -885,12 +885,169 @@ namespace smt {
     }
 
 
+    /**
+       \brief Delay bit-blasting of multiplication, division and remainder.
+       The term receives fresh bits. final_check_eh relates them to the
+       arguments by value lemmas and bit-blasts the term only when the
+       arguments are not fixed or when it received too many lemmas.
+    */
+    bool theory_bv::internalize_delayed(app * n) {
+        if (params().m_bv_lazy_blast == 0)
+            return false;
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+        case OP_BUDIV_I:
+        case OP_BUREM_I:
+        case OP_BSDIV_I:
+        case OP_BSREM_I:
+        case OP_BSMOD_I:
+            break;
+        default:
+            return false;
+        }
+        SASSERT(!ctx.e_internalized(n));
+        process_args(n);
+        enode * e = mk_enode(n);
+        for (unsigned i = 0; i < n->get_num_args(); ++i)
+            get_arg_var(e, i);
+        mk_bits(e->get_th_var(get_id()));
+        m_delayed.push_back(e);
+        m_delay_lemmas.push_back(0);
+        m_delay_blasted.push_back(false);
+        ctx.push_trail(push_back_vector<enode_vector>(m_delayed));
+        ctx.push_trail(push_back_vector<unsigned_vector>(m_delay_lemmas));
+        ctx.push_trail(push_back_vector<bool_vector>(m_delay_blasted));
+        ++m_stats.m_num_delayed;
+        return true;
+    }
+
+    /**
+       \brief add the circuit of the delayed term m_delayed[idx] and
+       equate its outputs with the bits of the term.
+    */
+    void theory_bv::blast_delayed(unsigned idx) {
+        enode * e    = m_delayed[idx];
+        app * n      = e->get_expr();
+        theory_var v = e->get_th_var(get_id());
+        expr_ref_vector arg1_bits(m), arg2_bits(m), bits(m);
+        if (n->get_decl_kind() == OP_BMUL) {
+            unsigned i = n->get_num_args() - 1;
+            get_arg_bits(e, i, bits);
+            while (i > 0) {
+                --i;
+                arg1_bits.reset();
+                arg2_bits.reset();
+                get_arg_bits(e, i, arg1_bits);
+                m_bb.mk_multiplier(arg1_bits.size(), arg1_bits.data(), bits.data(), arg2_bits);
+                bits.swap(arg2_bits);
+            }
+        }
+        else {
+            get_arg_bits(e, 0, arg1_bits);
+            get_arg_bits(e, 1, arg2_bits);
+            unsigned sz = arg1_bits.size();
+            switch (n->get_decl_kind()) {
+            case OP_BUDIV_I: m_bb.mk_udiv(sz, arg1_bits.data(), arg2_bits.data(), bits); break;
+            case OP_BUREM_I: m_bb.mk_urem(sz, arg1_bits.data(), arg2_bits.data(), bits); break;
+            case OP_BSDIV_I: m_bb.mk_sdiv(sz, arg1_bits.data(), arg2_bits.data(), bits); break;
+            case OP_BSREM_I: m_bb.mk_srem(sz, arg1_bits.data(), arg2_bits.data(), bits); break;
+            case OP_BSMOD_I: m_bb.mk_smod(sz, arg1_bits.data(), arg2_bits.data(), bits); break;
+            default: UNREACHABLE(); break;
+            }
+        }
+        ctx.internalize(bits.data(), bits.size(), true);
+        literal_vector const bv_bits(m_bits[v]);
+        SASSERT(bv_bits.size() == bits.size());
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            literal l = ctx.get_literal(bits.get(i));
+            literal b = bv_bits[i];
+            if (l == b)
+                continue;
+            if (l != true_literal && l != false_literal)
+                ctx.mark_as_relevant(l);
+            ctx.mk_th_axiom(get_id(), ~l, b);
+            ctx.mk_th_axiom(get_id(), l, ~b);
+        }
+        ctx.push_trail(vector_value_trail<bool, false>(m_delay_blasted, idx));
+        m_delay_blasted[idx] = true;
+        ++m_stats.m_num_delay_blasted;
+        TRACE("bv", tout << "blast #" << n->get_id() << " " << mk_bounded_pp(n, m) << "\n";);
+    }
+
+    /**
+       \brief evaluate the delayed term m_delayed[idx] on the values of its arguments.
+       Return true if a lemma was added or the term was bit-blasted.
+    */
+    bool theory_bv::check_delayed(unsigned idx) {
+        enode * e = m_delayed[idx];
+        app * n   = e->get_expr();
+        if (m_delay_blasted[idx] || !ctx.is_relevant(e))
+            return false;
+        unsigned sz = get_bv_size(n);
+        numeral val;
+        expr_ref_vector vals(m);
+        for (unsigned i = 0; i < n->get_num_args(); ++i) {
+            theory_var w = get_arg_var(e, i);
+            if (!get_fixed_value(w, val)) {
+                bool marked = false;
+                for (literal b : m_bits[w]) {
+                    if (ctx.get_assignment(b) == l_undef && !ctx.is_relevant(b)) {
+                        ctx.mark_as_relevant(b);
+                        marked = true;
+                    }
+                }
+                if (!marked)
+                    blast_delayed(idx);
+                return true;
+            }
+            vals.push_back(m_util.mk_numeral(val, sz));
+        }
+        expr_ref r(m.mk_app(n->get_decl(), vals.size(), vals.data()), m);
+        th_rewriter rw(m);
+        rw(r);
+        numeral r_val;
+        if (!m_util.is_numeral(r, r_val, sz)) {
+            blast_delayed(idx);
+            return true;
+        }
+        if (get_fixed_value(e->get_th_var(get_id()), val) && val == r_val)
+            return false;
+        literal eq = mk_eq(n, r, false);
+        if (m_delay_lemmas[idx] >= params().m_bv_lazy_blast || ctx.get_assignment(eq) == l_true) {
+            blast_delayed(idx);
+            return true;
+        }
+        literal_vector lits;
+        for (unsigned i = 0; i < n->get_num_args(); ++i)
+            if (!m_util.is_numeral(n->get_arg(i)))
+                lits.push_back(~mk_eq(n->get_arg(i), vals.get(i), false));
+        lits.push_back(eq);
+        for (literal lit : lits)
+            ctx.mark_as_relevant(lit);
+        TRACE("bv", tout << "value lemma " << mk_bounded_pp(n, m) << " = " << r << "\n";);
+        ctx.mk_th_axiom(get_id(), lits);
+        ++m_delay_lemmas[idx];
+        ++m_stats.m_num_delay_lemmas;
+        return true;
+    }
+
+    bool theory_bv::check_delayed() {
+        bool progress = false;
+        for (unsigned i = 0; i < m_delayed.size() && !ctx.inconsistent(); ++i)
+            if (check_delayed(i))
+                progress = true;
+        return progress;
+    }
+
     bool theory_bv::internalize_term_core(app * term) {
         SASSERT(term->get_family_id() == get_family_id());
         TRACE("bv", tout << "internalizing term: " << mk_bounded_pp(term, m) << "\n";);
         if (approximate_term(term)) {
             return false;
         }
+        if (internalize_delayed(term)) {
+            return true;
+        }
         switch (term->get_decl_kind()) {
         case OP_BV_NUM:         internalize_num(term); return true;
         case OP_BNEG:           internalize_neg(term); return true;
@@ -1448,6 +1605,9 @@ namespace smt {
 
     final_check_status theory_bv::final_check_eh() {
         SASSERT(check_invariant());
+        if (check_delayed()) {
+            return FC_CONTINUE;
+        }
         if (m_approximates_large_bvs) {
             return FC_GIVEUP;
         }
@@ -1882,6 +2042,9 @@ namespace smt {
         st.update("bv bit2core", m_stats.m_num_bit2core);
         st.update("bv->core eq", m_stats.m_num_th2core_eq);
         st.update("bv dynamic eqs", m_stats.m_num_eq_dynamic);
+        st.update("bv delayed", m_stats.m_num_delayed);
+        st.update("bv delay lemmas", m_stats.m_num_delay_lemmas);
+        st.update("bv delay blasted", m_stats.m_num_delay_blasted);
     }
 
     theory_bv::var_enode_pos theory_bv::get_bv_with_theory(bool_var v, theory_id id) const {
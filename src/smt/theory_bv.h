@@ -31,6 +31,7 @@ namespace smt {
     struct theory_bv_stats {
         unsigned   m_num_diseq_static, m_num_diseq_dynamic, m_num_bit2core, m_num_th2core_eq, m_num_conflicts;
         unsigned   m_num_eq_dynamic;
+        unsigned   m_num_delayed, m_num_delay_lemmas, m_num_delay_blasted;
         void reset() { memset(this, 0, sizeof(theory_bv_stats)); }
         theory_bv_stats() { reset(); }
     };
@@ -113,6 +114,9 @@ namespace smt {
         vector<zero_one_bits>    m_zero_one_bits; // per var, see comment in the struct zero_one_bit
         bool_var2atom            m_bool_var2atom;
         enode_vector             m_bv2int;
+        enode_vector             m_delayed;         // multiplications and divisions whose bit-blasting is delayed
+        unsigned_vector          m_delay_lemmas;    // per delayed term, number of value lemmas
+        bool_vector              m_delay_blasted;   // per delayed term, whether the circuit was added in the current scope
         typedef svector<theory_var> vars;
 
         typedef std::pair<numeral, unsigned> value_sort_pair;
@@ -219,6 +223,10 @@ namespace smt {
         void internalize_smul_no_underflow(app *n);
 
         bool approximate_term(app* n);
+        bool internalize_delayed(app* n);
+        void blast_delayed(unsigned idx);
+        bool check_delayed(unsigned idx);
+        bool check_delayed();
 
         template<bool Signed>
         void internalize_le(app * atom);
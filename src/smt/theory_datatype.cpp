@@ -265,10 +265,13 @@ namespace smt {
         VERIFY(r == static_cast<theory_var>(m_find.mk_var()));
         SASSERT(r == static_cast<int>(m_var_data.size()));
         m_var_data.push_back(alloc(var_data));
+        m_oc_ord.push_back(m_oc_next++);
+        m_oc_marked.push_back(false);
         var_data * d  = m_var_data[r];
         ctx.attach_th_var(n, this, r);
         if (is_constructor(n)) {
             d->m_constructor = n;
+            oc_new_constructor(r, n);
             assert_accessor_axioms(n);
         }
         else if (is_update_field(n)) {
@@ -471,6 +474,9 @@ namespace smt {
         unsigned num_old_vars = get_old_num_vars(num_scopes);
         std::for_each(m_var_data.begin() + num_old_vars, m_var_data.end(), delete_proc<var_data>());
         m_var_data.shrink(num_old_vars);
+        m_oc_ord.shrink(num_old_vars);
+        m_oc_marked.shrink(num_old_vars);
+        m_oc_valid = false;
         theory::pop_scope_eh(num_scopes);
         SASSERT(m_find.get_num_vars() == m_var_data.size());
         SASSERT(m_find.get_num_vars() == get_num_vars());
@@ -481,13 +487,15 @@ namespace smt {
         int num_vars = get_num_vars();
         final_check_status r = FC_DONE;
         final_check_st _guard(this); 
+        if (!m_oc_valid)
+            m_oc_next = 0;
         for (int v = 0; v < num_vars; v++) {
             if (v == static_cast<int>(m_find.find(v))) {
                 enode * node = get_enode(v);
                 sort* s = node->get_sort();
                 if (!m_util.is_datatype(s))
                     continue;
-                if (m_util.is_recursive(s) && !oc_cycle_free(node) && occurs_check(node)) {
+                if (!m_oc_valid && m_util.is_recursive(s) && !oc_cycle_free(node) && occurs_check(node)) {
                     // conflict was detected... 
                     // return...
                     return FC_CONTINUE;
@@ -503,6 +511,8 @@ namespace smt {
                 }
             }
         }
+        // the occurs checks numbered the roots in post-order, which is a topological order.
+        m_oc_valid = m_oc_incremental && num_vars == static_cast<int>(get_num_vars());
         return r;
     }
 
@@ -722,10 +732,14 @@ namespace smt {
                 res = occurs_check_enter(app);
                 break;
 
-            case EXIT:
+            case EXIT: {
                 oc_mark_cycle_free(app);
+                theory_var v = app->get_root()->get_th_var(get_id());
+                if (v != null_theory_var)
+                    m_oc_ord[m_find.find(v)] = m_oc_next++;
                 break;
             }
+            }
         }
 
         if (res) {
@@ -736,10 +750,131 @@ namespace smt {
         return res;
     }
         
+    template<typename F>
+    void theory_datatype::oc_for_each_succ(theory_var u, F const& f) {
+        enode * c = m_var_data[u]->m_constructor;
+        if (!c)
+            return;
+        for (enode * arg : enode::args(c)) {
+            theory_var w = arg->get_th_var(get_id());
+            if (w != null_theory_var && oc_is_recursive(arg))
+                f(static_cast<theory_var>(m_find.find(w)));
+        }
+    }
+
+    template<typename F>
+    void theory_datatype::oc_for_each_pred(theory_var u, F const& f) {
+        theory_var w = u;
+        do {
+            for (enode * c : m_var_data[w]->m_parents) {
+                theory_var r = m_find.find(c->get_th_var(get_id()));
+                if (m_var_data[r]->m_constructor == c)
+                    f(r);
+            }
+            w = m_find.next(w);
+        }
+        while (w != u);
+    }
+
+    void theory_datatype::oc_new_constructor(theory_var v, enode * n) {
+        for (enode * arg : enode::args(n)) {
+            sort * s = arg->get_sort(), * se = nullptr;
+            if ((m_sutil.is_seq(s, se) && m_util.is_datatype(se)) ||
+                (m_autil.is_array(s) && m_util.is_datatype(get_array_range(s))))
+                m_oc_incremental = false;
+            theory_var w = arg->get_th_var(get_id());
+            if (w == null_theory_var || !oc_is_recursive(arg) || !oc_is_recursive(n))
+                continue;
+            m_var_data[w]->m_parents.push_back(n);
+            m_trail_stack.push(push_back_vector<ptr_vector<enode>>(m_var_data[w]->m_parents));
+        }
+        if (!m_oc_incremental)
+            m_oc_valid = false;
+        // v is a fresh variable: it has the largest position in the order and no parents.
+    }
+
+    /**
+       \brief Insert the edge u -> v in the topological order.
+       Return false if v reaches u, that is, the edge closes a cycle.
+
+       Only the nodes between v and u in the order are visited: the descendants of v
+       that are above u and the ancestors of u that are below v. They are renumbered
+       using their old positions so that the ancestors come after the descendants.
+    */
+    bool theory_datatype::oc_insert_edge(theory_var u, theory_var v) {
+        if (m_oc_ord[u] > m_oc_ord[v])
+            return true;
+        if (u == v)
+            return false;
+        unsigned lb = m_oc_ord[u], ub = m_oc_ord[v];
+        bool cycle = false;
+        m_oc_forward.reset();
+        m_oc_backward.reset();
+        auto visit = [&](theory_var w, svector<theory_var>& found) {
+            if (!m_oc_marked[w]) {
+                m_oc_marked[w] = true;
+                found.push_back(w);
+            }
+        };
+        visit(v, m_oc_forward);
+        for (unsigned i = 0; !cycle && i < m_oc_forward.size(); ++i) {
+            oc_for_each_succ(m_oc_forward[i], [&](theory_var w) {
+                if (w == u)
+                    cycle = true;
+                else if (m_oc_ord[w] > lb)
+                    visit(w, m_oc_forward);
+            });
+        }
+        if (!cycle) {
+            visit(u, m_oc_backward);
+            for (unsigned i = 0; i < m_oc_backward.size(); ++i) {
+                oc_for_each_pred(m_oc_backward[i], [&](theory_var w) {
+                    if (m_oc_ord[w] < ub)
+                        visit(w, m_oc_backward);
+                });
+            }
+            oc_reorder();
+        }
+        for (theory_var w : m_oc_forward)
+            m_oc_marked[w] = false;
+        for (theory_var w : m_oc_backward)
+            m_oc_marked[w] = false;
+        return !cycle;
+    }
+
+    void theory_datatype::oc_reorder() {
+        m_stats.m_oc_reorder++;
+        auto lt = [&](theory_var a, theory_var b) { return m_oc_ord[a] < m_oc_ord[b]; };
+        std::sort(m_oc_forward.begin(), m_oc_forward.end(), lt);
+        std::sort(m_oc_backward.begin(), m_oc_backward.end(), lt);
+        m_oc_ords.reset();
+        for (theory_var w : m_oc_forward)
+            m_oc_ords.push_back(m_oc_ord[w]);
+        for (theory_var w : m_oc_backward)
+            m_oc_ords.push_back(m_oc_ord[w]);
+        std::sort(m_oc_ords.begin(), m_oc_ords.end());
+        unsigned i = 0;
+        for (theory_var w : m_oc_forward)
+            m_oc_ord[w] = m_oc_ords[i++];
+        for (theory_var w : m_oc_backward)
+            m_oc_ord[w] = m_oc_ords[i++];
+    }
+
+    // the incremental check found a cycle through v, use the full occurs check to explain it.
+    void theory_datatype::oc_conflict(theory_var v) {
+        m_oc_valid = false;
+        final_check_st _guard(this);
+        occurs_check(get_enode(v));
+    }
+
     void theory_datatype::reset_eh() {
         m_trail_stack.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
+        m_oc_ord.reset();
+        m_oc_marked.reset();
+        m_oc_valid = false;
+        m_oc_incremental = true;
         theory::reset_eh();
         m_util.reset();
         m_stats.reset();
@@ -780,6 +915,7 @@ namespace smt {
 
     void theory_datatype::collect_statistics(::statistics & st) const {
         st.update("datatype occurs check", m_stats.m_occurs_check);
+        st.update("datatype occurs check reorder", m_stats.m_oc_reorder);
         st.update("datatype splits", m_stats.m_splits);
         st.update("datatype constructor ax", m_stats.m_assert_cnstr);
         st.update("datatype accessor ax", m_stats.m_assert_accessor);
@@ -879,6 +1015,31 @@ namespace smt {
                 add_recognizer(v1, e);
     }
 
+    void theory_datatype::after_merge_eh(theory_var r1, theory_var r2, theory_var v1, theory_var v2) {
+        // r2 was merged into r1. The edges of r1 are in the order, the new edges are the
+        // ones from the parents of the old class of r2, and those of the constructor of r2
+        // if r1 had none.
+        if (!m_oc_valid || ctx.inconsistent() || !oc_is_recursive(get_enode(r1)))
+            return;
+        auto insert = [&](theory_var u, theory_var v) {
+            if (m_oc_valid && !oc_insert_edge(u, v))
+                oc_conflict(u);
+        };
+        if (m_var_data[r1]->m_constructor == m_var_data[r2]->m_constructor)
+            oc_for_each_succ(r1, [&](theory_var w) { insert(r1, w); });
+        // after the merge, the old class of r2 follows r1 in the cyclic list of m_find.
+        theory_var w = r1;
+        do {
+            w = m_find.next(w);
+            for (enode * c : m_var_data[w]->m_parents) {
+                theory_var p = m_find.find(c->get_th_var(get_id()));
+                if (m_var_data[p]->m_constructor == c)
+                    insert(p, r1);
+            }
+        }
+        while (w != r2);
+    }
+
     void theory_datatype::unmerge_eh(theory_var v1, theory_var v2) {
         // do nothing
     }
@@ -33,13 +33,14 @@ namespace smt {
         struct var_data {
             ptr_vector<enode> m_recognizers; //!< recognizers of this equivalence class that are being watched.
             enode *           m_constructor; //!< constructor of this equivalence class, 0 if there is no constructor in the eqc.
+            ptr_vector<enode> m_parents;     //!< constructors that have this variable as an argument.
             var_data():
                 m_constructor(nullptr) {
             }
         };
 
         struct stats {
-            unsigned   m_occurs_check, m_splits;
+            unsigned   m_occurs_check, m_oc_reorder, m_splits;
             unsigned   m_assert_cnstr, m_assert_accessor, m_assert_update_field;
             void reset() { memset(this, 0, sizeof(stats)); }
             stats() { reset(); }
@@ -92,6 +93,29 @@ namespace smt {
         bool oc_cycle_free(enode * n) const { return n->get_root()->is_marked2(); }
 
         void oc_push_stack(enode * n);
+
+        // Incremental occurs check.
+        // m_oc_ord is a topological order of the constructor graph over the roots of m_find
+        // restricted to recursive sorts: an edge u -> v, where the constructor of u has an
+        // argument in v, implies m_oc_ord[u] > m_oc_ord[v]. The order is computed by a full
+        // occurs check in final_check_eh and maintained with the Pearce-Kelly algorithm when
+        // constructors and merges add edges. It is not restored on backtracking, a pop
+        // invalidates it until the next full check.
+        bool                  m_oc_incremental = true;  // false once a constructor has sequence or array arguments
+        bool                  m_oc_valid = false;
+        unsigned              m_oc_next = 0;
+        unsigned_vector       m_oc_ord;
+        bool_vector           m_oc_marked;
+        svector<theory_var>   m_oc_forward, m_oc_backward, m_oc_todo;
+        unsigned_vector       m_oc_ords;
+
+        bool oc_is_recursive(enode * n) { return m_util.is_datatype(n->get_sort()) && m_util.is_recursive(n->get_sort()); }
+        template<typename F> void oc_for_each_succ(theory_var u, F const& f);
+        template<typename F> void oc_for_each_pred(theory_var u, F const& f);
+        void oc_new_constructor(theory_var v, enode * n);
+        bool oc_insert_edge(theory_var u, theory_var v);
+        void oc_reorder();
+        void oc_conflict(theory_var v);
         ptr_vector<enode> m_args, m_todo;
         ptr_vector<enode> const& get_array_args(enode* n);
         ptr_vector<enode> const& get_seq_args(enode* n, enode*& sibling);
@@ -141,7 +165,7 @@ namespace smt {
         model_value_proc * mk_value(enode * n, model_generator & m) override;
         trail_stack & get_trail_stack() { return m_trail_stack; }
         virtual void merge_eh(theory_var v1, theory_var v2, theory_var, theory_var);
-        static void after_merge_eh(theory_var r1, theory_var r2, theory_var v1, theory_var v2) {}
+        void after_merge_eh(theory_var r1, theory_var r2, theory_var v1, theory_var v2);
         void unmerge_eh(theory_var v1, theory_var v2);
         char const * get_name() const override { return "datatype"; }
         bool include_func_interp(func_decl* f) override;
@@ -34,11 +34,13 @@ namespace smt {
         m_fpa_util(m_converter.fu()),
         m_bv_util(m_converter.bu()),
         m_arith_util(m_converter.au()),
-        m_is_initialized(true)
+        m_is_initialized(true),
+        m_abstractions(ctx.get_manager())
     {
         params_ref p;
         p.set_bool("arith_lhs", true);
         m_th_rw.updt_params(p);
+        m_converter.set_abstract_ops(ctx.get_fparams().m_fp_abstract_ops);
     }
 
     theory_fpa::~theory_fpa()
@@ -206,6 +208,11 @@ namespace smt {
             fmls.push_back(std::move(t));
         }
         m_converter.m_extra_assertions.reset();
+        for (expr* a : m_converter.m_abstractions) {
+            m_abstractions.push_back(a);
+            m_trail_stack.push(push_back_vector<expr_ref_vector>(m_abstractions));
+        }
+        m_converter.m_abstractions.reset();
         res = m.mk_and(fmls);
 
         m_th_rw(res);
@@ -504,9 +511,80 @@ namespace smt {
     final_check_status theory_fpa::final_check_eh() {
         TRACE("t_fpa", tout << "final_check_eh\n";);
         SASSERT(m_converter.m_extra_assertions.empty());
+        if (refine_abstractions())
+            return FC_CONTINUE;
         return FC_DONE;
     }
 
+    /**
+       \brief check the abstracted arithmetic operations against the current
+       assignment. An operation is evaluated on the values of its arguments
+       and bit-blasted if the result differs from the value of its abstraction.
+    */
+    bool theory_fpa::refine_abstractions() {
+        if (m_abstractions.empty())
+            return false;
+        auto* th_bv = dynamic_cast<theory_bv*>(ctx.get_theory(m_bv_util.get_fid()));
+        bool refined = false;
+        for (unsigned i = 0; i < m_abstractions.size(); ++i) {
+            app* a = to_app(m_abstractions.get(i));
+            func_decl* f = nullptr;
+            expr_ref_vector args(m);
+            VERIFY(m_converter.is_abstraction(a, f, args));
+            if (m_refined.contains(a))
+                continue;
+            bool used = false, consistent = th_bv != nullptr;
+            for (expr* r : *a)
+                used |= ctx.e_internalized(r) && ctx.is_relevant(r);
+            if (!used)
+                continue;
+            app* sgn = to_app(a->get_arg(0));
+            expr_ref_vector vals(m);
+            rational v;
+            for (expr* c : *sgn) {
+                if (!consistent || !is_app(c) || !th_bv->get_fixed_value(to_app(c), v))
+                    consistent = false;
+                else
+                    vals.push_back(m_bv_util.mk_numeral(v, c->get_sort()));
+            }
+            if (consistent) {
+                expr_ref_vector vargs(m);
+                expr_ref val(m);
+                m_converter.mk_op_args(f, vals.data(), vargs);
+                m_converter.mk_arith_op_core(f, vargs.size(), vargs.data(), val);
+                consistent = m_fpa_util.is_fp(val);
+                for (unsigned j = 0; consistent && j < 3; ++j) {
+                    expr* r = a->get_arg(j);
+                    expr_ref c(to_app(val)->get_arg(j), m);
+                    rational w;
+                    if (!ctx.e_internalized(r))
+                        continue;
+                    m_th_rw(c);
+                    consistent = 
+                        m_bv_util.is_numeral(c, v) &&
+                        th_bv->get_fixed_value(to_app(r), w) && v == w;
+                }
+            }
+            if (consistent)
+                continue;
+            TRACE("t_fpa", tout << "refine " << f->get_name() << " " << mk_ismt2_pp(a, m) << "\n";);
+            expr_ref bv(m);
+            m_converter.mk_arith_op_core(f, args.size(), args.data(), bv);
+            SASSERT(m_fpa_util.is_fp(bv));
+            expr_ref_vector eqs(m);
+            for (unsigned j = 0; j < 3; ++j)
+                eqs.push_back(m.mk_eq(a->get_arg(j), to_app(bv)->get_arg(j)));
+            expr_ref cnstr(m.mk_and(eqs), m);
+            m_th_rw(cnstr);
+            assert_cnstr(cnstr);
+            assert_cnstr(mk_side_conditions());
+            m_refined.insert(a);
+            m_trail_stack.push(insert_obj_trail<expr>(m_refined, a));
+            refined = true;
+        }
+        return refined;
+    }
+
     void theory_fpa::init_model(model_generator & mg) {
         TRACE("t_fpa", tout << "initializing model" << std::endl; display(tout););
         m_factory = alloc(fpa_value_factory, m, get_family_id());
@@ -88,6 +88,8 @@ namespace smt {
         obj_map<expr, expr*>      m_conversions;
         bool                      m_is_initialized;
         obj_hashtable<func_decl>  m_is_added_to_model;
+        expr_ref_vector           m_abstractions;
+        obj_hashtable<expr>       m_refined;
 
         final_check_status final_check_eh() override;
         bool internalize_atom(app * atom, bool gate_ctx) override;
@@ -117,6 +119,7 @@ namespace smt {
     protected:
         expr_ref mk_side_conditions();
         expr_ref convert(expr * e);
+        bool refine_abstractions();
 
         void attach_new_th_var(enode * n);
         void assert_cnstr(expr * e);
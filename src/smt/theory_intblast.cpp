@@ -14,6 +14,7 @@ Author:
 #include "smt/smt_context.h"
 #include "smt/theory_intblast.h"
 #include "smt/smt_model_generator.h"
+#include "smt/smt_arith_value.h"
 
 namespace smt {
 
@@ -33,8 +34,12 @@ namespace smt {
         m_trail(ctx),
         m_translator(m, m_trail),
         bv(m),
-        a(m)
-    {}
+        a(m),
+        m_wraps(m)
+    {
+        m_lazy_mod = ctx.get_fparams().m_bv_intblast_lazy_mod;
+        m_translator.set_lazy_mod(m_lazy_mod);
+    }
     
     theory_intblast::~theory_intblast() {}
         
@@ -78,9 +83,86 @@ namespace smt {
                 return final_check_status::FC_CONTINUE;
             }
         }
+        if (refine_wraps())
+            return final_check_status::FC_CONTINUE;
         return final_check_status::FC_DONE;
     }
 
+    /**
+     * Ensure that wrap(x) = x mod N in the current model.
+     * If x is in range the cheaper axiom 0 <= x < N => wrap(x) = x is added.
+     */
+    bool theory_intblast::refine_wraps() {
+        arith_value av(m);
+        av.init(&ctx);
+        bool refined = false;
+        for (expr* w : m_wraps) {
+            expr* x = nullptr;
+            rational N, vx, vw;
+            VERIFY(m_translator.is_wrap(w, x, N));
+            if (av.get_value(x, vx) && av.get_value(w, vw)) {
+                if (vw == mod(vx, N))
+                    continue;
+                if (vx >= 0 && vx < N) {
+                    literal lo = mk_literal(a.mk_ge(x, a.mk_int(0)));
+                    literal hi = mk_literal(a.mk_le(x, a.mk_int(N - 1)));
+                    literal eq = mk_eq(w, x, false);
+                    ctx.mark_as_relevant(lo);
+                    ctx.mark_as_relevant(hi);
+                    ctx.mark_as_relevant(eq);
+                    ctx.mk_th_axiom(m_id, ~lo, ~hi, eq);
+                    refined = true;
+                    continue;
+                }
+            }
+            expr_ref xModN(a.mk_mod(x, a.mk_int(N)), m);
+            ctx.internalize(xModN, false);
+            if (ctx.get_enode(w)->get_root() == ctx.get_enode(xModN)->get_root())
+                continue;
+            literal eq = mk_eq(w, xModN, false);
+            ctx.mark_as_relevant(eq);
+            ctx.mk_th_axiom(m_id, 1, &eq);
+            refined = true;
+        }
+        return refined;
+    }
+
+    void theory_intblast::collect_wraps(expr* r, ptr_vector<expr>& wraps) {
+        ptr_vector<expr> todo;
+        ast_fast_mark1 visited;
+        todo.push_back(r);
+        visited.mark(r);
+        while (!todo.empty()) {
+            expr* e = todo.back();
+            todo.pop_back();
+            if (!is_app(e) || ctx.e_internalized(e))
+                continue;
+            expr* x;
+            rational N;
+            if (m_translator.is_wrap(e, x, N))
+                wraps.push_back(e);
+            for (expr* arg : *to_app(e))
+                if (!visited.is_marked(arg)) {
+                    visited.mark(arg);
+                    todo.push_back(arg);
+                }
+        }
+    }
+
+    void theory_intblast::add_wrap(expr* w) {
+        expr* x;
+        rational N;
+        VERIFY(m_translator.is_wrap(w, x, N));
+        m_wraps.push_back(w);
+        ctx.push_trail(push_back_vector(m_wraps));
+        auto lo = mk_literal(a.mk_ge(w, a.mk_int(0)));
+        auto hi = mk_literal(a.mk_le(w, a.mk_int(N - 1)));
+        ctx.mark_as_relevant(lo);
+        ctx.mark_as_relevant(hi);
+        ctx.mk_th_axiom(m_id, 1, &lo);
+        ctx.mk_th_axiom(m_id, 1, &hi);
+    }
+
     bool theory_intblast::add_bound_axioms() {
         auto const& vars = m_translator.vars();
         if (m_vars_qhead == vars.size())
@@ -109,12 +191,17 @@ namespace smt {
             expr* e = preds[m_preds_qhead];
             expr_ref r(m_translator.translated(e), m);
             ctx.get_rewriter()(r);
+            ptr_vector<expr> wraps;
+            if (m_lazy_mod)
+                collect_wraps(r, wraps);
             auto a = mk_literal(e);
             auto b = mk_literal(r);
             ctx.mark_as_relevant(a);
             ctx.mark_as_relevant(b);
             ctx.mk_th_axiom(m_id, ~a, b);
             ctx.mk_th_axiom(m_id, a, ~b);
+            for (expr* w : wraps)
+                add_wrap(w);
         }
         return true;
     }
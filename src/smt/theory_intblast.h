@@ -44,9 +44,14 @@ namespace smt {
         arith_util        a;
         unsigned m_vars_qhead = 0, m_preds_qhead = 0;
         bv_factory *    m_factory = nullptr;
+        bool            m_lazy_mod = false;
+        expr_ref_vector m_wraps;        // wrap terms in internalized predicates
 
         bool add_bound_axioms();
         bool add_predicate_axioms();
+        void collect_wraps(expr* r, ptr_vector<expr>& wraps);
+        void add_wrap(expr* w);
+        bool refine_wraps();
 
     public:
         theory_intblast(context& ctx);
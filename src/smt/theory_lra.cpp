@@ -74,7 +74,7 @@ class theory_lra::imp {
         imp& m_imp;
     public:
         resource_limit(imp& i): m_imp(i) { }
-        bool get_cancel_flag() override { return !m_imp.m.inc(); }
+        bool get_cancel_flag() override { return !m_imp.m.limit().tick(); }
     };
 
     theory_lra&                  th;
@@ -1039,6 +1039,7 @@ public:
         sc.m_bounds_lim = m_bounds_trail.size();
         sc.m_asserted_qhead = m_asserted_qhead;
         sc.m_asserted_atoms_lim = m_asserted_atoms.size();
+        m_explanation_log.push_scope();
         lp().push();
         if (m_nla)
             m_nla->push();
@@ -1052,6 +1053,8 @@ public:
         m_asserted_atoms.shrink(m_scopes[old_size].m_asserted_atoms_lim);
         m_asserted_qhead = m_scopes[old_size].m_asserted_qhead;
         m_scopes.resize(old_size);            
+        m_explanation_log.pop_scope(num_scopes);
+        m_evidence_log_idx = UINT_MAX;
         lp().pop(num_scopes);
         // VERIFY(l_false != make_feasible());
         m_new_bounds.reset();
@@ -2293,6 +2296,8 @@ public:
             TRACE("arith", tout << "return\n";);
             return 0;
         }
+        if (params().m_arith_bprop_batch && !should_refine_bounds())
+            return propagate_lp_solver_bound_batched(v, be);
         lp_bounds const& bounds = m_bounds[v];
         bool first = true;
         unsigned count = 0;
@@ -2340,6 +2345,62 @@ public:
         return count;
     }
 
+    ptr_vector<api_bound> m_implied_batch;
+
+    /**
+       \brief propagate the literals implied by be, explaining only the strongest one.
+       The literals implied by be are grouped by the kind of their bound.
+       Within a group, the literal of the tightest bound implies the others,
+       so only that literal is assigned with the explanation of be and the
+       remaining literals are justified by it.
+    */
+    unsigned propagate_lp_solver_bound_batched(theory_var v, const lp::implied_bound& be) {
+        bool is_upper = be.kind() == lp::LE || be.kind() == lp::LT;
+        api_bound* strongest[2] = { nullptr, nullptr };
+        m_implied_batch.reset();
+        for (api_bound* b : m_bounds[v]) {
+            if (ctx().get_assignment(b->get_lit()) != l_undef) 
+                continue;
+            if (null_literal == is_bound_implied(be.kind(), be.m_bound, *b))
+                continue;
+            m_implied_batch.push_back(b);
+            api_bound*& s = strongest[b->get_bound_kind()];
+            if (!s || (is_upper ? b->get_value() < s->get_value() : s->get_value() < b->get_value()))
+                s = b;
+        }
+        if (m_implied_batch.empty())
+            return 0;
+        reset_evidence();
+        m_explanation.clear();
+        lp().explain_implied_bound(be, m_bp);
+        for (api_bound* s : strongest) {
+            if (!s || ctx().inconsistent())
+                continue;
+            literal lit = is_bound_implied(be.kind(), be.m_bound, *s);
+            lp().settings().stats().m_num_of_implied_bounds ++;
+            updt_unassigned_bounds(v, -1);
+            ++m_stats.m_bound_propagations1;
+            assign(lit, m_core, m_eqs, m_params);
+        }
+        for (api_bound* b : m_implied_batch) {
+            api_bound* s = strongest[b->get_bound_kind()];
+            if (b == s || ctx().inconsistent())
+                continue;
+            literal lit = is_bound_implied(be.kind(), be.m_bound, *b);
+            literal slit = is_bound_implied(be.kind(), be.m_bound, *s);
+            if (ctx().get_assignment(lit) != l_undef || ctx().get_assignment(slit) != l_true)
+                continue;
+            TRACE("arith", ctx().display_literal_verbose(tout, slit) << " --> "; ctx().display_literal_verbose(tout, lit) << "\n";);
+            updt_unassigned_bounds(v, -1);
+            ++m_stats.m_bound_propagations_batched;
+            ctx().assign(
+                lit, ctx().mk_justification(
+                    ext_theory_propagation_justification(
+                        get_id(), ctx(), 1, &slit, 0, nullptr, lit, m_bound_params.size(), m_bound_params.data())));
+        }
+        return m_implied_batch.size();
+    }
+
     void refine_bound(theory_var v, const lp::implied_bound& be) {
         lpvar vi = be.m_j;
         if (lp().column_has_term(vi))
@@ -2407,6 +2468,14 @@ public:
 
     literal_vector m_core2;
 
+    // explanations of bound propagations, shared by the literals implied by the same evidence.
+    explanation_log m_explanation_log;
+    unsigned        m_evidence_log_idx = UINT_MAX;   // entry of m_core, m_eqs in m_explanation_log
+
+    bool use_explanation_log(literal_vector const& core, svector<enode_pair> const& eqs) const {
+        return &core == &m_core && &eqs == &m_eqs && !proofs_enabled() && !ctx().get_fparams().m_axioms2files;
+    }
+
     void assign(literal lit, literal_vector const& core, svector<enode_pair> const& eqs, vector<parameter> const& ps) {
         if (params().m_arith_validate)
             VERIFY(validate_assign(lit, core, eqs));
@@ -2423,6 +2492,14 @@ public:
             }
             ctx().mk_clause(m_core2.size(), m_core2.data(), js, CLS_TH_LEMMA, nullptr);
         }
+        else if (use_explanation_log(core, eqs)) {
+            unsigned& idx = m_evidence_log_idx;
+            if (!m_explanation_log.matches(idx, core.size(), core.data(), eqs.size(), eqs.data()))
+                idx = m_explanation_log.add(core.size(), core.data(), eqs.size(), eqs.data());
+            ctx().assign(
+                lit, ctx().mk_justification(
+                    ext_theory_log_justification(get_id(), m_explanation_log, idx, lit)));
+        }
         else {
             ctx().assign(
                 lit, ctx().mk_justification(
@@ -3382,6 +3459,7 @@ public:
         m_core.reset();
         m_eqs.reset();
         m_params.reset();
+        m_evidence_log_idx = UINT_MAX;
     }
 
     // lp::constraint_index const null_constraint_index = UINT_MAX; // not sure what a correct fix is
@@ -3770,6 +3848,31 @@ public:
         }
     }
 
+    /**
+       \brief maximize v over the rows and bounds of the LP, ignoring integrality.
+       The assignment of the LP is restored afterwards.
+    */
+    bool relaxation_bound(theory_var v, inf_eps& r) {
+        if (!is_registered_var(v) || !m.limit().inc())
+            return false;
+        lp().backup_x();
+        if (!lp().is_feasible() || lp().has_changed_columns())
+            make_feasible();
+        lp::impq term_max;
+        lp::lp_status st = lp().is_feasible() ? lp().maximize_term(get_lpvar(v), term_max) : lp::lp_status::INFEASIBLE;
+        lp().restore_x();
+        switch (st) {
+        case lp::lp_status::OPTIMAL:
+            r = inf_eps(rational::zero(), inf_rational(term_max.x, term_max.y));
+            return true;
+        case lp::lp_status::UNBOUNDED:
+            r = inf_eps(rational::one(), inf_rational());
+            return true;
+        default:
+            return false;
+        }
+    }
+
     expr_ref mk_gt(theory_var v) {
         lp::impq val = get_ivalue(v);
         expr* obj = get_enode(v)->get_expr();
@@ -4152,6 +4255,9 @@ theory_lra::inf_eps theory_lra::value(theory_var v) {
 theory_lra::inf_eps theory_lra::maximize(theory_var v, expr_ref& blocker, bool& has_shared) {
     return m_imp->maximize(v, blocker, has_shared);
 }
+bool theory_lra::relaxation_bound(theory_var v, inf_eps& r) {
+    return m_imp->relaxation_bound(v, r);
+}
 theory_var theory_lra::add_objective(app* term) {
     return m_imp->add_objective(term);
 }
@@ -33,6 +33,8 @@ namespace smt {
         virtual inf_eps value(theory_var) = 0;
         virtual inf_eps maximize(theory_var v, expr_ref& blocker, bool& has_shared) = 0; 
         virtual theory_var add_objective(app* term) = 0;
+        // upper bound of v in the linear relaxation of the current constraints.
+        virtual bool relaxation_bound(theory_var v, inf_eps& r) { return false; }
         bool is_linear(ast_manager& m, expr* term);
         bool is_numeral(arith_util& a, expr* term);
     };
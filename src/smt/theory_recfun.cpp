@@ -34,8 +34,10 @@ namespace smt {
           m_util(m_plugin.u()), 
           m_disabled_guards(m),
           m_enabled_guards(m),
-          m_preds(m) {
-        }
+          m_preds(m),
+          m_pending_calls(m) {
+        m_lazy = ctx.get_fparams().m_recfun_lazy;
+    }
 
     theory_recfun::~theory_recfun() {
         reset_eh();
@@ -61,7 +63,7 @@ namespace smt {
         if (!ctx.b_internalized(atom)) 
             ctx.set_var_theory(ctx.mk_bool_var(atom), get_id());
         if (!ctx.relevancy() && u().is_defined(atom)) 
-            push_case_expand(atom);
+            push_call(atom);
         return true;
     }
 
@@ -78,11 +80,38 @@ namespace smt {
             ctx.mk_enode(term, false, false, true);
         }
         if (!ctx.relevancy() && u().is_defined(term)) {
-            push_case_expand(term);
+            push_call(term);
         }
         return true; 
     }
 
+    /**
+     * Without relevancy, every internalized call would be case expanded
+     * right away. In lazy mode, the calls are queued and expanded at final check.
+     */
+    void theory_recfun::push_call(expr* e) {
+        if (!m_lazy) {
+            push_case_expand(e);
+            return;
+        }
+        m_pending_calls.push_back(e);
+        ctx.push_trail(push_back_vector<expr_ref_vector>(m_pending_calls));
+    }
+
+    /**
+     * A call f(s) that is congruent to a case-expanded call f(t) needs no
+     * expansion of its own: congruence closure equates f(s) with f(t) as long
+     * as the arguments are equal, and backtracking past that equality also
+     * undoes the decision to skip f(s).
+     */
+    bool theory_recfun::is_congruent_to_expanded(expr* e) {
+        if (!ctx.e_internalized(e))
+            return false;
+        enode* n = ctx.get_enode(e);
+        enode* cg = n->get_cg();
+        return cg != n && m_expanded.contains(cg->get_expr());
+    }
+
 
     void theory_recfun::reset_eh() {
         m_stats.reset();
@@ -92,6 +121,10 @@ namespace smt {
         for (auto & kv : m_guard2pending) 
             dealloc(kv.m_value);
         m_guard2pending.reset();
+        m_pending_calls.reset();
+        m_pending_head = 0;
+        m_expanded.reset();
+        m_unfolds.reset();
     }
 
     /*
@@ -142,8 +175,18 @@ namespace smt {
                 activate_guard(p.guard(), *m_guard2pending[p.guard()]);
             else if (p.is_core()) 
                 block_core(p.core());
-            else if (p.is_case()) 
+            else if (p.is_case()) {
+                app* lhs = p.case_ex().m_lhs;
+                if (m_lazy && is_congruent_to_expanded(lhs)) {
+                    ++m_stats.m_congruent_expansions;
+                    continue;
+                }
+                if (m_lazy && !m_expanded.contains(lhs)) {
+                    m_expanded.insert(lhs);
+                    ctx.push_trail(insert_obj_trail<expr>(m_expanded, lhs));
+                }
                 assert_case_axioms(p.case_ex());
+            }
             else 
                 assert_body_axiom(p.body());
         }
@@ -203,6 +246,7 @@ namespace smt {
         if ((u().is_defined(e) || u().is_case_pred(e)) && !m_pred_depth.contains(e)) {
             m_pred_depth.insert(e, depth);
             m_preds.push_back(e);
+            m_stats.m_max_depth = std::max(m_stats.m_max_depth, depth);
         }
     }
 
@@ -310,6 +354,7 @@ namespace smt {
         }
 
         ++m_stats.m_case_expansions;
+        m_unfolds.insert_if_not_there(e.m_lhs->get_decl(), 0)++;
         TRACEFN("assert_case_axioms " << e
                 << " with " << e.m_def->get_cases().size() << " cases");
         SASSERT(e.m_def->is_fun_defined());
@@ -408,6 +453,11 @@ namespace smt {
     }
     
     final_check_status theory_recfun::final_check_eh() {
+        if (m_pending_head < m_pending_calls.size()) {
+            ctx.push_trail(value_trail<unsigned>(m_pending_head));
+            for (; m_pending_head < m_pending_calls.size(); ++m_pending_head)
+                push_case_expand(m_pending_calls.get(m_pending_head));
+        }
         if (can_propagate()) {
             TRACEFN("final\n");
             propagate();
@@ -485,6 +535,12 @@ namespace smt {
         st.update("recfun macro expansion", m_stats.m_macro_expansions);
         st.update("recfun case expansion", m_stats.m_case_expansions);
         st.update("recfun body expansion", m_stats.m_body_expansions);
+        st.update("recfun congruent expansion", m_stats.m_congruent_expansions);
+        st.update("recfun max depth", m_stats.m_max_depth);
+        for (auto const& [f, n] : m_unfolds) {
+            std::string key = "recfun unfold " + f->get_name().str();
+            st.update(symbol(key.c_str()).bare_str(), n);
+        }
     }
 
 }
@@ -29,6 +29,7 @@ namespace smt {
     class theory_recfun : public theory {
         struct stats {
             unsigned m_case_expansions, m_body_expansions, m_macro_expansions;
+            unsigned m_congruent_expansions, m_max_depth;
             void reset() { memset(this, 0, sizeof(stats)); }
             stats() { reset(); }
         };
@@ -46,6 +47,13 @@ namespace smt {
         unsigned_vector          m_preds_lim;
         unsigned                 m_num_rounds { 0 };
 
+        // demand-driven unfolding
+        bool                     m_lazy = false;
+        expr_ref_vector          m_pending_calls;   // calls whose case expansion is postponed to final check
+        unsigned                 m_pending_head = 0;
+        obj_hashtable<expr>      m_expanded;        // calls that were case expanded in the current branch
+        obj_map<func_decl, unsigned> m_unfolds;     // case expansions per function
+
         typedef recfun::propagation_item propagation_item;
 
         scoped_ptr_vector<propagation_item> m_propagation_queue;
@@ -53,6 +61,8 @@ namespace smt {
 
         void push_body_expand(expr* e) { push(alloc(propagation_item, alloc(recfun::body_expansion, u(), to_app(e)))); }
         void push_case_expand(expr* e) { push(alloc(propagation_item, alloc(recfun::case_expansion, u(), to_app(e)))); }
+        void push_call(expr* e);
+        bool is_congruent_to_expanded(expr* e);
         void push_guard(expr* e) { push(alloc(propagation_item, e)); }
         void push_core(expr_ref_vector const& core) { push(alloc(propagation_item, core)); }
         void push(propagation_item* p);
@@ -73,6 +73,16 @@ namespace smt {
         m_smt_plugin->finalize(m_model, m_st);
         m_model = nullptr;
         m_smt_plugin = nullptr;        
+        for (auto* w : m_workers) {
+            model_ref mdl;
+            w->finalize(mdl, m_st);
+        }
+        m_workers.reset();
+        m_shared = nullptr;
+    }
+
+    bool theory_sls::completed() const {
+        return m_smt_plugin->completed() || any_of(m_workers, [](auto* w) { return w->completed(); });
     }
 
     void theory_sls::propagate() {
@@ -82,17 +92,55 @@ namespace smt {
                 fmls.push_back(ctx.get_asserted_formula(i));
             m_checking = true;
             vector<sat::literal_vector> clauses;
+            unsigned num_threads = ctx.get_fparams().m_sls_threads;
+            if (num_threads > 1) {
+                m_shared = alloc(sls::shared_phases, ctx.get_num_bool_vars());
+                m_shared_version = 0;
+                m_smt_plugin->set_shared(m_shared.get(), 0);
+                for (unsigned i = 1; i < num_threads; ++i) {
+                    auto* w = alloc(sls::smt_plugin, *this);
+                    w->set_shared(m_shared.get(), i);
+                    m_workers.push_back(w);
+                }
+            }
             m_smt_plugin->check(fmls, clauses);
+            for (auto* w : m_workers)
+                w->check(fmls, clauses);
             return;
         }
         if (!m_smt_plugin)
             return;
-        if (!m_smt_plugin->completed())
+        import_shared_phase();
+        if (!completed())
             return;
+        // keep the model of the first worker that found one
+        model_ref mdl;
         m_smt_plugin->finalize(m_model, m_st);
+        for (auto* w : m_workers) {
+            w->finalize(mdl, m_st);
+            if (!m_model)
+                m_model = mdl;
+        }
+        m_workers.reset();
         m_smt_plugin = nullptr;
     }    
 
+    /**
+       \brief use the last assignment published by a worker as phase
+       for the next case splits.
+    */
+    void theory_sls::import_shared_phase() {
+        if (!m_shared || m_shared->version() == m_shared_version)
+            return;
+        m_shared_version = m_shared->version();
+        unsigned n = std::min(m_shared->size(), ctx.get_num_bool_vars());
+        for (unsigned v = 0; v < n; ++v) {
+            lbool ph = m_shared->get_phase(v);
+            if (ph != l_undef)
+                ctx.force_phase(v, ph == l_true);
+        }
+    }
+
     void theory_sls::pop_scope_eh(unsigned n) {
         if (!m_smt_plugin)
             return;
@@ -100,8 +148,12 @@ namespace smt {
         unsigned scope_lvl = ctx.get_scope_level();
         if (ctx.get_search_level() == scope_lvl - n) {
             auto& lits = ctx.assigned_literals();
-            for (; m_trail_lim < lits.size() && ctx.get_assign_level(lits[m_trail_lim]) == scope_lvl; ++m_trail_lim) 
-                m_smt_plugin->add_unit(lits[m_trail_lim]);            
+            for (; m_trail_lim < lits.size() && ctx.get_assign_level(lits[m_trail_lim]) == scope_lvl; ++m_trail_lim) {
+                if (m_shared)
+                    m_shared->set_unit(lits[m_trail_lim]);
+                else
+                    m_smt_plugin->add_unit(lits[m_trail_lim]);
+            }
         }
 #if 0
         if (ctx.has_new_best_phase())
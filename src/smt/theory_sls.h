@@ -52,11 +52,17 @@ namespace smt {
     class theory_sls : public theory, public sls::smt_context {
         model_ref m_model;
         sls::smt_plugin* m_smt_plugin = nullptr;
+        // additional workers and the phases they share when sls.threads > 1
+        ptr_vector<sls::smt_plugin> m_workers;
+        scoped_ptr<sls::shared_phases> m_shared;
+        unsigned m_shared_version = 0;
         unsigned m_trail_lim = 0;
         bool m_checking = false;
         ::statistics m_st;
 
         void finalize();
+        void import_shared_phase();
+        bool completed() const;
 
     public:
         theory_sls(context& ctx);
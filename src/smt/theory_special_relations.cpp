@@ -48,6 +48,7 @@ namespace smt {
         s.m_asserted_qhead_old = m_asserted_qhead;
         m_graph.push();        
         m_ufctx.get_trail_stack().push_scope();
+        m_reach.push();
     }
 
     void theory_special_relations::relation::pop(unsigned num_scopes) {
@@ -58,6 +59,8 @@ namespace smt {
         m_scopes.shrink(new_lvl);
         m_graph.pop(num_scopes);        
         m_ufctx.get_trail_stack().pop_scope(num_scopes);
+        m_reach.pop(num_scopes);
+        m_touched.reset();
     }
 
     void theory_special_relations::relation::ensure_var(theory_var v) {
@@ -65,6 +68,72 @@ namespace smt {
         if ((unsigned)v >= m_graph.get_num_nodes()) {
             m_graph.init_var(v);
         }
+        if ((unsigned)v >= m_atoms_of.size())
+            m_atoms_of.resize(v + 1);
+        m_reach.ensure_var(v);
+    }
+
+    void theory_special_relations::reach_index::ensure_var(unsigned v) {
+        if (!m_enabled)
+            return;
+        if (v >= max_nodes) {
+            m_enabled = false;
+            m_rows.reset();
+            m_trail.reset();
+            m_lim.reset();
+            return;
+        }
+        if (v >= m_rows.size())
+            m_rows.resize(v + 1);
+    }
+
+    /**
+       \brief record the edge u -> v. Every node that reaches u,
+       including u, now reaches v and the nodes reached by v.
+       The nodes whose rows change are added to touched.
+    */
+    void theory_special_relations::reach_index::add_edge(unsigned u, unsigned v, unsigned_vector& touched) {
+        if (!m_enabled || u == v || reaches(u, v))
+            return;
+        m_desc.reset();
+        m_desc.append(m_rows[v]);
+        m_desc.reserve(v / 64 + 1, 0);
+        m_desc[v / 64] |= 1ull << (v % 64);
+        for (unsigned x = 0; x < m_rows.size(); ++x) {
+            if (x != u && !reaches(x, u))
+                continue;
+            auto& row = m_rows[x];
+            row.reserve(m_desc.size(), 0);
+            bool changed = false;
+            for (unsigned w = 0; w < m_desc.size(); ++w) {
+                uint64_t add = m_desc[w] & ~row[w];
+                if (add == 0)
+                    continue;
+                row[w] |= add;
+                changed = true;
+                for (; add; add &= add - 1)
+                    m_trail.push_back({ x, 64 * w + uint64_log2(add & (0 - add)) });
+            }
+            if (changed)
+                touched.push_back(x);
+        }
+    }
+
+    void theory_special_relations::reach_index::push() {
+        if (m_enabled)
+            m_lim.push_back(m_trail.size());
+    }
+
+    void theory_special_relations::reach_index::pop(unsigned num_scopes) {
+        if (!m_enabled)
+            return;
+        unsigned old_size = m_lim[m_lim.size() - num_scopes];
+        for (unsigned i = m_trail.size(); i-- > old_size; ) {
+            auto [x, y] = m_trail[i];
+            m_rows[x][y / 64] &= ~(1ull << (y % 64));
+        }
+        m_trail.shrink(old_size);
+        m_lim.shrink(m_lim.size() - num_scopes);
     }
 
     bool theory_special_relations::relation::new_eq_eh(literal l, theory_var v1, theory_var v2) {
@@ -183,6 +252,11 @@ namespace smt {
                 set_neg_cycle_conflict(r);
                 break;
             }
+            if (r.use_reach()) {
+                r.m_reach.add_edge(v1, v2, r.m_touched);
+                r.m_reach.add_edge(v2, v1, r.m_touched);
+                m_can_propagate |= !r.m_touched.empty();
+            }
         }
     }
 
@@ -573,10 +647,58 @@ namespace smt {
     
     lbool theory_special_relations::propagate_po(atom& a) {
         lbool res = l_true;
+        relation& r = a.get_relation();
         if (a.phase()) {
-            relation& r = a.get_relation();
             r.m_uf.merge(a.v1(), a.v2());
             res = enable(a);
+            if (res == l_true && r.use_reach())
+                r.m_reach.add_edge(a.v1(), a.v2(), r.m_touched);
+        }
+        else if (r.use_reach() && (a.v1() == a.v2() || r.m_reach.reaches(a.v1(), a.v2()))) {
+            // v1 !-> v2 but v1 -> v2 is already entailed
+            r.m_explanation.reset();
+            unsigned timestamp = r.m_graph.get_timestamp();
+            VERIFY(a.v1() == a.v2() || r.m_graph.find_shortest_reachable_path(a.v1(), a.v2(), timestamp, r));
+            r.m_explanation.push_back(a.explanation());
+            set_conflict(r);
+            res = l_false;
+        }
+        return res;
+    }
+
+    /**
+       \brief propagate the atoms v1 -> v2 where v1 is a node whose
+       reachable set grew and v2 is now reachable from v1.
+       Returns l_false if an atom was propagated or a conflict was found.
+    */
+    lbool theory_special_relations::propagate_reach(relation& r) {
+        lbool res = l_true;
+        unsigned_vector touched;
+        touched.swap(r.m_touched);
+        for (unsigned x : touched) {
+            for (atom* a : r.m_atoms_of[x]) {
+                if (a->v2() == static_cast<theory_var>(x) || !r.m_reach.reaches(x, a->v2()))
+                    continue;
+                literal lit(a->var());
+                lbool val = ctx.get_assignment(lit);
+                if (val == l_true)
+                    continue;
+                r.m_explanation.reset();
+                unsigned timestamp = r.m_graph.get_timestamp();
+                VERIFY(r.m_graph.find_shortest_reachable_path(x, a->v2(), timestamp, r));
+                if (val == l_false) {
+                    TRACE("special_relations", tout << "reach conflict v" << x << " -> v" << a->v2() << "\n";);
+                    r.m_explanation.push_back(lit);
+                    set_conflict(r);
+                    return l_false;
+                }
+                literal_vector const& lits = r.m_explanation;
+                TRACE("special_relations", tout << "reach propagate " << lit << "\n";);
+                ctx.assign(lit, ctx.mk_justification(
+                               ext_theory_propagation_justification(
+                                   get_id(), ctx, lits.size(), lits.data(), 0, nullptr, lit)));
+                res = l_false;
+            }
         }
         return res;
     }
@@ -597,6 +719,8 @@ namespace smt {
                 continue;
             // v1 !-> v2
             // find v1 -> v3 -> v4 -> v2 path
+            if (r.use_reach() && a.v1() != a.v2() && !r.m_reach.reaches(a.v1(), a.v2()))
+                continue;
             r.m_explanation.reset();
             unsigned timestamp = r.m_graph.get_timestamp();
             bool found_path = a.v1() == a.v2() || r.m_graph.find_shortest_reachable_path(a.v1(), a.v2(), timestamp, r);
@@ -638,20 +762,24 @@ namespace smt {
             default:
                 if (a.phase()) {
                     res = enable(a);
+                    if (res == l_true && r.use_reach())
+                        r.m_reach.add_edge(a.v1(), a.v2(), r.m_touched);
                 }
                 break;
             }
             ++r.m_asserted_qhead;
         }
+        if (res == l_true && !r.m_touched.empty())
+            res = propagate_reach(r);
         return res;
     }
 
     void theory_special_relations::reset_eh() {
+        del_atoms(0);
         for (auto const& kv : m_relations) {
             dealloc(kv.m_value);
         }
         m_relations.reset();
-        del_atoms(0);
     }
 
     void theory_special_relations::assign_eh(bool_var v, bool is_true) {
@@ -687,6 +815,9 @@ namespace smt {
             --it;
             atom* a = *it;
             m_bool_var2atom.erase(a->var());
+            auto& atoms_of = a->get_relation().m_atoms_of[a->v1()];
+            SASSERT(atoms_of.back() == a);
+            atoms_of.pop_back();
             dealloc(a);
         }
         m_atoms.shrink(old_size);
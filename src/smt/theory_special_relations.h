@@ -49,6 +49,7 @@ namespace smt {
             {
                 r.ensure_var(v1);
                 r.ensure_var(v2);
+                r.m_atoms_of[v1].push_back(this);
                 literal_vector ls;
                 ls.push_back(literal(b, false));
                 m_pos = r.m_graph.add_edge(v1, v2, s_integer(0), ls);  // v1 <= v2
@@ -90,6 +91,35 @@ namespace smt {
 
         typedef union_find<union_find_default_ctx> union_find_t;
 
+        /**
+           \brief reachability over the enabled edges of partial and tree orders.
+           Each node has a row of bits for the nodes it reaches. Enabling an edge
+           u -> v adds the descendants of v to the rows of the nodes that reach u.
+           Bits are undone on backtracking. The index is disabled for relations
+           with more than max_nodes nodes, and their reachability is checked
+           in final_check.
+        */
+        class reach_index {
+            static const unsigned max_nodes = 1 << 13;
+            vector<svector<uint64_t>>              m_rows;
+            svector<std::pair<unsigned, unsigned>> m_trail;
+            unsigned_vector                        m_lim;
+            bool                                   m_enabled = true;
+            svector<uint64_t>                      m_desc;
+        public:
+            bool enabled() const { return m_enabled; }
+            bool reaches(unsigned x, unsigned y) const {
+                if (x >= m_rows.size())
+                    return false;
+                auto const& row = m_rows[x];
+                return y / 64 < row.size() && ((row[y / 64] >> (y % 64)) & 1);
+            }
+            void ensure_var(unsigned v);
+            void add_edge(unsigned u, unsigned v, unsigned_vector& touched);
+            void push();
+            void pop(unsigned num_scopes);
+        };
+
         struct relation {
             ast_manager&           m;
             func_decl_ref          m_next;
@@ -102,6 +132,9 @@ namespace smt {
             union_find_default_ctx m_ufctx;
             union_find_t           m_uf;
             literal_vector         m_explanation;
+            reach_index            m_reach;
+            unsigned_vector        m_touched;          // nodes whose descendants grew
+            vector<atoms>          m_atoms_of;         // atoms indexed by their first argument
 
             relation(sr_property p, func_decl* d, ast_manager& m): m(m), m_next(m), m_property(p), m_decl(d), m_asserted_qhead(0), m_uf(m_ufctx) {}
 
@@ -115,6 +148,7 @@ namespace smt {
             void pop(unsigned num_scopes);
             void ensure_var(theory_var v);
             bool new_eq_eh(literal l, theory_var v1, theory_var v2);
+            bool use_reach() const { return (m_property == sr_po || m_property == sr_to) && m_reach.enabled(); }
             void operator()(literal_vector const & ex) {
                 m_explanation.append(ex);
             }
@@ -152,6 +186,7 @@ namespace smt {
         lbool  propagate_plo(atom& a);
         lbool  propagate_po(atom& a); 
         lbool  propagate_tc(atom& a); 
+        lbool  propagate_reach(relation& r);
         theory_var mk_var(expr* e);
         void count_children(graph const& g, unsigned_vector& num_children);
         void ensure_strict(graph& g);
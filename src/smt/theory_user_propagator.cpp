@@ -28,7 +28,8 @@ theory_user_propagator::theory_user_propagator(context& ctx):
     theory(ctx, ctx.get_manager().mk_family_id(user_propagator::plugin::name())),
     m_var2expr(ctx.get_manager()),
     m_push_popping(false),
-    m_to_add(ctx.get_manager())
+    m_to_add(ctx.get_manager()),
+    m_batch_values(ctx.get_manager())
 {}
 
 theory_user_propagator::~theory_user_propagator() {
@@ -41,7 +42,36 @@ void theory_user_propagator::force_push() {
         theory::push_scope_eh();
         m_prop_lim.push_back(m_prop.size());
         m_to_add_lim.push_back(m_to_add.size());
-        m_push_eh(m_user_context, this);
+        if (m_batch_eh)
+            ++m_batch_pushes;
+        else
+            m_push_eh(m_user_context, this);
+    }
+}
+
+/**
+ * In batched mode, push notifications and the fixed and equality events that
+ * the registered callbacks would receive are buffered and delivered by a single
+ * call to the batch callback, before the next propagation round and before
+ * any other callback. Buffered events belong to the current scope; backtracking
+ * drops them together with the undelivered pushes.
+ */
+void theory_user_propagator::flush_batch() {
+    if (!m_batch_eh || (m_batch_pushes == 0 && !has_batch_events()))
+        return;
+    unsigned num_pushes = m_batch_pushes;
+    ptr_vector<expr> fixed, lhs, rhs;
+    expr_ref_vector values(m);
+    m_batch_pushes = 0;
+    fixed.swap(m_batch_fixed);
+    values.swap(m_batch_values);
+    lhs.swap(m_batch_lhs);
+    rhs.swap(m_batch_rhs);
+    try {
+        m_batch_eh(m_user_context, this, num_pushes, fixed.size(), fixed.data(), values.data(), lhs.size(), lhs.data(), rhs.data());
+    }
+    catch (...) {
+        throw default_exception("Exception thrown in \"batch\"-callback");
     }
 }
 
@@ -141,13 +171,19 @@ theory * theory_user_propagator::mk_fresh(context * new_ctx) {
     if ((bool)m_diseq_eh) th->register_diseq(m_diseq_eh);
     if ((bool)m_created_eh) th->register_created(m_created_eh);
     if ((bool)m_decide_eh) th->register_decide(m_decide_eh);
+    if ((bool)m_batch_eh) th->register_batch(m_batch_eh);
     return th;
 }
 
 final_check_status theory_user_propagator::final_check_eh() {
+    if (has_batch_events()) {
+        propagate();
+        return FC_CONTINUE;
+    }
     if (!(bool)m_final_eh)
         return FC_DONE;
     force_push();
+    flush_batch();
     unsigned sz1 = m_prop.size();
     unsigned sz2 = get_num_vars();
     try {
@@ -173,6 +209,11 @@ void theory_user_propagator::new_fixed_eh(theory_var v, expr* value, unsigned nu
     m_fixed.insert(v);
     ctx.push_trail(insert_map<uint_set, unsigned>(m_fixed, v));
     m_id2justification.setx(v, literal_vector(num_lits, jlits), literal_vector());
+    if (m_batch_eh) {
+        m_batch_fixed.push_back(var2expr(v));
+        m_batch_values.push_back(value);
+        return;
+    }
     try {
         m_fixed_eh(m_user_context, this, var2expr(v), value);
     }
@@ -181,6 +222,18 @@ void theory_user_propagator::new_fixed_eh(theory_var v, expr* value, unsigned nu
     }
 }
 
+void theory_user_propagator::new_eq_eh(theory_var v1, theory_var v2) {
+    if (!m_eq_eh)
+        return;
+    force_push();
+    if (m_batch_eh) {
+        m_batch_lhs.push_back(var2expr(v1));
+        m_batch_rhs.push_back(var2expr(v2));
+        return;
+    }
+    m_eq_eh(m_user_context, this, var2expr(v1), var2expr(v2));
+}
+
 bool_var theory_user_propagator::enode_to_bool(enode* n, unsigned idx) {
     if (n->is_bool()) {
         // expression is a boolean
@@ -242,6 +295,7 @@ void theory_user_propagator::decide(bool_var& var, bool& is_pos) {
     unsigned new_bit = original_bit;
 
     force_push();
+    flush_batch();
     expr *e = var2expr(v);
     m_decide_eh(m_user_context, this, e, new_bit, is_pos);
 
@@ -283,17 +337,24 @@ void theory_user_propagator::pop_scope_eh(unsigned num_scopes) {
     if (num_scopes == 0)
         return;
     theory::pop_scope_eh(num_scopes);
+    m_batch_fixed.reset();
+    m_batch_values.reset();
+    m_batch_lhs.reset();
+    m_batch_rhs.reset();
+    unsigned undelivered = std::min(num_scopes, m_batch_pushes);
+    m_batch_pushes -= undelivered;
     unsigned old_sz = m_prop_lim.size() - num_scopes;
     m_prop.shrink(m_prop_lim[old_sz]);
     m_prop_lim.shrink(old_sz);
     old_sz = m_to_add_lim.size() - num_scopes;
     m_to_add.shrink(m_to_add_lim[old_sz]);
     m_to_add_lim.shrink(old_sz);
-    m_pop_eh(m_user_context, this, num_scopes);
+    if (num_scopes > undelivered)
+        m_pop_eh(m_user_context, this, num_scopes - undelivered);
 }
 
 bool theory_user_propagator::can_propagate() {
-    return m_qhead < m_prop.size() || m_to_add_qhead < m_to_add.size() || m_replay_qhead < m_clauses_to_replay.size();
+    return m_qhead < m_prop.size() || m_to_add_qhead < m_to_add.size() || m_replay_qhead < m_clauses_to_replay.size() || has_batch_events();
 }
 
 void theory_user_propagator::propagate_consequence(prop_info const& prop) {
@@ -366,6 +427,10 @@ void theory_user_propagator::propagate_new_fixed(prop_info const& prop) {
 
 
 void theory_user_propagator::propagate() {
+    if (has_batch_events()) {
+        force_push();
+        flush_batch();
+    }
     if (m_qhead == m_prop.size() && m_to_add_qhead == m_to_add.size() && m_replay_qhead == m_clauses_to_replay.size())
         return;
     TRACE("user_propagate", tout << "propagating queue head: " << m_qhead << " prop queue: " << m_prop.size() << "\n");
@@ -424,6 +489,7 @@ bool theory_user_propagator::internalize_term(app* term) {
     if (!m_created_eh)
         throw default_exception("You have to register a created event handler for new terms if you track them");
 
+    flush_batch();
     try {
         m_created_eh(m_user_context, this, term);
     }
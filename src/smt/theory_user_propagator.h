@@ -66,6 +66,7 @@ namespace smt {
         user_propagator::eq_eh_t        m_diseq_eh;
         user_propagator::created_eh_t   m_created_eh;
         user_propagator::decide_eh_t    m_decide_eh;
+        user_propagator::batch_eh_t     m_batch_eh;
 
         user_propagator::context_obj*   m_api_context = nullptr;
         unsigned               m_qhead = 0;
@@ -89,6 +90,13 @@ namespace smt {
         vector<expr_ref_vector> m_clauses_to_replay;
         unsigned                m_replay_qhead = 0;
 
+        // events buffered for the batch callback, all at the current scope
+        unsigned               m_batch_pushes = 0;
+        ptr_vector<expr>       m_batch_fixed;
+        expr_ref_vector        m_batch_values;
+        ptr_vector<expr>       m_batch_lhs;
+        ptr_vector<expr>       m_batch_rhs;
+
         expr* var2expr(theory_var v) { return m_var2expr.get(v); }
         theory_var expr2var(expr* e) { check_defined(e); return m_expr2var[e->get_id()]; }
         void check_defined(expr* e) {
@@ -98,6 +106,9 @@ namespace smt {
 
         void force_push();
 
+        bool has_batch_events() const { return !m_batch_fixed.empty() || !m_batch_lhs.empty(); }
+        void flush_batch();
+
         void propagate_consequence(prop_info const& prop);
         void propagate_new_fixed(prop_info const& prop);
         
@@ -132,6 +143,7 @@ namespace smt {
         void register_diseq(user_propagator::eq_eh_t& diseq_eh) { m_diseq_eh = diseq_eh; }
         void register_created(user_propagator::created_eh_t& created_eh) { m_created_eh = created_eh; }
         void register_decide(user_propagator::decide_eh_t& decide_eh) { m_decide_eh = decide_eh; }
+        void register_batch(user_propagator::batch_eh_t& batch_eh) { m_batch_eh = batch_eh; }
 
         bool has_fixed() const { return (bool)m_fixed_eh; }
         
@@ -147,8 +159,8 @@ namespace smt {
         char const* get_name() const override { return "user_propagate"; }
         bool internalize_atom(app* atom, bool gate_ctx) override;
         bool internalize_term(app* term) override;
-        void new_eq_eh(theory_var v1, theory_var v2) override { if (m_eq_eh) force_push(), m_eq_eh(m_user_context, this, var2expr(v1), var2expr(v2)); }
-        void new_diseq_eh(theory_var v1, theory_var v2) override { if (m_diseq_eh) force_push(), m_diseq_eh(m_user_context, this, var2expr(v1), var2expr(v2)); }
+        void new_eq_eh(theory_var v1, theory_var v2) override;
+        void new_diseq_eh(theory_var v1, theory_var v2) override { if (m_diseq_eh) force_push(), flush_batch(), m_diseq_eh(m_user_context, this, var2expr(v1), var2expr(v2)); }
         bool use_diseqs() const override { return ((bool)m_diseq_eh); }
         bool build_models() const override { return false; }
         final_check_status final_check_eh() override;
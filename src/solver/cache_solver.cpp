@@ -0,0 +1,554 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    cache_solver.cpp
+
+Abstract:
+
+    Solver wrapper that reuses the results of previous check-sat calls.
+
+--*/
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include "util/mutex.h"
+#include "util/obj_pair_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#include "ast/ast_smt2_pp.h"
+#include "ast/ast_util.h"
+#include "ast/decl_collector.h"
+#include "ast/for_each_expr.h"
+#include "ast/rewriter/expr_safe_replace.h"
+#include "model/model.h"
+#include "solver/solver.h"
+#include "solver/cache_solver.h"
+#include "params/solver_params.hpp"
+
+namespace {
+
+    /**
+       \brief canonical form of a query in the manager of the cache.
+    */
+    struct cache_key {
+        expr_ref                       m_fmls;
+        expr_ref                       m_asms;
+        expr_ref_vector                m_sorted_asms;   // arguments of m_asms
+        expr_ref_vector                m_canon_asms;    // canonical form of the i'th local assumption
+        obj_map<func_decl, func_decl*> m_canon;         // translated local constant -> canonical constant
+        func_decl_ref_vector           m_pinned;
+        cache_key(ast_manager& m): m_fmls(m), m_asms(m), m_sorted_asms(m), m_canon_asms(m), m_pinned(m) {}
+    };
+
+    struct cache_entry {
+        lbool           m_result;
+        model_ref       m_model;
+        expr_ref_vector m_core;
+        cache_entry(ast_manager& m, lbool r): m_result(r), m_core(m) {}
+    };
+
+    class query_cache {
+        ast_manager                                     m;
+        expr_ref_vector                                 m_keys;
+        obj_pair_map<expr, expr, cache_entry*>          m_entries;
+        scoped_ptr_vector<cache_entry>                  m_alloc;
+        std::string                                     m_file;
+        bool                                            m_file_loaded = false;
+        std::unordered_map<std::string, unsigned_vector> m_disk;
+
+        /**
+           \brief hash of e that ignores the names of uninterpreted constants.
+        */
+        unsigned shape_hash(expr* e, obj_map<expr, unsigned>& cache) {
+            ptr_buffer<expr> todo;
+            todo.push_back(e);
+            while (!todo.empty()) {
+                expr* t = todo.back();
+                if (cache.contains(t)) {
+                    todo.pop_back();
+                    continue;
+                }
+                if (!is_app(t)) {
+                    cache.insert(t, t->hash());
+                    todo.pop_back();
+                    continue;
+                }
+                app* a = to_app(t);
+                bool valid = true;
+                for (expr* arg : *a)
+                    if (!cache.contains(arg)) {
+                        todo.push_back(arg);
+                        valid = false;
+                    }
+                if (!valid)
+                    continue;
+                todo.pop_back();
+                unsigned h = is_uninterp_const(a) ? combine_hash(a->get_sort()->hash(), 17) : a->get_decl()->hash();
+                for (expr* arg : *a)
+                    h = combine_hash(h, cache[arg]);
+                cache.insert(t, h);
+            }
+            return cache[e];
+        }
+
+        void sort_by_hash(ast_manager& src, expr_ref_vector& es, bool rename, obj_map<expr, unsigned>& shapes) {
+            svector<std::pair<unsigned, unsigned>> hs;
+            for (unsigned i = 0; i < es.size(); ++i)
+                hs.push_back({ rename ? shape_hash(es.get(i), shapes) : es.get(i)->hash(), i });
+            std::stable_sort(hs.begin(), hs.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+            expr_ref_vector sorted(src);
+            for (auto const& [h, i] : hs)
+                sorted.push_back(es.get(i));
+            es.swap(sorted);
+        }
+
+        std::string digest(cache_key const& k) {
+            decl_collector dc(m);
+            dc.visit(k.m_fmls);
+            dc.visit(k.m_asms);
+            std::ostringstream strm;
+            for (func_decl* f : dc.get_func_decls())
+                strm << mk_ismt2_pp(f, m) << "\n";
+            strm << mk_ismt2_pp(k.m_fmls, m) << "\n" << mk_ismt2_pp(k.m_asms, m);
+            std::string text = strm.str();
+            std::ostringstream d;
+            d << std::hex << std::hash<std::string>()(text) << "-" << string_hash(text.c_str(), text.size(), 17) << "-" << std::dec << text.size();
+            return d.str();
+        }
+
+        void load_file() {
+            m_file_loaded = true;
+            std::ifstream in(m_file);
+            std::string line, kw, d;
+            while (std::getline(in, line)) {
+                std::istringstream is(line);
+                unsigned n = 0, idx;
+                if (!(is >> kw >> d >> n) || kw != "unsat")
+                    continue;
+                unsigned_vector core;
+                while (core.size() < n && is >> idx)
+                    core.push_back(idx);
+                if (core.size() == n)
+                    m_disk[d] = core;
+            }
+        }
+
+        model* rename_model(ast_manager& dst, model& mdl, obj_map<func_decl, func_decl*> const& ren) {
+            model* r = alloc(model, dst);
+            for (unsigned i = 0; i < mdl.get_num_constants(); ++i) {
+                func_decl* d = mdl.get_constant(i);
+                func_decl* d2 = d;
+                ren.find(d, d2);
+                r->register_decl(d2, mdl.get_const_interp(d));
+            }
+            for (unsigned i = 0; i < mdl.get_num_functions(); ++i) {
+                func_decl* f = mdl.get_function(i);
+                r->register_decl(f, mdl.get_func_interp(f)->copy());
+            }
+            for (unsigned i = 0; i < mdl.get_num_uninterpreted_sorts(); ++i) {
+                sort* s = mdl.get_uninterpreted_sort(i);
+                ptr_vector<expr> const& u = mdl.get_universe(s);
+                r->register_usort(s, u.size(), u.data());
+            }
+            return r;
+        }
+
+    public:
+
+        query_cache(): m_keys(m) {}
+
+        ast_manager& get_manager() { return m; }
+
+        void set_file(std::string const& f) {
+            if (f != m_file) {
+                m_file = f;
+                m_file_loaded = false;
+                m_disk.clear();
+            }
+            if (!m_file.empty() && !m_file_loaded)
+                load_file();
+        }
+
+        /**
+           \brief compute the canonical form of the assertions and assumptions.
+           Return false if the query cannot be cached.
+        */
+        bool mk_key(ast_manager& src, expr_ref_vector const& fmls, unsigned num_asms, expr* const* asms, bool rename, cache_key& k) {
+            expr_ref_vector conj(src), as(src, num_asms, asms);
+            conj.append(fmls);
+            flatten_and(conj);
+            obj_map<expr, unsigned> shapes;
+            sort_by_hash(src, conj, rename, shapes);
+            sort_by_hash(src, as, rename, shapes);
+            ast_translation tr(src, m);
+            expr_safe_replace rep(m);
+            if (rename) {
+                expr_mark visited;
+                ptr_vector<app> consts;
+                auto collect = [&](expr* e) {
+                    for (expr* t : subterms::all(expr_ref(e, src), nullptr, &visited))
+                        if (is_uninterp_const(t))
+                            consts.push_back(to_app(t));
+                };
+                for (expr* e : conj)
+                    collect(e);
+                for (expr* e : as)
+                    collect(e);
+                for (app* c : consts) {
+                    if (c->get_decl()->get_name().is_numerical())
+                        return false;
+                    app* tc = tr(c);
+                    app* cc = m.mk_const(symbol(k.m_canon.size()), tc->get_sort());
+                    k.m_pinned.push_back(tc->get_decl());
+                    k.m_pinned.push_back(cc->get_decl());
+                    k.m_canon.insert(tc->get_decl(), cc->get_decl());
+                    rep.insert(tc, cc);
+                }
+            }
+            auto canon = [&](expr* e) {
+                expr_ref r(tr(e), m);
+                if (rename)
+                    rep(r);
+                return r;
+            };
+            expr_ref_vector cfmls(m);
+            expr_mark seen;
+            for (expr* e : conj) {
+                expr_ref c = canon(e);
+                if (!seen.is_marked(c)) {
+                    seen.mark(c);
+                    cfmls.push_back(c);
+                }
+            }
+            for (expr* e : as) {
+                expr_ref c = canon(e);
+                if (!seen.is_marked(c)) {
+                    seen.mark(c);
+                    k.m_sorted_asms.push_back(c);
+                }
+            }
+            for (unsigned i = 0; i < num_asms; ++i)
+                k.m_canon_asms.push_back(canon(asms[i]));
+            k.m_fmls = mk_and(cfmls);
+            k.m_asms = mk_and(k.m_sorted_asms);
+            return true;
+        }
+
+        /**
+           \brief retrieve the result of k, with the model and the indices of
+           the local assumptions in the core.
+        */
+        lbool find(ast_manager& src, cache_key const& k, model_ref& mdl, unsigned_vector& core) {
+            cache_entry* e = nullptr;
+            if (m_entries.find(k.m_fmls, k.m_asms, e)) {
+                if (e->m_result == l_false) {
+                    for (unsigned i = 0; i < k.m_canon_asms.size(); ++i)
+                        if (e->m_core.contains(k.m_canon_asms.get(i)))
+                            core.push_back(i);
+                }
+                else {
+                    ast_translation tr(m, src);
+                    model_ref tmdl = e->m_model->translate(tr);
+                    obj_map<func_decl, func_decl*> ren;
+                    for (auto const& [d, c] : k.m_canon)
+                        ren.insert(tr(c), tr(d));
+                    mdl = rename_model(src, *tmdl, ren);
+                }
+                return e->m_result;
+            }
+            if (m_file.empty())
+                return l_undef;
+            auto it = m_disk.find(digest(k));
+            if (it == m_disk.end())
+                return l_undef;
+            for (unsigned idx : it->second) {
+                if (idx >= k.m_sorted_asms.size())
+                    return l_undef;
+                for (unsigned i = 0; i < k.m_canon_asms.size(); ++i)
+                    if (k.m_canon_asms.get(i) == k.m_sorted_asms.get(idx))
+                        core.push_back(i);
+            }
+            return l_false;
+        }
+
+        void insert(ast_manager& src, cache_key const& k, lbool r, model* mdl, expr_ref_vector const& core, expr* const* asms, unsigned capacity) {
+            if (m_entries.contains(k.m_fmls, k.m_asms))
+                return;
+            if (m_alloc.size() >= capacity)
+                reset();
+            if (capacity == 0)
+                return;
+            cache_entry* e = alloc(cache_entry, m, r);
+            if (r == l_true) {
+                ast_translation tr(src, m);
+                model_ref tmdl = mdl->translate(tr);
+                e->m_model = rename_model(m, *tmdl, k.m_canon);
+            }
+            else {
+                for (expr* c : core)
+                    for (unsigned i = 0; i < k.m_canon_asms.size(); ++i)
+                        if (asms[i] == c)
+                            e->m_core.push_back(k.m_canon_asms.get(i));
+            }
+            m_alloc.push_back(e);
+            m_keys.push_back(k.m_fmls);
+            m_keys.push_back(k.m_asms);
+            m_entries.insert(k.m_fmls, k.m_asms, e);
+            if (r != l_false || m_file.empty())
+                return;
+            std::string d = digest(k);
+            if (m_disk.count(d))
+                return;
+            unsigned_vector idxs;
+            for (unsigned i = 0; i < k.m_sorted_asms.size(); ++i)
+                if (e->m_core.contains(k.m_sorted_asms.get(i)))
+                    idxs.push_back(i);
+            m_disk[d] = idxs;
+            std::ofstream out(m_file, std::ios::app);
+            out << "unsat " << d << " " << idxs.size();
+            for (unsigned i : idxs)
+                out << " " << i;
+            out << "\n";
+        }
+
+        void reset() {
+            m_entries.reset();
+            m_alloc.reset();
+            m_keys.reset();
+        }
+    };
+
+    mutex        g_cache_mux;
+    query_cache* g_cache = nullptr;
+
+    query_cache& get_cache() {
+        if (!g_cache)
+            g_cache = alloc(query_cache);
+        return *g_cache;
+    }
+
+    class cache_solver : public solver {
+        ast_manager&    m;
+        solver_ref      s;
+        bool            m_rename;
+        unsigned        m_capacity;
+        std::string     m_file;
+        bool            m_hit = false;
+        model_ref       m_model;
+        expr_ref_vector m_core;
+        unsigned        m_hits = 0;
+        unsigned        m_misses = 0;
+
+        void updt_cache_params(params_ref const& p) {
+            solver_params sp(p);
+            m_rename = sp.cache_rename();
+            m_capacity = sp.cache_size();
+            m_file = sp.cache_file().str();
+        }
+
+        lbool lookup(unsigned num, expr* const* asms) {
+            expr_ref_vector fmls(m);
+            s->get_assertions(fmls);
+            model_ref mdl;
+            unsigned_vector core;
+            lbool r = l_undef;
+            {
+                lock_guard lock(g_cache_mux);
+                query_cache& c = get_cache();
+                c.set_file(m_file);
+                cache_key k(c.get_manager());
+                if (c.mk_key(m, fmls, num, asms, m_rename, k))
+                    r = c.find(m, k, mdl, core);
+            }
+            if (r == l_true) {
+                if (!mdl->is_true(fmls) || !mdl->is_true(expr_ref_vector(m, num, asms)))
+                    return l_undef;
+                m_model = mdl;
+            }
+            else if (r == l_false) {
+                for (unsigned i : core)
+                    m_core.push_back(asms[i]);
+            }
+            return r;
+        }
+
+        void store(unsigned num, expr* const* asms, lbool r) {
+            model_ref mdl;
+            expr_ref_vector core(m);
+            if (r == l_true) {
+                s->get_model(mdl);
+                if (!mdl)
+                    return;
+            }
+            else
+                s->get_unsat_core(core);
+            expr_ref_vector fmls(m);
+            s->get_assertions(fmls);
+            lock_guard lock(g_cache_mux);
+            query_cache& c = get_cache();
+            cache_key k(c.get_manager());
+            if (c.mk_key(m, fmls, num, asms, m_rename, k))
+                c.insert(m, k, r, mdl.get(), core, asms, m_capacity);
+        }
+
+    public:
+
+        cache_solver(solver* s, params_ref const& p):
+            solver(s->get_manager()),
+            m(s->get_manager()),
+            s(s),
+            m_core(m) {
+            updt_cache_params(p);
+        }
+
+        void assert_expr_core2(expr* t, expr* a) override { s->assert_expr(t, a); }
+        void assert_expr_core(expr* t) override { s->assert_expr(t); }
+        void push() override { s->push(); }
+        void pop(unsigned n) override { s->pop(n); }
+
+        lbool check_sat_core(unsigned num_assumptions, expr* const* assumptions) override {
+            m_hit = false;
+            m_model = nullptr;
+            m_core.reset();
+            lbool r = lookup(num_assumptions, assumptions);
+            if (r != l_undef) {
+                ++m_hits;
+                m_hit = true;
+                return r;
+            }
+            m_core.reset();
+            ++m_misses;
+            r = s->check_sat_core(num_assumptions, assumptions);
+            if (r != l_undef)
+                store(num_assumptions, assumptions, r);
+            return r;
+        }
+
+        void collect_statistics(statistics& st) const override {
+            s->collect_statistics(st);
+            st.update("cache hits", m_hits);
+            st.update("cache misses", m_misses);
+        }
+
+        void get_model_core(model_ref& mdl) override {
+            if (m_hit)
+                mdl = m_model;
+            else
+                s->get_model_core(mdl);
+        }
+
+        model_converter_ref get_model_converter() const override {
+            return m_hit ? model_converter_ref() : s->get_model_converter();
+        }
+
+        void get_unsat_core(expr_ref_vector& r) override {
+            if (m_hit)
+                r.append(m_core);
+            else
+                s->get_unsat_core(r);
+        }
+
+        proof* get_proof_core() override { return m_hit ? nullptr : s->get_proof(); }
+
+        solver* translate(ast_manager& m, params_ref const& p) override {
+            return alloc(cache_solver, s->translate(m, p), p);
+        }
+
+        void updt_params(params_ref const& p) override {
+            updt_cache_params(p);
+            s->updt_params(p);
+        }
+
+        unsigned get_num_assertions() const override { return s->get_num_assertions(); }
+        expr* get_assertion(unsigned idx) const override { return s->get_assertion(idx); }
+        std::string reason_unknown() const override { return s->reason_unknown(); }
+        void set_reason_unknown(char const* msg) override { s->set_reason_unknown(msg); }
+        void get_labels(svector<symbol>& r) override { s->get_labels(r); }
+        ast_manager& get_manager() const override { return s->get_manager(); }
+        void reset_params(params_ref const& p) override { updt_cache_params(p); s->reset_params(p); }
+        params_ref const& get_params() const override { return s->get_params(); }
+        void collect_param_descrs(param_descrs& r) override { s->collect_param_descrs(r); }
+        void push_params() override { s->push_params(); }
+        void pop_params() override { s->pop_params(); }
+        void set_produce_models(bool f) override { s->set_produce_models(f); }
+        void set_phase(expr* e) override { s->set_phase(e); }
+        void move_to_front(expr* e) override { s->move_to_front(e); }
+        phase* get_phase() override { return s->get_phase(); }
+        void set_phase(phase* p) override { s->set_phase(p); }
+        unsigned get_num_assumptions() const override { return s->get_num_assumptions(); }
+        expr* get_assumption(unsigned idx) const override { return s->get_assumption(idx); }
+        unsigned get_scope_level() const override { return s->get_scope_level(); }
+        void set_progress_callback(progress_callback* callback) override { s->set_progress_callback(callback); }
+
+        lbool get_consequences(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& consequences) override {
+            m_hit = false;
+            return s->get_consequences(asms, vars, consequences);
+        }
+
+        lbool check_sat_cc(expr_ref_vector const& cube, vector<expr_ref_vector> const& clauses) override {
+            m_hit = false;
+            return s->check_sat_cc(cube, clauses);
+        }
+
+        lbool find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes) override {
+            return s->find_mutexes(vars, mutexes);
+        }
+
+        lbool preferred_sat(expr_ref_vector const& asms, vector<expr_ref_vector>& cores) override {
+            m_hit = false;
+            return s->preferred_sat(asms, cores);
+        }
+
+        expr_ref_vector cube(expr_ref_vector& vars, unsigned backtrack_level) override {
+            return s->cube(vars, backtrack_level);
+        }
+
+        expr* congruence_root(expr* e) override { return s->congruence_root(e); }
+        expr* congruence_next(expr* e) override { return s->congruence_next(e); }
+        std::ostream& display(std::ostream& out, unsigned n, expr* const* assumptions) const override {
+            return s->display(out, n, assumptions);
+        }
+        void get_units_core(expr_ref_vector& units) override { s->get_units_core(units); }
+        expr_ref_vector get_trail(unsigned max_level) override { return s->get_trail(max_level); }
+        void get_levels(ptr_vector<expr> const& vars, unsigned_vector& depth) override { s->get_levels(vars, depth); }
+
+        void register_on_clause(void* ctx, user_propagator::on_clause_eh_t& on_clause) override {
+            s->register_on_clause(ctx, on_clause);
+        }
+
+        void user_propagate_init(
+            void*                ctx,
+            user_propagator::push_eh_t&   push_eh,
+            user_propagator::pop_eh_t&    pop_eh,
+            user_propagator::fresh_eh_t&  fresh_eh) override {
+            s->user_propagate_init(ctx, push_eh, pop_eh, fresh_eh);
+        }
+        void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) override { s->user_propagate_register_fixed(fixed_eh); }
+        void user_propagate_register_final(user_propagator::final_eh_t& final_eh) override { s->user_propagate_register_final(final_eh); }
+        void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) override { s->user_propagate_register_eq(eq_eh); }
+        void user_propagate_register_diseq(user_propagator::eq_eh_t& diseq_eh) override { s->user_propagate_register_diseq(diseq_eh); }
+        void user_propagate_register_expr(expr* e) override { s->user_propagate_register_expr(e); }
+        void user_propagate_register_created(user_propagator::created_eh_t& r) override { s->user_propagate_register_created(r); }
+        void user_propagate_register_decide(user_propagator::decide_eh_t& r) override { s->user_propagate_register_decide(r); }
+        void user_propagate_register_batch(user_propagator::batch_eh_t& r) override { s->user_propagate_register_batch(r); }
+        void user_propagate_initialize_value(expr* var, expr* value) override { s->user_propagate_initialize_value(var, value); }
+    };
+}
+
+solver * mk_cache_solver(solver * s, params_ref const & p) {
+    solver_params sp(p);
+    if (sp.cache())
+        return alloc(cache_solver, s, p);
+    else
+        return s;
+}
+
+void finalize_cache_solver() {
+    lock_guard lock(g_cache_mux);
+    dealloc(g_cache);
+    g_cache = nullptr;
+}
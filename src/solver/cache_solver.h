@@ -0,0 +1,41 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    cache_solver.h
+
+Abstract:
+
+    Solver wrapper that reuses the results of previous check-sat calls.
+
+    The assertions and assumptions of a check-sat call are flattened
+    into top-level conjuncts, ordered by a structural hash and
+    translated into a manager owned by the cache. With solver.cache.rename,
+    uninterpreted constants are also renamed by their first occurrence,
+    so assertions that are equal up to renaming of constants share an
+    entry. Entries store the result, the model, translated back and
+    checked against the assertions on a hit, and the unsat core, as a
+    subset of the assumptions.
+
+    The cache is shared by all solvers and bounded by solver.cache.size.
+    With solver.cache.file, unsat results are also appended to a file,
+    keyed by a digest of the printed canonical form, and reused by later
+    runs.
+
+--*/
+#pragma once
+
+#include "util/params.h"
+
+class solver;
+
+/**
+   \brief wrap s by a cache solver if solver.cache is set in p, and return s otherwise.
+*/
+solver * mk_cache_solver(solver * s, params_ref const & p);
+
+void finalize_cache_solver();
+/*
+  ADD_FINALIZER('finalize_cache_solver();')
+*/
@@ -21,9 +21,14 @@ Notes:
 #include "util/scoped_timer.h"
 #include "util/common_msgs.h"
 #include "ast/ast_pp.h"
+#include "ast/ast_translation.h"
 #include "solver/solver.h"
 #include "solver/combined_solver_params.hpp"
 #include <atomic>
+#ifndef SINGLE_THREAD
+#include <mutex>
+#include <thread>
+#endif
 #define PS_VB_LVL 15
 
 /**
@@ -42,6 +47,12 @@ Notes:
        - push is used
        - assertions are performed after a check_sat
        - parameter ignore_solver1==false
+
+   With the parameter race, the first check in non-incremental mode
+   runs solver 1 on a translated copy in a separate thread and solver 2
+   in the calling thread. The first solver to return sat or unsat wins
+   and the other is canceled. Results of solver 1 are translated back.
+   Later checks use the incremental mode as usual.
 */
 class combined_solver : public solver {
 public:
@@ -65,6 +76,14 @@ private:
     bool                 m_ignore_solver1;
     inc_unknown_behavior m_inc_unknown_behavior;
     unsigned             m_inc_timeout;
+    bool                 m_race;
+    // results of solver 1 when it wins a race
+    bool                 m_use_race_results = false;
+    model_ref            m_race_model;
+    expr_ref_vector      m_race_core;
+    proof_ref            m_race_proof;
+    std::string          m_race_reason;
+    statistics           m_race_stats;
     
     void switch_inc_mode() {
         m_inc_mode = true;
@@ -90,7 +109,103 @@ private:
         m_inc_timeout    = p.solver2_timeout();
         m_ignore_solver1 = p.ignore_solver1();
         m_inc_unknown_behavior = static_cast<inc_unknown_behavior>(p.solver2_unknown());
+        m_race           = p.race();
+    }
+
+#ifndef SINGLE_THREAD
+    /**
+       \brief race solver 1 and solver 2. Set raced to false if solver 1
+       could not be copied.
+    */
+    lbool race(bool& raced) {
+        ast_manager& m = get_manager();
+        ast_manager m2(m, true);
+        solver_ref s1;
+        raced = false;
+        try {
+            s1 = m_solver1->translate(m2, get_params());
+        }
+        catch (z3_exception& ex) {
+            IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"could not copy solver 1: " << ex.what() << "\")\n";);
+            return l_undef;
+        }
+        raced = true;
+        IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"racing solver 1 and solver 2\")\n";);
+        scoped_limits sl(m.limit());
+        sl.push_child(&m2.limit());
+        std::mutex mux;
+        int winner = -1;
+        bool canceled2 = false;
+        lbool r1 = l_undef, r2 = l_undef;
+        std::thread th([&]() {
+            try {
+                r1 = s1->check_sat(0, nullptr);
+            }
+            catch (z3_exception&) {
+                r1 = l_undef;
+            }
+            std::lock_guard<std::mutex> lock(mux);
+            if (winner == -1 && r1 != l_undef) {
+                winner = 1;
+                canceled2 = true;
+                m.limit().inc_cancel();
+            }
+        });
+        try {
+            r2 = m_solver2->check_sat_core(0, nullptr);
+        }
+        catch (z3_exception&) {
+            bool rethrow = false;
+            {
+                std::lock_guard<std::mutex> lock(mux);
+                if (!canceled2) {
+                    winner = 2;
+                    m2.limit().cancel();
+                    rethrow = true;
+                }
+            }
+            if (rethrow) {
+                th.join();
+                throw;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mux);
+            if (winner == -1 && r2 != l_undef) {
+                winner = 2;
+                m2.limit().cancel();
+            }
+        }
+        th.join();
+        if (canceled2)
+            m.limit().dec_cancel();
+        if (winner != 1) {
+            IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"solver 2 won\")\n";);
+            return r2;
+        }
+        IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"solver 1 won\")\n";);
+        ast_translation tr(m2, m);
+        m_use_race_results = true;
+        m_race_reason = s1->reason_unknown();
+        m_race_stats.reset();
+        s1->collect_statistics(m_race_stats);
+        if (r1 == l_true) {
+            model_ref mdl;
+            s1->get_model(mdl);
+            if (mdl)
+                m_race_model = mdl->translate(tr);
+        }
+        else {
+            expr_ref_vector core(m2);
+            s1->get_unsat_core(core);
+            for (expr* c : core)
+                m_race_core.push_back(tr(c));
+            if (m.proofs_enabled() && s1->get_proof())
+                m_race_proof = tr(s1->get_proof());
+        }
+        return r1;
     }
+#endif
 
     ast_manager& get_manager() const override { return m_solver1->get_manager(); }
 
@@ -116,7 +231,9 @@ private:
 
 public:
     combined_solver(solver * s1, solver * s2, params_ref const & p):
-        solver(s1->get_manager()) {
+        solver(s1->get_manager()),
+        m_race_core(s1->get_manager()),
+        m_race_proof(s1->get_manager()) {
         m_solver1 = s1;
         m_solver2 = s2;
         updt_local_params(p);
@@ -211,6 +328,10 @@ public:
     lbool check_sat_core(unsigned num_assumptions, expr * const * assumptions) override {
         m_check_sat_executed  = true;        
         m_use_solver1_results = false;
+        m_use_race_results    = false;
+        m_race_model          = nullptr;
+        m_race_core.reset();
+        m_race_proof          = nullptr;
 
         if (get_num_assumptions() != 0 ||            
             num_assumptions > 0 ||  // assumptions were provided            
@@ -247,6 +368,14 @@ public:
             }
             IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"solver 2 failed, trying solver1\")\n";);
         }
+#ifndef SINGLE_THREAD
+        else if (m_race && std::thread::hardware_concurrency() > 1) {
+            bool raced = false;
+            lbool r = race(raced);
+            if (raced)
+                return r;
+        }
+#endif
         
         IF_VERBOSE(PS_VB_LVL, verbose_stream() << "(combined-solver \"using solver 1\")\n";);
         m_use_solver1_results = true;
@@ -291,19 +420,25 @@ public:
 
     void collect_statistics(statistics & st) const override {
         m_solver2->collect_statistics(st);
+        if (m_use_race_results)
+            st.copy(m_race_stats);
         if (m_use_solver1_results)
             m_solver1->collect_statistics(st);
     }
 
     void get_unsat_core(expr_ref_vector & r) override {
-        if (m_use_solver1_results)
+        if (m_use_race_results)
+            r.append(m_race_core);
+        else if (m_use_solver1_results)
             m_solver1->get_unsat_core(r);
         else
             m_solver2->get_unsat_core(r);
     }
 
     void get_model_core(model_ref & m) override {
-        if (m_use_solver1_results)
+        if (m_use_race_results)
+            m = m_race_model;
+        else if (m_use_solver1_results)
             m_solver1->get_model(m);
         else
             m_solver2->get_model(m);
@@ -324,14 +459,18 @@ public:
     }
 
     proof * get_proof_core() override {
-        if (m_use_solver1_results)
+        if (m_use_race_results)
+            return m_race_proof;
+        else if (m_use_solver1_results)
             return m_solver1->get_proof_core();
         else
             return m_solver2->get_proof_core();
     }
 
     std::string reason_unknown() const override {
-        if (m_use_solver1_results)
+        if (m_use_race_results)
+            return m_race_reason;
+        else if (m_use_solver1_results)
             return m_solver1->reason_unknown();
         else
             return m_solver2->reason_unknown();
@@ -390,6 +529,10 @@ public:
     void user_propagate_register_decide(user_propagator::decide_eh_t& r) override {
         m_solver2->user_propagate_register_decide(r);
     }
+
+    void user_propagate_register_batch(user_propagator::batch_eh_t& r) override {
+        m_solver2->user_propagate_register_batch(r);
+    }
     
     void user_propagate_clear() override {
         m_solver2->user_propagate_clear();
@@ -18,10 +18,15 @@ Notes:
 
 --*/
 
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
+#include "util/scoped_ptr_vector.h"
 #include "solver/solver.h"
 #include "solver/mus.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "ast/ast_translation.h"
 #include "model/model_evaluator.h"
 
 
@@ -38,6 +43,7 @@ struct mus::imp {
     expr_ref_vector          m_soft;
     vector<rational>         m_weights;
     rational                 m_weight;
+    unsigned                 m_num_threads = 1;
 
     imp(solver& s): 
         m_solver(s), m(s.get_manager()), m_lit2expr(m),  m_assumptions(m), m_soft(m)
@@ -74,6 +80,15 @@ struct mus::imp {
             mus.push_back(m_lit2expr.back());
             return l_true;
         }
+#ifndef SINGLE_THREAD
+        if (m_num_threads > 1 && m_soft.empty() && m_lit2expr.size() >= 2 * m_num_threads) {
+            bool is_par = false;
+            lbool r = get_mus_par(mus, is_par);
+            if (is_par)
+                return r;
+            mus.reset();
+        }
+#endif
         return get_mus1(mus);
     }
 
@@ -125,6 +140,252 @@ struct mus::imp {
         return l_true;
     }
 
+#ifndef SINGLE_THREAD
+
+    /**
+       \brief a copy of the solver used to test one chunk of the unknown
+       literals per round. Copies persist across rounds, so each of them
+       keeps the clauses it learned while testing earlier chunks.
+    */
+    struct worker {
+        ast_manager             m;
+        solver_ref              s;
+        expr_ref_vector         m_lits;         // translation of m_lit2expr
+        expr_ref_vector         m_assumptions;  // translation of the extra assumptions
+        obj_map<expr, unsigned> m_lit2idx;
+        expr_ref_vector         m_asms;
+        unsigned_vector         m_chunk;
+        lbool                   m_result = l_undef;
+        unsigned_vector         m_core;
+        bool                    m_not_lit_in_core = false;
+        unsigned                m_num_falsified = 0;
+        unsigned                m_falsified = UINT_MAX;
+
+        worker(ast_manager& src): m(src, true), m_lits(m), m_assumptions(m), m_asms(m) {}
+    };
+
+    /**
+       \brief create one copy of the solver per thread. Return false if the
+       solver cannot be copied, or if the copy carries assumptions of its own
+       (names of tracked assertions) that would be added to every check.
+    */
+    bool mk_workers(scoped_ptr_vector<worker>& workers) {
+        params_ref p;
+        p.copy(m_solver.get_params());
+        p.set_bool("core.minimize", false);
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            worker* w = alloc(worker, m);
+            workers.push_back(w);
+            try {
+                w->s = m_solver.translate(w->m, p);
+            }
+            catch (z3_exception& ex) {
+                IF_VERBOSE(12, verbose_stream() << "(mus \"could not copy solver: " << ex.what() << "\")\n";);
+                return false;
+            }
+            if (w->s->get_num_assumptions() > 0)
+                return false;
+            ast_translation tr(m, w->m);
+            for (unsigned idx = 0; idx < m_lit2expr.size(); ++idx) {
+                w->m_lits.push_back(tr(m_lit2expr.get(idx)));
+                w->m_lit2idx.insert(w->m_lits.back(), idx);
+            }
+            for (expr* a : m_assumptions)
+                w->m_assumptions.push_back(tr(a));
+        }
+        return true;
+    }
+
+    /**
+       \brief check M & (U \ C) for the chunk C of the worker. A chunk with a
+       single literal lit is checked together with not lit, as in get_mus1.
+    */
+    void check_chunk(worker& w, unsigned_vector const& mus, unsigned_vector const& unknown, bool_vector const& in_chunk) {
+        w.m_result = l_undef;
+        w.m_core.reset();
+        w.m_not_lit_in_core = false;
+        w.m_num_falsified = 0;
+        w.m_falsified = UINT_MAX;
+        try {
+            w.m_asms.reset();
+            for (unsigned idx : mus)
+                w.m_asms.push_back(w.m_lits.get(idx));
+            for (unsigned idx : unknown)
+                if (!in_chunk[idx])
+                    w.m_asms.push_back(w.m_lits.get(idx));
+            w.m_asms.append(w.m_assumptions);
+            expr_ref not_lit(w.m);
+            if (w.m_chunk.size() == 1) {
+                not_lit = mk_not(w.m, w.m_lits.get(w.m_chunk[0]));
+                w.m_asms.push_back(not_lit);
+            }
+            w.m_result = w.s->check_sat(w.m_asms);
+            if (w.m_result == l_true && w.m_chunk.size() == 1) {
+                w.m_num_falsified = 1;
+                w.m_falsified = w.m_chunk[0];
+            }
+            else if (w.m_result == l_true) {
+                model_ref mdl;
+                w.s->get_model(mdl);
+                for (unsigned idx : w.m_chunk) {
+                    if (!mdl)
+                        break;
+                    if (!mdl->is_true(w.m_lits.get(idx))) {
+                        ++w.m_num_falsified;
+                        w.m_falsified = idx;
+                    }
+                }
+            }
+            else if (w.m_result == l_false) {
+                expr_ref_vector core(w.m);
+                w.s->get_unsat_core(core);
+                unsigned idx;
+                for (expr* c : core) {
+                    if (c == not_lit)
+                        w.m_not_lit_in_core = true;
+                    else if (w.m_lit2idx.find(c, idx))
+                        w.m_core.push_back(idx);
+                }
+            }
+        }
+        catch (z3_exception&) {
+            w.m_result = l_undef;
+        }
+    }
+
+    /**
+       \brief deletion based MUS extraction that removes disjoint chunks of
+       the unknown literals concurrently, one chunk per copy of the solver.
+
+       A chunk that can be removed shrinks the unknown literals to the core of
+       its check; the smallest such core is used. A satisfiable check whose
+       model falsifies exactly one literal of the chunk shows that the literal
+       is critical: all other unknown literals are satisfied together with the
+       mus. If no chunk could be removed and no literal was found critical,
+       the chunk size is halved. Chunks of a single literal always make
+       progress.
+
+       Set is_par to false if the solver could not be copied.
+    */
+    lbool get_mus_par(expr_ref_vector& mus, bool& is_par) {
+        is_par = false;
+        scoped_ptr_vector<worker> workers;
+        if (!mk_workers(workers))
+            return l_undef;
+        is_par = true;
+        scoped_limits sl(m.limit());
+        for (worker* w : workers)
+            sl.push_child(&w->m.limit());
+
+        unsigned_vector unknown, mus_idx, next;
+        for (unsigned idx = 0; idx < m_lit2expr.size(); ++idx)
+            unknown.push_back(idx);
+        bool_vector in_chunk(m_lit2expr.size(), false), marked(m_lit2expr.size(), false);
+        unsigned chunk_size = std::max(1u, unknown.size() / (2 * m_num_threads));
+
+        while (!unknown.empty()) {
+            IF_VERBOSE(12, verbose_stream() << "(mus reducing core: " << unknown.size() << " new core: " << mus_idx.size() << " chunk: " << chunk_size << ")\n";);
+            chunk_size = std::min(chunk_size, std::max(1u, unknown.size() / m_num_threads));
+            unsigned num_chunks = 0, end = unknown.size();
+            for (; num_chunks < m_num_threads && end > 0; ++num_chunks) {
+                worker& w = *workers[num_chunks];
+                w.m_chunk.reset();
+                for (unsigned i = 0; i < chunk_size && end > 0; ++i) {
+                    w.m_chunk.push_back(unknown[--end]);
+                }
+            }
+            vector<std::thread> threads;
+            for (unsigned j = 0; j < num_chunks; ++j) {
+                threads.push_back(std::thread([&, j]() {
+                    worker& w = *workers[j];
+                    bool_vector chunk_marks(m_lit2expr.size(), false);
+                    for (unsigned idx : w.m_chunk)
+                        chunk_marks[idx] = true;
+                    check_chunk(w, mus_idx, unknown, chunk_marks);
+                }));
+            }
+            for (auto& th : threads)
+                th.join();
+
+            // pick the removable chunk that leaves the fewest unknown literals.
+            worker* best = nullptr;
+            unsigned best_size = UINT_MAX;
+            for (unsigned j = 0; j < num_chunks; ++j) {
+                worker& w = *workers[j];
+                if (w.m_result == l_undef)
+                    return l_undef;
+                if (w.m_result != l_false)
+                    continue;
+                for (unsigned idx : w.m_chunk)
+                    in_chunk[idx] = true;
+                unsigned sz = 0;
+                if (w.m_chunk.size() == 1 && w.m_not_lit_in_core) {
+                    sz = unknown.size() - 1;
+                }
+                else {
+                    for (unsigned idx : w.m_core)
+                        if (!in_chunk[idx] && !marked[idx])
+                            marked[idx] = true, ++sz;
+                    for (unsigned idx : w.m_core)
+                        marked[idx] = false;
+                }
+                for (unsigned idx : w.m_chunk)
+                    in_chunk[idx] = false;
+                if (sz < best_size)
+                    best = &w, best_size = sz;
+            }
+            bool progress = best != nullptr;
+            if (best) {
+                for (unsigned idx : best->m_chunk)
+                    in_chunk[idx] = true;
+                bool use_core = best->m_chunk.size() > 1 || !best->m_not_lit_in_core;
+                if (use_core)
+                    for (unsigned idx : best->m_core)
+                        marked[idx] = true;
+                next.reset();
+                for (unsigned idx : unknown)
+                    if (!in_chunk[idx] && (!use_core || marked[idx]))
+                        next.push_back(idx);
+                for (unsigned idx : best->m_chunk)
+                    in_chunk[idx] = false;
+                for (unsigned idx : best->m_core)
+                    marked[idx] = false;
+                unknown.swap(next);
+            }
+            // literals falsified alone by a model are critical.
+            // they belong to every core contained in the unknown literals.
+            for (unsigned j = 0; j < num_chunks; ++j) {
+                worker& w = *workers[j];
+                if (w.m_result == l_true && w.m_num_falsified == 1)
+                    marked[w.m_falsified] = true;
+            }
+            next.reset();
+            for (unsigned idx : unknown) {
+                if (marked[idx]) {
+                    mus_idx.push_back(idx);
+                    progress = true;
+                }
+                else
+                    next.push_back(idx);
+            }
+            for (unsigned j = 0; j < num_chunks; ++j) {
+                worker& w = *workers[j];
+                if (w.m_result == l_true && w.m_num_falsified == 1)
+                    marked[w.m_falsified] = false;
+            }
+            unknown.swap(next);
+            if (!progress) {
+                SASSERT(chunk_size > 1);
+                chunk_size = std::max(1u, chunk_size / 2);
+            }
+        }
+        for (unsigned idx : mus_idx)
+            mus.push_back(m_lit2expr.get(idx));
+        return l_true;
+    }
+
+#endif
+
     // use correction sets
     lbool get_mus2(expr_ref_vector& mus) {
         expr* lit = nullptr;
@@ -380,3 +641,7 @@ void mus::set_soft(unsigned sz, expr* const* soft, rational const* weights) {
 rational mus::get_best_model(model_ref& mdl) {
     return m_imp->get_best_model(mdl);
 }
+
+void mus::set_num_threads(unsigned n) {
+    m_imp->m_num_threads = std::max(1u, n);
+}
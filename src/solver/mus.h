@@ -59,6 +59,13 @@ class mus {
     void set_soft(unsigned sz, expr* const* soft, rational const* weights);
 
     rational get_best_model(model_ref& mdl);
+
+    /**
+       Use n copies of the solver to test disjoint chunks of the
+       core concurrently. Copies are only used when no soft
+       constraints are set with set_soft.
+    */
+    void set_num_threads(unsigned n);
     
 };
 
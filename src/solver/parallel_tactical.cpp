@@ -25,13 +25,25 @@ Notes:
   3. Cube using the parameter settings prescribed in m_params.
   4. Optionally pass the cubes as assumptions and solve each sub-cube with a prescribed resource bound.
   5. Assemble cubes that could not be solved and create a cube state.
+
+ Each worker has its own deque of tasks. It takes its most recent task and
+ steals the oldest task of another worker when its deque is empty. Cubes 
+ found during conquer are spawned as soon as a worker is idle.
+
+ Units learned while simplifying a state are shared. A unit learned under a
+ set of asserted cubes is valid for every state whose asserted cubes include
+ that set. The same holds for short learned clauses, which with the sat.euf
+ core include theory lemmas, and for equalities between terms that the
+ solver derived without decisions.
  
 --*/
 
 #include "util/scoped_ptr_vector.h"
+#include "util/uint_set.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/ast_translation.h"
+#include "ast/for_each_expr.h"
 #include "solver/solver.h"
 #include "solver/solver2tactic.h"
 #include "tactic/tactic.h"
@@ -77,9 +89,11 @@ class parallel_tactic : public tactic {
     class task_queue {
         std::mutex                   m_mutex;
         std::condition_variable      m_cond;
-        ptr_vector<solver_state>     m_tasks;
+        vector<ptr_vector<solver_state>> m_tasks;  // one deque per worker
         ptr_vector<solver_state>     m_active;
+        unsigned                     m_num_tasks = 0;
         unsigned                     m_num_waiters;
+        unsigned                     m_num_steals = 0;
         std::atomic<bool>            m_shutdown;
 
         void inc_wait() {
@@ -92,14 +106,28 @@ class parallel_tactic : public tactic {
             --m_num_waiters;
         }
 
-        solver_state* try_get_task() {
+        // take the most recent task of worker id or steal the oldest task of another worker.
+        solver_state* try_get_task(unsigned id) {
             solver_state* st = nullptr;
             std::lock_guard<std::mutex> lock(m_mutex);
-            if (!m_tasks.empty()) {
-                st = m_tasks.back();
-                m_tasks.pop_back();
-                m_active.push_back(st);
+            if (m_num_tasks == 0)
+                return nullptr;
+            auto& own = m_tasks[id];
+            if (!own.empty()) {
+                st = own.back();
+                own.pop_back();
             }
+            for (unsigned i = 1; !st && i < m_tasks.size(); ++i) {
+                auto& other = m_tasks[(id + i) % m_tasks.size()];
+                if (!other.empty()) {
+                    st = other[0];
+                    other.erase(other.begin());
+                    ++m_num_steals;
+                }
+            }
+            SASSERT(st);
+            --m_num_tasks;
+            m_active.push_back(st);
             return st;
         }
 
@@ -124,9 +152,17 @@ class parallel_tactic : public tactic {
 
         bool in_shutdown() const { return m_shutdown; }
 
-        void add_task(solver_state* task) {
+        void set_num_workers(unsigned n) {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_tasks.push_back(task);
+            SASSERT(m_num_tasks == 0);
+            m_tasks.reset();
+            m_tasks.resize(std::max(n, 1u));
+        }
+
+        void add_task(solver_state* task, unsigned id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks[id % m_tasks.size()].push_back(task);
+            ++m_num_tasks;
             if (m_num_waiters > 0) {
                 m_cond.notify_one();
             }            
@@ -134,13 +170,15 @@ class parallel_tactic : public tactic {
 
         bool is_idle() {
             std::lock_guard<std::mutex> lock(m_mutex);
-            return m_tasks.empty() && m_num_waiters > 0;
+            return m_num_tasks == 0 && m_num_waiters > 0;
         }
 
-        solver_state* get_task() { 
+        unsigned num_steals() const { return m_num_steals; }
+
+        solver_state* get_task(unsigned id) { 
             while (!m_shutdown) {
                 inc_wait();
-                solver_state* st = try_get_task();
+                solver_state* st = try_get_task(id);
                 if (st) {
                     dec_wait();
                     return st;
@@ -159,36 +197,41 @@ class parallel_tactic : public tactic {
         void task_done(solver_state* st) {
             std::lock_guard<std::mutex> lock(m_mutex);
             m_active.erase(st);
-            if (m_tasks.empty() && m_active.empty()) {
+            if (m_num_tasks == 0 && m_active.empty()) {
                 m_shutdown = true;
                 m_cond.notify_all();
             }
         }
 
         void stats(::statistics& st) {
-            for (auto* t : m_tasks) 
-                t->get_solver().collect_statistics(st);
+            for (auto& ts : m_tasks) 
+                for (auto* t : ts)
+                    t->get_solver().collect_statistics(st);
             for (auto* t : m_active) 
                 t->get_solver().collect_statistics(st);
         }
 
         void reset() {
-            for (auto* t : m_tasks) 
-                dealloc(t);
+            for (auto& ts : m_tasks) {
+                for (auto* t : ts) 
+                    dealloc(t);
+                ts.reset();
+            }
             for (auto* t : m_active) 
                 dealloc(t);
-            m_tasks.reset();
             m_active.reset();
+            m_num_tasks = 0;
+            m_num_steals = 0;
             m_num_waiters = 0;
             m_shutdown = false;
         }
 
         std::ostream& display(std::ostream& out) {
             std::lock_guard<std::mutex> lock(m_mutex);
-            out << "num_tasks " << m_tasks.size() << " active: " << m_active.size() << "\n";
-            for (solver_state* st : m_tasks) {
-                st->display(out);
-            }
+            out << "num_tasks " << m_num_tasks << " active: " << m_active.size() << " steals: " << m_num_steals << "\n";
+            for (auto& ts : m_tasks) 
+                for (solver_state* st : ts) 
+                    st->display(out);
             return out;
         }
 
@@ -221,6 +264,7 @@ class parallel_tactic : public tactic {
         unsigned        m_depth;                  // number of nested calls to cubing
         double          m_width;                  // estimate of fraction of problem handled by state
         bool            m_giveup;
+        uint_set        m_imported;               // indices of shared units and lemmas asserted on the solver
 
     public:
         solver_state(ast_manager* m, solver* s, params_ref const& p): 
@@ -261,11 +305,16 @@ class parallel_tactic : public tactic {
             for (expr* c : m_assumptions) st->m_assumptions.push_back(tr(c));
             st->m_depth = m_depth;
             st->m_width = m_width;
+            st->m_imported = m_imported;
             return st;
         }
 
         vector<cube_var> const& cubes() const { return m_cubes; }
 
+        expr_ref_vector const& asserted_cubes() const { return m_asserted_cubes; }
+
+        uint_set& imported() { return m_imported; }
+
         // remove up to n cubes from list of cubes.
         vector<cube_var> split_cubes(unsigned n) {
             vector<cube_var> result;
@@ -397,6 +446,18 @@ private:
     std::string   m_exn_msg;
     std::string   m_reason_undef;
 
+    // units and lemmas shared between solver states, in m_serialize_manager.
+    struct shared_unit {
+        expr*            m_unit;
+        ptr_vector<expr> m_cube;   // asserted cubes the unit was learned under
+    };
+    bool                        m_share_units;
+    unsigned                    m_share_lemmas;
+    scoped_ptr<expr_ref_vector> m_unit_trail;
+    vector<shared_unit>         m_units;
+    obj_hashtable<expr>         m_unit_set;
+    obj_hashtable<func_decl>    m_input_decls;   // units may only use symbols of the input
+
     void init() {
         parallel_params pp(m_params);
         m_num_threads = std::min((unsigned) std::thread::hardware_concurrency(), pp.threads_max());
@@ -408,9 +469,97 @@ private:
         m_last_depth = 0;
         m_backtrack_frequency = pp.conquer_backtrack_frequency();
         m_conquer_delay = pp.conquer_delay();
+        m_share_units = pp.share_units();
+        m_share_lemmas = pp.share_lemmas();
         m_exn_code = 0;
         m_params.set_bool("override_incremental", true);
         m_core = nullptr;        
+        m_queue.set_num_workers(m_num_threads);
+    }
+
+    void init_shared_units(expr_ref_vector const& clauses) {
+        m_units.reset();
+        m_unit_set.reset();
+        m_input_decls.reset();
+        if (!m_share_units)
+            return;
+        ast_manager& m = clauses.get_manager();
+        if (!m_serialize_manager) 
+            m_serialize_manager = alloc(ast_manager, m, true);
+        m_unit_trail = nullptr;
+        m_unit_trail = alloc(expr_ref_vector, *m_serialize_manager);
+        ast_translation tr(m, *m_serialize_manager);
+        for (expr* e : subterms::ground(clauses)) {
+            if (is_app(e) && to_app(e)->get_family_id() == null_family_id) {
+                app* a = to_app(tr(e));
+                m_unit_trail->push_back(a);
+                m_input_decls.insert(a->get_decl());
+            }
+        }
+    }
+
+    bool is_shareable(expr* u) {
+        for (expr* e : subterms::all(expr_ref(u, *m_serialize_manager))) {
+            if (!is_app(e))
+                return false;
+            if (to_app(e)->get_family_id() == null_family_id && !m_input_decls.contains(to_app(e)->get_decl()))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+       \brief publish the units and short lemmas of the solver of s together with the cubes asserted on s.
+    */
+    void export_units(solver_state& s) {
+        if (!m_share_units)
+            return;
+        expr_ref_vector units = s.get_solver().get_trail(0);
+        if (m_share_lemmas > 0)
+            s.get_solver().get_lemmas(m_share_lemmas, units);
+        if (units.empty())
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ast_translation tr(s.m(), *m_serialize_manager);
+        expr_ref_vector cube(tr(s.asserted_cubes()));
+        unsigned num_units = m_units.size();
+        for (expr* u : units) {
+            expr_ref u1(tr(u), *m_serialize_manager);
+            if (m_unit_set.contains(u1) || cube.contains(u1) || !is_shareable(u1))
+                continue;
+            m_unit_trail->push_back(u1);
+            m_unit_set.insert(u1);
+            m_units.push_back({ u1, ptr_vector<expr>(cube.size(), cube.data()) });
+        }
+        if (num_units < m_units.size()) {
+            m_unit_trail->append(cube);
+            IF_VERBOSE(2, verbose_stream() << "(tactic.parallel :shared-units " << m_units.size() << ")\n";);
+        }
+    }
+
+    /**
+       \brief assert the shared units that were learned under cubes that are asserted on s.
+    */
+    void import_units(solver_state& s) {
+        if (!m_share_units)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_units.empty())
+            return;
+        ast_translation tr(s.m(), *m_serialize_manager);
+        expr_ref_vector cube(tr(s.asserted_cubes()));
+        obj_hashtable<expr> cubes;
+        for (expr* c : cube)
+            cubes.insert(c);
+        ast_translation back(*m_serialize_manager, s.m());
+        for (unsigned i = 0; i < m_units.size(); ++i) {
+            if (s.imported().contains(i))
+                continue;
+            if (!all_of(m_units[i].m_cube, [&](expr* c) { return cubes.contains(c); }))
+                continue;
+            s.imported().insert(i);
+            s.get_solver().assert_expr(back(m_units[i].m_unit));
+        }
     }
 
     void log_branches(lbool status) {
@@ -515,7 +664,7 @@ private:
         close_branch(s, l_undef);
     }
 
-    void cube_and_conquer(solver_state& s) {
+    void cube_and_conquer(solver_state& s, unsigned id) {
         ast_manager& m = s.m();
         vector<cube_var> cube, hard_cubes, cubes;
         expr_ref_vector vars(m);
@@ -530,7 +679,7 @@ private:
         IF_VERBOSE(2, verbose_stream() << "(tactic.parallel :split-cube " << cube.size() << ")\n";);
         {
             // std::lock_guard<std::mutex> lock(m_mutex);
-            if (!s.cubes().empty()) m_queue.add_task(s.clone());
+            if (!s.cubes().empty()) m_queue.add_task(s.clone(), id);
         }
         if (!cube.empty()) {
             s.assert_cube(cube.get(0).cube());
@@ -544,8 +693,9 @@ private:
         // simplify
         s.inc_depth(1);
         if (canceled(s)) return;
+        import_units(s);
         switch (s.simplify()) {
-        case l_undef: break;
+        case l_undef: export_units(s); break;
         case l_true:  report_sat(s, nullptr); return;
         case l_false: report_unsat(s); return;                
         }
@@ -611,8 +761,8 @@ private:
                 break;
 
             }
-            if (cubes.size() >= conquer_batch_size()) {
-                spawn_cubes(s, 10*width, cubes);
+            if (cubes.size() >= conquer_batch_size() || (!cubes.empty() && m_queue.is_idle())) {
+                spawn_cubes(s, 10*width, cubes, id);
                 first = false;
                 cubes.reset();
             }
@@ -636,7 +786,7 @@ private:
         }                
     }
 
-    void spawn_cubes(solver_state& s, unsigned width, vector<cube_var>& cubes) {
+    void spawn_cubes(solver_state& s, unsigned width, vector<cube_var>& cubes, unsigned id) {
         if (cubes.empty()) return;
         add_branches(cubes.size());
         s.set_cubes(cubes);        
@@ -646,7 +796,7 @@ private:
             s1 = s.clone();
         }
         s1->inc_width(width);
-        m_queue.add_task(s1);
+        m_queue.add_task(s1, id);
     }
 
     /*
@@ -698,10 +848,10 @@ private:
         return memory::above_high_watermark();
     }
 
-    void run_solver() {
+    void run_solver(unsigned id) {
         try {
-            while (solver_state* st = m_queue.get_task()) {
-                cube_and_conquer(*st);                
+            while (solver_state* st = m_queue.get_task(id)) {
+                cube_and_conquer(*st, id);                
                 collect_statistics(*st);
                 m_queue.task_done(st);
                 if (!st->m().inc()) m_queue.shutdown();
@@ -737,7 +887,7 @@ private:
         add_branches(1);
         vector<std::thread> threads;
         for (unsigned i = 0; i < m_num_threads; ++i) 
-            threads.push_back(std::thread([this]() { run_solver(); }));
+            threads.push_back(std::thread([this, i]() { run_solver(i); }));
         for (std::thread& t : threads) 
             t.join();
         m_queue.stats(m_stats);
@@ -796,7 +946,7 @@ public:
             throw default_exception("parallel tactic does not work with trace");
         solver* s = m_solver->translate(m, m_params);
         solver_state* st = alloc(solver_state, nullptr, s, m_params);
-        m_queue.add_task(st);
+        m_queue.add_task(st, 0);
         expr_ref_vector clauses(m);
         ptr_vector<expr> assumptions;
         obj_map<expr, expr*> bool2dep;
@@ -807,6 +957,7 @@ public:
         for (expr * clause : clauses) {
             s->assert_expr(clause);
         }
+        init_shared_units(clauses);
         st->set_assumptions(assumptions);
         model_ref mdl;
         lbool is_sat = solve(mdl);
@@ -856,6 +1007,8 @@ public:
         m_params.copy(p);
         parallel_params pp(p);
         m_conquer_delay = pp.conquer_delay();
+        m_share_units = pp.share_units();
+        m_share_lemmas = pp.share_lemmas();
     }
 
     void collect_statistics(statistics & st) const override {
@@ -863,6 +1016,8 @@ public:
         st.update("par unsat", m_num_unsat);
         st.update("par models", m_models.size());
         st.update("par progress", m_progress);
+        st.update("par steals", m_queue.num_steals());
+        st.update("par shared units", m_units.size());
     }
 
     void reset_statistics() override {
@@ -18,6 +18,8 @@ Revision History:
 --*/
 #pragma once
 
+class statistics;
+
 class progress_callback {
 public:
     virtual ~progress_callback() = default;
@@ -27,5 +29,16 @@ public:
 
     // Less frequent invoked.
     virtual void slow_progress_sample() {}
+
+    // Interval in milliseconds between telemetry samples, 0 disables them.
+    virtual unsigned telemetry_interval() const { return 0; }
+
+    // Invoked from the searching thread every telemetry_interval() milliseconds
+    // with a snapshot of the search statistics. Search resumes when it returns.
+    virtual void telemetry_sample(statistics const& st) {}
+
+    // Invoked after each round of consequence finding with the number of
+    // fixed, unfixed and remaining candidate variables.
+    virtual void consequence_progress(unsigned num_fixed, unsigned num_unfixed, unsigned num_remaining) {}
 };
 
@@ -116,6 +116,7 @@ class simplifier_solver : public solver {
     expr_ref_vector             m_assumptions;
     model_converter_ref         m_mc;
     bool                        m_inconsistent = false;
+    bool                        m_mc_dirty = true;     // the reconstruction trail changed since m_mc was built
     expr_safe_replace           m_core_replace;
 
     void replace(expr_ref_vector& r) {
@@ -135,6 +136,7 @@ class simplifier_solver : public solver {
             m_core_replace.insert(assumptions.get(i), orig_assumptions.get(i));                    
 
         if (qhead < m_fmls.size()) {
+            m_mc_dirty = true;
             m_preprocess.reduce();
             if (!m.inc())
                 return;
@@ -143,8 +145,11 @@ class simplifier_solver : public solver {
             m_preprocess_state.advance_qhead();
         }
 
-        m_mc = m_preprocess_state.model_trail().get_model_converter(); 
-        m_cached_mc = nullptr;
+        if (m_mc_dirty) {
+            m_mc = m_preprocess_state.model_trail().get_model_converter(); 
+            m_cached_mc = nullptr;
+            m_mc_dirty = false;
+        }
         for (; qhead < m_fmls.size(); ++qhead)
             add_with_dependency(m_fmls[qhead]);
     }
@@ -220,6 +225,7 @@ public:
         m_cached_model = nullptr;
         m_preprocess.pop(n);
         m_preprocess_state.pop(n);
+        m_mc_dirty = true;
     }
 
     lbool check_sat_core(unsigned num_assumptions, expr* const* assumptions) override { 
@@ -232,6 +238,7 @@ public:
     void collect_statistics(statistics& st) const override { 
         s->collect_statistics(st); 
         m_preprocess.collect_statistics(st);
+        m_preprocess_state.m_reconstruction_trail.collect_statistics(st);
     }
 
     model_ref m_cached_model;
@@ -390,6 +397,7 @@ public:
     void user_propagate_register_expr(expr* e) override { m_preprocess_state.freeze(e);  s->user_propagate_register_expr(e); }
     void user_propagate_register_created(user_propagator::created_eh_t& r) override { s->user_propagate_register_created(r); }
     void user_propagate_register_decide(user_propagator::decide_eh_t& r) override { s->user_propagate_register_decide(r); }
+    void user_propagate_register_batch(user_propagator::batch_eh_t& r) override { s->user_propagate_register_batch(r); }
     void user_propagate_initialize_value(expr* var, expr* value) override { m_preprocess_state.freeze(var); s->user_propagate_initialize_value(var, value); }
 
 
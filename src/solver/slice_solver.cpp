@@ -418,6 +418,7 @@ public:
     void user_propagate_register_expr(expr* e) override { s->user_propagate_register_expr(e); }
     void user_propagate_register_created(user_propagator::created_eh_t& r) override { s->user_propagate_register_created(r); }
     void user_propagate_register_decide(user_propagator::decide_eh_t& r) override { s->user_propagate_register_decide(r); }
+    void user_propagate_register_batch(user_propagator::batch_eh_t& r) override { s->user_propagate_register_batch(r); }
     void user_propagate_initialize_value(expr* var, expr* value) override { s->user_propagate_initialize_value(var, value); }    
 };
 
@@ -101,6 +101,14 @@ lbool solver::get_consequences(expr_ref_vector const& asms, expr_ref_vector cons
     }
 }
 
+//
+// Candidates are checked in chunks: the negation of the chunk is asserted as
+// a disjunction. An unsatisfiable check fixes every literal of the chunk with
+// the same core; a model rules out every candidate it falsifies, and at least
+// one literal of the chunk. The chunk grows after unsatisfiable checks and
+// shrinks after satisfiable checks. Chunks of one Boolean variable are checked
+// using an assumption, so that incremental solvers need not push a scope.
+//
 lbool solver::get_consequences_core(expr_ref_vector const& asms, expr_ref_vector const& vars, expr_ref_vector& consequences) {
     ast_manager& m = asms.get_manager();
     lbool is_sat = check_sat(asms);
@@ -109,71 +117,91 @@ lbool solver::get_consequences_core(expr_ref_vector const& asms, expr_ref_vector
     }
     model_ref model;
     get_model(model);
-    expr_ref tmp(m), nlit(m), lit(m), val(m);
-    expr_ref_vector asms1(asms);
-    model_evaluator eval(*model.get());
-    unsigned k = 0;
-    for (unsigned i = 0; i < vars.size(); ++i) {
-        expr_ref_vector core(m);
-        tmp = vars[i];
-        val = eval(tmp);
+    expr_ref tmp(m), val(m);
+    expr_ref_vector lits(m), asms1(asms), core(m);
+    // lits[i] is satisfied by every model found so far.
+    for (expr* v : vars) {
+        tmp = v;
+        val = (*model)(tmp);
         if (!m.is_value(val)) {
-            // vars[i] is unfixed
+            // v is unfixed
             continue;
         }
         if (m.is_bool(tmp) && is_uninterp_const(tmp)) {
-            if (m.is_true(val)) {
-                nlit = m.mk_not(tmp);
-                lit = tmp;
-            }
-            else if (m.is_false(val)) {
-                nlit = tmp;
-                lit = m.mk_not(tmp);
-            }
-            else {
-                // vars[i] is unfixed
-                continue;
-            }
+            if (m.is_true(val))
+                lits.push_back(tmp);
+            else if (m.is_false(val))
+                lits.push_back(m.mk_not(tmp));
+        }
+        else {
+            lits.push_back(m.mk_eq(tmp, val));
+        }
+    }
+
+    auto filter = [&]() {
+        get_model(model);
+        unsigned j = 0;
+        for (expr* lit : lits) 
+            if (!model->is_false(lit))
+                lits[j++] = lit;
+        lits.shrink(j);
+    };
+
+    unsigned max_chunk = std::max(1u, solver_params(m_params).consequences_chunk());
+    unsigned chunk = 1;
+    unsigned num_fixed = 0;
+    while (!lits.empty()) {
+        chunk = std::min(chunk, lits.size());
+        unsigned start = lits.size() - chunk;
+        expr_ref lit(lits.get(start), m);
+        expr* v = nullptr;
+        core.reset();
+        if (chunk == 1 && (is_uninterp_const(lit) || (m.is_not(lit, v) && is_uninterp_const(v)))) {
+            expr_ref nlit(mk_not(m, lit), m);
             scoped_assumption_push _scoped_push(asms1, nlit);
             is_sat = check_sat(asms1);
-            switch (is_sat) {
-            case l_undef: 
-                return is_sat;
-            case l_true:
-                // vars[i] is unfixed
-                break;
-            case l_false:
+            if (is_sat == l_false) {
                 get_unsat_core(core);
-                k = 0;
-                for (unsigned j = 0; j < core.size(); ++j) {
-                    if (core[j].get() != nlit) {
-                        core[k] = core[j].get();
-                        ++k;
-                    }
-                }
-                core.resize(k);
-                consequences.push_back(m.mk_implies(mk_and(core), lit));
-                break;
+                unsigned k = 0;
+                for (expr* c : core)
+                    if (c != nlit)
+                        core[k++] = c;
+                core.shrink(k);
             }
+            else if (is_sat == l_true)
+                filter();
         }
         else {
-            lit = m.mk_eq(tmp, val);
-            nlit = m.mk_not(lit);
+            expr_ref_vector nlits(m);
+            for (unsigned i = start; i < lits.size(); ++i)
+                nlits.push_back(mk_not(m, lits.get(i)));
             scoped_push _scoped_push(*this);
-            assert_expr(nlit);
-            is_sat = check_sat(asms);            
-            switch (is_sat) {
-            case l_undef: 
-                return is_sat;
-            case l_true:
-                // vars[i] is unfixed
-                break;
-            case l_false:
+            assert_expr(mk_or(nlits));
+            is_sat = check_sat(asms);
+            if (is_sat == l_false)
                 get_unsat_core(core);
-                consequences.push_back(m.mk_implies(mk_and(core), lit));
-                break;
-            }            
+            else if (is_sat == l_true)
+                filter();
+        }
+        switch (is_sat) {
+        case l_undef:
+            return is_sat;
+        case l_true:
+            // a chunk of one literal is unfixed even if the model leaves it open.
+            if (chunk == 1 && !lits.empty() && lits.back() == lit)
+                lits.pop_back();
+            chunk = std::max(1u, chunk / 2);
+            break;
+        case l_false:
+            tmp = mk_and(core);
+            for (unsigned i = start; i < lits.size(); ++i)
+                consequences.push_back(m.mk_implies(tmp, lits.get(i)));
+            num_fixed += lits.size() - start;
+            lits.shrink(start);
+            chunk = std::min(2 * chunk, max_chunk);
+            break;
         }
+        IF_VERBOSE(10, verbose_stream() << "(get-consequences fixed: " << num_fixed << " remaining: " << lits.size() << " chunk: " << chunk << ")\n";);
     }
     return l_true;
 }
@@ -274,6 +274,12 @@ public:
     expr_ref_vector get_non_units();
 
     virtual expr_ref_vector get_trail(unsigned max_level) = 0; // { return expr_ref_vector(get_manager()); }
+
+    /**
+       \brief add learned clauses with at most max_size literals, and equalities between
+       terms that hold without decisions, to lemmas. They are implied by the assertions.
+    */
+    virtual void get_lemmas(unsigned max_size, expr_ref_vector& lemmas) {}
     
     virtual void get_levels(ptr_vector<expr> const& vars, unsigned_vector& depth) = 0;
 
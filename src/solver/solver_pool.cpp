@@ -24,6 +24,7 @@ Notes:
 
 class pool_solver : public solver_na2as {
     solver_pool&       m_pool;
+    unsigned           m_idx;
     app_ref            m_pred;
     proof_ref          m_proof;
     ref<solver>        m_base;
@@ -39,9 +40,10 @@ class pool_solver : public solver_na2as {
 
     bool is_virtual() const { return !m.is_true(m_pred); }
 public:
-    pool_solver(solver* b, solver_pool& pool, app_ref& pred):
+    pool_solver(solver* b, solver_pool& pool, unsigned idx, app_ref& pred):
         solver_na2as(pred.get_manager()),
         m_pool(pool),
+        m_idx(idx),
         m_pred(pred),
         m_proof(m),
         m_base(b),
@@ -68,6 +70,11 @@ public:
     }
 
     solver* base_solver() { return m_base.get(); }
+    unsigned pool_idx() const { return m_idx; }
+    unsigned num_internalized() const { return m_head; }
+    bool is_pushed() const { return m_pushed; }
+    // the pool holds the only reference
+    bool is_retired() const { return m_ref_count == 1; }
     void set_phase(expr* e) override { m_base->set_phase(e); }
     phase* get_phase() override { return m_base->get_phase(); }
     void set_phase(phase* p) override { m_base->set_phase(p); }
@@ -120,6 +127,7 @@ public:
             expr_ref f(m);
             f = m.mk_implies(m_pred, (m_assertions.get(m_head)));
             m_base->assert_expr(f);
+            m_pool.m_pools[m_idx].m_num_internalized++;
         }
     }
 
@@ -137,11 +145,14 @@ public:
         scoped_watch _t_(m_pool.m_check_watch);
         m_pool.m_stats.m_num_checks++;
 
+        if (!m_pushed)
+            m_pool.maybe_recycle(this);
         stopwatch sw;
         sw.start();
         internalize_assertions();
         lbool res = m_base->check_sat(num_assumptions, assumptions);
         sw.stop();
+        m_pool.record_check(m_idx, sw.get_seconds());
         switch (res) {
         case l_true:
             m_pool.m_check_sat_watch.add(sw);
@@ -171,11 +182,14 @@ public:
         scoped_watch _t_(m_pool.m_check_watch);
         m_pool.m_stats.m_num_checks++;
 
+        if (!m_pushed)
+            m_pool.maybe_recycle(this);
         stopwatch sw;
         sw.start();
         internalize_assertions();
         lbool res = m_base->check_sat_cc(cube, clauses);
         sw.stop();
+        m_pool.record_check(m_idx, sw.get_seconds());
         switch (res) {
         case l_true:
             m_pool.m_check_sat_watch.add(sw);
@@ -277,7 +291,7 @@ public:
         SASSERT(!m_pushed);
         m_head = 0;
         m_assertions.reset();
-        m_pool.refresh(m_base.get());
+        m_pool.refresh(m_idx);
     }
 
 private:
@@ -339,27 +353,23 @@ solver_pool::solver_pool(solver* base_solver, unsigned num_pools):
     m_current_pool(0)
 {
     SASSERT(num_pools > 0);
-}
-
-
-ptr_vector<solver> solver_pool::get_base_solvers() const {
-    ptr_vector<solver> solvers;
-    for (solver* s0 : m_solvers) {
-        pool_solver* s = dynamic_cast<pool_solver*>(s0);
-        if (!solvers.contains(s->base_solver())) {
-            solvers.push_back(s->base_solver());
-        }
-    }
-    return solvers;
+    m_bases.resize(num_pools);
+    m_pools.resize(num_pools);
 }
 
 void solver_pool::updt_params(const params_ref &p) {
     m_base_solver->updt_params(p);
     for (solver *s : m_solvers) s->updt_params(p);
 }
+
+void solver_pool::set_recycle(unsigned min_size, double retired, double latency) {
+    m_recycle_min = min_size;
+    m_recycle_retired = retired;
+    m_recycle_latency = latency;
+}
+
 void solver_pool::collect_statistics(statistics &st) const {
-    ptr_vector<solver> solvers = get_base_solvers();
-    for (solver* s : solvers) s->collect_statistics(st);
+    for (solver* s : m_bases) if (s) s->collect_statistics(st);
     st.update("time.pool_solver.smt.total", m_check_watch.get_seconds());
     st.update("time.pool_solver.smt.total.sat", m_check_sat_watch.get_seconds());
     st.update("time.pool_solver.smt.total.undef", m_check_undef_watch.get_seconds());
@@ -367,13 +377,14 @@ void solver_pool::collect_statistics(statistics &st) const {
     st.update("pool_solver.checks", m_stats.m_num_checks);
     st.update("pool_solver.checks.sat", m_stats.m_num_sat_checks);
     st.update("pool_solver.checks.undef", m_stats.m_num_undef_checks);
+    st.update("pool_solver.recycles", m_stats.m_num_recycles);
+    st.update("pool_solver.retired", m_stats.m_num_retired);
 }
 
 void solver_pool::reset_statistics() {
 #if 0
-    ptr_vector<solver> solvers = get_base_solvers();
-    for (solver* s : solvers) {
-        s->reset_statistics();
+    for (solver* s : m_bases) {
+        if (s) s->reset_statistics();
     }
 #endif
     m_stats.reset();
@@ -391,19 +402,14 @@ void solver_pool::reset_statistics() {
    among the first num_pools.
 */
 solver* solver_pool::mk_solver() {
-    ref<solver> base_solver;
     ast_manager& m = m_base_solver->get_manager();
-    if (m_solvers.size() < m_num_pools) {
-        base_solver = m_base_solver->translate(m, m_base_solver->get_params());
-    }
-    else {
-        solver* s = m_solvers[(m_current_pool++) % m_num_pools];
-        base_solver = dynamic_cast<pool_solver*>(s)->base_solver();
-    }
+    unsigned idx = (m_current_pool++) % m_num_pools;
+    if (!m_bases.get(idx)) 
+        m_bases.set(idx, m_base_solver->translate(m, m_base_solver->get_params()));
     std::stringstream name;
-    name << "vsolver#" << m_solvers.size();
+    name << "vsolver#" << m_current_pool - 1;
     app_ref pred(m.mk_const(symbol(name.str()), m.mk_bool_sort()), m);
-    pool_solver* solver = alloc(pool_solver, base_solver.get(), *this, pred);
+    pool_solver* solver = alloc(pool_solver, m_bases.get(idx), *this, idx, pred);
     m_solvers.push_back(solver);
     return solver;
 }
@@ -414,13 +420,75 @@ void solver_pool::reset_solver(solver* s) {
     if (ps) ps->reset();
 }
 
-void solver_pool::refresh(solver* base_solver) {
+void solver_pool::refresh(unsigned idx) {
     ast_manager& m = m_base_solver->get_manager();
     ref<solver> new_base = m_base_solver->translate(m, m_base_solver->get_params());
     for (solver* s0 : m_solvers) {
         pool_solver* s = dynamic_cast<pool_solver*>(s0);
-        if (base_solver == s->base_solver()) {
+        if (idx == s->pool_idx()) {
             s->refresh(new_base.get());
         }
     }
+    m_bases.set(idx, new_base.get());
+    m_pools[idx] = pool_info();
+}
+
+/**
+   \brief track the check time of a base solver.
+   The baseline is the average over the first checks after a refresh,
+   the latency is a moving average over the subsequent ones.
+*/
+void solver_pool::record_check(unsigned idx, double seconds) {
+    static const unsigned window = 16;
+    pool_info& p = m_pools[idx];
+    ++p.m_num_checks;
+    if (p.m_num_checks <= window) {
+        p.m_baseline += (seconds - p.m_baseline) / p.m_num_checks;
+        p.m_latency = p.m_baseline;
+    }
+    else 
+        p.m_latency += (seconds - p.m_latency) / window;
+}
+
+/**
+   \brief rebuild the base solver of pool idx when it is bloated by
+   assertions of retired members or its checks became slow.
+   Retired members are dropped, and the live members re-internalize
+   their assertions into a fresh base solver that they share.
+   This is only possible when no member has a pushed scope in the base solver.
+*/
+void solver_pool::maybe_recycle(pool_solver* self) {
+    unsigned idx = self->pool_idx();
+    pool_info const& p = m_pools[idx];
+    if (p.m_num_internalized < m_recycle_min)
+        return;
+    unsigned retired = 0;
+    for (solver* s0 : m_solvers) {
+        pool_solver* s = dynamic_cast<pool_solver*>(s0);
+        if (s->pool_idx() != idx)
+            continue;
+        if (s->is_pushed())
+            return;
+        if (s != self && s->is_retired())
+            retired += s->num_internalized();
+    }
+    bool bloated = retired > 0 && retired >= m_recycle_retired * p.m_num_internalized;
+    bool slow = m_recycle_latency > 0 && p.m_num_checks >= 32 &&
+        p.m_latency > m_recycle_latency * p.m_baseline;
+    if (!bloated && !slow)
+        return;
+    IF_VERBOSE(2, verbose_stream() << "(solver-pool :recycle " << idx
+               << " :internalized " << p.m_num_internalized
+               << " :retired " << retired << ")\n";);
+    unsigned j = 0;
+    for (unsigned i = 0; i < m_solvers.size(); ++i) {
+        pool_solver* s = dynamic_cast<pool_solver*>(m_solvers.get(i));
+        if (s != self && s->pool_idx() == idx && s->is_retired())
+            m_stats.m_num_retired++;
+        else
+            m_solvers.set(j++, s);
+    }
+    m_solvers.shrink(j);
+    m_stats.m_num_recycles++;
+    refresh(idx);
 }
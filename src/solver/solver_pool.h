@@ -37,24 +37,40 @@ class solver_pool {
         unsigned m_num_checks;
         unsigned m_num_sat_checks;
         unsigned m_num_undef_checks;
+        unsigned m_num_recycles;
+        unsigned m_num_retired;
         stats() { reset(); }
         void reset() { memset(this, 0, sizeof(*this)); }
     };
 
+    // state of a base solver shared by pool members since its last refresh
+    struct pool_info {
+        unsigned m_num_internalized = 0;
+        unsigned m_num_checks = 0;
+        double   m_baseline = 0;
+        double   m_latency = 0;
+    };
+
     ref<solver>         m_base_solver;
     unsigned            m_num_pools;
     unsigned            m_current_pool;
+    sref_vector<solver> m_bases;
+    vector<pool_info>   m_pools;
     sref_vector<solver> m_solvers;
     stats               m_stats;
 
+    unsigned m_recycle_min = UINT_MAX;
+    double   m_recycle_retired = 0.5;
+    double   m_recycle_latency = 0;
+
     stopwatch m_check_watch;
     stopwatch m_check_sat_watch;
     stopwatch m_check_undef_watch;
     stopwatch m_proof_watch;
 
-    void refresh(solver* s);
-
-    ptr_vector<solver> get_base_solvers() const;
+    void refresh(unsigned idx);
+    void record_check(unsigned idx, double seconds);
+    void maybe_recycle(pool_solver* self);
   
 public:
     solver_pool(solver* base_solver, unsigned num_pools);
@@ -67,6 +83,16 @@ public:
     void reset_solver(solver* s);
     void updt_params(const params_ref &p);
 
+    /**
+       \brief rebuild a base solver from the assertions of its live members
+       once at least min_size formulas were internalized in it and either
+       members that are no longer referenced outside the pool own
+       a fraction retired of them, or the average check time exceeds
+       latency times the average of the first checks after the last rebuild.
+       A latency of 0 disables the latency criterion.
+    */
+    void set_recycle(unsigned min_size, double retired, double latency);
+
 };
 
 
@@ -131,6 +131,10 @@ public:
         m_tactic->user_propagate_register_decide(decide_eh);
     }
 
+    void user_propagate_register_batch(user_propagator::batch_eh_t& batch_eh) override {
+        m_tactic->user_propagate_register_batch(batch_eh);
+    }
+
     void user_propagate_clear() override {
         if (m_tactic)
             m_tactic->user_propagate_clear();
@@ -317,6 +321,7 @@ void tactic2solver::get_unsat_core(expr_ref_vector & r) {
         if (!m_minimizing && smt_params_helper(get_params()).core_minimize()) {
             flet<bool> minimizing(m_minimizing, true);
             mus mus(*this);
+            mus.set_num_threads(smt_params_helper(get_params()).core_minimize_threads());
             mus.add_soft(r.size(), r.data());
             expr_ref_vector r2(m);
             if (l_true == mus.get_mus(r2)) {
@@ -40,6 +40,8 @@ separately from the conversions from Pseudo-Boolean constraints using different
 (apply (with card2bv :cardinality.encoding ordered))
 (apply (with card2bv :cardinality.encoding grouped))
 (apply (with card2bv :cardinality.encoding bimander))
+(apply (with card2bv :cardinality.encoding totalizer))
+(apply (with card2bv :cardinality.encoding auto))
 (pop)
 (assert ((_ pbge 5 2 3 4 4 3 5) a1 a2 a3 a4 a5 a6))
 (apply (with card2bv :pb.solver totalizer))
@@ -131,6 +131,7 @@ public:
         insert_max_steps(r);
         r.insert("blast_mul", CPK_BOOL, "bit-blast multipliers (and dividers, remainders).", "true");
         r.insert("blast_add", CPK_BOOL, "bit-blast adders.", "true");
+        r.insert("wallace_mul", CPK_BOOL, "bit-blast multipliers using a Wallace tree instead of an array of ripple adders.", "false");
         r.insert("blast_quant", CPK_BOOL, "bit-blast quantified variables.", "false");
         r.insert("blast_full", CPK_BOOL, "bit-blast any term with bit-vector sort, this option will make E-matching ineffective in any pattern containing bit-vector terms.", "false");
     }
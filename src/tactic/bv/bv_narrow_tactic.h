@@ -0,0 +1,67 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    bv_narrow_tactic.h
+
+Abstract:
+
+    Tactic for narrowing bit-vector operations using bounds
+
+Author:
+
+    Nikolaj Bjorner (nbjorner) 2024-04-03
+
+Tactic Documentation
+
+## Tactic bv-narrow
+
+### Short Description
+
+Narrows bit-vector arithmetic, bit-wise operations and comparisons
+whose arguments are provably small.
+
+### Long Description
+
+The tactic collects unit bounds, such as `(bvule x #x0000ffff)`, from the
+assertions and computes an upper bound on the number of significant bits
+of every bit-vector term. Additions, multiplications, bit-wise operations
+and comparisons whose arguments have fewer significant bits than their
+width are performed on the low bits only. This produces smaller circuits
+when the goal is bit-blasted.
+
+### Example
+
+```z3
+(declare-const x (_ BitVec 64))
+(declare-const y (_ BitVec 64))
+(declare-const z (_ BitVec 64))
+(assert (bvule x #x000000000000ffff))
+(assert (bvule y #x000000000000ffff))
+(assert (= z (bvadd x y)))
+(assert (bvult #x0000000000001000 (bvadd x y)))
+(apply bv-narrow)
+```
+
+--*/
+#pragma once
+
+#include "util/params.h"
+#include "tactic/tactic.h"
+#include "tactic/dependent_expr_state_tactic.h"
+#include "ast/simplifiers/bv_narrow.h"
+
+class ast_manager;
+class tactic;
+
+inline tactic* mk_bv_narrow_tactic(ast_manager& m, params_ref const& p = params_ref()) {
+    return alloc(dependent_expr_state_tactic, m, p,
+                 [](auto& m, auto& p, auto &s) -> dependent_expr_simplifier* { return alloc(bv::narrow, m, s); });
+}
+
+
+/*
+  ADD_TACTIC("bv-narrow", "narrow bit-vector operations on provably small arguments.", "mk_bv_narrow_tactic(m, p)")
+  ADD_SIMPLIFIER("bv-narrow", "narrow bit-vector operations on provably small arguments.", "alloc(bv::narrow, m, s)")
+*/
@@ -18,6 +18,8 @@ Notes:
 --*/
 #include "tactic/core/simplify_tactic.h"
 #include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/rewrite_cache.h"
+#include "params/rewriter_params.hpp"
 #include "ast/ast_pp.h"
 
 struct simplify_tactic::imp {
@@ -74,15 +76,27 @@ struct simplify_tactic::imp {
 simplify_tactic::simplify_tactic(ast_manager & m, params_ref const & p):
     m_params(p) {
     m_imp = alloc(imp, m, p);
+    init_cache();
 }
 
 simplify_tactic::~simplify_tactic() {
     dealloc(m_imp);
+    dealloc(m_cache);
+}
+
+void simplify_tactic::init_cache() {
+    unsigned sz = rewriter_params(m_params).shared_cache();
+    if (!m_cache || m_cache->max_size() != sz) {
+        dealloc(m_cache);
+        m_cache = sz == 0 ? nullptr : alloc(rewrite_cache, m_imp->m(), sz);
+    }
+    m_imp->m_r.set_shared_cache(m_cache);
 }
 
 void simplify_tactic::updt_params(params_ref const & p) {
     m_params.append(p);
     m_imp->m_r.updt_params(m_params);
+    init_cache();
 }
 
 void simplify_tactic::get_param_descrs(param_descrs & r) {
@@ -110,12 +124,15 @@ void simplify_tactic::cleanup() {
     params_ref p = std::move(m_params);
     m_imp->~imp();
     new (m_imp) imp(m, p);
+    m_imp->m_r.set_shared_cache(m_cache);
     m_clean = true;
 }
 
 void simplify_tactic::collect_statistics(statistics& st) const {
     if (m_imp)
         m_imp->collect_statistics(st);
+    if (m_cache)
+        m_cache->collect_statistics(st);
 }
 
 unsigned simplify_tactic::get_num_steps() const {
@@ -68,11 +68,16 @@ There are several options to control its behavior.
 #include "tactic/tactic.h"
 #include "tactic/tactical.h"
 
+class rewrite_cache;
+
 class simplify_tactic : public tactic {
     bool       m_clean = true;
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    rewrite_cache * m_cache = nullptr; // rewriting results kept across goals (rewriter.shared_cache)
+
+    void init_cache();
 public:
     simplify_tactic(ast_manager & m, params_ref const & ref = params_ref());
     ~simplify_tactic() override;
@@ -0,0 +1,566 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    symmetry_break_tactic.cpp
+
+Abstract:
+
+    Detect symmetries of clauses and pseudo-Boolean constraints and
+    add lex-leader symmetry breaking predicates.
+
+    The goal is represented as a vertex colored graph in the style of
+    Shatter and BreakID: one vertex per literal, connected to the
+    vertex of its complement, one vertex per clause and one vertex per
+    pseudo-Boolean constraint, colored by kind and bound. Coefficients
+    other than 1 are represented by intermediate vertices colored by
+    the coefficient. Automorphisms of the graph map literals to literals
+    and preserve the set of constraints.
+
+    Generators of the automorphism group are searched for as in saucy
+    and bliss: the coloring is refined to an equitable partition,
+    and for each non-singleton cell along the first path of the search
+    tree, the first vertex is individualized on the left and each other
+    vertex of the cell on the right. The two colorings are refined in
+    lock step and the search backtracks when their cell sizes differ.
+    When both colorings are discrete, the induced permutation is checked
+    to be an automorphism. Colors are 64-bit hashes of the color and the
+    multiset of neighbor colors; a hash collision can only make the
+    search miss symmetries since every candidate is checked.
+
+    For each generator sigma the predicate x <=_lex sigma(x) is added
+    using the variable order of the goal, with the compact encoding:
+
+        e_{i-1} & x_i  => sigma(x_i)
+        e_{i-1} & x_i  => e_i
+        e_{i-1} & ~sigma(x_i) => e_i
+
+    where e_0 = true and e_i holds when the first i variables agree.
+    The predicates of all generators use the same order, so together
+    they preserve the lexicographically least model of each orbit.
+
+Author:
+
+    Nikolaj Bjorner (nbjorner) 2024-04-10
+
+--*/
+#include "ast/ast_pp.h"
+#include "ast/for_each_expr.h"
+#include "ast/pb_decl_plugin.h"
+#include "ast/converters/generic_model_converter.h"
+#include "util/map.h"
+#include "tactic/tactical.h"
+#include "tactic/core/symmetry_break_tactic.h"
+
+class symmetry_break_tactic : public tactic {
+
+    struct stats {
+        unsigned m_num_generators = 0;
+        unsigned m_num_clauses = 0;
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    struct imp {
+        typedef svector<uint64_t> coloring;
+        typedef hashtable<uint64_t, u64_hash, u64_eq> edge_set;
+
+        ast_manager&            m;
+        pb_util                 pb;
+        stats&                  m_stats;
+        unsigned                m_max_steps = 10000000;
+        unsigned                m_max_length = 100;
+        unsigned                m_steps = 0;
+        obj_map<expr, unsigned> m_var2id;
+        ptr_vector<app>         m_vars;
+        vector<unsigned_vector> m_adj;
+        coloring                m_color;
+        edge_set                m_edges;
+        unsigned                m_num_edges = 0;
+        unsigned_vector         m_orbit;
+        vector<unsigned_vector> m_generators;
+
+        imp(ast_manager& m, params_ref const& p, stats& st): m(m), pb(m), m_stats(st) {
+            updt_params(p);
+        }
+
+        void updt_params(params_ref const& p) {
+            m_max_steps  = p.get_uint("max_steps", 10000000);
+            m_max_length = p.get_uint("max_length", 100);
+        }
+
+        static uint64_t scramble(uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        }
+
+        static uint64_t mk_color(uint64_t tag, uint64_t a = 0, uint64_t b = 0) {
+            return scramble(scramble(scramble(tag) + a) + b);
+        }
+
+        bool budget_exhausted() const { return m_steps >= m_max_steps; }
+
+        // ----------------------------------------------------------------
+        // graph construction
+
+        bool is_lit(expr* e, expr*& v, bool& sign) const {
+            sign = m.is_not(e, e);
+            v = e;
+            return is_uninterp_const(e) && m.is_bool(e);
+        }
+
+        unsigned mk_var(expr* e) {
+            unsigned id;
+            if (m_var2id.find(e, id))
+                return id;
+            id = m_vars.size();
+            m_var2id.insert(e, id);
+            m_vars.push_back(to_app(e));
+            return id;
+        }
+
+        unsigned lit2vertex(expr* e) {
+            expr* v;
+            bool sign;
+            VERIFY(is_lit(e, v, sign));
+            return 2 * m_var2id[v] + sign;
+        }
+
+        expr* vertex2lit(unsigned v) {
+            expr* x = m_vars[v / 2];
+            return (v & 1) ? m.mk_not(x) : x;
+        }
+
+        bool is_clause(expr* f) const {
+            expr* v;
+            bool sign;
+            if (is_lit(f, v, sign))
+                return true;
+            if (!m.is_or(f))
+                return false;
+            for (expr* arg : *to_app(f))
+                if (!is_lit(arg, v, sign))
+                    return false;
+            return true;
+        }
+
+        bool is_pb(expr* f) const {
+            expr* v;
+            bool sign;
+            if (!pb.is_at_most_k(f) && !pb.is_at_least_k(f) && !pb.is_le(f) && !pb.is_ge(f) && !pb.is_eq(f))
+                return false;
+            for (expr* arg : *to_app(f))
+                if (!is_lit(arg, v, sign))
+                    return false;
+            return true;
+        }
+
+        unsigned mk_vertex(uint64_t color) {
+            m_adj.push_back(unsigned_vector());
+            m_color.push_back(color);
+            return m_adj.size() - 1;
+        }
+
+        void add_edge(unsigned u, unsigned v) {
+            uint64_t key = u < v ? (static_cast<uint64_t>(u) << 32) | v : (static_cast<uint64_t>(v) << 32) | u;
+            if (m_edges.contains(key))
+                return;
+            m_edges.insert(key);
+            m_adj[u].push_back(v);
+            m_adj[v].push_back(u);
+            ++m_num_edges;
+        }
+
+        void add_clause(expr* f) {
+            unsigned c = mk_vertex(mk_color(2));
+            if (m.is_or(f))
+                for (expr* arg : *to_app(f))
+                    add_edge(c, lit2vertex(arg));
+            else
+                add_edge(c, lit2vertex(f));
+        }
+
+        void add_pb(app* f) {
+            bool has_coeffs = pb.is_le(f) || pb.is_ge(f) || pb.is_eq(f);
+            unsigned c = mk_vertex(mk_color(3, f->get_decl_kind(), pb.get_k(f).hash()));
+            // repeated literals are merged by adding their coefficients.
+            u_map<rational> coeffs;
+            unsigned_vector lits;
+            for (unsigned i = 0; i < f->get_num_args(); ++i) {
+                unsigned l = lit2vertex(f->get_arg(i));
+                rational k = has_coeffs ? pb.get_coeff(f, i) : rational::one();
+                auto* e = coeffs.find_core(l);
+                if (e)
+                    e->get_data().m_value += k;
+                else {
+                    coeffs.insert(l, k);
+                    lits.push_back(l);
+                }
+            }
+            for (unsigned l : lits) {
+                rational const& k = coeffs.find(l);
+                if (k.is_one())
+                    add_edge(c, l);
+                else {
+                    unsigned w = mk_vertex(mk_color(4, k.hash()));
+                    add_edge(c, w);
+                    add_edge(w, l);
+                }
+            }
+        }
+
+        /**
+           \brief build the graph of the goal. Return false if there is nothing to break.
+        */
+        bool mk_graph(goal const& g) {
+            expr_fast_mark1 frozen;
+            unsigned num_constraints = 0;
+            for (unsigned i = 0; i < g.size(); ++i) {
+                expr* f = g.form(i);
+                if (is_clause(f) || is_pb(f)) {
+                    ++num_constraints;
+                    continue;
+                }
+                // variables of other formulas are not moved by symmetries.
+                for (expr* e : subterms::all(expr_ref(f, m)))
+                    if (is_uninterp_const(e) && m.is_bool(e))
+                        frozen.mark(e);
+            }
+            if (num_constraints == 0)
+                return false;
+            for (unsigned i = 0; i < g.size(); ++i) {
+                expr* f = g.form(i), * v;
+                bool sign;
+                if (is_lit(f, v, sign))
+                    mk_var(v);
+                else if (is_clause(f) || is_pb(f))
+                    for (expr* arg : *to_app(f))
+                        if (is_lit(arg, v, sign))
+                            mk_var(v);
+            }
+            for (unsigned i = 0; i < m_vars.size(); ++i) {
+                app* x = m_vars[i];
+                bool is_frozen = frozen.is_marked(x);
+                unsigned p = mk_vertex(is_frozen ? mk_color(5, i, 0) : mk_color(1));
+                unsigned n = mk_vertex(is_frozen ? mk_color(5, i, 1) : mk_color(1));
+                add_edge(p, n);
+            }
+            for (unsigned i = 0; i < g.size(); ++i) {
+                expr* f = g.form(i);
+                if (is_clause(f))
+                    add_clause(f);
+                else if (is_pb(f))
+                    add_pb(to_app(f));
+            }
+            return true;
+        }
+
+        // ----------------------------------------------------------------
+        // partition refinement
+
+        unsigned num_colors(coloring const& c) const {
+            coloring s(c);
+            std::sort(s.begin(), s.end());
+            return static_cast<unsigned>(std::unique(s.begin(), s.end()) - s.begin());
+        }
+
+        bool same_cells(coloring const& a, coloring const& b) const {
+            coloring sa(a), sb(b);
+            std::sort(sa.begin(), sa.end());
+            std::sort(sb.begin(), sb.end());
+            return sa == sb;
+        }
+
+        void refine_step(coloring const& c, coloring& r) {
+            unsigned n = c.size();
+            r.resize(n);
+            for (unsigned v = 0; v < n; ++v) {
+                uint64_t s = 0;
+                for (unsigned u : m_adj[v])
+                    s += scramble(c[u]);
+                r[v] = scramble(c[v] * 0x9e3779b97f4a7c15ull + s);
+            }
+            m_steps += n + 2 * m_num_edges;
+        }
+
+        /**
+           \brief refine l, and r in lock step if given, to an equitable partition.
+           Return false if the cells of l and r stop corresponding.
+        */
+        bool refine(coloring& l, coloring* r) {
+            coloring tmp;
+            unsigned k = num_colors(l);
+            while (!budget_exhausted()) {
+                refine_step(l, tmp);
+                l.swap(tmp);
+                if (r) {
+                    refine_step(*r, tmp);
+                    r->swap(tmp);
+                    if (!same_cells(l, *r))
+                        return false;
+                }
+                unsigned k2 = num_colors(l);
+                if (k2 == k)
+                    return true;
+                k = k2;
+            }
+            return false;
+        }
+
+        bool is_discrete(coloring const& c) const {
+            return num_colors(c) == c.size();
+        }
+
+        /**
+           \brief the color of the smallest non-singleton cell, ties broken by color.
+        */
+        uint64_t target_cell(coloring const& c) const {
+            coloring s(c);
+            std::sort(s.begin(), s.end());
+            uint64_t best = 0;
+            unsigned best_size = UINT_MAX;
+            for (unsigned i = 0, j; i < s.size(); i = j) {
+                for (j = i + 1; j < s.size() && s[j] == s[i]; ++j)
+                    ;
+                if (j - i > 1 && j - i < best_size) {
+                    best_size = j - i;
+                    best = s[i];
+                }
+            }
+            SASSERT(best_size != UINT_MAX);
+            return best;
+        }
+
+        static void individualize(coloring& c, unsigned v) {
+            c[v] = scramble(c[v] + 0x632be59bd9b4e019ull);
+        }
+
+        // ----------------------------------------------------------------
+        // search for automorphisms
+
+        bool mk_perm(coloring const& l, coloring const& r, unsigned_vector& perm) {
+            svector<std::pair<uint64_t, unsigned>> sl, sr;
+            for (unsigned v = 0; v < l.size(); ++v) {
+                sl.push_back({ l[v], v });
+                sr.push_back({ r[v], v });
+            }
+            std::sort(sl.begin(), sl.end());
+            std::sort(sr.begin(), sr.end());
+            perm.resize(l.size());
+            for (unsigned i = 0; i < sl.size(); ++i) {
+                if (sl[i].first != sr[i].first)
+                    return false;
+                perm[sl[i].second] = sr[i].second;
+            }
+            return true;
+        }
+
+        bool is_automorphism(unsigned_vector const& perm) {
+            m_steps += 2 * m_num_edges;
+            for (unsigned v = 0; v < m_adj.size(); ++v) {
+                for (unsigned u : m_adj[v]) {
+                    unsigned a = perm[v], b = perm[u];
+                    uint64_t key = a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+                    if (!m_edges.contains(key))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+           \brief search for an automorphism mapping the coloring l to r.
+        */
+        bool search(coloring const& l, coloring const& r, unsigned_vector& perm) {
+            tactic::checkpoint(m);
+            if (is_discrete(l))
+                return mk_perm(l, r, perm) && is_automorphism(perm);
+            uint64_t c = target_cell(l);
+            unsigned v = 0;
+            while (l[v] != c)
+                ++v;
+            for (unsigned w = 0; w < r.size() && !budget_exhausted(); ++w) {
+                if (r[w] != c)
+                    continue;
+                coloring l2(l), r2(r);
+                individualize(l2, v);
+                individualize(r2, w);
+                if (refine(l2, &r2) && search(l2, r2, perm))
+                    return true;
+            }
+            return false;
+        }
+
+        unsigned find(unsigned v) {
+            while (m_orbit[v] != v)
+                v = m_orbit[v] = m_orbit[m_orbit[v]];
+            return v;
+        }
+
+        void add_generator(unsigned_vector const& perm) {
+            for (unsigned v = 0; v < perm.size(); ++v) {
+                unsigned a = find(v), b = find(perm[v]);
+                if (a != b)
+                    m_orbit[a] = b;
+            }
+            m_generators.push_back(perm);
+            ++m_stats.m_num_generators;
+        }
+
+        void find_generators() {
+            coloring c(m_color);
+            if (!refine(c, nullptr))
+                return;
+            m_orbit.reset();
+            for (unsigned v = 0; v < c.size(); ++v)
+                m_orbit.push_back(v);
+            unsigned_vector perm;
+            while (!budget_exhausted() && !is_discrete(c)) {
+                uint64_t cell = target_cell(c);
+                unsigned v = 0;
+                while (c[v] != cell)
+                    ++v;
+                for (unsigned w = v + 1; w < c.size() && !budget_exhausted(); ++w) {
+                    if (c[w] != cell || find(v) == find(w))
+                        continue;
+                    coloring l(c), r(c);
+                    individualize(l, v);
+                    individualize(r, w);
+                    if (refine(l, &r) && search(l, r, perm))
+                        add_generator(perm);
+                }
+                individualize(c, v);
+                if (!refine(c, nullptr))
+                    return;
+            }
+        }
+
+        // ----------------------------------------------------------------
+        // lex-leader predicates
+
+        void assert_clause(goal& g, expr* a, expr* b, expr* c = nullptr) {
+            ptr_buffer<expr> lits;
+            for (expr* l : { a, b, c })
+                if (l)
+                    lits.push_back(l);
+            g.assert_expr(lits.size() == 1 ? lits[0] : m.mk_or(lits.size(), lits.data()));
+            ++m_stats.m_num_clauses;
+        }
+
+        /**
+           \brief add x <=_lex perm(x) restricted to the first m_max_length variables moved by perm.
+           not_prefix is the negation of e_{i-1}, it is null for e_0 = true.
+        */
+        void add_lex_leader(goal& g, unsigned_vector const& perm, generic_model_converter* mc) {
+            unsigned_vector support;
+            for (unsigned i = 0; i < m_vars.size() && support.size() < m_max_length; ++i)
+                if (perm[2 * i] != 2 * i)
+                    support.push_back(i);
+            expr_ref not_prefix(m), e(m), nx(m), y(m);
+            for (unsigned j = 0; j < support.size(); ++j) {
+                unsigned i = support[j];
+                nx = m.mk_not(m_vars[i]);
+                if (perm[2 * i] == 2 * i + 1) {
+                    // x <= ~x forces x to be false, and the prefixes differ afterwards.
+                    assert_clause(g, not_prefix, nx);
+                    break;
+                }
+                y = vertex2lit(perm[2 * i]);
+                assert_clause(g, not_prefix, nx, y);
+                if (j + 1 == support.size())
+                    break;
+                e = m.mk_fresh_const("sbp", m.mk_bool_sort());
+                if (mc)
+                    mc->hide(e);
+                assert_clause(g, not_prefix, nx, e);
+                assert_clause(g, not_prefix, y, e);
+                not_prefix = m.mk_not(e);
+            }
+        }
+
+        void operator()(goal_ref const& g, goal_ref_buffer& result) {
+            tactic_report report("symmetry-break", *g);
+            result.reset();
+            m_steps = 0;
+            bool has_deps = false;
+            for (unsigned i = 0; i < g->size(); ++i)
+                has_deps |= g->dep(i) != nullptr;
+            // predicates are not entailed and not tracked by dependencies.
+            if (g->proofs_enabled() || has_deps || g->inconsistent() || !mk_graph(*g)) {
+                result.push_back(g.get());
+                return;
+            }
+            find_generators();
+            IF_VERBOSE(10, verbose_stream() << "(symmetry-break :vertices " << m_adj.size() << " :edges " << m_num_edges
+                       << " :generators " << m_generators.size() << " :steps " << m_steps << ")\n");
+            if (!m_generators.empty()) {
+                generic_model_converter* mc = nullptr;
+                if (g->models_enabled()) {
+                    mc = alloc(generic_model_converter, m, "symmetry-break");
+                    g->add(mc);
+                }
+                for (auto const& perm : m_generators)
+                    add_lex_leader(*g.get(), perm, mc);
+            }
+            g->inc_depth();
+            result.push_back(g.get());
+        }
+    };
+
+    ast_manager& m;
+    params_ref   m_params;
+    stats        m_stats;
+    imp*         m_imp;
+
+public:
+    symmetry_break_tactic(ast_manager& m, params_ref const& p): m(m), m_params(p) {
+        m_imp = alloc(imp, m, p, m_stats);
+    }
+
+    tactic* translate(ast_manager& m) override {
+        return alloc(symmetry_break_tactic, m, m_params);
+    }
+
+    ~symmetry_break_tactic() override {
+        dealloc(m_imp);
+    }
+
+    char const* name() const override { return "symmetry-break"; }
+
+    void updt_params(params_ref const& p) override {
+        m_params.append(p);
+        m_imp->updt_params(m_params);
+    }
+
+    void collect_param_descrs(param_descrs& r) override {
+        r.insert("max_steps", CPK_UINT, "(default: 10000000) maximal number of vertex and edge visits used to search for symmetries.");
+        r.insert("max_length", CPK_UINT, "(default: 100) maximal number of variables in a lex-leader predicate.");
+    }
+
+    void operator()(goal_ref const& in, goal_ref_buffer& result) override {
+        (*m_imp)(in, result);
+    }
+
+    void cleanup() override {
+        imp* d = alloc(imp, m, m_params, m_stats);
+        std::swap(d, m_imp);
+        dealloc(d);
+    }
+
+    void collect_statistics(statistics& st) const override {
+        st.update("symmetry generators", m_stats.m_num_generators);
+        st.update("symmetry breaking clauses", m_stats.m_num_clauses);
+    }
+
+    void reset_statistics() override {
+        m_stats.reset();
+    }
+};
+
+tactic* mk_symmetry_break_tactic(ast_manager& m, params_ref const& p) {
+    return clean(alloc(symmetry_break_tactic, m, p));
+}
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    symmetry_break_tactic.h
+
+Abstract:
+
+    Add lex-leader symmetry breaking predicates to clauses and
+    pseudo-Boolean constraints.
+
+Author:
+
+    Nikolaj Bjorner (nbjorner) 2024-04-10
+
+Tactic Documentation:
+
+## Tactic symmetry-break
+
+### Short Description
+
+Detect symmetries of propositional and pseudo-Boolean constraints and break them.
+
+### Long Description
+
+The tactic builds a colored graph from the clauses and pseudo-Boolean
+constraints of the goal and searches for generators of its automorphism
+group using partition refinement. Each generator that permutes or negates
+variables contributes a lex-leader predicate, encoded as clauses over
+fresh auxiliary variables. The resulting goal is equi-satisfiable.
+
+Variables that occur in other formulas are kept fixed. The search is bounded
+by `max_steps`, and each predicate covers at most `max_length` variables.
+
+### Example
+
+```z3
+(declare-const a1 Bool)
+(declare-const a2 Bool)
+(declare-const b1 Bool)
+(declare-const b2 Bool)
+(assert (or a1 a2))
+(assert (or b1 b2))
+(assert ((_ at-most 1) a1 b1))
+(assert ((_ at-most 1) a2 b2))
+(apply symmetry-break)
+```
+
+### Notes
+
+* does not apply when proofs are enabled or formulas are tracked by dependencies.
+
+--*/
+#pragma once
+
+#include "util/params.h"
+class ast_manager;
+class tactic;
+
+tactic * mk_symmetry_break_tactic(ast_manager & m, params_ref const & p = params_ref());
+
+/*
+  ADD_TACTIC("symmetry-break", "add lex-leader predicates for symmetries of clauses and pseudo-Boolean constraints.", "mk_symmetry_break_tactic(m, p)")
+*/
+
@@ -130,7 +130,8 @@ void goal::push_back(expr * f, proof * pr, expr_dependency * d) {
         m().del(m_dependencies);
         m_inconsistent = true;
         m().push_back(m_forms, m().mk_false());
-        m().push_back(m_proofs, saved_pr);
+        if (proofs_enabled())
+            m().push_back(m_proofs, saved_pr);
         if (unsat_core_enabled())
             m().push_back(m_dependencies, saved_d);
     }
@@ -138,7 +139,8 @@ void goal::push_back(expr * f, proof * pr, expr_dependency * d) {
         SASSERT(!pr || m().get_fact(pr) == f);
         SASSERT(!m_inconsistent);
         m().push_back(m_forms, f);
-        m().push_back(m_proofs, pr);
+        if (proofs_enabled())
+            m().push_back(m_proofs, pr);
         if (unsat_core_enabled())
             m().push_back(m_dependencies, d);
     }
@@ -476,8 +478,9 @@ void goal::shrink(unsigned j) {
     unsigned sz = size();
     for (unsigned i = j; i < sz; i++)
         m().pop_back(m_forms);
-    for (unsigned i = j; i < sz; i++)
-        m().pop_back(m_proofs);
+    if (proofs_enabled())
+        for (unsigned i = j; i < sz; i++)
+            m().pop_back(m_proofs);
     if (unsat_core_enabled()) 
         for (unsigned i = j; i < sz; i++)
             m().pop_back(m_dependencies);
@@ -498,7 +501,8 @@ void goal::elim_true() {
             continue;
         }
         m().set(m_forms, j, f);
-        m().set(m_proofs, j, m().get(m_proofs, i));
+        if (proofs_enabled())
+            m().set(m_proofs, j, m().get(m_proofs, i));
         if (unsat_core_enabled())
             m().set(m_dependencies, j, m().get(m_dependencies, i));
         j++;
@@ -584,7 +588,8 @@ void goal::elim_redundancies() {
             continue;
         }
         m().set(m_forms, j, f);
-        m().set(m_proofs, j, pr(i));
+        if (proofs_enabled())
+            m().set(m_proofs, j, pr(i));
         if (unsat_core_enabled())
             m().set(m_dependencies, j, dep(i));
         j++;
@@ -621,7 +626,8 @@ goal * goal::translate(ast_translation & translator) const {
     unsigned sz = m().size(m_forms);
     for (unsigned i = 0; i < sz; i++) {
         res->m().push_back(res->m_forms, translator(m().get(m_forms, i)));
-        res->m().push_back(res->m_proofs, translator(m().get(m_proofs, i)));
+        if (res->proofs_enabled())
+            res->m().push_back(res->m_proofs, translator(m().get(m_proofs, i)));
         if (res->unsat_core_enabled())
             res->m().push_back(res->m_dependencies, dep_translator(m().get(m_dependencies, i)));
     }
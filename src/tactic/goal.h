@@ -56,6 +56,10 @@ protected:
     dependency_converter_ref m_dc;
     unsigned              m_ref_count;
     std::string           m_reason_unknown;
+    // The arrays are persistent: copies of a goal share them, and updates
+    // to a copy are recorded as differences to the shared array.
+    // Proofs are only stored when proofs are enabled, and dependencies
+    // only when unsat cores are enabled.
     expr_array            m_forms;
     expr_array            m_proofs;
     expr_dependency_array m_dependencies;
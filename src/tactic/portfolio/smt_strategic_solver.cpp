@@ -33,6 +33,7 @@ Notes:
 #include "tactic/smtlogics/qfidl_tactic.h"
 #include "tactic/smtlogics/nra_tactic.h"
 #include "tactic/portfolio/default_tactic.h"
+#include "tactic/portfolio/strategy_selector.h"
 #include "tactic/fd_solver/fd_solver.h"
 #include "tactic/fd_solver/smtfd_solver.h"
 #include "tactic/ufbv/ufbv_tactic.h"
@@ -179,6 +180,8 @@ public:
         }
         if (!t) {
             t = mk_tactic_for_logic(m, p, l);
+            if (tp.strategy_model()[0])
+                t = mk_strategy_selector_tactic(m, p, t.get());
         }
         return mk_combined_solver(mk_tactic2solver(m, t.get(), p, proofs_enabled, models_enabled, unsat_core_enabled, l),
                                   mk_solver_for_logic(m, p, l), 
@@ -0,0 +1,281 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    strategy_selector.cpp
+
+Abstract:
+
+    Select the tactic for a goal from its static features.
+
+--*/
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "ast/static_features.h"
+#include "cmd_context/cmd_context.h"
+#include "cmd_context/tactic_cmds.h"
+#include "parsers/smt2/smt2parser.h"
+#include "tactic/tactic.h"
+#include "tactic/tactical.h"
+#include "tactic/portfolio/default_tactic.h"
+#include "tactic/portfolio/strategy_selector.h"
+#include "params/tactic_params.hpp"
+
+namespace {
+
+    class strategy_model {
+        unsigned                 m_k = 1;
+        svector<symbol>          m_features;
+        vector<std::string>      m_strategies;
+        svector<unsigned>        m_labels;
+        vector<svector<double>>  m_points;
+        svector<double>          m_mean;
+        svector<double>          m_dev;
+
+        static double transform(double v) { return std::log1p(std::fabs(v)); }
+
+        [[noreturn]] static void error(std::string const& file, unsigned line, char const* msg) {
+            std::stringstream strm;
+            strm << file << ":" << line << ": " << msg;
+            throw default_exception(strm.str());
+        }
+
+        void normalize() {
+            unsigned nf = m_features.size();
+            m_mean.resize(nf, 0);
+            m_dev.resize(nf, 0);
+            if (m_points.empty())
+                return;
+            for (auto& pt : m_points)
+                for (unsigned i = 0; i < nf; ++i)
+                    m_mean[i] += pt[i];
+            for (unsigned i = 0; i < nf; ++i)
+                m_mean[i] /= m_points.size();
+            for (auto& pt : m_points)
+                for (unsigned i = 0; i < nf; ++i)
+                    m_dev[i] += (pt[i] - m_mean[i]) * (pt[i] - m_mean[i]);
+            for (unsigned i = 0; i < nf; ++i) {
+                m_dev[i] = std::sqrt(m_dev[i] / m_points.size());
+                if (m_dev[i] == 0)
+                    m_dev[i] = 1;
+            }
+            for (auto& pt : m_points)
+                for (unsigned i = 0; i < nf; ++i)
+                    pt[i] = (pt[i] - m_mean[i]) / m_dev[i];
+        }
+
+    public:
+
+        void load(std::string const& file) {
+            std::ifstream in(file);
+            if (!in)
+                throw default_exception("could not open strategy model " + file);
+            std::string line, kw;
+            unsigned lineno = 0;
+            while (std::getline(in, line)) {
+                ++lineno;
+                std::istringstream is(line);
+                if (!(is >> kw) || kw[0] == '#')
+                    continue;
+                if (kw == "k") {
+                    if (!(is >> m_k) || m_k == 0)
+                        error(file, lineno, "expected a positive number of neighbors");
+                }
+                else if (kw == "features") {
+                    std::string f;
+                    while (is >> f)
+                        m_features.push_back(symbol(f.c_str()));
+                }
+                else if (kw == "strategy") {
+                    unsigned id;
+                    if (!(is >> id))
+                        error(file, lineno, "expected strategy number");
+                    std::string s;
+                    std::getline(is, s);
+                    if (s.find_first_not_of(" \t") == std::string::npos)
+                        error(file, lineno, "expected tactic");
+                    m_strategies.reserve(id + 1);
+                    m_strategies[id] = s;
+                }
+                else if (kw == "point") {
+                    unsigned label;
+                    if (!(is >> label))
+                        error(file, lineno, "expected strategy number");
+                    svector<double> pt;
+                    double v;
+                    while (is >> v)
+                        pt.push_back(transform(v));
+                    if (pt.size() != m_features.size())
+                        error(file, lineno, "number of values does not match the number of features");
+                    m_labels.push_back(label);
+                    m_points.push_back(pt);
+                }
+                else
+                    error(file, lineno, "unexpected keyword");
+            }
+            for (unsigned l : m_labels)
+                if (l >= m_strategies.size() || m_strategies[l].empty())
+                    throw default_exception("strategy model " + file + " refers to an undefined strategy");
+            normalize();
+        }
+
+        unsigned num_strategies() const { return m_strategies.size(); }
+        std::string const& strategy(unsigned i) const { return m_strategies[i]; }
+
+        /**
+           \brief return the strategy voted by the k nearest points, or UINT_MAX
+           if the table is empty.
+        */
+        unsigned select(vector<std::pair<symbol, double>> const& features) const {
+            if (m_points.empty())
+                return UINT_MAX;
+            svector<double> x(m_features.size(), 0.0);
+            for (unsigned i = 0; i < m_features.size(); ++i) {
+                for (auto const& [n, v] : features) {
+                    if (n == m_features[i]) {
+                        x[i] = v;
+                        break;
+                    }
+                }
+                x[i] = (transform(x[i]) - m_mean[i]) / m_dev[i];
+            }
+            svector<std::pair<double, unsigned>> dist;
+            for (unsigned j = 0; j < m_points.size(); ++j) {
+                double d = 0;
+                for (unsigned i = 0; i < x.size(); ++i)
+                    d += (x[i] - m_points[j][i]) * (x[i] - m_points[j][i]);
+                dist.push_back({ std::sqrt(d), m_labels[j] });
+            }
+            unsigned k = std::min(m_k, dist.size());
+            std::partial_sort(dist.begin(), dist.begin() + k, dist.end());
+            svector<double> votes(m_strategies.size(), 0.0);
+            for (unsigned j = 0; j < k; ++j)
+                votes[dist[j].second] += 1.0 / (dist[j].first + 1e-6);
+            unsigned best = dist[0].second;
+            for (unsigned i = 0; i < votes.size(); ++i)
+                if (votes[i] > votes[best])
+                    best = i;
+            return best;
+        }
+    };
+
+    class strategy_selector_tactic : public tactic {
+        ast_manager&             m;
+        params_ref               m_params;
+        strategy_model           m_model;
+        bool                     m_loaded = false;
+        sref_vector<tactic>      m_tactics;
+        tactic_ref               m_default;
+        tactic_ref               m_last;
+        unsigned                 m_num_selected = 0;
+        unsigned                 m_num_default = 0;
+
+        tactic* mk_strategy(unsigned i) {
+            m_tactics.reserve(i + 1);
+            if (m_tactics.get(i))
+                return m_tactics.get(i);
+            cmd_context ctx(false, &m);
+            std::istringstream is(m_model.strategy(i));
+            char const* file_name = "";
+            sexpr_ref se = parse_sexpr(ctx, is, m_params, file_name);
+            if (!se)
+                throw default_exception("could not parse strategy " + m_model.strategy(i));
+            tactic* t = sexpr2tactic(ctx, se.get());
+            t->updt_params(m_params);
+            m_tactics.set(i, t);
+            return t;
+        }
+
+        tactic* mk_default() {
+            if (!m_default)
+                m_default = mk_default_tactic(m, m_params);
+            return m_default.get();
+        }
+
+    public:
+        strategy_selector_tactic(ast_manager& m, params_ref const& p, tactic* fallback):
+            m(m), m_params(p), m_default(fallback) {}
+
+        tactic * translate(ast_manager & m) override {
+            return alloc(strategy_selector_tactic, m, m_params, m_default ? m_default->translate(m) : nullptr);
+        }
+
+        char const* name() const override { return "strategy_selector"; }
+
+        void updt_params(params_ref const & p) override {
+            m_params.append(p);
+            for (tactic* t : m_tactics)
+                if (t)
+                    t->updt_params(m_params);
+            if (m_default)
+                m_default->updt_params(m_params);
+        }
+
+        void collect_param_descrs(param_descrs & r) override {
+            tactic_params::collect_param_descrs(r);
+        }
+
+        void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+            tactic_params tp(m_params);
+            expr_ref_vector fmls(m);
+            in->get_formulas(fmls);
+            static_features sf(m);
+            sf.collect(fmls.size(), fmls.data());
+            vector<std::pair<symbol, double>> features;
+            sf.get_features(features);
+            if (tp.strategy_selector_print_features()) {
+                verbose_stream() << "(features";
+                for (auto const& [n, v] : features)
+                    verbose_stream() << " " << n << " " << v;
+                verbose_stream() << ")\n";
+                result.push_back(in.get());
+                return;
+            }
+            std::string file = tp.strategy_model();
+            if (!m_loaded && !file.empty()) {
+                m_model.load(file);
+                m_loaded = true;
+            }
+            unsigned i = m_loaded ? m_model.select(features) : UINT_MAX;
+            if (i == UINT_MAX) {
+                ++m_num_default;
+                m_last = mk_default();
+            }
+            else {
+                ++m_num_selected;
+                IF_VERBOSE(2, verbose_stream() << "(strategy-selector :strategy " << i << " " << m_model.strategy(i) << ")\n");
+                m_last = mk_strategy(i);
+            }
+            (*m_last)(in, result);
+        }
+
+        void cleanup() override {
+            if (m_last)
+                m_last->cleanup();
+        }
+
+        void collect_statistics(statistics & st) const override {
+            if (m_last)
+                m_last->collect_statistics(st);
+            st.update("strategy selected", m_num_selected);
+            st.update("strategy default", m_num_default);
+        }
+
+        void reset_statistics() override {
+            for (tactic* t : m_tactics)
+                if (t)
+                    t->reset_statistics();
+            if (m_default)
+                m_default->reset_statistics();
+            m_num_selected = 0;
+            m_num_default = 0;
+        }
+    };
+}
+
+tactic * mk_strategy_selector_tactic(ast_manager & m, params_ref const & p, tactic * fallback) {
+    return alloc(strategy_selector_tactic, m, p, fallback);
+}
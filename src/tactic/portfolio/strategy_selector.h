@@ -0,0 +1,45 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    strategy_selector.h
+
+Abstract:
+
+    Select the tactic for a goal from its static features.
+
+    A strategy model is a k-nearest-neighbor table loaded from a text
+    file. It lists the features it uses, by the names printed by
+    static_features::display_primitive, the candidate strategies as
+    tactic s-expressions, and one labeled point per training benchmark:
+
+        # comment
+        k 3
+        features NUM_EXPRS NUM_ARITH_INEQS HAS_INT
+        strategy 0 (then simplify smt)
+        strategy 1 (then simplify solve-eqs bit-blast sat)
+        point 0 1200 35 1
+        point 1 800 0 0
+
+    Feature values are mapped to log(1 + |x|) and normalized by the mean
+    and deviation of the points. The selected strategy is the weighted
+    majority of the k nearest points. scripts/train_strategy_model.py
+    builds the table from benchmark runs.
+
+--*/
+#pragma once
+
+#include "util/params.h"
+class ast_manager;
+class tactic;
+
+/**
+   \brief create the selector. It applies fallback, or the default tactic if
+   fallback is null, when no model is given or the model has no points.
+*/
+tactic * mk_strategy_selector_tactic(ast_manager & m, params_ref const & p = params_ref(), tactic * fallback = nullptr);
+
+/*
+ADD_TACTIC("strategy-selector", "select a tactic for the goal from its static features using the model file tactic.strategy_model.", "mk_strategy_selector_tactic(m, p)")
+*/
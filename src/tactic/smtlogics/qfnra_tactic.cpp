@@ -24,6 +24,7 @@ Notes:
 #include "tactic/smtlogics/smt_tactic.h"
 
 #include "tactic/smtlogics/qflra_tactic.h"
+#include "nlsat/nlsat_params.hpp"
 
 
 tactic * mk_multilinear_ls_tactic(ast_manager & m, params_ref const & p, unsigned ls_time = 60) {
@@ -320,7 +321,38 @@ tactic * mk_qfnra_mixed_solver(ast_manager& m, params_ref const& p) {
            );
 }
 
+/**
+   \brief run nlsat under num_threads configurations in parallel and return the first answer.
+   The first configurations use the static variable orderings, the remaining
+   ones shuffle the variables with different seeds. par translates the goal and
+   the tactics to a fresh ast_manager per thread, so each nlsat instance owns
+   its polynomial and algebraic number managers.
+*/
+tactic * mk_qfnra_portfolio_solver(ast_manager& m, params_ref const& p, unsigned num_threads) {
+    static const unsigned orderings[] = { 0, 4, 3, 1, 5, 2 };
+    unsigned num_orderings = sizeof(orderings) / sizeof(orderings[0]);
+    ptr_vector<tactic> ts;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        params_ref p_i = p;
+        if (i < num_orderings) {
+            p_i.set_uint("variable_ordering_strategy", orderings[i]);
+        }
+        else {
+            p_i.set_uint("seed", i);
+            p_i.set_bool("shuffle_vars", true);
+        }
+        ts.push_back(mk_qfnra_nlsat_tactic(m, p_i));
+    }
+    return par(ts.size(), ts.data());
+}
+
 tactic * mk_qfnra_tactic(ast_manager & m, params_ref const& p) {
+    unsigned num_threads = nlsat_params(p).portfolio();
+    if (num_threads > 1) 
+        return and_then(mk_simplify_tactic(m, p), 
+                        mk_propagate_values_tactic(m, p),
+                        or_else(mk_qfnra_portfolio_solver(m, p, num_threads),
+                                mk_qfnra_mixed_solver(m, p)));
 
     return and_then(mk_simplify_tactic(m, p), 
                     mk_propagate_values_tactic(m, p),
@@ -38,6 +38,7 @@ Notes:
 #include "tactic/smtlogics/qfbv_tactic.h"
 #include "tactic/smtlogics/smt_tactic.h"
 #include "solver/tactic2solver.h"
+#include "smt/smt_solver.h"
 #include "tactic/bv/bv_bound_chk_tactic.h"
 #include "ackermannization/ackermannize_bv_tactic.h"
 ///////////////
@@ -49,7 +50,11 @@ public:
         , m_p(p)
         , m_use_sat(false)
         , m_inc_use_sat(false)
-    {}
+        , m_lazy(false)
+        , m_inc_lazy(true)
+    {
+        updt_params(p);
+    }
 
     char const* name() const override { return "qfufbv_ackr"; }
 
@@ -87,9 +92,12 @@ public:
     }
 
     void updt_params(params_ref const & _p) override {
-        qfufbv_tactic_params p(_p);
+        m_p.append(_p);
+        qfufbv_tactic_params p(m_p);
         m_use_sat = p.sat_backend();
         m_inc_use_sat = p.inc_sat_backend();
+        m_inc_lazy = p.inc_lazy();
+        m_lazy = !ackermannization_params(m_p).eager();
     }
 
     void collect_statistics(statistics & st) const override {
@@ -111,10 +119,19 @@ private:
     lackr_stats                          m_st;
     bool                                 m_use_sat;
     bool                                 m_inc_use_sat;
+    bool                                 m_lazy;
+    bool                                 m_inc_lazy;
 
     solver* setup_sat() {
         solver * sat = nullptr;
-        if (m_use_sat) {
+        if (m_lazy && m_inc_lazy) {
+            // lemmas are added between checks, so keep one solver and its learned clauses
+            if (m_use_sat)
+                sat = mk_inc_sat_solver(m_m, m_p);
+            else
+                sat = mk_smt_solver(m_m, m_p, symbol("QF_AUFBV"));
+        }
+        else if (m_use_sat) {
             if (m_inc_use_sat) {
                 sat = mk_inc_sat_solver(m_m, m_p);
             }
@@ -20,6 +20,7 @@ Notes:
 #include "tactic/tactic.h"
 #include "tactic/probe.h"
 #include "util/stopwatch.h"
+#include "util/event_trace.h"
 #include "model/model_v2_pp.h"
 
 
@@ -57,7 +58,8 @@ struct tactic_report::imp {
     }
 };
 
-tactic_report::tactic_report(char const * id, goal const & g) {
+tactic_report::tactic_report(char const * id, goal const & g): m_scope(id) {
+    EVENT_TRACE(tactic_start_k, reinterpret_cast<uintptr_t>(id), g.size());
     if (get_verbosity_level() >= TACTIC_VERBOSITY_LVL)
         m_imp = alloc(imp, id, g);
     else
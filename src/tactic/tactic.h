@@ -23,6 +23,7 @@ Notes:
 #include "util/params.h"
 #include "util/lbool.h"
 #include "util/statistics.h"
+#include "util/profile.h"
 #include "tactic/user_propagator_base.h"
 #include "tactic/goal.h"
 #include "tactic/tactic_exception.h"
@@ -106,6 +107,7 @@ typedef sref_buffer<tactic> tactic_ref_buffer;
 class tactic_report {
     struct imp;
     imp *  m_imp;
+    profile::scope m_scope;
 public:
     tactic_report(char const * id, goal const & g);
     ~tactic_report();
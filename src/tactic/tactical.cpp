@@ -19,12 +19,17 @@ Notes:
 #include "util/scoped_timer.h"
 #include "util/cancel_eh.h"
 #include "util/scoped_ptr_vector.h"
+#include "util/stopwatch.h"
+#include "util/mutex.h"
+#include "params/tactic_params.hpp"
 #include "tactic/tactical.h"
 #include "tactic/goal_proof_converter.h"
 #ifndef SINGLE_THREAD
 #include <thread>
 #endif
 #include <vector>
+#include <iomanip>
+#include <string>
 
 class binary_tactical : public tactic {
 protected:
@@ -35,8 +40,8 @@ protected:
 public:
 
     binary_tactical(tactic * t1, tactic * t2):
-        m_t1(t1),
-        m_t2(t2) {
+        m_t1(mk_profiled(t1)),
+        m_t2(mk_profiled(t2)) {
         SASSERT(m_t1);
         SASSERT(m_t2);
     }
@@ -218,6 +223,10 @@ public:
         m_t2->user_propagate_register_decide(decide_eh);
     }
 
+    void user_propagate_register_batch(user_propagator::batch_eh_t& batch_eh) override {
+        m_t2->user_propagate_register_batch(batch_eh);
+    }
+
     void user_propagate_initialize_value(expr* var, expr* value) override {
         m_t2->user_propagate_initialize_value(var, value);
     }
@@ -283,7 +292,7 @@ public:
     nary_tactical(unsigned num, tactic * const * ts) {
         for (unsigned i = 0; i < num; i++) {
             SASSERT(ts[i]);
-            m_ts.push_back(ts[i]);
+            m_ts.push_back(mk_profiled(ts[i]));
         }
     }
 
@@ -561,6 +570,10 @@ public:
                     ex_msg = z3_ex.what();
                 }
             }
+            // a cancelled branch releases its copies as soon as it unwinds
+            // instead of holding them until the slowest branch returns.
+            ts.set(i, nullptr);
+            in_copies.set(i, nullptr);
         };
 
         vector<std::thread> threads(sz);
@@ -784,6 +797,9 @@ public:
                         }
                     }                                                                                           
                 }
+                // release the copies of the branch; results are kept in goals_vect.
+                ts2.set(i, nullptr);
+                g_copies.set(i, nullptr);
             };
 
             if (m.has_trace_stream())
@@ -1012,7 +1028,7 @@ public:
 };
 
 tactic * repeat(tactic * t, unsigned max) {
-    return alloc(repeat_tactical, t, max);
+    return alloc(repeat_tactical, mk_profiled(t), max);
 }
 
 class fail_if_branching_tactical : public unary_tactical {
@@ -1301,3 +1317,172 @@ tactic * skip_if_failed(tactic * t) {
     return or_else(t, mk_skip_tactic());
 }
 
+
+/**
+   \brief Report nodes of tactic.profile.
+
+   Every invocation of a profiled tactic creates a node. Invocations
+   nested within it, on the same thread, become its children.
+   Outermost invocations are appended to a global list of roots.
+   Recording stops after max_profile_nodes nodes until the report is reset.
+*/
+namespace {
+
+    struct tactic_profile_node {
+        std::string                         m_name;
+        double                              m_seconds = 0;
+        unsigned long long                  m_mem_before = 0;
+        unsigned long long                  m_mem_after = 0;
+        unsigned long long                  m_max_mem = 0;
+        unsigned                            m_size_before = 0;
+        unsigned                            m_size_after = 0;
+        unsigned                            m_num_goals = 0;
+        bool                                m_failed = false;
+        scoped_ptr_vector<tactic_profile_node> m_children;
+        tactic_profile_node(char const* n): m_name(n) {}
+    };
+
+    const unsigned max_profile_nodes = 100000;
+
+    mutex                                   g_profile_mux;
+    scoped_ptr_vector<tactic_profile_node>  g_profile_roots;
+    atomic<unsigned>                        g_profile_nodes(0);
+    thread_local tactic_profile_node*       g_profile_current = nullptr;
+
+    double to_mb(unsigned long long sz) {
+        return static_cast<double>(sz) / static_cast<double>(1024*1024);
+    }
+
+    void display_node(std::ostream& out, tactic_profile_node const& n, unsigned indent) {
+        out << std::string(indent, ' ') << "(" << n.m_name
+            << std::fixed << std::setprecision(3)
+            << " :time " << n.m_seconds
+            << std::setprecision(2)
+            << " :memory-before " << to_mb(n.m_mem_before)
+            << " :memory-after " << to_mb(n.m_mem_after)
+            << " :max-memory " << to_mb(n.m_max_mem)
+            << std::defaultfloat
+            << " :size-before " << n.m_size_before;
+        if (n.m_failed)
+            out << " :failed";
+        else
+            out << " :size-after " << n.m_size_after << " :goals " << n.m_num_goals;
+        for (tactic_profile_node const* c : n.m_children) {
+            out << "\n";
+            display_node(out, *c, indent + 2);
+        }
+        out << ")";
+    }
+}
+
+/**
+   \brief Wrapper that records a report node per invocation of m_t
+   and accumulates the time and size reduction for the statistics
+   of the enclosing solver or apply command.
+*/
+class profile_tactical : public unary_tactical {
+    unsigned m_calls = 0;
+    double   m_seconds = 0;
+    double   m_max_mem = 0;
+public:
+    profile_tactical(tactic * t): unary_tactical(t) {}
+
+    char const* name() const override { return m_t->name(); }
+
+    void operator()(goal_ref const & in, goal_ref_buffer& result) override {
+        m_clean = false;
+        tactic_profile_node* parent = g_profile_current;
+        tactic_profile_node* n = nullptr;
+        if (g_profile_nodes < max_profile_nodes) {
+            ++g_profile_nodes;
+            n = alloc(tactic_profile_node, m_t->name());
+            n->m_mem_before = memory::get_allocation_size();
+            n->m_size_before = in->num_exprs();
+        }
+        g_profile_current = n ? n : parent;
+        stopwatch sw;
+        sw.start();
+        auto finish = [&](bool failed) {
+            sw.stop();
+            g_profile_current = parent;
+            ++m_calls;
+            m_seconds += sw.get_seconds();
+            m_max_mem = std::max(m_max_mem, to_mb(memory::get_max_used_memory()));
+            if (!n)
+                return;
+            n->m_seconds = sw.get_seconds();
+            n->m_mem_after = memory::get_allocation_size();
+            n->m_max_mem = memory::get_max_used_memory();
+            n->m_failed = failed;
+            n->m_num_goals = result.size();
+            for (goal* g : result)
+                n->m_size_after += g->num_exprs();
+            if (parent)
+                parent->m_children.push_back(n);
+            else {
+                lock_guard lock(g_profile_mux);
+                g_profile_roots.push_back(n);
+            }
+        };
+        try {
+            m_t->operator()(in, result);
+        }
+        catch (...) {
+            finish(true);
+            throw;
+        }
+        finish(false);
+    }
+
+    void collect_statistics(statistics & st) const override {
+        m_t->collect_statistics(st);
+        if (m_calls == 0)
+            return;
+        std::string prefix = std::string("profile tactic ") + m_t->name();
+        st.update(symbol((prefix + " time").c_str()).bare_str(), m_seconds);
+        st.update(symbol((prefix + " calls").c_str()).bare_str(), m_calls);
+        st.update(symbol((prefix + " max memory").c_str()).bare_str(), m_max_mem);
+    }
+
+    void reset_statistics() override {
+        m_t->reset_statistics();
+        m_calls = 0;
+        m_seconds = 0;
+        m_max_mem = 0;
+    }
+
+    tactic * translate(ast_manager & m) override {
+        return translate_core<profile_tactical>(m);
+    }
+};
+
+tactic * mk_profile_tactical(tactic * t) {
+    return alloc(profile_tactical, t);
+}
+
+tactic * mk_profiled(tactic * t) {
+    if (!t || dynamic_cast<profile_tactical*>(t))
+        return t;
+    tactic_params tp;
+    return tp.profile() ? mk_profile_tactical(t) : t;
+}
+
+void display_tactic_profile(std::ostream & out) {
+    lock_guard lock(g_profile_mux);
+    out << "(tactic-profile";
+    for (tactic_profile_node const* n : g_profile_roots) {
+        out << "\n";
+        display_node(out, *n, 2);
+    }
+    out << ")\n";
+}
+
+void reset_tactic_profile() {
+    lock_guard lock(g_profile_mux);
+    g_profile_roots.reset();
+    g_profile_nodes = 0;
+}
+
+void finalize_tactic_profile() {
+    reset_tactic_profile();
+}
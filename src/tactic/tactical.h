@@ -81,3 +81,21 @@ tactic * if_no_proofs(tactic * t);
 tactic * if_no_unsat_cores(tactic * t);
 tactic * if_no_models(tactic * t);
 
+
+/**
+   \brief Wrap t with instrumentation that records, per invocation, the
+   time, the memory before and after, the peak memory and the goal size
+   before and after. Invocations of profiled tactics nested in t become
+   children in the report tree.
+*/
+tactic * mk_profile_tactical(tactic * t);
+// Return mk_profile_tactical(t) if the parameter tactic.profile is set, and t otherwise.
+tactic * mk_profiled(tactic * t);
+
+void display_tactic_profile(std::ostream & out);
+void reset_tactic_profile();
+
+void finalize_tactic_profile();
+/*
+  ADD_FINALIZER('finalize_tactic_profile();')
+*/
@@ -107,8 +107,46 @@ static void test_mk_distinct() {
     
 }
 
+static void test_mk_term_dag() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_sort int_sort = Z3_mk_int_sort(ctx);
+    Z3_ast x = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "x"), int_sort);
+    Z3_ast one = Z3_mk_int64(ctx, 1, int_sort);
+    Z3_ast sum_args[2] = { x, one };
+    Z3_func_decl add = Z3_get_app_decl(ctx, Z3_to_app(ctx, Z3_mk_add(ctx, 2, sum_args)));
+    Z3_ast a = Z3_mk_add(ctx, 2, sum_args);
+    Z3_ast prod_args[2] = { a, a };
+    Z3_ast expected = Z3_mk_mul(ctx, 2, prod_args);
+    Z3_inc_ref(ctx, expected);
+    Z3_func_decl mul = Z3_get_app_decl(ctx, Z3_to_app(ctx, expected));
+
+    // (* (+ x 1) (+ x 1)) with the sum shared
+    Z3_func_decl decls[2] = { add, mul };
+    Z3_ast leaves[1] = { x };
+    Z3_sort sorts[1] = { int_sort };
+    unsigned code[] = { Z3_TERM_LEAF, 0, Z3_TERM_NUMERAL, 0, 1, 0, Z3_TERM_APP, 0, 2, Z3_TERM_REF, 2, Z3_TERM_APP, 1, 2 };
+    Z3_ast terms[3];
+    Z3_ast r = Z3_mk_term_dag(ctx, sizeof(code) / sizeof(code[0]), code, 2, decls, 1, leaves, 1, sorts, 3, terms);
+    ENSURE(Z3_get_error_code(ctx) == Z3_OK);
+    ENSURE(Z3_is_eq_ast(ctx, r, expected));
+    ENSURE(Z3_is_eq_ast(ctx, terms[0], x));
+    ENSURE(Z3_is_eq_ast(ctx, terms[2], a));
+
+    Z3_set_error_handler(ctx, my_cb);
+    cb_called = false;
+    unsigned bad[] = { Z3_TERM_LEAF, 0, Z3_TERM_LEAF, 0 };
+    r = Z3_mk_term_dag(ctx, 4, bad, 0, nullptr, 1, leaves, 0, nullptr, 0, nullptr);
+    ENSURE(cb_called);
+    VERIFY(!r);
+    Z3_dec_ref(ctx, expected);
+    Z3_del_config(cfg);
+    Z3_del_context(ctx);
+}
+
 void tst_api() {
     test_apps();
     test_bvneg();
     test_mk_distinct();
+    test_mk_term_dag();
 }
@@ -10,6 +10,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include "ast/rewriter/th_rewriter.h"
 #include "model/model.h"
 #include "parsers/smt2/smt2parser.h"
+#include "util/stopwatch.h"
 #include <iostream>
 
 static expr_ref parse_fml(ast_manager& m, char const* str) {
@@ -33,6 +34,47 @@ static expr_ref parse_fml(ast_manager& m, char const* str) {
 static char const* example1 = "(<= (+ (* 1.3 x y) (* 2.3 y y) (* (- 1.1 x x))) 2.2)";
 static char const* example2 = "(= (+ 4 3 (- (* 3 x x) (* 5 y)) y) 0)";
 
+// compare the hashed accumulation of large sums with the marking path.
+static void tst_large_sums(ast_manager& m, bool sort_sums) {
+    arith_util au(m);
+    params_ref p;
+    p.set_bool("sort_sums", sort_sums);
+    arith_rewriter small(m, p), large(m, p);
+    small.set_large_sum_threshold(UINT_MAX);
+    large.set_large_sum_threshold(2);
+    random_gen rand(sort_sums ? 1 : 2);
+    expr_ref_vector vars(m);
+    for (unsigned i = 0; i < 200; ++i)
+        vars.push_back(m.mk_const(symbol(i), au.mk_int()));
+    double t_small = 0, t_large = 0;
+    for (unsigned round = 0; round < 200; ++round) {
+        expr_ref_vector args(m);
+        unsigned n = 2 + rand(1000);
+        unsigned nv = 1 + rand(vars.size());
+        for (unsigned i = 0; i < n; ++i) {
+            unsigned k = rand(8);
+            expr* v = vars.get(rand(nv));
+            if (k == 0)
+                args.push_back(au.mk_int(rand(5)));
+            else if (k <= 2)
+                args.push_back(au.mk_mul(au.mk_int(static_cast<int>(rand(7)) - 3), v));
+            else
+                args.push_back(v);
+        }
+        expr_ref r1(m), r2(m);
+        stopwatch sw;
+        sw.start();
+        br_status st1 = small.mk_add_core(args.size(), args.data(), r1);
+        t_small += sw.get_current_seconds();
+        sw.reset();
+        sw.start();
+        br_status st2 = large.mk_add_core(args.size(), args.data(), r2);
+        t_large += sw.get_current_seconds();
+        ENSURE(st1 == st2);
+        ENSURE(st1 == BR_FAILED || r1 == r2);
+    }
+    std::cout << "large sums sort_sums: " << sort_sums << " marking: " << t_small << "s hashed: " << t_large << "s\n";
+}
 
 void tst_arith_rewriter() {
     ast_manager m;
@@ -56,4 +98,7 @@ void tst_arith_rewriter() {
     fml = parse_fml(m, example2);
     rw(fml);
     std::cout << mk_pp(fml, m) << "\n";
+
+    tst_large_sums(m, false);
+    tst_large_sums(m, true);
 }
@@ -235,6 +235,9 @@ void tst_bit_blaster() {
 
     tst_adder(m, blaster);
     tst_multiplier(m, blaster);
+    blaster.set_wallace_multiplier(true);
+    tst_multiplier(m, blaster);
+    blaster.set_wallace_multiplier(false);
     tst_le(m, 4);
     tst_eqs(m, 8);
     tst_sh(m, 4);
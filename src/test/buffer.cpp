@@ -17,6 +17,9 @@ Revision History:
 
 --*/
 #include "util/ptr_scoped_buffer.h"
+#include "util/buffer.h"
+#include "util/vector.h"
+#include "util/rational.h"
 
 typedef std::pair<int, int> point;
 
@@ -43,6 +46,41 @@ static void tst1() {
     b.push_back(alloc(point, 40, 40));
 }
 
+static void tst2() {
+    sbuffer<unsigned, 4> b;
+    for (unsigned i = 0; i < 10; ++i)
+        b.emplace_back(i);
+    ENSURE(b.size() == 10);
+    ENSURE(b.contains(7));
+    b.erase(7);
+    ENSURE(!b.contains(7) && b.size() == 9 && b[7] == 8);
+    b.reverse();
+    ENSURE(b[0] == 9 && b.back() == 0);
+    unsigned_vector v;
+    v.push_back(20);
+    v.push_back(21);
+    b.append(v);
+    ENSURE(b.size() == 11 && b.back() == 21);
+    sbuffer<unsigned, 4> c;
+    c = std::move(b);
+    ENSURE(b.empty() && c.size() == 11);
+    sbuffer<unsigned, 4> d;
+    d.push_back(1);
+    c = std::move(d);
+    ENSURE(c.size() == 1 && c[0] == 1 && d.empty());
+    c.reserve(100);
+    ENSURE(c.capacity() >= 100 && c[0] == 1);
+    c.fill(3);
+    ENSURE(c[0] == 3);
+    buffer<rational, true, 2> r;
+    for (unsigned i = 0; i < 5; ++i)
+        r.emplace_back(i);
+    buffer<rational, true, 2> r2(std::move(r));
+    r = std::move(r2);
+    ENSURE(r.size() == 5 && r[4] == rational(4));
+}
+
 void tst_buffer() {
     tst1();
+    tst2();
 }
@@ -0,0 +1,45 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    context_bench.cpp
+
+Abstract:
+
+    Measure the cost of creating and deleting API contexts.
+
+    test-z3 context_bench [contexts [with-tactic]]
+
+    With with-tactic set to 1, every context also looks up a tactic,
+    which forces the registration of the built-in tactics.
+
+--*/
+#include <iostream>
+#include "api/z3.h"
+#include "util/stopwatch.h"
+
+void tst_context_bench(char** argv, int argc, int& i) {
+    unsigned num_contexts = 1000;
+    bool with_tactic = false;
+    if (i + 1 < argc) num_contexts = atoi(argv[++i]);
+    if (i + 1 < argc) with_tactic = atoi(argv[++i]) != 0;
+
+    Z3_config cfg = Z3_mk_config();
+    stopwatch sw;
+    sw.start();
+    for (unsigned j = 0; j < num_contexts; ++j) {
+        Z3_context ctx = Z3_mk_context(cfg);
+        if (with_tactic) {
+            Z3_tactic t = Z3_mk_tactic(ctx, "simplify");
+            Z3_tactic_inc_ref(ctx, t);
+            Z3_tactic_dec_ref(ctx, t);
+        }
+        Z3_del_context(ctx);
+    }
+    sw.stop();
+    Z3_del_config(cfg);
+    double sec = sw.get_seconds();
+    std::cout << "contexts: " << num_contexts << " seconds: " << sec
+              << " usec/context: " << (num_contexts > 0 ? 1e6 * sec / num_contexts : 0) << "\n";
+}
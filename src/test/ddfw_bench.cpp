@@ -0,0 +1,62 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ddfw_bench.cpp
+
+Abstract:
+
+    Measure the flip rate of ddfw on random 3-SAT.
+
+    test-z3 ddfw_bench [vars [clauses-per-var [steps [seed]]]]
+
+--*/
+#include <iostream>
+#include "ast/sls/sat_ddfw.h"
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+
+void tst_ddfw_bench(char** argv, int argc, int& i) {
+    unsigned num_vars = 1000000, steps = 10000000, seed = 0;
+    double ratio = 4.2;
+    if (i + 1 < argc) num_vars = atoi(argv[++i]);
+    if (i + 1 < argc) ratio = atof(argv[++i]);
+    if (i + 1 < argc) steps = atoi(argv[++i]);
+    if (i + 1 < argc) seed = atoi(argv[++i]);
+
+    random_gen r(seed);
+    sat::ddfw ddfw;
+    ddfw.set_seed(seed);
+    ddfw.reserve_vars(num_vars);
+    unsigned num_clauses = static_cast<unsigned>(ratio * num_vars);
+    sat::literal lits[3];
+    for (unsigned j = 0; j < num_clauses; ++j) {
+        for (unsigned k = 0; k < 3; ++k) {
+            sat::bool_var v;
+            do 
+                v = (r() * 32768u + r()) % num_vars;
+            while ((k > 0 && lits[0].var() == v) || (k > 1 && lits[1].var() == v));
+            lits[k] = sat::literal(v, r() % 2 == 0);
+        }
+        ddfw.add(3, lits);
+    }
+
+    stopwatch sw;
+    sw.start();
+    ddfw.rlimit().push(steps);
+    lbool is_sat = ddfw.check(0, nullptr);
+    ddfw.rlimit().pop();
+    sw.stop();
+
+    statistics st;
+    ddfw.collect_statistics(st);
+    double flips = 0;
+    for (unsigned k = 0; k < st.size(); ++k)
+        if (std::string("sls-ddfw-flips") == st.get_key(k))
+            flips = st.is_uint(k) ? st.get_uint_value(k) : st.get_double_value(k);
+    double sec = sw.get_seconds();
+    std::cout << "vars: " << num_vars << " clauses: " << num_clauses << " result: " << is_sat
+              << " flips: " << flips << " seconds: " << sec
+              << " kflips/sec: " << (sec > 0 ? flips / (1000 * sec) : 0) << "\n";
+}
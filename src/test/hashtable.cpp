@@ -17,6 +17,63 @@ Author:
 Revision History:
 
 --*/
+#include <iostream>
+#include <unordered_set>
+#include <stdlib.h>
+#include "util/hashtable.h"
+#include "util/map.h"
+#include "util/stopwatch.h"
+
+// Compare tombstone and backward-shift deletion on insert/erase churn.
+// The hash sends many keys to the same home so that probe sequences are long.
+struct clustered_hash { unsigned operator()(unsigned x) const { return x & ~7u; } };
+
+template<bool BackShift>
+static void tst_churn(unsigned num_keys, unsigned num_rounds) {
+    typedef map<unsigned, unsigned, clustered_hash, u_eq, BackShift> umap;
+    umap m;
+    std::unordered_set<unsigned> ref;
+    unsigned seed = 17;
+    auto next = [&]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % (4 * num_keys); };
+    stopwatch sw;
+    sw.start();
+    unsigned found = 0;
+    for (unsigned r = 0; r < num_rounds; ++r) {
+        unsigned k = next();
+        if (ref.count(k)) {
+            m.erase(k);
+            ref.erase(k);
+        }
+        else if (ref.size() < num_keys) {
+            m.insert(k, k + 1);
+            ref.insert(k);
+        }
+        unsigned q = next();
+        unsigned v = 0;
+        bool in = m.find(q, v);
+        ENSURE(in == (ref.count(q) != 0));
+        ENSURE(!in || v == q + 1);
+        found += in;
+    }
+    sw.stop();
+    ENSURE(m.size() == ref.size());
+    unsigned n = 0;
+    for (auto const& kv : m) {
+        ENSURE(ref.count(kv.m_key));
+        ++n;
+    }
+    ENSURE(n == ref.size());
+    std::cout << (BackShift ? "backshift" : "tombstone") << " keys: " << num_keys << " rounds: " << num_rounds
+              << " hits: " << found << " time: " << sw.get_seconds() << "\n";
+}
+
+static void tst_backshift() {
+    for (unsigned num_keys : { 10u, 1000u, 50000u }) {
+        tst_churn<false>(num_keys, 400000);
+        tst_churn<true>(num_keys, 400000);
+    }
+}
+
 #ifdef _WINDOWS
 #include<iostream>
 #include<unordered_set>
@@ -225,6 +282,7 @@ void test_hashtable_operators() {
 }
 
 void tst_hashtable() {
+    tst_backshift();
     tst3();
     for (int i = 0; i < 100; i++) 
         tst2();
@@ -242,5 +300,6 @@ void tst_hashtable() {
 }
 #else
 void tst_hashtable() {
+    tst_backshift();
 }
 #endif
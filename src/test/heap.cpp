@@ -19,6 +19,8 @@ Revision History:
 #include<iostream>
 #include "util/util.h"
 #include "util/heap.h"
+#include "util/dary_heap.h"
+#include "util/stopwatch.h"
 #include "util/trace.h"
 #include "util/uint_set.h"
 // include "util/hashtable.h"
@@ -134,6 +136,96 @@ static void tst2() {
     ENSURE(h.check_invariant());
 }
 
+// run the same operations on a binary and a d-ary heap and compare the minima.
+template<unsigned D>
+static void tst3() {
+    int_heap2 h1(N);
+    dary_heap<lt_proc2, D> h2(N);
+    for (int i = 0; i < N * 10; i++) {
+        int cmd = heap_rand() % 10;
+        int val = heap_rand() % N;
+        if (cmd <= 3) {
+            if (!h1.contains(val)) {
+                h1.insert(val);
+                h2.insert(val);
+            }
+        }
+        else if (cmd <= 5) {
+            if (h1.contains(val)) {
+                h1.erase(val);
+                h2.erase(val);
+            }
+        }
+        else if (cmd <= 8) {
+            if (h1.contains(val)) {
+                int old_v = g_value[val];
+                g_value[val] = heap_rand();
+                if (old_v < g_value[val]) 
+                    h1.increased(val), h2.increased(val);
+                else 
+                    h1.decreased(val), h2.decreased(val);
+            }
+        }
+        else if (!h1.empty()) {
+            int m1 = h1.erase_min();
+            int m2 = h2.erase_min();
+            ENSURE(g_value[m1] == g_value[m2]);
+            if (m1 != m2) {
+                // equal priorities may leave the heaps in different orders.
+                h1.erase(m2);
+                h1.insert(m1);
+            }
+        }
+        ENSURE(h1.size() == h2.size());
+        ENSURE(h1.contains(val) == h2.contains(val));
+    }
+    ENSURE(h2.check_invariant());
+}
+
+// decision queue workload: bump the activity of a few variables and pop the most active one.
+struct act_lt { 
+    svector<double> const& m_act;
+    act_lt(svector<double> const& a): m_act(a) {}
+    bool operator()(int v1, int v2) const { return m_act[v1] > m_act[v2]; } 
+};
+
+template<typename Heap>
+static double bench_bumps(unsigned num_vars, unsigned rounds) {
+    random_gen r(0);
+    svector<double> act(num_vars, 0.0);
+    Heap h(num_vars, act_lt(act));
+    for (unsigned v = 0; v < num_vars; ++v)
+        h.insert(v);
+    stopwatch sw;
+    sw.start();
+    double inc = 1.0;
+    for (unsigned i = 0; i < rounds; ++i) {
+        for (unsigned j = 0; j < 20; ++j) {
+            unsigned v = r() % num_vars;
+            act[v] += inc;
+            if (h.contains(v))
+                h.decreased(v);
+        }
+        inc *= 1.05;
+        if (inc > 1e100) {
+            for (double& a : act) a *= 1e-100;
+            inc *= 1e-100;
+        }
+        int v = h.erase_min();
+        h.insert(v);
+    }
+    sw.stop();
+    return sw.get_seconds();
+}
+
+static void tst_bench() {
+    unsigned n = 1 << 16, rounds = 100000;
+    double t2 = bench_bumps<heap<act_lt>>(n, rounds);
+    double t4 = bench_bumps<dary_heap<act_lt, 4>>(n, rounds);
+    double t8 = bench_bumps<dary_heap<act_lt, 8>>(n, rounds);
+    IF_VERBOSE(0, verbose_stream() << "(heap-bench binary " << t2 << "s 4-ary " << t4 << "s 8-ary " << t8 << "s)\n");
+}
+
 void tst_heap() {
     // enable_debug("heap");
     enable_trace("heap");
@@ -144,5 +236,10 @@ void tst_heap() {
         tst1();
         init_values();
         tst2();
+        init_values();
+        tst3<4>();
+        init_values();
+        tst3<8>();
     }
+    tst_bench();
 }
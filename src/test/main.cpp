@@ -257,6 +257,8 @@ int main(int argc, char ** argv) {
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
     TST_ARGV(cnf_backbones);
+    TST_ARGV(ddfw_bench);
+    TST_ARGV(context_bench);
     TST(bdd);
     TST(pdd);
     TST(pdd_solver);
@@ -21,6 +21,33 @@ static void tst_ascii_roundtrip() {
     }
 }
 
+// Concatenations and sub-strings share buffers; check that
+// extending one string in place does not change the others.
+static void tst_shared_buffers() {
+    zstring a("abc");
+    zstring ab = a + zstring("d");
+    zstring ac = a + zstring("e");
+    ENSURE(ab == zstring("abcd"));
+    ENSURE(ac == zstring("abce"));
+    ENSURE(a == zstring("abc"));
+
+    zstring s;
+    for (unsigned i = 0; i < 1000; ++i)
+        s = s + zstring('a' + i % 26);
+    ENSURE(s.length() == 1000);
+    zstring mid = s.extract(26, 52);
+    ENSURE(mid.length() == 52);
+    ENSURE(mid[0] == 'a' && mid[51] == 'z');
+    ENSURE(mid.hash() == zstring(mid.encode()).hash());
+
+    // mixing characters above 255 into a narrow buffer.
+    zstring w = mid + zstring(0x3a9u);
+    ENSURE(w.length() == 53 && w[52] == 0x3a9 && w[0] == 'a');
+    ENSURE(w.extract(0, 52) == mid);
+    ENSURE(w.reverse()[0] == 0x3a9);
+}
+
 void tst_zstring() {
     tst_ascii_roundtrip();
+    tst_shared_buffers();
 }
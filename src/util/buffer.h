@@ -8,7 +8,9 @@ Module Name:
 
 Abstract:
 
-    <abstract>
+    Vectors with inline storage for the first INITIAL_SIZE elements.
+    They only allocate on the heap when they grow beyond that, which
+    makes them a good choice for short-lived temporaries.
 
 Author:
 
@@ -21,6 +23,7 @@ Revision History:
 --*/
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include "util/memory_manager.h"
 
@@ -39,8 +42,12 @@ protected:
     }
 
     void expand() {
+        expand(m_capacity << 1);
+    }
+
+    void expand(unsigned new_capacity) {
         static_assert(std::is_nothrow_move_constructible<T>::value);
-        unsigned new_capacity = m_capacity << 1;
+        SASSERT(new_capacity > m_capacity);
         T * new_buffer        = reinterpret_cast<T*>(memory::allocate(sizeof(T) * new_capacity));
         for (unsigned i = 0; i < m_pos; ++i) {
             new (&new_buffer[i]) T(std::move(m_buffer[i]));
@@ -169,6 +176,27 @@ public:
         m_pos++;
     }
     
+    template<typename... Args>
+    T & emplace_back(Args&&... args) {
+        if (m_pos >= m_capacity)
+            expand();
+        new (m_buffer + m_pos) T(std::forward<Args>(args)...);
+        return m_buffer[m_pos++];
+    }
+
+    void reserve(unsigned sz) {
+        if (sz > m_capacity) {
+            unsigned new_capacity = m_capacity;
+            while (new_capacity < sz)
+                new_capacity <<= 1;
+            expand(new_capacity);
+        }
+    }
+
+    unsigned capacity() const {
+        return m_capacity;
+    }
+
     void pop_back() {
         if (CallDestructors) {
             back().~T(); 
@@ -202,6 +230,37 @@ public:
         append(source.size(), source.data());
     }
 
+    template<typename Container>
+    void append(Container const& source) {
+        for (auto const& e : source)
+            push_back(e);
+    }
+
+    bool contains(T const & elem) const {
+        for (T const& e : *this)
+            if (e == elem)
+                return true;
+        return false;
+    }
+
+    void erase(T const & elem) {
+        iterator it = std::find(begin(), end(), elem);
+        if (it == end())
+            return;
+        for (iterator next = it + 1; next != end(); ++it, ++next)
+            *it = std::move(*next);
+        pop_back();
+    }
+
+    void reverse() {
+        std::reverse(begin(), end());
+    }
+
+    void fill(T const & elem) {
+        for (T& e : *this)
+            e = elem;
+    }
+
     T & operator[](unsigned idx) { 
         SASSERT(idx < size()); 
         return m_buffer[idx]; 
@@ -257,6 +316,27 @@ public:
         append(other);
         return *this;
     }
+
+    buffer & operator=(buffer && other) noexcept {
+        if (this == &other)
+            return *this;
+        if (other.m_buffer == reinterpret_cast<T*>(other.m_initial_buffer)) {
+            reset();
+            for (T& e : other)
+                push_back(std::move(e));
+            other.reset();
+        }
+        else {
+            destroy();
+            m_buffer         = other.m_buffer;
+            m_pos            = other.m_pos;
+            m_capacity       = other.m_capacity;
+            other.m_buffer   = reinterpret_cast<T*>(other.m_initial_buffer);
+            other.m_pos      = 0;
+            other.m_capacity = INITIAL_SIZE;
+        }
+        return *this;
+    }
 };
 
 // note that the append added is actually not an addition over its base class buffer,
@@ -51,8 +51,11 @@ public:
     static const unsigned default_init_cellar = 2;
 
 protected:
+    // each cell keeps the hash of its data, so that chains and rehashing
+    // compare and redistribute entries without touching the data itself.
     struct cell {
         cell *  m_next = (cell*)1;
+        unsigned m_hash = 0;
         T       m_data;
         bool is_free() const { return GET_TAG(m_next) == 1; }
         void mark_free() { m_next = TAG(cell*, m_next, 1); }
@@ -101,24 +104,27 @@ protected:
             if (!source_it->is_free()) {
                 cell * list_it = source_it;
                 do {
-                    unsigned h    = get_hash(list_it->m_data);
+                    unsigned h    = list_it->m_hash;
+                    SASSERT(h == get_hash(list_it->m_data));
                     unsigned idx  = h & target_mask;
                     cell * target_it = target + idx;
                     SASSERT(target_it >= target);
                     SASSERT(target_it < target + target_slots);
                     if (target_it->is_free()) {
                         target_it->m_data = list_it->m_data;
+                        target_it->m_hash = h;
                         target_it->m_next = nullptr;
                         used_slots++;
                     }
                     else {
-                        SASSERT((get_hash(target_it->m_data) & target_mask) == idx);
+                        SASSERT((target_it->m_hash & target_mask) == idx);
                         if (target_cellar == target_end)
                             return nullptr; // the cellar is too small...
                         SASSERT(target_cellar >= target + target_slots);
                         SASSERT(target_cellar < target_end);
                         *target_cellar    = *target_it;
                         target_it->m_data = list_it->m_data;
+                        target_it->m_hash = h;
                         target_it->m_next = target_cellar;
                         target_cellar++;
                     }
@@ -305,6 +311,7 @@ public:
         }
         c->m_next = new_c;
         c->m_data = d;
+        c->m_hash = h;
         CASSERT("chashtable_bug", check_invariant());
     }
     
@@ -319,6 +326,7 @@ public:
             m_size++;
             m_used_slots++;
             c->m_data = d;
+            c->m_hash = h;
             c->m_next = nullptr;
             CASSERT("chashtable_bug", check_invariant());
             return;
@@ -326,7 +334,7 @@ public:
         else {
             cell * it = c;
             do { 
-                if (equals(it->m_data, d)) {
+                if (it->m_hash == h && equals(it->m_data, d)) {
                     // already there
                     it->m_data = d;
                     CASSERT("chashtable_bug", check_invariant());
@@ -341,6 +349,7 @@ public:
             cell * new_c = get_free_cell();
             *new_c = *c;
             c->m_data    = d;
+            c->m_hash    = h;
             c->m_next    = new_c;
             CASSERT("chashtable_bug", check_invariant());
             return;
@@ -358,6 +367,7 @@ public:
             m_size++;
             m_used_slots++;
             c->m_data = d;
+            c->m_hash = h;
             c->m_next = nullptr;
             CASSERT("chashtable_bug", check_invariant());
             return c->m_data;
@@ -365,7 +375,7 @@ public:
         else {
             cell * it = c;
             do { 
-                if (equals(it->m_data, d)) {
+                if (it->m_hash == h && equals(it->m_data, d)) {
                     // already there
                     CASSERT("chashtable_bug", check_invariant());
                     return it->m_data;
@@ -379,6 +389,7 @@ public:
             cell * new_c = get_free_cell();
             *new_c = *c;
             c->m_data    = d;
+            c->m_hash    = h;
             c->m_next    = new_c;
             CASSERT("chashtable_bug", check_invariant());
             return c->m_data;
@@ -396,6 +407,7 @@ public:
             m_size++;
             m_used_slots++;
             c->m_data = d;
+            c->m_hash = h;
             c->m_next = nullptr;
             CASSERT("chashtable_bug", check_invariant());
             return true;
@@ -403,7 +415,7 @@ public:
         else {
             cell * it = c;
             do { 
-                if (equals(it->m_data, d)) {
+                if (it->m_hash == h && equals(it->m_data, d)) {
                     // already there
                     CASSERT("chashtable_bug", check_invariant());
                     return false;
@@ -417,6 +429,7 @@ public:
             cell * new_c = get_free_cell();
             *new_c = *c;
             c->m_data    = d;
+            c->m_hash    = h;
             c->m_next    = new_c;
             CASSERT("chashtable_bug", check_invariant());
             return true;
@@ -431,7 +444,7 @@ public:
         if (c->is_free())
             return false;
         do { 
-            if (equals(c->m_data, d)) {
+            if (c->m_hash == h && equals(c->m_data, d)) {
                 return true;
             }
             CHS_CODE(const_cast<chashtable*>(this)->m_collisions++;);
@@ -449,7 +462,7 @@ public:
         if (c->is_free())
             return nullptr;
         do { 
-            if (equals(c->m_data, d)) {
+            if (c->m_hash == h && equals(c->m_data, d)) {
                 return &(c->m_data);
             }
             CHS_CODE(const_cast<chashtable*>(this)->m_collisions++;);
@@ -467,7 +480,7 @@ public:
         if (c->is_free())
             return false;
         do { 
-            if (equals(c->m_data, d)) {
+            if (c->m_hash == h && equals(c->m_data, d)) {
                 r = c->m_data;
                 return true;
             }
@@ -487,7 +500,7 @@ public:
             return; 
         cell * prev = nullptr;
         do { 
-            if (equals(c->m_data, d)) {
+            if (c->m_hash == h && equals(c->m_data, d)) {
                 m_size--;
                 if (prev == nullptr) {
                     cell * next = c->m_next;
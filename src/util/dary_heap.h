@@ -0,0 +1,273 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    dary_heap.h
+
+Abstract:
+
+    A d-ary heap of integers with the interface of heap<LT>.
+
+    Children of a node are stored next to each other, so that a node is
+    compared with all its children on one or two cache lines, and the
+    tree has half (4-ary) or a third (8-ary) of the levels of a binary
+    heap. This shortens the sift-up performed for every activity bump in
+    the decision queues.
+
+    Values are stored from index 1 on, and index 0 holds a dummy, as in
+    heap<LT>, so that m_value2indices[v] == 0 means v is not in the heap.
+    The children of node i are d*(i-1)+2, ..., d*(i-1)+d+1.
+
+--*/
+#pragma once
+
+#include "util/vector.h"
+#include "util/debug.h"
+#include <algorithm>
+#include <cstring>
+
+template<typename LT, unsigned D = 4>
+class dary_heap : private LT {
+    static_assert(D >= 2, "a d-ary heap needs at least two children per node");
+
+    int_vector    m_values;
+    int_vector    m_value2indices;
+
+    static int first_child(int i) {
+        return D * (i - 1) + 2;
+    }
+
+    static int parent(int i) {
+        return i == 1 ? 0 : (i - 2) / static_cast<int>(D) + 1;
+    }
+
+    void display(std::ostream& out, unsigned indent, int idx) const {
+        if (idx < static_cast<int>(m_values.size())) {
+            for (unsigned i = 0; i < indent; ++i) out << " ";
+            out << m_values[idx] << "\n";
+            for (unsigned j = 0; j < D; ++j)
+                display(out, indent + 1, first_child(idx) + j);
+        }
+    }
+
+    bool is_valid_value(int v) const { 
+        SASSERT(v >= 0 && v < static_cast<int>(m_value2indices.size())); 
+        return true; 
+    }
+
+    void move_up(int idx) {
+        int val = m_values[idx];
+        while (true) {
+            int parent_idx = parent(idx);
+            if (parent_idx == 0 || !less_than(val, m_values[parent_idx])) {
+                break;
+            }
+            m_values[idx]                  = m_values[parent_idx];
+            m_value2indices[m_values[idx]] = idx;
+            idx                            = parent_idx;
+        }
+        m_values[idx]        = val;
+        m_value2indices[val] = idx;
+        CASSERT("heap", check_invariant());
+    }
+
+    void move_down(int idx) {
+        int val = m_values[idx];
+        int sz  = static_cast<int>(m_values.size());
+        while (true) {
+            int child_idx = first_child(idx);
+            if (child_idx >= sz) {
+                break;
+            }
+            int end     = std::min(child_idx + static_cast<int>(D), sz);
+            int min_idx = child_idx;
+            for (int j = child_idx + 1; j < end; ++j) 
+                if (less_than(m_values[j], m_values[min_idx]))
+                    min_idx = j;
+            int min_value = m_values[min_idx];
+            if (!less_than(min_value, val)) {
+                break;
+            }
+            m_values[idx]                  = min_value;
+            m_value2indices[min_value]     = idx;
+            idx                            = min_idx;
+        }
+        m_values[idx]        = val;
+        m_value2indices[val] = idx;
+        CASSERT("heap", check_invariant());
+    }
+
+public:
+    typedef int * iterator;
+    typedef const int * const_iterator;
+
+    dary_heap(int s, const LT & lt = LT()):LT(lt) {
+        m_values.push_back(-1);
+        set_bounds(s);
+        CASSERT("heap", check_invariant());
+    }
+
+    bool check_invariant() const {
+        if (m_values.empty() || m_values[0] != -1) 
+            return false;
+        for (int idx = 1; idx < static_cast<int>(m_values.size()); ++idx) {
+            if (m_value2indices[m_values[idx]] != idx)
+                return false;
+            if (parent(idx) != 0 && less_than(m_values[idx], m_values[parent(idx)]))
+                return false;
+        }
+        return true;
+    }
+
+    bool less_than(int v1, int v2) const { 
+        return LT::operator()(v1, v2); 
+    }
+
+    bool empty() const { 
+        return m_values.size() == 1; 
+    }
+
+    bool contains(int val) const { 
+        return val < static_cast<int>(m_value2indices.size()) && m_value2indices[val] != 0; 
+    }
+
+    void reset() {
+        if (empty()) {
+            return;
+        }
+        memset(m_value2indices.data(), 0, sizeof(int) * m_value2indices.size());
+        m_values.reset();
+        m_values.push_back(-1);
+        CASSERT("heap", check_invariant());
+    }
+
+    void clear() { 
+        reset(); 
+    }
+
+    void set_bounds(int s) { 
+        m_value2indices.resize(s, 0); 
+    }
+    
+    unsigned get_bounds() const {
+        return m_value2indices.size();
+    }
+
+    unsigned size() const {
+        return m_values.size() - 1;
+    }
+
+    void reserve(int s) {
+        if (s > static_cast<int>(m_value2indices.size()))
+            set_bounds(s);
+    }
+
+    int min_value() const {
+        SASSERT(!empty());
+        return m_values[1];
+    }
+
+    int erase_min() {
+        SASSERT(!empty());
+        int result                  = m_values[1];
+        int last_val                = m_values.back();
+        m_values.pop_back();
+        m_value2indices[result]     = 0;
+        if (!empty()) {
+            m_values[1]               = last_val;
+            m_value2indices[last_val] = 1;
+            move_down(1);
+        }
+        CASSERT("heap", check_invariant());
+        return result;
+    }
+
+    void erase(int val) {
+        SASSERT(contains(val));
+        int idx                   = m_value2indices[val];
+        int last_val              = m_values.back();
+        m_values.pop_back();
+        m_value2indices[val]      = 0;
+        if (idx < static_cast<int>(m_values.size())) {
+            m_values[idx]             = last_val;
+            m_value2indices[last_val] = idx;
+            int parent_idx            = parent(idx);
+            if (parent_idx != 0 && less_than(last_val, m_values[parent_idx])) 
+                move_up(idx);
+            else 
+                move_down(idx);
+        }
+        CASSERT("heap", check_invariant());
+    }
+
+    void decreased(int val) { 
+        SASSERT(contains(val)); 
+        move_up(m_value2indices[val]); 
+    }
+
+    void increased(int val) { 
+        SASSERT(contains(val)); 
+        move_down(m_value2indices[val]); 
+    }
+
+    void insert(int val) {
+        CASSERT("heap", !contains(val));
+        SASSERT(is_valid_value(val));
+        int idx              = static_cast<int>(m_values.size());
+        m_value2indices[val] = idx;
+        m_values.push_back(val);
+        move_up(idx);
+    }
+
+    iterator begin() { 
+        return m_values.data() + 1; 
+    }
+
+    iterator end() { 
+        return m_values.data() + m_values.size(); 
+    }
+
+    const_iterator begin() const { 
+        return m_values.begin() + 1; 
+    }
+
+    const_iterator end() const { 
+        return m_values.end(); 
+    }
+
+    void swap(dary_heap & other) noexcept {
+        if (this != &other) {
+            m_values.swap(other.m_values);
+            m_value2indices.swap(other.m_value2indices);
+        }
+    }
+
+    /**
+       \brief return set of values in heap that are less or equal to val.
+     */
+    void find_le(int val, int_vector& result) {
+        int_vector todo;
+        todo.push_back(1);
+        while (!todo.empty()) {
+            int index = todo.back();
+            todo.pop_back();
+            if (index < static_cast<int>(m_values.size()) &&
+                !less_than(val, m_values[index])) {
+                result.push_back(m_values[index]);
+                for (unsigned j = 0; j < D; ++j)
+                    todo.push_back(first_child(index) + j);
+            }
+        }
+    }
+
+    void display(std::ostream& out) const {
+        display(out, 0, 1);
+    }
+};
+
+template<typename LT>
+using quaternary_heap = dary_heap<LT, 4>;
+
+template<typename LT>
+using octonary_heap = dary_heap<LT, 8>;
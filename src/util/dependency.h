@@ -47,7 +47,8 @@ public:
         value const& leaf_value() const { SASSERT(is_leaf()); return static_cast<leaf const*>(this)->m_value; }
     };
 
-    static void linearize_todo(ptr_vector<dependency>& todo, vector<value, false>& vs) {
+    template<typename Values>
+    static void linearize_todo(ptr_vector<dependency>& todo, Values& vs) {
         unsigned qhead = 0;
         while (qhead < todo.size()) {
             dependency* d = todo[qhead];
@@ -224,7 +225,12 @@ public:
 
 
 
-    void linearize(dependency * d, vector<value, false> & vs) const {
+    /**
+       \brief append the leaves of d to vs.
+       Values is any vector-like container, e.g. vector<value, false> or sbuffer<value>.
+    */
+    template<typename Values>
+    void linearize(dependency * d, Values & vs) const {
         if (!d) 
             return;
         SASSERT(m_todo.empty());
@@ -329,7 +335,8 @@ public:
         return m_dep_manager.contains(d, v); 
     }
 
-    void linearize(dependency * d, vector<value, false> & vs) const {
+    template<typename Values>
+    void linearize(dependency * d, Values & vs) const {
         return m_dep_manager.linearize(d, vs);
     }    
 
@@ -428,7 +435,8 @@ public:
         return m_dep_manager.contains(d, v);
     }
 
-    void linearize(dependency* d, vector<value, false>& vs) {
+    template<typename Values>
+    void linearize(dependency* d, Values& vs) {
         return m_dep_manager.linearize(d, vs);
     }
 
@@ -21,6 +21,9 @@ Notes:
 #include "util/gparams.h"
 #include "util/util.h"
 #include "util/memory_manager.h"
+#include "util/event_trace.h"
+#include "util/profile.h"
+#include "util/perf_counters.h"
 
 void env_params::updt_params() {
     params_ref const& p = gparams::get_ref();
@@ -32,6 +35,9 @@ void env_params::updt_params() {
     unsigned mb = p.get_uint("memory_high_watermark_mb", 0);
     if (mb > 0)
         memory::set_high_watermark(megabytes_to_bytes(mb));    
+    event_trace::enable(p.get_bool("event_trace", false));
+    profile::enable(p.get_bool("profile", false));
+    perf_counters::enable(p.get_bool("perf_counters", false));
 }
 
 void env_params::collect_param_descrs(param_descrs & d) {
@@ -41,4 +47,8 @@ void env_params::collect_param_descrs(param_descrs & d) {
     d.insert("memory_max_alloc_count", CPK_UINT, "set hard upper limit for memory allocations, if 0 then there is no limit", "0");
     d.insert("memory_high_watermark", CPK_UINT, "set high watermark for memory consumption (in bytes), if 0 then there is no limit", "0");
     d.insert("memory_high_watermark_mb", CPK_UINT, "set high watermark for memory consumption (in megabytes), if 0 then there is no limit", "0");
+    d.insert("profile", CPK_BOOL, "record the time spent in tactics, simplifiers, propagation, final checks and garbage collection, reported as 'profile' statistics", "false");
+    d.insert("profile_file", CPK_STRING, "write the profile as folded stacks, the input format of flame graph tools, to this file on exit", "");
+    d.insert("perf_counters", CPK_BOOL, "count cycles, instructions, cache misses and branch misses in BCP, propagation, rewriting and simplex pivots, reported as 'perf' statistics (Linux only)", "false");
+    d.insert("event_trace", CPK_BOOL, "record conflicts, restarts, tactic starts, quantifier instantiation rounds and final checks in per-thread ring buffers that are printed on timeout or interrupt", "false");
 }
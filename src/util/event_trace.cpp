@@ -0,0 +1,114 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    event_trace.cpp
+
+Abstract:
+
+    Per-thread ring buffers for release-build event tracing.
+
+--*/
+#include <chrono>
+#include "util/event_trace.h"
+#include "util/mutex.h"
+#include "util/vector.h"
+
+namespace event_trace {
+
+    std::atomic<bool> g_enabled(false);
+
+    static const unsigned RING_SIZE = 4096;   // power of two
+
+    struct ring {
+        event                 m_events[RING_SIZE];
+        std::atomic<uint64_t> m_head { 0 };
+        uint32_t              m_thread;
+        ring(uint32_t t): m_thread(t) {}
+    };
+
+    static DECLARE_INIT_MUTEX(g_rings_mux);
+    static ptr_vector<ring>* g_rings = nullptr;
+    static std::chrono::steady_clock::time_point g_start;
+    static std::atomic<unsigned> g_generation(0);
+    static thread_local ring* t_ring = nullptr;
+    static thread_local unsigned t_generation = 0;
+
+    void enable(bool f) {
+        if (f && !enabled())
+            g_start = std::chrono::steady_clock::now();
+        g_enabled.store(f, std::memory_order_relaxed);
+    }
+
+    static ring* mk_ring() {
+        lock_guard lock(*g_rings_mux);
+        if (!g_rings)
+            g_rings = alloc(ptr_vector<ring>);
+        ring* r = alloc(ring, g_rings->size());
+        g_rings->push_back(r);
+        return r;
+    }
+
+    void record(kind k, uint64_t arg1, uint64_t arg2) {
+        ring* r = t_ring;
+        unsigned gen = g_generation.load(std::memory_order_relaxed);
+        if (!r || t_generation != gen) {
+            t_ring = r = mk_ring();
+            t_generation = gen;
+        }
+        uint64_t head = r->m_head.load(std::memory_order_relaxed);
+        event& e = r->m_events[head & (RING_SIZE - 1)];
+        e.m_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_start).count();
+        e.m_kind = k;
+        e.m_thread = r->m_thread;
+        e.m_arg1 = arg1;
+        e.m_arg2 = arg2;
+        r->m_head.store(head + 1, std::memory_order_release);
+    }
+
+    char const* kind_name(kind k) {
+        switch (k) {
+        case conflict_k: return "conflict";
+        case restart_k: return "restart";
+        case tactic_start_k: return "tactic-start";
+        case qi_round_k: return "qi-round";
+        case final_check_k: return "final-check";
+        default: return "unknown";
+        }
+    }
+
+    static void display(std::ostream& out, event const& e) {
+        out << "(event " << e.m_time << " :thread " << e.m_thread << " :kind " << kind_name(static_cast<kind>(e.m_kind));
+        if (e.m_kind == tactic_start_k)
+            out << " :tactic " << reinterpret_cast<char const*>(static_cast<uintptr_t>(e.m_arg1)) << " :size " << e.m_arg2;
+        else
+            out << " " << e.m_arg1 << " " << e.m_arg2;
+        out << ")\n";
+    }
+
+    void dump(std::ostream& out) {
+        lock_guard lock(*g_rings_mux);
+        if (!g_rings)
+            return;
+        for (ring* r : *g_rings) {
+            uint64_t head = r->m_head.load(std::memory_order_acquire);
+            uint64_t begin = head > RING_SIZE ? head - RING_SIZE : 0;
+            for (uint64_t i = begin; i < head; ++i)
+                display(out, r->m_events[i & (RING_SIZE - 1)]);
+        }
+        out.flush();
+    }
+};
+
+void finalize_event_trace() {
+    event_trace::g_enabled.store(false, std::memory_order_relaxed);
+    // rings cached by threads from before the finalization are replaced on their next event.
+    event_trace::g_generation.fetch_add(1, std::memory_order_relaxed);
+    if (event_trace::g_rings) {
+        for (auto* r : *event_trace::g_rings)
+            dealloc(r);
+        dealloc(event_trace::g_rings);
+        event_trace::g_rings = nullptr;
+    }
+}
@@ -0,0 +1,69 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    event_trace.h
+
+Abstract:
+
+    Lightweight event tracing that is available in release builds.
+
+    Unlike TRACE, which is compiled out unless Z3DEBUG or _TRACE is set,
+    tracepoints are always compiled in and guarded by a runtime flag
+    (parameter event_trace). When the flag is off, a tracepoint costs a
+    relaxed load and a branch. When it is on, each thread writes
+    fixed-size binary events into its own ring buffer that keeps the
+    most recent events. The buffers are not locked on the write path,
+    and dump() prints them, for example from a timeout or
+    interrupt handler.
+
+--*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace event_trace {
+
+    enum kind : uint32_t {
+        conflict_k,        // arg1: number of conflicts, arg2: conflict level
+        restart_k,         // arg1: number of restarts, arg2: number of conflicts
+        tactic_start_k,    // arg1: tactic name (static string), arg2: goal size
+        qi_round_k,        // arg1: number of new instances, arg2: scope level
+        final_check_k,     // arg1: theory family id, arg2: final check result
+        num_kinds
+    };
+
+    struct event {
+        uint64_t m_time;   // nanoseconds since the trace was enabled
+        uint32_t m_kind;
+        uint32_t m_thread;
+        uint64_t m_arg1;
+        uint64_t m_arg2;
+    };
+
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    void enable(bool f);
+
+    void record(kind k, uint64_t arg1, uint64_t arg2);
+
+    char const* kind_name(kind k);
+
+    /**
+       \brief print the events of all threads, oldest first.
+       Events recorded concurrently with the dump may be skipped.
+    */
+    void dump(std::ostream& out);
+};
+
+void finalize_event_trace();
+/*
+  ADD_FINALIZER('finalize_event_trace();')
+*/
+
+#define EVENT_TRACE(K, A1, A2) { if (event_trace::enabled()) event_trace::record(event_trace::K, static_cast<uint64_t>(A1), static_cast<uint64_t>(A2)); } ((void) 0)
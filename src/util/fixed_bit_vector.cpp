@@ -125,16 +125,27 @@ unsigned fixed_bit_vector_manager::last_word(fixed_bit_vector const& bv) const {
     return bv.m_data[n-1] & m_mask;
 }
 
+// comparisons accumulate differences over blocks of words without branching,
+// so that the compiler can vectorize the inner loops.
+static const unsigned block_words = 8;
+
 bool fixed_bit_vector_manager::equals(fixed_bit_vector const& a, fixed_bit_vector const& b) const {
     if (&a == &b) return true;
     unsigned n = num_words();
     if (n == 0)
         return true;
-    for (unsigned i = 0; i < n - 1; i++) {
-        if (a.m_data[i] != b.m_data[i])
+    unsigned i = 0;
+    for (; i + block_words < n; i += block_words) {
+        unsigned diff = 0;
+        for (unsigned k = 0; k < block_words; ++k) 
+            diff |= a.m_data[i + k] ^ b.m_data[i + k];
+        if (diff)
             return false;
     }
-    return last_word(a) == last_word(b);
+    unsigned diff = 0;
+    for (; i < n - 1; i++) 
+        diff |= a.m_data[i] ^ b.m_data[i];
+    return diff == 0 && last_word(a) == last_word(b);
 }
 unsigned fixed_bit_vector_manager::hash(fixed_bit_vector const& src) const {
     return string_hash(reinterpret_cast<char const* const>(src.m_data), num_bits()/8, num_bits());
@@ -145,12 +156,19 @@ bool fixed_bit_vector_manager::contains(fixed_bit_vector const& a, fixed_bit_vec
     if (n == 0)
         return true;
     
-    for (unsigned i = 0; i < n - 1; ++i) {
-        if ((a.m_data[i] & b.m_data[i]) != b.m_data[i])
+    // a contains b if b has no bit outside of a.
+    unsigned i = 0;
+    for (; i + block_words < n; i += block_words) {
+        unsigned diff = 0;
+        for (unsigned k = 0; k < block_words; ++k) 
+            diff |= b.m_data[i + k] & ~a.m_data[i + k];
+        if (diff)
             return false;
     }
-    unsigned b_data = last_word(b);
-    return (last_word(a) & b_data) == b_data;
+    unsigned diff = 0;
+    for (; i < n - 1; ++i) 
+        diff |= b.m_data[i] & ~a.m_data[i];
+    return diff == 0 && (last_word(b) & ~last_word(a)) == 0;
 }
 
 std::ostream& fixed_bit_vector_manager::display(std::ostream& out, fixed_bit_vector const& b) const {
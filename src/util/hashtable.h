@@ -125,7 +125,18 @@ public:
     void mark_as_free() { m_ptr = 0; }
 };
 
-template<typename Entry, typename HashProc, typename EqProc>
+/**
+   \brief Open addressing hashtable with linear probing.
+
+   By default, removed entries are replaced by tombstones that are
+   cleaned up when they outnumber the live entries. When BackShift is
+   true, removal instead shifts the following entries of the probe
+   sequence back into the hole (Knuth's Algorithm R), so the table never
+   contains deleted entries and lookups after heavy insert/erase churn do
+   not walk over tombstones. Removal moves entries of a BackShift table,
+   so elements must not be erased while iterating over it.
+*/
+template<typename Entry, typename HashProc, typename EqProc, bool BackShift = false>
 class core_hashtable : private HashProc, private EqProc {
 protected:
     Entry *  m_table;
@@ -571,6 +582,10 @@ public:
         SASSERT(!contains(e));
         return; // node is not in the table
     end_remove:
+        if constexpr (BackShift) {
+            backshift_remove(curr);
+            return;
+        }
         entry * next = curr + 1;                                      
         if (next == end) {
             next = m_table;                          
@@ -589,6 +604,32 @@ public:
         }
     }
 
+    /**
+       \brief free the entry at curr and move back the entries that follow it
+       in the probe sequence and whose home position does not lie between
+       the hole and their current position.
+    */
+    void backshift_remove(entry * curr) {
+        unsigned mask = m_capacity - 1;
+        unsigned hole = static_cast<unsigned>(curr - m_table);
+        unsigned j    = hole;
+        while (true) {
+            j = (j + 1) & mask;
+            entry & e = m_table[j];
+            if (e.is_free())
+                break;
+            SASSERT(e.is_used());
+            unsigned home = e.get_hash() & mask;
+            bool stays = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+            if (stays)
+                continue;
+            m_table[hole] = std::move(e);
+            hole = j;
+        }
+        m_table[hole].mark_as_free();
+        m_size--;
+    }
+
     void erase(data const & e) { remove(e); }
     
     void dump(std::ostream & out) {
@@ -26,7 +26,7 @@ struct _key_data {
     Value m_value;
 };
 
-template<typename Entry, typename HashProc, typename EqProc>
+template<typename Entry, typename HashProc, typename EqProc, bool BackShift = false>
 class table2map {
 public:
     typedef Entry    entry;
@@ -55,7 +55,7 @@ public:
         }
     };
 
-    typedef core_hashtable<entry, entry_hash_proc, entry_eq_proc> table;
+    typedef core_hashtable<entry, entry_hash_proc, entry_eq_proc, BackShift> table;
     
     table m_table;
     
@@ -203,11 +203,11 @@ public:
 };
 
 
-template<typename Key, typename Value, typename HashProc, typename EqProc>
-class map : public table2map<default_map_entry<Key, Value>, HashProc, EqProc> {
+template<typename Key, typename Value, typename HashProc, typename EqProc, bool BackShift = false>
+class map : public table2map<default_map_entry<Key, Value>, HashProc, EqProc, BackShift> {
 public:
     map(HashProc const & h = HashProc(), EqProc const & e = EqProc()):
-        table2map<default_map_entry<Key, Value>, HashProc, EqProc>(h, e) {
+        table2map<default_map_entry<Key, Value>, HashProc, EqProc, BackShift>(h, e) {
     }
 };
 
@@ -293,6 +293,10 @@ struct int_eq { bool operator()(int u1, int u2) const { return u1 == u2; } };
 template<typename Value> 
 class u_map : public map<unsigned, Value, u_hash, u_eq> {};
 
+// u_map with backward-shift deletion, for maps with heavy insert/erase churn.
+template<typename Value> 
+class u_shift_map : public map<unsigned, Value, u_hash, u_eq, true> {};
+
 template<typename Value>
 class size_t_map : public map<size_t, Value, size_t_hash, size_t_eq> {};
 
@@ -7,6 +7,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include<iostream>
 #include<stdlib.h>
 #include<climits>
+#include<algorithm>
 #include "util/mutex.h"
 #include "util/trace.h"
 #include "util/memory_manager.h"
@@ -54,17 +55,20 @@ out_of_memory_error::out_of_memory_error():z3_error(ERR_MEMOUT) {
 }
 
 
-static DECLARE_INIT_MUTEX(g_memory_mux);
+// The global counters are updated with atomic operations, so allocation
+// never takes a lock.
 static atomic<bool> g_memory_out_of_memory(false);
 static bool       g_memory_initialized       = false;
-static long long  g_memory_alloc_size        = 0;
+static atomic<long long> g_memory_alloc_size(0);
 static long long  g_memory_max_size          = 0;
-static long long  g_memory_max_used_size     = 0;
+static atomic<long long> g_memory_max_used_size(0);
 static long long  g_memory_watermark         = 0;
-static long long  g_memory_alloc_count       = 0;
+static atomic<long long> g_memory_alloc_count(0);
 static long long  g_memory_max_alloc_count   = 0;
 static bool       g_exit_when_out_of_memory  = false;
 static char const * g_out_of_memory_msg      = "ERROR: out of memory";
+static atomic<long long> g_memory_tag_size[memory::num_tags]  = {};
+static atomic<long long> g_memory_tag_count[memory::num_tags] = {};
 
 void memory::exit_when_out_of_memory(bool flag, char const * msg) {
     g_exit_when_out_of_memory = flag;
@@ -132,7 +136,6 @@ void memory::set_high_watermark(size_t watermark) {
 bool memory::above_high_watermark() {
     if (g_memory_watermark == 0)
         return false;
-    lock_guard lock(*g_memory_mux);
     return g_memory_watermark < g_memory_alloc_size;
 }
 
@@ -153,9 +156,6 @@ void memory::finalize(bool shutdown) {
     if (g_memory_initialized) {
         g_finalizing = true;
         mem_finalize();
-        // we leak the mutex since we need it to be always live since memory may
-        // be reinitialized again
-        //delete g_memory_mux;
         g_memory_initialized = false;
         g_finalizing = false;
 
@@ -166,22 +166,14 @@ void memory::finalize(bool shutdown) {
 }
 
 unsigned long long memory::get_allocation_size() {
-    long long r;
-    {
-        lock_guard lock(*g_memory_mux);
-        r = g_memory_alloc_size;
-    }
+    long long r = g_memory_alloc_size;
     if (r < 0)
         r = 0;
     return r;
 }
 
 unsigned long long memory::get_max_used_memory() {
-    unsigned long long r;
-    {
-        lock_guard lock(*g_memory_mux);
-        r = g_memory_max_used_size;
-    }
+    long long r = g_memory_max_used_size;
     return r;
 }
 
@@ -205,6 +197,18 @@ unsigned long long memory::get_allocation_count() {
     return g_memory_alloc_count;
 }
 
+char const* memory::tag_name(tag t) {
+    switch (t) {
+    case tag_other: return "other";
+    case tag_smt: return "smt";
+    case tag_sat: return "sat";
+    case tag_egraph: return "egraph";
+    case tag_rewriter: return "rewriter";
+    case tag_numerals: return "numerals";
+    default: return "unknown";
+    }
+}
+
 
 void memory::display_max_usage(std::ostream & os) {
     unsigned long long mem = get_max_used_memory();
@@ -242,31 +246,61 @@ void * memory::allocate(char const* file, int line, char const* obj, size_t s) {
 
 
 // We only integrate the local thread counters with the global one
-// when the local counter > SYNCH_THRESHOLD 
+// when the local counter exceeds the thread threshold. Without a memory
+// limit the threshold is SYNCH_THRESHOLD. With a limit it shrinks with the
+// remaining headroom, so that SYNCH_THREADS threads with pending counts
+// cannot overshoot the limit, down to MIN_SYNCH_THRESHOLD.
 #define SYNCH_THRESHOLD 100000
+#define MIN_SYNCH_THRESHOLD 4096
+#define SYNCH_THREADS 64
 
 thread_local long long g_memory_thread_alloc_size    = 0;
 thread_local long long g_memory_thread_alloc_count   = 0;
+thread_local long long g_memory_thread_threshold     = SYNCH_THRESHOLD;
+thread_local memory::tag g_memory_tag                = memory::tag_other;
+thread_local long long g_memory_thread_tag_size[memory::num_tags]  = {};
+thread_local long long g_memory_thread_tag_count[memory::num_tags] = {};
+
+memory::tag memory::set_tag(tag t) {
+    tag old = g_memory_tag;
+    g_memory_tag = t;
+    return old;
+}
+
+long long memory::get_tag_allocation_size(tag t) {
+    return g_memory_tag_size[t] + g_memory_thread_tag_size[t];
+}
+
+unsigned long long memory::get_tag_allocation_count(tag t) {
+    return g_memory_tag_count[t] + g_memory_thread_tag_count[t];
+}
 
 static void synchronize_counters(bool allocating) {
 #ifdef PROFILE_MEMORY
     g_synch_counter++;
 #endif
 
-    bool out_of_mem = false;
-    bool counts_exceeded = false;
-    {
-        lock_guard lock(*g_memory_mux);
-        g_memory_alloc_size += g_memory_thread_alloc_size;
-        g_memory_alloc_count += g_memory_thread_alloc_count;
-        if (g_memory_alloc_size > g_memory_max_used_size)
-            g_memory_max_used_size = g_memory_alloc_size;
-        if (g_memory_max_size != 0 && g_memory_alloc_size > g_memory_max_size)
-            out_of_mem = true;
-        if (g_memory_max_alloc_count != 0 && g_memory_alloc_count > g_memory_max_alloc_count)
-            counts_exceeded = true;
-    }
+    long long size = g_memory_alloc_size.fetch_add(g_memory_thread_alloc_size) + g_memory_thread_alloc_size;
+    long long count = g_memory_alloc_count.fetch_add(g_memory_thread_alloc_count) + g_memory_thread_alloc_count;
     g_memory_thread_alloc_size = 0;
+    g_memory_thread_alloc_count = 0;
+    for (unsigned t = 0; t < memory::num_tags; ++t) {
+        if (g_memory_thread_tag_count[t] == 0 && g_memory_thread_tag_size[t] == 0)
+            continue;
+        g_memory_tag_size[t] += g_memory_thread_tag_size[t];
+        g_memory_tag_count[t] += g_memory_thread_tag_count[t];
+        g_memory_thread_tag_size[t] = 0;
+        g_memory_thread_tag_count[t] = 0;
+    }
+    long long max_used = g_memory_max_used_size;
+    while (size > max_used && !g_memory_max_used_size.compare_exchange_weak(max_used, size))
+        ;
+    bool out_of_mem = g_memory_max_size != 0 && size > g_memory_max_size;
+    bool counts_exceeded = g_memory_max_alloc_count != 0 && count > g_memory_max_alloc_count;
+    if (g_memory_max_size != 0) {
+        long long headroom = g_memory_max_size - size;
+        g_memory_thread_threshold = std::max<long long>(MIN_SYNCH_THRESHOLD, std::min<long long>(SYNCH_THRESHOLD, headroom / SYNCH_THREADS));
+    }
     if (out_of_mem && allocating) {
         throw_out_of_memory();
     }
@@ -285,8 +319,9 @@ void memory::deallocate(void * p) {
     void * real_p  = reinterpret_cast<void*>(sz_p);
 #endif
     g_memory_thread_alloc_size -= sz;
+    g_memory_thread_tag_size[g_memory_tag] -= sz;
     free(real_p);
-    if (g_memory_thread_alloc_size < -SYNCH_THRESHOLD) {
+    if (g_memory_thread_alloc_size < -g_memory_thread_threshold) {
         synchronize_counters(false);
     }
 }
@@ -297,7 +332,9 @@ void * memory::allocate(size_t s) {
 #endif
     g_memory_thread_alloc_size += s;
     g_memory_thread_alloc_count += 1;
-    if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
+    g_memory_thread_tag_size[g_memory_tag] += s;
+    g_memory_thread_tag_count[g_memory_tag] += 1;
+    if (g_memory_thread_alloc_size > g_memory_thread_threshold) {
         synchronize_counters(true);
     }
     void * r = malloc(s);
@@ -307,6 +344,7 @@ void * memory::allocate(size_t s) {
     }
 #ifdef HAS_MALLOC_USABLE_SIZE
     g_memory_thread_alloc_size += malloc_usable_size(r) - s;
+    g_memory_thread_tag_size[g_memory_tag] += malloc_usable_size(r) - s;
     return r;
 #else
     *(static_cast<size_t*>(r)) = s;
@@ -329,7 +367,9 @@ void* memory::reallocate(void *p, size_t s) {
 #endif
     g_memory_thread_alloc_size += s - sz;
     g_memory_thread_alloc_count += 1;
-    if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
+    g_memory_thread_tag_size[g_memory_tag] += s - sz;
+    g_memory_thread_tag_count[g_memory_tag] += 1;
+    if (g_memory_thread_alloc_size > g_memory_thread_threshold) {
         synchronize_counters(true);
     }
 
@@ -340,6 +380,7 @@ void* memory::reallocate(void *p, size_t s) {
     }
 #ifdef HAS_MALLOC_USABLE_SIZE
     g_memory_thread_alloc_size += malloc_usable_size(r) - s;
+    g_memory_thread_tag_size[g_memory_tag] += malloc_usable_size(r) - s;
     return r;
 #else
     *(static_cast<size_t*>(r)) = s;
@@ -355,6 +396,22 @@ void* memory::reallocate(void *p, size_t s) {
 // ==================================
 // allocate & deallocate without locking
 
+static memory::tag g_memory_tag = memory::tag_other;
+
+memory::tag memory::set_tag(tag t) {
+    tag old = g_memory_tag;
+    g_memory_tag = t;
+    return old;
+}
+
+long long memory::get_tag_allocation_size(tag t) {
+    return g_memory_tag_size[t];
+}
+
+unsigned long long memory::get_tag_allocation_count(tag t) {
+    return g_memory_tag_count[t];
+}
+
 void memory::deallocate(void * p) {
 #ifdef HAS_MALLOC_USABLE_SIZE
     size_t sz      = malloc_usable_size(p);
@@ -365,6 +422,7 @@ void memory::deallocate(void * p) {
     void * real_p  = reinterpret_cast<void*>(sz_p);
 #endif
     g_memory_alloc_size -= sz;
+    g_memory_tag_size[g_memory_tag] -= sz;
     free(real_p);
 }
 
@@ -374,6 +432,8 @@ void * memory::allocate(size_t s) {
 #endif
     g_memory_alloc_size += s;
     g_memory_alloc_count += 1;
+    g_memory_tag_size[g_memory_tag] += s;
+    g_memory_tag_count[g_memory_tag] += 1;
     if (g_memory_alloc_size > g_memory_max_used_size)
         g_memory_max_used_size = g_memory_alloc_size;
     if (g_memory_max_size != 0 && g_memory_alloc_size > g_memory_max_size)
@@ -388,6 +448,7 @@ void * memory::allocate(size_t s) {
     }
 #ifdef HAS_MALLOC_USABLE_SIZE
     g_memory_alloc_size += malloc_usable_size(r) - s;
+    g_memory_tag_size[g_memory_tag] += malloc_usable_size(r) - s;
     return r;
 #else
     *(static_cast<size_t*>(r)) = s;
@@ -410,6 +471,8 @@ void* memory::reallocate(void *p, size_t s) {
 #endif
     g_memory_alloc_size += s - sz;
     g_memory_alloc_count += 1;
+    g_memory_tag_size[g_memory_tag] += s - sz;
+    g_memory_tag_count[g_memory_tag] += 1;
     if (g_memory_alloc_size > g_memory_max_used_size)
         g_memory_max_used_size = g_memory_alloc_size;
     if (g_memory_max_size != 0 && g_memory_alloc_size > g_memory_max_size)
@@ -424,6 +487,7 @@ void* memory::reallocate(void *p, size_t s) {
     }
 #ifdef HAS_MALLOC_USABLE_SIZE
     g_memory_alloc_size += malloc_usable_size(r) - s;
+    g_memory_tag_size[g_memory_tag] += malloc_usable_size(r) - s;
     return r;
 #else
     *(static_cast<size_t*>(r)) = s;
@@ -50,6 +50,25 @@ public:
 
 class memory {
 public:
+    /**
+       \brief subsystems for which allocations are accounted separately.
+       The current tag is thread local and set by scoped_memory_tag.
+    */
+    enum tag {
+        tag_other,
+        tag_smt,
+        tag_sat,
+        tag_egraph,
+        tag_rewriter,
+        tag_numerals,
+        num_tags
+    };
+    static tag set_tag(tag t);
+    static char const* tag_name(tag t);
+    // bytes allocated minus bytes freed while t was the current tag.
+    static long long get_tag_allocation_size(tag t);
+    static unsigned long long get_tag_allocation_count(tag t);
+
     static bool is_out_of_memory();
     static void initialize(size_t max_size);
     static void set_high_watermark(size_t watermak);
@@ -75,6 +94,13 @@ public:
 };
 
 
+class scoped_memory_tag {
+    memory::tag m_old;
+public:
+    scoped_memory_tag(memory::tag t) : m_old(memory::set_tag(t)) {}
+    ~scoped_memory_tag() { memory::set_tag(m_old); }
+};
+
 #if _DEBUG
 
 #define alloc(T,...) new (memory::allocate(__FILE__,__LINE__,#T, sizeof(T))) T(__VA_ARGS__)
@@ -194,6 +194,7 @@ mpz_manager<SYNCH>::~mpz_manager() {
 template<bool SYNCH>
 mpz_cell * mpz_manager<SYNCH>::allocate(unsigned capacity) {
     SASSERT(capacity >= m_init_cell_capacity);
+    scoped_memory_tag _tag(memory::tag_numerals);
     mpz_cell * cell;
 #ifdef SINGLE_THREAD
     cell = reinterpret_cast<mpz_cell*>(m_allocator.allocate(cell_size(capacity)));
@@ -213,6 +214,7 @@ mpz_cell * mpz_manager<SYNCH>::allocate(unsigned capacity) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::deallocate(bool is_heap, mpz_cell * ptr) { 
     if (is_heap) {
+        scoped_memory_tag _tag(memory::tag_numerals);
 
 #ifdef SINGLE_THREAD
         m_allocator.deallocate(cell_size(ptr->m_capacity), ptr); 
@@ -252,9 +254,13 @@ void mpz_manager<SYNCH>::del(mpz_manager<SYNCH>* m, mpz & a) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::add(mpz const & a, mpz const & b, mpz & c) {
     STRACE("mpz", tout << "[mpz] " << to_string(a) << " + " << to_string(b) << " == ";); 
+    int64_t r;
     if (is_small(a) && is_small(b)) {
         set_i64(c, i64(a) + i64(b));
     }
+    else if (add_i64(a, b, r)) {
+        set_i64(c, r);
+    }
     else {
         big_add(a, b, c);
     }
@@ -264,9 +270,13 @@ void mpz_manager<SYNCH>::add(mpz const & a, mpz const & b, mpz & c) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::sub(mpz const & a, mpz const & b, mpz & c) {
     STRACE("mpz", tout << "[mpz] " << to_string(a) << " - " << to_string(b) << " == ";); 
+    int64_t r;
     if (is_small(a) && is_small(b)) {
         set_i64(c, i64(a) - i64(b));
     }
+    else if (sub_i64(a, b, r)) {
+        set_i64(c, r);
+    }
     else {
         big_sub(a, b, c);
     }
@@ -508,9 +518,13 @@ void mpz_manager<SYNCH>::set_digits(mpz & target, unsigned sz, digit_t const * d
 template<bool SYNCH>
 void mpz_manager<SYNCH>::mul(mpz const & a, mpz const & b, mpz & c) {
     STRACE("mpz", tout << "[mpz] " << to_string(a) << " * " << to_string(b) << " == ";); 
+    int64_t r;
     if (is_small(a) && is_small(b)) {
         set_i64(c, i64(a) * i64(b));
     }
+    else if (mul_i64(a, b, r)) {
+        set_i64(c, r);
+    }
     else {
         big_mul(a, b, c);
     }
@@ -893,6 +907,11 @@ void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
         unsigned r = u_gcd(_a, _b);
         set(c, r);
     }
+    else if (is_int64(a) && is_int64(b)) {
+        // both fit in 64 bits: binary gcd on machine words.
+        auto uabs = [](int64_t v) { return v < 0 ? 0ull - static_cast<uint64_t>(v) : static_cast<uint64_t>(v); };
+        set(c, u64_gcd(uabs(get_int64(a)), uabs(get_int64(b))));
+    }
     else {
 #ifdef _MP_GMP
         ensure_mpz_t a1(a), b1(b);
@@ -27,6 +27,12 @@ Revision History:
 #include "util/scoped_numeral_vector.h"
 #include "util/mpn.h"
 
+#if defined(__GNUC__) || defined(__clang__)
+#define MPZ_HAS_OVERFLOW_BUILTINS 1
+#else
+#define MPZ_HAS_OVERFLOW_BUILTINS 0
+#endif
+
 unsigned u_gcd(unsigned u, unsigned v);
 uint64_t u64_gcd(uint64_t u, uint64_t v);
 unsigned trailing_zeros(uint64_t);
@@ -269,6 +275,32 @@ class mpz_manager {
 
     void set_big_ui64(mpz & c, uint64_t v);
 
+    // 64-bit fast paths for operands that are not both small but fit in int64_t.
+    // They return false if an operand or the result does not fit.
+    bool add_i64(mpz const & a, mpz const & b, int64_t & r) const {
+#if MPZ_HAS_OVERFLOW_BUILTINS
+        return is_int64(a) && is_int64(b) && !__builtin_add_overflow(get_int64(a), get_int64(b), &r);
+#else
+        return false;
+#endif
+    }
+
+    bool sub_i64(mpz const & a, mpz const & b, int64_t & r) const {
+#if MPZ_HAS_OVERFLOW_BUILTINS
+        return is_int64(a) && is_int64(b) && !__builtin_sub_overflow(get_int64(a), get_int64(b), &r);
+#else
+        return false;
+#endif
+    }
+
+    bool mul_i64(mpz const & a, mpz const & b, int64_t & r) const {
+#if MPZ_HAS_OVERFLOW_BUILTINS
+        return is_int64(a) && is_int64(b) && !__builtin_mul_overflow(get_int64(a), get_int64(b), &r);
+#else
+        return false;
+#endif
+    }
+
 
 #ifndef _MP_GMP
 
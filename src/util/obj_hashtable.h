@@ -52,7 +52,11 @@ public:
 
 };
 
-template<typename Key, typename Value>
+/**
+   \brief map from AST nodes to values.
+   BackShift selects backward-shift deletion in the underlying table, see core_hashtable.
+*/
+template<typename Key, typename Value, bool BackShift = false>
 class obj_map {
 public:
     struct key_data {
@@ -92,7 +96,7 @@ public:
         void mark_as_free() { m_data.m_key = nullptr; }
     };
 
-    typedef core_hashtable<obj_map_entry, obj_hash<key_data>, default_eq<key_data> > table;
+    typedef core_hashtable<obj_map_entry, obj_hash<key_data>, default_eq<key_data>, BackShift> table;
 
     table m_table;
   
@@ -49,3 +49,37 @@ public:
     void reset() { m_marks.reset(); }
 };
 
+/**
+   \brief mark indexed by the ids of the objects, where reset takes constant time.
+   An object is marked if its stamp is the current epoch, reset moves to the next epoch.
+   It suits traversals that reset the mark for each call and visit few of the ids.
+*/
+template<typename T, typename T2UInt = default_t2uint<T> >
+class obj_epoch_mark {
+    T2UInt          m_proc;
+    unsigned_vector m_stamps;
+    unsigned        m_epoch = 1;
+public:
+    obj_epoch_mark(T2UInt const & p = T2UInt()):m_proc(p) {}
+    bool is_marked(T const & obj) const {
+        unsigned id = m_proc(obj);
+        return id < m_stamps.size() && m_stamps[id] == m_epoch;
+    }
+    bool is_marked(T * obj) const { return is_marked(*obj); }
+    void mark(T const & obj, bool flag) {
+        unsigned id = m_proc(obj);
+        if (id >= m_stamps.size())
+            m_stamps.resize(id + 1, 0);
+        m_stamps[id] = flag ? m_epoch : 0;
+    }
+    void mark(T const * obj, bool flag) { mark(*obj, flag); }
+    void mark(T const & obj) { mark(obj, true); }
+    void mark(T const * obj) { mark(obj, true); }
+    void reset() {
+        if (++m_epoch == 0) {
+            m_stamps.fill(0);
+            m_epoch = 1;
+        }
+    }
+};
+
@@ -0,0 +1,149 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    perf_counters.cpp
+
+Abstract:
+
+    Hardware performance counters for hot phases.
+
+    Each thread opens one perf event group, led by the cycle counter,
+    the first time it enters a scope, so that all counters are read with
+    a single system call. The descriptors are closed when the thread exits.
+
+--*/
+#include "util/perf_counters.h"
+#include "util/statistics.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace perf_counters {
+
+    std::atomic<bool> g_enabled(false);
+
+    static std::atomic<uint64_t> g_totals[num_phases][num_counters];
+    static std::atomic<uint64_t> g_calls[num_phases];
+
+    void enable(bool f) {
+        g_enabled.store(f, std::memory_order_relaxed);
+    }
+
+#if defined(__linux__)
+
+    static uint64_t const s_config[num_counters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    struct thread_counters {
+        int  m_fds[num_counters];
+        bool m_opened = false;
+        bool m_failed = false;
+
+        thread_counters() {
+            for (int& fd : m_fds)
+                fd = -1;
+        }
+
+        ~thread_counters() {
+            for (int fd : m_fds)
+                if (fd >= 0)
+                    close(fd);
+        }
+
+        bool open() {
+            m_opened = true;
+            for (unsigned i = 0; i < num_counters; ++i) {
+                perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = s_config[i];
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.disabled = i == 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                int leader = i == 0 ? -1 : m_fds[0];
+                m_fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+                if (m_fds[i] < 0) {
+                    m_failed = true;
+                    return false;
+                }
+            }
+            ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            return true;
+        }
+
+        bool read_values(uint64_t* values) {
+            if (m_failed || (!m_opened && !open()))
+                return false;
+            // PERF_FORMAT_GROUP: the number of counters followed by their values.
+            uint64_t buffer[1 + num_counters];
+            if (::read(m_fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != num_counters)
+                return false;
+            for (unsigned i = 0; i < num_counters; ++i)
+                values[i] = buffer[i + 1];
+            return true;
+        }
+    };
+
+    static thread_local thread_counters t_counters;
+
+    bool read(uint64_t* values) {
+        return t_counters.read_values(values);
+    }
+
+#else
+
+    bool read(uint64_t*) {
+        return false;
+    }
+
+#endif
+
+    void add(phase p, uint64_t const* start) {
+        uint64_t end[num_counters];
+        if (!read(end))
+            return;
+        for (unsigned i = 0; i < num_counters; ++i)
+            g_totals[p][i].fetch_add(end[i] - start[i], std::memory_order_relaxed);
+        g_calls[p].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void collect_statistics(statistics& st) {
+        if (!enabled())
+            return;
+        // statistics keep the key pointers, so the keys are static.
+        static char const* const s_keys[num_phases][num_counters] = {
+            { "perf sat.propagate cycles", "perf sat.propagate instructions", "perf sat.propagate cache misses", "perf sat.propagate branch misses" },
+            { "perf smt.propagate cycles", "perf smt.propagate instructions", "perf smt.propagate cache misses", "perf smt.propagate branch misses" },
+            { "perf rewriter cycles", "perf rewriter instructions", "perf rewriter cache misses", "perf rewriter branch misses" },
+            { "perf lp.pivot cycles", "perf lp.pivot instructions", "perf lp.pivot cache misses", "perf lp.pivot branch misses" }
+        };
+        for (unsigned p = 0; p < num_phases; ++p) {
+            if (g_calls[p].load(std::memory_order_relaxed) == 0)
+                continue;
+            for (unsigned i = 0; i < num_counters; ++i)
+                // counts exceed 32 bits quickly, so they are reported as doubles.
+                st.update(s_keys[p][i], static_cast<double>(g_totals[p][i].load(std::memory_order_relaxed)));
+        }
+    }
+
+    void reset() {
+        for (unsigned p = 0; p < num_phases; ++p) {
+            g_calls[p].store(0, std::memory_order_relaxed);
+            for (unsigned i = 0; i < num_counters; ++i)
+                g_totals[p][i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
@@ -0,0 +1,85 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    perf_counters.h
+
+Abstract:
+
+    Hardware performance counters for hot phases.
+
+    A perf_counters::scope reads the cycles, instructions, cache misses
+    and branch misses of the calling thread on entry and exit of a phase
+    (BCP, congruence closure propagation, rewriting, simplex pivots) and
+    adds the difference to the totals of the phase. The counts are
+    inclusive: rewriting done during propagation is counted for both.
+
+    Counters are enabled at runtime by the parameter perf_counters. They
+    use perf_event_open and are only available on Linux; elsewhere, or if
+    the kernel refuses to open them, scopes count nothing. When disabled,
+    a scope costs a relaxed load and a branch.
+
+--*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+class statistics;
+
+namespace perf_counters {
+
+    enum phase {
+        sat_propagate,
+        smt_propagate,
+        rewriter,
+        lp_pivot,
+        num_phases
+    };
+
+    enum counter {
+        cycles,
+        instructions,
+        cache_misses,
+        branch_misses,
+        num_counters
+    };
+
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    void enable(bool f);
+
+    /**
+       \brief read the counters of the calling thread.
+       Return false if they are not available.
+    */
+    bool read(uint64_t* values);
+
+    void add(phase p, uint64_t const* start);
+
+    class scope {
+        phase    m_phase;
+        bool     m_active = false;
+        uint64_t m_start[num_counters];
+    public:
+        scope(phase p): m_phase(p) {
+            if (enabled())
+                m_active = read(m_start);
+        }
+        ~scope() {
+            if (m_active)
+                add(m_phase, m_start);
+        }
+    };
+
+    /**
+       \brief add "perf <phase> <counter>" for every phase that was entered,
+       summed over all threads.
+    */
+    void collect_statistics(statistics& st);
+
+    void reset();
+};
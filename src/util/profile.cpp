@@ -0,0 +1,206 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    profile.cpp
+
+Abstract:
+
+    Hierarchical profiling timers.
+
+--*/
+#include <chrono>
+#include <cstring>
+#include <string>
+#include "util/profile.h"
+#include "util/mutex.h"
+#include "util/vector.h"
+#include "util/map.h"
+#include "util/str_hashtable.h"
+#include "util/statistics.h"
+#include "util/symbol.h"
+
+namespace profile {
+
+    std::atomic<bool> g_enabled(false);
+
+    struct node {
+        char const*      m_name;
+        node*            m_parent;
+        ptr_vector<node> m_children;
+        uint64_t         m_calls = 0;
+        uint64_t         m_time = 0;         // inclusive, in nanoseconds
+        uint64_t         m_child_time = 0;   // spent in nested regions
+        node(char const* name, node* parent): m_name(name), m_parent(parent) {}
+        ~node() {
+            for (node* c : m_children)
+                dealloc(c);
+        }
+        uint64_t self_time() const { return m_time > m_child_time ? m_time - m_child_time : 0; }
+    };
+
+    struct thread_profile {
+        node     m_root;
+        node*    m_current;
+        unsigned m_id;
+        mutex    m_mux;    // protects the shape of the tree against readers in other threads
+        thread_profile(unsigned id): m_root("root", nullptr), m_current(&m_root), m_id(id) {}
+    };
+
+    static DECLARE_INIT_MUTEX(g_profile_mux);
+    static ptr_vector<thread_profile>* g_threads = nullptr;
+    static std::atomic<unsigned> g_generation(0);
+    static thread_local thread_profile* t_profile = nullptr;
+    static thread_local unsigned t_generation = 0;
+
+    void enable(bool f) {
+        g_enabled.store(f, std::memory_order_relaxed);
+    }
+
+    uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static thread_profile& get_thread_profile() {
+        unsigned gen = g_generation.load(std::memory_order_relaxed);
+        if (!t_profile || t_generation != gen) {
+            lock_guard lock(*g_profile_mux);
+            if (!g_threads)
+                g_threads = alloc(ptr_vector<thread_profile>);
+            t_profile = alloc(thread_profile, g_threads->size());
+            t_generation = gen;
+            g_threads->push_back(t_profile);
+        }
+        return *t_profile;
+    }
+
+    node* enter(char const* name) {
+        thread_profile& tp = get_thread_profile();
+        node* cur = tp.m_current;
+        node* child = nullptr;
+        for (node* c : cur->m_children) {
+            if (c->m_name == name || strcmp(c->m_name, name) == 0) {
+                child = c;
+                break;
+            }
+        }
+        if (!child) {
+            child = alloc(node, name, cur);
+            lock_guard lock(tp.m_mux);
+            cur->m_children.push_back(child);
+        }
+        tp.m_current = child;
+        return child;
+    }
+
+    void leave(node* n, uint64_t start) {
+        uint64_t elapsed = now() - start;
+        n->m_time += elapsed;
+        n->m_calls++;
+        n->m_parent->m_child_time += elapsed;
+        t_profile->m_current = n->m_parent;
+    }
+
+    struct summary {
+        uint64_t m_calls = 0;
+        uint64_t m_time = 0;
+        uint64_t m_self_time = 0;
+    };
+
+    typedef map<char const*, summary, str_hash_proc, str_eq_proc> summary_map;
+
+    static bool has_ancestor(node const* n, char const* name) {
+        for (node const* p = n->m_parent; p; p = p->m_parent)
+            if (strcmp(p->m_name, name) == 0)
+                return true;
+        return false;
+    }
+
+    static void summarize(node const* n, summary_map& acc) {
+        for (node const* c : n->m_children) {
+            summary& s = acc.insert_if_not_there(c->m_name, summary());
+            s.m_calls += c->m_calls;
+            s.m_self_time += c->self_time();
+            // recursive regions are counted once in the inclusive time.
+            if (!has_ancestor(c, c->m_name))
+                s.m_time += c->m_time;
+            summarize(c, acc);
+        }
+    }
+
+    static char const* mk_key(char const* name, char const* suffix) {
+        std::string key = std::string("profile ") + name + suffix;
+        // statistics keep the key pointer, symbols keep the string alive.
+        return symbol(key.c_str()).bare_str();
+    }
+
+    void collect_statistics(statistics& st) {
+        if (!enabled())
+            return;
+        summary_map acc;
+        lock_guard lock(*g_profile_mux);
+        if (!g_threads)
+            return;
+        for (thread_profile* tp : *g_threads) {
+            lock_guard lock2(tp->m_mux);
+            summarize(&tp->m_root, acc);
+        }
+        for (auto const& kv : acc) {
+            st.update(mk_key(kv.m_key, ""), kv.m_value.m_time / 1e9);
+            st.update(mk_key(kv.m_key, " self"), kv.m_value.m_self_time / 1e9);
+            st.update(mk_key(kv.m_key, " calls"), static_cast<double>(kv.m_value.m_calls));
+        }
+    }
+
+    static void dump_folded(std::ostream& out, node const* n, std::string& path) {
+        size_t sz = path.size();
+        for (node const* c : n->m_children) {
+            path += ";";
+            path += c->m_name;
+            out << path << " " << c->self_time() / 1000 << "\n";
+            dump_folded(out, c, path);
+            path.resize(sz);
+        }
+    }
+
+    void dump_folded(std::ostream& out) {
+        lock_guard lock(*g_profile_mux);
+        if (!g_threads)
+            return;
+        for (thread_profile* tp : *g_threads) {
+            lock_guard lock2(tp->m_mux);
+            std::string path = "thread-" + std::to_string(tp->m_id);
+            dump_folded(out, &tp->m_root, path);
+        }
+        out.flush();
+    }
+
+    static void reset(node* n) {
+        n->m_calls = n->m_time = n->m_child_time = 0;
+        for (node* c : n->m_children)
+            reset(c);
+    }
+
+    void reset() {
+        lock_guard lock(*g_profile_mux);
+        if (!g_threads)
+            return;
+        for (thread_profile* tp : *g_threads) {
+            lock_guard lock2(tp->m_mux);
+            reset(&tp->m_root);
+        }
+    }
+};
+
+void finalize_profile() {
+    profile::g_enabled.store(false, std::memory_order_relaxed);
+    // profiles cached by threads from before the finalization are replaced on their next scope.
+    profile::g_generation.fetch_add(1, std::memory_order_relaxed);
+    if (profile::g_threads) {
+        for (auto* tp : *profile::g_threads)
+            dealloc(tp);
+        dealloc(profile::g_threads);
+        profile::g_threads = nullptr;
+    }
+}
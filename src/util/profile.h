@@ -0,0 +1,83 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    profile.h
+
+Abstract:
+
+    Hierarchical profiling timers.
+
+    A profile::scope measures the time spent in a named region,
+    for example a tactic, a simplifier or a theory final check. Scopes
+    nest. Each thread keeps a tree of regions, indexed by the chain of
+    enclosing regions, with the number of calls, the inclusive time and
+    the time spent in nested regions. Profiling is enabled at runtime by
+    the parameter profile. When it is disabled, a scope costs a relaxed
+    load and a branch.
+
+    collect_statistics adds the inclusive and exclusive time per region,
+    summed over all threads, to a statistics object. dump_folded writes
+    the trees as folded stacks, the input format of flame graph tools.
+
+    Region names must be static strings.
+
+--*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+class statistics;
+
+namespace profile {
+
+    struct node;
+
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    void enable(bool f);
+
+    node* enter(char const* name);
+    void leave(node* n, uint64_t start);
+    uint64_t now();
+
+    class scope {
+        node*    m_node = nullptr;
+        uint64_t m_start = 0;
+    public:
+        scope(char const* name) {
+            if (enabled()) {
+                m_node = enter(name);
+                m_start = now();
+            }
+        }
+        ~scope() {
+            if (m_node)
+                leave(m_node, m_start);
+        }
+    };
+
+    /**
+       \brief add "profile <region>" (inclusive seconds) and
+       "profile <region> self" (exclusive seconds) for every region.
+    */
+    void collect_statistics(statistics& st);
+
+    /**
+       \brief write one line "thread-i;region;...;region <exclusive microseconds>"
+       per node of the region trees.
+    */
+    void dump_folded(std::ostream& out);
+
+    void reset();
+};
+
+void finalize_profile();
+/*
+  ADD_FINALIZER('finalize_profile();')
+*/
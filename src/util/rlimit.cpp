@@ -42,16 +42,6 @@ uint64_t reslimit::count() const {
     return m_count;
 }
 
-bool reslimit::inc() {
-    ++m_count;
-    return not_canceled();
-}
-
-bool reslimit::inc(unsigned offset) {
-    m_count += offset;
-    return not_canceled();
-}
-
 void reslimit::push(unsigned delta_limit) {
     uint64_t new_limit = delta_limit ? delta_limit + m_count : std::numeric_limits<uint64_t>::max();
     if (new_limit <= m_count) {
@@ -47,8 +47,32 @@ public:
     void pop_child();
     void pop_child(reslimit* r);
 
-    bool inc();
-    bool inc(unsigned offset);
+    bool inc() {
+        ++m_count;
+        return not_canceled();
+    }
+
+    bool inc(unsigned offset) {
+        m_count += offset;
+        return not_canceled();
+    }
+
+    /**
+       \brief amortized variant of inc() for hot loops.
+       The step is counted as with inc(), but the resource limit is only
+       compared every tick_period steps. In between, only the cancellation
+       flag is read, with relaxed ordering. A cancellation is therefore seen
+       on the next tick. An exhausted resource limit is seen at most
+       tick_period - 1 steps late.
+    */
+    static const unsigned tick_period = 64;
+    bool tick() {
+        ++m_count;
+        if ((m_count & (tick_period - 1)) != 0)
+            return m_cancel.load(std::memory_order_relaxed) == 0 || m_suspend;
+        return not_canceled();
+    }
+
     uint64_t count() const;
 
     bool suspended() const { return m_suspend;  }
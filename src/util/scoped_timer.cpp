@@ -7,7 +7,13 @@ Module Name:
 
 Abstract:
 
-    <abstract>
+    All scoped timers are served by a single thread that keeps them in a
+    hierarchical timer wheel with millisecond ticks. A timer is filed in
+    the level of the highest base-64 digit in which its expiry differs
+    from the current tick, and moves down a level each time the wheel
+    below it wraps around. Arming and disarming a timer takes constant
+    time. When timers are armed, the thread sleeps until the next timer
+    of the lowest level expires or until that level wraps around.
 
 Author:
 
@@ -20,94 +26,226 @@ Revision History:
 --*/
 
 #include "util/scoped_timer.h"
-#include "util/mutex.h"
 #include "util/util.h"
-#include <atomic>
 #include <chrono>
 #include <climits>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <thread>
-#include <vector>
 #ifndef _WINDOWS
 #include <pthread.h>
 #endif
 
-enum scoped_timer_work_state { IDLE = 0, WORKING = 1, EXITING = 2 };
+static unsigned const wheel_bits   = 6;
+static unsigned const wheel_size   = 1u << wheel_bits;
+static unsigned const wheel_mask   = wheel_size - 1;
+static unsigned const wheel_levels = 5;
 
 struct scoped_timer_state {
-    std::thread m_thread;
-    std::timed_mutex m_mutex;
-    event_handler * eh;
-    unsigned ms;
-    std::atomic<scoped_timer_work_state> work;
-    std::condition_variable_any cv;
+    event_handler *       eh = nullptr;
+    uint64_t              expiry = 0;
+    scoped_timer_state *  prev = nullptr;
+    scoped_timer_state *  next = nullptr;
+    scoped_timer_state ** head = nullptr; // list containing the timer, null if disarmed.
 };
 
-static std::vector<scoped_timer_state*> available_workers;
-static std::mutex workers;
-static atomic<unsigned> num_workers(0);
+class timer_wheel {
+    typedef std::chrono::steady_clock clock;
 
-static void thread_func(scoped_timer_state *s) {
-    workers.lock();
-    while (true) {
-        s->cv.wait(workers, [=]{ return s->work != IDLE; });
-        workers.unlock();
+    std::mutex                m_mutex;
+    std::condition_variable   m_cv;       // wakes up the timer thread.
+    std::condition_variable   m_idle_cv;  // signals the end of a handler call or a disarmed timer.
+    std::thread               m_thread;
+    bool                      m_running = false;
+    bool                      m_exit = false;
+    clock::time_point         m_start = clock::now();
+    uint64_t                  m_now = 0;             // last tick processed.
+    uint64_t                  m_wakeup = UINT64_MAX; // tick the thread sleeps until.
+    unsigned                  m_num_armed = 0;
+    scoped_timer_state *      m_slots[wheel_levels][wheel_size] = {};
+    scoped_timer_state *      m_due = nullptr;
+    scoped_timer_state *      m_firing = nullptr;
 
-        if (s->work == EXITING)
+    uint64_t now_ms() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - m_start).count());
+    }
+
+    static unsigned digit(uint64_t t, unsigned level) {
+        return static_cast<unsigned>(t >> (wheel_bits * level)) & wheel_mask;
+    }
+
+    static void link(scoped_timer_state* s, scoped_timer_state** head) {
+        s->head = head;
+        s->prev = nullptr;
+        s->next = *head;
+        if (*head)
+            (*head)->prev = s;
+        *head = s;
+    }
+
+    static void unlink(scoped_timer_state* s) {
+        if (s->prev)
+            s->prev->next = s->next;
+        else
+            *s->head = s->next;
+        if (s->next)
+            s->next->prev = s->prev;
+        s->head = nullptr;
+        s->prev = s->next = nullptr;
+    }
+
+    void insert(scoped_timer_state* s) {
+        if (s->expiry <= m_now) {
+            link(s, &m_due);
             return;
+        }
+        unsigned level = 0;
+        while (level < wheel_levels && (s->expiry >> (wheel_bits * (level + 1))) != (m_now >> (wheel_bits * (level + 1))))
+            ++level;
+        if (level < wheel_levels)
+            link(s, &m_slots[level][digit(s->expiry, level)]);
+        else
+            // beyond the horizon: park in the last slot of the top level to be reinserted from there.
+            link(s, &m_slots[wheel_levels - 1][(digit(m_now, wheel_levels - 1) + wheel_mask) & wheel_mask]);
+    }
+
+    void cascade(unsigned level, unsigned idx) {
+        scoped_timer_state* s = m_slots[level][idx];
+        m_slots[level][idx] = nullptr;
+        while (s) {
+            scoped_timer_state* next = s->next;
+            insert(s);
+            s = next;
+        }
+    }
 
-        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(s->ms);
+    // advance the wheel by one tick and move the expired timers to the due list.
+    void tick() {
+        ++m_now;
+        unsigned top = 0;
+        while (top + 1 < wheel_levels && digit(m_now, top) == 0)
+            ++top;
+        for (unsigned level = top; level > 0; --level)
+            cascade(level, digit(m_now, level));
+        while (scoped_timer_state* s = m_slots[0][digit(m_now, 0)]) {
+            unlink(s);
+            link(s, &m_due);
+        }
+    }
 
-        while (!s->m_mutex.try_lock_until(end)) {
-            if (std::chrono::steady_clock::now() >= end) {
-                s->eh->operator()(TIMEOUT_EH_CALLER);
-                goto next;
+    void fire(std::unique_lock<std::mutex>& lock) {
+        while (scoped_timer_state* s = m_due) {
+            unlink(s);
+            --m_num_armed;
+            m_firing = s;
+            lock.unlock();
+            s->eh->operator()(TIMEOUT_EH_CALLER);
+            lock.lock();
+            m_firing = nullptr;
+            m_idle_cv.notify_all();
+        }
+    }
+
+    // the next tick with an expiring timer, or the next wrap around of the lowest level.
+    uint64_t next_wakeup() const {
+        uint64_t end = ((m_now >> wheel_bits) + 1) << wheel_bits;
+        for (uint64_t t = m_now + 1; t < end; ++t)
+            if (m_slots[0][digit(t, 0)])
+                return t;
+        return end;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_exit) {
+            uint64_t now = now_ms();
+            if (m_num_armed == 0)
+                m_now = std::max(m_now, now);
+            while (m_now < now && !m_exit) {
+                tick();
+                fire(lock);
+            }
+            if (m_exit)
+                break;
+            if (m_num_armed == 0) {
+                m_wakeup = UINT64_MAX;
+                m_cv.wait(lock);
+            }
+            else {
+                m_wakeup = next_wakeup();
+                m_cv.wait_until(lock, m_start + std::chrono::milliseconds(m_wakeup));
             }
         }
+    }
 
-        s->m_mutex.unlock();
+public:
 
-    next:
-        s->work = IDLE;
-        workers.lock();
+    void arm(scoped_timer_state* s, unsigned ms) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            m_running = true;
+            m_exit = false;
+            m_thread = std::thread([this]() { run(); });
+        }
+        uint64_t now = now_ms();
+        if (m_num_armed == 0)
+            // the wheel is empty, skip the ticks the sleeping thread did not process.
+            m_now = std::max(m_now, now);
+        s->expiry = now + ms;
+        ++m_num_armed;
+        insert(s);
+        if (s->expiry < m_wakeup)
+            m_cv.notify_one();
+    }
+
+    // on return, the handler of s is not running and will not be called.
+    void disarm(scoped_timer_state* s) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (s->head) {
+            unlink(s);
+            --m_num_armed;
+            m_idle_cv.notify_all();
+        }
+        while (m_firing == s)
+            m_idle_cv.wait(lock);
     }
-}
 
+    // wait for all armed timers to expire or be disarmed and stop the thread.
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_running)
+                return;
+            while (m_num_armed > 0 || m_firing)
+                m_idle_cv.wait(lock);
+            m_exit = true;
+            m_running = false;
+            m_cv.notify_one();
+        }
+        m_thread.join();
+    }
+};
+
+// the wheel is never deleted: timers may still be disarmed during static destruction.
+static timer_wheel& get_wheel() {
+    static timer_wheel* w = new timer_wheel();
+    return *w;
+}
 
 scoped_timer::scoped_timer(unsigned ms, event_handler * eh) {
     if (ms == 0 || ms == UINT_MAX)
         return;
-
-    workers.lock();
-    if (available_workers.empty()) {
-        // start new thead
-        workers.unlock();
-        s = new scoped_timer_state;
-        ++num_workers;
-        init_state(ms, eh);
-        s->m_thread = std::thread(thread_func, s);
-    }
-    else {
-        // re-use existing thread
-        s = available_workers.back();
-        available_workers.pop_back();
-        init_state(ms, eh);
-        workers.unlock();
-        s->cv.notify_one();
-    }
+    s = new scoped_timer_state;
+    s->eh = eh;
+    get_wheel().arm(s, ms);
 }
     
 scoped_timer::~scoped_timer() {
     if (!s)
         return;
-
-    s->m_mutex.unlock();
-    while (s->work == WORKING)
-        std::this_thread::yield();
-    workers.lock();
-    available_workers.push_back(s);
-    workers.unlock();
+    get_wheel().disarm(s);
+    delete s;
 }
 
 void scoped_timer::initialize() {
@@ -121,30 +259,5 @@ void scoped_timer::initialize() {
 }
 
 void scoped_timer::finalize() {
-    unsigned deleted = 0;
-    while (deleted < num_workers) {
-        workers.lock();
-        for (auto w : available_workers) {
-            w->work = EXITING;
-            w->cv.notify_one();
-        }
-        decltype(available_workers) cleanup_workers;
-        std::swap(available_workers, cleanup_workers);
-        workers.unlock();
-
-        for (auto w : cleanup_workers) {
-            ++deleted;
-            w->m_thread.join();
-            delete w;
-        }
-    }
-    num_workers = 0;
-    available_workers.clear();
-}
-
-void scoped_timer::init_state(unsigned ms, event_handler * eh) {
-    s->ms = ms;
-    s->eh = eh;
-    s->m_mutex.lock();
-    s->work = WORKING;
+    get_wheel().stop();
 }
@@ -24,12 +24,16 @@ Revision History:
 #include "util/util.h"
 #include "util/vector.h"
 #include<iomanip>
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
 #ifdef Z3DEBUG
 # include <iostream>
 #endif
 
 
-small_object_allocator::small_object_allocator(char const * id) {
+small_object_allocator::small_object_allocator(char const * id, bool use_slabs):
+    m_use_slabs(use_slabs) {
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
         m_chunks[i] = nullptr;
         m_free_list[i] = nullptr;
@@ -41,14 +45,7 @@ small_object_allocator::small_object_allocator(char const * id) {
 }
 
 small_object_allocator::~small_object_allocator() {
-    for (unsigned i = 0; i < NUM_SLOTS; i++) {
-        chunk * c = m_chunks[i];
-        while (c) {
-            chunk * next = c->m_next;
-            dealloc(c);
-            c = next;
-        }
-    }
+    del_chunks();
     DEBUG_CODE({
         if (m_alloc_size > 0) {
             std::cerr << "Memory leak detected for small object allocator '" << m_id << "'. " << m_alloc_size << " bytes leaked" << std::endl;
@@ -57,6 +54,26 @@ small_object_allocator::~small_object_allocator() {
 }
 
 void small_object_allocator::reset() {
+    del_chunks();
+    for (unsigned i = 0; i < NUM_SLOTS; i++) {
+        m_chunks[i] = nullptr;
+        m_free_list[i] = nullptr;
+    }
+    m_alloc_size = 0;
+}
+
+void small_object_allocator::del_chunks() {
+    if (m_use_slabs) {
+        while (m_slabs) {
+            slab * next = m_slabs->m_next;
+            memory::deallocate(m_slabs);
+            m_slabs = next;
+        }
+        m_slab_curr = m_slab_end = nullptr;
+        m_slab_size = MIN_SLAB_SIZE;
+        m_free_chunks = nullptr;
+        return;
+    }
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
         chunk * c = m_chunks[i];
         while (c) {
@@ -64,10 +81,48 @@ void small_object_allocator::reset() {
             dealloc(c);
             c = next;
         }
-        m_chunks[i] = nullptr;
-        m_free_list[i] = nullptr;
     }
-    m_alloc_size = 0;
+}
+
+small_object_allocator::chunk * small_object_allocator::mk_chunk() {
+    if (!m_use_slabs)
+        return alloc(chunk);
+    if (m_free_chunks) {
+        chunk * c = m_free_chunks;
+        m_free_chunks = c->m_next;
+        return new (c) chunk();
+    }
+    if (static_cast<size_t>(m_slab_end - m_slab_curr) < sizeof(chunk)) {
+        size_t sz = m_slab_size;
+        if (m_slab_size < SLAB_SIZE)
+            m_slab_size *= 2;
+        char * mem = static_cast<char*>(memory::allocate(sz));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // ask for transparent huge pages on the page-aligned part of the slab.
+        size_t page = 4096;
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(mem) + page - 1) & ~(page - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(mem) + sz) & ~(page - 1);
+        if (sz == SLAB_SIZE && begin < end)
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+        slab * s = reinterpret_cast<slab*>(mem);
+        s->m_next = m_slabs;
+        m_slabs = s;
+        m_slab_curr = mem + sizeof(slab);
+        m_slab_end = mem + sz;
+    }
+    chunk * c = new (m_slab_curr) chunk();
+    m_slab_curr += sizeof(chunk);
+    return c;
+}
+
+void small_object_allocator::del_chunk(chunk * c) {
+    if (!m_use_slabs) {
+        dealloc(c);
+        return;
+    }
+    c->m_next = m_free_chunks;
+    m_free_chunks = c;
 }
 
 #define MASK ((1 << PTR_ALIGNMENT) - 1)
@@ -138,7 +193,7 @@ void * small_object_allocator::allocate(size_t size) {
             return r;
         }
     }
-    chunk * new_c = alloc(chunk);
+    chunk * new_c = mk_chunk();
     new_c->m_next = c;
     m_chunks[slot_id] = new_c;
     void * r = new_c->m_curr;
@@ -227,7 +282,7 @@ void small_object_allocator::consolidate() {
                 num_free_in_chunk++;
             }
             if (num_free_in_chunk == num_objs_per_chunk) {
-                dealloc(curr_chunk);
+                del_chunk(curr_chunk);
             }
             else {
                 curr_chunk->m_next = last_chunk;
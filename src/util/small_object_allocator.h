@@ -32,14 +32,31 @@ class small_object_allocator {
         char* m_curr = m_data;
         char    m_data[CHUNK_SIZE];
     };
+    // In slab mode chunks are carved out of large slabs that are only
+    // released together, when the allocator is reset or destroyed.
+    // Slabs double in size from MIN_SLAB_SIZE up to SLAB_SIZE.
+    static const unsigned SLAB_SIZE      = 2 * 1024 * 1024;
+    static const unsigned MIN_SLAB_SIZE  = 64 * 1024;
+    struct slab {
+        slab* m_next;
+    };
     chunk *     m_chunks[NUM_SLOTS];
     void  *     m_free_list[NUM_SLOTS];
     size_t      m_alloc_size;
+    bool        m_use_slabs;
+    slab *      m_slabs = nullptr;
+    char *      m_slab_curr = nullptr;
+    char *      m_slab_end = nullptr;
+    unsigned    m_slab_size = MIN_SLAB_SIZE;
+    chunk *     m_free_chunks = nullptr; // slab chunks released by consolidate
 #ifdef Z3DEBUG
     char const * m_id;
 #endif
+    chunk * mk_chunk();
+    void del_chunk(chunk * c);
+    void del_chunks();
 public:
-    small_object_allocator(char const * id = "unknown");
+    small_object_allocator(char const * id = "unknown", bool use_slabs = false);
     ~small_object_allocator();
     void reset();
     void * allocate(size_t size);
@@ -29,7 +29,10 @@ Notes:
         bimander_at_most,
         ordered_at_most,
         unate_at_most,
-        circuit_at_most
+        circuit_at_most,
+        totalizer_at_most,
+        mtotalizer_at_most,
+        auto_at_most
     };
 
     inline std::ostream& operator<<(std::ostream& out, sorting_network_encoding enc) {
@@ -40,6 +43,9 @@ Notes:
         case sorting_network_encoding::sorted_at_most: return out << "sorted";
         case sorting_network_encoding::unate_at_most: return out << "unate";
         case sorting_network_encoding::circuit_at_most: return out << "circuit";
+        case sorting_network_encoding::totalizer_at_most: return out << "totalizer";
+        case sorting_network_encoding::mtotalizer_at_most: return out << "mtotalizer";
+        case sorting_network_encoding::auto_at_most: return out << "auto";
         }
         return out << "???";
     }
@@ -151,11 +157,11 @@ Notes:
         sorting_network_config m_cfg;
 
         class vc {
-            unsigned v; // number of vertices
-            unsigned c; // number of clauses
+            uint64_t v; // number of vertices
+            uint64_t c; // number of clauses
             static const unsigned lambda = 5;
         public:
-            vc(unsigned v, unsigned c):v(v), c(c) {}
+            vc(uint64_t v, uint64_t c):v(v), c(c) {}
 
             bool operator<(vc const& other) const {
                 return to_int() < other.to_int();
@@ -166,7 +172,7 @@ Notes:
             vc operator-(vc const& other) const {
                 return vc(v - other.v, c - other.c);
             }
-            unsigned to_int() const {
+            uint64_t to_int() const {
                 return lambda*v + c;
             }
             vc operator*(unsigned n) const {
@@ -204,6 +210,12 @@ Notes:
             unsigned m_num_compiled_vars;
             unsigned m_num_compiled_clauses;
             unsigned m_num_clause_vars;
+            // encodings chosen for cardinality constraints with k > 1
+            unsigned m_num_sorted;
+            unsigned m_num_unate;
+            unsigned m_num_circuit;
+            unsigned m_num_totalizer;
+            unsigned m_num_mtotalizer;
             void reset() { memset(this, 0, sizeof(*this)); }
             stats() { reset(); }
         };
@@ -244,11 +256,8 @@ Notes:
                 return le(full, k, in.size(), in.data());
             }
             else {
-                switch (m_cfg.m_encoding) {
+                switch (select_encoding(full?GE_FULL:GE, k, n)) {
                 case sorting_network_encoding::sorted_at_most:
-                case sorting_network_encoding::bimander_at_most:
-                case sorting_network_encoding::ordered_at_most:
-                case sorting_network_encoding::grouped_at_most:
                     SASSERT(2*k <= n);
                     m_t = full?GE_FULL:GE;
                     // scoped_stats _ss(m_stats, k, n);
@@ -258,6 +267,10 @@ Notes:
                     return unate_ge(full, k, n, xs);
                 case sorting_network_encoding::circuit_at_most:
                     return circuit_ge(full, k, n, xs); 
+                case sorting_network_encoding::totalizer_at_most:
+                    return totalizer_cmp(full?GE_FULL:GE, k, n, xs);
+                case sorting_network_encoding::mtotalizer_at_most:
+                    return mtotalizer_cmp(full?GE_FULL:GE, k, n, xs);
                 default:
                     UNREACHABLE();
                     return xs[0];
@@ -282,6 +295,9 @@ Notes:
                 case sorting_network_encoding::sorted_at_most:
                 case sorting_network_encoding::unate_at_most:
                 case sorting_network_encoding::circuit_at_most:
+                case sorting_network_encoding::totalizer_at_most:
+                case sorting_network_encoding::mtotalizer_at_most:
+                case sorting_network_encoding::auto_at_most:
                     return mk_at_most_1(full, n, xs, ors, false);
                 case sorting_network_encoding::bimander_at_most:
                     return mk_at_most_1_bimander(full, n, xs, ors);
@@ -294,11 +310,8 @@ Notes:
                 }
             }
             else {
-                switch (m_cfg.m_encoding) {
+                switch (select_encoding(full?LE_FULL:LE, k, n)) {
                 case sorting_network_encoding::sorted_at_most:
-                case sorting_network_encoding::bimander_at_most:
-                case sorting_network_encoding::ordered_at_most:
-                case sorting_network_encoding::grouped_at_most:
                     SASSERT(2*k <= n);
                     m_t = full?LE_FULL:LE;
                     // scoped_stats _ss(m_stats, k, n);
@@ -308,6 +321,10 @@ Notes:
                     return unate_le(full, k, n, xs); 
                 case sorting_network_encoding::circuit_at_most:
                     return circuit_le(full, k, n, xs); 
+                case sorting_network_encoding::totalizer_at_most:
+                    return totalizer_cmp(full?LE_FULL:LE, k, n, xs);
+                case sorting_network_encoding::mtotalizer_at_most:
+                    return mtotalizer_cmp(full?LE_FULL:LE, k, n, xs);
                 default:                    
                     UNREACHABLE();
                     return xs[0];
@@ -329,11 +346,8 @@ Notes:
                 return mk_exactly_1(full, n, xs);
             }
             else {
-                switch (m_cfg.m_encoding) {
+                switch (select_encoding(EQ, k, n)) {
                 case sorting_network_encoding::sorted_at_most:
-                case sorting_network_encoding::bimander_at_most:
-                case sorting_network_encoding::grouped_at_most:
-                case sorting_network_encoding::ordered_at_most:
                     // scoped_stats _ss(m_stats, k, n);
                     SASSERT(2*k <= n);
                     m_t = EQ;
@@ -349,6 +363,10 @@ Notes:
                     return unate_eq(k, n, xs);              
                 case sorting_network_encoding::circuit_at_most:
                     return circuit_eq(k, n, xs);        
+                case sorting_network_encoding::totalizer_at_most:
+                    return totalizer_cmp(EQ, k, n, xs);
+                case sorting_network_encoding::mtotalizer_at_most:
+                    return mtotalizer_cmp(EQ, k, n, xs);
                 default:                    
                     UNREACHABLE();
                     return xs[0];
@@ -611,6 +629,231 @@ Notes:
         literal circuit_eq(unsigned k, unsigned n, literal const* xs) {
             return circuit_cmp(EQ, k, n, xs);
         }
+
+        /**
+           \brief encoding used for a cardinality constraint over n literals with bound k (k > 1).
+
+           The sorting network variants (sorted, grouped, bimander, ordered) only differ for
+           at-most-1 constraints. With the auto encoding the candidate with the smallest
+           estimated size is used. Constraints that occur with both polarities (the _FULL
+           and EQ comparisons) need both directions of the sorting network comparators,
+           while the other encodings define their outputs by equivalences in either case.
+         */
+        sorting_network_encoding select_encoding(cmp_t t, unsigned k, unsigned n) {
+            sorting_network_encoding enc = m_cfg.m_encoding;
+            switch (enc) {
+            case sorting_network_encoding::grouped_at_most:
+            case sorting_network_encoding::bimander_at_most:
+            case sorting_network_encoding::ordered_at_most:
+                enc = sorting_network_encoding::sorted_at_most;
+                break;
+            case sorting_network_encoding::auto_at_most:
+                enc = cheapest_encoding(t, k, n);
+                break;
+            default:
+                break;
+            }
+            switch (enc) {
+            case sorting_network_encoding::sorted_at_most: m_stats.m_num_sorted++; break;
+            case sorting_network_encoding::unate_at_most: m_stats.m_num_unate++; break;
+            case sorting_network_encoding::circuit_at_most: m_stats.m_num_circuit++; break;
+            case sorting_network_encoding::totalizer_at_most: m_stats.m_num_totalizer++; break;
+            case sorting_network_encoding::mtotalizer_at_most: m_stats.m_num_mtotalizer++; break;
+            default: UNREACHABLE(); break;
+            }
+            TRACE("pb", tout << "k: " << k << " n: " << n << " encoding: " << enc << "\n";);
+            return enc;
+        }
+
+        // number of unary outputs needed to compare against k.
+        static unsigned cmp_bound(cmp_t t, unsigned k) {
+            return (t == GE || t == GE_FULL) ? k : k + 1;
+        }
+
+        sorting_network_encoding cheapest_encoding(cmp_t t, unsigned k, unsigned n) {
+            unsigned bound = cmp_bound(t, k);
+            cmp_t save = m_t;
+            m_t = t;
+            vc best = vc_card(bound, n);
+            m_t = save;
+            sorting_network_encoding enc = sorting_network_encoding::sorted_at_most;
+            auto consider = [&](vc const& cost, sorting_network_encoding e) {
+                if (cost < best) {
+                    best = cost;
+                    enc = e;
+                }
+            };
+            consider(vc_unate(bound, n), sorting_network_encoding::unate_at_most);
+            consider(vc_totalizer(bound, n), sorting_network_encoding::totalizer_at_most);
+            consider(vc_circuit(bound, n), sorting_network_encoding::circuit_at_most);
+            unsigned p = mod_base(bound);
+            if (p < bound)
+                consider(vc_mtotalizer(p, bound / p + 1, n), sorting_network_encoding::mtotalizer_at_most);
+            return enc;
+        }
+
+        // sequential counter: one and-gate and one or-gate per input and output.
+        vc vc_unate(unsigned bound, unsigned n) {
+            uint64_t cells = static_cast<uint64_t>(n) * bound;
+            return vc(2 * cells, 6 * cells);
+        }
+
+        // adder tree, a sum of n bits uses at most log2(n) + 1 full adders.
+        // Most adder inputs near the leaves are constant and simplify away.
+        vc vc_circuit(unsigned bound, unsigned n) {
+            if (n <= 1)
+                return vc(0, 0);
+            unsigned half = n / 2;
+            vc sub = (2 * half == n) ? vc_circuit(bound, half) * 2 : vc_circuit(bound, half) + vc_circuit(bound, n - half);
+            uint64_t bits = 0;
+            for (unsigned b = std::min(bound, n); b > 0; b >>= 1) ++bits;
+            return sub + vc(5 * bits, 17 * bits);
+        }
+
+        // unary addition of a and b unary digits truncated to c outputs.
+        vc vc_unary_add(uint64_t a, uint64_t b, uint64_t c) {
+            uint64_t pairs = a * b;
+            if (a + b > c) {
+                uint64_t d = a + b - c;
+                pairs = d * (d + 1) / 2 >= pairs ? 0 : pairs - d * (d + 1) / 2;
+            }
+            return vc(pairs + c, 4 * pairs + 3 * c);
+        }
+
+        vc vc_totalizer(unsigned bound, unsigned n) {
+            if (n <= 1)
+                return vc(0, 0);
+            unsigned half = n / 2;
+            vc sub = (2 * half == n) ? vc_totalizer(bound, half) * 2 : vc_totalizer(bound, half) + vc_totalizer(bound, n - half);
+            return sub + vc_unary_add(std::min(bound, half), std::min(bound, n - half), std::min(bound, n));
+        }
+
+        vc vc_mtotalizer(unsigned p, unsigned qbound, unsigned n) {
+            if (n <= 1)
+                return vc(0, 0);
+            unsigned half = n / 2;
+            vc sub = (2 * half == n) ? vc_mtotalizer(p, qbound, half) * 2 : vc_mtotalizer(p, qbound, half) + vc_mtotalizer(p, qbound, n - half);
+            unsigned la = std::min(p - 1, half), lb = std::min(p - 1, n - half);
+            unsigned ha = std::min(qbound, half / p), hb = std::min(qbound, (n - half) / p);
+            unsigned lo = std::min(p - 1, n), hi = std::min(qbound, n / p);
+            return sub + 
+                vc_unary_add(la, lb, la + lb) + vc(2 * lo, 7 * lo) +
+                vc_unary_add(ha, hb, std::min(qbound, ha + hb)) + vc(2 * hi, 7 * hi);
+        }
+
+        // totalizer encoding
+        literal unary_get(literal_vector const& a, unsigned i) {
+            if (i == 0) return ctx.mk_true();
+            if (i <= a.size()) return a[i - 1];
+            return ctx.mk_false();
+        }
+
+        // out[t-1] <=> a + b >= t for t <= min(bound, |a| + |b|)
+        void unary_add(unsigned bound, literal_vector const& a, literal_vector const& b, literal_vector& out) {
+            unsigned c = std::min(bound, a.size() + b.size());
+            literal_vector ors;
+            for (unsigned t = 1; t <= c; ++t) {
+                ors.reset();
+                unsigned lo = t > b.size() ? t - b.size() : 0;
+                unsigned hi = std::min(t, a.size());
+                for (unsigned i = lo; i <= hi; ++i) 
+                    ors.push_back(mk_and(unary_get(a, i), unary_get(b, t - i)));
+                out.push_back(mk_or(ors));
+            }
+        }
+
+        // out[i] <=> at least i+1 of xs are true, for i < min(n, bound)
+        void totalizer(unsigned bound, unsigned n, literal const* xs, literal_vector& out) {
+            if (n == 1) {
+                out.push_back(xs[0]);
+                return;
+            }
+            literal_vector a, b;
+            unsigned half = n / 2;
+            totalizer(bound, half, xs, a);
+            totalizer(bound, n - half, xs + half, b);
+            unary_add(bound, a, b, out);
+        }
+
+        literal unary_cmp(cmp_t t, unsigned k, literal_vector const& out) {
+            switch (t) {
+            case LE:
+            case LE_FULL:
+                return mk_not(unary_get(out, k + 1));
+            case GE:
+            case GE_FULL:
+                return unary_get(out, k);
+            case EQ:
+                return mk_and(unary_get(out, k), mk_not(unary_get(out, k + 1)));
+            default:
+                UNREACHABLE();
+                return ctx.mk_false();
+            }
+        }
+
+        literal totalizer_cmp(cmp_t t, unsigned k, unsigned n, literal const* xs) {
+            literal_vector out;
+            totalizer(cmp_bound(t, k), n, xs, out);
+            return unary_cmp(t, k, out);
+        }
+
+        // modulo totalizer encoding, Ogawa et al. ICTAI 2013.
+        // The count is represented as q*p + r with q and r in unary,
+        // lo[i] <=> r >= i+1 and hi[i] <=> q >= i+1.
+        static unsigned mod_base(unsigned bound) {
+            unsigned p = 2;
+            while (p * p < bound) ++p;
+            return p;
+        }
+
+        void mtotalizer(unsigned p, unsigned qbound, unsigned n, literal const* xs, literal_vector& lo, literal_vector& hi) {
+            if (n == 1) {
+                lo.push_back(xs[0]);
+                return;
+            }
+            literal_vector alo, ahi, blo, bhi, sum, qsum;
+            unsigned half = n / 2;
+            mtotalizer(p, qbound, half, xs, alo, ahi);
+            mtotalizer(p, qbound, n - half, xs + half, blo, bhi);
+            // sum[t-1] <=> ra + rb >= t
+            unary_add(UINT_MAX, alo, blo, sum);
+            literal carry = unary_get(sum, p);
+            unsigned num_lo = std::min(p - 1, sum.size());
+            for (unsigned s = 1; s <= num_lo; ++s) 
+                lo.push_back(mk_and(unary_get(sum, s), mk_or(mk_not(carry), unary_get(sum, p + s))));
+            unary_add(qbound, ahi, bhi, qsum);
+            unsigned num_hi = std::min(qbound, qsum.size() + (is_false(carry) ? 0 : 1));
+            for (unsigned t = 1; t <= num_hi; ++t) 
+                hi.push_back(mk_or(unary_get(qsum, t), mk_and(carry, unary_get(qsum, t - 1))));
+        }
+
+        // count >= k
+        literal mtotalizer_ge(unsigned p, unsigned k, literal_vector const& lo, literal_vector const& hi) {
+            unsigned q = k / p, r = k % p;
+            if (r == 0)
+                return unary_get(hi, q);
+            return mk_or(unary_get(hi, q + 1), mk_and(unary_get(hi, q), unary_get(lo, r)));
+        }
+
+        literal mtotalizer_cmp(cmp_t t, unsigned k, unsigned n, literal const* xs) {
+            unsigned bound = cmp_bound(t, k);
+            unsigned p = mod_base(bound);
+            literal_vector lo, hi;
+            mtotalizer(p, bound / p + 1, n, xs, lo, hi);
+            switch (t) {
+            case LE:
+            case LE_FULL:
+                return mk_not(mtotalizer_ge(p, k + 1, lo, hi));
+            case GE:
+            case GE_FULL:
+                return mtotalizer_ge(p, k, lo, hi);
+            case EQ:
+                return mk_and(mtotalizer_ge(p, k, lo, hi), mk_not(mtotalizer_ge(p, k + 1, lo, hi)));
+            default:
+                UNREACHABLE();
+                return ctx.mk_false();
+            }
+        }
        
         void add_implies_or(literal l, unsigned n, literal const* xs) {
             literal_vector lits(n, xs);
@@ -702,6 +945,9 @@ Notes:
             case sorting_network_encoding::sorted_at_most:
             case sorting_network_encoding::unate_at_most:
             case sorting_network_encoding::circuit_at_most:
+            case sorting_network_encoding::totalizer_at_most:
+            case sorting_network_encoding::mtotalizer_at_most:
+            case sorting_network_encoding::auto_at_most:
                 r1 = mk_at_most_1(full, n, xs, ors, true);
                 break;
             case sorting_network_encoding::bimander_at_most:
@@ -1069,7 +1315,7 @@ Notes:
         }
         vc vc_card_rec(unsigned k, unsigned n) {
             unsigned l = n/2;
-            return vc_card(k, l) + vc_card(k, n-l) + vc_smerge(k, l, n-l);
+            return vc_card(k, l) + vc_card(k, n-l) + vc_smerge(l, n-l, k);
         }
         bool use_dcard(unsigned k, unsigned n) {
             return m_force_dcard || (!m_disable_dcard && n < 10 && vc_dsorting(k, n) < vc_card_rec(k, n));
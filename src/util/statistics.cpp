@@ -239,6 +239,22 @@ void get_memory_statistics(statistics& st) {
     st.update("max memory", static_cast<double>(max_mem)/100.0);    
     st.update("memory", static_cast<double>(mem)/100.0);
     get_uint64_stats(st, "num allocs",  memory::get_allocation_count());
+    // statistics keep the key pointers, so the keys are static.
+    static char const* const s_tag_memory[memory::num_tags] = {
+        "memory other", "memory smt", "memory sat", "memory egraph", "memory rewriter", "memory numerals"
+    };
+    static char const* const s_tag_allocs[memory::num_tags] = {
+        "num allocs other", "num allocs smt", "num allocs sat", "num allocs egraph", "num allocs rewriter", "num allocs numerals"
+    };
+    for (unsigned t = memory::tag_other + 1; t < memory::num_tags; ++t) {
+        auto tg = static_cast<memory::tag>(t);
+        unsigned long long count = memory::get_tag_allocation_count(tg);
+        if (count == 0)
+            continue;
+        long long tag_mem = (100*memory::get_tag_allocation_size(tg))/(1024*1024);
+        st.update(s_tag_memory[t], static_cast<double>(tag_mem)/100.0);
+        get_uint64_stats(st, s_tag_allocs[t], count);
+    }
 }
 
 void get_rlimit_statistics(reslimit& l, statistics& st) {
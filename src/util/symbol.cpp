@@ -92,6 +92,23 @@ void finalize_symbols() {
 
 #else
 
+/**
+   \brief per-thread cache of recently interned strings.
+   A hit returns the interned string without taking the lock of a table.
+   Entries are tagged with the generation of the symbol tables, so they
+   are invalidated when the tables are finalized and initialized again.
+*/
+static unsigned g_symbol_generation = 0;
+
+struct symbol_cache_entry {
+    unsigned     m_generation = 0;
+    unsigned     m_hash = 0;
+    char const * m_str = nullptr;
+};
+
+static const unsigned SYMBOL_CACHE_SIZE = 256;
+static thread_local symbol_cache_entry t_symbol_cache[SYMBOL_CACHE_SIZE];
+
 struct internal_symbol_tables {
     unsigned sz;
     internal_symbol_table** tables;
@@ -109,8 +126,15 @@ struct internal_symbol_tables {
     }
 
     char const * get_str(char const * d) {
-        auto* table = tables[string_hash(d, static_cast<unsigned>(strlen(d)), 251) % sz];
-        return table->get_str(d);
+        unsigned h = string_hash(d, static_cast<unsigned>(strlen(d)), 251);
+        symbol_cache_entry & c = t_symbol_cache[h % SYMBOL_CACHE_SIZE];
+        if (c.m_generation == g_symbol_generation && c.m_hash == h && strcmp(c.m_str, d) == 0)
+            return c.m_str;
+        char const * result = tables[h % sz]->get_str(d);
+        c.m_generation = g_symbol_generation;
+        c.m_hash = h;
+        c.m_str = result;
+        return result;
     }
 };
 
@@ -121,7 +145,7 @@ void initialize_symbols() {
     if (!g_symbol_tables) {
         unsigned num_tables = 2 * std::min((unsigned) std::thread::hardware_concurrency(), 64u);
         g_symbol_tables = alloc(internal_symbol_tables, num_tables);
-        
+        ++g_symbol_generation;
     }
 }
 
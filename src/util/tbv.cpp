@@ -202,25 +202,47 @@ tbv& tbv_manager::set_or(tbv& dst,  tbv const& src) const {
     m.set_or(dst, src); 
     return dst;
 }
-bool tbv_manager::set_and(tbv& dst,  tbv const& src) const {
-    m.set_and(dst, src); 
-    return is_well_formed(dst);
+// A tbit is BIT_z if neither of its two bits is set. 
+// Return the high bits of the pairs in w that are BIT_z.
+static inline unsigned z_bits(unsigned w) {
+    return ~(w | (w << 1)) & 0xAAAAAAAA;
 }
 
-bool tbv_manager::is_well_formed(tbv const& dst) const {
+/**
+   \brief compute dst = a & b and check that dst is well formed in a single pass.
+*/
+static bool and_well_formed(fixed_bit_vector_manager const& m, unsigned* dst, unsigned const* a, unsigned const* b) {
     unsigned nw = m.num_words();
-    unsigned w;
+    if (nw == 0) 
+        return true;
+    unsigned z = 0;
     for (unsigned i = 0; i + 1 < nw; ++i) {
-        w = dst.get_word(i);
-        w = w | (w << 1) | 0x55555555;
-        if (w != 0xFFFFFFFF) return false;
-    }
-    if (nw > 0) {        
-        w = m.last_word(dst);
-        w = w | (w << 1) | 0x55555555 | ~m.get_mask();
-        if (w != 0xFFFFFFFF) return false;
+        unsigned w = a[i] & b[i];
+        dst[i] = w;
+        z |= z_bits(w);
     }
-    return true;
+    unsigned w = a[nw - 1] & b[nw - 1];
+    dst[nw - 1] = w;
+    z |= z_bits(w) & m.get_mask();
+    return z == 0;
+}
+
+bool tbv_manager::set_and(tbv& dst,  tbv const& src) const {
+    fixed_bit_vector& d = dst;
+    fixed_bit_vector const& s = src;
+    return and_well_formed(m, d.m_data, d.m_data, s.m_data);
+}
+
+bool tbv_manager::is_well_formed(tbv const& dst) const {
+    fixed_bit_vector const& d = dst;
+    unsigned nw = m.num_words();
+    if (nw == 0)
+        return true;
+    unsigned z = 0;
+    for (unsigned i = 0; i + 1 < nw; ++i) 
+        z |= z_bits(d.m_data[i]);
+    z |= z_bits(m.last_word(d)) & m.get_mask();
+    return z == 0;
 }
 
 void tbv_manager::complement(tbv const& src, ptr_vector<tbv>& result) {
@@ -265,8 +287,10 @@ bool tbv_manager::contains(tbv const& a, unsigned_vector const& colsa,
 }
 
 bool tbv_manager::intersect(tbv const& a, tbv const& b, tbv& result) {
-    copy(result, a);
-    return set_and(result, b);
+    fixed_bit_vector& r = result;
+    fixed_bit_vector const& fa = a;
+    fixed_bit_vector const& fb = b;
+    return and_well_formed(m, r.m_data, fa.m_data, fb.m_data);
 }
 
 std::ostream& tbv_manager::display(std::ostream& out, tbv const& b, unsigned hi, unsigned lo) const {
@@ -19,9 +19,13 @@ Revision History:
 #pragma once
 
 #include "util/heap.h"
+#include "util/dary_heap.h"
 
-
-template <class ActivityVector>    
+/**
+   \brief priority queue of variables ordered by decreasing activity.
+   Heap is heap or one of the d-ary heaps of dary_heap.h.
+*/
+template <class ActivityVector, template<typename> class Heap = heap>    
 class var_queue {
     typedef unsigned var;
 
@@ -30,7 +34,7 @@ class var_queue {
         lt(ActivityVector & act):m_activity(act) {}
         bool operator()(var v1, var v2) const { return m_activity[v1] > m_activity[v2]; }
     };
-    heap<lt>  m_queue;
+    Heap<lt>  m_queue;
 
 public:
     
@@ -97,7 +101,7 @@ public:
     const_iterator end() const { return m_queue.end(); }
 };
 
-template <typename T>
-inline std::ostream& operator<<(std::ostream& out, var_queue<T> const& queue) {
+template <typename T, template<typename> class H>
+inline std::ostream& operator<<(std::ostream& out, var_queue<T, H> const& queue) {
     return queue.display(out);
 }
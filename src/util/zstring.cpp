@@ -71,17 +71,100 @@ bool zstring::is_escape_char(char const *& s, unsigned& result) {
     return false;
 }
 
+zstring::storage* zstring::mk_storage(unsigned capacity, bool wide) {
+    size_t sz = sizeof(storage) + static_cast<size_t>(capacity) * (wide ? sizeof(uint32_t) : sizeof(uint8_t));
+    return new (memory::allocate(sz)) storage(capacity, wide);
+}
+
+void zstring::dec_ref(storage* s) {
+    if (s && s->m_ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        s->~storage();
+        memory::deallocate(s);
+    }
+}
+
+zstring& zstring::operator=(zstring const& other) {
+    inc_ref(other.m_storage);
+    dec_ref(m_storage);
+    m_storage = other.m_storage;
+    m_offset = other.m_offset;
+    m_length = other.m_length;
+    return *this;
+}
+
+zstring& zstring::operator=(zstring&& other) noexcept {
+    if (this != &other) {
+        dec_ref(m_storage);
+        m_storage = other.m_storage;
+        m_offset = other.m_offset;
+        m_length = other.m_length;
+        other.m_storage = nullptr;
+        other.m_length = 0;
+    }
+    return *this;
+}
+
+void zstring::init(unsigned sz, unsigned const* s, unsigned capacity) {
+    SASSERT(!m_storage);
+    SASSERT(sz <= capacity);
+    if (sz == 0)
+        return;
+    bool wide = false;
+    for (unsigned i = 0; i < sz && !wide; ++i)
+        wide = s[i] > 255;
+    m_storage = mk_storage(capacity, wide);
+    inc_ref(m_storage);
+    if (wide)
+        memcpy(m_storage->wide(), s, sz * sizeof(uint32_t));
+    else
+        for (unsigned i = 0; i < sz; ++i)
+            m_storage->narrow()[i] = static_cast<uint8_t>(s[i]);
+    m_storage->m_size = sz;
+    m_offset = 0;
+    m_length = sz;
+}
+
+bool zstring::has_wide_chars() const {
+    if (!m_storage || !m_storage->m_wide)
+        return false;
+    for (unsigned i = 0; i < m_length; ++i)
+        if ((*this)[i] > 255)
+            return true;
+    return false;
+}
+
+/**
+   \brief copy the characters of this string to dst starting at offset.
+*/
+void zstring::copy_to(unsigned offset, storage* dst) const {
+    SASSERT(offset + m_length <= dst->m_capacity);
+    if (m_length == 0)
+        return;
+    if (dst->m_wide && m_storage->m_wide)
+        memcpy(dst->wide() + offset, m_storage->wide() + m_offset, m_length * sizeof(uint32_t));
+    else if (!dst->m_wide && !m_storage->m_wide)
+        memcpy(dst->narrow() + offset, m_storage->narrow() + m_offset, m_length);
+    else if (dst->m_wide)
+        for (unsigned i = 0; i < m_length; ++i)
+            dst->wide()[offset + i] = (*this)[i];
+    else
+        for (unsigned i = 0; i < m_length; ++i)
+            dst->narrow()[offset + i] = static_cast<uint8_t>((*this)[i]);
+}
+
 zstring::zstring(char const* s) {
+    buffer<unsigned> chars;
     while (*s) {
         unsigned ch = 0;
         if (is_escape_char(s, ch)) {
-            m_buffer.push_back(ch);
+            chars.push_back(ch);
         }
         else {
-            m_buffer.push_back((unsigned char)*s);
+            chars.push_back((unsigned char)*s);
             ++s;
         }
     }
+    init(chars.size(), chars.data(), chars.size());
     SASSERT(well_formed());
 }
 
@@ -96,7 +179,8 @@ string_encoding zstring::get_encoding() {
 }
 
 bool zstring::well_formed() const {
-    for (unsigned ch : m_buffer) {
+    for (unsigned i = 0; i < length(); ++i) {
+        unsigned ch = (*this)[i];
         if (ch > max_char()) {
             IF_VERBOSE(0, verbose_stream() << "large character: " << ch << "\n";);
             return false;
@@ -105,20 +189,16 @@ bool zstring::well_formed() const {
     return true;
 }
 
-zstring::zstring(unsigned ch) {
-    m_buffer.push_back(ch);
-}
-
 zstring zstring::reverse() const {
-    zstring result;
+    buffer<unsigned> chars;
     for (unsigned i = length(); i-- > 0; ) {
-        result.m_buffer.push_back(m_buffer[i]);
+        chars.push_back((*this)[i]);
     }
-    return result;
+    return zstring(chars.size(), chars.data());
 }
 
 zstring zstring::replace(zstring const& src, zstring const& dst) const {
-    zstring result;
+    buffer<unsigned> result;
     if (length() < src.length()) {
         return zstring(*this);
     }
@@ -129,18 +209,19 @@ zstring zstring::replace(zstring const& src, zstring const& dst) const {
     for (unsigned i = 0; i < length(); ++i) {
         bool eq = !found && i + src.length() <= length();
         for (unsigned j = 0; eq && j < src.length(); ++j) {
-            eq = m_buffer[i+j] == src[j];
+            eq = (*this)[i+j] == src[j];
         }
         if (eq) {
-            result.m_buffer.append(dst.m_buffer);
+            for (unsigned j = 0; j < dst.length(); ++j)
+                result.push_back(dst[j]);
             found = true;
             i += src.length() - 1;
         }
         else {
-            result.m_buffer.push_back(m_buffer[i]);
+            result.push_back((*this)[i]);
         }
     }
-    return result;
+    return zstring(result.size(), result.data());
 }
 
 std::string zstring::encode() const {
@@ -148,9 +229,9 @@ std::string zstring::encode() const {
     char buffer[100];
     unsigned offset = 0;
 #define _flush() if (offset > 0) { buffer[offset] = 0; strm << buffer; offset = 0; }
-    for (unsigned i = 0; i < m_buffer.size(); ++i) {
-        unsigned ch = m_buffer[i];
-        if (ch < 32 || ch >= 128 || ('\\' == ch && i + 1 < m_buffer.size() && 'u' == m_buffer[i+1])) {
+    for (unsigned i = 0; i < length(); ++i) {
+        unsigned ch = (*this)[i];
+        if (ch < 32 || ch >= 128 || ('\\' == ch && i + 1 < length() && 'u' == (*this)[i+1])) {
             _flush();
             strm << "\\u{" << std::hex << ch << std::dec << '}';
         }
@@ -168,7 +249,7 @@ bool zstring::suffixof(zstring const& other) const {
     if (length() > other.length()) return false;
     bool suffix = true;
     for (unsigned i = 0; suffix && i < length(); ++i) {
-        suffix = m_buffer[length()-i-1] == other[other.length()-i-1];
+        suffix = (*this)[length()-i-1] == other[other.length()-i-1];
     }
     return suffix;
 }
@@ -177,7 +258,7 @@ bool zstring::prefixof(zstring const& other) const {
     if (length() > other.length()) return false;
     bool prefix = true;
     for (unsigned i = 0; prefix && i < length(); ++i) {
-        prefix = m_buffer[i] == other[i];
+        prefix = (*this)[i] == other[i];
     }
     return prefix;
 }
@@ -189,7 +270,7 @@ bool zstring::contains(zstring const& other) const {
     for (unsigned i = 0; !cont && i <= last; ++i) {
         cont = true;
         for (unsigned j = 0; cont && j < other.length(); ++j) {
-            cont = other[j] == m_buffer[j+i];
+            cont = other[j] == (*this)[j+i];
         }
     }
     return cont;
@@ -204,7 +285,7 @@ int zstring::indexofu(zstring const& other, unsigned offset) const {
     for (unsigned i = offset; i <= last; ++i) {
         bool prefix = true;
         for (unsigned j = 0; prefix && j < other.length(); ++j) {
-            prefix = m_buffer[i + j] == other[j];
+            prefix = (*this)[i + j] == other[j];
         }
         if (prefix) {
             return static_cast<int>(i);
@@ -219,7 +300,7 @@ int zstring::last_indexof(zstring const& other) const {
     for (unsigned last = length() - other.length() + 1; last-- > 0; ) {
         bool suffix = true;
         for (unsigned j = 0; suffix && j < other.length(); ++j) {
-            suffix = m_buffer[last + j] == other[j];
+            suffix = (*this)[last + j] == other[j];
         }
         if (suffix) {
             return static_cast<int>(last);
@@ -230,21 +311,56 @@ int zstring::last_indexof(zstring const& other) const {
 
 zstring zstring::extract(unsigned offset, unsigned len) const {
     zstring result;
-    if (offset + len < offset) return result;
-    int last = std::min(offset+len, length());
-    for (int i = offset; i < last; ++i) {
-        result.m_buffer.push_back(m_buffer[i]);
-    }
+    if (offset + len < offset || offset >= length()) return result;
+    len = std::min(len, length() - offset);
+    if (len == 0)
+        return result;
+    // sub-strings share the buffer.
+    result.m_storage = m_storage;
+    result.m_offset = m_offset + offset;
+    result.m_length = len;
+    inc_ref(m_storage);
     return result;
 }
 
 unsigned zstring::hash() const {
-    return unsigned_ptr_hash(m_buffer.data(), m_buffer.size(), 23);
+    if (m_length > 0 && m_storage->m_wide)
+        return unsigned_ptr_hash(m_storage->wide() + m_offset, m_length, 23);
+    buffer<unsigned> chars;
+    for (unsigned i = 0; i < length(); ++i)
+        chars.push_back((*this)[i]);
+    return unsigned_ptr_hash(chars.data(), chars.size(), 23);
 }
 
 zstring zstring::operator+(zstring const& other) const {
-    zstring result(*this);
-    result.m_buffer.append(other.m_buffer);
+    if (other.empty())
+        return *this;
+    if (empty())
+        return other;
+    unsigned end = m_offset + m_length;
+    unsigned len = m_length + other.length();
+    if (len < m_length)
+        throw default_exception("string too long");
+    bool wide = m_storage->m_wide || other.has_wide_chars();
+    // claim the space after the end of this string if no other string extended the buffer already.
+    if (wide == m_storage->m_wide && len - m_length <= m_storage->m_capacity - end) {
+        unsigned expected = end;
+        if (m_storage->m_size.compare_exchange_strong(expected, end + other.length())) {
+            other.copy_to(end, m_storage);
+            zstring result(*this);
+            result.m_length = len;
+            return result;
+        }
+    }
+    // reserve space for further concatenations.
+    unsigned capacity = std::max(len, std::min(2 * len, UINT_MAX / 8));
+    zstring result;
+    result.m_storage = mk_storage(capacity, wide);
+    inc_ref(result.m_storage);
+    copy_to(0, result.m_storage);
+    other.copy_to(m_length, result.m_storage);
+    result.m_storage->m_size = len;
+    result.m_length = len;
     return result;
 }
 
@@ -254,8 +370,11 @@ bool zstring::operator==(const zstring& other) const {
     if (length() != other.length()) {
         return false;
     }
+    if (m_storage == other.m_storage && m_offset == other.m_offset) {
+        return true;
+    }
     for (unsigned i = 0; i < length(); ++i) {
-        if (m_buffer[i] != other[i]) {
+        if ((*this)[i] != other[i]) {
             return false;
         }
     }
@@ -16,6 +16,7 @@ Author:
 --*/
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include "util/buffer.h"
@@ -29,7 +30,34 @@ enum class string_encoding {
 
 class zstring {
 private:
-    buffer<uint32_t> m_buffer;
+    /**
+       Characters are kept in a reference counted buffer that is shared by
+       copies and sub-strings. Buffers use one byte per character when all
+       characters are below 256, and four bytes otherwise. A string that ends
+       at the end of the used part of its buffer is extended in place, so
+       repeated concatenation does not copy the prefix.
+    */
+    struct storage {
+        std::atomic<unsigned> m_ref;
+        std::atomic<unsigned> m_size;
+        unsigned              m_capacity;
+        bool                  m_wide;
+        storage(unsigned capacity, bool wide): m_ref(0), m_size(0), m_capacity(capacity), m_wide(wide) {}
+        uint8_t*  narrow() { return reinterpret_cast<uint8_t*>(this + 1); }
+        uint32_t* wide() { return reinterpret_cast<uint32_t*>(this + 1); }
+        uint8_t const*  narrow() const { return reinterpret_cast<uint8_t const*>(this + 1); }
+        uint32_t const* wide() const { return reinterpret_cast<uint32_t const*>(this + 1); }
+    };
+    storage* m_storage = nullptr;
+    unsigned m_offset = 0;
+    unsigned m_length = 0;
+
+    static storage* mk_storage(unsigned capacity, bool wide);
+    static void inc_ref(storage* s) { if (s) s->m_ref.fetch_add(1, std::memory_order_relaxed); }
+    static void dec_ref(storage* s);
+    void init(unsigned sz, unsigned const* s, unsigned capacity);
+    bool has_wide_chars() const;
+    void copy_to(unsigned offset, storage* dst) const;
     bool well_formed() const;
     bool is_escape_char(char const *& s, unsigned& result);
 public:
@@ -66,14 +94,22 @@ public:
     zstring(char const* s);
     zstring(const std::string &str) : zstring(str.c_str()) {}
     zstring(rational const& r): zstring(r.to_string()) {}
-    zstring(unsigned sz, unsigned const* s) { m_buffer.append(sz, s); SASSERT(well_formed()); }
-    zstring(unsigned ch);
+    zstring(unsigned sz, unsigned const* s) { init(sz, s, sz); SASSERT(well_formed()); }
+    zstring(unsigned ch) { init(1, &ch, 1); }
+    zstring(zstring const& other): m_storage(other.m_storage), m_offset(other.m_offset), m_length(other.m_length) { inc_ref(m_storage); }
+    zstring(zstring&& other) noexcept: m_storage(other.m_storage), m_offset(other.m_offset), m_length(other.m_length) { other.m_storage = nullptr; other.m_length = 0; }
+    ~zstring() { dec_ref(m_storage); }
+    zstring& operator=(zstring const& other);
+    zstring& operator=(zstring&& other) noexcept;
     zstring replace(zstring const& src, zstring const& dst) const;
     zstring reverse() const;
     std::string encode() const;
-    unsigned length() const { return m_buffer.size(); }
-    unsigned operator[](unsigned i) const { return m_buffer[i]; }
-    bool empty() const { return m_buffer.empty(); }
+    unsigned length() const { return m_length; }
+    unsigned operator[](unsigned i) const {
+        SASSERT(i < m_length);
+        return m_storage->m_wide ? m_storage->wide()[m_offset + i] : m_storage->narrow()[m_offset + i];
+    }
+    bool empty() const { return m_length == 0; }
     bool suffixof(zstring const& other) const;
     bool prefixof(zstring const& other) const;
     bool contains(zstring const& other) const;